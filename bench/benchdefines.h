@@ -0,0 +1,88 @@
+#pragma once
+#include <benchmark/benchmark.h>
+#include <cstring>
+extern "C" {
+#include "iso22133.h"
+#include "defines.h"
+}
+#include "../tests/testdefines.h"
+
+//! Reports messages/s as items and bytes/s, for comparison across commits
+static inline void setMessageCounters(benchmark::State& state, const size_t messageLength) {
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * messageLength));
+}
+
+static inline MessageHeaderType makeBenchHeader() {
+	MessageHeaderType header;
+	header.transmitterID = TEST_TRANSMITTER_ID_1;
+	header.receiverID = TEST_DEFAULT_RECEIVER_ID;
+	header.messageCounter = TEST_DEFAULT_MESSAGE_COUNTER;
+	return header;
+}
+
+//! Friday, April 29, 2022 2:22:22 AM, as used by the unit tests
+static inline struct timeval makeBenchTime() {
+	struct timeval time = { 1651198942, 123750 };
+	return time;
+}
+
+static inline CartesianPosition makeBenchPosition() {
+	CartesianPosition position;
+	position.xCoord_m = 123.456;
+	position.yCoord_m = -78.9;
+	position.zCoord_m = 1.25;
+	position.heading_rad = 1.2345;
+	position.isXcoordValid = position.isYcoordValid = position.isZcoordValid = true;
+	position.isPositionValid = position.isHeadingValid = true;
+	return position;
+}
+
+static inline SpeedType makeBenchSpeed() {
+	SpeedType speed;
+	speed.longitudinal_m_s = 13.89;
+	speed.lateral_m_s = 0.12;
+	speed.isLongitudinalValid = speed.isLateralValid = true;
+	return speed;
+}
+
+static inline AccelerationType makeBenchAcceleration() {
+	AccelerationType acceleration;
+	acceleration.longitudinal_m_s2 = 0.85;
+	acceleration.lateral_m_s2 = -0.3;
+	acceleration.isLongitudinalValid = acceleration.isLateralValid = true;
+	return acceleration;
+}
+
+#define BENCH_BUFFER_SIZE 1024
+
+//! Measures an encoder writing into a buffer of the size typically used by callers
+template <typename Encoder>
+static void runEncodeBenchmark(benchmark::State& state, Encoder encode) {
+	char buffer[BENCH_BUFFER_SIZE];
+	ssize_t length = encode(buffer, sizeof(buffer));
+	if (length < 0) {
+		state.SkipWithError("Encoding failed");
+		return;
+	}
+	for (auto _ : state) {
+		length = encode(buffer, sizeof(buffer));
+		benchmark::DoNotOptimize(buffer);
+	}
+	setMessageCounters(state, static_cast<size_t>(length));
+}
+
+//! Measures a decoder on a message produced by the corresponding encoder
+template <typename Encoder, typename Decoder>
+static void runDecodeBenchmark(benchmark::State& state, Encoder encode, Decoder decode) {
+	char buffer[BENCH_BUFFER_SIZE];
+	const ssize_t length = encode(buffer, sizeof(buffer));
+	if (length < 0 || decode(buffer, static_cast<size_t>(length)) < 0) {
+		state.SkipWithError("Unable to produce a decodable message");
+		return;
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(decode(buffer, static_cast<size_t>(length)));
+	}
+	setMessageCounters(state, static_cast<size_t>(length));
+}
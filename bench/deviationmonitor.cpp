@@ -0,0 +1,70 @@
+#include "benchdefines.h"
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "deviationmonitor.h"
+}
+
+/*! Monitor data of a fleet at 100 Hz checked against trajectories with points every 10 ms, each
+ *  object driving a circle of 200 m radius with a small lateral offset. Items are monitor samples. */
+static void BM_processDeviationMonitorData(benchmark::State& state) {
+	const int nObjects = static_cast<int>(state.range(0));
+	const int nPoints = static_cast<int>(state.range(1));
+	const double radius_m = 200.0, speed_m_s = 10.0;
+	DeviationMonitorType* monitor = createDeviationMonitor();
+	std::vector<TrajectoryWaypointType> waypoints(static_cast<size_t>(nPoints));
+	ObjectSettingsType settings = {};
+	settings.maxDeviation.position_m = 2.0;
+	settings.maxDeviation.lateral_m = 1.0;
+	settings.maxDeviation.yaw_rad = 0.2;
+	settings.minRequiredPositioningAccuracy_m = 0.1;
+
+	for (int i = 0; i < nPoints; ++i) {
+		TrajectoryWaypointType& waypoint = waypoints[static_cast<size_t>(i)];
+		const double angle_rad = speed_m_s * 0.01 * i / radius_m;
+		waypoint.relativeTime = { static_cast<time_t>(i / 100), static_cast<suseconds_t>((i % 100) * 10000) };
+		waypoint.pos = makeBenchPosition();
+		waypoint.pos.xCoord_m = radius_m * std::sin(angle_rad);
+		waypoint.pos.yCoord_m = radius_m * (1.0 - std::cos(angle_rad));
+		waypoint.pos.heading_rad = std::fmod(angle_rad, 2.0 * M_PI);
+		waypoint.spd = makeBenchSpeed();
+		waypoint.acc = makeBenchAcceleration();
+	}
+	for (int object = 0; object < nObjects; ++object) {
+		setDeviationTrajectory(monitor, TEST_TRANSMITTER_ID_1 + static_cast<uint32_t>(object),
+							   waypoints.data(), waypoints.size(), &settings);
+	}
+	StartMessageType start;
+	start.startTime = makeBenchTime();
+	start.isTimestampValid = true;
+	setDeviationStartTime(monitor, &start);
+
+	ObjectMonitorType monitorData = {};
+	monitorData.isTimestampValid = true;
+	monitorData.position = makeBenchPosition();
+	TrajectoryDeviationType deviation;
+	DeviationEventType events[16];
+	int point = 0;
+	for (auto _ : state) {
+		const int64_t time_us = start.startTime.tv_sec * 1000000LL + start.startTime.tv_usec + point * 10000LL;
+		const CartesianPosition& planned = waypoints[static_cast<size_t>(point)].pos;
+		monitorData.timestamp = { static_cast<time_t>(time_us / 1000000), static_cast<suseconds_t>(time_us % 1000000) };
+		for (int object = 0; object < nObjects; ++object) {
+			const double offset_m = 0.01 * (object % 50);
+			monitorData.position.xCoord_m = planned.xCoord_m - offset_m * std::sin(planned.heading_rad);
+			monitorData.position.yCoord_m = planned.yCoord_m + offset_m * std::cos(planned.heading_rad);
+			monitorData.position.heading_rad = planned.heading_rad + 0.01;
+			benchmark::DoNotOptimize(processDeviationMonitorData(
+										 monitor, TEST_TRANSMITTER_ID_1 + static_cast<uint32_t>(object),
+										 &monitorData, &monitorData.timestamp, &deviation));
+		}
+		benchmark::DoNotOptimize(popDeviationEvents(monitor, events, 16));
+		if (++point == nPoints) {
+			point = 0;
+			setDeviationStartTime(monitor, &start);
+		}
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * nObjects);
+	freeDeviationMonitor(monitor);
+}
+BENCHMARK(BM_processDeviationMonitorData)->Args({ 16, 60000 })->Args({ 1000, 6000 });
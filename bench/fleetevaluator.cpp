@@ -0,0 +1,47 @@
+#include "benchdefines.h"
+#include <vector>
+extern "C" {
+#include "fleetevaluator.h"
+}
+
+/*! Planned states of a fleet evaluated at 100 Hz, each object on a trajectory with points every
+ *  10 ms. Items are object states. */
+static void BM_evaluateFleetPlannedStates(benchmark::State& state) {
+	const int nObjects = static_cast<int>(state.range(0));
+	const int nPoints = static_cast<int>(state.range(1));
+	FleetEvaluatorType* evaluator = createFleetEvaluator();
+	std::vector<TrajectoryWaypointType> waypoints(static_cast<size_t>(nPoints));
+
+	for (int object = 0; object < nObjects; ++object) {
+		for (int i = 0; i < nPoints; ++i) {
+			TrajectoryWaypointType& waypoint = waypoints[static_cast<size_t>(i)];
+			waypoint.relativeTime = { static_cast<time_t>(i / 100), static_cast<suseconds_t>((i % 100) * 10000) };
+			waypoint.pos = makeBenchPosition();
+			waypoint.pos.xCoord_m += 0.1 * i + object;
+			waypoint.spd = makeBenchSpeed();
+			waypoint.acc = makeBenchAcceleration();
+			waypoint.curvature = 0.01f;
+		}
+		setFleetTrajectory(evaluator, TEST_TRANSMITTER_ID_1 + static_cast<uint32_t>(object),
+						   waypoints.data(), waypoints.size());
+	}
+	StartMessageType start;
+	start.startTime = makeBenchTime();
+	start.isTimestampValid = true;
+	setFleetStartTime(evaluator, &start);
+
+	FleetPlannedStatesType states;
+	const int64_t duration_us = static_cast<int64_t>(nPoints) * 10000;
+	int64_t elapsed_us = 0;
+	for (auto _ : state) {
+		const int64_t time_us = start.startTime.tv_sec * 1000000LL + start.startTime.tv_usec + elapsed_us;
+		const struct timeval time = { static_cast<time_t>(time_us / 1000000),
+									  static_cast<suseconds_t>(time_us % 1000000) };
+		benchmark::DoNotOptimize(evaluateFleetPlannedStates(evaluator, &time, &states));
+		benchmark::DoNotOptimize(states.x_m);
+		elapsed_us = (elapsed_us + 10000) % duration_us;
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * nObjects);
+	freeFleetEvaluator(evaluator);
+}
+BENCHMARK(BM_evaluateFleetPlannedStates)->Args({ 16, 100000 })->Args({ 256, 10000 })->Args({ 1024, 1000 });
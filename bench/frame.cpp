@@ -0,0 +1,75 @@
+#include "benchdefines.h"
+#include <vector>
+extern "C" {
+#include "frame.h"
+#include "relay.h"
+}
+
+static std::vector<char> encodeBenchMONR(const uint8_t counter) {
+	MessageHeaderType header = makeBenchHeader();
+	header.messageCounter = counter;
+	struct timeval time = makeBenchTime();
+	std::vector<char> buffer(256);
+	ssize_t length = encodeMONRMessage(&header, &time, makeBenchPosition(), makeBenchSpeed(), makeBenchAcceleration(),
+									   ISO_DRIVE_DIRECTION_FORWARD, ISO_OBJECT_STATE_RUNNING, ISO_READY_TO_ARM, 0, 0,
+									   buffer.data(), buffer.size(), false);
+	buffer.resize(length > 0 ? static_cast<size_t>(length) : 0);
+	return buffer;
+}
+
+static void BM_validateISOFrame(benchmark::State& state) {
+	const std::vector<char> message = encodeBenchMONR(0);
+	HeaderType header;
+	if (message.empty() || validateISOFrame(message.data(), message.size(), &header) < 0) {
+		state.SkipWithError("Unable to encode MONR");
+		return;
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(validateISOFrame(message.data(), message.size(), &header));
+	}
+	setMessageCounters(state, message.size());
+}
+BENCHMARK(BM_validateISOFrame);
+
+//! Batch of datagrams as received with recvmmsg, range is the batch size
+static void BM_validateISOFrames(benchmark::State& state) {
+	const size_t nFrames = static_cast<size_t>(state.range(0));
+	std::vector<std::vector<char>> messages;
+	std::vector<const void*> frames;
+	std::vector<size_t> lengths;
+	for (size_t i = 0; i < nFrames; ++i) {
+		messages.push_back(encodeBenchMONR(static_cast<uint8_t>(i)));
+	}
+	for (const auto& message : messages) {
+		frames.push_back(message.data());
+		lengths.push_back(message.size());
+	}
+	std::vector<HeaderType> headers(nFrames);
+	std::vector<ssize_t> results(nFrames);
+	if (validateISOFrames(frames.data(), lengths.data(), nFrames, headers.data(), results.data()) != nFrames) {
+		state.SkipWithError("Unable to encode MONR");
+		return;
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(validateISOFrames(frames.data(), lengths.data(), nFrames, headers.data(),
+												   results.data()));
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nFrames));
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * nFrames * messages[0].size()));
+}
+BENCHMARK(BM_validateISOFrames)->Arg(1)->Arg(16)->Arg(64);
+
+static void BM_rewriteISOFrameIDs(benchmark::State& state) {
+	std::vector<char> message = encodeBenchMONR(0);
+	if (message.empty()) {
+		state.SkipWithError("Unable to encode MONR");
+		return;
+	}
+	uint32_t receiverID = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(rewriteISOFrameIDs(message.data(), message.size(), RELAY_FIELD_RECEIVER_ID, 0,
+													++receiverID));
+	}
+	setMessageCounters(state, message.size());
+}
+BENCHMARK(BM_rewriteISOFrameIDs);
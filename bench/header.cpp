@@ -0,0 +1,71 @@
+#include "benchdefines.h"
+#include <vector>
+extern "C" {
+#include "header.h"
+#include "footer.h"
+}
+
+static std::vector<char> encodeBenchMONR() {
+	MessageHeaderType header = makeBenchHeader();
+	struct timeval time = makeBenchTime();
+	std::vector<char> buffer(256);
+	ssize_t length = encodeMONRMessage(&header, &time, makeBenchPosition(), makeBenchSpeed(), makeBenchAcceleration(),
+									   ISO_DRIVE_DIRECTION_FORWARD, ISO_OBJECT_STATE_RUNNING, ISO_READY_TO_ARM, 0, 0,
+									   buffer.data(), buffer.size(), false);
+	buffer.resize(length > 0 ? static_cast<size_t>(length) : 0);
+	return buffer;
+}
+
+static void BM_crc16(benchmark::State& state) {
+	std::vector<uint8_t> data(static_cast<size_t>(state.range(0)));
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = static_cast<uint8_t>(i * 31 + 7);
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(crc16(data.data(), data.size()));
+	}
+	setMessageCounters(state, data.size());
+}
+BENCHMARK(BM_crc16)->Arg(57)->Arg(1024)->Arg(64 * 1024);
+
+static void BM_decodeISOHeader(benchmark::State& state) {
+	const std::vector<char> message = encodeBenchMONR();
+	HeaderType header;
+	if (message.empty() || decodeISOHeader(message.data(), message.size(), &header, false) != MESSAGE_OK) {
+		state.SkipWithError("Unable to encode MONR");
+		return;
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(decodeISOHeader(message.data(), message.size(), &header, false));
+	}
+	setMessageCounters(state, sizeof(HeaderType));
+}
+BENCHMARK(BM_decodeISOHeader);
+
+static void BM_decodeISOFooter(benchmark::State& state) {
+	const std::vector<char> message = encodeBenchMONR();
+	FooterType footer;
+	if (message.empty()) {
+		state.SkipWithError("Unable to encode MONR");
+		return;
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(decodeISOFooter(message.data() + message.size() - sizeof(FooterType),
+												 sizeof(FooterType), &footer, false));
+	}
+	setMessageCounters(state, sizeof(FooterType));
+}
+BENCHMARK(BM_decodeISOFooter);
+
+static void BM_getISOMessageType(benchmark::State& state) {
+	const std::vector<char> message = encodeBenchMONR();
+	if (message.empty() || getISOMessageType(message.data(), message.size(), false) != MESSAGE_ID_MONR) {
+		state.SkipWithError("Unable to encode MONR");
+		return;
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(getISOMessageType(message.data(), message.size(), false));
+	}
+	setMessageCounters(state, message.size());
+}
+BENCHMARK(BM_getISOMessageType);
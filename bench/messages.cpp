@@ -0,0 +1,438 @@
+#include "benchdefines.h"
+extern "C" {
+#include "header.h"
+#include "footer.h"
+}
+
+static const MessageHeaderType header = makeBenchHeader();
+
+// STRT
+
+static ssize_t encodeBenchSTRT(char* buffer, const size_t length) {
+	StartMessageType start;
+	start.startTime = makeBenchTime();
+	start.isTimestampValid = true;
+	return encodeSTRTMessage(&header, &start, buffer, length, false);
+}
+static void BM_encodeSTRTMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchSTRT);
+}
+BENCHMARK(BM_encodeSTRTMessage);
+static void BM_decodeSTRTMessage(benchmark::State& state) {
+	const struct timeval now = makeBenchTime();
+	StartMessageType start;
+	runDecodeBenchmark(state, encodeBenchSTRT, [&](const char* buffer, size_t length) {
+		return decodeSTRTMessage(buffer, length, &now, &start, false);
+	});
+}
+BENCHMARK(BM_decodeSTRTMessage);
+
+// OSEM
+
+static ssize_t encodeBenchOSEM(char* buffer, const size_t length) {
+	ObjectSettingsType settings;
+	memset(&settings, 0, sizeof(settings));
+	settings.desiredID.transmitter = TEST_RECEIVER_ID_2;
+	settings.desiredID.subTransmitter = 0x5678;
+	settings.coordinateSystemOrigin.latitude_deg = 57.7773716086;
+	settings.coordinateSystemOrigin.longitude_deg = 12.7804629583;
+	settings.coordinateSystemOrigin.altitude_m = 201.46;
+	settings.coordinateSystemOrigin.isLatitudeValid = true;
+	settings.coordinateSystemOrigin.isLongitudeValid = true;
+	settings.coordinateSystemOrigin.isAltitudeValid = true;
+	settings.coordinateSystemRotation_rad = 0.45678;
+	settings.coordinateSystemType = COORDINATE_SYSTEM_WGS84;
+	settings.currentTime = makeBenchTime();
+	settings.maxDeviation.position_m = 0.5;
+	settings.maxDeviation.lateral_m = 0.25;
+	settings.maxDeviation.yaw_rad = 0.1;
+	settings.minRequiredPositioningAccuracy_m = 0.05;
+	settings.heabTimeout.tv_usec = 100000;
+	settings.testMode = TEST_MODE_SCENARIO;
+	settings.rate.monr = 100;
+	settings.rate.monr2 = 10;
+	settings.rate.heab = 100;
+	return encodeOSEMMessage(&header, &settings, buffer, length, false);
+}
+static void BM_encodeOSEMMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchOSEM);
+}
+BENCHMARK(BM_encodeOSEMMessage);
+static void BM_decodeOSEMMessage(benchmark::State& state) {
+	ObjectSettingsType settings;
+	runDecodeBenchmark(state, encodeBenchOSEM, [&](const char* buffer, size_t length) {
+		return decodeOSEMMessage(&settings, buffer, length, false);
+	});
+}
+BENCHMARK(BM_decodeOSEMMessage);
+
+// OSTM
+
+static ssize_t encodeBenchOSTM(char* buffer, const size_t length) {
+	return encodeOSTMMessage(&header, OBJECT_COMMAND_ARM, buffer, length, false);
+}
+static void BM_encodeOSTMMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchOSTM);
+}
+BENCHMARK(BM_encodeOSTMMessage);
+static void BM_decodeOSTMMessage(benchmark::State& state) {
+	enum ObjectCommandType command;
+	runDecodeBenchmark(state, encodeBenchOSTM, [&](const char* buffer, size_t length) {
+		return decodeOSTMMessage(buffer, length, &command, false);
+	});
+}
+BENCHMARK(BM_decodeOSTMMessage);
+
+// HEAB
+
+static ssize_t encodeBenchHEAB(char* buffer, const size_t length) {
+	const struct timeval time = makeBenchTime();
+	return encodeHEABMessage(&header, &time, CONTROL_CENTER_STATUS_RUNNING, buffer, length, false);
+}
+static void BM_encodeHEABMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchHEAB);
+}
+BENCHMARK(BM_encodeHEABMessage);
+static void BM_decodeHEABMessage(benchmark::State& state) {
+	const struct timeval now = makeBenchTime();
+	HeabMessageDataType heab;
+	runDecodeBenchmark(state, encodeBenchHEAB, [&](const char* buffer, size_t length) {
+		return decodeHEABMessage(buffer, length, now, &heab, false);
+	});
+}
+BENCHMARK(BM_decodeHEABMessage);
+
+// SYPM, MTSP
+
+static void BM_encodeSYPMMessage(benchmark::State& state) {
+	const struct timeval synchronizationTime = { 12, 500000 }, freezeTime = { 11, 0 };
+	runEncodeBenchmark(state, [&](char* buffer, size_t length) {
+		return encodeSYPMMessage(&header, synchronizationTime, freezeTime, buffer, length, false);
+	});
+}
+BENCHMARK(BM_encodeSYPMMessage);
+static void BM_encodeMTSPMessage(benchmark::State& state) {
+	const struct timeval time = makeBenchTime();
+	runEncodeBenchmark(state, [&](char* buffer, size_t length) {
+		return encodeMTSPMessage(&header, &time, buffer, length, false);
+	});
+}
+BENCHMARK(BM_encodeMTSPMessage);
+
+// TRCM, ACCM, EXAC
+
+static void BM_encodeTRCMMessage(benchmark::State& state) {
+	const uint16_t triggerID = 1;
+	const enum TriggerType_t type = TRIGGER_BRAKE;
+	const enum TriggerTypeParameter_t parameter = TRIGGER_PARAMETER_PRESSED;
+	runEncodeBenchmark(state, [&](char* buffer, size_t length) {
+		return encodeTRCMMessage(&header, &triggerID, &type, &parameter, nullptr, nullptr, buffer, length, false);
+	});
+}
+BENCHMARK(BM_encodeTRCMMessage);
+static void BM_encodeACCMMessage(benchmark::State& state) {
+	const uint16_t actionID = 2;
+	const enum ActionType_t type = ACTION_MISC_DIGITAL_OUTPUT;
+	const enum ActionTypeParameter_t parameter = ACTION_PARAMETER_SET_TRUE;
+	runEncodeBenchmark(state, [&](char* buffer, size_t length) {
+		return encodeACCMMessage(&header, &actionID, &type, &parameter, nullptr, nullptr, buffer, length, false);
+	});
+}
+BENCHMARK(BM_encodeACCMMessage);
+static void BM_encodeEXACMessage(benchmark::State& state) {
+	const uint16_t actionID = 2;
+	const struct timeval time = makeBenchTime();
+	runEncodeBenchmark(state, [&](char* buffer, size_t length) {
+		return encodeEXACMessage(&header, &actionID, &time, buffer, length, false);
+	});
+}
+BENCHMARK(BM_encodeEXACMessage);
+
+// RCMM, DCMM
+
+static RemoteControlManoeuvreMessageType makeBenchManoeuvre() {
+	RemoteControlManoeuvreMessageType manoeuvre;
+	memset(&manoeuvre, 0, sizeof(manoeuvre));
+	manoeuvre.status = 1;
+	manoeuvre.command = MANOEUVRE_NONE;
+	manoeuvre.steeringManoeuvre.rad = 0.12;
+	manoeuvre.steeringUnit = ISO_UNIT_TYPE_STEERING_DEGREES;
+	manoeuvre.isSteeringManoeuvreValid = true;
+	manoeuvre.speedManoeuvre.m_s = 5.5;
+	manoeuvre.speedUnit = ISO_UNIT_TYPE_SPEED_METER_SECOND;
+	manoeuvre.isSpeedManoeuvreValid = true;
+	manoeuvre.throttleManoeuvre.pct = 20;
+	manoeuvre.throttleUnit = ISO_UNIT_TYPE_THROTTLE_PERCENTAGE;
+	manoeuvre.isThrottleManoeuvreValid = true;
+	manoeuvre.brakeManoeuvre.pct = 0;
+	manoeuvre.brakeUnit = ISO_UNIT_TYPE_BRAKE_PERCENTAGE;
+	manoeuvre.isBrakeManoeuvreValid = true;
+	return manoeuvre;
+}
+//! The manoeuvre decoders lack throttle and brake, which the encoder requires, so these are removed
+static ssize_t removeThrottleAndBrake(char* buffer, const ssize_t length) {
+	const uint16_t throttleValueID = 0x0033, brakeValueID = 0x0034;
+	size_t in = sizeof(HeaderType), out = sizeof(HeaderType);
+	if (length < 0) {
+		return length;
+	}
+	while (in + 4 <= static_cast<size_t>(length) - sizeof(FooterType)) {
+		uint16_t valueID, contentLength;
+		memcpy(&valueID, buffer + in, sizeof(valueID));
+		memcpy(&contentLength, buffer + in + 2, sizeof(contentLength));
+		const size_t entryLength = 4 + contentLength;
+		if (valueID != throttleValueID && valueID != brakeValueID) {
+			memmove(buffer + out, buffer + in, entryLength);
+			out += entryLength;
+		}
+		in += entryLength;
+	}
+	const uint32_t messageLength = static_cast<uint32_t>(out - sizeof(HeaderType));
+	memcpy(buffer + 2, &messageLength, sizeof(messageLength));
+	const uint16_t crc = crc16(reinterpret_cast<const uint8_t*>(buffer), out);
+	memcpy(buffer + out, &crc, sizeof(crc));
+	return static_cast<ssize_t>(out + sizeof(crc));
+}
+
+static ssize_t encodeBenchRCMM(char* buffer, const size_t length) {
+	const RemoteControlManoeuvreMessageType manoeuvre = makeBenchManoeuvre();
+	return encodeRCMMMessage(&header, &manoeuvre, buffer, length, false);
+}
+static void BM_encodeRCMMMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchRCMM);
+}
+BENCHMARK(BM_encodeRCMMMessage);
+static void BM_decodeRCMMMessage(benchmark::State& state) {
+	RemoteControlManoeuvreMessageType manoeuvre;
+	auto encode = [](char* buffer, size_t length) { return removeThrottleAndBrake(buffer, encodeBenchRCMM(buffer, length)); };
+	runDecodeBenchmark(state, encode, [&](const char* buffer, size_t length) {
+		return decodeRCMMMessage(buffer, length, &manoeuvre, false);
+	});
+}
+BENCHMARK(BM_decodeRCMMMessage);
+static ssize_t encodeBenchDCMM(char* buffer, const size_t length) {
+	const RemoteControlManoeuvreMessageType manoeuvre = makeBenchManoeuvre();
+	return encodeDCMMMessage(&header, &manoeuvre, buffer, length, false);
+}
+static void BM_encodeDCMMMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchDCMM);
+}
+BENCHMARK(BM_encodeDCMMMessage);
+static void BM_decodeDCMMMessage(benchmark::State& state) {
+	RemoteControlManoeuvreMessageType manoeuvre;
+	auto encode = [](char* buffer, size_t length) { return removeThrottleAndBrake(buffer, encodeBenchDCMM(buffer, length)); };
+	runDecodeBenchmark(state, encode, [&](const char* buffer, size_t length) {
+		return decodeDCMMMessage(buffer, length, &manoeuvre, false);
+	});
+}
+BENCHMARK(BM_decodeDCMMMessage);
+
+// GREM
+
+static ssize_t encodeBenchGREM(char* buffer, const size_t length) {
+	GeneralResponseMessageType response;
+	memset(&response, 0, sizeof(response));
+	response.receivedHeaderTransmitterID = TEST_TRANSMITTER_ID_2;
+	response.receivedHeaderMessageCounter = 3;
+	response.receivedHeaderMessageID = MESSAGE_ID_TRAJ;
+	response.responseCode = GREM_OK;
+	return encodeGREMMessage(&header, &response, buffer, length, false);
+}
+static void BM_encodeGREMMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchGREM);
+}
+BENCHMARK(BM_encodeGREMMessage);
+static void BM_decodeGREMMessage(benchmark::State& state) {
+	GeneralResponseMessageType response;
+	runDecodeBenchmark(state, encodeBenchGREM, [&](const char* buffer, size_t length) {
+		return decodeGREMMessage(buffer, length, &response, false);
+	});
+}
+BENCHMARK(BM_decodeGREMMessage);
+
+// DREQ, DRES
+
+static ssize_t encodeBenchDREQ(char* buffer, const size_t length) {
+	return encodeDREQMessage(&header, buffer, length, false);
+}
+static void BM_encodeDREQMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchDREQ);
+}
+BENCHMARK(BM_encodeDREQMessage);
+static void BM_decodeDREQMessage(benchmark::State& state) {
+	TestObjectDiscoveryRequestType request;
+	runDecodeBenchmark(state, encodeBenchDREQ, [&](const char* buffer, size_t length) {
+		return decodeDREQMessage(buffer, length, &request, false);
+	});
+}
+BENCHMARK(BM_decodeDREQMessage);
+static ssize_t encodeBenchDRES(char* buffer, const size_t length) {
+	TestObjectDiscoveryType discovery;
+	memset(&discovery, 0, sizeof(discovery));
+	strcpy(discovery.vendor, "RISE");
+	strcpy(discovery.productName, "Test object");
+	strcpy(discovery.firmwareVersion, "1.2.3");
+	strcpy(discovery.testObjectName, "Benchmark car");
+	discovery.testObjectTypeCode = OBJECT_TYPE_MOVEABLE;
+	discovery.subDeviceId = 1;
+	return encodeDRESMessage(&header, &discovery, buffer, length, false);
+}
+static void BM_encodeDRESMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchDRES);
+}
+BENCHMARK(BM_encodeDRESMessage);
+static void BM_decodeDRESMessage(benchmark::State& state) {
+	TestObjectDiscoveryType discovery;
+	runDecodeBenchmark(state, encodeBenchDRES, [&](const char* buffer, size_t length) {
+		return decodeDRESMessage(buffer, length, &discovery, false);
+	});
+}
+BENCHMARK(BM_decodeDRESMessage);
+
+// INSUP
+
+static void BM_encodeINSUPMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, [&](char* buffer, size_t length) {
+		return encodeINSUPMessage(&header, SUPERVISOR_COMMAND_NORMAL, buffer, length, false);
+	});
+}
+BENCHMARK(BM_encodeINSUPMessage);
+
+// DCTI, GDRM, RDCA
+
+static ssize_t encodeBenchDCTI(char* buffer, const size_t length) {
+	DctiMessageDataType dcti = { 2, 1, TEST_TRANSMITTER_ID_2 };
+	return encodeDCTIMessage(&header, &dcti, buffer, length, false);
+}
+static void BM_encodeDCTIMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchDCTI);
+}
+BENCHMARK(BM_encodeDCTIMessage);
+static void BM_decodeDCTIMessage(benchmark::State& state) {
+	DctiMessageDataType dcti;
+	runDecodeBenchmark(state, encodeBenchDCTI, [&](const char* buffer, size_t length) {
+		return decodeDCTIMessage(buffer, length, &dcti, false);
+	});
+}
+BENCHMARK(BM_decodeDCTIMessage);
+static ssize_t encodeBenchGDRM(char* buffer, const size_t length) {
+	GdrmMessageDataType gdrm = { DIRECT_CONTROL_TRANSMITTER_ID_REQUEST };
+	return encodeGDRMMessage(&header, &gdrm, buffer, length, false);
+}
+static void BM_encodeGDRMMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchGDRM);
+}
+BENCHMARK(BM_encodeGDRMMessage);
+static void BM_decodeGDRMMessage(benchmark::State& state) {
+	GdrmMessageDataType gdrm;
+	runDecodeBenchmark(state, encodeBenchGDRM, [&](const char* buffer, size_t length) {
+		return decodeGDRMMessage(buffer, length, &gdrm, false);
+	});
+}
+BENCHMARK(BM_decodeGDRMMessage);
+static ssize_t encodeBenchRDCA(char* buffer, const size_t length) {
+	RequestControlActionType action;
+	memset(&action, 0, sizeof(action));
+	action.executingID = TEST_TRANSMITTER_ID_2;
+	action.dataTimestamp = makeBenchTime();
+	action.steeringAction.rad = 0.05;
+	action.steeringUnit = ISO_UNIT_TYPE_STEERING_DEGREES;
+	action.isSteeringActionValid = true;
+	action.speedAction.m_s = 8.3;
+	action.speedUnit = ISO_UNIT_TYPE_SPEED_METER_SECOND;
+	action.isSpeedActionValid = true;
+	return encodeRDCAMessage(&header, &action, buffer, length, false);
+}
+static void BM_encodeRDCAMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchRDCA);
+}
+BENCHMARK(BM_encodeRDCAMessage);
+static void BM_decodeRDCAMessage(benchmark::State& state) {
+	const struct timeval now = makeBenchTime();
+	RequestControlActionType action;
+	runDecodeBenchmark(state, encodeBenchRDCA, [&](const char* buffer, size_t length) {
+		return decodeRDCAMessage(buffer, &action, length, now, false);
+	});
+}
+BENCHMARK(BM_decodeRDCAMessage);
+
+// PODI, OPRO, FOPR
+
+static ssize_t encodeBenchPODI(char* buffer, const size_t length) {
+	PeerObjectInjectionType peer;
+	memset(&peer, 0, sizeof(peer));
+	peer.foreignTransmitterID = TEST_TRANSMITTER_ID_2;
+	peer.dataTimestamp = makeBenchTime();
+	peer.state = OBJECT_STATE_RUNNING;
+	peer.position = makeBenchPosition();
+	peer.speed = makeBenchSpeed();
+	peer.pitch_rad = 0.01;
+	peer.roll_rad = -0.02;
+	peer.isPitchValid = peer.isRollValid = true;
+	return encodePODIMessage(&header, &peer, buffer, length, false);
+}
+static void BM_encodePODIMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchPODI);
+}
+BENCHMARK(BM_encodePODIMessage);
+static void BM_decodePODIMessage(benchmark::State& state) {
+	const struct timeval now = makeBenchTime();
+	PeerObjectInjectionType peer;
+	runDecodeBenchmark(state, encodeBenchPODI, [&](const char* buffer, size_t length) {
+		return decodePODIMessage(buffer, length, now, &peer, false);
+	});
+}
+BENCHMARK(BM_decodePODIMessage);
+
+template <typename PropertiesType>
+static void fillBenchProperties(PropertiesType& properties) {
+	properties.objectType = OBJECT_CATEGORY_CAR;
+	properties.actorType = ACTOR_TYPE_REAL_OBJECT;
+	properties.operationMode = OPERATION_MODE_PREDEFINED_TRAJECTORY;
+	properties.mass_kg = 1650;
+	properties.objectXDimension_m = 4.7;
+	properties.objectYDimension_m = 1.9;
+	properties.objectZDimension_m = 1.5;
+	properties.positionDisplacementX_m = 1.2;
+	properties.positionDisplacementY_m = 0;
+	properties.positionDisplacementZ_m = 0.3;
+	properties.isMassValid = properties.isObjectXDimensionValid = properties.isObjectYDimensionValid = true;
+	properties.isObjectZDimensionValid = properties.isObjectXDisplacementValid = true;
+	properties.isObjectYDisplacementValid = properties.isObjectZDisplacementValid = true;
+}
+static ssize_t encodeBenchOPRO(char* buffer, const size_t length) {
+	ObjectPropertiesType properties;
+	memset(&properties, 0, sizeof(properties));
+	properties.objectID = TEST_TRANSMITTER_ID_1;
+	fillBenchProperties(properties);
+	return encodeOPROMessage(&header, &properties, buffer, length, false);
+}
+static void BM_encodeOPROMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchOPRO);
+}
+BENCHMARK(BM_encodeOPROMessage);
+static void BM_decodeOPROMessage(benchmark::State& state) {
+	ObjectPropertiesType properties;
+	runDecodeBenchmark(state, encodeBenchOPRO, [&](const char* buffer, size_t length) {
+		return decodeOPROMessage(&properties, buffer, length, false);
+	});
+}
+BENCHMARK(BM_decodeOPROMessage);
+static ssize_t encodeBenchFOPR(char* buffer, const size_t length) {
+	ForeignObjectPropertiesType properties;
+	memset(&properties, 0, sizeof(properties));
+	properties.foreignTransmitterID = TEST_TRANSMITTER_ID_2;
+	fillBenchProperties(properties);
+	return encodeFOPRMessage(&header, &properties, buffer, length, false);
+}
+static void BM_encodeFOPRMessage(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchFOPR);
+}
+BENCHMARK(BM_encodeFOPRMessage);
+static void BM_decodeFOPRMessage(benchmark::State& state) {
+	ForeignObjectPropertiesType properties;
+	runDecodeBenchmark(state, encodeBenchFOPR, [&](const char* buffer, size_t length) {
+		return decodeFOPRMessage(&properties, buffer, length, false);
+	});
+}
+BENCHMARK(BM_decodeFOPRMessage);
@@ -0,0 +1,79 @@
+#include "benchdefines.h"
+extern "C" {
+#include "monr.h"
+}
+
+static ssize_t encodeBenchMONR(char* buffer, const size_t bufferLength) {
+	MessageHeaderType header = makeBenchHeader();
+	struct timeval time = makeBenchTime();
+	return encodeMONRMessage(&header, &time, makeBenchPosition(), makeBenchSpeed(), makeBenchAcceleration(),
+							 ISO_DRIVE_DIRECTION_FORWARD, ISO_OBJECT_STATE_RUNNING, ISO_READY_TO_ARM, 0, 0,
+							 buffer, bufferLength, false);
+}
+
+static void BM_encodeMONRMessage(benchmark::State& state) {
+	MessageHeaderType header = makeBenchHeader();
+	struct timeval time = makeBenchTime();
+	const CartesianPosition position = makeBenchPosition();
+	const SpeedType speed = makeBenchSpeed();
+	const AccelerationType acceleration = makeBenchAcceleration();
+	char buffer[sizeof(MONRType)];
+	ssize_t length = 0;
+	for (auto _ : state) {
+		length = encodeMONRMessage(&header, &time, position, speed, acceleration, ISO_DRIVE_DIRECTION_FORWARD,
+								   ISO_OBJECT_STATE_RUNNING, ISO_READY_TO_ARM, 0, 0, buffer, sizeof(buffer), false);
+		benchmark::DoNotOptimize(buffer);
+	}
+	setMessageCounters(state, static_cast<size_t>(length));
+}
+BENCHMARK(BM_encodeMONRMessage);
+
+static void BM_decodeMONRMessage(benchmark::State& state) {
+	char buffer[sizeof(MONRType)];
+	const ssize_t length = encodeBenchMONR(buffer, sizeof(buffer));
+	const struct timeval now = makeBenchTime();
+	ObjectMonitorType monitor;
+	if (length < 0 || decodeMONRMessage(buffer, sizeof(buffer), now, &monitor, false) < 0) {
+		state.SkipWithError("Unable to encode MONR");
+		return;
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(decodeMONRMessage(buffer, sizeof(buffer), now, &monitor, false));
+	}
+	setMessageCounters(state, static_cast<size_t>(length));
+}
+BENCHMARK(BM_decodeMONRMessage);
+
+static void BM_encodeMONRMessageFromSample(benchmark::State& state) {
+	char buffer[sizeof(MONRType)];
+	const ssize_t encoded = encodeBenchMONR(buffer, sizeof(buffer));
+	MessageHeaderType header = makeBenchHeader();
+	MonitorSampleType sample;
+	ssize_t length = 0;
+	if (encoded < 0 || decodeMONRMessageToSample(buffer, sizeof(buffer), makeBenchTime(), &sample, false) < 0) {
+		state.SkipWithError("Unable to encode MONR");
+		return;
+	}
+	for (auto _ : state) {
+		length = encodeMONRMessageFromSample(&header, &sample, buffer, sizeof(buffer), false);
+		benchmark::DoNotOptimize(buffer);
+	}
+	setMessageCounters(state, static_cast<size_t>(length));
+}
+BENCHMARK(BM_encodeMONRMessageFromSample);
+
+static void BM_decodeMONRMessageToSample(benchmark::State& state) {
+	char buffer[sizeof(MONRType)];
+	const ssize_t length = encodeBenchMONR(buffer, sizeof(buffer));
+	const struct timeval now = makeBenchTime();
+	MonitorSampleType sample;
+	if (length < 0 || decodeMONRMessageToSample(buffer, sizeof(buffer), now, &sample, false) < 0) {
+		state.SkipWithError("Unable to encode MONR");
+		return;
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(decodeMONRMessageToSample(buffer, sizeof(buffer), now, &sample, false));
+	}
+	setMessageCounters(state, static_cast<size_t>(length));
+}
+BENCHMARK(BM_decodeMONRMessageToSample);
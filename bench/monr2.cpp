@@ -0,0 +1,70 @@
+#include "benchdefines.h"
+#include <vector>
+extern "C" {
+#include "monr2.h"
+}
+
+static ObjectMonitor2Type makeBenchMonitor2() {
+	ObjectMonitor2Type data;
+	memset(&data, 0, sizeof(data));
+	data.timestamp = makeBenchTime();
+	data.isTimestampValid = true;
+	data.pitch_rad = 0.05;
+	data.roll_rad = -0.02;
+	data.verticalSpeed_m_s = 0.1;
+	data.yawRate_rad_s = 0.3;
+	data.positionAccuracy_m = 0.02;
+	data.isPitchValid = data.isRollValid = data.isVerticalSpeedValid = true;
+	data.isYawRateValid = data.isPositionAccuracyValid = true;
+	return data;
+}
+
+static ssize_t encodeBenchMONR2(char* buffer, const size_t length) {
+	const MessageHeaderType header = makeBenchHeader();
+	const ObjectMonitor2Type data = makeBenchMonitor2();
+	return encodeMONR2Message(&header, &data, buffer, length, false);
+}
+static void BM_encodeMONR2Message(benchmark::State& state) {
+	runEncodeBenchmark(state, encodeBenchMONR2);
+}
+BENCHMARK(BM_encodeMONR2Message);
+static void BM_decodeMONR2Message(benchmark::State& state) {
+	const struct timeval now = makeBenchTime();
+	ObjectMonitor2Type data;
+	runDecodeBenchmark(state, encodeBenchMONR2, [&](const char* buffer, size_t length) {
+		return decodeMONR2Message(buffer, length, now, &data, false);
+	});
+}
+BENCHMARK(BM_decodeMONR2Message);
+static void BM_viewMONR2Message(benchmark::State& state) {
+	MONR2ViewType view;
+	runDecodeBenchmark(state, encodeBenchMONR2, [&](const char* buffer, size_t length) {
+		return viewMONR2Message(buffer, length, &view);
+	});
+}
+BENCHMARK(BM_viewMONR2Message);
+
+//! Range is the number of messages decoded per call, items are messages
+static void BM_decodeMONR2Messages(benchmark::State& state) {
+	const size_t nFrames = static_cast<size_t>(state.range(0));
+	std::vector<char> buffer(nFrames * sizeof(MONR2Type));
+	std::vector<const void*> frames(nFrames);
+	std::vector<size_t> lengths(nFrames, sizeof(MONR2Type));
+	std::vector<ObjectMonitor2Type> data(nFrames);
+	std::vector<ssize_t> results(nFrames);
+	const struct timeval now = makeBenchTime();
+
+	for (size_t i = 0; i < nFrames; ++i) {
+		frames[i] = &buffer[i * sizeof(MONR2Type)];
+		encodeBenchMONR2(&buffer[i * sizeof(MONR2Type)], sizeof(MONR2Type));
+	}
+	if (decodeMONR2Messages(frames.data(), lengths.data(), nFrames, now, data.data(), results.data()) != nFrames) {
+		state.SkipWithError("Unable to decode MONR2");
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(decodeMONR2Messages(frames.data(), lengths.data(), nFrames, now, data.data(),
+													 results.data()));
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nFrames));
+}
+BENCHMARK(BM_decodeMONR2Messages)->Arg(8)->Arg(64);
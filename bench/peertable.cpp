@@ -0,0 +1,69 @@
+#include "benchdefines.h"
+#include <vector>
+extern "C" {
+#include "peertable.h"
+}
+
+static std::vector<std::vector<char>> encodeBenchPeers(const uint32_t nPeers) {
+	MessageHeaderType header = makeBenchHeader();
+	std::vector<std::vector<char>> messages;
+	for (uint32_t id = 1; id <= nPeers; ++id) {
+		PeerObjectInjectionType peer;
+		memset(&peer, 0, sizeof(peer));
+		peer.foreignTransmitterID = id;
+		peer.dataTimestamp = makeBenchTime();
+		peer.state = OBJECT_STATE_RUNNING;
+		peer.position = makeBenchPosition();
+		peer.speed = makeBenchSpeed();
+		std::vector<char> message(getEncodedSizePODIMessage());
+		const ssize_t length = encodePODIMessage(&header, &peer, message.data(), message.size(), false);
+		message.resize(length > 0 ? static_cast<size_t>(length) : 0);
+		messages.push_back(message);
+	}
+	return messages;
+}
+
+/*! One PODI message per peer, range is the number of peers. The current time is moved a week ahead
+ *  each iteration so that every message is newer than the one held and gets stored. */
+static void BM_decodePODIMessages(benchmark::State& state) {
+	const size_t nPeers = static_cast<size_t>(state.range(0));
+	const std::vector<std::vector<char>> messages = encodeBenchPeers(static_cast<uint32_t>(nPeers));
+	std::vector<const void*> frames;
+	std::vector<size_t> lengths;
+	for (const auto& message : messages) {
+		frames.push_back(message.data());
+		lengths.push_back(message.size());
+	}
+	std::vector<ssize_t> results(nPeers);
+	PeerTableType* table = createPeerTable(nPeers);
+	struct timeval now = makeBenchTime();
+
+	if (decodePODIMessages(table, frames.data(), lengths.data(), nPeers, now, results.data()) != nPeers) {
+		state.SkipWithError("Unable to decode PODI");
+	}
+	for (auto _ : state) {
+		now.tv_sec += 7 * 24 * 3600;
+		benchmark::DoNotOptimize(decodePODIMessages(table, frames.data(), lengths.data(), nPeers, now,
+													results.data()));
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nPeers));
+	freePeerTable(table);
+}
+BENCHMARK(BM_decodePODIMessages)->Arg(8)->Arg(64)->Arg(256);
+
+//! The same messages decoded one at a time into an array of structs, for comparison
+static void BM_decodePODIMessagesSingly(benchmark::State& state) {
+	const size_t nPeers = static_cast<size_t>(state.range(0));
+	const std::vector<std::vector<char>> messages = encodeBenchPeers(static_cast<uint32_t>(nPeers));
+	std::vector<PeerObjectInjectionType> peers(nPeers);
+	const struct timeval now = makeBenchTime();
+
+	for (auto _ : state) {
+		for (size_t i = 0; i < nPeers; ++i) {
+			benchmark::DoNotOptimize(decodePODIMessage(messages[i].data(), messages[i].size(), now, &peers[i],
+													   false));
+		}
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nPeers));
+}
+BENCHMARK(BM_decodePODIMessagesSingly)->Arg(8)->Arg(64)->Arg(256);
@@ -0,0 +1,62 @@
+#include "benchdefines.h"
+#include <vector>
+extern "C" {
+#include "podifanout.h"
+}
+
+static PeerObjectInjectionType makeBenchPeer(const uint32_t id) {
+	PeerObjectInjectionType peer;
+	memset(&peer, 0, sizeof(peer));
+	peer.foreignTransmitterID = id;
+	peer.dataTimestamp = makeBenchTime();
+	peer.state = OBJECT_STATE_RUNNING;
+	peer.position = makeBenchPosition();
+	peer.position.xCoord_m += id;
+	peer.speed = makeBenchSpeed();
+	return peer;
+}
+
+static ssize_t discardDatagram(const uint32_t, const char* datagram, const size_t length, void*) {
+	benchmark::DoNotOptimize(datagram);
+	return static_cast<ssize_t>(length);
+}
+
+//! One tick with every object receiving all others, range is the number of objects
+static void BM_runPODIFanoutTick(benchmark::State& state) {
+	const uint32_t nObjects = static_cast<uint32_t>(state.range(0));
+	PODIFanoutType* fanout = createPODIFanout(TEST_TRANSMITTER_ID_1, 0);
+	for (uint32_t id = 1; id <= nObjects; ++id) {
+		const PeerObjectInjectionType peer = makeBenchPeer(id);
+		updatePODIFanoutPeer(fanout, &peer);
+		addPODIFanoutReceiver(fanout, id, 0.0);
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(runPODIFanoutTick(fanout, discardDatagram, nullptr));
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nObjects * (nObjects - 1)));
+	freePODIFanout(fanout);
+}
+BENCHMARK(BM_runPODIFanoutTick)->Arg(8)->Arg(32)->Arg(128);
+
+//! The same tick with one encodePODIMessage call per message, for comparison
+static void BM_encodePODIMessagesPerPair(benchmark::State& state) {
+	const uint32_t nObjects = static_cast<uint32_t>(state.range(0));
+	std::vector<PeerObjectInjectionType> peers;
+	for (uint32_t id = 1; id <= nObjects; ++id) {
+		peers.push_back(makeBenchPeer(id));
+	}
+	char buffer[BENCH_BUFFER_SIZE];
+	for (auto _ : state) {
+		for (uint32_t receiver = 1; receiver <= nObjects; ++receiver) {
+			MessageHeaderType header = makeBenchHeader();
+			header.receiverID = receiver;
+			for (const auto& peer : peers) {
+				if (peer.foreignTransmitterID != receiver) {
+					benchmark::DoNotOptimize(encodePODIMessage(&header, &peer, buffer, sizeof(buffer), false));
+				}
+			}
+		}
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nObjects * (nObjects - 1)));
+}
+BENCHMARK(BM_encodePODIMessagesPerPair)->Arg(8)->Arg(32)->Arg(128);
@@ -0,0 +1,51 @@
+#include "benchdefines.h"
+extern "C" {
+#include "scenarioengine.h"
+}
+
+/*! One object with range regions on a 1 km line and range speed thresholds, driving along the line
+ *  with varying speed. The evaluations counter shows how many conditions each sample is tested against. */
+static void BM_processScenarioMonitorData(benchmark::State& state) {
+	const int nTriggers = static_cast<int>(state.range(0));
+	ScenarioEngineType* engine = createScenarioEngine(10.0, nullptr);
+
+	for (int i = 0; i < nTriggers; ++i) {
+		ScenarioTriggerType trigger;
+		memset(&trigger, 0, sizeof(trigger));
+		trigger.triggerID = static_cast<uint16_t>(i);
+		trigger.transmitterID = TEST_TRANSMITTER_ID_1;
+		trigger.type = i % 2 ? TRIGGER_POSITION_LEFT : TRIGGER_POSITION_REACHED;
+		trigger.minX_m = 1000.0 * i / nTriggers;
+		trigger.maxX_m = trigger.minX_m + 5.0;
+		trigger.minY_m = -2.0;
+		trigger.maxY_m = 2.0;
+		addScenarioTrigger(engine, &trigger);
+		trigger.type = TRIGGER_SPEED;
+		trigger.comparison = i % 2 ? TRIGGER_PARAMETER_LESS_THAN : TRIGGER_PARAMETER_GREATER_THAN;
+		trigger.speedThreshold_m_s = 30.0 * i / nTriggers;
+		addScenarioTrigger(engine, &trigger);
+	}
+
+	ObjectMonitorType monitor;
+	memset(&monitor, 0, sizeof(monitor));
+	monitor.position = makeBenchPosition();
+	monitor.position.yCoord_m = 0.0;
+	monitor.speed = makeBenchSpeed();
+	monitor.state = OBJECT_STATE_RUNNING;
+	struct timeval now = makeBenchTime();
+	int64_t step = 0;
+
+	for (auto _ : state) {
+		monitor.position.xCoord_m = static_cast<double>(step % 10000) * 0.1;
+		monitor.speed.longitudinal_m_s = 15.0 + 10.0 * ((step / 50) % 2 ? 1 : -1) * (step % 50) / 50.0;
+		now.tv_usec = static_cast<suseconds_t>(step % 1000000);
+		benchmark::DoNotOptimize(processScenarioMonitorData(engine, TEST_TRANSMITTER_ID_1, &monitor, &now));
+		step++;
+	}
+	const ScenarioStatisticsType statistics = getScenarioStatistics(engine);
+	state.counters["evaluations"] = static_cast<double>(statistics.nTriggerEvaluations)
+			/ static_cast<double>(statistics.nMonitorSamples);
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	freeScenarioEngine(engine);
+}
+BENCHMARK(BM_processScenarioMonitorData)->Arg(16)->Arg(256)->Arg(4096);
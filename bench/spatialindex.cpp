@@ -0,0 +1,69 @@
+#include "benchdefines.h"
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "spatialindex.h"
+}
+
+//! Meandering trajectory with points every 10 cm
+static std::vector<TrajectoryWaypointType> createBenchTrajectory(const int nPoints) {
+	std::vector<TrajectoryWaypointType> waypoints(static_cast<size_t>(nPoints));
+	double x = 0.0, y = 0.0;
+	for (int i = 0; i < nPoints; ++i) {
+		TrajectoryWaypointType& waypoint = waypoints[static_cast<size_t>(i)];
+		const double heading = 2.0 * std::sin(i * 0.0007) + i * 0.00013;
+		memset(&waypoint, 0, sizeof(waypoint));
+		waypoint.relativeTime = { static_cast<time_t>(i / 100), static_cast<suseconds_t>((i % 100) * 10000) };
+		waypoint.pos.xCoord_m = x;
+		waypoint.pos.yCoord_m = y;
+		waypoint.pos.isPositionValid = true;
+		x += 0.1 * std::cos(heading);
+		y += 0.1 * std::sin(heading);
+	}
+	return waypoints;
+}
+
+//! Positions up to a few metres from random points of the trajectory, projected one at a time
+static void BM_projectOntoSpatialIndex(benchmark::State& state) {
+	const int nPoints = static_cast<int>(state.range(0));
+	const std::vector<TrajectoryWaypointType> waypoints = createBenchTrajectory(nPoints);
+	SpatialIndexType* index = createSpatialIndex(waypoints.data(), waypoints.size());
+	TrajectoryProjectionType projection;
+	uint32_t seed = 12345;
+
+	for (auto _ : state) {
+		seed = seed * 1664525u + 1013904223u;
+		const CartesianPosition& position = waypoints[seed % static_cast<uint32_t>(nPoints)].pos;
+		const double x = position.xCoord_m + static_cast<double>(seed >> 28) * 0.2 - 1.5;
+		const double y = position.yCoord_m + static_cast<double>((seed >> 24) & 0xF) * 0.2 - 1.5;
+		benchmark::DoNotOptimize(projectOntoSpatialIndex(index, x, y, &projection));
+		benchmark::DoNotOptimize(projection);
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	freeSpatialIndex(index);
+}
+BENCHMARK(BM_projectOntoSpatialIndex)->Arg(1000)->Arg(100000)->Arg(1000000);
+
+//! A measured track 1 m apart following the trajectory with an offset, 1024 positions per call
+static void BM_projectManyOntoSpatialIndex(benchmark::State& state) {
+	const int nPoints = static_cast<int>(state.range(0));
+	const size_t nPositions = 1024;
+	const std::vector<TrajectoryWaypointType> waypoints = createBenchTrajectory(nPoints);
+	SpatialIndexType* index = createSpatialIndex(waypoints.data(), waypoints.size());
+	std::vector<double> x(nPositions), y(nPositions);
+	std::vector<TrajectoryProjectionType> projections(nPositions);
+
+	for (size_t k = 0; k < nPositions; ++k) {
+		const CartesianPosition& position = waypoints[(k * 10) % static_cast<size_t>(nPoints)].pos;
+		x[k] = position.xCoord_m + 0.5;
+		y[k] = position.yCoord_m - 0.3;
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(projectManyOntoSpatialIndex(index, x.data(), y.data(), nPositions,
+															 projections.data()));
+		benchmark::DoNotOptimize(projections.data());
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nPositions));
+	freeSpatialIndex(index);
+}
+BENCHMARK(BM_projectManyOntoSpatialIndex)->Arg(1000)->Arg(100000)->Arg(1000000);
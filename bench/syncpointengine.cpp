@@ -0,0 +1,75 @@
+#include "benchdefines.h"
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "syncpointengine.h"
+}
+
+#define BENCH_N_MASTERS 4
+#define BENCH_SYNC_POINTS_PER_MASTER 12
+
+/*! Four masters on winding trajectories, each with a dozen sync points, one of them reporting
+ *  monitor data per iteration while due MTSP updates are collected. The segments counter shows
+ *  how many trajectory segments each position is projected onto. */
+static void BM_processSyncPointMonitorData(benchmark::State& state) {
+	const int nPoints = static_cast<int>(state.range(0));
+	SyncPointEngineType* engine = createSyncPointEngine(nullptr);
+	std::vector<TrajectoryWaypointType> waypoints(static_cast<size_t>(nPoints));
+
+	for (int i = 0; i < nPoints; ++i) {
+		TrajectoryWaypointType& waypoint = waypoints[static_cast<size_t>(i)];
+		memset(&waypoint, 0, sizeof(waypoint));
+		waypoint.relativeTime.tv_sec = i / 10;
+		waypoint.relativeTime.tv_usec = (i % 10) * 100000;
+		waypoint.pos.xCoord_m = 1.5 * i;
+		waypoint.pos.yCoord_m = 20.0 * std::sin(i * 0.01);
+		waypoint.pos.isPositionValid = true;
+	}
+	for (uint32_t master = 0; master < BENCH_N_MASTERS; ++master) {
+		setSyncPointMasterTrajectory(engine, TEST_TRANSMITTER_ID_1 + master, waypoints.data(), waypoints.size());
+		for (int i = 0; i < BENCH_SYNC_POINTS_PER_MASTER; ++i) {
+			SyncPointType syncPoint;
+			memset(&syncPoint, 0, sizeof(syncPoint));
+			syncPoint.syncPointID = static_cast<uint16_t>(master * BENCH_SYNC_POINTS_PER_MASTER + i);
+			syncPoint.masterTransmitterID = TEST_TRANSMITTER_ID_1 + master;
+			syncPoint.slaveTransmitterID = TEST_TRANSMITTER_ID_2 + static_cast<uint32_t>(i);
+			syncPoint.masterTime.tv_sec = static_cast<time_t>((i + 1) * nPoints / 10 / BENCH_SYNC_POINTS_PER_MASTER);
+			addSyncPoint(engine, &syncPoint);
+		}
+	}
+
+	ObjectMonitorType monitor;
+	memset(&monitor, 0, sizeof(monitor));
+	monitor.position = makeBenchPosition();
+	monitor.speed = makeBenchSpeed();
+	monitor.speed.longitudinal_m_s = 15.0;
+	monitor.isTimestampValid = true;
+	SyncPointUpdateType updates[BENCH_N_MASTERS * BENCH_SYNC_POINTS_PER_MASTER];
+	const struct timeval start = makeBenchTime();
+	int64_t step = 0;
+
+	for (auto _ : state) {
+		// Each master reports every 10 ms, driving the trajectory with some lateral offset
+		const int64_t sample = step / BENCH_N_MASTERS;
+		const int64_t elapsed_us = sample * 10000;
+		const double distance_m = static_cast<double>(sample % (10 * nPoints)) * 0.15;
+		monitor.timestamp.tv_sec = start.tv_sec + static_cast<time_t>(elapsed_us / 1000000);
+		monitor.timestamp.tv_usec = static_cast<suseconds_t>(elapsed_us % 1000000);
+		monitor.position.xCoord_m = distance_m;
+		monitor.position.yCoord_m = 20.0 * std::sin(distance_m / 150.0) + 0.3;
+		benchmark::DoNotOptimize(processSyncPointMonitorData(
+				engine, TEST_TRANSMITTER_ID_1 + static_cast<uint32_t>(step % BENCH_N_MASTERS),
+				&monitor, &monitor.timestamp));
+		benchmark::DoNotOptimize(popDueSyncPointUpdates(engine, &monitor.timestamp, updates,
+														sizeof(updates) / sizeof(updates[0])));
+		step++;
+	}
+	const SyncPointStatisticsType statistics = getSyncPointStatistics(engine);
+	state.counters["segments"] = static_cast<double>(statistics.nSegmentsTested)
+			/ static_cast<double>(statistics.nMonitorSamples);
+	state.counters["updates"] = static_cast<double>(statistics.nUpdates)
+			/ static_cast<double>(statistics.nMonitorSamples);
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	freeSyncPointEngine(engine);
+}
+BENCHMARK(BM_processSyncPointMonitorData)->Arg(1000)->Arg(100000);
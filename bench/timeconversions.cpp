@@ -0,0 +1,45 @@
+#include "benchdefines.h"
+extern "C" {
+#include "timeconversions.h"
+}
+
+static void BM_setToGPStime(benchmark::State& state) {
+	struct timeval time;
+	uint32_t qmsOfWeek = 1000000;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(setToGPStime(&time, 2207, qmsOfWeek));
+		qmsOfWeek += 40;
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_setToGPStime);
+
+static void BM_getAsGPSWeek(benchmark::State& state) {
+	struct timeval time = makeBenchTime();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(getAsGPSWeek(&time));
+		time.tv_usec = (time.tv_usec + 10000) % 1000000;
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_getAsGPSWeek);
+
+static void BM_getAsGPSQuarterMillisecondOfWeek(benchmark::State& state) {
+	struct timeval time = makeBenchTime();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(getAsGPSQuarterMillisecondOfWeek(&time));
+		time.tv_usec = (time.tv_usec + 10000) % 1000000;
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_getAsGPSQuarterMillisecondOfWeek);
+
+static void BM_getAsGPSms(benchmark::State& state) {
+	struct timeval time = makeBenchTime();
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(getAsGPSms(&time));
+		time.tv_usec = (time.tv_usec + 10000) % 1000000;
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_getAsGPSms);
@@ -0,0 +1,137 @@
+#include "benchdefines.h"
+#include <vector>
+extern "C" {
+#include "traj.h"
+}
+
+static const char trajectoryName[] = "benchmark trajectory";
+
+static ssize_t encodeTrajectory(char* buffer, const size_t bufferLength, const uint32_t nPoints) {
+	MessageHeaderType header = makeBenchHeader();
+	char* p = buffer;
+	ssize_t result = encodeTRAJMessageHeader(&header, 0x0123, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, trajectoryName,
+											 sizeof(trajectoryName) - 1, nPoints, p, bufferLength, false);
+	if (result < 0) {
+		return result;
+	}
+	p += result;
+	for (uint32_t i = 0; i < nPoints; ++i) {
+		struct timeval time = { static_cast<time_t>(i / 100), static_cast<suseconds_t>((i % 100) * 10000) };
+		CartesianPosition position = makeBenchPosition();
+		position.xCoord_m += 0.1 * i;
+		if ((result = encodeTRAJMessagePoint(&time, position, makeBenchSpeed(), makeBenchAcceleration(), 0.01f, p,
+											 bufferLength - static_cast<size_t>(p - buffer), false)) < 0) {
+			return result;
+		}
+		p += result;
+	}
+	if ((result = encodeTRAJMessageFooter(p, bufferLength - static_cast<size_t>(p - buffer), false)) < 0) {
+		return result;
+	}
+	return p + result - buffer;
+}
+
+static void BM_encodeTRAJMessageHeader(benchmark::State& state) {
+	MessageHeaderType header = makeBenchHeader();
+	char buffer[256];
+	ssize_t length = 0;
+	for (auto _ : state) {
+		length = encodeTRAJMessageHeader(&header, 0x0123, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, trajectoryName,
+										 sizeof(trajectoryName) - 1, 1000, buffer, sizeof(buffer), false);
+		benchmark::DoNotOptimize(buffer);
+	}
+	setMessageCounters(state, static_cast<size_t>(length));
+}
+BENCHMARK(BM_encodeTRAJMessageHeader);
+
+static void BM_decodeTRAJMessageHeader(benchmark::State& state) {
+	char buffer[256];
+	MessageHeaderType header = makeBenchHeader();
+	ssize_t length = encodeTRAJMessageHeader(&header, 0x0123, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, trajectoryName,
+											 sizeof(trajectoryName) - 1, 1000, buffer, sizeof(buffer), false);
+	TrajectoryHeaderType trajectoryHeader;
+	if (length < 0 || decodeTRAJMessageHeader(&trajectoryHeader, buffer, sizeof(buffer), false) < 0) {
+		state.SkipWithError("Unable to encode TRAJ header");
+		return;
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(decodeTRAJMessageHeader(&trajectoryHeader, buffer, sizeof(buffer), false));
+	}
+	setMessageCounters(state, static_cast<size_t>(length));
+}
+BENCHMARK(BM_decodeTRAJMessageHeader);
+
+static void BM_encodeTRAJMessagePoint(benchmark::State& state) {
+	struct timeval time = { 1, 250000 };
+	CartesianPosition position = makeBenchPosition();
+	SpeedType speed = makeBenchSpeed();
+	AccelerationType acceleration = makeBenchAcceleration();
+	char buffer[64];
+	ssize_t length = 0;
+	for (auto _ : state) {
+		length = encodeTRAJMessagePoint(&time, position, speed, acceleration, 0.01f, buffer, sizeof(buffer), false);
+		benchmark::DoNotOptimize(buffer);
+	}
+	setMessageCounters(state, static_cast<size_t>(length));
+}
+BENCHMARK(BM_encodeTRAJMessagePoint);
+
+static void BM_decodeTRAJMessagePoint(benchmark::State& state) {
+	struct timeval time = { 1, 250000 };
+	char buffer[64];
+	ssize_t length = encodeTRAJMessagePoint(&time, makeBenchPosition(), makeBenchSpeed(), makeBenchAcceleration(),
+											0.01f, buffer, sizeof(buffer), false);
+	TrajectoryWaypointType waypoint;
+	if (length < 0 || decodeTRAJMessagePoint(&waypoint, buffer, false) < 0) {
+		state.SkipWithError("Unable to encode TRAJ point");
+		return;
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(decodeTRAJMessagePoint(&waypoint, buffer, false));
+	}
+	setMessageCounters(state, static_cast<size_t>(length));
+}
+BENCHMARK(BM_decodeTRAJMessagePoint);
+
+//! Complete trajectory of state.range(0) points, as sent to an object before a test
+static void BM_encodeTRAJMessage(benchmark::State& state) {
+	const uint32_t nPoints = static_cast<uint32_t>(state.range(0));
+	std::vector<char> buffer(static_cast<size_t>(nPoints) * 64 + 256);
+	ssize_t length = 0;
+	for (auto _ : state) {
+		length = encodeTrajectory(buffer.data(), buffer.size(), nPoints);
+		benchmark::DoNotOptimize(buffer.data());
+	}
+	if (length < 0) {
+		state.SkipWithError("Unable to encode TRAJ");
+		return;
+	}
+	setMessageCounters(state, static_cast<size_t>(length));
+	state.counters["points/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * nPoints,
+													benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_encodeTRAJMessage)->Arg(100)->Arg(10000);
+
+static void BM_decodeTRAJMessage(benchmark::State& state) {
+	const uint32_t nPoints = static_cast<uint32_t>(state.range(0));
+	std::vector<char> buffer(static_cast<size_t>(nPoints) * 64 + 256);
+	const ssize_t length = encodeTrajectory(buffer.data(), buffer.size(), nPoints);
+	std::vector<TrajectoryWaypointType> waypoints(nPoints);
+	TrajectoryHeaderType trajectoryHeader;
+	if (length < 0) {
+		state.SkipWithError("Unable to encode TRAJ");
+		return;
+	}
+	for (auto _ : state) {
+		ssize_t offset = decodeTRAJMessageHeader(&trajectoryHeader, buffer.data(), buffer.size(), false);
+		for (uint32_t i = 0; i < trajectoryHeader.nWaypoints && offset > 0; ++i) {
+			ssize_t result = decodeTRAJMessagePoint(&waypoints[i], buffer.data() + offset, false);
+			offset = result < 0 ? result : offset + result;
+		}
+		benchmark::DoNotOptimize(waypoints.data());
+	}
+	setMessageCounters(state, static_cast<size_t>(length));
+	state.counters["points/s"] = benchmark::Counter(static_cast<double>(state.iterations()) * nPoints,
+													benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_decodeTRAJMessage)->Arg(100)->Arg(10000);
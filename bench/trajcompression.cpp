@@ -0,0 +1,82 @@
+#include "benchdefines.h"
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "trajcompression.h"
+}
+
+/*! Trajectory sampled at 100 Hz, alternating straights and curves while speeding up and slowing down */
+static std::vector<TrajectoryWaypointType> makeBenchTrajectory(const size_t nPoints) {
+	std::vector<TrajectoryWaypointType> waypoints(nPoints);
+	double x = 0.0, y = 0.0, heading = 0.0;
+
+	for (size_t i = 0; i < nPoints; ++i) {
+		TrajectoryWaypointType& waypoint = waypoints[i];
+		const double speed = 8.0 + 4.0 * std::sin(static_cast<double>(i) * 0.0005);
+		const float curvature = (i / 1500) % 3 == 1 ? static_cast<float>(0.02 * std::sin(static_cast<double>(i) * 0.002))
+												   : 0.0f;
+		waypoint.relativeTime = { static_cast<time_t>(i / 100), static_cast<suseconds_t>((i % 100) * 10000) };
+		waypoint.pos = makeBenchPosition();
+		waypoint.pos.xCoord_m = x;
+		waypoint.pos.yCoord_m = y;
+		waypoint.pos.heading_rad = heading;
+		waypoint.spd = makeBenchSpeed();
+		waypoint.spd.longitudinal_m_s = speed;
+		waypoint.acc = makeBenchAcceleration();
+		waypoint.acc.longitudinal_m_s2 = 0.002 * std::cos(static_cast<double>(i) * 0.0005);
+		waypoint.acc.lateral_m_s2 = curvature * speed * speed;
+		waypoint.curvature = curvature;
+		heading = std::fmod(heading + curvature * speed * 0.01 + 2.0 * M_PI, 2.0 * M_PI);
+		x += speed * 0.01 * std::cos(heading);
+		y += speed * 0.01 * std::sin(heading);
+	}
+	return waypoints;
+}
+
+/*! Encoding of a trajectory as TRAJ (accepted codec version 0) or CTRJ (version 1). Items are points,
+ *  and the compression counter is the TRAJ size divided by the size of the encoded message. */
+static void BM_encodeTrajectoryMessage(benchmark::State& state) {
+	const uint32_t nPoints = static_cast<uint32_t>(state.range(0));
+	const uint8_t codecVersion = static_cast<uint8_t>(state.range(1));
+	const auto waypoints = makeBenchTrajectory(nPoints);
+	std::vector<char> buffer(getEncodedSizeTRAJMessage(nPoints));
+	TrajectoryCompressorType* compressor = createTrajectoryCompressor();
+	MessageHeaderType header = makeBenchHeader();
+	ssize_t length = 0;
+
+	for (auto _ : state) {
+		length = encodeTrajectoryMessage(compressor, codecVersion, &header, 1, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN,
+										 nullptr, 0, waypoints.data(), nPoints, buffer.data(), buffer.size(), false);
+		benchmark::DoNotOptimize(buffer.data());
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * nPoints);
+	state.counters["compression"] = static_cast<double>(buffer.size()) / static_cast<double>(length);
+	freeTrajectoryCompressor(compressor);
+}
+BENCHMARK(BM_encodeTrajectoryMessage)->Args({ 100000, 0 })->Args({ 100000, 1 });
+
+/*! Decoding of a CTRJ message in chunks of 256 points. Items are points. */
+static void BM_decodeCTRJMessagePoints(benchmark::State& state) {
+	const uint32_t nPoints = static_cast<uint32_t>(state.range(0));
+	const auto waypoints = makeBenchTrajectory(nPoints);
+	std::vector<char> buffer(getEncodedSizeTRAJMessage(nPoints));
+	std::vector<TrajectoryWaypointType> decoded(256);
+	TrajectoryCompressorType* compressor = createTrajectoryCompressor();
+	TrajectoryDecompressorType* decompressor = createTrajectoryDecompressor();
+	MessageHeaderType header = makeBenchHeader();
+	TrajectoryHeaderType trajectoryHeader;
+
+	const ssize_t length = encodeTrajectoryMessage(compressor, CTRJ_CODEC_VERSION, &header, 1,
+												   TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, nullptr, 0, waypoints.data(),
+												   nPoints, buffer.data(), buffer.size(), false);
+	for (auto _ : state) {
+		decodeCTRJMessageHeader(decompressor, &trajectoryHeader, buffer.data(), static_cast<size_t>(length), false);
+		while (decodeCTRJMessagePoints(decompressor, decoded.data(), decoded.size()) > 0) {
+			benchmark::DoNotOptimize(decoded.data());
+		}
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * nPoints);
+	freeTrajectoryCompressor(compressor);
+	freeTrajectoryDecompressor(decompressor);
+}
+BENCHMARK(BM_decodeCTRJMessagePoints)->Arg(100000);
@@ -0,0 +1,50 @@
+#include "benchdefines.h"
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+extern "C" {
+#include "trajectoryimport.h"
+}
+
+//! Comma separated trajectory at 100 Hz with a header line, as exported from a path planner
+static std::string makeBenchTrajectoryText(const size_t nLines) {
+	std::string text = "time,x,y,z,heading,speed,acceleration,curvature\n";
+	char line[160];
+	double x = 0.0, y = 0.0, heading = 0.0;
+
+	text.reserve(nLines * 64);
+	for (size_t i = 0; i < nLines; ++i) {
+		const double speed = 8.0 + 4.0 * std::sin(static_cast<double>(i) * 0.0005);
+		const double curvature = (i / 1500) % 3 == 1 ? 0.02 * std::sin(static_cast<double>(i) * 0.002) : 0.0;
+		snprintf(line, sizeof(line), "%.2f,%.3f,%.3f,0.000,%.5f,%.3f,%.3f,%.6f\n", static_cast<double>(i) * 0.01, x,
+				 y, heading, speed, 0.002 * std::cos(static_cast<double>(i) * 0.0005), curvature);
+		text += line;
+		heading = std::fmod(heading + curvature * speed * 0.01 + 2.0 * M_PI, 2.0 * M_PI);
+		x += speed * 0.01 * std::cos(heading);
+		y += speed * 0.01 * std::sin(heading);
+	}
+	return text;
+}
+
+/*! Conversion of a 1M line trajectory text to a TRAJ message on the given number of threads.
+ *  Items are lines. */
+static void BM_importTrajectoryText(benchmark::State& state) {
+	const size_t nLines = static_cast<size_t>(state.range(0));
+	const std::string text = makeBenchTrajectoryText(nLines);
+	MessageHeaderType header = makeBenchHeader();
+	TrajectoryImportOptionsType options = {};
+	TrajectoryImportStatisticsType statistics;
+	char* message = nullptr;
+
+	options.nThreads = static_cast<unsigned int>(state.range(1));
+	for (auto _ : state) {
+		importTrajectoryText(text.data(), text.size(), &options, &header, 1, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN,
+							 nullptr, 0, &message, &statistics);
+		benchmark::DoNotOptimize(message);
+		free(message);
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nLines));
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+}
+BENCHMARK(BM_importTrajectoryText)->Args({ 1000000, 1 })->Args({ 1000000, 0 })->Unit(benchmark::kMillisecond);
@@ -0,0 +1,82 @@
+#include "benchdefines.h"
+#include <vector>
+extern "C" {
+#include "trajectoryindex.h"
+}
+
+#define BENCH_LOOKUP_STEP_US 3333
+
+static TrajectoryIndexType* createBenchTrajectoryIndex(const int nPoints) {
+	std::vector<TrajectoryWaypointType> waypoints(static_cast<size_t>(nPoints));
+	for (int i = 0; i < nPoints; ++i) {
+		TrajectoryWaypointType& waypoint = waypoints[static_cast<size_t>(i)];
+		waypoint.relativeTime = { static_cast<time_t>(i / 100), static_cast<suseconds_t>((i % 100) * 10000) };
+		waypoint.pos = makeBenchPosition();
+		waypoint.pos.xCoord_m += 0.1 * i;
+		waypoint.spd = makeBenchSpeed();
+		waypoint.acc = makeBenchAcceleration();
+		waypoint.curvature = 0.01f;
+	}
+	return createTrajectoryIndex(waypoints.data(), waypoints.size());
+}
+
+static inline struct timeval benchLookupTime(const int64_t step, const int nPoints) {
+	const int64_t time_us = (step * BENCH_LOOKUP_STEP_US) % (static_cast<int64_t>(nPoints) * 10000);
+	return { static_cast<time_t>(time_us / 1000000), static_cast<suseconds_t>(time_us % 1000000) };
+}
+
+//! Lookup of increasing times by binary search
+static void BM_getTrajectoryPointAt(benchmark::State& state) {
+	const int nPoints = static_cast<int>(state.range(0));
+	TrajectoryIndexType* index = createBenchTrajectoryIndex(nPoints);
+	TrajectoryWaypointType point;
+	int64_t step = 0;
+
+	for (auto _ : state) {
+		const struct timeval time = benchLookupTime(step++, nPoints);
+		benchmark::DoNotOptimize(getTrajectoryPointAt(index, &time, &point));
+		benchmark::DoNotOptimize(point);
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	freeTrajectoryIndex(index);
+}
+BENCHMARK(BM_getTrajectoryPointAt)->Arg(1000)->Arg(1000000);
+
+//! Lookup of the same increasing times with a cursor
+static void BM_getTrajectoryPointAtCursor(benchmark::State& state) {
+	const int nPoints = static_cast<int>(state.range(0));
+	TrajectoryIndexType* index = createBenchTrajectoryIndex(nPoints);
+	TrajectoryCursorType cursor;
+	TrajectoryWaypointType point;
+	int64_t step = 0;
+
+	initTrajectoryCursor(&cursor, index);
+	for (auto _ : state) {
+		const struct timeval time = benchLookupTime(step++, nPoints);
+		benchmark::DoNotOptimize(getTrajectoryPointAtCursor(&cursor, &time, &point));
+		benchmark::DoNotOptimize(point);
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	freeTrajectoryIndex(index);
+}
+BENCHMARK(BM_getTrajectoryPointAtCursor)->Arg(1000)->Arg(1000000);
+
+//! Evaluation of a trajectory at 1024 increasing times per call
+static void BM_getTrajectoryPointsAt(benchmark::State& state) {
+	const int nPoints = static_cast<int>(state.range(0));
+	const size_t nTimes = 1024;
+	TrajectoryIndexType* index = createBenchTrajectoryIndex(nPoints);
+	std::vector<struct timeval> times(nTimes);
+	std::vector<TrajectoryWaypointType> points(nTimes);
+
+	for (size_t i = 0; i < nTimes; ++i) {
+		times[i] = benchLookupTime(static_cast<int64_t>(i), nPoints);
+	}
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(getTrajectoryPointsAt(index, times.data(), nTimes, points.data()));
+		benchmark::DoNotOptimize(points.data());
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nTimes));
+	freeTrajectoryIndex(index);
+}
+BENCHMARK(BM_getTrajectoryPointsAt)->Arg(1000)->Arg(1000000);
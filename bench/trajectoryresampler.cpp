@@ -0,0 +1,49 @@
+#include "benchdefines.h"
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "trajectoryresampler.h"
+}
+
+/*! Resampling of 1M raw points at about 1 kHz, alternating straights and curves, to a 100 Hz time
+ *  step or a 0.1 m arc length step. Items are input points. */
+static void BM_resampleTrajectory(benchmark::State& state) {
+	const size_t nPoints = static_cast<size_t>(state.range(0));
+	const TrajectoryResampleOptionsType options = {
+		static_cast<TrajectoryResampleModeType>(state.range(1)),
+		state.range(1) == TRAJECTORY_RESAMPLE_TIME ? 0.01 : 0.1
+	};
+	std::vector<int64_t> time_us(nPoints);
+	std::vector<double> x(nPoints), y(nPoints);
+	TrajectoryResamplerType* resampler = createTrajectoryResampler();
+	TrajectoryColumnsType input = {}, output;
+	double px = 0.0, py = 0.0, heading = 0.0;
+
+	for (size_t i = 0; i < nPoints; ++i) {
+		const double speed = 8.0 + 4.0 * std::sin(static_cast<double>(i) * 0.00005);
+		const double curvature = (i / 15000) % 3 == 1 ? 0.02 * std::sin(static_cast<double>(i) * 0.0002) : 0.0;
+		time_us[i] = static_cast<int64_t>(i) * 1000 + static_cast<int64_t>(i % 5) * 100;
+		x[i] = px;
+		y[i] = py;
+		heading += curvature * speed * 0.001;
+		px += speed * 0.001 * std::cos(heading);
+		py += speed * 0.001 * std::sin(heading);
+	}
+	input.nPoints = nPoints;
+	input.time_us = time_us.data();
+	input.x_m = x.data();
+	input.y_m = y.data();
+
+	for (auto _ : state) {
+		resampleTrajectory(resampler, &input, &options, &output);
+		benchmark::DoNotOptimize(output.curvature);
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * nPoints));
+	state.counters["outputPoints"] = static_cast<double>(output.nPoints);
+	freeTrajectoryResampler(resampler);
+}
+BENCHMARK(BM_resampleTrajectory)
+	->Args({ 1000000, TRAJECTORY_RESAMPLE_TIME })
+	->Args({ 1000000, TRAJECTORY_RESAMPLE_DISTANCE })
+	->Args({ 1000000, TRAJECTORY_RESAMPLE_NONE })
+	->Unit(benchmark::kMillisecond);
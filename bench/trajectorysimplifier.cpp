@@ -0,0 +1,45 @@
+#include "benchdefines.h"
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "trajectorysimplifier.h"
+}
+
+/*! Simplification of a trajectory sampled at 100 Hz, alternating straights and curves, on a given
+ *  number of threads. Items are input points. */
+static void BM_simplifyTrajectory(benchmark::State& state) {
+	const size_t nPoints = static_cast<size_t>(state.range(0));
+	std::vector<TrajectoryWaypointType> waypoints(nPoints), simplified(nPoints);
+	TrajectorySimplificationOptionsType options;
+	TrajectorySimplificationStatisticsType statistics = {};
+	double x = 0.0, y = 0.0, heading = 0.0;
+
+	for (size_t i = 0; i < nPoints; ++i) {
+		TrajectoryWaypointType& waypoint = waypoints[i];
+		const double speed = 8.0 + 4.0 * std::sin(static_cast<double>(i) * 0.0005);
+		const float curvature = (i / 1500) % 3 == 1 ? static_cast<float>(0.02 * std::sin(static_cast<double>(i) * 0.002))
+												   : 0.0f;
+		waypoint.relativeTime = { static_cast<time_t>(i / 100), static_cast<suseconds_t>((i % 100) * 10000) };
+		waypoint.pos = makeBenchPosition();
+		waypoint.pos.xCoord_m = x;
+		waypoint.pos.yCoord_m = y;
+		waypoint.spd = makeBenchSpeed();
+		waypoint.spd.longitudinal_m_s = speed;
+		waypoint.acc = makeBenchAcceleration();
+		waypoint.curvature = curvature;
+		heading += curvature * speed * 0.01;
+		x += speed * 0.01 * std::cos(heading);
+		y += speed * 0.01 * std::sin(heading);
+	}
+	options.position_m = 0.02;
+	options.speed_m_s = 0.05;
+	options.curvature = 0.001;
+	options.nThreads = static_cast<unsigned int>(state.range(1));
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(simplifyTrajectory(waypoints.data(), nPoints, &options, simplified.data(), &statistics));
+	}
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(nPoints));
+	state.counters["compression"] = statistics.compressionRatio;
+}
+BENCHMARK(BM_simplifyTrajectory)->Args({ 100000, 1 })->Args({ 1000000, 1 })->Args({ 1000000, 8 })->UseRealTime();
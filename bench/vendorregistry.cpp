@@ -0,0 +1,53 @@
+#include "benchdefines.h"
+extern "C" {
+#include "vendorregistry.h"
+}
+
+#define BENCH_VENDOR_MESSAGE_ID 0xB123
+#define BENCH_VENDOR_VALUE_ID 0x0100
+
+//! A single uint8 value, the same content as GDRM so that dispatch cost can be compared directly
+static ssize_t encodeBenchContent(const void* messageData, char* content, const size_t contentCapacity, void*) {
+	const uint16_t valueHeader[] = { htole16(BENCH_VENDOR_VALUE_ID), htole16(sizeof (uint8_t)) };
+	if (contentCapacity < sizeof (valueHeader) + sizeof (uint8_t)) {
+		return -1;
+	}
+	memcpy(content, valueHeader, sizeof (valueHeader));
+	content[sizeof (valueHeader)] = *static_cast<const char*>(messageData);
+	return sizeof (valueHeader) + sizeof (uint8_t);
+}
+
+static int decodeBenchContent(const HeaderType*, const char* content, const size_t contentLength,
+							  void* messageData, void*) {
+	if (contentLength != 2 * sizeof (uint16_t) + sizeof (uint8_t)) {
+		return MESSAGE_LENGTH_ERROR;
+	}
+	*static_cast<char*>(messageData) = content[2 * sizeof (uint16_t)];
+	return MESSAGE_OK;
+}
+
+static const MessageHeaderType vendorHeader = makeBenchHeader();
+
+//! Registers the handler once, later calls fail with EEXIST which is fine
+static void registerBenchVendorMessage() {
+	const VendorMessageHandlerType handler = { encodeBenchContent, decodeBenchContent, nullptr };
+	registerVendorMessage(BENCH_VENDOR_MESSAGE_ID, &handler);
+}
+
+static ssize_t encodeBenchVendor(char* buffer, const size_t length) {
+	const char data = 1;
+	return encodeVendorMessage(&vendorHeader, BENCH_VENDOR_MESSAGE_ID, &data, buffer, length, false);
+}
+static void BM_encodeVendorMessage(benchmark::State& state) {
+	registerBenchVendorMessage();
+	runEncodeBenchmark(state, encodeBenchVendor);
+}
+BENCHMARK(BM_encodeVendorMessage);
+static void BM_decodeVendorMessage(benchmark::State& state) {
+	char data;
+	registerBenchVendorMessage();
+	runDecodeBenchmark(state, encodeBenchVendor, [&](const char* buffer, size_t length) {
+		return decodeVendorMessage(buffer, length, &data, false);
+	});
+}
+BENCHMARK(BM_decodeVendorMessage);
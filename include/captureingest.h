@@ -0,0 +1,94 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*! One captured packet, referring into the mapped capture file */
+typedef struct {
+	const uint8_t* data;
+	uint32_t length;			//!< Captured length
+	uint16_t linkType;			//!< Link type according to the pcap LINKTYPE_* registry
+	int64_t time_ns;			//!< Capture time since the Unix epoch
+} CapturePacketType;
+
+/*! A pcap or pcapng file mapped into memory, with an index of its packets */
+typedef struct {
+	const uint8_t* data;
+	size_t size;
+	CapturePacketType* packets;
+	size_t nPackets;
+} CaptureType;
+
+/*! An ISO message found in a capture */
+typedef struct {
+	const uint8_t* data;
+	size_t length;
+	int64_t time_ns;			//!< Capture time of the packet completing the message
+} CaptureFrameType;
+
+typedef struct CaptureFrameIterator CaptureFrameIteratorType;
+
+typedef struct {
+	unsigned int nThreads;			//!< Number of decoding threads, 0 for one per online processor
+	bool isTransmitterFiltered;		//!< Only analyse messages from transmitterID
+	uint32_t transmitterID;
+	bool isTimelineEnabled;			//!< Record MONR state transitions per object
+} CaptureAnalysisOptionsType;
+
+/*! Point in time at which an object was first seen in a new state */
+typedef struct {
+	int64_t time_ns;
+	uint8_t state;					//!< ::ObjectStateType
+} CaptureStateTransitionType;
+
+typedef struct {
+	uint32_t transmitterID;
+	uint64_t nMessages;
+	uint64_t nMONRMessages;
+	uint64_t nCRCErrors;
+	uint64_t nDecodeErrors;
+	int64_t firstTime_ns;
+	int64_t lastTime_ns;
+	int64_t firstMONRTime_ns;
+	int64_t lastMONRTime_ns;
+	CaptureStateTransitionType* timeline;
+	size_t nTimelineEntries;
+} CaptureObjectStatisticsType;
+
+typedef struct {
+	uint64_t nPackets;
+	uint64_t nBytes;
+	uint64_t nUDPPackets;
+	uint64_t nTCPPackets;
+	uint64_t nOtherPackets;			//!< Packets not carrying UDP or TCP, or IP fragments
+	uint64_t nFrames;				//!< ISO messages found in payloads
+	uint64_t nCRCErrors;
+	uint64_t nDecodeErrors;
+	uint64_t nTruncatedFrames;
+	uint64_t nSkippedBytes;			//!< Payload bytes not belonging to any ISO message
+	uint64_t nTCPGaps;				//!< Missing TCP segments, after which framing was resynchronized
+	uint64_t messageCounts[256];	//!< Number of messages per standard message ID
+	uint64_t nVendorMessages;		//!< Number of messages with IDs above the standard range
+	int64_t firstTime_ns;
+	int64_t lastTime_ns;
+	CaptureObjectStatisticsType* objects;	//!< Sorted on transmitter ID
+	size_t nObjects;
+} CaptureStatisticsType;
+
+int openCapture(const char* path, CaptureType* capture);
+void closeCapture(CaptureType* capture);
+
+int analyzeCapture(const CaptureType* capture, const CaptureAnalysisOptionsType* options,
+				   CaptureStatisticsType* statistics);
+void freeCaptureStatistics(CaptureStatisticsType* statistics);
+
+CaptureFrameIteratorType* createCaptureFrameIterator(const CaptureType* capture);
+int getNextCaptureFrame(CaptureFrameIteratorType* iterator, CaptureFrameType* frame);
+void freeCaptureFrameIterator(CaptureFrameIteratorType* iterator);
+
+#ifdef __cplusplus
+}
+#endif
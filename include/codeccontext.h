@@ -0,0 +1,187 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "iso22133.h"
+#include "header.h"
+#include "isoerror.h"
+#include "monitorsample.h"
+#include "monr2.h"
+#include "trajcompression.h"
+
+#define ISO_CODEC_MAX_PROTOCOL_VERSIONS 8
+
+/*! Codec settings and state for one session, e.g. the link to one test object. A context may be used
+ *  by one thread at a time, while separate contexts can be used concurrently. Functions without a
+ *  context argument use a process wide default context, configured by setISOCRCVerification() and
+ *  setISOErrorCallback(). */
+typedef struct ISOCodecContext ISOCodecContextType;
+
+ISOCodecContextType* createISOCodecContext(void);
+void freeISOCodecContext(ISOCodecContextType* context);
+
+void setCodecCRCVerification(ISOCodecContextType* context, const bool enabled);
+void setCodecDebug(ISOCodecContextType* context, const char debug);
+int setCodecProtocolVersions(ISOCodecContextType* context, const uint8_t* versions, const size_t nVersions);
+void setCodecCompressedTrajectoryVersion(ISOCodecContextType* context, const uint8_t version);
+uint8_t getCodecCompressedTrajectoryVersion(const ISOCodecContextType* context);
+void setCodecErrorCallback(ISOCodecContextType* context, ISOErrorCallbackType callback, void* userData,
+		const uint32_t maxReportsPerSecond);
+ISOErrorType getCodecLastError(const ISOCodecContextType* context);
+uint64_t getCodecSuppressedErrorCount(const ISOCodecContextType* context);
+int fillCodecMessageHeader(ISOCodecContextType* context, const uint32_t transmitterID, const uint32_t receiverID,
+		MessageHeaderType* header);
+
+ssize_t encodeMONRMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const struct timeval* objectTime, const CartesianPosition position, const SpeedType speed,
+		const AccelerationType acceleration, const unsigned char driveDirection, const unsigned char objectState,
+		const unsigned char readyToArm, const unsigned char objectErrorState, const unsigned short errorCode,
+		char* monrDataBuffer, const size_t bufferLength);
+ssize_t decodeMONRMessageCtx(ISOCodecContextType* context, const char* monrDataBuffer, const size_t bufferLength,
+		const struct timeval currentTime, ObjectMonitorType* monitorData);
+ssize_t encodeTRAJMessageHeaderCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const uint16_t trajectoryID, const TrajectoryInfoType trajectoryInfo, const char* trajectoryName,
+		const size_t nameLength, const uint32_t numberOfPointsInTraj, char* trajDataBuffer,
+		const size_t bufferLength);
+ssize_t encodeTRAJMessagePointCtx(ISOCodecContextType* context, const struct timeval* pointTimeFromStart,
+		const CartesianPosition position, const SpeedType speed, const AccelerationType acceleration,
+		const float curvature, char* trajDataBufferPointer, const size_t remainingBufferLength);
+ssize_t decodeTRAJMessagePointCtx(ISOCodecContextType* context, TrajectoryWaypointType* wayPoints,
+		const char* trajDataBuffer);
+ssize_t decodeTRAJMessagePointBoundedCtx(ISOCodecContextType* context, TrajectoryWaypointType* wayPoints,
+		const char* trajDataBuffer, const size_t bufferLength);
+ssize_t encodeTRAJMessageFooterCtx(ISOCodecContextType* context, char* trajDataBuffer, const size_t bufferLength);
+ssize_t decodeTRAJMessageHeaderCtx(ISOCodecContextType* context, TrajectoryHeaderType* trajHeader,
+		const char* trajDataBuffer, const size_t bufferLength);
+ssize_t encodeSTRTMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const StartMessageType* startData, char* strtDataBuffer, const size_t bufferLength);
+ssize_t decodeSTRTMessageCtx(ISOCodecContextType* context, const char* strtDataBuffer, const size_t bufferLength,
+		const struct timeval* currentTime, StartMessageType* startData);
+ssize_t encodeOSEMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const ObjectSettingsType* objectSettingsData, char* osemDataBuffer, const size_t bufferLength);
+ssize_t decodeOSEMMessageCtx(ISOCodecContextType* context, ObjectSettingsType* objectSettingsData,
+		const char* osemDataBuffer, const size_t bufferLength);
+ssize_t encodeOSTMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const enum ObjectCommandType command, char* ostmDataBuffer, const size_t bufferLength);
+ssize_t decodeOSTMMessageCtx(ISOCodecContextType* context, const char* ostmDataBuffer, const size_t bufferLength,
+		enum ObjectCommandType* command);
+ssize_t encodeHEABMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const struct timeval* heabTime, const enum ControlCenterStatusType status, char* heabDataBuffer,
+		const size_t bufferLength);
+ssize_t decodeHEABMessageCtx(ISOCodecContextType* context, const char* heabDataBuffer, const size_t bufferLength,
+		const struct timeval currentTime, HeabMessageDataType* heabData);
+ssize_t encodeSYPMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const struct timeval synchronizationTime, const struct timeval freezeTime, char* sypmDataBuffer,
+		const size_t bufferLength);
+ssize_t encodeMTSPMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const struct timeval* estSyncPointTime, char* mtspDataBuffer, const size_t bufferLength);
+ssize_t encodeTRCMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const uint16_t* triggerID, const enum TriggerType_t* triggerType,
+		const enum TriggerTypeParameter_t* param1, const enum TriggerTypeParameter_t* param2,
+		const enum TriggerTypeParameter_t* param3, char* trcmDataBuffer, const size_t bufferLength);
+ssize_t encodeACCMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const uint16_t* actionID, const enum ActionType_t* actionType, const enum ActionTypeParameter_t* param1,
+		const enum ActionTypeParameter_t* param2, const enum ActionTypeParameter_t* param3, char* accmDataBuffer,
+		const size_t bufferLength);
+ssize_t encodeEXACMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const uint16_t* actionID, const struct timeval* executionTime, char* exacDataBuffer,
+		const size_t bufferLength);
+ssize_t decodeRCMMMessageCtx(ISOCodecContextType* context, const char* rcmmDataBuffer, const size_t bufferLength,
+		RemoteControlManoeuvreMessageType* rcmmData);
+ssize_t encodeRCMMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const RemoteControlManoeuvreMessageType* rcmmObjectData, char* rcmmDataBuffer, const size_t bufferLength);
+ssize_t decodeGREMMessageCtx(ISOCodecContextType* context, const char* gremDataBuffer, const size_t bufferLength,
+		GeneralResponseMessageType* gremData);
+ssize_t encodeGREMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const GeneralResponseMessageType* gremObjectData, char* gremDataBuffer, const size_t bufferLength);
+ssize_t encodeDRESMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const TestObjectDiscoveryType* testObjectDiscoveryData, char* dresDataBuffer, const size_t bufferLength);
+ssize_t decodeDRESMessageCtx(ISOCodecContextType* context, const char* dresDataBuffer, const size_t bufferLength,
+		TestObjectDiscoveryType* testObjectDiscoveryData);
+ssize_t encodeDREQMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		char* dreqDataBuffer, const size_t bufferLength);
+ssize_t decodeDREQMessageCtx(ISOCodecContextType* context, const char* dreqDataBuffer, const size_t bufferLength,
+		TestObjectDiscoveryRequestType* testObjectDiscoveryRequestData);
+ssize_t encodeINSUPMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const enum SupervisorCommandType command, char* insupDataBuffer, const size_t bufferLength);
+ssize_t encodeDCTIMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const DctiMessageDataType* dctiData, char* dctiDataBuffer, const size_t bufferLength);
+enum ISOMessageReturnValue decodeDCTIMessageCtx(ISOCodecContextType* context, const char* dctiDataBuffer,
+		const size_t bufferLength, DctiMessageDataType* dctiData);
+enum ISOMessageID getISOMessageTypeCtx(ISOCodecContextType* context, const char* messageData, const size_t length);
+ssize_t encodePODIMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const PeerObjectInjectionType* peerObjectData, char* podiDataBuffer, const size_t bufferLength);
+ssize_t decodePODIMessageCtx(ISOCodecContextType* context, const char* podiDataBuffer, const size_t bufferLength,
+		const struct timeval currentTime, PeerObjectInjectionType* peerData);
+ssize_t encodeOPROMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const ObjectPropertiesType* objectPropertiesData, char* oproDataBuffer, const size_t bufferLength);
+ssize_t decodeOPROMessageCtx(ISOCodecContextType* context, ObjectPropertiesType* objectPropertiesData,
+		const char* oproDataBuffer, const size_t bufferLength);
+ssize_t encodeFOPRMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const ForeignObjectPropertiesType* foreignObjectPropertiesData, char* foprDataBuffer,
+		const size_t bufferLength);
+ssize_t decodeFOPRMessageCtx(ISOCodecContextType* context,
+		ForeignObjectPropertiesType* foreignObjectPropertiesData, const char* foprDataBuffer,
+		const size_t bufferLength);
+ssize_t encodeRDCAMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const RequestControlActionType* requestControlActionData, char* rdcaDataBuffer, const size_t bufferLength);
+ssize_t decodeRDCAMessageCtx(ISOCodecContextType* context, const char* rdcaDataBuffer,
+		RequestControlActionType* requestControlActionData, const size_t bufferLength,
+		const struct timeval currentTime);
+ssize_t encodeGDRMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const GdrmMessageDataType* gdrmData, char* gdrmDataBuffer, const size_t bufferLength);
+enum ISOMessageReturnValue decodeGDRMMessageCtx(ISOCodecContextType* context, const char* gdrmDataBuffer,
+		const size_t bufferLength, GdrmMessageDataType* gdrmData);
+ssize_t encodeDCMMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const RemoteControlManoeuvreMessageType* command, char* dcmmDataBuffer, const size_t bufferLength);
+ssize_t decodeDCMMMessageCtx(ISOCodecContextType* context, const char* dcmmDataBuffer, const size_t bufferLength,
+		RemoteControlManoeuvreMessageType* dcmmData);
+ssize_t encodeMONRMessageFromSampleCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const MonitorSampleType* sample, char* monrDataBuffer, const size_t bufferLength);
+ssize_t decodeMONRMessageToSampleCtx(ISOCodecContextType* context, const char* monrDataBuffer,
+		const size_t bufferLength, const struct timeval currentTime, MonitorSampleType* sample);
+enum ISOMessageReturnValue decodeISOHeaderCtx(ISOCodecContextType* context, const char* messageBuffer,
+		const size_t length, HeaderType* headerData);
+ssize_t validateISOFrameCtx(ISOCodecContextType* context, const void* frame, const size_t length,
+		HeaderType* header);
+size_t validateISOFramesCtx(ISOCodecContextType* context, const void* const frames[], const size_t lengths[],
+		const size_t nFrames, HeaderType headers[], ssize_t results[]);
+ssize_t encodeVendorMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const uint16_t messageID, const void* messageData, char* buffer, const size_t bufferLength);
+ssize_t decodeVendorMessageCtx(ISOCodecContextType* context, const char* buffer, const size_t bufferLength,
+		void* messageData);
+ssize_t encodeMONR2MessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const ObjectMonitor2Type* monitorData, char* monr2DataBuffer, const size_t bufferLength);
+ssize_t decodeMONR2MessageCtx(ISOCodecContextType* context, const char* monr2DataBuffer, const size_t bufferLength,
+		const struct timeval currentTime, ObjectMonitor2Type* monitorData);
+size_t decodeMONR2MessagesCtx(ISOCodecContextType* context, const void* const frames[], const size_t lengths[],
+		const size_t nFrames, const struct timeval currentTime, ObjectMonitor2Type monitorData[], ssize_t results[]);
+ssize_t encodeCTRJMessageCtx(ISOCodecContextType* context, TrajectoryCompressorType* compressor,
+		const MessageHeaderType* inputHeader, char* ctrjDataBuffer, const size_t bufferLength);
+ssize_t decodeCTRJMessageHeaderCtx(ISOCodecContextType* context, TrajectoryDecompressorType* decompressor,
+		TrajectoryHeaderType* trajHeader, const char* ctrjDataBuffer, const size_t bufferLength);
+ssize_t encodeCTRAMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		char* ctraDataBuffer, const size_t bufferLength);
+ssize_t decodeCTRAMessageCtx(ISOCodecContextType* context, const char* ctraDataBuffer, const size_t bufferLength);
+ssize_t encodeTrajectoryMessageCtx(ISOCodecContextType* context, TrajectoryCompressorType* compressor,
+		const MessageHeaderType* inputHeader, const uint16_t trajectoryID, const TrajectoryInfoType trajectoryInfo,
+		const char* trajectoryName, const size_t nameLength, const TrajectoryWaypointType waypoints[],
+		const uint32_t nWaypoints, char* dataBuffer, const size_t bufferLength);
+
+/* Used by the encoders and decoders */
+ISOCodecContextType* getActiveCodecContext(void);
+ISOCodecContextType* getDefaultCodecContext(void);
+bool isCodecCRCVerificationEnabled(const ISOCodecContextType* context);
+bool isCodecProtocolVersionSupported(const ISOCodecContextType* context, const uint8_t version);
+uint16_t* getCodecTrajectoryCRC(ISOCodecContextType* context);
+void passErrorToCodecSink(ISOCodecContextType* context, const ISOErrorType* error, const char* format,
+		va_list args);
+
+#ifdef __cplusplus
+}
+#endif
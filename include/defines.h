@@ -56,6 +56,10 @@ extern "C" {
 #define SPEED_ONE_METER_PER_SECOND_VALUE 100.0
 #define ACCELERATION_UNAVAILABLE_VALUE (-32768)
 #define ACCELERATION_ONE_METER_PER_SECOND_SQUARED_VALUE 1000.0
+#define ANGULAR_RATE_UNAVAILABLE_VALUE (-32768)
+#define ANGULAR_RATE_ONE_DEGREE_PER_SECOND_VALUE 100.0
+#define POSITION_ACCURACY_UNAVAILABLE_VALUE 65535
+#define POSITION_ACCURACY_ONE_METER_VALUE 100.0
 #define RELATIVE_TIME_ONE_SECOND_VALUE 1000.0
 #define STEERING_ANGLE_ONE_DEGREE_VALUE 100.0
 #define STEERING_ANGLE_MAX_VALUE_DEG 18000
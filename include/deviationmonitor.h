@@ -0,0 +1,68 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/time.h>
+
+#include "iso22133.h"
+
+/*! Deviations of an object from its trajectory at one monitor sample */
+typedef struct {
+	uint32_t transmitterID;
+	struct timeval sampleTime;
+	struct timeval trajectoryTime;			//!< Time since start, clamped to the trajectory
+	double wayDeviation_m;					//!< Distance to the planned position at the trajectory time
+	double lateralDeviation_m;				//!< Distance to the path, positive if the object is to the
+											//!< left of the path in its direction of travel
+	double yawDeviation_rad;				//!< Heading relative to the path, in [-π, π), NAN if the
+											//!< object reported no valid heading
+	size_t segment;							//!< Segment of the path nearest to the object
+} TrajectoryDeviationType;
+
+typedef enum {
+	DEVIATION_EVENT_WAY,					//!< Way deviation above maxDeviation.position_m
+	DEVIATION_EVENT_LATERAL,				//!< Lateral deviation above maxDeviation.lateral_m
+	DEVIATION_EVENT_YAW,					//!< Yaw deviation above maxDeviation.yaw_rad
+	DEVIATION_EVENT_POSITIONING_ACCURACY	//!< Object reported positioning worse than
+											//!< minRequiredPositioningAccuracy_m
+} DeviationEventKindType;
+
+/*! Limit exceeded by an object. Events are raised on the sample where a limit becomes exceeded,
+ *  and again only after the object has been within the limit. */
+typedef struct {
+	uint32_t transmitterID;
+	DeviationEventKindType kind;
+	double deviation;						//!< Magnitude of the deviation, NAN for positioning accuracy
+	double limit;
+	struct timeval sampleTime;
+} DeviationEventType;
+
+typedef struct {
+	uint64_t nMonitorSamples;
+	uint64_t nEvaluations;					//!< Samples evaluated against a trajectory
+	uint64_t nSegmentsTested;
+	uint64_t nReacquisitions;				//!< Samples projected using the spatial index
+	uint64_t nEvents;
+} DeviationStatisticsType;
+
+typedef struct DeviationMonitor DeviationMonitorType;
+
+DeviationMonitorType* createDeviationMonitor(void);
+void freeDeviationMonitor(DeviationMonitorType* monitor);
+void resetDeviationMonitor(DeviationMonitorType* monitor);
+int setDeviationTrajectory(DeviationMonitorType* monitor, const uint32_t transmitterID,
+						   const TrajectoryWaypointType waypoints[], const size_t nWaypoints,
+						   const ObjectSettingsType* settings);
+int removeDeviationTrajectory(DeviationMonitorType* monitor, const uint32_t transmitterID);
+int setDeviationStartTime(DeviationMonitorType* monitor, const StartMessageType* startData);
+int processDeviationMonitorData(DeviationMonitorType* monitor, const uint32_t transmitterID,
+								const ObjectMonitorType* monitorData, const struct timeval* receiveTime,
+								TrajectoryDeviationType* deviation);
+size_t popDeviationEvents(DeviationMonitorType* monitor, DeviationEventType events[], const size_t maxEvents);
+DeviationStatisticsType getDeviationStatistics(const DeviationMonitorType* monitor);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,14 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stddef.h>
+
+int reserveArray(void** array, size_t* capacity, const size_t count, const size_t elementSize);
+
+//! Makes room for one more element in an array of count used and capacity allocated elements
+#define RESERVE(array, count, capacity) reserveArray((void**) &(array), &(capacity), (count), sizeof (*(array)))
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,45 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/time.h>
+
+#include "iso22133.h"
+
+/*! Planned states of all objects at one instant, one column per field and one row per object in
+ *  order of transmitter ID. The columns are owned by the evaluator and overwritten by the next
+ *  evaluation. */
+typedef struct {
+	size_t nObjects;
+	const uint32_t* transmitterID;
+	const double* x_m;
+	const double* y_m;
+	const double* z_m;
+	const double* heading_rad;
+	const double* longitudinalSpeed_m_s;
+	const double* lateralSpeed_m_s;
+	const double* longitudinalAcceleration_m_s2;
+	const double* lateralAcceleration_m_s2;
+	const float* curvature;
+	const bool* isWithinTrajectory;			//!< False before the start or after the end, where the
+											//!< nearest end of the trajectory is given
+} FleetPlannedStatesType;
+
+typedef struct FleetEvaluator FleetEvaluatorType;
+
+FleetEvaluatorType* createFleetEvaluator(void);
+void freeFleetEvaluator(FleetEvaluatorType* evaluator);
+int setFleetTrajectory(FleetEvaluatorType* evaluator, const uint32_t transmitterID,
+					   const TrajectoryWaypointType waypoints[], const size_t nWaypoints);
+int removeFleetTrajectory(FleetEvaluatorType* evaluator, const uint32_t transmitterID);
+int setFleetStartTime(FleetEvaluatorType* evaluator, const StartMessageType* startData);
+ssize_t evaluateFleetPlannedStates(FleetEvaluatorType* evaluator, const struct timeval* time,
+								   FleetPlannedStatesType* states);
+
+#ifdef __cplusplus
+}
+#endif
@@ -19,6 +19,10 @@ FooterType buildISOFooter(const void *message, const size_t messageSize, const c
 
 uint16_t crcByte(const uint16_t crc, const uint8_t byte);
 uint16_t crc16(const uint8_t * data, size_t dataLen);
+void crc16Interleaved(const uint8_t* const data[], const size_t dataLen[], const size_t nBlocks, uint16_t crc[]);
+uint16_t crc16Combine(const uint16_t crcFirst, const uint16_t crcSecond, const size_t secondLength);
+uint16_t crc16Patch(const uint16_t crc, const uint8_t* oldData, const uint8_t* newData, const size_t patchLength,
+					const size_t bytesAfterPatch);
 
 enum ISOMessageReturnValue verifyChecksum(
 		const void *data,
@@ -0,0 +1,18 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "header.h"
+
+ssize_t validateISOFrameHeader(const void* frame, const size_t length, HeaderType* header);
+ssize_t validateISOFrame(const void* frame, const size_t length, HeaderType* header);
+size_t validateISOFrames(const void* const frames[], const size_t lengths[], const size_t nFrames,
+						 HeaderType headers[], ssize_t results[]);
+
+#ifdef __cplusplus
+}
+#endif
@@ -34,6 +34,7 @@ typedef struct{
 
     uint16_t PayloadDataValueID;
     uint16_t PayloadDataContentLength;
+    uint8_t PayloadData;
     FooterType footer;
 } GREMType;
 #pragma pack(pop)
@@ -0,0 +1,41 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+
+#include "iso22133.h"
+
+/*! Description of the most recent error detected by an encoder or decoder */
+typedef struct {
+	enum ISOMessageReturnValue code;
+	enum ISOMessageID messageID;	//!< Message being encoded or decoded, MESSAGE_ID_INVALID if unknown
+	size_t offset;					//!< Byte offset into the message buffer where the error was detected
+	const char* function;			//!< Function which reported the error
+	const char* description;		//!< printf style format of the error message
+} ISOErrorType;
+
+/*! Called with each reported error which passes the rate limit, together with the formatted message.
+ *  May be called concurrently from all threads that encode or decode messages. */
+typedef void (*ISOErrorCallbackType)(const ISOErrorType* error, const char* message, void* userData);
+
+/*! Report an error detected in the calling function */
+#define ISO_REPORT_ERROR(code, messageID, offset, ...) \
+	reportISOError(code, messageID, offset, __func__, __VA_ARGS__)
+
+ISOErrorType getLastISOError(void);
+void clearLastISOError(void);
+void setISOErrorCallback(ISOErrorCallbackType callback, void* userData, const uint32_t maxReportsPerSecond);
+uint64_t getSuppressedISOErrorCount(void);
+
+void reportISOError(const enum ISOMessageReturnValue code, const enum ISOMessageID messageID, const size_t offset,
+					const char* function, const char* format, ...)
+#ifdef __GNUC__
+	__attribute__((format(printf, 5, 6)))
+#endif
+	;
+
+#ifdef __cplusplus
+}
+#endif
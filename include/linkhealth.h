@@ -0,0 +1,65 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <sys/time.h>
+
+#include "header.h"
+
+#define LINK_HEALTH_QUANTILE_MARKERS 5
+
+/*! Streaming P² quantile estimator, five markers regardless of sample count */
+typedef struct {
+	double probability;
+	double heights[LINK_HEALTH_QUANTILE_MARKERS];
+	double positions[LINK_HEALTH_QUANTILE_MARKERS];
+	double desiredPositions[LINK_HEALTH_QUANTILE_MARKERS];
+	double increments[LINK_HEALTH_QUANTILE_MARKERS];
+	uint32_t count;
+} QuantileEstimatorType;
+
+/*! Link health statistics for a single transmitter */
+typedef struct {
+	uint32_t transmitterID;
+	bool isActive;
+	uint8_t highestCounter;		//!< Highest message counter seen, with wrap
+	uint64_t receivedWindow;	//!< Bit k set if counter (highestCounter - k) was received
+	uint64_t received;
+	uint64_t lost;
+	uint64_t duplicated;
+	uint64_t reordered;
+	uint64_t resynchronized;	//!< Number of counter jumps too large to be interpreted as loss
+	int64_t lastArrival_us;
+	double lastInterArrival_us;
+	double minInterArrival_us;
+	double maxInterArrival_us;
+	double jitter_us;			//!< Smoothed jitter estimate according to RFC 3550
+	QuantileEstimatorType jitterMedian;
+	QuantileEstimatorType jitterP95;
+	QuantileEstimatorType jitterP99;
+} LinkHealthType;
+
+/*! Table of link health statistics, keyed on transmitter ID, backed by caller supplied storage */
+typedef struct {
+	LinkHealthType* entries;
+	size_t capacity;
+	size_t nEntries;
+} LinkHealthTableType;
+
+int initLinkHealthTable(LinkHealthTableType* table, LinkHealthType* storage, const size_t capacity);
+void resetLinkHealthTable(LinkHealthTableType* table);
+const LinkHealthType* updateLinkHealth(LinkHealthTableType* table, const HeaderType* header,
+									   const struct timeval* receiveTime);
+const LinkHealthType* getLinkHealth(const LinkHealthTableType* table, const uint32_t transmitterID);
+double getLinkLossRatio(const LinkHealthType* link);
+
+void initQuantileEstimator(QuantileEstimatorType* estimator, const double probability);
+void updateQuantileEstimator(QuantileEstimatorType* estimator, const double sample);
+double getQuantileEstimate(const QuantileEstimatorType* estimator);
+
+#ifdef __cplusplus
+}
+#endif
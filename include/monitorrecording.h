@@ -0,0 +1,82 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "monitorsample.h"
+
+/*! Columns of a recording block, each stored as a separate delta encoded run of varints */
+typedef enum {
+	MONITOR_RECORDING_COLUMN_TIME,				//!< GPS time since epoch [¼ ms], delta-of-delta
+	MONITOR_RECORDING_COLUMN_X,
+	MONITOR_RECORDING_COLUMN_Y,
+	MONITOR_RECORDING_COLUMN_Z,
+	MONITOR_RECORDING_COLUMN_YAW,
+	MONITOR_RECORDING_COLUMN_LONGITUDINAL_SPEED,
+	MONITOR_RECORDING_COLUMN_LATERAL_SPEED,
+	MONITOR_RECORDING_COLUMN_LONGITUDINAL_ACC,
+	MONITOR_RECORDING_COLUMN_LATERAL_ACC,
+	MONITOR_RECORDING_COLUMN_STATUS,			//!< Error status, state, direction, readiness and validity flags
+	MONITOR_RECORDING_COLUMN_COUNT
+} MonitorRecordingColumnType;
+
+/*! A monitor sample together with the object it was received from */
+typedef struct {
+	uint32_t transmitterID;
+	MonitorSampleType sample;
+} MonitorRecordType;
+
+typedef struct {
+	size_t queueCapacity;		//!< Number of records buffered between receive path and writer, power of two
+	size_t samplesPerBlock;		//!< Number of samples per object collected before a block is written
+} MonitorRecorderConfigType;
+
+typedef struct {
+	uint64_t submitted;
+	uint64_t dropped;			//!< Records rejected because the queue was full
+	uint64_t blocksWritten;
+	uint64_t bytesWritten;
+	int writeError;				//!< errno of the first failed write, or 0
+} MonitorRecorderStatisticsType;
+
+typedef struct MonitorRecorder MonitorRecorderType;
+
+/*! Index entry describing one block of a recording */
+typedef struct {
+	uint32_t transmitterID;
+	uint32_t nSamples;
+	uint64_t firstGPSQms;
+	uint64_t lastGPSQms;
+	uint64_t offset;			//!< Position of the block header in the file
+} MonitorRecordingBlockType;
+
+/*! Read only view of a recording file mapped into memory */
+typedef struct {
+	const uint8_t* data;
+	size_t size;
+	MonitorRecordingBlockType* blocks;	//!< Sorted on transmitter ID, then time
+	size_t nBlocks;
+	int isIndexRebuilt;					//!< Set if the file lacked a valid index and was scanned
+} MonitorRecordingType;
+
+MonitorRecorderType* openMonitorRecorder(const char* path, const MonitorRecorderConfigType* config);
+ssize_t submitMonitorRecords(MonitorRecorderType* recorder, const MonitorRecordType* records, const size_t nRecords);
+void getMonitorRecorderStatistics(MonitorRecorderType* recorder, MonitorRecorderStatisticsType* statistics);
+int closeMonitorRecorder(MonitorRecorderType* recorder);
+
+int openMonitorRecording(const char* path, MonitorRecordingType* recording);
+void closeMonitorRecording(MonitorRecordingType* recording);
+ssize_t findMonitorRecordingBlock(const MonitorRecordingType* recording, const uint32_t transmitterID,
+								  const uint64_t gpsQms);
+ssize_t decodeMonitorRecordingBlock(const MonitorRecordingType* recording, const size_t blockIndex,
+									MonitorSampleType* samples, const size_t capacity);
+ssize_t decodeMonitorRecordingColumn(const MonitorRecordingType* recording, const size_t blockIndex,
+									 const MonitorRecordingColumnType column, int64_t* values,
+									 const size_t capacity);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#include "positioning.h"
+#include "defines.h"
+#include "timeconversions.h"
+
+/*! Compact monitor sample holding the contents of an ObjectMonitorType in ISO fixed point units */
+typedef struct {
+	uint32_t gpsQmsOfWeek;				//!< [¼ ms]
+	uint16_t gpsWeek;
+	uint16_t yaw;						//!< [0.01 deg]
+	int32_t xPosition;					//!< [mm]
+	int32_t yPosition;					//!< [mm]
+	int32_t zPosition;					//!< [mm]
+	int16_t longitudinalSpeed;			//!< [0.01 m/s]
+	int16_t lateralSpeed;				//!< [0.01 m/s]
+	int16_t longitudinalAcc;			//!< [0.001 m/s²]
+	int16_t lateralAcc;					//!< [0.001 m/s²]
+	uint8_t errorStatus;				//!< ISO error bitmask, see BITMASK_ERROR_*
+	uint8_t state : 4;					//!< ::ObjectStateType
+	uint8_t drivingDirection : 2;		//!< ::DriveDirectionType
+	uint8_t armReadiness : 2;			//!< ::ObjectArmReadinessType
+	uint16_t isTimestampValid : 1;
+	uint16_t isXcoordValid : 1;
+	uint16_t isYcoordValid : 1;
+	uint16_t isZcoordValid : 1;
+	uint16_t isPositionValid : 1;
+	uint16_t isHeadingValid : 1;
+	uint16_t isLongitudinalSpeedValid : 1;
+	uint16_t isLateralSpeedValid : 1;
+	uint16_t isLongitudinalAccValid : 1;
+	uint16_t isLateralAccValid : 1;
+} MonitorSampleType;
+
+void convertObjectMonitorToSamples(const ObjectMonitorType* monitorData, MonitorSampleType* samples,
+								   const size_t nSamples);
+void convertSamplesToObjectMonitor(const MonitorSampleType* samples, ObjectMonitorType* monitorData,
+								   const size_t nSamples);
+
+// Accessors converting single fields to SI units
+static inline double getMonitorSampleXCoord_m(const MonitorSampleType* sample) {
+	return sample->xPosition / POSITION_ONE_METER_VALUE;
+}
+static inline double getMonitorSampleYCoord_m(const MonitorSampleType* sample) {
+	return sample->yPosition / POSITION_ONE_METER_VALUE;
+}
+static inline double getMonitorSampleZCoord_m(const MonitorSampleType* sample) {
+	return sample->zPosition / POSITION_ONE_METER_VALUE;
+}
+static inline double getMonitorSampleHeading_rad(const MonitorSampleType* sample) {
+	return sample->yaw / YAW_ONE_DEGREE_VALUE * M_PI / 180.0;
+}
+static inline double getMonitorSampleLongitudinalSpeed_m_s(const MonitorSampleType* sample) {
+	return sample->longitudinalSpeed / SPEED_ONE_METER_PER_SECOND_VALUE;
+}
+static inline double getMonitorSampleLateralSpeed_m_s(const MonitorSampleType* sample) {
+	return sample->lateralSpeed / SPEED_ONE_METER_PER_SECOND_VALUE;
+}
+static inline double getMonitorSampleLongitudinalAcc_m_s2(const MonitorSampleType* sample) {
+	return sample->longitudinalAcc / ACCELERATION_ONE_METER_PER_SECOND_SQUARED_VALUE;
+}
+static inline double getMonitorSampleLateralAcc_m_s2(const MonitorSampleType* sample) {
+	return sample->lateralAcc / ACCELERATION_ONE_METER_PER_SECOND_SQUARED_VALUE;
+}
+static inline ObjectStateType getMonitorSampleState(const MonitorSampleType* sample) {
+	return (ObjectStateType) sample->state;
+}
+static inline int8_t getMonitorSampleTimestamp(const MonitorSampleType* sample, struct timeval* timestamp) {
+	return sample->isTimestampValid ? setToGPStime(timestamp, sample->gpsWeek, sample->gpsQmsOfWeek) : -1;
+}
+//! Time since the GPS epoch, convenient for ordering and differencing samples
+static inline uint64_t getMonitorSampleGPSQms(const MonitorSampleType* sample) {
+	return (uint64_t) sample->gpsWeek * WEEK_TIME_QMS + sample->gpsQmsOfWeek;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -6,6 +6,7 @@ extern "C" {
 #include "header.h"
 #include "footer.h"
 #include "iso22133.h"
+#include "monitorsample.h"
 
 #pragma pack(push, 1)
 //! MONR message */
@@ -41,6 +42,15 @@ void convertMONRToHostRepresentation(
 		const MONRType * MONRData,
 		const struct timeval *currentTime,
 		ObjectMonitorType * monitorData);
+void convertMONRToMonitorSample(
+		const MONRType * MONRData,
+		const struct timeval *currentTime,
+		MonitorSampleType * sample);
+
+ssize_t encodeMONRMessageFromSample(const MessageHeaderType *inputHeader, const MonitorSampleType * sample,
+									char * monrDataBuffer, const size_t bufferLength, const char debug);
+ssize_t decodeMONRMessageToSample(const char * monrDataBuffer, const size_t bufferLength,
+								  const struct timeval currentTime, MonitorSampleType * sample, const char debug);
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,114 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/time.h>
+
+#include "header.h"
+#include "footer.h"
+#include "iso22133.h"
+#include "defines.h"
+
+#pragma pack(push, 1)
+/*! MONR2 message */
+typedef struct {
+	HeaderType header;
+	uint16_t monr2StructValueID;
+	uint16_t monr2StructContentLength;
+	uint32_t gpsQmsOfWeek;
+	int16_t pitch;
+	int16_t roll;
+	int16_t verticalSpeed;
+	int16_t verticalAcc;
+	int16_t yawRate;
+	int16_t pitchRate;
+	int16_t rollRate;
+	uint16_t positionAccuracy;
+	FooterType footer;
+} MONR2Type;
+#pragma pack(pop)
+
+//! MONR2 value IDs
+#define VALUE_ID_MONR2_STRUCT 0x81
+
+/*! Secondary monitoring data of an object, sent at its own rate alongside MONR */
+typedef struct {
+	bool isTimestampValid;
+	struct timeval timestamp;
+	double pitch_rad;
+	double roll_rad;
+	double verticalSpeed_m_s;
+	double verticalAcc_m_s2;
+	double yawRate_rad_s;
+	double pitchRate_rad_s;
+	double rollRate_rad_s;
+	double positionAccuracy_m;
+	bool isPitchValid;
+	bool isRollValid;
+	bool isVerticalSpeedValid;
+	bool isVerticalAccValid;
+	bool isYawRateValid;
+	bool isPitchRateValid;
+	bool isRollRateValid;
+	bool isPositionAccuracyValid;
+} ObjectMonitor2Type;
+
+/*! Read-only view of a validated MONR2 message in its receive buffer. Fields are read from the
+ *  buffer on access, in ISO units, and the view is valid as long as the buffer is. */
+typedef struct {
+	HeaderType header;
+	const uint8_t* message;
+} MONR2ViewType;
+
+size_t getEncodedSizeMONR2Message(void);
+ssize_t encodeMONR2Message(const MessageHeaderType* inputHeader, const ObjectMonitor2Type* monitorData,
+						   char* monr2DataBuffer, const size_t bufferLength, const char debug);
+ssize_t decodeMONR2Message(const char* monr2DataBuffer, const size_t bufferLength,
+						   const struct timeval currentTime, ObjectMonitor2Type* monitorData, const char debug);
+size_t decodeMONR2Messages(const void* const frames[], const size_t lengths[], const size_t nFrames,
+						   const struct timeval currentTime, ObjectMonitor2Type monitorData[], ssize_t results[]);
+ssize_t viewMONR2Message(const char* monr2DataBuffer, const size_t bufferLength, MONR2ViewType* view);
+
+// Accessors reading single fields of a view, in ISO units
+static inline uint16_t readMONR2ViewU16(const MONR2ViewType* view, const size_t offset) {
+	uint16_t value;
+	memcpy(&value, view->message + offset, sizeof (value));
+	return le16toh(value);
+}
+static inline uint32_t getMONR2ViewGPSQmsOfWeek(const MONR2ViewType* view) {
+	uint32_t value;
+	memcpy(&value, view->message + offsetof(MONR2Type, gpsQmsOfWeek), sizeof (value));
+	return le32toh(value);
+}
+static inline int16_t getMONR2ViewPitch(const MONR2ViewType* view) {
+	return (int16_t) readMONR2ViewU16(view, offsetof(MONR2Type, pitch));
+}
+static inline int16_t getMONR2ViewRoll(const MONR2ViewType* view) {
+	return (int16_t) readMONR2ViewU16(view, offsetof(MONR2Type, roll));
+}
+static inline int16_t getMONR2ViewVerticalSpeed(const MONR2ViewType* view) {
+	return (int16_t) readMONR2ViewU16(view, offsetof(MONR2Type, verticalSpeed));
+}
+static inline int16_t getMONR2ViewVerticalAcc(const MONR2ViewType* view) {
+	return (int16_t) readMONR2ViewU16(view, offsetof(MONR2Type, verticalAcc));
+}
+static inline int16_t getMONR2ViewYawRate(const MONR2ViewType* view) {
+	return (int16_t) readMONR2ViewU16(view, offsetof(MONR2Type, yawRate));
+}
+static inline int16_t getMONR2ViewPitchRate(const MONR2ViewType* view) {
+	return (int16_t) readMONR2ViewU16(view, offsetof(MONR2Type, pitchRate));
+}
+static inline int16_t getMONR2ViewRollRate(const MONR2ViewType* view) {
+	return (int16_t) readMONR2ViewU16(view, offsetof(MONR2Type, rollRate));
+}
+static inline uint16_t getMONR2ViewPositionAccuracy(const MONR2ViewType* view) {
+	return readMONR2ViewU16(view, offsetof(MONR2Type, positionAccuracy));
+}
+
+#ifdef __cplusplus
+}
+#endif
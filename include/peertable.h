@@ -0,0 +1,67 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/time.h>
+
+#include "iso22133.h"
+
+//! PODI value IDs
+#define VALUE_ID_PODI_FOREIGN_TRANSMITTER_ID	0x00FF
+#define VALUE_ID_PODI_GPS_QMS_OF_WEEK			0x010A
+#define VALUE_ID_PODI_OBJECT_STATE				0x010C
+#define VALUE_ID_PODI_X_POSITION				0x010D
+#define VALUE_ID_PODI_Y_POSITION				0x010E
+#define VALUE_ID_PODI_Z_POSITION				0x010F
+#define VALUE_ID_PODI_HEADING					0x0110
+#define VALUE_ID_PODI_PITCH						0x0111
+#define VALUE_ID_PODI_ROLL						0x0112
+#define VALUE_ID_PODI_LONGITUDINAL_SPEED		0x0113
+#define VALUE_ID_PODI_LATERAL_SPEED				0x0114
+
+/*! Read-only view of the newest state of each peer, one array per field, all indexed alike and
+ *  sorted on foreign transmitter ID. Valid until the table is next modified. */
+typedef struct {
+	size_t nPeers;
+	const uint32_t* foreignTransmitterID;
+	const uint64_t* gpsQms;				//!< Time of the sample since the GPS epoch [¼ ms]
+	const uint8_t* state;				//!< ::ObjectStateType
+	const double* xCoord_m;
+	const double* yCoord_m;
+	const double* zCoord_m;
+	const double* heading_rad;
+	const uint8_t* isHeadingValid;
+	const double* pitch_rad;
+	const uint8_t* isPitchValid;
+	const double* roll_rad;
+	const uint8_t* isRollValid;
+	const double* longitudinalSpeed_m_s;
+	const uint8_t* isLongitudinalSpeedValid;
+	const double* lateralSpeed_m_s;
+	const uint8_t* isLateralSpeedValid;
+} PeerTableSnapshotType;
+
+typedef struct {
+	uint64_t nSamplesApplied;
+	uint64_t nSamplesOutdated;		//!< Valid messages discarded since a newer sample of the peer was held
+	uint64_t nDecodeErrors;
+} PeerTableStatisticsType;
+
+typedef struct PeerTable PeerTableType;
+
+PeerTableType* createPeerTable(const size_t initialCapacity);
+void freePeerTable(PeerTableType* table);
+size_t decodePODIMessages(PeerTableType* table, const void* const frames[], const size_t lengths[],
+						  const size_t nFrames, const struct timeval currentTime, ssize_t results[]);
+PeerTableSnapshotType getPeerTableSnapshot(const PeerTableType* table);
+ssize_t findPeerTableIndex(const PeerTableType* table, const uint32_t foreignTransmitterID);
+int getPeerTableEntry(const PeerTableType* table, const size_t index, PeerObjectInjectionType* peerData);
+size_t removeOutdatedPeers(PeerTableType* table, const struct timeval* oldestTime);
+PeerTableStatisticsType getPeerTableStatistics(const PeerTableType* table);
+
+#ifdef __cplusplus
+}
+#endif
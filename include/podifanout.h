@@ -0,0 +1,40 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "iso22133.h"
+
+//! Default maximum datagram payload, fitting a 1500 byte Ethernet MTU with IPv4 and UDP headers
+#define PODI_FANOUT_DEFAULT_DATAGRAM_SIZE 1472
+
+/*! Called with each datagram of PODI messages for a receiver. A negative return value aborts the tick. */
+typedef ssize_t (*PODIFanoutSinkType)(const uint32_t receiverID, const char* datagram, const size_t length,
+									  void* userData);
+
+typedef struct {
+	uint64_t nTicks;
+	uint64_t nPeersEncoded;		//!< PODI messages encoded, once per peer and tick
+	uint64_t nEncodeErrors;		//!< Peers which could not be encoded and were left out of the tick
+	uint64_t nFramesSent;		//!< PODI messages passed to the sink after patching the header
+	uint64_t nFramesFiltered;	//!< Messages not sent since the peer was outside the interest radius
+	uint64_t nDatagramsSent;
+} PODIFanoutStatisticsType;
+
+typedef struct PODIFanout PODIFanoutType;
+
+PODIFanoutType* createPODIFanout(const uint32_t transmitterID, const size_t maxDatagramSize);
+void freePODIFanout(PODIFanoutType* fanout);
+int addPODIFanoutReceiver(PODIFanoutType* fanout, const uint32_t receiverID, const double interestRadius_m);
+int removePODIFanoutReceiver(PODIFanoutType* fanout, const uint32_t receiverID);
+int updatePODIFanoutPeer(PODIFanoutType* fanout, const PeerObjectInjectionType* peer);
+int removePODIFanoutPeer(PODIFanoutType* fanout, const uint32_t peerID);
+ssize_t runPODIFanoutTick(PODIFanoutType* fanout, PODIFanoutSinkType sink, void* userData);
+PODIFanoutStatisticsType getPODIFanoutStatistics(const PODIFanoutType* fanout);
+
+#ifdef __cplusplus
+}
+#endif
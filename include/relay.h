@@ -0,0 +1,64 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#include "header.h"
+
+//! Maximum number of datagrams received and sent in one system call
+#define ISO_RELAY_BATCH_SIZE 64
+//! Default maximum size of a relayed datagram
+#define ISO_RELAY_DEFAULT_DATAGRAM_SIZE 2048
+
+/*! Header fields matched and rewritten by a relay */
+enum RelayFieldType {
+	RELAY_FIELD_TRANSMITTER_ID = 0x01,
+	RELAY_FIELD_RECEIVER_ID = 0x02
+};
+
+/*! Rewrite of the IDs in frames matching a transmitter and/or receiver ID. Rules matching both IDs
+ *  take precedence, after which rules matching one or no ID are tried in the order they were added. */
+typedef struct {
+	uint8_t matchedFields;		//!< Bitwise OR of ::RelayFieldType, fields not included match any ID
+	uint32_t transmitterID;
+	uint32_t receiverID;
+	uint8_t rewrittenFields;	//!< Bitwise OR of ::RelayFieldType, fields not included are kept
+	uint32_t newTransmitterID;
+	uint32_t newReceiverID;
+} RelayRewriteType;
+
+typedef struct {
+	uint64_t nDatagramsReceived;
+	uint64_t nDatagramsForwarded;
+	uint64_t nFramesForwarded;
+	uint64_t nFramesRewritten;
+	uint64_t nMalformedFrames;		//!< Frames with invalid framing, dropped with the rest of their datagram
+	uint64_t nTruncatedDatagrams;	//!< Datagrams larger than the maximum datagram size, dropped
+	uint64_t nSendErrors;			//!< Datagrams that could not be sent
+} RelayStatisticsType;
+
+typedef struct ISORelay ISORelayType;
+
+ISORelayType* createISORelay(const size_t maxDatagramSize);
+void freeISORelay(ISORelayType* relay);
+int addRelayRoute(ISORelayType* relay, const int inputSocket, const int outputSocket,
+				  const struct sockaddr* destination, const socklen_t destinationLength);
+int addRelayRewrite(ISORelayType* relay, const int route, const RelayRewriteType* rewrite);
+ssize_t relayISOFrames(const ISORelayType* relay, const int route, char* datagram, const size_t length,
+					   RelayStatisticsType* statistics);
+ssize_t forwardRelayRoute(ISORelayType* relay, const int route);
+int runISORelay(ISORelayType* relay, const volatile sig_atomic_t* stop, const int pollInterval_ms);
+RelayStatisticsType getRelayStatistics(const ISORelayType* relay, const int route);
+
+ssize_t rewriteISOFrameIDs(char* frame, const size_t length, const uint8_t rewrittenFields,
+						   const uint32_t transmitterID, const uint32_t receiverID);
+
+#ifdef __cplusplus
+}
+#endif
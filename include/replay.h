@@ -0,0 +1,45 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <sys/time.h>
+#include <sys/types.h>
+
+#include "captureingest.h"
+#include "monitorrecording.h"
+
+typedef struct {
+	double speedFactor;			//!< 1 for real time, 2 for twice as fast, 0 for as fast as possible
+	bool isTimestampRewritten;	//!< Shift MONR and HEAB timestamps as if sent starting at startTime
+	struct timeval startTime;	//!< Rewritten time of the first message, zero for the current time
+	uint32_t receiverID;		//!< Receiver of messages encoded from recordings
+} ReplayConfigType;
+
+/*! Called with each message to be sent, a negative return value aborts the replay */
+typedef ssize_t (*ReplaySinkType)(const char* data, const size_t length, void* userData);
+
+/*! Adherence to the replay schedule. Lateness is the time a message was passed to the sink after
+ *  its deadline, and is only measured when pacing. */
+typedef struct {
+	uint64_t nFrames;				//!< Messages passed to the sink
+	uint64_t nRewritten;			//!< Messages whose timestamp was rewritten
+	int64_t scheduledDuration_ns;	//!< Time between first and last deadline
+	int64_t elapsed_ns;				//!< Time between first and last message actually sent
+	int64_t drift_ns;				//!< Lateness of the last message
+	int64_t maxLateness_ns;
+	double meanLateness_ns;
+	double medianLateness_ns;
+	double p99Lateness_ns;
+} ReplayStatisticsType;
+
+int replayCapture(const CaptureType* capture, const ReplayConfigType* config, ReplaySinkType sink,
+				  void* userData, ReplayStatisticsType* statistics);
+int replayMonitorRecording(const MonitorRecordingType* recording, const ReplayConfigType* config,
+						   ReplaySinkType sink, void* userData, ReplayStatisticsType* statistics);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/time.h>
+
+#include "iso22133.h"
+
+/*! Condition evaluated on the monitor data of one object. Conditions fire on the sample where
+ *  they become true, and again only after having been false. */
+typedef struct {
+	uint16_t triggerID;
+	uint32_t transmitterID;					//!< Object whose monitor data is evaluated
+	enum TriggerType_t type;				//!< ::TRIGGER_SPEED, ::TRIGGER_POSITION_REACHED,
+											//!< ::TRIGGER_POSITION_LEFT or ::TRIGGER_MODE_CHANGED
+	enum TriggerTypeParameter_t comparison;	//!< Greater or less than parameter, for speed triggers
+	double speedThreshold_m_s;				//!< Compared to the longitudinal speed
+	double minX_m;							//!< Region of position triggers
+	double minY_m;
+	double maxX_m;
+	double maxY_m;
+	ObjectStateType state;					//!< State entered, for mode triggers
+} ScenarioTriggerType;
+
+/*! Action executed by an object some time after a trigger fires */
+typedef struct {
+	uint16_t actionID;
+	uint16_t triggerID;
+	uint32_t transmitterID;					//!< Object executing the action, receiver of the EXAC
+	struct timeval delay;					//!< Time from receipt of the firing monitor data to execution
+} ScenarioActionType;
+
+/*! Scheduled execution of an action, to be sent in an EXAC message */
+typedef struct {
+	uint16_t actionID;
+	uint32_t transmitterID;
+	struct timeval executionTime;
+	struct timeval triggerTime;				//!< Receipt of the monitor data which fired the trigger
+} ScenarioExecutionType;
+
+typedef struct {
+	uint64_t nMonitorSamples;
+	uint64_t nTriggerEvaluations;			//!< Conditions tested, the rest were excluded by the index
+	uint64_t nTriggersFired;
+	uint64_t nExecutionsScheduled;
+	uint64_t nExecutionsSent;
+	uint64_t nExecutionsLate;				//!< EXAC messages encoded after their execution time
+	int64_t minLatency_us;					//!< Time from receipt of monitor data to EXAC encoding
+	int64_t maxLatency_us;
+	int64_t totalLatency_us;
+} ScenarioStatisticsType;
+
+typedef struct ScenarioEngine ScenarioEngineType;
+
+ScenarioEngineType* createScenarioEngine(const double gridCellSize_m, const struct timeval* sendLeadTime);
+void freeScenarioEngine(ScenarioEngineType* engine);
+void resetScenarioEngine(ScenarioEngineType* engine);
+int addScenarioTrigger(ScenarioEngineType* engine, const ScenarioTriggerType* trigger);
+int addScenarioAction(ScenarioEngineType* engine, const ScenarioActionType* action);
+ssize_t processScenarioMonitorData(ScenarioEngineType* engine, const uint32_t transmitterID,
+								   const ObjectMonitorType* monitorData, const struct timeval* receiveTime);
+int getNextScenarioDeadline(const ScenarioEngineType* engine, struct timeval* deadline);
+size_t popDueScenarioExecutions(ScenarioEngineType* engine, const struct timeval* currentTime,
+								ScenarioExecutionType executions[], const size_t maxExecutions);
+ssize_t encodeScenarioEXACMessage(ScenarioEngineType* engine, const MessageHeaderType* inputHeader,
+								  const ScenarioExecutionType* execution, const struct timeval* sendTime,
+								  char* exacDataBuffer, const size_t bufferLength, const char debug);
+ScenarioStatisticsType getScenarioStatistics(const ScenarioEngineType* engine);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stddef.h>
+#include <sys/time.h>
+
+#include "iso22133.h"
+
+/*! Point on a trajectory nearest to a position */
+typedef struct {
+	size_t segment;							//!< Index of the waypoint starting the nearest segment
+	double fraction;						//!< Of the segment before the nearest point
+	double x_m;								//!< Nearest point
+	double y_m;
+	double distance_m;						//!< From the position to the nearest point
+	double lateralOffset_m;					//!< Distance, positive if the position is to the left
+											//!< of the trajectory in its direction of travel
+	double arcLength_m;						//!< Along the trajectory to the nearest point
+	struct timeval relativeTime;			//!< At which the trajectory passes the nearest point
+} TrajectoryProjectionType;
+
+typedef struct SpatialIndex SpatialIndexType;
+
+SpatialIndexType* createSpatialIndex(const TrajectoryWaypointType waypoints[], const size_t nWaypoints);
+void freeSpatialIndex(SpatialIndexType* index);
+int projectOntoSpatialIndex(const SpatialIndexType* index, const double x_m, const double y_m,
+							TrajectoryProjectionType* projection);
+size_t projectManyOntoSpatialIndex(const SpatialIndexType* index, const double x_m[], const double y_m[],
+								   const size_t nPositions, TrajectoryProjectionType projections[]);
+
+#ifdef __cplusplus
+}
+#endif
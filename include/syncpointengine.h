@@ -0,0 +1,55 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/time.h>
+
+#include "iso22133.h"
+
+/*! Point on the trajectory of a master object with which a slave object synchronises */
+typedef struct {
+	uint16_t syncPointID;
+	uint32_t masterTransmitterID;
+	uint32_t slaveTransmitterID;			//!< Receiver of the MTSP updates
+	struct timeval masterTime;				//!< Time from the start of the master trajectory at which
+											//!< the master passes the sync point
+} SyncPointType;
+
+/*! Estimate to be sent to a slave in an MTSP message */
+typedef struct {
+	uint16_t syncPointID;
+	uint32_t masterTransmitterID;
+	uint32_t slaveTransmitterID;
+	struct timeval estSyncPointTime;		//!< Estimated time at which the master passes the sync point
+	double remainingDistance_m;				//!< Along the master trajectory
+} SyncPointUpdateType;
+
+typedef struct {
+	uint64_t nMonitorSamples;
+	uint64_t nSegmentsTested;				//!< Trajectory segments a position was projected onto
+	uint64_t nReacquisitions;				//!< Samples too far from the predicted segment, located
+											//!< through the spatial index of the whole trajectory
+	uint64_t nUpdates;
+} SyncPointStatisticsType;
+
+typedef struct SyncPointEngine SyncPointEngineType;
+
+SyncPointEngineType* createSyncPointEngine(const struct timeval* updatePeriod);
+void freeSyncPointEngine(SyncPointEngineType* engine);
+void resetSyncPointEngine(SyncPointEngineType* engine);
+int setSyncPointMasterTrajectory(SyncPointEngineType* engine, const uint32_t masterTransmitterID,
+								 const TrajectoryWaypointType waypoints[], const size_t nWaypoints);
+int addSyncPoint(SyncPointEngineType* engine, const SyncPointType* syncPoint);
+int processSyncPointMonitorData(SyncPointEngineType* engine, const uint32_t transmitterID,
+								const ObjectMonitorType* monitorData, const struct timeval* receiveTime);
+int getNextSyncPointDeadline(const SyncPointEngineType* engine, struct timeval* deadline);
+size_t popDueSyncPointUpdates(SyncPointEngineType* engine, const struct timeval* currentTime,
+							  SyncPointUpdateType updates[], const size_t maxUpdates);
+SyncPointStatisticsType getSyncPointStatistics(const SyncPointEngineType* engine);
+
+#ifdef __cplusplus
+}
+#endif
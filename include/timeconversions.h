@@ -5,11 +5,15 @@ extern "C" {
 #include <stdint.h>
 #include <sys/time.h>
 
+#define MICROSECONDS_PER_SECOND 1000000
+
 // Time functions
 int8_t setToGPStime(struct timeval *time, const uint16_t GPSweek, const uint32_t GPSqmsOfWeek);
 int32_t getAsGPSWeek(const struct timeval *time);
 int64_t getAsGPSQuarterMillisecondOfWeek(const struct timeval *time);
 uint64_t getAsGPSms(const struct timeval *time);
+int64_t timevalToMicroseconds(const struct timeval *time);
+struct timeval microsecondsToTimeval(const int64_t time_us);
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
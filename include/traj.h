@@ -60,10 +60,16 @@ typedef struct {
 
 #define TRAJ_LINE_INFO_END_OF_TRANSMISSION 0x04
 
-static enum ISOMessageReturnValue convertTRAJHeaderToHostRepresentation(TRAJHeaderType* TRAJHeaderData,
-				uint32_t trajectoryLength,	TrajectoryHeaderType* trajectoryHeaderData);
-static enum ISOMessageReturnValue convertTRAJPointToHostRepresentation(TRAJPointType* TRAJPointData,
-														TrajectoryWaypointType* wayPoint);
+enum ISOMessageReturnValue convertTRAJPointToISORepresentation(const struct timeval* pointTimeFromStart,
+		const CartesianPosition position, const SpeedType speed, const AccelerationType acceleration,
+		const float curvature, TRAJPointType* TRAJPointData);
+void writeTRAJPoint(const TRAJPointType* TRAJPointData, char* trajDataBufferPointer);
+enum ISOMessageReturnValue convertTRAJPointToHostRepresentation(TRAJPointType* TRAJPointData,
+		TrajectoryWaypointType* wayPoint);
+ssize_t encodeTRAJMessageWaypoints(const MessageHeaderType* inputHeader, const uint16_t trajectoryID,
+		const TrajectoryInfoType trajectoryInfo, const char* trajectoryName, const size_t nameLength,
+		const TrajectoryWaypointType waypoints[], const uint32_t nWaypoints, char* trajDataBuffer,
+		const size_t bufferLength, const char debug);
 
 #ifdef __cplusplus
 }
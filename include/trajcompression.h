@@ -0,0 +1,56 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "iso22133.h"
+
+//! Version of the compressed trajectory codec implemented here, announced in CTRA messages
+#define CTRJ_CODEC_VERSION 1
+//! Number of points whose residuals are bit packed together
+#define CTRJ_POINTS_PER_BLOCK 64
+
+/*! Compresses the points of a trajectory into a CTRJ message, the vendor specific counterpart of
+ *  TRAJ. Points are quantised exactly as in TRAJ, predicted from the preceding points and the
+ *  residuals bit packed in blocks, so that decoding yields the same waypoints as a TRAJ message. */
+typedef struct TrajectoryCompressor TrajectoryCompressorType;
+/*! Decodes the points of a received CTRJ message a few at a time */
+typedef struct TrajectoryDecompressor TrajectoryDecompressorType;
+
+TrajectoryCompressorType* createTrajectoryCompressor(void);
+void freeTrajectoryCompressor(TrajectoryCompressorType* compressor);
+int beginCTRJMessage(TrajectoryCompressorType* compressor, const uint16_t trajectoryID,
+					 const TrajectoryInfoType trajectoryInfo, const char* trajectoryName, const size_t nameLength);
+int addCTRJMessagePoint(TrajectoryCompressorType* compressor, const struct timeval* pointTimeFromStart,
+						const CartesianPosition position, const SpeedType speed,
+						const AccelerationType acceleration, const float curvature);
+size_t getEncodedSizeCTRJMessage(const TrajectoryCompressorType* compressor);
+ssize_t encodeCTRJMessage(TrajectoryCompressorType* compressor, const MessageHeaderType* inputHeader,
+						  char* ctrjDataBuffer, const size_t bufferLength, const char debug);
+
+TrajectoryDecompressorType* createTrajectoryDecompressor(void);
+void freeTrajectoryDecompressor(TrajectoryDecompressorType* decompressor);
+ssize_t decodeCTRJMessageHeader(TrajectoryDecompressorType* decompressor, TrajectoryHeaderType* trajHeader,
+								const char* ctrjDataBuffer, const size_t bufferLength, const char debug);
+ssize_t decodeCTRJMessagePoints(TrajectoryDecompressorType* decompressor, TrajectoryWaypointType wayPoints[],
+								const size_t maxPoints);
+
+size_t getEncodedSizeCTRAMessage(void);
+ssize_t encodeCTRAMessage(const MessageHeaderType* inputHeader, char* ctraDataBuffer, const size_t bufferLength,
+						  const char debug);
+ssize_t decodeCTRAMessage(const char* ctraDataBuffer, const size_t bufferLength, uint8_t* codecVersion,
+						  const char debug);
+
+ssize_t encodeTrajectoryMessage(TrajectoryCompressorType* compressor, const uint8_t acceptedCodecVersion,
+								const MessageHeaderType* inputHeader, const uint16_t trajectoryID,
+								const TrajectoryInfoType trajectoryInfo, const char* trajectoryName,
+								const size_t nameLength, const TrajectoryWaypointType waypoints[],
+								const uint32_t nWaypoints, char* dataBuffer, const size_t bufferLength,
+								const char debug);
+
+#ifdef __cplusplus
+}
+#endif
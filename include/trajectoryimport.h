@@ -0,0 +1,56 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "iso22133.h"
+
+#define TRAJECTORY_IMPORT_MAX_COLUMNS 32
+
+/*! Meaning of a column of a trajectory text file. Time, x, y and longitudinal speed are required,
+ *  the other fields are unavailable in TRAJ if their column is missing or a field is empty. */
+typedef enum {
+	TRAJECTORY_COLUMN_IGNORED,
+	TRAJECTORY_COLUMN_TIME_S,				//!< Time from the start of the trajectory
+	TRAJECTORY_COLUMN_X_M,
+	TRAJECTORY_COLUMN_Y_M,
+	TRAJECTORY_COLUMN_Z_M,
+	TRAJECTORY_COLUMN_HEADING_RAD,
+	TRAJECTORY_COLUMN_HEADING_DEG,
+	TRAJECTORY_COLUMN_LONGITUDINAL_SPEED_M_S,
+	TRAJECTORY_COLUMN_LATERAL_SPEED_M_S,
+	TRAJECTORY_COLUMN_LONGITUDINAL_ACCELERATION_M_S2,
+	TRAJECTORY_COLUMN_LATERAL_ACCELERATION_M_S2,
+	TRAJECTORY_COLUMN_CURVATURE
+} TrajectoryColumnType;
+
+typedef struct {
+	char delimiter;							//!< Field separator, 0 for comma
+	size_t nColumns;						//!< Number of columns given, 0 to name them in a header line
+	TrajectoryColumnType columns[TRAJECTORY_IMPORT_MAX_COLUMNS];
+	unsigned int nThreads;					//!< Number of parsing threads, 0 for one per online processor
+} TrajectoryImportOptionsType;
+
+typedef struct {
+	size_t nLines;							//!< Lines in the text, including header, comments and blank lines
+	size_t nPoints;
+	size_t errorLine;						//!< First line which could not be imported, 0 if none
+} TrajectoryImportStatisticsType;
+
+ssize_t importTrajectoryText(const char* text, const size_t length, const TrajectoryImportOptionsType* options,
+							 const MessageHeaderType* inputHeader, const uint16_t trajectoryID,
+							 const TrajectoryInfoType trajectoryInfo, const char* trajectoryName,
+							 const size_t nameLength, char** trajDataBuffer,
+							 TrajectoryImportStatisticsType* statistics);
+ssize_t importTrajectoryFile(const char* path, const TrajectoryImportOptionsType* options,
+							 const MessageHeaderType* inputHeader, const uint16_t trajectoryID,
+							 const TrajectoryInfoType trajectoryInfo, const char* trajectoryName,
+							 const size_t nameLength, char** trajDataBuffer,
+							 TrajectoryImportStatisticsType* statistics);
+
+#ifdef __cplusplus
+}
+#endif
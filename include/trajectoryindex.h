@@ -0,0 +1,34 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/time.h>
+
+#include "iso22133.h"
+
+typedef struct TrajectoryIndex TrajectoryIndexType;
+
+/*! Position in a trajectory index, for lookup of times which mostly increase. May be copied,
+ *  and stays valid as long as the index. */
+typedef struct {
+	const TrajectoryIndexType* index;
+	size_t segment;
+} TrajectoryCursorType;
+
+TrajectoryIndexType* createTrajectoryIndex(const TrajectoryWaypointType waypoints[], const size_t nWaypoints);
+void freeTrajectoryIndex(TrajectoryIndexType* index);
+void initTrajectoryCursor(TrajectoryCursorType* cursor, const TrajectoryIndexType* index);
+int getTrajectoryPointAt(const TrajectoryIndexType* index, const struct timeval* relativeTime,
+						 TrajectoryWaypointType* point);
+int getTrajectoryPointAtCursor(TrajectoryCursorType* cursor, const struct timeval* relativeTime,
+							   TrajectoryWaypointType* point);
+size_t seekTrajectoryCursor(TrajectoryCursorType* cursor, const int64_t relativeTime_us);
+TrajectoryColumnsType getTrajectoryColumns(const TrajectoryIndexType* index);
+size_t getTrajectoryPointsAt(const TrajectoryIndexType* index, const struct timeval relativeTimes[],
+							 const size_t nTimes, TrajectoryWaypointType points[]);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "iso22133.h"
+#include "trajectoryindex.h"
+
+typedef enum {
+	TRAJECTORY_RESAMPLE_NONE,				//!< Keep the input times
+	TRAJECTORY_RESAMPLE_TIME,				//!< Fixed time step, in seconds
+	TRAJECTORY_RESAMPLE_DISTANCE			//!< Fixed arc length step, in meters
+} TrajectoryResampleModeType;
+
+typedef struct {
+	TrajectoryResampleModeType mode;
+	double step;
+} TrajectoryResampleOptionsType;
+
+/*! Resamples trajectories given as positions over time, deriving heading, speed, acceleration and
+ *  curvature from the positions. The output columns are owned by the resampler and overwritten by
+ *  the next resampling. */
+typedef struct TrajectoryResampler TrajectoryResamplerType;
+
+TrajectoryResamplerType* createTrajectoryResampler(void);
+void freeTrajectoryResampler(TrajectoryResamplerType* resampler);
+ssize_t resampleTrajectory(TrajectoryResamplerType* resampler, const TrajectoryColumnsType* input,
+						   const TrajectoryResampleOptionsType* options, TrajectoryColumnsType* output);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "iso22133.h"
+
+/*! Largest errors allowed between a removed point and the simplified trajectory, interpolated at
+ *  the time of the removed point. Use INFINITY to ignore an error. */
+typedef struct {
+	double position_m;				//!< Distance between the positions at the same time, which also
+									//!< bounds how early or late the simplified trajectory is
+	double speed_m_s;				//!< Difference in longitudinal and lateral speed
+	double curvature;				//!< Difference in curvature, 1/m
+	unsigned int nThreads;			//!< Number of simplifying threads, 0 for one per online processor
+} TrajectorySimplificationOptionsType;
+
+typedef struct {
+	size_t nInputPoints;
+	size_t nOutputPoints;
+	double compressionRatio;		//!< Input points per output point
+	double maxPositionError_m;		//!< Largest errors of the removed points
+	double maxSpeedError_m_s;
+	double maxCurvatureError;
+} TrajectorySimplificationStatisticsType;
+
+ssize_t simplifyTrajectory(const TrajectoryWaypointType waypoints[], const size_t nWaypoints,
+						   const TrajectorySimplificationOptionsType* options,
+						   TrajectoryWaypointType simplified[],
+						   TrajectorySimplificationStatisticsType* statistics);
+
+#ifdef __cplusplus
+}
+#endif
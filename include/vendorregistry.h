@@ -0,0 +1,46 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "iso22133.h"
+#include "header.h"
+
+/*! Writes the contents of a vendor message, i.e. everything between header and footer, and returns
+ *  the number of bytes written or a negative value on error. */
+typedef ssize_t (*VendorMessageEncoderType)(const void* messageData, char* content, const size_t contentCapacity,
+											void* userData);
+/*! Fills messageData from the contents of a received vendor message, returning a negative value
+ *  according to ::ISOMessageReturnValue on error. */
+typedef int (*VendorMessageDecoderType)(const HeaderType* header, const char* content, const size_t contentLength,
+										void* messageData, void* userData);
+/*! Handles the content of a vendor specific value ID within a standard message, returning a
+ *  negative value according to ::ISOMessageReturnValue on error. */
+typedef int (*VendorValueHandlerType)(const enum ISOMessageID messageID, const uint16_t valueID,
+									  const char* content, const uint16_t contentLength, void* userData);
+
+typedef struct {
+	VendorMessageEncoderType encode;
+	VendorMessageDecoderType decode;
+	void* userData;
+} VendorMessageHandlerType;
+
+int registerVendorMessage(const uint16_t messageID, const VendorMessageHandlerType* handler);
+int unregisterVendorMessage(const uint16_t messageID);
+const VendorMessageHandlerType* getVendorMessageHandler(const uint16_t messageID);
+ssize_t encodeVendorMessage(const MessageHeaderType* inputHeader, const uint16_t messageID, const void* messageData,
+							char* buffer, const size_t bufferLength, const char debug);
+ssize_t decodeVendorMessage(const char* buffer, const size_t bufferLength, void* messageData, const char debug);
+
+int registerVendorValueHandler(const enum ISOMessageID messageID, const uint16_t valueID,
+							   VendorValueHandlerType handler, void* userData);
+int unregisterVendorValueHandler(const enum ISOMessageID messageID, const uint16_t valueID);
+int handleVendorValue(const enum ISOMessageID messageID, const uint16_t valueID, const char* content,
+					  const uint16_t contentLength);
+
+#ifdef __cplusplus
+}
+#endif
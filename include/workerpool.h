@@ -0,0 +1,14 @@
+#pragma once
+#ifdef __cplusplus
+extern "C" {
+#endif
+#include <stddef.h>
+
+//! Runs one task, on the thread with the given index below the number of threads
+typedef void (*WorkerFunctionType)(void* arg, const unsigned int thread, const size_t task);
+
+void runWorkers(WorkerFunctionType fn, void* arg, const unsigned int nThreads, const size_t nTasks);
+
+#ifdef __cplusplus
+}
+#endif
@@ -4,6 +4,8 @@
 #include "defines.h"
 #include "timeconversions.h"
 #include "iohelpers.h"
+#include "isoerror.h"
+#include "peertable.h"
 
 #include <string.h>
 #include <errno.h>
@@ -347,19 +349,6 @@ typedef struct {
 	FooterType footer;
 } PODIType;
 
-//! PODI value IDs
-#define VALUE_ID_PODI_FOREIGN_TRANSMITTER_ID	0x00FF
-#define VALUE_ID_PODI_GPS_QMS_OF_WEEK			0x010A
-#define VALUE_ID_PODI_OBJECT_STATE				0x010C
-#define VALUE_ID_PODI_X_POSITION				0x010D
-#define VALUE_ID_PODI_Y_POSITION				0x010E
-#define VALUE_ID_PODI_Z_POSITION				0x010F
-#define VALUE_ID_PODI_HEADING					0x0110
-#define VALUE_ID_PODI_PITCH						0x0111
-#define VALUE_ID_PODI_ROLL						0x0112
-#define VALUE_ID_PODI_LONGITUDINAL_SPEED		0x0113
-#define VALUE_ID_PODI_LATERAL_SPEED				0x0114
-
 //! PODI field descriptions
 static DebugStrings_t PODIForeignTransmitterIdDescription = {"ForeignTransmitterID",	"",			&printU32};
 static DebugStrings_t PODIGpsQmsOfWeekDescription =			{"GpsQmsOfWeek",			"[¼ ms]",	&printU32};
@@ -467,7 +456,7 @@ typedef struct {
 
 
 //! GDRM field descriptions
-static DebugStrings_t GDRMDataCodeDescription = {"Data code",	"",			&printU32};
+static DebugStrings_t GDRMDataCodeDescription = {"Data code",	"",			&printU16};
 
 
 /*! DCTI message - Direct Control Transmitter Ids*/
@@ -500,8 +489,6 @@ static DebugStrings_t DCTITransmitterIdDescription = {"TransmitterID",	"",		&pri
 // ************************** static function declarations ********************************************************
 
 static char isValidMessageID(const uint16_t id);
-static double_t mapISOHeadingToHostHeading(const double_t isoHeading_rad);
-static double_t mapHostHeadingToISOHeading(const double_t hostHeading_rad);
 
 static enum ISOMessageReturnValue convertHEABToHostRepresentation(
 		HEABType* HEABData,
@@ -560,7 +547,6 @@ enum ISOMessageID getISOMessageType(const char *messageData, const size_t length
 
 	// Decode header
 	if (decodeISOHeader(messageData, length, &header, debug) != MESSAGE_OK) {
-		fprintf(stderr, "Unable to parse raw data into ISO message header\n");
 		return MESSAGE_ID_INVALID;
 	}
 
@@ -568,11 +554,20 @@ enum ISOMessageID getISOMessageType(const char *messageData, const size_t length
 	if (isValidMessageID(header.messageID))
 		return (enum ISOMessageID) header.messageID;
 	else {
-		printf("Message ID %u does not match any known ISO message\n", header.messageID);
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, (enum ISOMessageID) header.messageID, offsetof(HeaderType, messageID),
+						 "Message ID %u does not match any known ISO message", header.messageID);
 		return MESSAGE_ID_INVALID;
 	}
 }
 
+/*!
+ * \brief getEncodedSizeSTRTMessage Get the size of an encoded STRT message
+ * \return Number of bytes written by ::encodeSTRTMessage
+ */
+size_t getEncodedSizeSTRTMessage(void) {
+	return sizeof (STRTType);
+}
+
 /*!
  * \brief encodeSTRTMessage Constructs an ISO STRT message based on start time parameters
  * \param inputHeader data to create header with
@@ -586,11 +581,10 @@ ssize_t encodeSTRTMessage(const MessageHeaderType *inputHeader, const StartMessa
 						  const size_t bufferLength, const char debug) {
 	STRTType STRTData;
 
-	memset(strtDataBuffer, 0, bufferLength);
-
 	// If buffer too small to hold STRT data, generate an error
 	if (bufferLength < sizeof (STRTType)) {
-		fprintf(stderr, "Buffer too small to hold necessary STRT data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_STRT, 0,
+						 "Buffer too small to hold necessary STRT data");
 		return -1;
 	}
 
@@ -659,7 +653,8 @@ ssize_t decodeSTRTMessage(
 
 	if (startData == NULL || strtDataBuffer == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointers to STRT parsing function cannot be null\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_STRT, 0,
+						 "Input pointers to STRT parsing function cannot be null");
 		return ISO_FUNCTION_ERROR;
 	}								
 
@@ -675,12 +670,14 @@ ssize_t decodeSTRTMessage(
 
 	// If message is not a STRT message, generate an error
 	if (STRTData.header.messageID != MESSAGE_ID_STRT) {
-		fprintf(stderr, "Attempted to pass non-STRT message into STRT parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_STRT, (size_t) (p - strtDataBuffer),
+						 "Attempted to pass non-STRT message into STRT parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
 	if (STRTData.header.messageLength > sizeof (STRTType) - sizeof (HeaderType) - sizeof (FooterType)) {
-		fprintf(stderr, "STRT message exceeds expected message length\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_STRT, (size_t) (p - strtDataBuffer),
+						 "STRT message exceeds expected message length");
 		return MESSAGE_LENGTH_ERROR;
 	}
 	
@@ -690,7 +687,8 @@ ssize_t decodeSTRTMessage(
 	STRTData.StartTimeValueIdU16 = le16toh(STRTData.StartTimeValueIdU16);
 
 	if (STRTData.StartTimeValueIdU16 != VALUE_ID_STRT_GPS_QMS_OF_WEEK) {
-		fprintf(stderr, "StartTime Value Id differs from expected\n");
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_STRT, (size_t) (p - strtDataBuffer),
+						 "StartTime Value Id differs from expected");
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 
@@ -699,8 +697,9 @@ ssize_t decodeSTRTMessage(
 	STRTData.StartTimeContentLengthU16 = le16toh(STRTData.StartTimeContentLengthU16);
 
 	if (STRTData.StartTimeContentLengthU16 != sizeof(STRTData.StartTimeU32)) {
-		fprintf(stderr, "StartTime Content Length %u differs from the expected length %lu\n",
-		STRTData.StartTimeContentLengthU16, sizeof(STRTData.StartTimeU32));
+		ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_STRT, (size_t) (p - strtDataBuffer),
+						 "StartTime Content Length %u differs from the expected length %lu",
+						 STRTData.StartTimeContentLengthU16, sizeof(STRTData.StartTimeU32));
 		return MESSAGE_CONTENT_OUT_OF_RANGE;
 	}
 
@@ -713,7 +712,8 @@ ssize_t decodeSTRTMessage(
 	STRTData.GPSWeekValueID = le16toh(STRTData.GPSWeekValueID);
 
 	if (STRTData.GPSWeekValueID != VALUE_ID_STRT_GPS_WEEK) {
-		fprintf(stderr, "GPSWeek Value Id differs from expected\n");
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_STRT, (size_t) (p - strtDataBuffer),
+						 "GPSWeek Value Id differs from expected");
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 
@@ -722,8 +722,9 @@ ssize_t decodeSTRTMessage(
 	STRTData.GPSWeekContentLength = le16toh(STRTData.GPSWeekContentLength);
 
 	if (STRTData.GPSWeekContentLength != sizeof(STRTData.GPSWeek)) {
-		fprintf(stderr, "GPSWeek Content Length %u differs from the expected length %lu\n",
-		STRTData.GPSWeekContentLength, sizeof(STRTData.GPSWeek));
+		ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_STRT, (size_t) (p - strtDataBuffer),
+						 "GPSWeek Content Length %u differs from the expected length %lu",
+						 STRTData.GPSWeekContentLength, sizeof(STRTData.GPSWeek));
 		return MESSAGE_CONTENT_OUT_OF_RANGE;
 	}
 
@@ -735,14 +736,15 @@ ssize_t decodeSTRTMessage(
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - strtDataBuffer), &STRTData.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding STRT footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_STRT, (size_t) (p - strtDataBuffer),
+						 "Error decoding STRT footer");
 		return retval;
 	}
 	p += sizeof (STRTData.footer);
 
 	if ((retval = verifyChecksum(&STRTData, sizeof (STRTData) - sizeof (STRTData.footer),
 								 STRTData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-		fprintf(stderr, "STRT checksum error\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_STRT, (size_t) (p - strtDataBuffer), "STRT checksum error");
 		return retval;
 	}
 
@@ -788,7 +790,7 @@ enum ISOMessageReturnValue convertSTRTToHostRepresentation(
 
 	if (!STRTData || !startData) {
 		errno = EINVAL;
-		fprintf(stderr, "STRT input pointer error");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_STRT, 0, "STRT input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -805,7 +807,8 @@ enum ISOMessageReturnValue convertSTRTToHostRepresentation(
 	}
 	else {
 		if (currentTime && STRTData->GPSWeek != gpsWeek) {
-			fprintf(stderr, "Parsed STRT message with non-matching GPS week");
+			ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_STRT, 0,
+							 "Parsed STRT message with non-matching GPS week");
 			startData->isTimestampValid = 0;
 			return MESSAGE_OK;
 		}
@@ -814,6 +817,14 @@ enum ISOMessageReturnValue convertSTRTToHostRepresentation(
 	return MESSAGE_OK;
 }
 
+/*!
+ * \brief getEncodedSizeHEABMessage Get the size of an encoded HEAB message
+ * \return Number of bytes written by ::encodeHEABMessage
+ */
+size_t getEncodedSizeHEABMessage(void) {
+	return sizeof (HEABType);
+}
+
 /*!
  * \brief encodeHEABMessage Constructs an ISO HEAB message based on current control center status and system time
  * \param inputHeader data to create header with
@@ -830,11 +841,10 @@ ssize_t encodeHEABMessage(const MessageHeaderType *inputHeader, const struct tim
 
 	HEABType HEABData;
 
-	memset(heabDataBuffer, 0, bufferLength);
-
 	// If buffer too small to hold HEAB data, generate an error
 	if (bufferLength < sizeof (HEABType)) {
-		fprintf(stderr, "Buffer too small to hold necessary HEAB data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_HEAB, 0,
+						 "Buffer too small to hold necessary HEAB data");
 		return -1;
 	}
 
@@ -853,7 +863,8 @@ ssize_t encodeHEABMessage(const MessageHeaderType *inputHeader, const struct tim
 		(status == CONTROL_CENTER_STATUS_INIT || status == CONTROL_CENTER_STATUS_READY
 		 || status == CONTROL_CENTER_STATUS_ABORT || status == CONTROL_CENTER_STATUS_RUNNING
 		 || status == CONTROL_CENTER_STATUS_TEST_DONE || status == CONTROL_CENTER_STATUS_NORMAL_STOP)) {
-		printf("HEAB does not support status ID %u - defaulting to ABORT\n", (uint8_t) status);
+		ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_HEAB, 0,
+						 "HEAB does not support status ID %u - defaulting to ABORT", (uint8_t) status);
 		HEABData.controlCenterStatus = (uint8_t) CONTROL_CENTER_STATUS_ABORT;
 	}
 	else {
@@ -904,7 +915,8 @@ ssize_t decodeHEABMessage(const char *heabDataBuffer,
 
 	if (heabDataBuffer == NULL || heabData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointers to HEAB parsing function cannot be null\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_HEAB, 0,
+						 "Input pointers to HEAB parsing function cannot be null");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -919,13 +931,15 @@ ssize_t decodeHEABMessage(const char *heabDataBuffer,
 
 	// If message is not a HEAB message, generate an error
 	if (HEABData.header.messageID != MESSAGE_ID_HEAB) {
-		fprintf(stderr, "Attempted to pass non-HEAB message into HEAB parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_HEAB, (size_t) (p - heabDataBuffer),
+						 "Attempted to pass non-HEAB message into HEAB parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
 	
 	if (HEABData.header.messageLength > sizeof (HEABType) - sizeof (HeaderType) - sizeof (FooterType)) {
-		fprintf(stderr, "HEAB message exceeds expected message length\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_HEAB, (size_t) (p - heabDataBuffer),
+						 "HEAB message exceeds expected message length");
 		return MESSAGE_LENGTH_ERROR;
 	}
 	
@@ -939,8 +953,9 @@ ssize_t decodeHEABMessage(const char *heabDataBuffer,
 	HEABData.HEABStructContentLength = contentLength;
 
 	if (contentLength != (sizeof(HEABData.GPSQmsOfWeek) + sizeof(HEABData.controlCenterStatus))) {
-			fprintf(stderr, "Content length %u for value ID 0x%x does not match the expected %ld",
-					contentLength, valueID, sizeof(HEABData.GPSQmsOfWeek) + sizeof(HEABData.controlCenterStatus));
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_HEAB, (size_t) (p - heabDataBuffer),
+							 "Content length %u for value ID 0x%x does not match the expected %ld",
+							 contentLength, valueID, sizeof(HEABData.GPSQmsOfWeek) + sizeof(HEABData.controlCenterStatus));
 			return MESSAGE_LENGTH_ERROR;
 	}
 
@@ -954,7 +969,8 @@ ssize_t decodeHEABMessage(const char *heabDataBuffer,
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - heabDataBuffer), &HEABData.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding HEAB footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_HEAB, (size_t) (p - heabDataBuffer),
+						 "Error decoding HEAB footer");
 		return retval;
 	}
 	p += sizeof (HEABData.footer);
@@ -990,7 +1006,7 @@ enum ISOMessageReturnValue convertHEABToHostRepresentation(HEABType* HEABData,
 	
 	if (HEABData == NULL || heabData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "HEAB input pointer error");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_HEAB, 0, "HEAB input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -1026,7 +1042,8 @@ ssize_t decodeRCMMMessage(
 
 	if (rcmmDataBuffer == NULL || rcmmData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointers to RCMM parsing function cannot be null\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_RCMM, 0,
+						 "Input pointers to RCMM parsing function cannot be null");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -1042,12 +1059,14 @@ ssize_t decodeRCMMMessage(
 
 	// If message is not a RCMM message, generate an error
 	if (RCMMData.header.messageID != MESSAGE_ID_RCMM) {
-		fprintf(stderr, "Attempted to pass non-RCMM message into RCMM parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+						 "Attempted to pass non-RCMM message into RCMM parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
 	if (RCMMData.header.messageLength > sizeof (RCMMType) - sizeof (HeaderType) - sizeof (FooterType)) {
-		fprintf(stderr, "RCMM message exceeds expected message length\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+						 "RCMM message exceeds expected message length");
 		return MESSAGE_LENGTH_ERROR;
 	}
 
@@ -1100,14 +1119,16 @@ ssize_t decodeRCMMMessage(
 			expectedContentLength = sizeof (RCMMData.command);
 			break;
 		default:
-			fprintf(stderr, "Value ID 0x%x does not match any known RCMM value IDs\n", valueID);
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+							 "Value ID 0x%x does not match any known RCMM value IDs", valueID);
 			return MESSAGE_VALUE_ID_ERROR;
 		}
 
 		p += contentLength;
 		if (contentLength != expectedContentLength) {
-			fprintf(stderr, "Content length %u for value ID 0x%x does not match the expected %ld\n",
-					contentLength, valueID, expectedContentLength);
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+							 "Content length %u for value ID 0x%x does not match the expected %ld",
+							 contentLength, valueID, expectedContentLength);
 			return MESSAGE_LENGTH_ERROR;
 		}
 	}
@@ -1116,14 +1137,15 @@ ssize_t decodeRCMMMessage(
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - rcmmDataBuffer), &RCMMData.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding RCMM footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+						 "Error decoding RCMM footer");
 		return retval;
 	}
 
 	p += sizeof (RCMMData.footer);
 	if ((retval = verifyChecksum(rcmmDataBuffer, RCMMData.header.messageLength + sizeof (HeaderType),
 								 RCMMData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-		fprintf(stderr, "RCMM checksum error\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer), "RCMM checksum error");
 		return retval;
 	}
 
@@ -1161,7 +1183,7 @@ enum ISOMessageReturnValue convertRCMMToHostRepresentation(RCMMType * RCMMData,
 	
 	if (RCMMData == NULL ||  rcmmData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "RCMM input pointer error\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_RCMM, 0, "RCMM input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -1176,7 +1198,8 @@ enum ISOMessageReturnValue convertRCMMToHostRepresentation(RCMMType * RCMMData,
 				rcmmData->steeringUnit = ISO_UNIT_TYPE_STEERING_DEGREES; 
 			}
 			else {
-				fprintf(stderr, "Steering angle value is out of bounds\n");
+				ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_RCMM, 0,
+								 "Steering angle value is out of bounds");
 				return MESSAGE_CONTENT_OUT_OF_RANGE;
 			}
 		}
@@ -1188,12 +1211,13 @@ enum ISOMessageReturnValue convertRCMMToHostRepresentation(RCMMType * RCMMData,
 				rcmmData->steeringUnit = ISO_UNIT_TYPE_STEERING_PERCENTAGE;
 			}
 			else {
-				fprintf(stderr, "Steering percentage value is out of bounds\n");
+				ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_RCMM, 0,
+								 "Steering percentage value is out of bounds");
 				return MESSAGE_CONTENT_OUT_OF_RANGE;
 			}
 		}
 		else {
-			fprintf(stderr, "Steering Value ID error\n");
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_RCMM, 0, "Steering Value ID error");
 			return MESSAGE_VALUE_ID_ERROR;
 		}
 	}
@@ -1213,13 +1237,15 @@ enum ISOMessageReturnValue convertRCMMToHostRepresentation(RCMMType * RCMMData,
 				rcmmData->speedUnit = ISO_UNIT_TYPE_SPEED_PERCENTAGE;
 			}
 			else {
-				fprintf(stderr, "Speed percentage value is out of bounds\n");
+				ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_RCMM, 0,
+								 "Speed percentage value is out of bounds");
 				return MESSAGE_CONTENT_OUT_OF_RANGE;
 			}
 			
 		}
 		else {
-			fprintf(stderr, "Receiver ID not supplied in RDCA message\n");
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_RCMM, 0,
+							 "Receiver ID not supplied in RDCA message");
 			return MESSAGE_VALUE_ID_ERROR;
 		}
 	}
@@ -1227,6 +1253,37 @@ enum ISOMessageReturnValue convertRCMMToHostRepresentation(RCMMType * RCMMData,
 
 }
 
+/*!
+ * \brief getEncodedSizeRCMMMessage Get the size of an encoded RCMM message, which excludes
+ *		manoeuvres that are not valid and the command if there is none
+ * \param rcmmData Struct containing relevant RCMM data
+ * \return Number of bytes written by ::encodeRCMMMessage
+ */
+size_t getEncodedSizeRCMMMessage(const RemoteControlManoeuvreMessageType* rcmmData) {
+	RCMMType RCMMData;
+	size_t unusedMemory = 0;
+	if (rcmmData->command == MANOEUVRE_NONE) {
+		unusedMemory += sizeof (RCMMData.commandValueID)
+				+ sizeof (RCMMData.commandContentLength)
+				+ sizeof (RCMMData.command);
+	}
+	if (!rcmmData->isSteeringManoeuvreValid
+			|| (rcmmData->steeringUnit != ISO_UNIT_TYPE_STEERING_DEGREES
+				&& rcmmData->steeringUnit != ISO_UNIT_TYPE_STEERING_PERCENTAGE)) {
+		unusedMemory += sizeof (RCMMData.steeringValueID)
+				+ sizeof (RCMMData.steeringContentLength)
+				+ sizeof (RCMMData.steering);
+	}
+	if (!rcmmData->isSpeedManoeuvreValid
+			|| (rcmmData->speedUnit != ISO_UNIT_TYPE_SPEED_METER_SECOND
+				&& rcmmData->speedUnit != ISO_UNIT_TYPE_SPEED_PERCENTAGE)) {
+		unusedMemory += sizeof (RCMMData.speedValueID)
+				+ sizeof (RCMMData.speedContentLength)
+				+ sizeof (RCMMData.speed);
+	}
+	return sizeof (RCMMData) - unusedMemory;
+}
+
 /*!
  * \brief encodeRCMMMessage Fills an ISO RCMM struct with relevant data fields,
  *		and corresponding value IDs and content lengths
@@ -1244,23 +1301,25 @@ ssize_t encodeRCMMMessage(const MessageHeaderType *inputHeader, const RemoteCont
 
 	RCMMType RCMMData;
 
-	memset(rcmmDataBuffer, 0, bufferLength);
 	char* p = rcmmDataBuffer;
 	size_t remainingBytes = bufferLength;
 	int retval = 0;
 
-	if (rcmmDataBuffer == NULL) {
-		fprintf(stderr, "RCMM data input pointer error\n");
+	if (rcmmDataBuffer == NULL || rcmmData == NULL) {
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_RCMM, 0, "RCMM data input pointer error");
 		return -1;
 	}
 
+	const size_t messageSize = getEncodedSizeRCMMMessage(rcmmData);
+
 	// If buffer too small to hold RCMM data, generate an error
-	if (bufferLength < sizeof (RCMMType)) {
-		fprintf(stderr, "Buffer too small to hold necessary RCMM data\n");
+	if (bufferLength < messageSize) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+						 "Buffer too small to hold necessary RCMM data");
 		return -1;
 	}
 	// Construct header
-	RCMMData.header = buildISOHeader(MESSAGE_ID_RCMM, inputHeader, sizeof (RCMMData), debug);
+	RCMMData.header = buildISOHeader(MESSAGE_ID_RCMM, inputHeader, (uint32_t) messageSize, debug);
 	memcpy(p, &RCMMData.header, sizeof (RCMMData.header));
 	p += sizeof (RCMMData.header);
 	remainingBytes -= sizeof (RCMMData.header);
@@ -1284,7 +1343,8 @@ ssize_t encodeRCMMMessage(const MessageHeaderType *inputHeader, const RemoteCont
 							  sizeof (RCMMData.steering), &remainingBytes, &RCMMSteeringDescriptionDeg, debug);
 		}
 		else {
-			fprintf(stderr, "Steering value is out of bounds for angle value\n");
+			ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+							 "Steering value is out of bounds for angle value");
 			return MESSAGE_CONTENT_OUT_OF_RANGE;
 		}
 	}
@@ -1295,7 +1355,8 @@ ssize_t encodeRCMMMessage(const MessageHeaderType *inputHeader, const RemoteCont
 						 	  sizeof(RCMMData.steering), &remainingBytes, &RCMMSteeringDescriptionPct, debug);		
 		}
 		else {
-			fprintf(stderr, "Steering value is out of bounds for percentage\n");
+			ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+							 "Steering value is out of bounds for percentage");
 			return MESSAGE_CONTENT_OUT_OF_RANGE;
 		}
 	}
@@ -1312,7 +1373,8 @@ ssize_t encodeRCMMMessage(const MessageHeaderType *inputHeader, const RemoteCont
 			sizeof(RCMMData.speed), &remainingBytes, &RCMMSpeedDescriptionPct, debug);
 		}
 		else {
-			fprintf(stderr, "Speed value is out of bounds for percentage\n");
+			ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+							 "Speed value is out of bounds for percentage");
 			return MESSAGE_CONTENT_OUT_OF_RANGE;
 		}
 	}
@@ -1324,12 +1386,14 @@ ssize_t encodeRCMMMessage(const MessageHeaderType *inputHeader, const RemoteCont
 			sizeof(RCMMData.throttle), &remainingBytes, &RCMMThrottleDescriptionPct, debug);
 		}
 		else {
-			fprintf(stderr, "Throttle value is out of bounds for percentage\n");
+			ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+							 "Throttle value is out of bounds for percentage");
 			return MESSAGE_CONTENT_OUT_OF_RANGE;
 		}
 	}
 	else {
-		fprintf(stderr, "Throttle unit is not valid\n");
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+						 "Throttle unit is not valid");
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 
@@ -1340,22 +1404,25 @@ ssize_t encodeRCMMMessage(const MessageHeaderType *inputHeader, const RemoteCont
 			sizeof(RCMMData.brake), &remainingBytes, &RCMMBrakeDescriptionPct, debug);
 		}
 		else {
-			fprintf(stderr, "Brake value is out of bounds for percentage\n");
+			ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+							 "Brake value is out of bounds for percentage");
 			return MESSAGE_CONTENT_OUT_OF_RANGE;
 		}
 	}
 	else {
-		fprintf(stderr, "Brake unit is not valid\n");
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+						 "Brake unit is not valid");
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 	
 	if (retval != 0 || remainingBytes < sizeof (FooterType)) {
-		fprintf(stderr, "Buffer too small to hold necessary RCMM data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_RCMM, (size_t) (p - rcmmDataBuffer),
+						 "Buffer too small to hold necessary RCMM data");
 		return -1;
 	}
 	
 	// Construct footer
-	RCMMData.footer = buildISOFooter(&RCMMData, (size_t) (p-rcmmDataBuffer)+ sizeof(RCMMData.footer), debug);
+	RCMMData.footer = buildISOFooter(rcmmDataBuffer, (size_t) (p-rcmmDataBuffer)+ sizeof(RCMMData.footer), debug);
 	
 	memcpy(p, &RCMMData.footer, sizeof (RCMMData.footer));
 	p += sizeof (RCMMData.footer);
@@ -1363,14 +1430,22 @@ ssize_t encodeRCMMMessage(const MessageHeaderType *inputHeader, const RemoteCont
 
 	if(debug)
 	{
-		printf("RCMM message data (size = %zu):\n", sizeof (RCMMType));
-		for(size_t i = 0; i < sizeof (RCMMType); i++) printf("%x ", *(rcmmDataBuffer+i));
+		printf("RCMM message data (size = %zu):\n", messageSize);
+		for(size_t i = 0; i < messageSize; i++) printf("%x ", *(rcmmDataBuffer+i));
 		printf("\n");
 	}
 
 	return p - rcmmDataBuffer;
 }
 
+/*!
+ * \brief getEncodedSizeSYPMMessage Get the size of an encoded SYPM message
+ * \return Number of bytes written by ::encodeSYPMMessage
+ */
+size_t getEncodedSizeSYPMMessage(void) {
+	return sizeof (SYPMType);
+}
+
 /*!
  * \brief encodeSYPMMessage Fills an ISO SYPM struct with relevant data fields, and corresponding value IDs and content lengths
  * \param inputHeader data to create header with
@@ -1388,7 +1463,8 @@ ssize_t encodeSYPMMessage(const MessageHeaderType *inputHeader, const struct tim
 
 	// If buffer too small to hold SYPM data, generate an error
 	if (bufferLength < sizeof (SYPMType)) {
-		fprintf(stderr, "Buffer too small to hold necessary SYPM data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_SYPM, 0,
+						 "Buffer too small to hold necessary SYPM data");
 		return -1;
 	}
 
@@ -1432,6 +1508,14 @@ ssize_t encodeSYPMMessage(const MessageHeaderType *inputHeader, const struct tim
 	return sizeof (SYPMType);
 }
 
+/*!
+ * \brief getEncodedSizeMTSPMessage Get the size of an encoded MTSP message
+ * \return Number of bytes written by ::encodeMTSPMessage
+ */
+size_t getEncodedSizeMTSPMessage(void) {
+	return sizeof (MTSPType);
+}
+
 /*!
  * \brief encodeMTSPMessage Fills an ISO MTSP struct with relevant data fields, and corresponding value IDs and content lengths
  * \param inputHeader data to create header with
@@ -1445,11 +1529,10 @@ ssize_t encodeMTSPMessage(const MessageHeaderType *inputHeader, const struct tim
 						  const size_t bufferLength, const char debug) {
 	MTSPType MTSPData;
 
-	memset(mtspDataBuffer, 0, bufferLength);
-
 	// If buffer too small to hold MTSP data, generate an error
 	if (bufferLength < sizeof (MTSPType)) {
-		fprintf(stderr, "Buffer too small to hold necessary MTSP data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_MTSP, 0,
+						 "Buffer too small to hold necessary MTSP data");
 		return -1;
 	}
 
@@ -1486,6 +1569,14 @@ ssize_t encodeMTSPMessage(const MessageHeaderType *inputHeader, const struct tim
 	return sizeof (MTSPType);
 }
 
+/*!
+ * \brief getEncodedSizeTRCMMessage Get the size of an encoded TRCM message
+ * \return Number of bytes written by ::encodeTRCMMessage
+ */
+size_t getEncodedSizeTRCMMessage(void) {
+	return sizeof (TRCMType);
+}
+
 /*!
  * \brief encodeTRCMMessage Fills an ISO TRCM struct with relevant data fields, and corresponding value IDs and content lengths
  * \param inputHeader data to create header with
@@ -1505,11 +1596,10 @@ ssize_t encodeTRCMMessage(const MessageHeaderType *inputHeader, const uint16_t *
 						  const size_t bufferLength, const char debug) {
 	TRCMType TRCMData;
 
-	memset(trcmDataBuffer, 0, bufferLength);
-
 	// If buffer too small to hold TRCM data, generate an error
 	if (bufferLength < sizeof (TRCMType)) {
-		fprintf(stderr, "Buffer too small to hold necessary TRCM data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRCM, 0,
+						 "Buffer too small to hold necessary TRCM data");
 		return -1;
 	}
 
@@ -1586,6 +1676,14 @@ ssize_t encodeTRCMMessage(const MessageHeaderType *inputHeader, const uint16_t *
 }
 
 
+/*!
+ * \brief getEncodedSizeACCMMessage Get the size of an encoded ACCM message
+ * \return Number of bytes written by ::encodeACCMMessage
+ */
+size_t getEncodedSizeACCMMessage(void) {
+	return sizeof (ACCMType);
+}
+
 /*!
  * \brief encodeACCMMessage Fills an ISO ACCM struct with relevant data fields, and corresponding value IDs and content lengths
  * \param inputHeader data to create header with
@@ -1606,11 +1704,10 @@ ssize_t encodeACCMMessage(const MessageHeaderType *inputHeader, const uint16_t *
 
 	ACCMType ACCMData;
 
-	memset(accmDataBuffer, 0, bufferLength);
-
 	// If buffer too small to hold ACCM data, generate an error
 	if (bufferLength < sizeof (ACCMType)) {
-		fprintf(stderr, "Buffer too small to hold necessary ACCM data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_ACCM, 0,
+						 "Buffer too small to hold necessary ACCM data");
 		return -1;
 	}
 
@@ -1682,6 +1779,14 @@ ssize_t encodeACCMMessage(const MessageHeaderType *inputHeader, const uint16_t *
 	return sizeof (ACCMData);
 }
 
+/*!
+ * \brief getEncodedSizeEXACMessage Get the size of an encoded EXAC message
+ * \return Number of bytes written by ::encodeEXACMessage
+ */
+size_t getEncodedSizeEXACMessage(void) {
+	return sizeof (EXACType);
+}
+
 /*!
  * \brief encodeEXACMessage Fills an ISO EXAC struct with relevant data fields, and corresponding value IDs and content lengths
  * \param inputHeader data to create header with
@@ -1697,11 +1802,10 @@ ssize_t encodeEXACMessage(const MessageHeaderType *inputHeader, const uint16_t *
 
 	EXACType EXACData;
 
-	memset(exacDataBuffer, 0, bufferLength);
-
 	// If buffer too small to hold EXAC data, generate an error
 	if (bufferLength < sizeof (EXACType)) {
-		fprintf(stderr, "Buffer too small to hold necessary EXAC data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_EXAC, 0,
+						 "Buffer too small to hold necessary EXAC data");
 		return -1;
 	}
 
@@ -1745,6 +1849,14 @@ ssize_t encodeEXACMessage(const MessageHeaderType *inputHeader, const uint16_t *
 	return sizeof (EXACType);
 }
 
+/*!
+ * \brief getEncodedSizeINSUPMessage Get the size of an encoded INSUP message
+ * \return Number of bytes written by ::encodeINSUPMessage
+ */
+size_t getEncodedSizeINSUPMessage(void) {
+	return sizeof (INSUPType);
+}
+
 /*!
  * \brief encodeINSUPMessage Fills an ISO vendor specific (RISE) INSUP struct with relevant data fields,
  *		and corresponding value IDs and content lengths
@@ -1759,11 +1871,10 @@ ssize_t encodeINSUPMessage(const MessageHeaderType *inputHeader, const enum Supe
 						   const size_t bufferLength, const char debug) {
 	INSUPType INSUPData;
 
-	memset(insupDataBuffer, 0, bufferLength);
-
 	// If buffer too small to hold EXAC data, generate an error
 	if (bufferLength < sizeof (INSUPType)) {
-		fprintf(stderr, "Buffer too small to hold necessary INSUP data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_RISE_INSUP, 0,
+						 "Buffer too small to hold necessary INSUP data");
 		return -1;
 	}
 
@@ -1793,6 +1904,14 @@ ssize_t encodeINSUPMessage(const MessageHeaderType *inputHeader, const enum Supe
 	return sizeof (INSUPData);
 }
 
+/*!
+ * \brief getEncodedSizePODIMessage Get the size of an encoded PODI message
+ * \return Number of bytes written by ::encodePODIMessage
+ */
+size_t getEncodedSizePODIMessage(void) {
+	return sizeof (PODIType);
+}
+
 /*!
  * \brief encodePODIMessage Fills an ISO vendor specific (AstaZero) PODI struct with relevant data fields,
  *		and corresponding value IDs and content lengths
@@ -1810,19 +1929,20 @@ ssize_t encodePODIMessage(const MessageHeaderType *inputHeader, const PeerObject
 
 	PODIType PODIData;
 
-	memset(podiDataBuffer, 0, bufferLength);
 	char* p = podiDataBuffer;
 	size_t remainingBytes = bufferLength;
 	int retval = 0;
 
 	if (peerObjectData == NULL) {
-		fprintf(stderr, "PODI data input pointer error\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, 0,
+						 "PODI data input pointer error");
 		return -1;
 	}
 
 	// If buffer too small to hold PODI data, generate an error
 	if (bufferLength < sizeof (PODIType)) {
-		fprintf(stderr, "Buffer too small to hold necessary PODI data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, (size_t) (p - podiDataBuffer),
+						 "Buffer too small to hold necessary PODI data");
 		return -1;
 	}
 
@@ -1847,7 +1967,8 @@ ssize_t encodePODIMessage(const MessageHeaderType *inputHeader, const PeerObject
 						  sizeof (PODIData.objectState), &remainingBytes, &PODIObjectStateDescription, debug);
 	if (!peerObjectData->position.isPositionValid) {
 		errno = EINVAL;
-		fprintf(stderr, "Position is a required field in PODI messages\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, (size_t) (p - podiDataBuffer),
+						 "Position is a required field in PODI messages");
 		return -1;
 	}
 	PODIData.xPosition = (int32_t) (peerObjectData->position.xCoord_m * POSITION_ONE_METER_VALUE);
@@ -1887,7 +2008,8 @@ ssize_t encodePODIMessage(const MessageHeaderType *inputHeader, const PeerObject
 						  sizeof (PODIData.lateralSpeed), &remainingBytes, &PODILongitudinalSpeedDescription, debug);
 
 	if (retval != 0 || remainingBytes < sizeof (FooterType)) {
-		fprintf(stderr, "Buffer too small to hold necessary PODI data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, (size_t) (p - podiDataBuffer),
+						 "Buffer too small to hold necessary PODI data");
 		return -1;
 	}
 
@@ -1896,7 +2018,7 @@ ssize_t encodePODIMessage(const MessageHeaderType *inputHeader, const PeerObject
 	}
 
 	// Construct footer
-	PODIData.footer = buildISOFooter(&PODIData, sizeof (PODIData), debug);
+	PODIData.footer = buildISOFooter(podiDataBuffer, (size_t) (p - podiDataBuffer) + sizeof (FooterType), debug);
 	memcpy(p, &PODIData.footer, sizeof (PODIData.footer));
 	p += sizeof (PODIData.footer);
 	remainingBytes -= sizeof (PODIData.footer);
@@ -1936,7 +2058,8 @@ ssize_t decodePODIMessage(
 
 	if (podiDataBuffer == NULL || peerData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointers to PODI parsing function cannot be null\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, 0,
+						 "Input pointers to PODI parsing function cannot be null");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -1951,12 +2074,14 @@ ssize_t decodePODIMessage(
 
 	// If message is not a PODI message, generate an error
 	if (PODIData.header.messageID != MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI) {
-		fprintf(stderr, "Attempted to pass non-PODI message into PODI parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, (size_t) (p - podiDataBuffer),
+						 "Attempted to pass non-PODI message into PODI parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
 	if (PODIData.header.messageLength > sizeof (PODIType) - sizeof (HeaderType) - sizeof (FooterType)) {
-		fprintf(stderr, "PODI message exceeds expected message length\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, (size_t) (p - podiDataBuffer),
+						 "PODI message exceeds expected message length");
 		return MESSAGE_LENGTH_ERROR;
 	}
 
@@ -2045,14 +2170,16 @@ ssize_t decodePODIMessage(
 			expectedContentLength = sizeof (PODIData.longitudinalSpeed);
 			break;
 		default:
-			fprintf(stderr, "Value ID 0x%x does not match any known PODI value IDs", valueID);
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, (size_t) (p - podiDataBuffer),
+							 "Value ID 0x%x does not match any known PODI value IDs", valueID);
 			return MESSAGE_VALUE_ID_ERROR;
 		}
 
 		p += contentLength;
 		if (contentLength != expectedContentLength) {
-			fprintf(stderr, "Content length %u for value ID 0x%x does not match the expected %ld",
-					contentLength, valueID, expectedContentLength);
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, (size_t) (p - podiDataBuffer),
+							 "Content length %u for value ID 0x%x does not match the expected %ld",
+							 contentLength, valueID, expectedContentLength);
 			return MESSAGE_LENGTH_ERROR;
 		}
 	}
@@ -2061,14 +2188,16 @@ ssize_t decodePODIMessage(
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - podiDataBuffer), &PODIData.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding PODI footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, (size_t) (p - podiDataBuffer),
+						 "Error decoding PODI footer");
 		return retval;
 	}
 	p += sizeof (PODIData.footer);
 
 	/*if ((retval = verifyChecksum(podiDataBuffer, PODIData.header.messageLength + sizeof (HeaderType),
 								 PODIData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-		fprintf(stderr, "PODI checksum error\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, (size_t) (p - podiDataBuffer),
+						 "PODI checksum error");
 		return retval;
 	}*/
 
@@ -2127,12 +2256,14 @@ enum ISOMessageReturnValue convertPODIToHostRepresentation(PODIType* PODIData,
 
 	if (PODIData == NULL || currentTime == NULL || peerData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "PODI input pointer error");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, 0,
+						 "PODI input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
 	if (!PODIData->foreignTransmitterIDValueID) {
-		fprintf(stderr, "Foreign transmitter ID not supplied in PODI message\n");
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, 0,
+						 "Foreign transmitter ID not supplied in PODI message");
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 
@@ -2140,7 +2271,8 @@ enum ISOMessageReturnValue convertPODIToHostRepresentation(PODIType* PODIData,
 
 	if (!PODIData->gpsQmsOfWeekValueID
 			|| PODIData->gpsQmsOfWeek == GPS_SECOND_OF_WEEK_UNAVAILABLE_VALUE) {
-		fprintf(stderr, "Timestamp not supplied in PODI message\n");
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, 0,
+						 "Timestamp not supplied in PODI message");
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 
@@ -2152,7 +2284,8 @@ enum ISOMessageReturnValue convertPODIToHostRepresentation(PODIType* PODIData,
 	if (!PODIData->xPositionValueID
 			|| !PODIData->yPositionValueID
 			|| !PODIData->zPositionValueID) {
-		fprintf(stderr, "Position not supplied in PODI message\n");
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, 0,
+						 "Position not supplied in PODI message");
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 
@@ -2162,7 +2295,8 @@ enum ISOMessageReturnValue convertPODIToHostRepresentation(PODIType* PODIData,
 	peerData->position.zCoord_m = PODIData->zPosition / POSITION_ONE_METER_VALUE;
 
 	if (!PODIData->headingValueID) {
-		fprintf(stderr, "Heading not supplied in PODI message\n");
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, 0,
+						 "Heading not supplied in PODI message");
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 
@@ -2214,7 +2348,8 @@ ssize_t decodeOPROMessage(
 
 	if (objectPropertiesData == NULL || oproDataBuffer == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointer error\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_OPRO, 0,
+						 "Input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -2231,7 +2366,8 @@ ssize_t decodeOPROMessage(
 
 	// If message is not a OPRO message, generate an error
 	if (OPROData.header.messageID != MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_OPRO) {
-		fprintf(stderr, "Attempted to pass non-OPRO message into OPRO parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_OPRO, (size_t) (p - oproDataBuffer),
+						 "Attempted to pass non-OPRO message into OPRO parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
@@ -2320,7 +2456,8 @@ ssize_t decodeOPROMessage(
 			break;
 
 		default:
-			printf("Unable to handle OPRO value ID 0x%x\n", valueID);
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_OPRO, (size_t) (p - oproDataBuffer),
+							 "Unable to handle OPRO value ID 0x%x", valueID);
 			break;
 		}
 		p += contentLength;
@@ -2331,14 +2468,16 @@ ssize_t decodeOPROMessage(
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - oproDataBuffer), &OPROData.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding OPRO footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_OPRO, (size_t) (p - oproDataBuffer),
+						 "Error decoding OPRO footer");
 		return retval;
 	}
 	p += sizeof (OPROData.footer);
 
 	if ((retval = verifyChecksum(oproDataBuffer, OPROData.header.messageLength + sizeof (OPROData.header),
 								 OPROData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-		fprintf(stderr, "OPRO checksum error\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_OPRO, (size_t) (p - oproDataBuffer),
+						 "OPRO checksum error");
 		return retval;
 	}
 
@@ -2381,6 +2520,14 @@ ssize_t decodeOPROMessage(
 	return retval < 0 ? retval : p - oproDataBuffer;
 }
 
+/*!
+ * \brief getEncodedSizeOPROMessage Get the size of an encoded OPRO message
+ * \return Number of bytes written by ::encodeOPROMessage
+ */
+size_t getEncodedSizeOPROMessage(void) {
+	return sizeof (OPROType);
+}
+
 /*!
  * \brief encodeOPROMessage Fills an ISO vendor specific (AstaZero) OPRO struct with relevant data fields,
  *		and corresponding value IDs and content lengths
@@ -2399,19 +2546,20 @@ ssize_t encodeOPROMessage(
 		const char debug) {
 	OPROType OPROData;
 
-	memset(oproDataBuffer, 0, bufferLength);
 	char* p = oproDataBuffer;
 	size_t remainingBytes = bufferLength;
 	int retval = 0;
 
 	if (objectPropertiesData == NULL) {
-		fprintf(stderr, "OPRO data input pointer error\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_OPRO, 0,
+						 "OPRO data input pointer error");
 		return -1;
 	}
 
 	// If buffer too small to hold OPRO data, generate an error
 	if (bufferLength < sizeof (OPROType)) {
-		fprintf(stderr, "Buffer too small to hold necessary OPRO data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_OPRO, (size_t) (p - oproDataBuffer),
+						 "Buffer too small to hold necessary OPRO data");
 		return -1;
 	}
 
@@ -2464,7 +2612,8 @@ ssize_t encodeOPROMessage(
 
 	
 	if (retval != 0 || remainingBytes < sizeof (FooterType)) {
-		fprintf(stderr, "Buffer too small to hold necessary OPRO data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_OPRO, (size_t) (p - oproDataBuffer),
+						 "Buffer too small to hold necessary OPRO data");
 		return -1;
 	}
 	
@@ -2482,6 +2631,14 @@ ssize_t encodeOPROMessage(
 	return p - oproDataBuffer;
 }
 
+/*!
+ * \brief getEncodedSizeFOPRMessage Get the size of an encoded FOPR message
+ * \return Number of bytes written by ::encodeFOPRMessage
+ */
+size_t getEncodedSizeFOPRMessage(void) {
+	return sizeof (FOPRType);
+}
+
 /*!
  * \brief encodeFOPRMessage Fills an ISO vendor specific (AstaZero) FOPR struct with relevant data fields,
  *		and corresponding value IDs and content lengths
@@ -2500,19 +2657,20 @@ ssize_t encodeFOPRMessage(
 		const char debug) {
 	FOPRType FOPRData;
 
-	memset(foprDataBuffer, 0, bufferLength);
 	char* p = foprDataBuffer;
 	size_t remainingBytes = bufferLength;
 	int retval = 0;
 
 	if (foreignObjectPropertiesData == NULL) {
-		fprintf(stderr, "FOPR data input pointer error\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_FOPR, 0,
+						 "FOPR data input pointer error");
 		return -1;
 	}
 
 	// If buffer too small to hold FOPR data, generate an error
 	if (bufferLength < sizeof (FOPRType)) {
-		fprintf(stderr, "Buffer too small to hold necessary FOPR data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_FOPR, (size_t) (p - foprDataBuffer),
+						 "Buffer too small to hold necessary FOPR data");
 		return -1;
 	}
 
@@ -2568,7 +2726,8 @@ ssize_t encodeFOPRMessage(
 
 	
 	if (retval != 0 || remainingBytes < sizeof (FooterType)) {
-		fprintf(stderr, "Buffer too small to hold necessary OPRO data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_FOPR, (size_t) (p - foprDataBuffer),
+						 "Buffer too small to hold necessary OPRO data");
 		return -1;
 	}
 	
@@ -2598,7 +2757,8 @@ enum ISOMessageReturnValue convertOPROToHostRepresentation(const OPROType* OPROD
 
 	if (OPROData == NULL || objectProperties == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "OPRO input pointer error");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_OPRO, 0,
+						 "OPRO input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -2646,7 +2806,8 @@ enum ISOMessageReturnValue convertFOPRToHostRepresentation(const FOPRType* FOPRD
 
 	if (FOPRData == NULL || foreignObjectProperties == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "FOPR input pointer error");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_FOPR, 0,
+						 "FOPR input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 	
@@ -2709,7 +2870,8 @@ ssize_t decodeFOPRMessage(
 
 	if (foreignObjectPropertiesData == NULL || foprDataBuffer == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointer error\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_FOPR, 0,
+						 "Input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -2725,7 +2887,8 @@ ssize_t decodeFOPRMessage(
 
 	// If message is not a FOPR message, generate an error
 	if (FOPRData.header.messageID != MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_FOPR) {
-		fprintf(stderr, "Attempted to pass non-FOPR message into FOPR parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_FOPR, (size_t) (p - foprDataBuffer),
+						 "Attempted to pass non-FOPR message into FOPR parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
@@ -2820,7 +2983,8 @@ ssize_t decodeFOPRMessage(
 			break;
 
 		default:
-			printf("Unable to handle FOPR value ID 0x%x\n", valueID);
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_FOPR, (size_t) (p - foprDataBuffer),
+							 "Unable to handle FOPR value ID 0x%x", valueID);
 			break;
 		}
 		p += contentLength;
@@ -2831,13 +2995,15 @@ ssize_t decodeFOPRMessage(
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - foprDataBuffer), &FOPRData.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding FOPR footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_FOPR, (size_t) (p - foprDataBuffer),
+						 "Error decoding FOPR footer");
 		return retval;
 	}
 
 	if ((retval = verifyChecksum(foprDataBuffer, FOPRData.header.messageLength + sizeof (FOPRData.header),
 								 FOPRData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-		fprintf(stderr, "FOPR checksum error\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_FOPR, (size_t) (p - foprDataBuffer),
+						 "FOPR checksum error");
 		return retval;
 	}
 
@@ -2881,6 +3047,14 @@ ssize_t decodeFOPRMessage(
 	return retval < 0 ? retval : p - foprDataBuffer;
 }
 
+/*!
+ * \brief getEncodedSizeGDRMMessage Get the size of an encoded GDRM message
+ * \return Number of bytes written by ::encodeGDRMMessage
+ */
+size_t getEncodedSizeGDRMMessage(void) {
+	return sizeof (GDRMType);
+}
+
 /*!
  * \brief encodeGDRMMessage Constructs an ISO GDRM message (General Data Request Message)
  * \param inputHeader data to create header with
@@ -2895,19 +3069,20 @@ ssize_t encodeGDRMMessage(const MessageHeaderType *inputHeader, const GdrmMessag
 
 	 GDRMType GDRMData;
 
-	 memset(gdrmDataBuffer, 0, bufferLength);
 	 char* p = gdrmDataBuffer;
 	 size_t remainingBytes = bufferLength;
 	 int retval = 0;
 
 	 if (gdrmData == NULL) {
-		 fprintf(stderr, "GDRM data input pointer error\n");
+		 ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_GDRM, 0,
+		 				 "GDRM data input pointer error");
 		 return -1;
 	 }
 
 	 // If buffer too small to hold GDRM data, generate an error
 	 if (bufferLength < sizeof (GDRMType)) {
-		 fprintf(stderr, "Buffer too small to hold necessary GDRM data\n");
+		 ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_GDRM, (size_t) (p - gdrmDataBuffer),
+		 				 "Buffer too small to hold necessary GDRM data");
 		 return -1;
 	 }
 
@@ -2921,12 +3096,14 @@ ssize_t encodeGDRMMessage(const MessageHeaderType *inputHeader, const GdrmMessag
 			 printf("GDRM message:\n");
 	 }
 	 // Fill contents
-	 retval |= encodeContent(VALUE_ID_GDRM_DATA_CODE, &gdrmData->dataCode, &p,
-						   sizeof (gdrmData->dataCode), &remainingBytes, &GDRMDataCodeDescription, debug);
+	 GDRMData.DataCode = (uint16_t) gdrmData->dataCode;
+	 retval |= encodeContent(VALUE_ID_GDRM_DATA_CODE, &GDRMData.DataCode, &p,
+						   sizeof (GDRMData.DataCode), &remainingBytes, &GDRMDataCodeDescription, debug);
 
 
 	 if (retval != 0 || remainingBytes < sizeof (FooterType)) {
-		 fprintf(stderr, "Buffer too small to hold necessary GDRM data\n");
+		 ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_GDRM, (size_t) (p - gdrmDataBuffer),
+		 				 "Buffer too small to hold necessary GDRM data");
 		 return -1;
 	 }
 
@@ -2935,7 +3112,7 @@ ssize_t encodeGDRMMessage(const MessageHeaderType *inputHeader, const GdrmMessag
 	 }
 
 	 // Construct footer
-	 GDRMData.footer = buildISOFooter(&GDRMData, sizeof (GDRMData), debug);
+	 GDRMData.footer = buildISOFooter(gdrmDataBuffer, (size_t) (p - gdrmDataBuffer) + sizeof (FooterType), debug);
 	 memcpy(p, &GDRMData.footer, sizeof (GDRMData.footer));
 	 p += sizeof (GDRMData.footer);
 	 remainingBytes -= sizeof (GDRMData.footer);
@@ -2973,7 +3150,8 @@ ssize_t encodeGDRMMessage(const MessageHeaderType *inputHeader, const GdrmMessag
 
 	 if (gdrmDataBuffer == NULL || gdrmData == NULL) {
 		 errno = EINVAL;
-		 fprintf(stderr, "Input pointers to GDRM parsing function cannot be null\n");
+		 ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_GDRM, 0,
+		 				 "Input pointers to GDRM parsing function cannot be null");
 		 return ISO_FUNCTION_ERROR;
 	 }
 
@@ -2988,13 +3166,15 @@ ssize_t encodeGDRMMessage(const MessageHeaderType *inputHeader, const GdrmMessag
 
 	 // If message is not a GDRM message, generate an error
 	 if (GDRMData.header.messageID != MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_GDRM) {
-		 fprintf(stderr, "Attempted to pass non-GDRM message into GDRM parsing function\n");
+		 ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_GDRM, (size_t) (p - gdrmDataBuffer),
+		 				 "Attempted to pass non-GDRM message into GDRM parsing function");
 		 return MESSAGE_TYPE_ERROR;
 	 }
 
 
 	 if (GDRMData.header.messageLength > sizeof (GDRMType) - sizeof (HeaderType) - sizeof (FooterType)) {
-		 fprintf(stderr, "GDRM message exceeds expected message length\n");
+		 ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_GDRM, (size_t) (p - gdrmDataBuffer),
+		 				 "GDRM message exceeds expected message length");
 		 return MESSAGE_LENGTH_ERROR;
 	 }
 
@@ -3004,7 +3184,8 @@ ssize_t encodeGDRMMessage(const MessageHeaderType *inputHeader, const GdrmMessag
 	 if ((retval =
 		  decodeISOFooter(p, bufferLength - (size_t) (p - gdrmDataBuffer), &GDRMData.footer,
 						  debug)) != MESSAGE_OK) {
-		 fprintf(stderr, "Error decoding GDRM footer\n");
+		 ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_GDRM, (size_t) (p - gdrmDataBuffer),
+		 				 "Error decoding GDRM footer");
 		 return retval;
 	 }
 
@@ -3033,7 +3214,8 @@ ssize_t encodeGDRMMessage(const MessageHeaderType *inputHeader, const GdrmMessag
 
 	 if (GDRMData == NULL || gdrmData == NULL) {
 		 errno = EINVAL;
-		 fprintf(stderr, "GDRM input pointer error");
+		 ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_GDRM, 0,
+		 				 "GDRM input pointer error");
 		 return ISO_FUNCTION_ERROR;
 	 }
 
@@ -3045,6 +3227,14 @@ ssize_t encodeGDRMMessage(const MessageHeaderType *inputHeader, const GdrmMessag
 
 
 
+/*!
+ * \brief getEncodedSizeDCTIMessage Get the size of an encoded DCTI message
+ * \return Number of bytes written by ::encodeDCTIMessage
+ */
+size_t getEncodedSizeDCTIMessage(void) {
+	return sizeof (DCTIType);
+}
+
 /*!
  * \brief encodeDCTIMessage Constructs an ISO DCTI message (Direct Control Transmitter Id)
  * \param inputHeader data to create header with
@@ -3060,19 +3250,20 @@ ssize_t encodeDCTIMessage(const MessageHeaderType *inputHeader, const DctiMessag
 
 	DCTIType DCTIData;
 
-	memset(dctiDataBuffer, 0, bufferLength);
 	char* p = dctiDataBuffer;
 	size_t remainingBytes = bufferLength;
 	int retval = 0;
 
 	if (dctiData == NULL) {
-		fprintf(stderr, "DCTI data input pointer error\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI, 0,
+						 "DCTI data input pointer error");
 		return -1;
 	}
 
 	// If buffer too small to hold DCTI data, generate an error
 	if (bufferLength < sizeof (DCTIType)) {
-		fprintf(stderr, "Buffer too small to hold necessary DCTI data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI, (size_t) (p - dctiDataBuffer),
+						 "Buffer too small to hold necessary DCTI data");
 		return -1;
 	}
 
@@ -3095,7 +3286,8 @@ ssize_t encodeDCTIMessage(const MessageHeaderType *inputHeader, const DctiMessag
 
 
 	if (retval != 0 || remainingBytes < sizeof (FooterType)) {
-		fprintf(stderr, "Buffer too small to hold necessary DCTI data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI, (size_t) (p - dctiDataBuffer),
+						 "Buffer too small to hold necessary DCTI data");
 		return -1;
 	}
 
@@ -3104,7 +3296,7 @@ ssize_t encodeDCTIMessage(const MessageHeaderType *inputHeader, const DctiMessag
 	}
 
 	// Construct footer
-	DCTIData.footer = buildISOFooter(&DCTIData, sizeof (DCTIData), debug);
+	DCTIData.footer = buildISOFooter(dctiDataBuffer, (size_t) (p - dctiDataBuffer) + sizeof (FooterType), debug);
 	memcpy(p, &DCTIData.footer, sizeof (DCTIData.footer));
 	p += sizeof (DCTIData.footer);
 	remainingBytes -= sizeof (DCTIData.footer);
@@ -3143,7 +3335,8 @@ enum ISOMessageReturnValue decodeDCTIMessage(
 
 	if (dctiDataBuffer == NULL || dctiData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointers to DCTI parsing function cannot be null\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI, 0,
+						 "Input pointers to DCTI parsing function cannot be null");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -3157,12 +3350,14 @@ enum ISOMessageReturnValue decodeDCTIMessage(
 
 	// If message is not a PODI message, generate an error
 	if (DCTIData.header.messageID != MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI) {
-		fprintf(stderr, "Attempted to pass non-DCTI message into DCTI parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI, (size_t) (p - dctiDataBuffer),
+						 "Attempted to pass non-DCTI message into DCTI parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
 	if (DCTIData.header.messageLength > sizeof (DCTIType) - sizeof (HeaderType) - sizeof (FooterType)) {
-		fprintf(stderr, "PODI message exceeds expected message length\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI, (size_t) (p - dctiDataBuffer),
+						 "PODI message exceeds expected message length");
 		return MESSAGE_LENGTH_ERROR;
 	}
 
@@ -3194,14 +3389,16 @@ enum ISOMessageReturnValue decodeDCTIMessage(
 			expectedContentLength = sizeof (DCTIData.TransmitterID);
 			break;
 		default:
-			fprintf(stderr, "Value ID 0x%x does not match any known DCTI value IDs", valueID);
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI, (size_t) (p - dctiDataBuffer),
+							 "Value ID 0x%x does not match any known DCTI value IDs", valueID);
 			return MESSAGE_VALUE_ID_ERROR;
 		}
 
 		p += contentLength;
 		if (contentLength != expectedContentLength) {
-			fprintf(stderr, "Content length %u for value ID 0x%x does not match the expected %ld",
-					contentLength, valueID, expectedContentLength);
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI, (size_t) (p - dctiDataBuffer),
+							 "Content length %u for value ID 0x%x does not match the expected %ld",
+							 contentLength, valueID, expectedContentLength);
 			return MESSAGE_LENGTH_ERROR;
 		}
 	}
@@ -3210,14 +3407,16 @@ enum ISOMessageReturnValue decodeDCTIMessage(
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - dctiDataBuffer), &DCTIData.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding DCTI footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI, (size_t) (p - dctiDataBuffer),
+						 "Error decoding DCTI footer");
 		return retval;
 	}
 	p += sizeof (DCTIData.footer);
 
 	/*if ((retval = verifyChecksum(dctiDataBuffer, DCTIData.header.messageLength + sizeof (HeaderType),
 								 DCTIData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-		fprintf(stderr, "DCTI checksum error\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI, (size_t) (p - dctiDataBuffer),
+						 "DCTI checksum error");
 		return retval;
 	}*/
 
@@ -3251,7 +3450,8 @@ enum ISOMessageReturnValue convertDCTIToHostRepresentation(DCTIType* DCTIData,
 
 	if (DCTIData == NULL || dctiData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "DCTI input pointer error");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI, 0,
+						 "DCTI input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -3263,6 +3463,28 @@ enum ISOMessageReturnValue convertDCTIToHostRepresentation(DCTIType* DCTIData,
 	return MESSAGE_OK;
 }
 
+/*!
+ * \brief getEncodedSizeRDCAMessage Get the size of an encoded RDCA message, which excludes
+ *		actions that are not valid
+ * \param rdcaData Struct containing relevant RDCA data
+ * \return Number of bytes written by ::encodeRDCAMessage
+ */
+size_t getEncodedSizeRDCAMessage(const RequestControlActionType *rdcaData) {
+	RDCAType RDCAData;
+	size_t unusedMemory = 0;
+	if (!rdcaData->isSteeringActionValid) {
+		unusedMemory += sizeof (RDCAData.steeringActionValueID)
+				+ sizeof (RDCAData.steeringActionContentLength)
+				+ sizeof (RDCAData.steeringAction);
+	}
+	if (!rdcaData->isSpeedActionValid) {
+		unusedMemory += sizeof (RDCAData.speedActionValueID)
+				+ sizeof (RDCAData.speedActionContentLength)
+				+ sizeof (RDCAData.speedAction);
+	}
+	return sizeof (RDCAData) - unusedMemory;
+}
+
 /*!
  * \brief encodeRDCAMessage Constructs an ISO RDCA message (Request Direct Control Action)
  * \param inputHeader data to create header with
@@ -3279,36 +3501,27 @@ ssize_t encodeRDCAMessage(const MessageHeaderType *inputHeader,
 						  const char debug) {
 	RDCAType RDCAData;
 
-	memset(rdcaDataBuffer, 0, bufferLength);
 	char* p = rdcaDataBuffer;
 	size_t remainingBytes = bufferLength;
 	int retval = 0;
 
 	if (rdcaData == NULL || rdcaDataBuffer == NULL) {
-		fprintf(stderr, "RDCA data input pointer error\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, 0,
+						 "RDCA data input pointer error");
 		return -1;
 	}
 
+	const size_t messageSize = getEncodedSizeRDCAMessage(rdcaData);
+
 	// If buffer too small to hold RDCA data, generate an error
-	if (bufferLength < sizeof (RDCAType)) {
-		fprintf(stderr, "Buffer too small to hold necessary RDCA data\n");
+	if (bufferLength < messageSize) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, (size_t) (p - rdcaDataBuffer),
+						 "Buffer too small to hold necessary RDCA data");
 		return -1;
 	}
-	
-	
-	size_t unusedMemory = 0;
-	if (!rdcaData->isSteeringActionValid) {
-		unusedMemory += sizeof (RDCAData.steeringActionValueID)
-				+ sizeof (RDCAData.steeringActionContentLength)
-				+ sizeof (RDCAData.steeringAction);
-	}
-	if (!rdcaData->isSpeedActionValid) {
-			unusedMemory += sizeof (RDCAData.speedActionValueID)
-				+ sizeof (RDCAData.speedActionContentLength)	
-				+ sizeof (RDCAData.speedAction);
-	}
+
 	// Construct header
-	RDCAData.header = buildISOHeader(MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, inputHeader, sizeof (RDCAData) - unusedMemory, debug);
+	RDCAData.header = buildISOHeader(MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, inputHeader, messageSize, debug);
 	memcpy(p, &RDCAData.header, sizeof (RDCAData.header));
 	p += sizeof (RDCAData.header);
 	remainingBytes -= sizeof (RDCAData.header);
@@ -3335,7 +3548,8 @@ ssize_t encodeRDCAMessage(const MessageHeaderType *inputHeader,
 
 		}
 		else {
-			fprintf(stderr, "Steering value is out of bounds for angle value\n");
+			ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, (size_t) (p - rdcaDataBuffer),
+							 "Steering value is out of bounds for angle value");
 			return MESSAGE_CONTENT_OUT_OF_RANGE;
 		}
 	}
@@ -3346,7 +3560,8 @@ ssize_t encodeRDCAMessage(const MessageHeaderType *inputHeader,
 								sizeof(RDCAData.steeringAction), &remainingBytes, &RDCASteeringDescriptionPct, debug);	
 		}
 		else {
-			fprintf(stderr, "Steering value is out of bounds for percentage\n");
+			ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, (size_t) (p - rdcaDataBuffer),
+							 "Steering value is out of bounds for percentage");
 			return MESSAGE_CONTENT_OUT_OF_RANGE;
 		}
 	}
@@ -3366,18 +3581,20 @@ ssize_t encodeRDCAMessage(const MessageHeaderType *inputHeader,
 								sizeof(RDCAData.speedAction), &remainingBytes, &RDCASpeedDescriptionPct, debug);
 		}
 		else {
-			fprintf(stderr, "Speed value is out of bounds for percentage\n");
+			ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, (size_t) (p - rdcaDataBuffer),
+							 "Speed value is out of bounds for percentage");
 			return MESSAGE_CONTENT_OUT_OF_RANGE;
 		}
 	}
 	
 	if (retval != 0 || remainingBytes < sizeof (FooterType)) {
-		fprintf(stderr, "Buffer too small to hold necessary RDCA data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, (size_t) (p - rdcaDataBuffer),
+						 "Buffer too small to hold necessary RDCA data");
 		return -1;
 	}
 
 	// Construct footer
-	RDCAData.footer = buildISOFooter(&RDCAData, (size_t) (p-rdcaDataBuffer) + sizeof(RDCAData.footer), debug);
+	RDCAData.footer = buildISOFooter(rdcaDataBuffer, (size_t) (p-rdcaDataBuffer) + sizeof(RDCAData.footer), debug);
 	memcpy(p, &RDCAData.footer, sizeof (RDCAData.footer));
 	p += sizeof (RDCAData.footer);
 	remainingBytes -= sizeof (RDCAData.footer);
@@ -3416,7 +3633,8 @@ ssize_t decodeRDCAMessage(
 
 	if (rdcaDataBuffer == NULL || rdcaData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointers to RDCA parsing function cannot be null\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, 0,
+						 "Input pointers to RDCA parsing function cannot be null");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -3431,12 +3649,14 @@ ssize_t decodeRDCAMessage(
 
 	// If message is not a RDCA message, generate an error
 	if (RDCAData.header.messageID != MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA) {
-		fprintf(stderr, "Attempted to pass non-RDCA message into RDA parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, (size_t) (p - rdcaDataBuffer),
+						 "Attempted to pass non-RDCA message into RDA parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
 	if (RDCAData.header.messageLength > sizeof (RDCAType) - sizeof (HeaderType) - sizeof (FooterType)) {
-		fprintf(stderr, "RDCA message exceeds expected message length\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, (size_t) (p - rdcaDataBuffer),
+						 "RDCA message exceeds expected message length");
 		return MESSAGE_LENGTH_ERROR;
 	}
 
@@ -3492,14 +3712,16 @@ ssize_t decodeRDCAMessage(
 			expectedContentLength = sizeof (RDCAData.speedAction);
 			break;
 		default:
-			fprintf(stderr, "Value ID 0x%x does not match any known RDCA value IDs", valueID);
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, (size_t) (p - rdcaDataBuffer),
+							 "Value ID 0x%x does not match any known RDCA value IDs", valueID);
 			return MESSAGE_VALUE_ID_ERROR;
 		}
 
 		p += contentLength;
 		if (contentLength != expectedContentLength) {
-			fprintf(stderr, "Content length %u for value ID 0x%x does not match the expected %ld",
-					contentLength, valueID, expectedContentLength);
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, (size_t) (p - rdcaDataBuffer),
+							 "Content length %u for value ID 0x%x does not match the expected %ld",
+							 contentLength, valueID, expectedContentLength);
 			return MESSAGE_LENGTH_ERROR;
 		}
 	}
@@ -3508,14 +3730,16 @@ ssize_t decodeRDCAMessage(
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - rdcaDataBuffer), &RDCAData.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding RDCA footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, (size_t) (p - rdcaDataBuffer),
+						 "Error decoding RDCA footer");
 		return retval;
 	}
 	p += sizeof (RDCAData.footer);
 
 	/*if ((retval = verifyChecksum(rdcaDataBuffer, RDCAData.header.messageLength + sizeof (HeaderType),
 								 RDCAData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-		fprintf(stderr, "RDCA checksum error\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, (size_t) (p - rdcaDataBuffer),
+						 "RDCA checksum error");
 		return retval;
 	}*/
 
@@ -3556,17 +3780,20 @@ enum ISOMessageReturnValue convertRDCAToHostRepresentation(RDCAType* RDCAData,
 
 	if (RDCAData == NULL ||  rdcaData == NULL || currentTime == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "RDCA input pointer error\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, 0,
+						 "RDCA input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
 	if (!RDCAData->gpsQmsOfWeekValueID
 			|| RDCAData->gpsQmsOfWeek == GPS_SECOND_OF_WEEK_UNAVAILABLE_VALUE) {
-		fprintf(stderr, "Timestamp not supplied in RDCA message\n");
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, 0,
+						 "Timestamp not supplied in RDCA message");
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 	if (!RDCAData->gpsQmsOfWeekValueID) {
-		fprintf(stderr, "Receiver ID not supplied in RDCA message\n");
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, 0,
+						 "Receiver ID not supplied in RDCA message");
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 	
@@ -3583,7 +3810,8 @@ enum ISOMessageReturnValue convertRDCAToHostRepresentation(RDCAType* RDCAData,
 				rdcaData->steeringUnit = ISO_UNIT_TYPE_STEERING_DEGREES; 
 			}
 			else {
-				fprintf(stderr, "Steering angle value is out of bounds\n");
+				ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, 0,
+								 "Steering angle value is out of bounds");
 				return MESSAGE_CONTENT_OUT_OF_RANGE;
 			}
 		}
@@ -3595,12 +3823,14 @@ enum ISOMessageReturnValue convertRDCAToHostRepresentation(RDCAType* RDCAData,
 				rdcaData->steeringUnit = ISO_UNIT_TYPE_STEERING_PERCENTAGE;
 			}
 			else {
-				fprintf(stderr, "Steering percentage value is out of bounds\n");
+				ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, 0,
+								 "Steering percentage value is out of bounds");
 				return MESSAGE_CONTENT_OUT_OF_RANGE;
 			}
 		}
 		else {
-			fprintf(stderr, "Steering Value ID error\n");
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, 0,
+							 "Steering Value ID error");
 			return MESSAGE_VALUE_ID_ERROR;
 		}
 	}
@@ -3620,13 +3850,15 @@ enum ISOMessageReturnValue convertRDCAToHostRepresentation(RDCAType* RDCAData,
 				rdcaData->speedUnit = ISO_UNIT_TYPE_SPEED_PERCENTAGE;
 			}
 			else {
-				fprintf(stderr, "Speed percentage value is out of bounds");
+				ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, 0,
+								 "Speed percentage value is out of bounds");
 				return MESSAGE_CONTENT_OUT_OF_RANGE;
 			}
 			
 		}
 		else {
-			fprintf(stderr, "Receiver ID not supplied in RDCA message\n");
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA, 0,
+							 "Receiver ID not supplied in RDCA message");
 			return MESSAGE_VALUE_ID_ERROR;
 		}
 	}
@@ -3684,6 +3916,16 @@ double_t mapHostHeadingToISOHeading(const double_t hostHeading_rad) {
 }
 
 
+/*!
+ * \brief getEncodedSizeDCMMMessage Get the size of an encoded DCMM message, which has the same
+ *		contents as an RCMM message
+ * \param command Struct containing relevant DCMM data
+ * \return Number of bytes written by ::encodeDCMMMessage
+ */
+size_t getEncodedSizeDCMMMessage(const RemoteControlManoeuvreMessageType* command) {
+	return getEncodedSizeRCMMMessage(command);
+}
+
 /*!
  * \brief encodeDCMMessage Fills an ISO vendor specific (AstaZero) DCMM struct with relevant data fields,
  *		and corresponding value IDs and content lengths
@@ -3702,15 +3944,13 @@ ssize_t encodeDCMMMessage(const MessageHeaderType *inputHeader,
 
 	HeaderType DCMMHeader;
 	FooterType DCMMFooter;
-	RCMMType DCMMData;
-
-	DCMMHeader = buildISOHeader(MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM, inputHeader, sizeof (DCMMData), debug);
 
 	ssize_t retval =  encodeRCMMMessage(inputHeader, command, dcmmDataBuffer, bufferLength, debug);
 	if (retval < 0) {
-		fprintf(stderr, "DCMM wrapper error\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM, 0, "DCMM wrapper error");
 		return retval;
 	}
+	DCMMHeader = buildISOHeader(MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM, inputHeader, (uint32_t) retval, debug);
 	memcpy(dcmmDataBuffer, &DCMMHeader, sizeof(DCMMHeader) );
 
 	DCMMFooter = buildISOFooter(dcmmDataBuffer, retval, debug);
@@ -3743,7 +3983,8 @@ ssize_t decodeDCMMMessage(
 	
 	if (dcmmDataBuffer == NULL || dcmmData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointers to DCMM parsing function cannot be null\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM, 0,
+						 "Input pointers to DCMM parsing function cannot be null");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -3759,12 +4000,14 @@ ssize_t decodeDCMMMessage(
 
 	// If message is not a RCMM message, generate an error
 	if (DCMMData.header.messageID != MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM) {
-		fprintf(stderr, "Attempted to pass non-DCMM message into DCMM parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM, (size_t) (p - dcmmDataBuffer),
+						 "Attempted to pass non-DCMM message into DCMM parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
 	if (DCMMData.header.messageLength > sizeof (RCMMType) - sizeof (HeaderType) - sizeof (FooterType)) {
-		fprintf(stderr, "DCMM message exceeds expected message length\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM, (size_t) (p - dcmmDataBuffer),
+						 "DCMM message exceeds expected message length");
 		return MESSAGE_LENGTH_ERROR;
 	}
 
@@ -3817,14 +4060,16 @@ ssize_t decodeDCMMMessage(
 			expectedContentLength = sizeof (DCMMData.command);
 			break;
 		default:
-			fprintf(stderr, "Value ID 0x%x does not match any known DCMM value IDs\n", valueID);
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM, (size_t) (p - dcmmDataBuffer),
+							 "Value ID 0x%x does not match any known DCMM value IDs", valueID);
 			return MESSAGE_VALUE_ID_ERROR;
 		}
 
 		p += contentLength;
 		if (contentLength != expectedContentLength) {
-			fprintf(stderr, "Content length %u for value ID 0x%x does not match the expected %ld\n",
-					contentLength, valueID, expectedContentLength);
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM, (size_t) (p - dcmmDataBuffer),
+							 "Content length %u for value ID 0x%x does not match the expected %ld",
+							 contentLength, valueID, expectedContentLength);
 			return MESSAGE_LENGTH_ERROR;
 		}
 	}
@@ -3833,14 +4078,16 @@ ssize_t decodeDCMMMessage(
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - dcmmDataBuffer), &DCMMData.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding DCMM footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM, (size_t) (p - dcmmDataBuffer),
+						 "Error decoding DCMM footer");
 		return retval;
 	}
 
 	p += sizeof (DCMMData.footer);
 	if ((retval = verifyChecksum(dcmmDataBuffer, DCMMData.header.messageLength + sizeof (HeaderType),
 								 DCMMData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-		fprintf(stderr, "DCMM checksum error\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM, (size_t) (p - dcmmDataBuffer),
+						 "DCMM checksum error");
 		return retval;
 	}
 
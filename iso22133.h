@@ -99,6 +99,21 @@ typedef struct {
 	float_t curvature;
 } TrajectoryWaypointType;
 
+/*! Trajectory held as one array per field, e.g. for bulk processing. Optional columns may be NULL. */
+typedef struct {
+	size_t nPoints;
+	const int64_t* time_us;					//!< Time from start of trajectory, nondecreasing
+	const double* x_m;
+	const double* y_m;
+	const double* z_m;
+	const double* heading_rad;
+	const double* longitudinalSpeed_m_s;
+	const double* lateralSpeed_m_s;
+	const double* longitudinalAcceleration_m_s2;
+	const double* lateralAcceleration_m_s2;
+	const float* curvature;
+} TrajectoryColumnsType;
+
 /*! OSTM commands */
 enum ObjectCommandType {
 	OBJECT_COMMAND_ARM = 0x02,				//!< Request to arm the target object
@@ -277,7 +292,9 @@ enum ISOMessageID {
 	MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI = 0xA121,
 	MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_GDRM = 0xA120,
 	MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA = 0xA122,
-	MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM = 0xA124
+	MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM = 0xA124,
+	MESSAGE_ID_VENDOR_SPECIFIC_CTRJ = 0xA130,
+	MESSAGE_ID_VENDOR_SPECIFIC_CTRA = 0xA131
 };
 
 /*! Supervisor command */
@@ -512,8 +529,14 @@ ssize_t decodeMONRMessage(const char * monrDataBuffer, const size_t bufferLength
 ssize_t encodeTRAJMessageHeader(const MessageHeaderType *inputHeader, const uint16_t trajectoryID, const TrajectoryInfoType trajectoryInfo, const char* trajectoryName, const size_t nameLength,	const uint32_t numberOfPointsInTraj, char *trajDataBuffer, const size_t bufferLength, const char debug);
 ssize_t encodeTRAJMessagePoint(const struct timeval * pointTimeFromStart, const CartesianPosition position, const SpeedType speed, const AccelerationType acceleration, const float curvature, char * trajDataBufferPointer, const size_t remainingBufferLength, const char debug);
 ssize_t decodeTRAJMessagePoint(TrajectoryWaypointType* wayPoints, const char* trajDataBuffer, const char debug);
+ssize_t decodeTRAJMessagePointBounded(TrajectoryWaypointType* wayPoints, const char* trajDataBuffer,
+									  const size_t bufferLength, const char debug);
 ssize_t encodeTRAJMessageFooter(char * trajDataBuffer, const size_t bufferLength, const char debug);
 ssize_t decodeTRAJMessageHeader(TrajectoryHeaderType* trajHeader, const char* trajDataBuffer, const size_t bufferLength, const char debug);
+ssize_t encodeTRAJMessageColumns(const MessageHeaderType* inputHeader, const uint16_t trajectoryID,
+								 const TrajectoryInfoType trajectoryInfo, const char* trajectoryName,
+								 const size_t nameLength, const TrajectoryColumnsType* columns,
+								 char* trajDataBuffer, const size_t bufferLength, const char debug);
 ssize_t encodeSTRTMessage(const MessageHeaderType *inputHeader, const StartMessageType* startData, char * strtDataBuffer, const size_t bufferLength, const char debug);
 ssize_t decodeSTRTMessage(const char *strtDataBuffer, const size_t bufferLength, const struct timeval* currentTime, StartMessageType * startData, const char debug) ;
 ssize_t encodeOSEMMessage(const MessageHeaderType *inputHeader, const ObjectSettingsType* objectSettingsData, char * osemDataBuffer, const size_t bufferLength, const char debug);
@@ -540,6 +563,27 @@ ssize_t encodeDCTIMessage(const MessageHeaderType *inputHeader, const DctiMessag
 enum ISOMessageReturnValue decodeDCTIMessage(const char *dctiDataBuffer, const size_t bufferLength, DctiMessageDataType* dctiData, const char debug);
 enum ISOMessageID getISOMessageType(const char * messageData, const size_t length, const char debug);
 void setISOCRCVerification(const int8_t enabled);
+double_t mapISOHeadingToHostHeading(const double_t isoHeading_rad);
+double_t mapHostHeadingToISOHeading(const double_t hostHeading_rad);
+
+/* Number of bytes written by the encoders */
+size_t getEncodedSizeMONRMessage(void);
+size_t getEncodedSizeTRAJMessage(const uint32_t numberOfPointsInTraj);
+size_t getEncodedSizeSTRTMessage(void);
+size_t getEncodedSizeOSEMMessage(const ObjectSettingsType* objectSettings);
+size_t getEncodedSizeOSTMMessage(void);
+size_t getEncodedSizeHEABMessage(void);
+size_t getEncodedSizeSYPMMessage(void);
+size_t getEncodedSizeMTSPMessage(void);
+size_t getEncodedSizeTRCMMessage(void);
+size_t getEncodedSizeACCMMessage(void);
+size_t getEncodedSizeEXACMessage(void);
+size_t getEncodedSizeRCMMMessage(const RemoteControlManoeuvreMessageType* rcmmData);
+size_t getEncodedSizeGREMMessage(void);
+size_t getEncodedSizeDRESMessage(void);
+size_t getEncodedSizeDREQMessage(void);
+size_t getEncodedSizeINSUPMessage(void);
+size_t getEncodedSizeDCTIMessage(void);
 
 /* AstaZero vendor specific messages - TODO move to a separate repository */
 ssize_t encodePODIMessage(const MessageHeaderType *inputHeader, const PeerObjectInjectionType* peerObjectData, char* podiDataBuffer, const size_t bufferLength, const char debug);
@@ -554,6 +598,12 @@ ssize_t encodeGDRMMessage(const MessageHeaderType *inputHeader, const GdrmMessag
 enum ISOMessageReturnValue decodeGDRMMessage(const char *gdrmDataBuffer, const size_t bufferLength, GdrmMessageDataType* gdrmData, const char debug);
 ssize_t encodeDCMMMessage(const MessageHeaderType *inputHeader, const RemoteControlManoeuvreMessageType* command, char* dcmmDataBuffer, const size_t bufferLength, const char debug);
 ssize_t decodeDCMMMessage(const char * dcmmDataBuffer, const size_t bufferLenght, RemoteControlManoeuvreMessageType* dcmmData, const char debug);
+size_t getEncodedSizePODIMessage(void);
+size_t getEncodedSizeOPROMessage(void);
+size_t getEncodedSizeFOPRMessage(void);
+size_t getEncodedSizeRDCAMessage(const RequestControlActionType* rdcaData);
+size_t getEncodedSizeGDRMMessage(void);
+size_t getEncodedSizeDCMMMessage(const RemoteControlManoeuvreMessageType* command);
 #ifdef __cplusplus
 }
 #endif
@@ -12,6 +12,7 @@
 #include "header.h"
 #include "iohelpers.h"
 #include "monr.h"
+#include "monr2.h"
 #include "osem.h"
 #include "ostm.h"
 #include "timeconversions.h"
@@ -38,6 +39,7 @@ typedef long int ssize_t;
 %include "header.h"
 %include "iohelpers.h"
 %include "monr.h"
+%include "monr2.h"
 %include "osem.h"
 %include "ostm.h"
 %include "timeconversions.h"
@@ -0,0 +1,1607 @@
+#include "captureingest.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+
+#include "header.h"
+#include "footer.h"
+#include "monr.h"
+#include "defines.h"
+#include "workerpool.h"
+
+#define PCAP_MAGIC_MICROSECONDS 0xA1B2C3D4U
+#define PCAP_MAGIC_NANOSECONDS 0xA1B23C4DU
+#define PCAP_MAGIC_MICROSECONDS_SWAPPED 0xD4C3B2A1U
+#define PCAP_MAGIC_NANOSECONDS_SWAPPED 0x4D3CB2A1U
+#define PCAP_FILE_HEADER_LENGTH 24
+#define PCAP_RECORD_HEADER_LENGTH 16
+
+#define PCAPNG_SECTION_HEADER_BLOCK 0x0A0D0D0AU
+#define PCAPNG_INTERFACE_DESCRIPTION_BLOCK 0x00000001U
+#define PCAPNG_SIMPLE_PACKET_BLOCK 0x00000003U
+#define PCAPNG_ENHANCED_PACKET_BLOCK 0x00000006U
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1A2B3C4DU
+#define PCAPNG_OPTION_END 0
+#define PCAPNG_OPTION_TIMESTAMP_RESOLUTION 9
+#define PCAPNG_MAX_INTERFACES 256
+
+#define LINKTYPE_NULL 0
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_RAW 101
+#define LINKTYPE_LOOP 108
+#define LINKTYPE_LINUX_SLL 113
+#define LINKTYPE_IPV4 228
+#define LINKTYPE_IPV6 229
+#define LINKTYPE_LINUX_SLL2 276
+
+#define ETHERTYPE_IPV4 0x0800
+#define ETHERTYPE_IPV6 0x86DD
+#define ETHERTYPE_VLAN 0x8100
+#define ETHERTYPE_QINQ 0x88A8
+
+#define IP_PROTOCOL_TCP 6
+#define IP_PROTOCOL_UDP 17
+#define TCP_FLAG_FIN 0x01
+#define TCP_FLAG_SYN 0x02
+#define TCP_FLAG_RST 0x04
+
+#define ISO_FRAME_OVERHEAD (sizeof (HeaderType) + sizeof (FooterType))
+#define ISO_MAX_MESSAGE_LENGTH (16U * 1024U * 1024U)
+#define ISO_SYNC_WORD_FIRST_BYTE ((uint8_t) (ISO_SYNC_WORD & 0xFF))
+#define ISO_SYNC_WORD_SECOND_BYTE ((uint8_t) (ISO_SYNC_WORD >> 8))
+#define HEADER_TRANSMITTER_ID_OFFSET 7
+#define HEADER_MESSAGE_ID_OFFSET 16
+
+#define MIN_PACKETS_PER_CHUNK 1024
+#define CHUNKS_PER_THREAD 8
+#define ARENA_BLOCK_SIZE (1024 * 1024)
+#define NANOSECONDS_PER_SECOND 1000000000LL
+
+typedef enum {
+	TRANSPORT_NONE,
+	TRANSPORT_UDP,
+	TRANSPORT_TCP
+} TransportType;
+
+typedef struct {
+	uint8_t source[16];
+	uint8_t destination[16];
+	uint16_t sourcePort;
+	uint16_t destinationPort;
+	uint32_t ipVersion;
+} FlowKeyType;
+
+typedef struct {
+	FlowKeyType flow;
+	const uint8_t* payload;
+	uint32_t length;
+	uint32_t sequence;
+	uint8_t tcpFlags;
+	size_t packetIndex;
+} SegmentType;
+
+typedef enum {
+	FRAME_FOUND,
+	FRAME_INCOMPLETE,
+	FRAME_NOT_FOUND
+} FrameSearchResultType;
+
+/*! An ISO message reassembled from a TCP stream */
+typedef struct {
+	const uint8_t* data;
+	size_t length;
+	int64_t time_ns;
+	uint64_t order;
+} StreamFrameType;
+
+typedef struct {
+	FlowKeyType key;
+	bool isActive;
+	bool isSequenceKnown;
+	uint32_t nextSequence;
+	uint8_t* buffer;
+	size_t bufferLength;
+	size_t bufferCapacity;
+} FlowStateType;
+
+typedef struct ArenaBlock {
+	struct ArenaBlock* next;
+	size_t used;
+	size_t capacity;
+	uint8_t data[];
+} ArenaBlockType;
+
+typedef struct {
+	int64_t time_ns;
+	uint64_t order;
+	uint8_t state;
+} TimelineEntryType;
+
+typedef struct {
+	CaptureObjectStatisticsType statistics;
+	size_t lastChunk;
+	TimelineEntryType* timeline;
+	size_t nTimelineEntries;
+	size_t timelineCapacity;
+} ObjectContextType;
+
+/*! State of one decoding thread, merged after all threads have finished */
+typedef struct {
+	CaptureStatisticsType statistics;
+	ObjectContextType* objects;
+	size_t nObjects;
+	size_t objectCapacity;
+	size_t* objectIndex;			//!< Open addressing table of object positions + 1
+	size_t objectIndexCapacity;
+	int error;
+} ThreadContextType;
+
+typedef struct {
+	SegmentType* segments;
+	size_t nSegments;
+	size_t capacity;
+} SegmentListType;
+
+typedef struct {
+	const CaptureType* capture;
+	const CaptureAnalysisOptionsType* options;
+	ThreadContextType* threads;
+	SegmentListType* chunkSegments;
+	size_t nChunks;
+	size_t chunkSize;
+	const StreamFrameType* streamFrames;
+	size_t nStreamFrames;
+} AnalysisType;
+
+typedef struct {
+	FlowStateType* flows;
+	size_t capacity;
+	size_t nFlows;
+	ArenaBlockType* arena;
+	StreamFrameType* frames;
+	size_t nFrames;
+	size_t frameCapacity;
+	CaptureStatisticsType statistics;
+	int error;
+} ReassemblyType;
+
+struct CaptureFrameIterator {
+	const CaptureType* capture;
+	size_t nextPacket;
+	SegmentType datagram;			//!< UDP payload currently being split into messages
+	size_t datagramOffset;
+	int64_t datagramTime_ns;
+	ReassemblyType reassembly;
+	size_t nextStreamFrame;
+};
+
+static int indexPcap(CaptureType* capture);
+static int indexPcapng(CaptureType* capture);
+static int appendPacket(CaptureType* capture, size_t* capacity, const CapturePacketType* packet);
+static int64_t pcapngTimeToNanoseconds(const uint64_t timestamp, const uint8_t resolution);
+
+static TransportType parsePacket(const CapturePacketType* packet, SegmentType* segment);
+static FrameSearchResultType findFrame(const uint8_t* data, const size_t length, size_t* frameOffset,
+									   size_t* frameLength);
+
+static void analyzePacketChunk(void* arg, const unsigned int thread, const size_t chunk);
+static void analyzeStreamFrameChunk(void* arg, const unsigned int thread, const size_t chunk);
+static void analyzeFrame(const AnalysisType* analysis, ThreadContextType* thread, const uint8_t* frame,
+						 const size_t length, const int64_t time_ns, const uint64_t order, const size_t chunk);
+static ObjectContextType* getObjectContext(ThreadContextType* thread, const uint32_t transmitterID);
+static int appendSegment(SegmentListType* list, const SegmentType* segment);
+
+static void reassembleSegment(ReassemblyType* reassembly, const SegmentType* segment, const int64_t time_ns);
+static FlowStateType* getFlowState(ReassemblyType* reassembly, const FlowKeyType* key);
+static void extractStreamFrames(ReassemblyType* reassembly, FlowStateType* flow, const uint8_t* data,
+								const size_t length, const bool isBuffered, const int64_t time_ns,
+								const size_t packetIndex);
+static void appendStreamFrame(ReassemblyType* reassembly, const uint8_t* data, const size_t length,
+							  const bool isCopied, const int64_t time_ns, const uint64_t order);
+static void releaseStreamFrames(ReassemblyType* reassembly);
+static void freeReassembly(ReassemblyType* reassembly);
+
+static int mergeThreadContexts(ThreadContextType* threads, const size_t nThreads,
+							   const CaptureStatisticsType* reassemblyStatistics, CaptureStatisticsType* result);
+static void freeThreadContext(ThreadContextType* thread);
+static int compareObjectContexts(const void* a, const void* b);
+static int compareTimelineEntries(const void* a, const void* b);
+static void addCounters(CaptureStatisticsType* sum, const CaptureStatisticsType* term);
+
+static uint16_t readUint16(const uint8_t* p, const bool isBigEndian);
+static uint32_t readUint32(const uint8_t* p, const bool isBigEndian);
+static uint16_t readBigEndian16(const uint8_t* p);
+static uint32_t readBigEndian32(const uint8_t* p);
+static size_t hashBytes(const void* data, const size_t length);
+
+
+/*!
+ * \brief openCapture Maps a pcap or pcapng file into memory and indexes its packets. Packet data is not
+ *			copied, and remains valid until the capture is closed.
+ * \param path Path of the capture file
+ * \param capture Capture to be filled
+ * \return 0 on success, -1 with errno set otherwise
+ */
+int openCapture(
+		const char* path,
+		CaptureType* capture) {
+
+	struct stat fileStatus;
+	void* data;
+	int fd, error, result;
+
+	if (path == NULL || capture == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	memset(capture, 0, sizeof (*capture));
+
+	if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0) {
+		return -1;
+	}
+	if (fstat(fd, &fileStatus) < 0) {
+		error = errno;
+		close(fd);
+		errno = error;
+		return -1;
+	}
+	if ((size_t) fileStatus.st_size < sizeof (uint32_t)) {
+		close(fd);
+		errno = EBADMSG;
+		return -1;
+	}
+	data = mmap(NULL, (size_t) fileStatus.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	error = errno;
+	close(fd);
+	if (data == MAP_FAILED) {
+		errno = error;
+		return -1;
+	}
+	capture->data = data;
+	capture->size = (size_t) fileStatus.st_size;
+	madvise(data, capture->size, MADV_SEQUENTIAL);
+
+	if (readUint32(capture->data, false) == PCAPNG_SECTION_HEADER_BLOCK) {
+		result = indexPcapng(capture);
+	}
+	else {
+		result = indexPcap(capture);
+	}
+	if (result < 0) {
+		error = errno;
+		closeCapture(capture);
+		errno = error;
+		return -1;
+	}
+	return 0;
+}
+
+/*!
+ * \brief closeCapture Unmaps a capture file and frees its packet index
+ * \param capture Capture to be closed
+ */
+void closeCapture(CaptureType* capture) {
+	if (capture == NULL) {
+		return;
+	}
+	if (capture->data != NULL) {
+		munmap((void*) capture->data, capture->size);
+	}
+	free(capture->packets);
+	memset(capture, 0, sizeof (*capture));
+}
+
+/*!
+ * \brief analyzeCapture Finds and decodes all ISO messages in a capture, summarizing them per object.
+ *			UDP payloads are decoded in parallel directly from the mapped file, in chunks of packets.
+ *			TCP streams are then reassembled in capture order and the resulting messages decoded in
+ *			parallel. Per thread results are merged at the end.
+ * \param capture Capture to be analysed
+ * \param options Analysis options, or NULL for defaults
+ * \param statistics Struct to be filled, to be freed using ::freeCaptureStatistics
+ * \return 0 on success, -1 with errno set otherwise
+ */
+int analyzeCapture(
+		const CaptureType* capture,
+		const CaptureAnalysisOptionsType* options,
+		CaptureStatisticsType* statistics) {
+
+	static const CaptureAnalysisOptionsType defaultOptions = { 0 };
+	AnalysisType analysis;
+	ReassemblyType reassembly;
+	unsigned int nThreads;
+	long nProcessors;
+	int error = 0;
+
+	if (capture == NULL || statistics == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (options == NULL) {
+		options = &defaultOptions;
+	}
+	memset(statistics, 0, sizeof (*statistics));
+	memset(&reassembly, 0, sizeof (reassembly));
+	memset(&analysis, 0, sizeof (analysis));
+
+	nProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+	nThreads = options->nThreads != 0 ? options->nThreads : (nProcessors > 0 ? (unsigned int) nProcessors : 1);
+
+	analysis.capture = capture;
+	analysis.options = options;
+	analysis.chunkSize = capture->nPackets / ((size_t) nThreads * CHUNKS_PER_THREAD);
+	if (analysis.chunkSize < MIN_PACKETS_PER_CHUNK) {
+		analysis.chunkSize = MIN_PACKETS_PER_CHUNK;
+	}
+	analysis.nChunks = (capture->nPackets + analysis.chunkSize - 1) / analysis.chunkSize;
+	analysis.threads = calloc(nThreads, sizeof (*analysis.threads));
+	analysis.chunkSegments = calloc(analysis.nChunks ? analysis.nChunks : 1, sizeof (*analysis.chunkSegments));
+	if (analysis.threads == NULL || analysis.chunkSegments == NULL) {
+		free(analysis.threads);
+		free(analysis.chunkSegments);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	// Decode UDP and collect TCP segments, chunked on packet boundaries
+	runWorkers(analyzePacketChunk, &analysis, nThreads, analysis.nChunks);
+
+	// Reassemble TCP streams in capture order
+	for (size_t c = 0; c < analysis.nChunks; ++c) {
+		const SegmentListType* list = &analysis.chunkSegments[c];
+
+		for (size_t s = 0; s < list->nSegments; ++s) {
+			const SegmentType* segment = &list->segments[s];
+
+			reassembleSegment(&reassembly, segment, capture->packets[segment->packetIndex].time_ns);
+		}
+		free(analysis.chunkSegments[c].segments);
+	}
+	free(analysis.chunkSegments);
+	analysis.chunkSegments = NULL;
+
+	// Decode reassembled messages, chunk numbers continuing after the packet chunks
+	analysis.streamFrames = reassembly.frames;
+	analysis.nStreamFrames = reassembly.nFrames;
+	runWorkers(analyzeStreamFrameChunk, &analysis, nThreads,
+			   (reassembly.nFrames + analysis.chunkSize - 1) / analysis.chunkSize);
+
+	for (unsigned int t = 0; t < nThreads; ++t) {
+		if (analysis.threads[t].error != 0) {
+			error = analysis.threads[t].error;
+		}
+	}
+	if (reassembly.error != 0) {
+		error = reassembly.error;
+	}
+	if (error == 0 && mergeThreadContexts(analysis.threads, nThreads, &reassembly.statistics, statistics) < 0) {
+		error = errno;
+	}
+
+	for (unsigned int t = 0; t < nThreads; ++t) {
+		freeThreadContext(&analysis.threads[t]);
+	}
+	free(analysis.threads);
+	freeReassembly(&reassembly);
+
+	if (error != 0) {
+		freeCaptureStatistics(statistics);
+		errno = error;
+		return -1;
+	}
+	return 0;
+}
+
+/*!
+ * \brief freeCaptureStatistics Frees memory held by capture statistics
+ * \param statistics Statistics to be freed
+ */
+void freeCaptureStatistics(CaptureStatisticsType* statistics) {
+	if (statistics == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < statistics->nObjects; ++i) {
+		free(statistics->objects[i].timeline);
+	}
+	free(statistics->objects);
+	statistics->objects = NULL;
+	statistics->nObjects = 0;
+}
+
+/*!
+ * \brief createCaptureFrameIterator Creates an iterator returning the ISO messages of a capture one
+ *			at a time in capture order, reassembling TCP streams on the way. Intended for sequential
+ *			consumers such as replay, where ::analyzeCapture would hold all messages at once.
+ * \param capture Capture to iterate over, which must outlive the iterator
+ * \return Iterator to be freed using ::freeCaptureFrameIterator, or NULL with errno set
+ */
+CaptureFrameIteratorType* createCaptureFrameIterator(const CaptureType* capture) {
+	CaptureFrameIteratorType* iterator;
+
+	if (capture == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+	if ((iterator = calloc(1, sizeof (*iterator))) == NULL) {
+		errno = ENOMEM;
+		return NULL;
+	}
+	iterator->capture = capture;
+	return iterator;
+}
+
+/*!
+ * \brief getNextCaptureFrame Gets the next ISO message of a capture. Frame data refers either into the
+ *			capture or into memory owned by the iterator, and is only valid until the next call.
+ * \param iterator Iterator created using ::createCaptureFrameIterator
+ * \param frame Frame to be filled
+ * \return 1 if a frame was returned, 0 at the end of the capture, -1 with errno set on error
+ */
+int getNextCaptureFrame(
+		CaptureFrameIteratorType* iterator,
+		CaptureFrameType* frame) {
+
+	ReassemblyType* reassembly;
+	size_t frameOffset, frameLength;
+
+	if (iterator == NULL || frame == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	reassembly = &iterator->reassembly;
+
+	for (;;) {
+		if (iterator->nextStreamFrame < reassembly->nFrames) {
+			const StreamFrameType* streamFrame = &reassembly->frames[iterator->nextStreamFrame++];
+
+			frame->data = streamFrame->data;
+			frame->length = streamFrame->length;
+			frame->time_ns = streamFrame->time_ns;
+			return 1;
+		}
+		if (reassembly->nFrames > 0) {
+			releaseStreamFrames(reassembly);
+			iterator->nextStreamFrame = 0;
+		}
+
+		if (iterator->datagramOffset < iterator->datagram.length) {
+			const SegmentType* datagram = &iterator->datagram;
+
+			if (findFrame(datagram->payload + iterator->datagramOffset,
+						  datagram->length - iterator->datagramOffset, &frameOffset, &frameLength) == FRAME_FOUND) {
+				frame->data = datagram->payload + iterator->datagramOffset + frameOffset;
+				frame->length = frameLength;
+				frame->time_ns = iterator->datagramTime_ns;
+				iterator->datagramOffset += frameOffset + frameLength;
+				return 1;
+			}
+			iterator->datagramOffset = iterator->datagram.length;
+		}
+
+		if (iterator->nextPacket >= iterator->capture->nPackets) {
+			return 0;
+		}
+		else {
+			const CapturePacketType* packet = &iterator->capture->packets[iterator->nextPacket];
+			SegmentType segment;
+
+			switch (parsePacket(packet, &segment)) {
+			case TRANSPORT_UDP:
+				iterator->datagram = segment;
+				iterator->datagramOffset = 0;
+				iterator->datagramTime_ns = packet->time_ns;
+				break;
+			case TRANSPORT_TCP:
+				segment.packetIndex = iterator->nextPacket;
+				reassembleSegment(reassembly, &segment, packet->time_ns);
+				if (reassembly->error != 0) {
+					errno = reassembly->error;
+					return -1;
+				}
+				break;
+			case TRANSPORT_NONE:
+			default:
+				break;
+			}
+			iterator->nextPacket++;
+		}
+	}
+}
+
+/*!
+ * \brief freeCaptureFrameIterator Frees an iterator and any reassembly state it holds
+ * \param iterator Iterator to be freed
+ */
+void freeCaptureFrameIterator(CaptureFrameIteratorType* iterator) {
+	if (iterator == NULL) {
+		return;
+	}
+	freeReassembly(&iterator->reassembly);
+	free(iterator);
+}
+
+
+static int indexPcap(CaptureType* capture) {
+	const uint8_t* data = capture->data;
+	const uint32_t magic = readUint32(data, false);
+	bool isBigEndian, isNanoseconds;
+	size_t offset = PCAP_FILE_HEADER_LENGTH, capacity = 0;
+	uint16_t linkType;
+
+	switch (magic) {
+	case PCAP_MAGIC_MICROSECONDS:
+		isBigEndian = false;
+		isNanoseconds = false;
+		break;
+	case PCAP_MAGIC_NANOSECONDS:
+		isBigEndian = false;
+		isNanoseconds = true;
+		break;
+	case PCAP_MAGIC_MICROSECONDS_SWAPPED:
+		isBigEndian = true;
+		isNanoseconds = false;
+		break;
+	case PCAP_MAGIC_NANOSECONDS_SWAPPED:
+		isBigEndian = true;
+		isNanoseconds = true;
+		break;
+	default:
+		errno = EBADMSG;
+		return -1;
+	}
+	if (capture->size < PCAP_FILE_HEADER_LENGTH) {
+		errno = EBADMSG;
+		return -1;
+	}
+	linkType = (uint16_t) readUint32(data + 20, isBigEndian);
+
+	// A truncated last record is ignored, as when a capture is copied while still being written
+	while (offset + PCAP_RECORD_HEADER_LENGTH <= capture->size) {
+		const uint8_t* record = data + offset;
+		const uint32_t capturedLength = readUint32(record + 8, isBigEndian);
+		CapturePacketType packet;
+
+		if (capturedLength > capture->size - offset - PCAP_RECORD_HEADER_LENGTH) {
+			break;
+		}
+		packet.data = record + PCAP_RECORD_HEADER_LENGTH;
+		packet.length = capturedLength;
+		packet.linkType = linkType;
+		packet.time_ns = (int64_t) readUint32(record, isBigEndian) * NANOSECONDS_PER_SECOND
+				+ (int64_t) readUint32(record + 4, isBigEndian) * (isNanoseconds ? 1 : 1000);
+		if (appendPacket(capture, &capacity, &packet) < 0) {
+			return -1;
+		}
+		offset += PCAP_RECORD_HEADER_LENGTH + capturedLength;
+	}
+	return 0;
+}
+
+static int indexPcapng(CaptureType* capture) {
+	uint16_t linkTypes[PCAPNG_MAX_INTERFACES];
+	uint8_t resolutions[PCAPNG_MAX_INTERFACES];
+	size_t nInterfaces = 0, offset = 0, capacity = 0;
+	bool isBigEndian = false;
+	int64_t lastTime_ns = 0;
+
+	while (offset + 12 <= capture->size) {
+		const uint8_t* block = capture->data + offset;
+		const uint32_t blockType = readUint32(block, isBigEndian);
+		uint32_t blockLength;
+
+		if (blockType == PCAPNG_SECTION_HEADER_BLOCK) {
+			const uint32_t byteOrderMagic = readUint32(block + 8, false);
+
+			if (byteOrderMagic == PCAPNG_BYTE_ORDER_MAGIC) {
+				isBigEndian = false;
+			}
+			else if (readUint32(block + 8, true) == PCAPNG_BYTE_ORDER_MAGIC) {
+				isBigEndian = true;
+			}
+			else {
+				errno = EBADMSG;
+				return -1;
+			}
+			nInterfaces = 0;
+		}
+		blockLength = readUint32(block + 4, isBigEndian);
+		if (blockLength < 12 || blockLength % 4 != 0 || blockLength > capture->size - offset) {
+			break;
+		}
+
+		if (blockType == PCAPNG_INTERFACE_DESCRIPTION_BLOCK && blockLength >= 20) {
+			size_t optionOffset = 16;
+
+			if (nInterfaces < PCAPNG_MAX_INTERFACES) {
+				linkTypes[nInterfaces] = readUint16(block + 8, isBigEndian);
+				resolutions[nInterfaces] = 6;
+				while (optionOffset + 4 <= blockLength - 4) {
+					const uint16_t code = readUint16(block + optionOffset, isBigEndian);
+					const uint16_t length = readUint16(block + optionOffset + 2, isBigEndian);
+
+					if (code == PCAPNG_OPTION_END || optionOffset + 4 + length > blockLength - 4) {
+						break;
+					}
+					if (code == PCAPNG_OPTION_TIMESTAMP_RESOLUTION && length >= 1) {
+						resolutions[nInterfaces] = block[optionOffset + 4];
+					}
+					optionOffset += 4 + ((length + 3U) & ~3U);
+				}
+			}
+			nInterfaces++;
+		}
+		else if (blockType == PCAPNG_ENHANCED_PACKET_BLOCK && blockLength >= 32) {
+			const uint32_t interfaceID = readUint32(block + 8, isBigEndian);
+			const uint64_t timestamp = (uint64_t) readUint32(block + 12, isBigEndian) << 32
+					| readUint32(block + 16, isBigEndian);
+			const uint32_t capturedLength = readUint32(block + 20, isBigEndian);
+
+			if (interfaceID < nInterfaces && interfaceID < PCAPNG_MAX_INTERFACES
+					&& capturedLength <= blockLength - 32) {
+				CapturePacketType packet;
+
+				packet.data = block + 28;
+				packet.length = capturedLength;
+				packet.linkType = linkTypes[interfaceID];
+				packet.time_ns = lastTime_ns = pcapngTimeToNanoseconds(timestamp, resolutions[interfaceID]);
+				if (appendPacket(capture, &capacity, &packet) < 0) {
+					return -1;
+				}
+			}
+		}
+		else if (blockType == PCAPNG_SIMPLE_PACKET_BLOCK && blockLength >= 16 && nInterfaces > 0) {
+			const uint32_t originalLength = readUint32(block + 8, isBigEndian);
+			CapturePacketType packet;
+
+			// Simple packet blocks carry no timestamp, so the previous one is reused
+			packet.data = block + 12;
+			packet.length = originalLength < blockLength - 16 ? originalLength : blockLength - 16;
+			packet.linkType = linkTypes[0];
+			packet.time_ns = lastTime_ns;
+			if (appendPacket(capture, &capacity, &packet) < 0) {
+				return -1;
+			}
+		}
+		offset += blockLength;
+	}
+	return 0;
+}
+
+static int appendPacket(
+		CaptureType* capture,
+		size_t* capacity,
+		const CapturePacketType* packet) {
+
+	if (capture->nPackets == *capacity) {
+		const size_t newCapacity = *capacity ? 2 * *capacity : 4096;
+		CapturePacketType* newPackets = realloc(capture->packets, newCapacity * sizeof (*newPackets));
+
+		if (newPackets == NULL) {
+			errno = ENOMEM;
+			return -1;
+		}
+		capture->packets = newPackets;
+		*capacity = newCapacity;
+	}
+	capture->packets[capture->nPackets++] = *packet;
+	return 0;
+}
+
+static int64_t pcapngTimeToNanoseconds(
+		const uint64_t timestamp,
+		const uint8_t resolution) {
+
+	const uint8_t exponent = resolution & 0x7F;
+
+	if (resolution & 0x80) {
+		// Negative power of two
+		const uint64_t mask = exponent < 64 ? (UINT64_C(1) << exponent) - 1 : UINT64_MAX;
+
+		if (exponent >= 64) {
+			return 0;
+		}
+		return (int64_t) ((timestamp >> exponent) * NANOSECONDS_PER_SECOND
+						  + ((timestamp & mask) * NANOSECONDS_PER_SECOND >> exponent));
+	}
+	else if (exponent <= 9) {
+		uint64_t multiplier = 1;
+
+		for (uint8_t i = exponent; i < 9; ++i) {
+			multiplier *= 10;
+		}
+		return (int64_t) (timestamp * multiplier);
+	}
+	else {
+		uint64_t divisor = 1;
+
+		for (uint8_t i = 9; i < exponent && i < 28; ++i) {
+			divisor *= 10;
+		}
+		return (int64_t) (timestamp / divisor);
+	}
+}
+
+
+static TransportType parsePacket(
+		const CapturePacketType* packet,
+		SegmentType* segment) {
+
+	const uint8_t* p = packet->data;
+	const uint8_t* end = packet->data + packet->length;
+	uint16_t etherType = 0;
+	uint8_t protocol;
+
+	memset(&segment->flow, 0, sizeof (segment->flow));
+
+	// Link layer
+	switch (packet->linkType) {
+	case LINKTYPE_ETHERNET:
+		if (end - p < 14) {
+			return TRANSPORT_NONE;
+		}
+		etherType = readBigEndian16(p + 12);
+		p += 14;
+		while (etherType == ETHERTYPE_VLAN || etherType == ETHERTYPE_QINQ) {
+			if (end - p < 4) {
+				return TRANSPORT_NONE;
+			}
+			etherType = readBigEndian16(p + 2);
+			p += 4;
+		}
+		break;
+	case LINKTYPE_LINUX_SLL:
+		if (end - p < 16) {
+			return TRANSPORT_NONE;
+		}
+		etherType = readBigEndian16(p + 14);
+		p += 16;
+		break;
+	case LINKTYPE_LINUX_SLL2:
+		if (end - p < 20) {
+			return TRANSPORT_NONE;
+		}
+		etherType = readBigEndian16(p);
+		p += 20;
+		break;
+	case LINKTYPE_NULL:
+	case LINKTYPE_LOOP:
+		if (end - p < 4) {
+			return TRANSPORT_NONE;
+		}
+		// Address family in the byte order of the capturing host
+		p += 4;
+		if (p < end) {
+			etherType = (*p >> 4) == 4 ? ETHERTYPE_IPV4 : (*p >> 4) == 6 ? ETHERTYPE_IPV6 : 0;
+		}
+		break;
+	case LINKTYPE_RAW:
+	case LINKTYPE_IPV4:
+	case LINKTYPE_IPV6:
+		if (p < end) {
+			etherType = (*p >> 4) == 4 ? ETHERTYPE_IPV4 : (*p >> 4) == 6 ? ETHERTYPE_IPV6 : 0;
+		}
+		break;
+	default:
+		return TRANSPORT_NONE;
+	}
+
+	// Network layer
+	if (etherType == ETHERTYPE_IPV4) {
+		size_t headerLength, totalLength;
+
+		if (end - p < 20 || (p[0] >> 4) != 4) {
+			return TRANSPORT_NONE;
+		}
+		headerLength = (size_t) (p[0] & 0x0F) * 4;
+		totalLength = readBigEndian16(p + 2);
+		if (headerLength < 20 || totalLength < headerLength || (readBigEndian16(p + 6) & 0x3FFF) != 0) {
+			return TRANSPORT_NONE;		// Malformed, or a fragment
+		}
+		if ((size_t) (end - p) > totalLength) {
+			end = p + totalLength;		// Strip link layer padding
+		}
+		protocol = p[9];
+		segment->flow.ipVersion = 4;
+		memcpy(segment->flow.source, p + 12, 4);
+		memcpy(segment->flow.destination, p + 16, 4);
+		p += headerLength;
+	}
+	else if (etherType == ETHERTYPE_IPV6) {
+		size_t payloadLength;
+
+		if (end - p < 40 || (p[0] >> 4) != 6) {
+			return TRANSPORT_NONE;
+		}
+		payloadLength = readBigEndian16(p + 4);
+		protocol = p[6];
+		segment->flow.ipVersion = 6;
+		memcpy(segment->flow.source, p + 8, 16);
+		memcpy(segment->flow.destination, p + 24, 16);
+		p += 40;
+		if (payloadLength != 0 && (size_t) (end - p) > payloadLength) {
+			end = p + payloadLength;
+		}
+		// Skip hop-by-hop, routing, destination and authentication extension headers
+		while (protocol == 0 || protocol == 43 || protocol == 60 || protocol == 51) {
+			size_t extensionLength;
+
+			if (end - p < 8) {
+				return TRANSPORT_NONE;
+			}
+			extensionLength = protocol == 51 ? ((size_t) p[1] + 2) * 4 : ((size_t) p[1] + 1) * 8;
+			if ((size_t) (end - p) < extensionLength) {
+				return TRANSPORT_NONE;
+			}
+			protocol = p[0];
+			p += extensionLength;
+		}
+	}
+	else {
+		return TRANSPORT_NONE;
+	}
+
+	// Transport layer
+	if (protocol == IP_PROTOCOL_UDP) {
+		size_t length;
+
+		if (end - p < 8) {
+			return TRANSPORT_NONE;
+		}
+		segment->flow.sourcePort = readBigEndian16(p);
+		segment->flow.destinationPort = readBigEndian16(p + 2);
+		length = readBigEndian16(p + 4);
+		if (length < 8) {
+			return TRANSPORT_NONE;
+		}
+		segment->payload = p + 8;
+		segment->length = (uint32_t) ((size_t) (end - p) < length ? (size_t) (end - p) - 8 : length - 8);
+		segment->sequence = 0;
+		segment->tcpFlags = 0;
+		return TRANSPORT_UDP;
+	}
+	else if (protocol == IP_PROTOCOL_TCP) {
+		size_t dataOffset;
+
+		if (end - p < 20) {
+			return TRANSPORT_NONE;
+		}
+		dataOffset = (size_t) (p[12] >> 4) * 4;
+		if (dataOffset < 20 || (size_t) (end - p) < dataOffset) {
+			return TRANSPORT_NONE;
+		}
+		segment->flow.sourcePort = readBigEndian16(p);
+		segment->flow.destinationPort = readBigEndian16(p + 2);
+		segment->sequence = readBigEndian32(p + 4);
+		segment->tcpFlags = p[13];
+		segment->payload = p + dataOffset;
+		segment->length = (uint32_t) ((size_t) (end - p) - dataOffset);
+		return TRANSPORT_TCP;
+	}
+	return TRANSPORT_NONE;
+}
+
+/*!
+ * \brief findFrame Searches for the first ISO message in a byte sequence, identified by its sync word
+ *			and length field
+ * \param data Bytes to search
+ * \param length Number of bytes
+ * \param frameOffset Position of the message, or of the first byte which may belong to a message
+ * \param frameLength Length of the message including header and footer, if known
+ * \return FRAME_FOUND if a complete message was found, FRAME_INCOMPLETE if a message starts but does not
+ *			fit, FRAME_NOT_FOUND otherwise
+ */
+static FrameSearchResultType findFrame(
+		const uint8_t* data,
+		const size_t length,
+		size_t* frameOffset,
+		size_t* frameLength) {
+
+	*frameLength = 0;
+	for (size_t offset = 0; offset + 1 < length; ++offset) {
+		uint32_t messageLength;
+
+		if (data[offset] != ISO_SYNC_WORD_FIRST_BYTE || data[offset + 1] != ISO_SYNC_WORD_SECOND_BYTE) {
+			continue;
+		}
+		*frameOffset = offset;
+		if (length - offset < sizeof (HeaderType)) {
+			return FRAME_INCOMPLETE;
+		}
+		messageLength = readUint32(data + offset + 2, false);
+		if (messageLength > ISO_MAX_MESSAGE_LENGTH) {
+			continue;
+		}
+		*frameLength = messageLength + ISO_FRAME_OVERHEAD;
+		return length - offset < *frameLength ? FRAME_INCOMPLETE : FRAME_FOUND;
+	}
+	// Keep a trailing first sync byte, as the second may arrive in the next segment
+	*frameOffset = length > 0 && data[length - 1] == ISO_SYNC_WORD_FIRST_BYTE ? length - 1 : length;
+	return FRAME_NOT_FOUND;
+}
+
+
+static void analyzePacketChunk(
+		void* arg,
+		const unsigned int threadIndex,
+		const size_t chunk) {
+
+	AnalysisType* analysis = arg;
+	ThreadContextType* thread = &analysis->threads[threadIndex];
+	const size_t first = chunk * analysis->chunkSize;
+	const size_t last = first + analysis->chunkSize < analysis->capture->nPackets ?
+				first + analysis->chunkSize : analysis->capture->nPackets;
+	CaptureStatisticsType* statistics = &thread->statistics;
+
+	for (size_t i = first; i < last; ++i) {
+		const CapturePacketType* packet = &analysis->capture->packets[i];
+		SegmentType segment;
+		size_t offset = 0, frameOffset, frameLength;
+		uint64_t frameIndex = 0;
+
+		statistics->nPackets++;
+		statistics->nBytes += packet->length;
+		if (statistics->nPackets == 1 || packet->time_ns < statistics->firstTime_ns) {
+			statistics->firstTime_ns = packet->time_ns;
+		}
+		if (statistics->nPackets == 1 || packet->time_ns > statistics->lastTime_ns) {
+			statistics->lastTime_ns = packet->time_ns;
+		}
+
+		switch (parsePacket(packet, &segment)) {
+		case TRANSPORT_UDP:
+			statistics->nUDPPackets++;
+			while (offset < segment.length) {
+				const FrameSearchResultType result = findFrame(segment.payload + offset, segment.length - offset,
+															   &frameOffset, &frameLength);
+				if (result != FRAME_FOUND) {
+					if (result == FRAME_INCOMPLETE) {
+						statistics->nTruncatedFrames++;
+					}
+					statistics->nSkippedBytes += segment.length - offset;
+					break;
+				}
+				statistics->nSkippedBytes += frameOffset;
+				analyzeFrame(analysis, thread, segment.payload + offset + frameOffset, frameLength,
+							 packet->time_ns, ((uint64_t) i << 16) | (frameIndex++ & 0xFFFF), chunk);
+				offset += frameOffset + frameLength;
+			}
+			break;
+		case TRANSPORT_TCP:
+			statistics->nTCPPackets++;
+			segment.packetIndex = i;
+			if (appendSegment(&analysis->chunkSegments[chunk], &segment) < 0) {
+				thread->error = ENOMEM;
+			}
+			break;
+		case TRANSPORT_NONE:
+		default:
+			statistics->nOtherPackets++;
+			break;
+		}
+	}
+}
+
+static void analyzeStreamFrameChunk(
+		void* arg,
+		const unsigned int threadIndex,
+		const size_t chunk) {
+
+	AnalysisType* analysis = arg;
+	ThreadContextType* thread = &analysis->threads[threadIndex];
+	const size_t first = chunk * analysis->chunkSize;
+	const size_t last = first + analysis->chunkSize < analysis->nStreamFrames ?
+				first + analysis->chunkSize : analysis->nStreamFrames;
+
+	for (size_t i = first; i < last; ++i) {
+		const StreamFrameType* frame = &analysis->streamFrames[i];
+
+		analyzeFrame(analysis, thread, frame->data, frame->length, frame->time_ns, frame->order,
+					 analysis->nChunks + chunk);
+	}
+}
+
+static void analyzeFrame(
+		const AnalysisType* analysis,
+		ThreadContextType* thread,
+		const uint8_t* frame,
+		const size_t length,
+		const int64_t time_ns,
+		const uint64_t order,
+		const size_t chunk) {
+
+	const uint32_t transmitterID = readUint32(frame + HEADER_TRANSMITTER_ID_OFFSET, false);
+	const uint16_t messageID = readUint16(frame + HEADER_MESSAGE_ID_OFFSET, false);
+	const uint16_t crc = readUint16(frame + length - sizeof (FooterType), false);
+	CaptureStatisticsType* statistics = &thread->statistics;
+	CaptureObjectStatisticsType* object;
+	ObjectContextType* context;
+
+	statistics->nFrames++;
+	if (analysis->options->isTransmitterFiltered && transmitterID != analysis->options->transmitterID) {
+		return;
+	}
+	if ((context = getObjectContext(thread, transmitterID)) == NULL) {
+		thread->error = ENOMEM;
+		return;
+	}
+	object = &context->statistics;
+
+	if (object->nMessages == 0 || time_ns < object->firstTime_ns) {
+		object->firstTime_ns = time_ns;
+	}
+	if (object->nMessages == 0 || time_ns > object->lastTime_ns) {
+		object->lastTime_ns = time_ns;
+	}
+	object->nMessages++;
+	if (messageID < sizeof (statistics->messageCounts) / sizeof (statistics->messageCounts[0])) {
+		statistics->messageCounts[messageID]++;
+	}
+	else {
+		statistics->nVendorMessages++;
+	}
+
+	if (verifyChecksum(frame, length - sizeof (FooterType), crc, 0) != MESSAGE_OK) {
+		statistics->nCRCErrors++;
+		object->nCRCErrors++;
+		return;
+	}
+
+	if (messageID == MESSAGE_ID_MONR) {
+		MonitorSampleType sample;
+		struct timeval receiveTime;
+
+		receiveTime.tv_sec = time_ns / NANOSECONDS_PER_SECOND;
+		receiveTime.tv_usec = (time_ns % NANOSECONDS_PER_SECOND) / 1000;
+		if (decodeMONRMessageToSample((const char*) frame, length, receiveTime, &sample, 0) < 0) {
+			statistics->nDecodeErrors++;
+			object->nDecodeErrors++;
+			return;
+		}
+		if (object->nMONRMessages == 0 || time_ns < object->firstMONRTime_ns) {
+			object->firstMONRTime_ns = time_ns;
+		}
+		if (object->nMONRMessages == 0 || time_ns > object->lastMONRTime_ns) {
+			object->lastMONRTime_ns = time_ns;
+		}
+		object->nMONRMessages++;
+
+		// The first state in each chunk is always kept, so that transitions survive merging
+		if (analysis->options->isTimelineEnabled
+				&& (context->lastChunk != chunk || context->nTimelineEntries == 0
+					|| context->timeline[context->nTimelineEntries - 1].state != sample.state)) {
+			if (context->nTimelineEntries == context->timelineCapacity) {
+				const size_t newCapacity = context->timelineCapacity ? 2 * context->timelineCapacity : 16;
+				TimelineEntryType* newTimeline = realloc(context->timeline, newCapacity * sizeof (*newTimeline));
+
+				if (newTimeline == NULL) {
+					thread->error = ENOMEM;
+					return;
+				}
+				context->timeline = newTimeline;
+				context->timelineCapacity = newCapacity;
+			}
+			context->timeline[context->nTimelineEntries].time_ns = time_ns;
+			context->timeline[context->nTimelineEntries].order = order;
+			context->timeline[context->nTimelineEntries].state = sample.state;
+			context->nTimelineEntries++;
+			context->lastChunk = chunk;
+		}
+	}
+}
+
+static ObjectContextType* getObjectContext(
+		ThreadContextType* thread,
+		const uint32_t transmitterID) {
+
+	size_t mask = thread->objectIndexCapacity - 1;
+	size_t slot;
+
+	if (thread->objectIndexCapacity != 0) {
+		for (slot = hashBytes(&transmitterID, sizeof (transmitterID)) & mask;
+			 thread->objectIndex[slot] != 0; slot = (slot + 1) & mask) {
+			ObjectContextType* object = &thread->objects[thread->objectIndex[slot] - 1];
+
+			if (object->statistics.transmitterID == transmitterID) {
+				return object;
+			}
+		}
+	}
+
+	// Not found, grow both arrays as needed and insert
+	if (thread->nObjects == thread->objectCapacity) {
+		const size_t newCapacity = thread->objectCapacity ? 2 * thread->objectCapacity : 16;
+		ObjectContextType* newObjects = realloc(thread->objects, newCapacity * sizeof (*newObjects));
+
+		if (newObjects == NULL) {
+			return NULL;
+		}
+		thread->objects = newObjects;
+		thread->objectCapacity = newCapacity;
+	}
+	if (2 * (thread->nObjects + 1) > thread->objectIndexCapacity) {
+		const size_t newCapacity = thread->objectIndexCapacity ? 2 * thread->objectIndexCapacity : 64;
+		size_t* newIndex = calloc(newCapacity, sizeof (*newIndex));
+
+		if (newIndex == NULL) {
+			return NULL;
+		}
+		free(thread->objectIndex);
+		thread->objectIndex = newIndex;
+		thread->objectIndexCapacity = newCapacity;
+		mask = newCapacity - 1;
+		for (size_t i = 0; i < thread->nObjects; ++i) {
+			const uint32_t id = thread->objects[i].statistics.transmitterID;
+
+			for (slot = hashBytes(&id, sizeof (id)) & mask; newIndex[slot] != 0; slot = (slot + 1) & mask);
+			newIndex[slot] = i + 1;
+		}
+	}
+	for (slot = hashBytes(&transmitterID, sizeof (transmitterID)) & mask;
+		 thread->objectIndex[slot] != 0; slot = (slot + 1) & mask);
+	thread->objectIndex[slot] = thread->nObjects + 1;
+
+	memset(&thread->objects[thread->nObjects], 0, sizeof (thread->objects[thread->nObjects]));
+	thread->objects[thread->nObjects].statistics.transmitterID = transmitterID;
+	return &thread->objects[thread->nObjects++];
+}
+
+static int appendSegment(
+		SegmentListType* list,
+		const SegmentType* segment) {
+
+	if (list->nSegments == list->capacity) {
+		const size_t newCapacity = list->capacity ? 2 * list->capacity : 256;
+		SegmentType* newSegments = realloc(list->segments, newCapacity * sizeof (*newSegments));
+
+		if (newSegments == NULL) {
+			return -1;
+		}
+		list->segments = newSegments;
+		list->capacity = newCapacity;
+	}
+	list->segments[list->nSegments++] = *segment;
+	return 0;
+}
+
+
+static void reassembleSegment(
+		ReassemblyType* reassembly,
+		const SegmentType* segment,
+		const int64_t time_ns) {
+
+	FlowStateType* flow = getFlowState(reassembly, &segment->flow);
+	const uint8_t* payload = segment->payload;
+	size_t length = segment->length;
+	int32_t sequenceDifference;
+
+	if (flow == NULL) {
+		reassembly->error = ENOMEM;
+		return;
+	}
+
+	if (segment->tcpFlags & TCP_FLAG_SYN) {
+		flow->isSequenceKnown = true;
+		flow->nextSequence = segment->sequence + 1;
+		flow->bufferLength = 0;
+		return;
+	}
+	if (!flow->isSequenceKnown) {
+		// Stream captured midway, framing is found using the sync word
+		flow->isSequenceKnown = true;
+		flow->nextSequence = segment->sequence;
+	}
+
+	sequenceDifference = (int32_t) (segment->sequence - flow->nextSequence);
+	if (sequenceDifference > 0) {
+		// Segments missing from the capture, discard any partial message
+		reassembly->statistics.nTCPGaps++;
+		if (flow->bufferLength > 0) {
+			reassembly->statistics.nTruncatedFrames++;
+			reassembly->statistics.nSkippedBytes += flow->bufferLength;
+			flow->bufferLength = 0;
+		}
+		flow->nextSequence = segment->sequence;
+	}
+	else if (sequenceDifference < 0) {
+		// Retransmission, possibly carrying some new data
+		if ((size_t) -(int64_t) sequenceDifference >= length) {
+			length = 0;
+		}
+		else {
+			payload += -(int64_t) sequenceDifference;
+			length -= (size_t) -(int64_t) sequenceDifference;
+		}
+	}
+
+	if (length > 0) {
+		flow->nextSequence += (uint32_t) length;
+		if (flow->bufferLength == 0) {
+			extractStreamFrames(reassembly, flow, payload, length, false, time_ns, segment->packetIndex);
+		}
+		else {
+			if (flow->bufferLength + length > flow->bufferCapacity) {
+				size_t newCapacity = flow->bufferCapacity ? flow->bufferCapacity : 4096;
+				uint8_t* newBuffer;
+
+				while (newCapacity < flow->bufferLength + length) {
+					newCapacity *= 2;
+				}
+				if ((newBuffer = realloc(flow->buffer, newCapacity)) == NULL) {
+					reassembly->error = ENOMEM;
+					return;
+				}
+				flow->buffer = newBuffer;
+				flow->bufferCapacity = newCapacity;
+			}
+			memcpy(flow->buffer + flow->bufferLength, payload, length);
+			flow->bufferLength += length;
+			extractStreamFrames(reassembly, flow, flow->buffer, flow->bufferLength, true, time_ns,
+								segment->packetIndex);
+		}
+	}
+
+	if (segment->tcpFlags & (TCP_FLAG_FIN | TCP_FLAG_RST)) {
+		if (flow->bufferLength > 0) {
+			reassembly->statistics.nTruncatedFrames++;
+			reassembly->statistics.nSkippedBytes += flow->bufferLength;
+		}
+		flow->bufferLength = 0;
+		flow->isSequenceKnown = false;
+	}
+}
+
+/*!
+ * \brief extractStreamFrames Extracts complete messages from stream data and keeps any remainder in
+ *			the flow buffer. Messages in unbuffered data refer directly into the capture.
+ */
+static void extractStreamFrames(
+		ReassemblyType* reassembly,
+		FlowStateType* flow,
+		const uint8_t* data,
+		const size_t length,
+		const bool isBuffered,
+		const int64_t time_ns,
+		const size_t packetIndex) {
+
+	size_t offset = 0, frameOffset, frameLength, remaining;
+	uint64_t frameIndex = 0;
+
+	for (;;) {
+		const FrameSearchResultType result = findFrame(data + offset, length - offset, &frameOffset, &frameLength);
+
+		reassembly->statistics.nSkippedBytes += frameOffset;
+		offset += frameOffset;
+		if (result != FRAME_FOUND) {
+			break;
+		}
+		appendStreamFrame(reassembly, data + offset, frameLength, isBuffered, time_ns,
+						  ((uint64_t) packetIndex << 16) | (frameIndex++ & 0xFFFF));
+		offset += frameLength;
+	}
+
+	remaining = length - offset;
+	if (isBuffered) {
+		memmove(flow->buffer, flow->buffer + offset, remaining);
+		flow->bufferLength = remaining;
+	}
+	else if (remaining > 0) {
+		size_t capacity = flow->bufferCapacity ? flow->bufferCapacity : 4096;
+
+		while (capacity < remaining) {
+			capacity *= 2;
+		}
+		if (capacity > flow->bufferCapacity) {
+			uint8_t* newBuffer = realloc(flow->buffer, capacity);
+
+			if (newBuffer == NULL) {
+				reassembly->error = ENOMEM;
+				return;
+			}
+			flow->buffer = newBuffer;
+			flow->bufferCapacity = capacity;
+		}
+		memcpy(flow->buffer, data + offset, remaining);
+		flow->bufferLength = remaining;
+	}
+}
+
+static void appendStreamFrame(
+		ReassemblyType* reassembly,
+		const uint8_t* data,
+		const size_t length,
+		const bool isCopied,
+		const int64_t time_ns,
+		const uint64_t order) {
+
+	StreamFrameType* frame;
+
+	if (reassembly->nFrames == reassembly->frameCapacity) {
+		const size_t newCapacity = reassembly->frameCapacity ? 2 * reassembly->frameCapacity : 1024;
+		StreamFrameType* newFrames = realloc(reassembly->frames, newCapacity * sizeof (*newFrames));
+
+		if (newFrames == NULL) {
+			reassembly->error = ENOMEM;
+			return;
+		}
+		reassembly->frames = newFrames;
+		reassembly->frameCapacity = newCapacity;
+	}
+	frame = &reassembly->frames[reassembly->nFrames];
+
+	if (isCopied) {
+		// Messages spanning segments are copied to stable storage, as the flow buffer is reused
+		ArenaBlockType* block = reassembly->arena;
+
+		if (block == NULL || block->capacity - block->used < length) {
+			const size_t capacity = length > ARENA_BLOCK_SIZE ? length : ARENA_BLOCK_SIZE;
+
+			if ((block = malloc(sizeof (*block) + capacity)) == NULL) {
+				reassembly->error = ENOMEM;
+				return;
+			}
+			block->next = reassembly->arena;
+			block->used = 0;
+			block->capacity = capacity;
+			reassembly->arena = block;
+		}
+		memcpy(block->data + block->used, data, length);
+		frame->data = block->data + block->used;
+		block->used += length;
+	}
+	else {
+		frame->data = data;
+	}
+	frame->length = length;
+	frame->time_ns = time_ns;
+	frame->order = order;
+	reassembly->nFrames++;
+}
+
+static FlowStateType* getFlowState(
+		ReassemblyType* reassembly,
+		const FlowKeyType* key) {
+
+	size_t mask, slot;
+
+	if (2 * (reassembly->nFlows + 1) > reassembly->capacity) {
+		const size_t newCapacity = reassembly->capacity ? 2 * reassembly->capacity : 64;
+		FlowStateType* newFlows = calloc(newCapacity, sizeof (*newFlows));
+
+		if (newFlows == NULL) {
+			return NULL;
+		}
+		for (size_t i = 0; i < reassembly->capacity; ++i) {
+			if (reassembly->flows[i].isActive) {
+				for (slot = hashBytes(&reassembly->flows[i].key, sizeof (*key)) & (newCapacity - 1);
+					 newFlows[slot].isActive; slot = (slot + 1) & (newCapacity - 1));
+				newFlows[slot] = reassembly->flows[i];
+			}
+		}
+		free(reassembly->flows);
+		reassembly->flows = newFlows;
+		reassembly->capacity = newCapacity;
+	}
+
+	mask = reassembly->capacity - 1;
+	for (slot = hashBytes(key, sizeof (*key)) & mask; reassembly->flows[slot].isActive; slot = (slot + 1) & mask) {
+		if (memcmp(&reassembly->flows[slot].key, key, sizeof (*key)) == 0) {
+			return &reassembly->flows[slot];
+		}
+	}
+	reassembly->flows[slot].isActive = true;
+	reassembly->flows[slot].key = *key;
+	reassembly->nFlows++;
+	return &reassembly->flows[slot];
+}
+
+/*!
+ * \brief releaseStreamFrames Discards all reassembled messages and the copies made of them, keeping
+ *			flow state so that reassembly can continue
+ */
+static void releaseStreamFrames(ReassemblyType* reassembly) {
+	while (reassembly->arena != NULL) {
+		ArenaBlockType* next = reassembly->arena->next;
+
+		free(reassembly->arena);
+		reassembly->arena = next;
+	}
+	reassembly->nFrames = 0;
+}
+
+static void freeReassembly(ReassemblyType* reassembly) {
+	for (size_t i = 0; i < reassembly->capacity; ++i) {
+		free(reassembly->flows[i].buffer);
+	}
+	free(reassembly->flows);
+	releaseStreamFrames(reassembly);
+	free(reassembly->frames);
+	memset(reassembly, 0, sizeof (*reassembly));
+}
+
+
+static int mergeThreadContexts(
+		ThreadContextType* threads,
+		const size_t nThreads,
+		const CaptureStatisticsType* reassemblyStatistics,
+		CaptureStatisticsType* result) {
+
+	ObjectContextType* all;
+	size_t nAll = 0;
+	bool hasTime = false;
+
+	for (size_t t = 0; t < nThreads; ++t) {
+		const CaptureStatisticsType* term = &threads[t].statistics;
+
+		if (term->nPackets > 0) {
+			if (!hasTime || term->firstTime_ns < result->firstTime_ns) {
+				result->firstTime_ns = term->firstTime_ns;
+			}
+			if (!hasTime || term->lastTime_ns > result->lastTime_ns) {
+				result->lastTime_ns = term->lastTime_ns;
+			}
+			hasTime = true;
+		}
+		addCounters(result, term);
+		nAll += threads[t].nObjects;
+	}
+	addCounters(result, reassemblyStatistics);
+
+	if (nAll == 0) {
+		return 0;
+	}
+	if ((all = malloc(nAll * sizeof (*all))) == NULL
+			|| (result->objects = calloc(nAll, sizeof (*result->objects))) == NULL) {
+		free(all);
+		errno = ENOMEM;
+		return -1;
+	}
+	nAll = 0;
+	for (size_t t = 0; t < nThreads; ++t) {
+		if (threads[t].nObjects == 0) {
+			continue;
+		}
+		memcpy(all + nAll, threads[t].objects, threads[t].nObjects * sizeof (*all));
+		nAll += threads[t].nObjects;
+	}
+	qsort(all, nAll, sizeof (*all), compareObjectContexts);
+
+	for (size_t first = 0, last; first < nAll; first = last) {
+		CaptureObjectStatisticsType* object = &result->objects[result->nObjects++];
+		TimelineEntryType* timeline = NULL;
+		size_t nTimelineEntries = 0;
+
+		*object = all[first].statistics;
+		object->nMessages = object->nMONRMessages = object->nCRCErrors = object->nDecodeErrors = 0;
+		for (last = first; last < nAll && all[last].statistics.transmitterID == object->transmitterID; ++last) {
+			const CaptureObjectStatisticsType* term = &all[last].statistics;
+
+			if (term->nMessages > 0 && (object->nMessages == 0 || term->firstTime_ns < object->firstTime_ns)) {
+				object->firstTime_ns = term->firstTime_ns;
+			}
+			if (term->nMessages > 0 && (object->nMessages == 0 || term->lastTime_ns > object->lastTime_ns)) {
+				object->lastTime_ns = term->lastTime_ns;
+			}
+			if (term->nMONRMessages > 0
+					&& (object->nMONRMessages == 0 || term->firstMONRTime_ns < object->firstMONRTime_ns)) {
+				object->firstMONRTime_ns = term->firstMONRTime_ns;
+			}
+			if (term->nMONRMessages > 0
+					&& (object->nMONRMessages == 0 || term->lastMONRTime_ns > object->lastMONRTime_ns)) {
+				object->lastMONRTime_ns = term->lastMONRTime_ns;
+			}
+			object->nMessages += term->nMessages;
+			object->nMONRMessages += term->nMONRMessages;
+			object->nCRCErrors += term->nCRCErrors;
+			object->nDecodeErrors += term->nDecodeErrors;
+			nTimelineEntries += all[last].nTimelineEntries;
+		}
+
+		// Concatenate timelines from all threads, order them as captured and keep only changes
+		object->timeline = NULL;
+		object->nTimelineEntries = 0;
+		if (nTimelineEntries > 0) {
+			if ((timeline = malloc(nTimelineEntries * sizeof (*timeline))) == NULL
+					|| (object->timeline = malloc(nTimelineEntries * sizeof (*object->timeline))) == NULL) {
+				free(timeline);
+				free(all);
+				errno = ENOMEM;
+				return -1;
+			}
+			nTimelineEntries = 0;
+			for (size_t i = first; i < last; ++i) {
+				memcpy(timeline + nTimelineEntries, all[i].timeline, all[i].nTimelineEntries * sizeof (*timeline));
+				nTimelineEntries += all[i].nTimelineEntries;
+			}
+			qsort(timeline, nTimelineEntries, sizeof (*timeline), compareTimelineEntries);
+			for (size_t i = 0; i < nTimelineEntries; ++i) {
+				if (object->nTimelineEntries == 0
+						|| object->timeline[object->nTimelineEntries - 1].state != timeline[i].state) {
+					object->timeline[object->nTimelineEntries].time_ns = timeline[i].time_ns;
+					object->timeline[object->nTimelineEntries].state = timeline[i].state;
+					object->nTimelineEntries++;
+				}
+			}
+			free(timeline);
+		}
+	}
+	free(all);
+	return 0;
+}
+
+static void addCounters(
+		CaptureStatisticsType* sum,
+		const CaptureStatisticsType* term) {
+
+	sum->nPackets += term->nPackets;
+	sum->nBytes += term->nBytes;
+	sum->nUDPPackets += term->nUDPPackets;
+	sum->nTCPPackets += term->nTCPPackets;
+	sum->nOtherPackets += term->nOtherPackets;
+	sum->nFrames += term->nFrames;
+	sum->nCRCErrors += term->nCRCErrors;
+	sum->nDecodeErrors += term->nDecodeErrors;
+	sum->nTruncatedFrames += term->nTruncatedFrames;
+	sum->nSkippedBytes += term->nSkippedBytes;
+	sum->nTCPGaps += term->nTCPGaps;
+	sum->nVendorMessages += term->nVendorMessages;
+	for (size_t i = 0; i < sizeof (sum->messageCounts) / sizeof (sum->messageCounts[0]); ++i) {
+		sum->messageCounts[i] += term->messageCounts[i];
+	}
+}
+
+static void freeThreadContext(ThreadContextType* thread) {
+	for (size_t i = 0; i < thread->nObjects; ++i) {
+		free(thread->objects[i].timeline);
+	}
+	free(thread->objects);
+	free(thread->objectIndex);
+	memset(thread, 0, sizeof (*thread));
+}
+
+static int compareObjectContexts(const void* a, const void* b) {
+	const uint32_t idA = ((const ObjectContextType*) a)->statistics.transmitterID;
+	const uint32_t idB = ((const ObjectContextType*) b)->statistics.transmitterID;
+
+	return idA < idB ? -1 : idA > idB;
+}
+
+static int compareTimelineEntries(const void* a, const void* b) {
+	const uint64_t orderA = ((const TimelineEntryType*) a)->order;
+	const uint64_t orderB = ((const TimelineEntryType*) b)->order;
+
+	return orderA < orderB ? -1 : orderA > orderB;
+}
+
+
+static uint16_t readUint16(const uint8_t* p, const bool isBigEndian) {
+	return isBigEndian ? readBigEndian16(p) : (uint16_t) (p[0] | p[1] << 8);
+}
+
+static uint32_t readUint32(const uint8_t* p, const bool isBigEndian) {
+	return isBigEndian ? readBigEndian32(p)
+					   : (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+static uint16_t readBigEndian16(const uint8_t* p) {
+	return (uint16_t) (p[0] << 8 | p[1]);
+}
+
+static uint32_t readBigEndian32(const uint8_t* p) {
+	return (uint32_t) p[0] << 24 | (uint32_t) p[1] << 16 | (uint32_t) p[2] << 8 | (uint32_t) p[3];
+}
+
+//! FNV-1a
+static size_t hashBytes(const void* data, const size_t length) {
+	const uint8_t* p = data;
+	uint64_t hash = 0xCBF29CE484222325ULL;
+
+	for (size_t i = 0; i < length; ++i) {
+		hash = (hash ^ p[i]) * 0x100000001B3ULL;
+	}
+	return (size_t) hash;
+}
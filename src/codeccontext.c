@@ -0,0 +1,871 @@
+#include "codeccontext.h"
+#include "defines.h"
+#include "monr.h"
+#include "frame.h"
+#include "vendorregistry.h"
+
+#include <errno.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define ISO_ERROR_MESSAGE_MAX_LENGTH 256
+#define MESSAGE_COUNTER_INITIAL_CAPACITY 16
+
+typedef struct {
+	uint32_t receiverID;
+	uint8_t nextCounter;
+	bool isUsed;
+} MessageCounterEntryType;
+
+struct ISOCodecContext {
+	bool isCRCVerificationEnabled;
+	char debug;
+	uint8_t protocolVersions[ISO_CODEC_MAX_PROTOCOL_VERSIONS];
+	size_t nProtocolVersions;		//!< Zero if the supported protocol versions are accepted
+	uint16_t trajectoryCRC;			//!< Running CRC of the TRAJ message being encoded
+	uint8_t compressedTrajectoryVersion;	//!< CTRJ codec version accepted by the receiver, zero if none
+
+	MessageCounterEntryType* counters;	//!< Open addressing table, capacity is a power of two
+	size_t counterCapacity;
+	size_t nCounters;
+
+	_Atomic(ISOErrorCallbackType) errorCallback;
+	void* errorUserData;
+	uint32_t maxErrorReportsPerSecond;
+	atomic_int_fast64_t rateLimitWindow;
+	atomic_uint_fast32_t rateLimitCount;
+	atomic_uint_fast64_t suppressedReports;
+	ISOErrorType lastError;
+};
+
+static ISOCodecContextType defaultContext = {
+	.isCRCVerificationEnabled = DEFAULT_CRC_CHECK_ENABLED,
+	.trajectoryCRC = DEFAULT_CRC_INIT_VALUE
+};
+
+static _Thread_local ISOCodecContextType* activeContext = NULL;
+
+/*!
+ * \brief createISOCodecContext Create a context with CRC verification enabled, debugging disabled,
+ *			the supported protocol versions and no error callback of its own
+ * \return Allocated context, or NULL with errno set on failure
+ */
+ISOCodecContextType* createISOCodecContext(void) {
+	ISOCodecContextType* context = calloc(1, sizeof (*context));
+	if (context == NULL) {
+		return NULL;
+	}
+	context->isCRCVerificationEnabled = DEFAULT_CRC_CHECK_ENABLED;
+	context->trajectoryCRC = DEFAULT_CRC_INIT_VALUE;
+	atomic_init(&context->errorCallback, NULL);
+	context->lastError.code = MESSAGE_OK;
+	context->lastError.messageID = MESSAGE_ID_INVALID;
+	return context;
+}
+
+/*!
+ * \brief freeISOCodecContext Free a context created with ::createISOCodecContext
+ * \param context Context to free, may be NULL
+ */
+void freeISOCodecContext(ISOCodecContextType* context) {
+	if (context == NULL || context == &defaultContext) {
+		return;
+	}
+	free(context->counters);
+	free(context);
+}
+
+/*!
+ * \brief setCodecCRCVerification Enable or disable checksum verification of decoded messages
+ * \param context Context to configure
+ * \param enabled Boolean for enabling or disabling the checksum verification
+ */
+void setCodecCRCVerification(ISOCodecContextType* context, const bool enabled) {
+	context->isCRCVerificationEnabled = enabled;
+}
+
+/*!
+ * \brief setCodecDebug Set the debug flag passed to encoders and decoders called with the context
+ * \param context Context to configure
+ * \param debug Flag for enabling debugging
+ */
+void setCodecDebug(ISOCodecContextType* context, const char debug) {
+	context->debug = debug;
+}
+
+/*!
+ * \brief setCodecProtocolVersions Set the protocol versions accepted when decoding headers
+ * \param context Context to configure
+ * \param versions Accepted protocol versions
+ * \param nVersions Number of accepted protocol versions
+ * \return 0 on success, -1 with errno set to EINVAL if too many or no versions were given
+ */
+int setCodecProtocolVersions(ISOCodecContextType* context, const uint8_t* versions, const size_t nVersions) {
+	if (versions == NULL || nVersions == 0 || nVersions > ISO_CODEC_MAX_PROTOCOL_VERSIONS) {
+		errno = EINVAL;
+		return -1;
+	}
+	memcpy(context->protocolVersions, versions, nVersions * sizeof (versions[0]));
+	context->nProtocolVersions = nVersions;
+	return 0;
+}
+
+/*!
+ * \brief setCodecCompressedTrajectoryVersion Set the version of the compressed trajectory codec accepted
+ *			by the receiver, as announced in a CTRA message or known from configuration
+ * \param context Context to configure
+ * \param version Accepted codec version, or zero if trajectories are to be sent as plain TRAJ
+ */
+void setCodecCompressedTrajectoryVersion(ISOCodecContextType* context, const uint8_t version) {
+	context->compressedTrajectoryVersion = version;
+}
+
+/*!
+ * \brief getCodecCompressedTrajectoryVersion Get the version of the compressed trajectory codec accepted
+ *			by the receiver
+ * \param context Context to query
+ * \return Accepted codec version, or zero if trajectories are to be sent as plain TRAJ
+ */
+uint8_t getCodecCompressedTrajectoryVersion(const ISOCodecContextType* context) {
+	return context->compressedTrajectoryVersion;
+}
+
+/*!
+ * \brief setCodecErrorCallback Register a function to be called with errors reported while the context
+ *			is in use. Errors exceeding the rate limit within the same second are counted but not passed
+ *			on. Without a callback, errors are passed to the callback set by ::setISOErrorCallback.
+ * \param context Context to configure
+ * \param callback Function to call, or NULL to stop calling it
+ * \param userData Pointer passed on to the callback
+ * \param maxReportsPerSecond Maximum number of calls per second, or 0 for no limit
+ */
+void setCodecErrorCallback(ISOCodecContextType* context, ISOErrorCallbackType callback, void* userData,
+		const uint32_t maxReportsPerSecond) {
+	atomic_store_explicit(&context->errorCallback, NULL, memory_order_release);
+	context->errorUserData = userData;
+	context->maxErrorReportsPerSecond = maxReportsPerSecond;
+	atomic_store_explicit(&context->rateLimitWindow, 0, memory_order_relaxed);
+	atomic_store_explicit(&context->rateLimitCount, 0, memory_order_relaxed);
+	atomic_store_explicit(&context->suppressedReports, 0, memory_order_relaxed);
+	atomic_store_explicit(&context->errorCallback, callback, memory_order_release);
+}
+
+/*!
+ * \brief getCodecLastError Get the most recent error reported while the context was in use
+ * \param context Context to query
+ * \return Error description, with code MESSAGE_OK if no error was reported
+ */
+ISOErrorType getCodecLastError(const ISOCodecContextType* context) {
+	return context == &defaultContext ? getLastISOError() : context->lastError;
+}
+
+/*!
+ * \brief getCodecSuppressedErrorCount Get the number of errors not passed to the callback of the
+ *			context due to its rate limit
+ * \param context Context to query
+ * \return Number of suppressed errors
+ */
+uint64_t getCodecSuppressedErrorCount(const ISOCodecContextType* context) {
+	return atomic_load_explicit(&context->suppressedReports, memory_order_relaxed);
+}
+
+/*!
+ * \brief fillCodecMessageHeader Fill in a header for a message to a receiver, using the next message
+ *			counter value for that receiver
+ * \param context Context holding the message counters
+ * \param transmitterID ID of the sender
+ * \param receiverID ID of the receiver
+ * \param header Header to fill in
+ * \return 0 on success, -1 with errno set to ENOMEM on failure
+ */
+int fillCodecMessageHeader(ISOCodecContextType* context, const uint32_t transmitterID, const uint32_t receiverID,
+		MessageHeaderType* header) {
+	if (2 * (context->nCounters + 1) > context->counterCapacity) {
+		const size_t newCapacity = context->counterCapacity ? 2 * context->counterCapacity
+															: MESSAGE_COUNTER_INITIAL_CAPACITY;
+		MessageCounterEntryType* newCounters = calloc(newCapacity, sizeof (*newCounters));
+		if (newCounters == NULL) {
+			return -1;
+		}
+		for (size_t i = 0; i < context->counterCapacity; ++i) {
+			if (context->counters[i].isUsed) {
+				size_t j = (context->counters[i].receiverID * 0x9E3779B1u) & (newCapacity - 1);
+				while (newCounters[j].isUsed) {
+					j = (j + 1) & (newCapacity - 1);
+				}
+				newCounters[j] = context->counters[i];
+			}
+		}
+		free(context->counters);
+		context->counters = newCounters;
+		context->counterCapacity = newCapacity;
+	}
+
+	size_t i = (receiverID * 0x9E3779B1u) & (context->counterCapacity - 1);
+	while (context->counters[i].isUsed && context->counters[i].receiverID != receiverID) {
+		i = (i + 1) & (context->counterCapacity - 1);
+	}
+	if (!context->counters[i].isUsed) {
+		context->counters[i].isUsed = true;
+		context->counters[i].receiverID = receiverID;
+		context->nCounters++;
+	}
+	header->transmitterID = transmitterID;
+	header->receiverID = receiverID;
+	header->messageCounter = context->counters[i].nextCounter++;
+	return 0;
+}
+
+/*!
+ * \brief getActiveCodecContext Get the context of the encoder or decoder running on the calling thread
+ * \return The context passed to the running function, or the default context
+ */
+ISOCodecContextType* getActiveCodecContext(void) {
+	return activeContext != NULL ? activeContext : &defaultContext;
+}
+
+/*!
+ * \brief getDefaultCodecContext Get the context used by functions without a context argument
+ * \return The default context
+ */
+ISOCodecContextType* getDefaultCodecContext(void) {
+	return &defaultContext;
+}
+
+/*!
+ * \brief isCodecCRCVerificationEnabled Check if checksums of decoded messages are to be verified
+ * \param context Context to query
+ * \return true if checksums are verified, false otherwise
+ */
+bool isCodecCRCVerificationEnabled(const ISOCodecContextType* context) {
+	return context->isCRCVerificationEnabled;
+}
+
+/*!
+ * \brief isCodecProtocolVersionSupported Check if a protocol version is accepted when decoding headers
+ * \param context Context to query
+ * \param version Protocol version of a received message
+ * \return true if the version is accepted, false otherwise
+ */
+bool isCodecProtocolVersionSupported(const ISOCodecContextType* context, const uint8_t version) {
+	if (context->nProtocolVersions == 0) {
+		for (size_t i = 0; i < sizeof (SupportedProtocolVersions) / sizeof (SupportedProtocolVersions[0]); ++i) {
+			if (SupportedProtocolVersions[i] == version) {
+				return true;
+			}
+		}
+		return false;
+	}
+	for (size_t i = 0; i < context->nProtocolVersions; ++i) {
+		if (context->protocolVersions[i] == version) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/*!
+ * \brief getCodecTrajectoryCRC Get the running CRC of the TRAJ message being encoded using the context
+ * \param context Context to query
+ * \return Pointer to the CRC
+ */
+uint16_t* getCodecTrajectoryCRC(ISOCodecContextType* context) {
+	return &context->trajectoryCRC;
+}
+
+/*!
+ * \brief isWithinRateLimit Check if another error may be passed to the callback during the current second
+ * \param context Context whose callback is to be called
+ * \return true if the error may be passed on, false otherwise
+ */
+static bool isWithinRateLimit(ISOCodecContextType* context) {
+	if (context->maxErrorReportsPerSecond == 0) {
+		return true;
+	}
+
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+	int_fast64_t window = atomic_load_explicit(&context->rateLimitWindow, memory_order_relaxed);
+	if (window != now.tv_sec
+			&& atomic_compare_exchange_strong_explicit(&context->rateLimitWindow, &window, now.tv_sec,
+													   memory_order_relaxed, memory_order_relaxed)) {
+		atomic_store_explicit(&context->rateLimitCount, 0, memory_order_relaxed);
+	}
+	if (atomic_fetch_add_explicit(&context->rateLimitCount, 1, memory_order_relaxed)
+			< context->maxErrorReportsPerSecond) {
+		return true;
+	}
+	atomic_fetch_add_explicit(&context->suppressedReports, 1, memory_order_relaxed);
+	return false;
+}
+
+/*!
+ * \brief passErrorToCodecSink Record an error in the context and, if a callback is registered and
+ *			the rate limit allows, format the message and pass it on
+ * \param context Context in use when the error was detected
+ * \param error Error description
+ * \param format printf style format of the error message
+ * \param args Arguments to the format
+ */
+void passErrorToCodecSink(ISOCodecContextType* context, const ISOErrorType* error, const char* format,
+		va_list args) {
+	if (context != &defaultContext) {
+		context->lastError = *error;
+	}
+
+	ISOErrorCallbackType callback = atomic_load_explicit(&context->errorCallback, memory_order_acquire);
+	if (callback == NULL && context != &defaultContext) {
+		context = &defaultContext;
+		callback = atomic_load_explicit(&context->errorCallback, memory_order_acquire);
+	}
+	if (callback == NULL || !isWithinRateLimit(context)) {
+		return;
+	}
+
+	char message[ISO_ERROR_MESSAGE_MAX_LENGTH];
+	vsnprintf(message, sizeof (message), format, args);
+	callback(error, message, context->errorUserData);
+}
+
+/*!
+ * \brief enterCodecContext Make a context active on the calling thread
+ * \param context Context to activate
+ * \return The previously active context, to be restored with ::leaveCodecContext
+ */
+static ISOCodecContextType* enterCodecContext(ISOCodecContextType* context) {
+	ISOCodecContextType* previous = activeContext;
+	activeContext = context;
+	return previous;
+}
+
+/*!
+ * \brief leaveCodecContext Restore the context active before ::enterCodecContext
+ * \param previous Context returned by ::enterCodecContext
+ */
+static void leaveCodecContext(ISOCodecContextType* previous) {
+	activeContext = previous;
+}
+
+ssize_t encodeMONRMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const struct timeval* objectTime, const CartesianPosition position, const SpeedType speed,
+		const AccelerationType acceleration, const unsigned char driveDirection, const unsigned char objectState,
+		const unsigned char readyToArm, const unsigned char objectErrorState, const unsigned short errorCode,
+		char* monrDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeMONRMessage(inputHeader, objectTime, position, speed, acceleration, driveDirection,
+			objectState, readyToArm, objectErrorState, errorCode, monrDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeMONRMessageCtx(ISOCodecContextType* context, const char* monrDataBuffer, const size_t bufferLength,
+		const struct timeval currentTime, ObjectMonitorType* monitorData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeMONRMessage(monrDataBuffer, bufferLength, currentTime, monitorData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeTRAJMessageHeaderCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const uint16_t trajectoryID, const TrajectoryInfoType trajectoryInfo, const char* trajectoryName,
+		const size_t nameLength, const uint32_t numberOfPointsInTraj, char* trajDataBuffer,
+		const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeTRAJMessageHeader(inputHeader, trajectoryID, trajectoryInfo, trajectoryName, nameLength,
+			numberOfPointsInTraj, trajDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeTRAJMessagePointCtx(ISOCodecContextType* context, const struct timeval* pointTimeFromStart,
+		const CartesianPosition position, const SpeedType speed, const AccelerationType acceleration,
+		const float curvature, char* trajDataBufferPointer, const size_t remainingBufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeTRAJMessagePoint(pointTimeFromStart, position, speed, acceleration, curvature,
+			trajDataBufferPointer, remainingBufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeTRAJMessagePointCtx(ISOCodecContextType* context, TrajectoryWaypointType* wayPoints,
+		const char* trajDataBuffer) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeTRAJMessagePoint(wayPoints, trajDataBuffer, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeTRAJMessagePointBoundedCtx(ISOCodecContextType* context, TrajectoryWaypointType* wayPoints,
+		const char* trajDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeTRAJMessagePointBounded(wayPoints, trajDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeTRAJMessageFooterCtx(ISOCodecContextType* context, char* trajDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeTRAJMessageFooter(trajDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeTRAJMessageHeaderCtx(ISOCodecContextType* context, TrajectoryHeaderType* trajHeader,
+		const char* trajDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeTRAJMessageHeader(trajHeader, trajDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeSTRTMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const StartMessageType* startData, char* strtDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeSTRTMessage(inputHeader, startData, strtDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeSTRTMessageCtx(ISOCodecContextType* context, const char* strtDataBuffer, const size_t bufferLength,
+		const struct timeval* currentTime, StartMessageType* startData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeSTRTMessage(strtDataBuffer, bufferLength, currentTime, startData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeOSEMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const ObjectSettingsType* objectSettingsData, char* osemDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeOSEMMessage(inputHeader, objectSettingsData, osemDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeOSEMMessageCtx(ISOCodecContextType* context, ObjectSettingsType* objectSettingsData,
+		const char* osemDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeOSEMMessage(objectSettingsData, osemDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeOSTMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const enum ObjectCommandType command, char* ostmDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeOSTMMessage(inputHeader, command, ostmDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeOSTMMessageCtx(ISOCodecContextType* context, const char* ostmDataBuffer, const size_t bufferLength,
+		enum ObjectCommandType* command) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeOSTMMessage(ostmDataBuffer, bufferLength, command, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeHEABMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const struct timeval* heabTime, const enum ControlCenterStatusType status, char* heabDataBuffer,
+		const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeHEABMessage(inputHeader, heabTime, status, heabDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeHEABMessageCtx(ISOCodecContextType* context, const char* heabDataBuffer, const size_t bufferLength,
+		const struct timeval currentTime, HeabMessageDataType* heabData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeHEABMessage(heabDataBuffer, bufferLength, currentTime, heabData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeSYPMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const struct timeval synchronizationTime, const struct timeval freezeTime, char* sypmDataBuffer,
+		const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeSYPMMessage(inputHeader, synchronizationTime, freezeTime, sypmDataBuffer, bufferLength,
+			context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeMTSPMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const struct timeval* estSyncPointTime, char* mtspDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeMTSPMessage(inputHeader, estSyncPointTime, mtspDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeTRCMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const uint16_t* triggerID, const enum TriggerType_t* triggerType,
+		const enum TriggerTypeParameter_t* param1, const enum TriggerTypeParameter_t* param2,
+		const enum TriggerTypeParameter_t* param3, char* trcmDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeTRCMMessage(inputHeader, triggerID, triggerType, param1, param2, param3, trcmDataBuffer,
+			bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeACCMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const uint16_t* actionID, const enum ActionType_t* actionType, const enum ActionTypeParameter_t* param1,
+		const enum ActionTypeParameter_t* param2, const enum ActionTypeParameter_t* param3, char* accmDataBuffer,
+		const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeACCMMessage(inputHeader, actionID, actionType, param1, param2, param3, accmDataBuffer,
+			bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeEXACMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const uint16_t* actionID, const struct timeval* executionTime, char* exacDataBuffer,
+		const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeEXACMessage(inputHeader, actionID, executionTime, exacDataBuffer, bufferLength,
+			context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeRCMMMessageCtx(ISOCodecContextType* context, const char* rcmmDataBuffer, const size_t bufferLength,
+		RemoteControlManoeuvreMessageType* rcmmData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeRCMMMessage(rcmmDataBuffer, bufferLength, rcmmData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeRCMMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const RemoteControlManoeuvreMessageType* rcmmObjectData, char* rcmmDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeRCMMMessage(inputHeader, rcmmObjectData, rcmmDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeGREMMessageCtx(ISOCodecContextType* context, const char* gremDataBuffer, const size_t bufferLength,
+		GeneralResponseMessageType* gremData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeGREMMessage(gremDataBuffer, bufferLength, gremData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeGREMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const GeneralResponseMessageType* gremObjectData, char* gremDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeGREMMessage(inputHeader, gremObjectData, gremDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeDRESMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const TestObjectDiscoveryType* testObjectDiscoveryData, char* dresDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeDRESMessage(inputHeader, testObjectDiscoveryData, dresDataBuffer, bufferLength,
+			context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeDRESMessageCtx(ISOCodecContextType* context, const char* dresDataBuffer, const size_t bufferLength,
+		TestObjectDiscoveryType* testObjectDiscoveryData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeDRESMessage(dresDataBuffer, bufferLength, testObjectDiscoveryData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeDREQMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		char* dreqDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeDREQMessage(inputHeader, dreqDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeDREQMessageCtx(ISOCodecContextType* context, const char* dreqDataBuffer, const size_t bufferLength,
+		TestObjectDiscoveryRequestType* testObjectDiscoveryRequestData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeDREQMessage(dreqDataBuffer, bufferLength, testObjectDiscoveryRequestData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeINSUPMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const enum SupervisorCommandType command, char* insupDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeINSUPMessage(inputHeader, command, insupDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeDCTIMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const DctiMessageDataType* dctiData, char* dctiDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeDCTIMessage(inputHeader, dctiData, dctiDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+enum ISOMessageReturnValue decodeDCTIMessageCtx(ISOCodecContextType* context, const char* dctiDataBuffer,
+		const size_t bufferLength, DctiMessageDataType* dctiData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	enum ISOMessageReturnValue retval = decodeDCTIMessage(dctiDataBuffer, bufferLength, dctiData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+enum ISOMessageID getISOMessageTypeCtx(ISOCodecContextType* context, const char* messageData, const size_t length) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	enum ISOMessageID retval = getISOMessageType(messageData, length, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodePODIMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const PeerObjectInjectionType* peerObjectData, char* podiDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodePODIMessage(inputHeader, peerObjectData, podiDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodePODIMessageCtx(ISOCodecContextType* context, const char* podiDataBuffer, const size_t bufferLength,
+		const struct timeval currentTime, PeerObjectInjectionType* peerData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodePODIMessage(podiDataBuffer, bufferLength, currentTime, peerData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeOPROMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const ObjectPropertiesType* objectPropertiesData, char* oproDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeOPROMessage(inputHeader, objectPropertiesData, oproDataBuffer, bufferLength,
+			context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeOPROMessageCtx(ISOCodecContextType* context, ObjectPropertiesType* objectPropertiesData,
+		const char* oproDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeOPROMessage(objectPropertiesData, oproDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeFOPRMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const ForeignObjectPropertiesType* foreignObjectPropertiesData, char* foprDataBuffer,
+		const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeFOPRMessage(inputHeader, foreignObjectPropertiesData, foprDataBuffer, bufferLength,
+			context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeFOPRMessageCtx(ISOCodecContextType* context,
+		ForeignObjectPropertiesType* foreignObjectPropertiesData, const char* foprDataBuffer,
+		const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeFOPRMessage(foreignObjectPropertiesData, foprDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeRDCAMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const RequestControlActionType* requestControlActionData, char* rdcaDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeRDCAMessage(inputHeader, requestControlActionData, rdcaDataBuffer, bufferLength,
+			context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeRDCAMessageCtx(ISOCodecContextType* context, const char* rdcaDataBuffer,
+		RequestControlActionType* requestControlActionData, const size_t bufferLength,
+		const struct timeval currentTime) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeRDCAMessage(rdcaDataBuffer, requestControlActionData, bufferLength, currentTime,
+			context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeGDRMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const GdrmMessageDataType* gdrmData, char* gdrmDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeGDRMMessage(inputHeader, gdrmData, gdrmDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+enum ISOMessageReturnValue decodeGDRMMessageCtx(ISOCodecContextType* context, const char* gdrmDataBuffer,
+		const size_t bufferLength, GdrmMessageDataType* gdrmData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	enum ISOMessageReturnValue retval = decodeGDRMMessage(gdrmDataBuffer, bufferLength, gdrmData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeDCMMMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const RemoteControlManoeuvreMessageType* command, char* dcmmDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeDCMMMessage(inputHeader, command, dcmmDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeDCMMMessageCtx(ISOCodecContextType* context, const char* dcmmDataBuffer, const size_t bufferLength,
+		RemoteControlManoeuvreMessageType* dcmmData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeDCMMMessage(dcmmDataBuffer, bufferLength, dcmmData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeMONRMessageFromSampleCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const MonitorSampleType* sample, char* monrDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeMONRMessageFromSample(inputHeader, sample, monrDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeMONRMessageToSampleCtx(ISOCodecContextType* context, const char* monrDataBuffer,
+		const size_t bufferLength, const struct timeval currentTime, MonitorSampleType* sample) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeMONRMessageToSample(monrDataBuffer, bufferLength, currentTime, sample, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+enum ISOMessageReturnValue decodeISOHeaderCtx(ISOCodecContextType* context, const char* messageBuffer,
+		const size_t length, HeaderType* headerData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	enum ISOMessageReturnValue retval = decodeISOHeader(messageBuffer, length, headerData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t validateISOFrameCtx(ISOCodecContextType* context, const void* frame, const size_t length,
+		HeaderType* header) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = validateISOFrame(frame, length, header);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+size_t validateISOFramesCtx(ISOCodecContextType* context, const void* const frames[], const size_t lengths[],
+		const size_t nFrames, HeaderType headers[], ssize_t results[]) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	size_t retval = validateISOFrames(frames, lengths, nFrames, headers, results);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeVendorMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const uint16_t messageID, const void* messageData, char* buffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeVendorMessage(inputHeader, messageID, messageData, buffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeVendorMessageCtx(ISOCodecContextType* context, const char* buffer, const size_t bufferLength,
+		void* messageData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeVendorMessage(buffer, bufferLength, messageData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeMONR2MessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		const ObjectMonitor2Type* monitorData, char* monr2DataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeMONR2Message(inputHeader, monitorData, monr2DataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeMONR2MessageCtx(ISOCodecContextType* context, const char* monr2DataBuffer, const size_t bufferLength,
+		const struct timeval currentTime, ObjectMonitor2Type* monitorData) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeMONR2Message(monr2DataBuffer, bufferLength, currentTime, monitorData, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+size_t decodeMONR2MessagesCtx(ISOCodecContextType* context, const void* const frames[], const size_t lengths[],
+		const size_t nFrames, const struct timeval currentTime, ObjectMonitor2Type monitorData[], ssize_t results[]) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	size_t retval = decodeMONR2Messages(frames, lengths, nFrames, currentTime, monitorData, results);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeCTRJMessageCtx(ISOCodecContextType* context, TrajectoryCompressorType* compressor,
+		const MessageHeaderType* inputHeader, char* ctrjDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeCTRJMessage(compressor, inputHeader, ctrjDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t decodeCTRJMessageHeaderCtx(ISOCodecContextType* context, TrajectoryDecompressorType* decompressor,
+		TrajectoryHeaderType* trajHeader, const char* ctrjDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = decodeCTRJMessageHeader(decompressor, trajHeader, ctrjDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeCTRAMessageCtx(ISOCodecContextType* context, const MessageHeaderType* inputHeader,
+		char* ctraDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeCTRAMessage(inputHeader, ctraDataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
+
+/*!
+ * \brief decodeCTRAMessageCtx Decodes a CTRA message and records the announced codec version in the
+ *			context, so that ::encodeTrajectoryMessageCtx compresses trajectories sent to the object
+ * \param context Context of the link to the announcing object
+ * \param ctraDataBuffer Received message
+ * \param bufferLength Length of ctraDataBuffer
+ * \return Size of the message, or a negative value according to ::ISOMessageReturnValue
+ */
+ssize_t decodeCTRAMessageCtx(ISOCodecContextType* context, const char* ctraDataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	uint8_t codecVersion;
+	ssize_t retval = decodeCTRAMessage(ctraDataBuffer, bufferLength, &codecVersion, context->debug);
+	if (retval >= 0) {
+		context->compressedTrajectoryVersion = codecVersion;
+	}
+	leaveCodecContext(previous);
+	return retval;
+}
+
+ssize_t encodeTrajectoryMessageCtx(ISOCodecContextType* context, TrajectoryCompressorType* compressor,
+		const MessageHeaderType* inputHeader, const uint16_t trajectoryID, const TrajectoryInfoType trajectoryInfo,
+		const char* trajectoryName, const size_t nameLength, const TrajectoryWaypointType waypoints[],
+		const uint32_t nWaypoints, char* dataBuffer, const size_t bufferLength) {
+	ISOCodecContextType* previous = enterCodecContext(context);
+	ssize_t retval = encodeTrajectoryMessage(compressor, context->compressedTrajectoryVersion, inputHeader,
+											 trajectoryID, trajectoryInfo, trajectoryName, nameLength, waypoints,
+											 nWaypoints, dataBuffer, bufferLength, context->debug);
+	leaveCodecContext(previous);
+	return retval;
+}
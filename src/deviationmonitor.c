@@ -0,0 +1,505 @@
+#include "deviationmonitor.h"
+#include "trajectoryindex.h"
+#include "spatialindex.h"
+#include "isoerror.h"
+#include "dynamicarray.h"
+#include "timeconversions.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+//! Objects further than this from the path near the previous sample are projected onto the whole path
+#define DEVIATION_RELOCK_DISTANCE_M 5.0
+//! Segments whose squared distances differ by less than this are equally near
+#define DEVIATION_TIE_DISTANCE2_M2 1e-12
+
+//! Trajectory uploaded to an object, with the limits it was given and its progress along it
+typedef struct {
+	uint32_t transmitterID;
+	TrajectoryIndexType* trajectory;
+	SpatialIndexType* spatialIndex;
+	TrajectoryColumnsType columns;
+	double maxWayDeviation_m;
+	double maxLateralDeviation_m;
+	double maxYawDeviation_rad;
+	double minRequiredPositioningAccuracy_m;
+
+	TrajectoryCursorType timeCursor;	//!< Segment of the planned position
+	size_t pathSegment;					//!< Segment nearest to the previous position
+	bool isLocked;						//!< Whether the path segment can be searched from
+	unsigned int exceeded;				//!< Bit per ::DeviationEventKindType exceeded at the previous sample
+} DeviationObjectType;
+
+struct DeviationMonitor {
+	DeviationObjectType* objects;		//!< Sorted on transmitter ID
+	size_t nObjects, objectCapacity;
+	DeviationEventType* events;			//!< Not yet popped, oldest first
+	size_t nEvents, eventCapacity;
+	bool hasStartTime;
+	int64_t startTime_us;
+	DeviationStatisticsType statistics;
+};
+
+/*!
+ * \brief createDeviationMonitor Creates a monitor without trajectories
+ * \return The monitor, or NULL if it could not be allocated
+ */
+DeviationMonitorType* createDeviationMonitor(void) {
+	return calloc(1, sizeof (DeviationMonitorType));
+}
+
+static void freeDeviationObject(DeviationObjectType* object) {
+	freeTrajectoryIndex(object->trajectory);
+	freeSpatialIndex(object->spatialIndex);
+}
+
+/*!
+ * \brief freeDeviationMonitor Frees a monitor, its trajectories and pending events
+ * \param monitor Monitor to free, may be NULL
+ */
+void freeDeviationMonitor(DeviationMonitorType* monitor) {
+	if (monitor == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < monitor->nObjects; ++i) {
+		freeDeviationObject(&monitor->objects[i]);
+	}
+	free(monitor->objects);
+	free(monitor->events);
+	free(monitor);
+}
+
+static void resetDeviationProgress(DeviationObjectType* object) {
+	initTrajectoryCursor(&object->timeCursor, object->trajectory);
+	object->pathSegment = 0;
+	object->isLocked = false;
+	object->exceeded = 0;
+}
+
+/*!
+ * \brief resetDeviationMonitor Prepares a monitor for a new test run. Trajectories and limits are
+ *			kept, while the start time, progress of objects, pending events and statistics are cleared.
+ * \param monitor Monitor to reset
+ */
+void resetDeviationMonitor(DeviationMonitorType* monitor) {
+	for (size_t i = 0; i < monitor->nObjects; ++i) {
+		resetDeviationProgress(&monitor->objects[i]);
+	}
+	monitor->nEvents = 0;
+	monitor->hasStartTime = false;
+	memset(&monitor->statistics, 0, sizeof (monitor->statistics));
+}
+
+//! Index of an object, or where it would be inserted
+static size_t lowerBoundDeviationObject(const DeviationMonitorType* monitor, const uint32_t transmitterID) {
+	size_t low = 0, high = monitor->nObjects;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (monitor->objects[middle].transmitterID < transmitterID) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+//! Limits which are not positive are not checked
+static inline double toLimit(const double limit) {
+	return isfinite(limit) && limit > 0.0 ? limit : INFINITY;
+}
+
+/*!
+ * \brief setDeviationTrajectory Sets the trajectory and limits uploaded to an object, replacing any
+ *			previous ones
+ * \param monitor Monitor to add the trajectory to
+ * \param transmitterID Object following the trajectory
+ * \param waypoints Trajectory, e.g. decoded from TRAJ, with nondecreasing times and valid positions
+ * \param nWaypoints Number of waypoints, at least one
+ * \param settings Settings sent to the object in OSEM, whose maximum deviations and required
+ *			positioning accuracy are monitored. Limits which are not positive are not checked, and
+ *			if NULL, deviations are computed without raising events.
+ * \return 0 on success, -1 otherwise with errno set as for ::createTrajectoryIndex and
+ *			::createSpatialIndex
+ */
+int setDeviationTrajectory(
+		DeviationMonitorType* monitor,
+		const uint32_t transmitterID,
+		const TrajectoryWaypointType waypoints[],
+		const size_t nWaypoints,
+		const ObjectSettingsType* settings) {
+	DeviationObjectType object;
+
+	if (monitor == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	memset(&object, 0, sizeof (object));
+	object.transmitterID = transmitterID;
+	if ((object.spatialIndex = createSpatialIndex(waypoints, nWaypoints)) == NULL
+			|| (object.trajectory = createTrajectoryIndex(waypoints, nWaypoints)) == NULL) {
+		freeDeviationObject(&object);
+		return -1;
+	}
+	object.columns = getTrajectoryColumns(object.trajectory);
+	object.maxWayDeviation_m = settings != NULL ? toLimit(settings->maxDeviation.position_m) : INFINITY;
+	object.maxLateralDeviation_m = settings != NULL ? toLimit(settings->maxDeviation.lateral_m) : INFINITY;
+	object.maxYawDeviation_rad = settings != NULL ? toLimit(settings->maxDeviation.yaw_rad) : INFINITY;
+	object.minRequiredPositioningAccuracy_m = settings != NULL ? settings->minRequiredPositioningAccuracy_m : NAN;
+	resetDeviationProgress(&object);
+
+	const size_t i = lowerBoundDeviationObject(monitor, transmitterID);
+	if (i < monitor->nObjects && monitor->objects[i].transmitterID == transmitterID) {
+		freeDeviationObject(&monitor->objects[i]);
+	}
+	else {
+		if (RESERVE(monitor->objects, monitor->nObjects, monitor->objectCapacity) < 0) {
+			freeDeviationObject(&object);
+			return -1;
+		}
+		memmove(&monitor->objects[i + 1], &monitor->objects[i],
+				(monitor->nObjects - i) * sizeof (monitor->objects[0]));
+		monitor->nObjects++;
+	}
+	monitor->objects[i] = object;
+	return 0;
+}
+
+/*!
+ * \brief removeDeviationTrajectory Stops monitoring an object
+ * \param monitor Monitor holding the trajectory
+ * \param transmitterID Object to remove
+ * \return 0 on success, -1 if the object has no trajectory
+ */
+int removeDeviationTrajectory(
+		DeviationMonitorType* monitor,
+		const uint32_t transmitterID) {
+	if (monitor == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	const size_t i = lowerBoundDeviationObject(monitor, transmitterID);
+	if (i == monitor->nObjects || monitor->objects[i].transmitterID != transmitterID) {
+		errno = ENOENT;
+		return -1;
+	}
+	freeDeviationObject(&monitor->objects[i]);
+	memmove(&monitor->objects[i], &monitor->objects[i + 1],
+			(monitor->nObjects - i - 1) * sizeof (monitor->objects[0]));
+	monitor->nObjects--;
+	return 0;
+}
+
+/*!
+ * \brief setDeviationStartTime Sets the time at which all trajectories start, e.g. decoded from
+ *			STRT. Monitor data from before the start is not evaluated.
+ * \param monitor Monitor to set the start time of
+ * \param startData Start message contents, with a valid start time
+ * \return 0 on success, -1 otherwise
+ */
+int setDeviationStartTime(
+		DeviationMonitorType* monitor,
+		const StartMessageType* startData) {
+	if (monitor == NULL || startData == NULL || !startData->isTimestampValid) {
+		errno = EINVAL;
+		return -1;
+	}
+	monitor->startTime_us = timevalToMicroseconds(&startData->startTime);
+	monitor->hasStartTime = true;
+	for (size_t i = 0; i < monitor->nObjects; ++i) {
+		monitor->objects[i].timeCursor.segment = 0;
+	}
+	return 0;
+}
+
+static inline size_t nextPoint(const TrajectoryColumnsType* columns, const size_t i) {
+	return i + 1 < columns->nPoints ? i + 1 : i;
+}
+
+//! Squared distance from a position to a segment, and the fraction of the segment at which it is closest
+static inline double projectOntoSegment(const TrajectoryColumnsType* columns, const size_t i,
+										const double x, const double y, double* fraction) {
+	const size_t next = nextPoint(columns, i);
+	const double dx = columns->x_m[next] - columns->x_m[i];
+	const double dy = columns->y_m[next] - columns->y_m[i];
+	const double length2 = dx * dx + dy * dy;
+	double f = length2 > 0.0 ? ((x - columns->x_m[i]) * dx + (y - columns->y_m[i]) * dy) / length2 : 0.0;
+
+	f = f < 0.0 ? 0.0 : f > 1.0 ? 1.0 : f;
+	*fraction = f;
+	const double ex = columns->x_m[i] + f * dx - x;
+	const double ey = columns->y_m[i] + f * dy - y;
+	return ex * ex + ey * ey;
+}
+
+//! Whether to move to an adjacent segment, which on ties is the one nearer the planned segment
+static inline bool isNearer(const double distance2, const double current2,
+							const size_t segment, const size_t current, const size_t plannedSegment) {
+	if (fabs(distance2 - current2) < DEVIATION_TIE_DISTANCE2_M2) {
+		return segment > current ? current < plannedSegment : current > plannedSegment;
+	}
+	return distance2 < current2;
+}
+
+/*!
+ * \brief followPath Finds the segment nearest to an object by walking from the segment nearest to
+ *			its previous position, forward or backward while segments get nearer. Each sample thus
+ *			tests about as many segments as the object has passed since the previous. Where the path
+ *			overlaps itself, or stands still, equally near segments are told apart by the time at
+ *			which they are planned. Objects which are lost, or far from the path near their previous
+ *			position, are projected onto the whole path with the spatial index.
+ * \param monitor Monitor counting tested segments
+ * \param object Object to project, whose path segment is updated
+ * \param x Position of the object
+ * \param y Position of the object
+ * \param plannedSegment Segment of the planned position at the time of the sample
+ * \param fraction Of the nearest segment before the nearest point
+ * \return Squared distance to the nearest segment
+ */
+static double followPath(DeviationMonitorType* monitor, DeviationObjectType* object,
+						 const double x, const double y, const size_t plannedSegment, double* fraction) {
+	const TrajectoryColumnsType* columns = &object->columns;
+	const size_t lastSegment = columns->nPoints > 1 ? columns->nPoints - 2 : 0;
+	size_t segment = object->pathSegment;
+	double distance2 = INFINITY;
+
+	if (object->isLocked) {
+		double f;
+		distance2 = projectOntoSegment(columns, segment, x, y, fraction);
+		monitor->statistics.nSegmentsTested++;
+		while (segment < lastSegment) {
+			const double next2 = projectOntoSegment(columns, segment + 1, x, y, &f);
+			monitor->statistics.nSegmentsTested++;
+			if (!isNearer(next2, distance2, segment + 1, segment, plannedSegment)) {
+				break;
+			}
+			distance2 = next2;
+			*fraction = f;
+			segment++;
+		}
+		const bool hasMovedForward = segment != object->pathSegment;
+		while (!hasMovedForward && segment > 0) {
+			const double previous2 = projectOntoSegment(columns, segment - 1, x, y, &f);
+			monitor->statistics.nSegmentsTested++;
+			if (!isNearer(previous2, distance2, segment - 1, segment, plannedSegment)) {
+				break;
+			}
+			distance2 = previous2;
+			*fraction = f;
+			segment--;
+		}
+	}
+	if (distance2 > DEVIATION_RELOCK_DISTANCE_M * DEVIATION_RELOCK_DISTANCE_M) {
+		TrajectoryProjectionType projection;
+		projectOntoSpatialIndex(object->spatialIndex, x, y, &projection);
+		segment = projection.segment;
+		distance2 = projectOntoSegment(columns, segment, x, y, fraction);
+		monitor->statistics.nReacquisitions++;
+	}
+	object->pathSegment = segment;
+	object->isLocked = true;
+	return distance2;
+}
+
+//! Angle wrapped into [-π, π)
+static inline double wrapAngle(double angle_rad) {
+	angle_rad = fmod(angle_rad + M_PI, 2.0 * M_PI);
+	return angle_rad < 0.0 ? angle_rad + M_PI : angle_rad - M_PI;
+}
+
+/*!
+ * \brief evaluateDeviation Computes the deviations of an object from its trajectory
+ * \param monitor Monitor counting tested segments
+ * \param object Object whose progress is updated
+ * \param position Position of the object, which must be valid
+ * \param relativeTime_us Time since the start
+ * \param deviation Computed deviations
+ */
+static void evaluateDeviation(DeviationMonitorType* monitor, DeviationObjectType* object,
+							  const CartesianPosition* position, int64_t relativeTime_us,
+							  TrajectoryDeviationType* deviation) {
+	const TrajectoryColumnsType* columns = &object->columns;
+	const double x = position->xCoord_m, y = position->yCoord_m;
+
+	// Planned position at the time, clamped to the end of the trajectory
+	const int64_t endTime_us = columns->time_us[columns->nPoints - 1];
+	relativeTime_us = relativeTime_us < endTime_us ? relativeTime_us : endTime_us;
+	const size_t i = seekTrajectoryCursor(&object->timeCursor, relativeTime_us);
+	const size_t next = nextPoint(columns, i);
+	const int64_t duration_us = columns->time_us[next] - columns->time_us[i];
+	double fraction = duration_us > 0 ? (double) (relativeTime_us - columns->time_us[i]) / (double) duration_us
+									  : 0.0;
+	fraction = fraction < 0.0 ? 0.0 : fraction > 1.0 ? 1.0 : fraction;
+	deviation->trajectoryTime = microsecondsToTimeval(relativeTime_us);
+	deviation->wayDeviation_m = hypot(columns->x_m[i] + fraction * (columns->x_m[next] - columns->x_m[i]) - x,
+									  columns->y_m[i] + fraction * (columns->y_m[next] - columns->y_m[i]) - y);
+
+	// Nearest point of the path, regardless of time
+	const double distance2 = followPath(monitor, object, x, y, i, &fraction);
+	const size_t segment = object->pathSegment;
+	const size_t segmentEnd = nextPoint(columns, segment);
+	const double dx = columns->x_m[segmentEnd] - columns->x_m[segment];
+	const double dy = columns->y_m[segmentEnd] - columns->y_m[segment];
+	const double cross = dx * (y - columns->y_m[segment]) - dy * (x - columns->x_m[segment]);
+	deviation->segment = segment;
+	deviation->lateralDeviation_m = cross < 0.0 ? -sqrt(distance2) : sqrt(distance2);
+
+	if (position->isHeadingValid) {
+		const double pathHeading_rad = columns->heading_rad[segment]
+				+ fraction * wrapAngle(columns->heading_rad[segmentEnd] - columns->heading_rad[segment]);
+		deviation->yawDeviation_rad = wrapAngle(position->heading_rad - pathHeading_rad);
+	}
+	else {
+		deviation->yawDeviation_rad = NAN;
+	}
+}
+
+/*!
+ * \brief raiseDeviationEvent Queues an event if a limit has become exceeded since the previous sample
+ * \param monitor Monitor holding the event queue
+ * \param object Object whose exceeded limits are updated
+ * \param kind Limit checked
+ * \param isExceeded Whether the limit is exceeded at this sample
+ * \param deviation Magnitude of the deviation
+ * \param limit Limit checked against
+ * \param sampleTime_us Time of the sample
+ * \return 0 on success, -1 if the event could not be queued
+ */
+static int raiseDeviationEvent(DeviationMonitorType* monitor, DeviationObjectType* object,
+							   const DeviationEventKindType kind, const bool isExceeded,
+							   const double deviation, const double limit, const int64_t sampleTime_us) {
+	const unsigned int bit = 1u << kind;
+	const bool wasExceeded = (object->exceeded & bit) != 0;
+
+	object->exceeded = isExceeded ? object->exceeded | bit : object->exceeded & ~bit;
+	if (!isExceeded || wasExceeded) {
+		return 0;
+	}
+	if (RESERVE(monitor->events, monitor->nEvents, monitor->eventCapacity) < 0) {
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_MONR, 0,
+						 "Unable to queue deviation event for object %u", object->transmitterID);
+		return -1;
+	}
+	DeviationEventType* event = &monitor->events[monitor->nEvents++];
+	event->transmitterID = object->transmitterID;
+	event->kind = kind;
+	event->deviation = deviation;
+	event->limit = limit;
+	event->sampleTime = microsecondsToTimeval(sampleTime_us);
+	monitor->statistics.nEvents++;
+	return 0;
+}
+
+/*!
+ * \brief processDeviationMonitorData Computes the deviations of an object from its trajectory, and
+ *			queues an event for each limit that has become exceeded. Monitor data from objects without
+ *			a trajectory, without a valid position or from before the start is not evaluated.
+ * \param monitor Monitor holding the trajectories
+ * \param transmitterID Object the monitor data is from
+ * \param monitorData Monitor data, e.g. decoded from MONR
+ * \param receiveTime Time the monitor data was received, used if it has no valid timestamp
+ * \param deviation Computed deviations, may be NULL. Unchanged if the data is not evaluated.
+ * \return 1 if the data was evaluated, 0 if not, or -1 on error
+ */
+int processDeviationMonitorData(
+		DeviationMonitorType* monitor,
+		const uint32_t transmitterID,
+		const ObjectMonitorType* monitorData,
+		const struct timeval* receiveTime,
+		TrajectoryDeviationType* deviation) {
+	TrajectoryDeviationType result;
+	int retval = 0;
+
+	if (monitor == NULL || monitorData == NULL || receiveTime == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	monitor->statistics.nMonitorSamples++;
+
+	const size_t i = lowerBoundDeviationObject(monitor, transmitterID);
+	if (i == monitor->nObjects || monitor->objects[i].transmitterID != transmitterID
+			|| !monitor->hasStartTime || !monitorData->position.isPositionValid
+			|| !isfinite(monitorData->position.xCoord_m) || !isfinite(monitorData->position.yCoord_m)) {
+		return 0;
+	}
+	const int64_t sampleTime_us = monitorData->isTimestampValid ? timevalToMicroseconds(&monitorData->timestamp)
+																: timevalToMicroseconds(receiveTime);
+	if (sampleTime_us < monitor->startTime_us) {
+		return 0;
+	}
+	DeviationObjectType* object = &monitor->objects[i];
+	evaluateDeviation(monitor, object, &monitorData->position, sampleTime_us - monitor->startTime_us, &result);
+	result.transmitterID = transmitterID;
+	result.sampleTime = microsecondsToTimeval(sampleTime_us);
+	monitor->statistics.nEvaluations++;
+
+	retval |= raiseDeviationEvent(monitor, object, DEVIATION_EVENT_WAY,
+								  result.wayDeviation_m > object->maxWayDeviation_m,
+								  result.wayDeviation_m, object->maxWayDeviation_m, sampleTime_us);
+	retval |= raiseDeviationEvent(monitor, object, DEVIATION_EVENT_LATERAL,
+								  fabs(result.lateralDeviation_m) > object->maxLateralDeviation_m,
+								  fabs(result.lateralDeviation_m), object->maxLateralDeviation_m, sampleTime_us);
+	if (!isnan(result.yawDeviation_rad)) {
+		retval |= raiseDeviationEvent(monitor, object, DEVIATION_EVENT_YAW,
+									  fabs(result.yawDeviation_rad) > object->maxYawDeviation_rad,
+									  fabs(result.yawDeviation_rad), object->maxYawDeviation_rad, sampleTime_us);
+	}
+	// Positioning accuracy is only known to the object, which reports when it is insufficient
+	if (!isnan(object->minRequiredPositioningAccuracy_m)) {
+		retval |= raiseDeviationEvent(monitor, object, DEVIATION_EVENT_POSITIONING_ACCURACY,
+									  monitorData->error.badPositioningAccuracy,
+									  NAN, object->minRequiredPositioningAccuracy_m, sampleTime_us);
+	}
+	if (deviation != NULL) {
+		*deviation = result;
+	}
+	return retval < 0 ? -1 : 1;
+}
+
+/*!
+ * \brief popDeviationEvents Gets the oldest pending events, and removes them from the monitor
+ * \param monitor Monitor holding the events
+ * \param events Array in which to store the events
+ * \param maxEvents Number of events the array can hold
+ * \return Number of events stored, or zero with errno set if the monitor is invalid
+ */
+size_t popDeviationEvents(
+		DeviationMonitorType* monitor,
+		DeviationEventType events[],
+		const size_t maxEvents) {
+	if (monitor == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_INVALID, 0, "Invalid deviation monitor");
+		return 0;
+	}
+	const size_t nPopped = monitor->nEvents < maxEvents ? monitor->nEvents : maxEvents;
+
+	if (nPopped == 0) {
+		return 0;
+	}
+	memcpy(events, monitor->events, nPopped * sizeof (*events));
+	memmove(monitor->events, &monitor->events[nPopped], (monitor->nEvents - nPopped) * sizeof (*events));
+	monitor->nEvents -= nPopped;
+	return nPopped;
+}
+
+/*!
+ * \brief getDeviationStatistics Gets counters of evaluated samples and raised events since the
+ *			monitor was created or reset
+ * \param monitor Monitor to read
+ * \return Statistics of the monitor, or zeroed statistics with errno set if the monitor is invalid
+ */
+DeviationStatisticsType getDeviationStatistics(const DeviationMonitorType* monitor) {
+	const DeviationStatisticsType noStatistics = { 0 };
+
+	if (monitor == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_INVALID, 0, "Invalid deviation monitor");
+		return noStatistics;
+	}
+	return monitor->statistics;
+}
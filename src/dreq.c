@@ -4,6 +4,15 @@
 #include <errno.h>
 #include "iso22133.h"
 #include "dreq.h"
+#include "isoerror.h"
+
+/*!
+ * \brief getEncodedSizeDREQMessage Get the size of an encoded DREQ message
+ * \return Number of bytes written by ::encodeDREQMessage
+ */
+size_t getEncodedSizeDREQMessage(void) {
+	return sizeof (DREQType);
+}
 
 /*!
  * \brief encodeDREQMessage Constructs an ISO DREQ message based on specified command (DREQ contains no message data)
@@ -19,11 +28,11 @@ ssize_t encodeDREQMessage(const MessageHeaderType *inputHeader,
 	const char debug)
 {
 	DREQType DREQData;
-	memset(dreqDataBuffer, 0, bufferLength);
 
 	// Check so buffer can hold message
 	if (bufferLength < sizeof (DREQData)) {
-		fprintf(stderr, "Buffer too small to hold necessary DREQ data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_DREQ, 0,
+						 "Buffer too small to hold necessary DREQ data");
 		return -1;
 	}
 
@@ -66,7 +75,8 @@ ssize_t decodeDREQMessage(
 
 	if (dreqDataBuffer == NULL || testObjectDiscoveryRequestData == NULL) {
 	 	errno = EINVAL;
-	 	fprintf(stderr, "Input pointers to DREQ parsing function cannot be null\n");
+	 	ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_DREQ, 0,
+	 					 "Input pointers to DREQ parsing function cannot be null");
 	 	return ISO_FUNCTION_ERROR;
 	}
 
@@ -80,7 +90,8 @@ ssize_t decodeDREQMessage(
 
 	// If message is not a DREQ message, generate an error
 	if (DREQData.header.messageID != MESSAGE_ID_DREQ) {
-	 	fprintf(stderr, "Attempted to pass non-DREQ message into DREQ parsing function\n");
+	 	ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_DREQ, (size_t) (p - dreqDataBuffer),
+	 					 "Attempted to pass non-DREQ message into DREQ parsing function");
 		testObjectDiscoveryRequestData->requestStatus = DREQ_NOT_RECEIVED;
 	 	return MESSAGE_TYPE_ERROR;
 	} else {
@@ -91,14 +102,15 @@ ssize_t decodeDREQMessage(
 	if ((retval =
 	 	 decodeISOFooter(p, bufferLength - (size_t) (p - dreqDataBuffer), &DREQData.footer,
 	 					 debug)) != MESSAGE_OK) {
-	 	fprintf(stderr, "Error decoding DREQ footer\n");
+	 	ISO_REPORT_ERROR(retval, MESSAGE_ID_DREQ, (size_t) (p - dreqDataBuffer),
+	 					 "Error decoding DREQ footer");
 	 	return retval;
 	 }
 	 p += sizeof (DREQData.footer);
 
 	if ((retval = verifyChecksum(dreqDataBuffer, DREQData.header.messageLength + sizeof (HeaderType),
 	 							 DREQData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-	 	fprintf(stderr, "DREQ checksum error\n");
+	 	ISO_REPORT_ERROR(retval, MESSAGE_ID_DREQ, (size_t) (p - dreqDataBuffer), "DREQ checksum error");
 	 	return retval;
 	}
 
@@ -4,6 +4,15 @@
 #include <errno.h>
 #include "iso22133.h"
 #include "dres.h"
+#include "isoerror.h"
+
+/*!
+ * \brief getEncodedSizeDRESMessage Get the size of an encoded DRES message
+ * \return Number of bytes written by ::encodeDRESMessage
+ */
+size_t getEncodedSizeDRESMessage(void) {
+	return sizeof (DRESType);
+}
 
 /*!
  * \brief encodeDRESMessage Constructs an ISO DRES message based on specified command
@@ -24,11 +33,10 @@ ssize_t encodeDRESMessage(
 
 	DRESType DRESData;
 
-	memset(dresDataBuffer, 0, bufferLength);
-
 	// Check so buffer can hold message
 	if (bufferLength < sizeof (DRESData)) {
-		fprintf(stderr, "Buffer too small to hold necessary DRES data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_DRES, 0,
+						 "Buffer too small to hold necessary DRES data");
 		return -1;
 	}
 
@@ -38,28 +46,28 @@ ssize_t encodeDRESMessage(
 	// Fill contents
     DRESData.vendorNameValueID = VALUE_ID_VENDOR_NAME;
     DRESData.vendorNameContentLength = sizeof(DRESData.vendorName);
-    memset(DRESData.vendorName, 0, strlen(DRESData.vendorName));
+    memset(DRESData.vendorName, 0, sizeof(DRESData.vendorName));
 	memcpy(DRESData.vendorName, &testObjectDiscoveryData->vendor, strlen(testObjectDiscoveryData->vendor));
     DRESData.vendorNameValueID = htole16(DRESData.vendorNameValueID);
     DRESData.vendorNameContentLength = htole16(DRESData.vendorNameContentLength);
 
     DRESData.productNameValueID = VALUE_ID_PRODUCT_NAME;
     DRESData.productNameContentLength = sizeof(DRESData.productName);
-    memset(DRESData.productName, 0, strlen(DRESData.productName));
+    memset(DRESData.productName, 0, sizeof(DRESData.productName));
 	memcpy(DRESData.productName, &testObjectDiscoveryData->productName, strlen(testObjectDiscoveryData->productName));
     DRESData.productNameValueID = htole16(DRESData.productNameValueID);
     DRESData.productNameContentLength = htole16(DRESData.productNameContentLength);
 
     DRESData.firmwareVersionValueID = VALUE_ID_FIRMWARE_VERSION;
-    DRESData.firmwareVersionContentLength = sizeof(DRESData.firmwareVersionContentLength);
-    memset(DRESData.firmwareVersion, 0, strlen(DRESData.firmwareVersion));
+    DRESData.firmwareVersionContentLength = sizeof(DRESData.firmwareVersion);
+    memset(DRESData.firmwareVersion, 0, sizeof(DRESData.firmwareVersion));
 	memcpy(DRESData.firmwareVersion, &testObjectDiscoveryData->firmwareVersion, strlen(testObjectDiscoveryData->firmwareVersion));
     DRESData.firmwareVersionValueID = htole16(DRESData.firmwareVersionValueID);
     DRESData.firmwareVersionContentLength = htole16(DRESData.firmwareVersionContentLength);
 
     DRESData.testObjectNameValueID = VALUE_ID_TEST_OBJECT_NAME;
-    DRESData.testObjectNameContentLength = sizeof(DRESData.testObjectNameContentLength);
-    memset(DRESData.testObjectName, 0, strlen(DRESData.testObjectName));
+    DRESData.testObjectNameContentLength = sizeof(DRESData.testObjectName);
+    memset(DRESData.testObjectName, 0, sizeof(DRESData.testObjectName));
 	memcpy(DRESData.testObjectName, &testObjectDiscoveryData->testObjectName, strlen(testObjectDiscoveryData->testObjectName));
     DRESData.testObjectNameValueID = htole16(DRESData.testObjectNameValueID);
     DRESData.testObjectNameContentLength = htole16(DRESData.testObjectNameContentLength);
@@ -71,7 +79,7 @@ ssize_t encodeDRESMessage(
     DRESData.testObjectTypeContentLength = htole16(DRESData.testObjectTypeContentLength);
 
     DRESData.subDeviceIdTypeValueID = VALUE_ID_SUB_DEVICE_ID;
-    DRESData.subDeviceIdTypeContentLength = sizeof(DRESData.subDeviceIdTypeContentLength);
+    DRESData.subDeviceIdTypeContentLength = sizeof(DRESData.subDeviceId);
     DRESData.subDeviceId = testObjectDiscoveryData->subDeviceId;
     DRESData.subDeviceIdTypeValueID = htole16(DRESData.subDeviceIdTypeValueID);
     DRESData.subDeviceIdTypeContentLength = htole16(DRESData.subDeviceIdTypeContentLength);
@@ -130,7 +138,8 @@ ssize_t decodeDRESMessage(
 
 	if (dresDataBuffer == NULL || testObjectDiscoveryData == NULL) {
 	 	errno = EINVAL;
-	 	fprintf(stderr, "Input pointers to OSTM parsing function cannot be null\n");
+	 	ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_DRES, 0,
+	 					 "Input pointers to OSTM parsing function cannot be null");
 	 	return ISO_FUNCTION_ERROR;
 	}
 
@@ -144,12 +153,14 @@ ssize_t decodeDRESMessage(
 
 	// If message is not a DRES message, generate an error
 	if (DRESData.header.messageID != MESSAGE_ID_DRES) {
-	 	fprintf(stderr, "Attempted to pass non-DRES message into DRES parsing function\n");
+	 	ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_DRES, (size_t) (p - dresDataBuffer),
+	 					 "Attempted to pass non-DRES message into DRES parsing function");
 	 	return MESSAGE_TYPE_ERROR;
 	 }
 
 	if (DRESData.header.messageLength > sizeof (DRESType) - sizeof (HeaderType) - sizeof (FooterType)) {
-		fprintf(stderr, "DRES message exceeds expected message length\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_DRES, (size_t) (p - dresDataBuffer),
+						 "DRES message exceeds expected message length");
 		return MESSAGE_LENGTH_ERROR;
 	}
 
@@ -203,14 +214,16 @@ ssize_t decodeDRESMessage(
 	 		expectedContentLength = sizeof (DRESData.subDeviceId);
 	 		break;
 	 	default:
-	 		fprintf(stderr, "Value ID 0x%x does not match any known DRES value IDs", valueID);
+	 		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_DRES, (size_t) (p - dresDataBuffer),
+	 						 "Value ID 0x%x does not match any known DRES value IDs", valueID);
 			return MESSAGE_VALUE_ID_ERROR;
 	 	}
 
 	 	p += contentLength;
 	 	if (contentLength != expectedContentLength) {
-	 		fprintf(stderr, "Content length %u for value ID 0x%x does not match the expected %ld",
-	 				contentLength, valueID, expectedContentLength);
+	 		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_DRES, (size_t) (p - dresDataBuffer),
+	 						 "Content length %u for value ID 0x%x does not match the expected %ld",
+	 						 contentLength, valueID, expectedContentLength);
 	 		return MESSAGE_LENGTH_ERROR;
 	 	}
 	}
@@ -219,14 +232,15 @@ ssize_t decodeDRESMessage(
 	if ((retval =
 	 	 decodeISOFooter(p, bufferLength - (size_t) (p - dresDataBuffer), &DRESData.footer,
 	 					 debug)) != MESSAGE_OK) {
-	 	fprintf(stderr, "Error decoding DRES footer\n");
+	 	ISO_REPORT_ERROR(retval, MESSAGE_ID_DRES, (size_t) (p - dresDataBuffer),
+	 					 "Error decoding DRES footer");
 	 	return retval;
 	 }
 	 p += sizeof (DRESData.footer);
 
 	if ((retval = verifyChecksum(dresDataBuffer, DRESData.header.messageLength + sizeof (HeaderType),
 	 							 DRESData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-	 	fprintf(stderr, "DRES checksum error\n");
+	 	ISO_REPORT_ERROR(retval, MESSAGE_ID_DRES, (size_t) (p - dresDataBuffer), "DRES checksum error");
 	 	return retval;
 	}
 
@@ -0,0 +1,29 @@
+#include "dynamicarray.h"
+#include <errno.h>
+#include <stdlib.h>
+
+#define DYNAMIC_ARRAY_INITIAL_CAPACITY 8
+
+/*!
+ * \brief reserveArray Makes room for one more element in a dynamic array, doubling its capacity
+ *			when it is full
+ * \param array Array to enlarge
+ * \param capacity Number of elements allocated
+ * \param count Number of elements used
+ * \param elementSize Size of one element
+ * \return 0 on success, -1 with errno set to ENOMEM otherwise
+ */
+int reserveArray(void** array, size_t* capacity, const size_t count, const size_t elementSize) {
+	if (count < *capacity) {
+		return 0;
+	}
+	const size_t newCapacity = *capacity == 0 ? DYNAMIC_ARRAY_INITIAL_CAPACITY : 2 * *capacity;
+	void* grown = realloc(*array, newCapacity * elementSize);
+	if (grown == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+	*array = grown;
+	*capacity = newCapacity;
+	return 0;
+}
@@ -0,0 +1,357 @@
+#include "fleetevaluator.h"
+#include "trajectoryindex.h"
+#include "isoerror.h"
+#include "timeconversions.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FLEET_INITIAL_CAPACITY 16
+
+//! Interpolated fields held in double columns
+enum {
+	FLEET_X,
+	FLEET_Y,
+	FLEET_Z,
+	FLEET_HEADING,
+	FLEET_LONGITUDINAL_SPEED,
+	FLEET_LATERAL_SPEED,
+	FLEET_LONGITUDINAL_ACCELERATION,
+	FLEET_LATERAL_ACCELERATION,
+	FLEET_N_FIELDS
+};
+
+//! Columns of the trajectory of one object
+typedef struct {
+	size_t nPoints;
+	const int64_t* time_us;
+	const double* field[FLEET_N_FIELDS];
+	const float* curvature;
+} FleetColumnsType;
+
+struct FleetEvaluator {
+	size_t nObjects, capacity;
+	uint32_t* transmitterID;			//!< Sorted
+	TrajectoryIndexType** indices;
+	TrajectoryCursorType* cursors;
+	FleetColumnsType* columns;
+
+	bool hasStartTime;
+	int64_t startTime_us;
+
+	//! Per evaluation columns, in one allocation of the capacity
+	void* frame;
+	double* state[FLEET_N_FIELDS];
+	double* delta[FLEET_N_FIELDS];		//!< Change of each field over the segment of each object
+	double* fraction;					//!< Of the segment elapsed
+	float* curvature;
+	float* curvatureDelta;
+	bool* isWithinTrajectory;
+};
+
+/*!
+ * \brief createFleetEvaluator Creates an evaluator without trajectories
+ * \return The evaluator, or NULL if it could not be allocated
+ */
+FleetEvaluatorType* createFleetEvaluator(void) {
+	return calloc(1, sizeof (FleetEvaluatorType));
+}
+
+/*!
+ * \brief freeFleetEvaluator Frees an evaluator and all its trajectories
+ * \param evaluator Evaluator to free, may be NULL
+ */
+void freeFleetEvaluator(FleetEvaluatorType* evaluator) {
+	if (evaluator == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < evaluator->nObjects; ++i) {
+		freeTrajectoryIndex(evaluator->indices[i]);
+	}
+	free(evaluator->transmitterID);
+	free(evaluator->indices);
+	free(evaluator->cursors);
+	free(evaluator->columns);
+	free(evaluator->frame);
+	free(evaluator);
+}
+
+//! Resizes a column, leaving it unchanged on failure
+static int resizeColumn(void** column, const size_t capacity, const size_t elementSize) {
+	void* grown = realloc(*column, capacity * elementSize);
+	if (grown == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+	*column = grown;
+	return 0;
+}
+
+/*!
+ * \brief reserveFleetObject Makes room for one more object, growing all columns together
+ * \param evaluator Evaluator to enlarge
+ * \return 0 on success, -1 otherwise
+ */
+static int reserveFleetObject(FleetEvaluatorType* evaluator) {
+	if (evaluator->nObjects < evaluator->capacity) {
+		return 0;
+	}
+	const size_t capacity = evaluator->capacity == 0 ? FLEET_INITIAL_CAPACITY : 2 * evaluator->capacity;
+	// Evaluation columns hold nothing between evaluations, so need not be copied
+	const size_t frameSize = capacity * ((2 * FLEET_N_FIELDS + 1) * sizeof (double)
+										 + 2 * sizeof (float) + sizeof (bool));
+	double* frame;
+
+	if (resizeColumn((void**) &evaluator->transmitterID, capacity, sizeof (*evaluator->transmitterID)) < 0
+			|| resizeColumn((void**) &evaluator->indices, capacity, sizeof (*evaluator->indices)) < 0
+			|| resizeColumn((void**) &evaluator->cursors, capacity, sizeof (*evaluator->cursors)) < 0
+			|| resizeColumn((void**) &evaluator->columns, capacity, sizeof (*evaluator->columns)) < 0) {
+		return -1;
+	}
+	if ((frame = malloc(frameSize)) == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+	free(evaluator->frame);
+	evaluator->frame = frame;
+	for (int field = 0; field < FLEET_N_FIELDS; ++field, frame += capacity) {
+		evaluator->state[field] = frame;
+	}
+	for (int field = 0; field < FLEET_N_FIELDS; ++field, frame += capacity) {
+		evaluator->delta[field] = frame;
+	}
+	evaluator->fraction = frame;
+	evaluator->curvature = (float*) (frame + capacity);
+	evaluator->curvatureDelta = evaluator->curvature + capacity;
+	evaluator->isWithinTrajectory = (bool*) (evaluator->curvatureDelta + capacity);
+	evaluator->capacity = capacity;
+	return 0;
+}
+
+//! Index of an object, or where it would be inserted
+static size_t lowerBoundFleetObject(const FleetEvaluatorType* evaluator, const uint32_t transmitterID) {
+	size_t low = 0, high = evaluator->nObjects;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (evaluator->transmitterID[middle] < transmitterID) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+static FleetColumnsType getFleetColumns(const TrajectoryIndexType* index) {
+	const TrajectoryColumnsType source = getTrajectoryColumns(index);
+	FleetColumnsType columns;
+
+	columns.nPoints = source.nPoints;
+	columns.time_us = source.time_us;
+	columns.field[FLEET_X] = source.x_m;
+	columns.field[FLEET_Y] = source.y_m;
+	columns.field[FLEET_Z] = source.z_m;
+	columns.field[FLEET_HEADING] = source.heading_rad;
+	columns.field[FLEET_LONGITUDINAL_SPEED] = source.longitudinalSpeed_m_s;
+	columns.field[FLEET_LATERAL_SPEED] = source.lateralSpeed_m_s;
+	columns.field[FLEET_LONGITUDINAL_ACCELERATION] = source.longitudinalAcceleration_m_s2;
+	columns.field[FLEET_LATERAL_ACCELERATION] = source.lateralAcceleration_m_s2;
+	columns.curvature = source.curvature;
+	return columns;
+}
+
+/*!
+ * \brief setFleetTrajectory Sets the trajectory of an object, replacing any previous one
+ * \param evaluator Evaluator to add the trajectory to
+ * \param transmitterID Object following the trajectory
+ * \param waypoints Trajectory, e.g. decoded from TRAJ, with nondecreasing times
+ * \param nWaypoints Number of waypoints, at least one
+ * \return 0 on success, -1 otherwise with errno set as for ::createTrajectoryIndex
+ */
+int setFleetTrajectory(
+		FleetEvaluatorType* evaluator,
+		const uint32_t transmitterID,
+		const TrajectoryWaypointType waypoints[],
+		const size_t nWaypoints) {
+	if (evaluator == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	TrajectoryIndexType* index = createTrajectoryIndex(waypoints, nWaypoints);
+	if (index == NULL) {
+		return -1;
+	}
+
+	const size_t i = lowerBoundFleetObject(evaluator, transmitterID);
+	if (i < evaluator->nObjects && evaluator->transmitterID[i] == transmitterID) {
+		freeTrajectoryIndex(evaluator->indices[i]);
+	}
+	else {
+		if (reserveFleetObject(evaluator) < 0) {
+			freeTrajectoryIndex(index);
+			return -1;
+		}
+		const size_t nMoved = evaluator->nObjects - i;
+		memmove(&evaluator->transmitterID[i + 1], &evaluator->transmitterID[i],
+				nMoved * sizeof (*evaluator->transmitterID));
+		memmove(&evaluator->indices[i + 1], &evaluator->indices[i], nMoved * sizeof (*evaluator->indices));
+		memmove(&evaluator->cursors[i + 1], &evaluator->cursors[i], nMoved * sizeof (*evaluator->cursors));
+		memmove(&evaluator->columns[i + 1], &evaluator->columns[i], nMoved * sizeof (*evaluator->columns));
+		evaluator->nObjects++;
+		evaluator->transmitterID[i] = transmitterID;
+	}
+	evaluator->indices[i] = index;
+	initTrajectoryCursor(&evaluator->cursors[i], index);
+	evaluator->columns[i] = getFleetColumns(index);
+	return 0;
+}
+
+/*!
+ * \brief removeFleetTrajectory Removes the trajectory of an object
+ * \param evaluator Evaluator holding the trajectory
+ * \param transmitterID Object to remove
+ * \return 0 on success, -1 if the object has no trajectory
+ */
+int removeFleetTrajectory(
+		FleetEvaluatorType* evaluator,
+		const uint32_t transmitterID) {
+	if (evaluator == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	const size_t i = lowerBoundFleetObject(evaluator, transmitterID);
+	if (i == evaluator->nObjects || evaluator->transmitterID[i] != transmitterID) {
+		errno = ENOENT;
+		return -1;
+	}
+	freeTrajectoryIndex(evaluator->indices[i]);
+	const size_t nMoved = evaluator->nObjects - i - 1;
+	memmove(&evaluator->transmitterID[i], &evaluator->transmitterID[i + 1],
+			nMoved * sizeof (*evaluator->transmitterID));
+	memmove(&evaluator->indices[i], &evaluator->indices[i + 1], nMoved * sizeof (*evaluator->indices));
+	memmove(&evaluator->cursors[i], &evaluator->cursors[i + 1], nMoved * sizeof (*evaluator->cursors));
+	memmove(&evaluator->columns[i], &evaluator->columns[i + 1], nMoved * sizeof (*evaluator->columns));
+	evaluator->nObjects--;
+	return 0;
+}
+
+/*!
+ * \brief setFleetStartTime Sets the time at which all trajectories start, e.g. decoded from STRT
+ * \param evaluator Evaluator to set the start time of
+ * \param startData Start message contents, with a valid start time
+ * \return 0 on success, -1 otherwise
+ */
+int setFleetStartTime(
+		FleetEvaluatorType* evaluator,
+		const StartMessageType* startData) {
+	if (evaluator == NULL || startData == NULL || !startData->isTimestampValid) {
+		errno = EINVAL;
+		return -1;
+	}
+	evaluator->startTime_us = timevalToMicroseconds(&startData->startTime);
+	evaluator->hasStartTime = true;
+	for (size_t i = 0; i < evaluator->nObjects; ++i) {
+		evaluator->cursors[i].segment = 0;
+	}
+	return 0;
+}
+
+/*!
+ * \brief gatherFleetSegments Finds the trajectory segment of each object at a time, and copies the
+ *			values at its start and the changes over it into the evaluation columns
+ * \param evaluator Evaluator holding the trajectories
+ * \param relativeTime_us Time since the start
+ * \return Number of objects for which the time is within the trajectory
+ */
+static size_t gatherFleetSegments(FleetEvaluatorType* evaluator, const int64_t relativeTime_us) {
+	size_t nWithin = 0;
+
+	for (size_t k = 0; k < evaluator->nObjects; ++k) {
+		const FleetColumnsType* columns = &evaluator->columns[k];
+		const size_t i = seekTrajectoryCursor(&evaluator->cursors[k], relativeTime_us);
+		const size_t next = columns->nPoints > 1 ? i + 1 : i;
+		const int64_t duration_us = columns->time_us[next] - columns->time_us[i];
+		const bool isWithin = relativeTime_us >= columns->time_us[0]
+				&& relativeTime_us <= columns->time_us[columns->nPoints - 1];
+		double fraction = duration_us > 0 ? (double) (relativeTime_us - columns->time_us[i]) / (double) duration_us
+										  : 0.0;
+
+		evaluator->fraction[k] = fraction < 0.0 ? 0.0 : fraction > 1.0 ? 1.0 : fraction;
+		evaluator->isWithinTrajectory[k] = isWithin;
+		nWithin += isWithin;
+		for (int field = 0; field < FLEET_N_FIELDS; ++field) {
+			evaluator->state[field][k] = columns->field[field][i];
+			evaluator->delta[field][k] = columns->field[field][next] - columns->field[field][i];
+		}
+		evaluator->curvature[k] = columns->curvature[i];
+		evaluator->curvatureDelta[k] = columns->curvature[next] - columns->curvature[i];
+	}
+	return nWithin;
+}
+
+/*!
+ * \brief evaluateFleetPlannedStates Interpolates the planned state of every object at a time. Each
+ *			object keeps a cursor into its trajectory, so that evaluation at increasing times takes
+ *			amortised constant time per object. The segments are gathered first, after which each
+ *			field is interpolated for all objects in one loop over contiguous columns.
+ * \param evaluator Evaluator holding the trajectories
+ * \param time Time at which to evaluate the trajectories
+ * \param states Columns of planned states, valid until the next evaluation or change of trajectories
+ * \return Number of objects for which the time is within the trajectory, or -1 with errno set to
+ *		EINVAL		if no start time has been set
+ */
+ssize_t evaluateFleetPlannedStates(
+		FleetEvaluatorType* evaluator,
+		const struct timeval* time,
+		FleetPlannedStatesType* states) {
+	if (evaluator == NULL || time == NULL || states == NULL || !evaluator->hasStartTime) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_STRT, 0,
+						 "Planned states cannot be evaluated without a start time");
+		return -1;
+	}
+	const size_t nObjects = evaluator->nObjects;
+	const size_t nWithin = gatherFleetSegments(evaluator, timevalToMicroseconds(time) - evaluator->startTime_us);
+	const double* restrict fraction = evaluator->fraction;
+
+	for (int field = 0; field < FLEET_N_FIELDS; ++field) {
+		double* restrict state = evaluator->state[field];
+		const double* restrict delta = evaluator->delta[field];
+		if (field == FLEET_HEADING) {
+			// Along the shorter turn, and back into [0, 2π)
+			for (size_t k = 0; k < nObjects; ++k) {
+				const double turn = delta[k] > M_PI ? delta[k] - 2.0 * M_PI
+													: delta[k] < -M_PI ? delta[k] + 2.0 * M_PI : delta[k];
+				const double heading = state[k] + fraction[k] * turn;
+				state[k] = heading < 0.0 ? heading + 2.0 * M_PI
+										 : heading >= 2.0 * M_PI ? heading - 2.0 * M_PI : heading;
+			}
+			continue;
+		}
+		for (size_t k = 0; k < nObjects; ++k) {
+			state[k] += fraction[k] * delta[k];
+		}
+	}
+	float* restrict curvature = evaluator->curvature;
+	const float* restrict curvatureDelta = evaluator->curvatureDelta;
+	for (size_t k = 0; k < nObjects; ++k) {
+		curvature[k] += (float) fraction[k] * curvatureDelta[k];
+	}
+
+	states->nObjects = nObjects;
+	states->transmitterID = evaluator->transmitterID;
+	states->x_m = evaluator->state[FLEET_X];
+	states->y_m = evaluator->state[FLEET_Y];
+	states->z_m = evaluator->state[FLEET_Z];
+	states->heading_rad = evaluator->state[FLEET_HEADING];
+	states->longitudinalSpeed_m_s = evaluator->state[FLEET_LONGITUDINAL_SPEED];
+	states->lateralSpeed_m_s = evaluator->state[FLEET_LATERAL_SPEED];
+	states->longitudinalAcceleration_m_s2 = evaluator->state[FLEET_LONGITUDINAL_ACCELERATION];
+	states->lateralAcceleration_m_s2 = evaluator->state[FLEET_LATERAL_ACCELERATION];
+	states->curvature = evaluator->curvature;
+	states->isWithinTrajectory = evaluator->isWithinTrajectory;
+	return (ssize_t) nWithin;
+}
@@ -1,12 +1,52 @@
 #include "footer.h"
 #include "defines.h"
+#include "isoerror.h"
+#include "codeccontext.h"
 
 #include <string.h>
 #include <endian.h>
 #include <stdio.h>
 
+//! CCITT lookup table for the polynomial x^16 + x^12 + x^5 + 1
+static const uint16_t crcTable[256] = {
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+	0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+	0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+	0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+	0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+	0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+	0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+	0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+	0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+	0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+	0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+	0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+	0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+	0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+	0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+	0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+	0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+	0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+	0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+	0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+	0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+	0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+	0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+	0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+	0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+	0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+	0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+	0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+	0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+	0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+	0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
 
-static int8_t isCRCVerificationEnabled = DEFAULT_CRC_CHECK_ENABLED;
+//! Internal version of ::crcByte, which can be inlined since it cannot be interposed
+static inline uint16_t crcStep(const uint16_t crc, const uint8_t byte) {
+	return (uint16_t) ((crc << 8) ^ crcTable[(crc >> 8) ^ byte]);
+}
 
 /*!
  * \brief buildISOFooter Constructs a footer for an ISO message
@@ -44,7 +84,8 @@ enum ISOMessageReturnValue decodeISOFooter(const char *MessageBuffer, const size
 
 	// If too little data, generate error
 	if (length < sizeof (FooterData->Crc)) {
-		fprintf(stderr, "Too little raw data to fill ISO footer\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_INVALID, 0,
+						 "Too little raw data to fill ISO footer");
 		memset(FooterData, 0, sizeof (*FooterData));
 		return MESSAGE_LENGTH_ERROR;
 	}
@@ -70,7 +111,7 @@ uint16_t crc16(const uint8_t * data, size_t dataLen) {
 	uint16_t crc = DEFAULT_CRC_INIT_VALUE;
 
 	while (dataLen-- > 0) {
-		crc = crcByte(crc, *data++);
+		crc = crcStep(crc, *data++);
 	}
 	return crc;
 }
@@ -83,42 +124,136 @@ uint16_t crc16(const uint8_t * data, size_t dataLen) {
  * \return New CRC value
  */
 uint16_t crcByte(const uint16_t crc, const uint8_t byte) {
-	static const uint16_t crcTable[256] = {
-		0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
-		0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
-		0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
-		0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
-		0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
-		0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
-		0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
-		0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
-		0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
-		0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
-		0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
-		0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
-		0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
-		0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
-		0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
-		0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
-		0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
-		0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
-		0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
-		0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
-		0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
-		0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
-		0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
-		0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
-		0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
-		0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
-		0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
-		0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
-		0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
-		0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
-		0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
-		0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
-	};
+	return crcStep(crc, byte);
+}
 
-	return (uint16_t) ((crc << 8) ^ crcTable[(crc >> 8) ^ byte]);
+/*!
+ * \brief crc16Interleaved Calculates the 16 bit CCITT checksum values of several blocks of data.
+ *			Blocks are processed four at a time, one byte from each per step, so that the table
+ *			lookups for different blocks are independent and can execute in parallel.
+ * \param data Blocks of data for which CRCs are to be calculated
+ * \param dataLen Lengths of the blocks of data
+ * \param nBlocks Number of blocks
+ * \param crc Array in which to store the CRC checksum of each block
+ */
+void crc16Interleaved(
+		const uint8_t* const data[],
+		const size_t dataLen[],
+		const size_t nBlocks,
+		uint16_t crc[]) {
+	size_t i = 0;
+
+	for (; i + 4 <= nBlocks; i += 4) {
+		uint16_t crc0 = DEFAULT_CRC_INIT_VALUE, crc1 = DEFAULT_CRC_INIT_VALUE;
+		uint16_t crc2 = DEFAULT_CRC_INIT_VALUE, crc3 = DEFAULT_CRC_INIT_VALUE;
+		size_t common = dataLen[i];
+
+		for (size_t j = 1; j < 4; ++j) {
+			common = dataLen[i + j] < common ? dataLen[i + j] : common;
+		}
+		for (size_t n = 0; n < common; ++n) {
+			crc0 = crcStep(crc0, data[i][n]);
+			crc1 = crcStep(crc1, data[i + 1][n]);
+			crc2 = crcStep(crc2, data[i + 2][n]);
+			crc3 = crcStep(crc3, data[i + 3][n]);
+		}
+		crc[i] = crc0;
+		crc[i + 1] = crc1;
+		crc[i + 2] = crc2;
+		crc[i + 3] = crc3;
+
+		// Finish the parts of longer blocks one at a time
+		for (size_t j = 0; j < 4; ++j) {
+			for (size_t n = common; n < dataLen[i + j]; ++n) {
+				crc[i + j] = crcStep(crc[i + j], data[i + j][n]);
+			}
+		}
+	}
+	for (; i < nBlocks; ++i) {
+		crc[i] = crc16(data[i], dataLen[i]);
+	}
+}
+
+//! x^(8 * 2^k) modulo the CRC polynomial, the effect of 2^k zero bytes on a CRC state
+static const uint16_t crcZeroBytePowers[64] = {
+	0x0100, 0x1021, 0x3730, 0xB861, 0xAEFC, 0x8E29, 0x13FC, 0x36C4,
+	0xFD50, 0xAA9E, 0x881C, 0x4458, 0x0002, 0x0004, 0x0010, 0x0100,
+	0x1021, 0x3730, 0xB861, 0xAEFC, 0x8E29, 0x13FC, 0x36C4, 0xFD50,
+	0xAA9E, 0x881C, 0x4458, 0x0002, 0x0004, 0x0010, 0x0100, 0x1021,
+	0x3730, 0xB861, 0xAEFC, 0x8E29, 0x13FC, 0x36C4, 0xFD50, 0xAA9E,
+	0x881C, 0x4458, 0x0002, 0x0004, 0x0010, 0x0100, 0x1021, 0x3730,
+	0xB861, 0xAEFC, 0x8E29, 0x13FC, 0x36C4, 0xFD50, 0xAA9E, 0x881C,
+	0x4458, 0x0002, 0x0004, 0x0010, 0x0100, 0x1021, 0x3730, 0xB861
+};
+
+/*!
+ * \brief crcMultiply Multiplies two polynomials modulo the CRC polynomial
+ * \param a First factor
+ * \param b Second factor
+ * \return Product modulo x^16 + x^12 + x^5 + 1
+ */
+static uint16_t crcMultiply(const uint16_t a, const uint16_t b) {
+	uint32_t product = 0;
+
+	for (unsigned int bit = 0; bit < 16; ++bit) {
+		product ^= ((uint32_t) a << bit) & (0u - ((b >> bit) & 1u));
+	}
+	// The upper half times x^16 is the upper half advanced by two zero bytes
+	const uint16_t high = (uint16_t) (product >> 16);
+	return (uint16_t) ((uint16_t) product ^ crcStep(crcStep(high, 0), 0));
+}
+
+/*!
+ * \brief crcShiftZeros Advances a CRC state past a number of zero bytes, in time logarithmic
+ *			in the number of bytes. Only valid for states calculated with a zero initial value.
+ * \param crc State to advance
+ * \param nZeroBytes Number of zero bytes
+ * \return The state after the zero bytes
+ */
+static uint16_t crcShiftZeros(uint16_t crc, size_t nZeroBytes) {
+	for (size_t k = 0; nZeroBytes > 0; ++k, nZeroBytes >>= 1) {
+		if (nZeroBytes & 1) {
+			crc = crcMultiply(crc, crcZeroBytePowers[k]);
+		}
+	}
+	return crc;
+}
+
+/*!
+ * \brief crc16Patch Updates the checksum of a block of data after some of its bytes were changed,
+ *			without reading the unchanged bytes. Since the CRC is linear, the change in checksum
+ *			only depends on the difference between old and new bytes and their distance to the end.
+ * \param crc Checksum of the block before the change
+ * \param oldData Changed bytes as they were before the change
+ * \param newData Changed bytes as they are after the change
+ * \param patchLength Number of changed bytes
+ * \param bytesAfterPatch Number of bytes in the block after the changed bytes
+ * \return Checksum of the block after the change
+ */
+uint16_t crc16Patch(
+		const uint16_t crc,
+		const uint8_t* oldData,
+		const uint8_t* newData,
+		const size_t patchLength,
+		const size_t bytesAfterPatch) {
+	uint16_t difference = 0;
+
+	for (size_t i = 0; i < patchLength; ++i) {
+		difference = crcStep(difference, oldData[i] ^ newData[i]);
+	}
+	return crc ^ crcShiftZeros(difference, bytesAfterPatch);
+}
+
+/*!
+ * \brief crc16Combine Calculates the checksum of two consecutive blocks of data from the checksums
+ *			of each block, e.g. of a message whose parts were checksummed in parallel
+ * \param crcFirst Checksum of the first block
+ * \param crcSecond Checksum of the second block
+ * \param secondLength Length of the second block
+ * \return Checksum of the first block followed by the second
+ */
+uint16_t crc16Combine(const uint16_t crcFirst, const uint16_t crcSecond, const size_t secondLength) {
+	return crcShiftZeros(crcFirst, secondLength) ^ crcSecond;
 }
 
 /*!
@@ -136,7 +271,7 @@ enum ISOMessageReturnValue verifyChecksum(
 	const uint16_t CRC,
 	const char debug)
 {
-	if (!isCRCVerificationEnabled || CRC == 0) {
+	if (!isCodecCRCVerificationEnabled(getActiveCodecContext()) || CRC == 0) {
 		return MESSAGE_OK;
 	}
 
@@ -153,11 +288,11 @@ enum ISOMessageReturnValue verifyChecksum(
 }
 
 /*!
- * \brief setISOCRCVerification Enables or disables checksum verification on received messages (default
- *			is to enable checksum verification)
+ * \brief setISOCRCVerification Enables or disables checksum verification on received messages decoded
+ *			without a codec context (default is to enable checksum verification)
  * \param enabled Boolean for enabling or disabling the checksum verification
  */
 void setISOCRCVerification(const int8_t enabled) {
-	isCRCVerificationEnabled = enabled ? 1 : 0;
+	setCodecCRCVerification(getDefaultCodecContext(), enabled);
 	return;
 }
@@ -0,0 +1,168 @@
+#include "frame.h"
+#include "footer.h"
+#include "defines.h"
+#include "isoerror.h"
+#include "codeccontext.h"
+
+#include <string.h>
+#include <endian.h>
+#include <stdbool.h>
+
+//! Number of frames whose checksums are calculated together by ::validateISOFrames
+#define FRAME_VALIDATION_BATCH_SIZE 64
+
+/*!
+ * \brief validateISOFrameHeader Copies the header from the start of a frame and verifies sync word,
+ *			protocol version and that the frame holds the length stated in the header
+ * \param frame Start of the frame
+ * \param length Number of bytes available in the frame buffer
+ * \param header Struct in which to store the header
+ * \return Size of the message including header and footer, or a negative value
+ *			according to ::ISOMessageReturnValue
+ */
+ssize_t validateISOFrameHeader(const void* frame, const size_t length, HeaderType* header) {
+	const uint8_t ProtocolVersionBitmask = 0x7F;
+
+	if (frame == NULL || header == NULL) {
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_INVALID, 0, "Input pointer error");
+		return ISO_FUNCTION_ERROR;
+	}
+	if (length < sizeof (HeaderType) + sizeof (FooterType)) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_INVALID, 0,
+						 "Frame of %zu bytes too short to hold header and footer", length);
+		return MESSAGE_LENGTH_ERROR;
+	}
+
+	// The header is packed and little endian, so a single copy decodes it on little endian hosts
+	memcpy(header, frame, sizeof (*header));
+	header->syncWord = le16toh(header->syncWord);
+	header->messageLength = le32toh(header->messageLength);
+	header->transmitterID = le32toh(header->transmitterID);
+	header->receiverID = le32toh(header->receiverID);
+	header->messageID = le16toh(header->messageID);
+
+	if (header->syncWord != ISO_SYNC_WORD) {
+		ISO_REPORT_ERROR(MESSAGE_SYNC_WORD_ERROR, MESSAGE_ID_INVALID, offsetof(HeaderType, syncWord),
+						 "Sync word error in frame (0x%04x)", header->syncWord);
+		return MESSAGE_SYNC_WORD_ERROR;
+	}
+	if (!isCodecProtocolVersionSupported(getActiveCodecContext(),
+										 (uint8_t) (header->ackReqProtVer & ProtocolVersionBitmask))) {
+		ISO_REPORT_ERROR(MESSAGE_VERSION_ERROR, header->messageID, offsetof(HeaderType, ackReqProtVer),
+						 "Protocol version %u not supported", header->ackReqProtVer & ProtocolVersionBitmask);
+		return MESSAGE_VERSION_ERROR;
+	}
+	if (header->messageLength > length - sizeof (HeaderType) - sizeof (FooterType)) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, header->messageID, offsetof(HeaderType, messageLength),
+						 "Message length %u exceeds the %zu bytes of the frame", header->messageLength, length);
+		return MESSAGE_LENGTH_ERROR;
+	}
+	return (ssize_t) (header->messageLength + sizeof (HeaderType) + sizeof (FooterType));
+}
+
+/*!
+ * \brief readFrameCRC Reads the CRC from the footer of a frame
+ * \param frame Start of the frame
+ * \param messageSize Size of the message including header and footer
+ * \return CRC as stated in the footer
+ */
+static uint16_t readFrameCRC(const uint8_t* frame, const size_t messageSize) {
+	uint16_t crc;
+	memcpy(&crc, frame + messageSize - sizeof (FooterType), sizeof (crc));
+	return le16toh(crc);
+}
+
+/*!
+ * \brief validateISOFrame Checks that a buffer starts with a well-formed ISO message, i.e. that sync
+ *			word, protocol version and length are consistent and that the CRC matches, and decodes only
+ *			its header. The message contents are not converted. Supported protocol versions and CRC
+ *			verification are taken from the active codec context.
+ * \param frame Buffer starting with the message
+ * \param length Number of bytes in the buffer, which may be more than the message
+ * \param header Struct in which to store the decoded header, zeroed if the frame is invalid
+ * \return Size of the message including header and footer, or a negative value
+ *			according to ::ISOMessageReturnValue
+ */
+ssize_t validateISOFrame(const void* frame, const size_t length, HeaderType* header) {
+	const ssize_t messageSize = validateISOFrameHeader(frame, length, header);
+
+	if (messageSize < 0) {
+		if (header != NULL) {
+			memset(header, 0, sizeof (*header));
+		}
+		return messageSize;
+	}
+	const uint16_t crc = readFrameCRC(frame, (size_t) messageSize);
+	if (isCodecCRCVerificationEnabled(getActiveCodecContext()) && crc != 0
+			&& crc16(frame, (size_t) messageSize - sizeof (FooterType)) != crc) {
+		ISO_REPORT_ERROR(MESSAGE_CRC_ERROR, header->messageID, (size_t) messageSize - sizeof (FooterType),
+						 "CRC mismatch in frame");
+		memset(header, 0, sizeof (*header));
+		return MESSAGE_CRC_ERROR;
+	}
+	return messageSize;
+}
+
+/*!
+ * \brief validateISOFrames Validates a batch of frames, such as datagrams received in one system call,
+ *			as ::validateISOFrame does for a single frame. Checksums of the batch are calculated
+ *			together, which is faster than validating the frames one by one.
+ * \param frames Buffers each starting with a message
+ * \param lengths Number of bytes in each buffer
+ * \param nFrames Number of frames
+ * \param headers Array in which to store the decoded header of each frame, zeroed if the frame is invalid
+ * \param results Array in which to store the message size of each frame, or a negative value
+ *			according to ::ISOMessageReturnValue if it is invalid
+ * \return Number of valid frames
+ */
+size_t validateISOFrames(
+		const void* const frames[],
+		const size_t lengths[],
+		const size_t nFrames,
+		HeaderType headers[],
+		ssize_t results[]) {
+	const bool isCRCVerified = isCodecCRCVerificationEnabled(getActiveCodecContext());
+	const uint8_t* crcData[FRAME_VALIDATION_BATCH_SIZE];
+	size_t crcDataLength[FRAME_VALIDATION_BATCH_SIZE];
+	uint16_t calculatedCRC[FRAME_VALIDATION_BATCH_SIZE];
+	uint16_t receivedCRC[FRAME_VALIDATION_BATCH_SIZE];
+	size_t frameIndex[FRAME_VALIDATION_BATCH_SIZE];
+	size_t nValid = 0;
+
+	for (size_t start = 0; start < nFrames; start += FRAME_VALIDATION_BATCH_SIZE) {
+		const size_t end = nFrames - start < FRAME_VALIDATION_BATCH_SIZE ? nFrames : start + FRAME_VALIDATION_BATCH_SIZE;
+		size_t nChecksums = 0;
+
+		for (size_t i = start; i < end; ++i) {
+			results[i] = validateISOFrameHeader(frames[i], lengths[i], &headers[i]);
+			if (results[i] < 0) {
+				memset(&headers[i], 0, sizeof (headers[i]));
+				continue;
+			}
+			const uint16_t crc = readFrameCRC(frames[i], (size_t) results[i]);
+			if (!isCRCVerified || crc == 0) {
+				nValid++;
+				continue;
+			}
+			crcData[nChecksums] = frames[i];
+			crcDataLength[nChecksums] = (size_t) results[i] - sizeof (FooterType);
+			receivedCRC[nChecksums] = crc;
+			frameIndex[nChecksums] = i;
+			nChecksums++;
+		}
+
+		crc16Interleaved(crcData, crcDataLength, nChecksums, calculatedCRC);
+		for (size_t j = 0; j < nChecksums; ++j) {
+			const size_t i = frameIndex[j];
+			if (calculatedCRC[j] == receivedCRC[j]) {
+				nValid++;
+				continue;
+			}
+			ISO_REPORT_ERROR(MESSAGE_CRC_ERROR, headers[i].messageID, crcDataLength[j],
+							 "CRC mismatch in frame %zu of batch", i);
+			memset(&headers[i], 0, sizeof (headers[i]));
+			results[i] = MESSAGE_CRC_ERROR;
+		}
+	}
+	return nValid;
+}
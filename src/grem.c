@@ -4,6 +4,7 @@
 
 #include "grem.h"
 #include "iohelpers.h"
+#include "isoerror.h"
 
 //! GREM field descriptions
 static DebugStrings_t GREMSReceivedHeaderTransmitterDescription = {"Received Header Transmitter", "", &printU32};
@@ -37,7 +38,8 @@ ssize_t decodeGREMMessage(
 
 	if (gremDataBuffer == NULL || gremData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointers to GREM parsing function cannot be null\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_GREM, 0,
+						 "Input pointers to GREM parsing function cannot be null");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -52,12 +54,14 @@ ssize_t decodeGREMMessage(
 
 	// If message is not a GREM message, generate an error
 	if (GREMdata.header.messageID != MESSAGE_ID_GREM) {
-		fprintf(stderr, "Attempted to pass non-GREM message into GREM parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_GREM, (size_t) (p - gremDataBuffer),
+						 "Attempted to pass non-GREM message into GREM parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
 	if (GREMdata.header.messageLength > sizeof (GREMType) - sizeof (HeaderType) - sizeof (FooterType)) {
-		fprintf(stderr, "GREM message exceeds expected message length\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_GREM, (size_t) (p - gremDataBuffer),
+						 "GREM message exceeds expected message length");
 		return MESSAGE_LENGTH_ERROR;
 	}
 
@@ -106,14 +110,16 @@ ssize_t decodeGREMMessage(
 			expectedContentLength = contentLength;
 			break;
 		default:
-			fprintf(stderr, "Value ID 0x%x does not match any known GREM value IDs", valueID);
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_GREM, (size_t) (p - gremDataBuffer),
+							 "Value ID 0x%x does not match any known GREM value IDs", valueID);
 			return MESSAGE_VALUE_ID_ERROR;
 		}
 
 		p += contentLength;
 		if (contentLength != expectedContentLength) {
-			fprintf(stderr, "Content length %u for value ID 0x%x does not match the expected %ld",
-					contentLength, valueID, expectedContentLength);
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_GREM, (size_t) (p - gremDataBuffer),
+							 "Content length %u for value ID 0x%x does not match the expected %ld",
+							 contentLength, valueID, expectedContentLength);
 			return MESSAGE_LENGTH_ERROR;
 		}
 	}
@@ -122,7 +128,8 @@ ssize_t decodeGREMMessage(
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - gremDataBuffer), &GREMdata.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding GREM footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_GREM, (size_t) (p - gremDataBuffer),
+						 "Error decoding GREM footer");
 		return retval;
 	}
 	p += sizeof (GREMdata.footer);
@@ -149,12 +156,13 @@ enum ISOMessageReturnValue convertGREMoHostRepresentation(GREMType* GREMdata,
 
 	if (GREMdata == NULL || gremData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "GREM input pointer error");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_INVALID, 0, "GREM input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
 	if (!GREMdata->ResponseCodeValueID ) {
-		fprintf(stderr, "Response Code Value ID not supplied in GREM message\n");
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_INVALID, 0,
+						 "Response Code Value ID not supplied in GREM message");
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 	gremData->receivedHeaderTransmitterID = GREMdata->ReceivedHeaderTransmitterID;
@@ -168,6 +176,14 @@ enum ISOMessageReturnValue convertGREMoHostRepresentation(GREMType* GREMdata,
 }
 
 
+/*!
+ * \brief getEncodedSizeGREMMessage Get the size of an encoded GREM message
+ * \return Number of bytes written by ::encodeGREMMessage
+ */
+size_t getEncodedSizeGREMMessage(void) {
+	return sizeof (GREMType);
+}
+
 /*!
  * \brief encodeGREMMessage Fills a GREM struct with relevant data fields,
  *		and corresponding value IDs and content lengths
@@ -187,19 +203,19 @@ ssize_t encodeGREMMessage(
 
 	GREMType GREMData;
 
-	memset(gremDataBuffer, 0, bufferLength);
 	char* p = gremDataBuffer;
 	size_t remainingBytes = bufferLength;
 	int retval = 0;
 
 	if (gremObjectData == NULL) {
-		fprintf(stderr, "GREM data input pointer error\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_GREM, 0, "GREM data input pointer error");
 		return -1;
 	}
 
 	// If buffer too small to hold GREM data, generate an error
 	if (bufferLength < sizeof (GREMType)) {
-		fprintf(stderr, "Buffer too small to hold necessary GREM data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_GREM, (size_t) (p - gremDataBuffer),
+						 "Buffer too small to hold necessary GREM data");
 		return -1;
 	}
 
@@ -226,12 +242,13 @@ ssize_t encodeGREMMessage(
 	retval |= encodeContent(VALUE_ID_GREM_PAYLOAD_DATA, &gremObjectData->payload, &p,
 						  sizeof (gremObjectData->payload), &remainingBytes, &GREMPayloadDescription, debug);
 	if (retval != 0 || remainingBytes < sizeof (FooterType)) {
-		fprintf(stderr, "Buffer too small to hold necessary GREM data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_GREM, (size_t) (p - gremDataBuffer),
+						 "Buffer too small to hold necessary GREM data");
 		return -1;
 	}
 
 	// Construct footer
-	GREMData.footer = buildISOFooter(&GREMData, sizeof (GREMData), debug);
+	GREMData.footer = buildISOFooter(gremDataBuffer, (size_t) (p - gremDataBuffer) + sizeof (FooterType), debug);
 	memcpy(p, &GREMData.footer, sizeof (GREMData.footer));
 	p += sizeof (GREMData.footer);
 	remainingBytes -= sizeof (GREMData.footer);
@@ -1,6 +1,8 @@
 #include "header.h"
 #include "defines.h"
 #include "footer.h"
+#include "isoerror.h"
+#include "codeccontext.h"
 
 #include <string.h>
 #include <endian.h>
@@ -27,7 +29,8 @@ HeaderType buildISOHeader(enum ISOMessageID id, const MessageHeaderType *input,
 		header.messageLength = messageLength - sizeof (HeaderType) - sizeof (FooterType);
 	}
 	else {
-		fprintf(stderr, "Supplied message length too small to hold header and footer\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_INVALID, 0,
+						 "Supplied message length too small to hold header and footer");
 		header.messageID = (uint16_t) MESSAGE_ID_INVALID;
 		header.messageLength = 0;
 	}
@@ -71,7 +74,8 @@ enum ISOMessageReturnValue decodeISOHeader(
 
 	// If not enough data to fill header, generate error
 	if (length < sizeof (HeaderData)) {
-		fprintf(stderr, "Too little raw data to fill ISO header\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_INVALID, (size_t) (p - MessageBuffer),
+						 "Too little raw data to fill ISO header");
 		memset(HeaderData, 0, sizeof (*HeaderData));
 		return MESSAGE_LENGTH_ERROR;
 	}
@@ -83,8 +87,9 @@ enum ISOMessageReturnValue decodeISOHeader(
 
 	// If sync word is not correct, generate error
 	if (HeaderData->syncWord != ISO_SYNC_WORD) {
-		fprintf(stderr, "Sync word error when decoding ISO header (0x%04x)\n",
-				HeaderData->syncWord);
+		ISO_REPORT_ERROR(MESSAGE_SYNC_WORD_ERROR, MESSAGE_ID_INVALID, (size_t) (p - MessageBuffer),
+						 "Sync word error when decoding ISO header (0x%04x)",
+						 HeaderData->syncWord);
 		memset(HeaderData, 0, sizeof (*HeaderData));
 		return MESSAGE_SYNC_WORD_ERROR;
 	}
@@ -96,18 +101,14 @@ enum ISOMessageReturnValue decodeISOHeader(
 	memcpy(&HeaderData->ackReqProtVer, p, sizeof (HeaderData->ackReqProtVer));
 	p += sizeof (HeaderData->ackReqProtVer);
 
-	// Loop over permitted protocol versions to see if current version is among them
+	// Check if current version is among the permitted protocol versions
 	messageProtocolVersion = HeaderData->ackReqProtVer & ProtocolVersionBitmask;
-	for (size_t i = 0; i < sizeof (SupportedProtocolVersions) / sizeof (SupportedProtocolVersions[0]); ++i) {
-		if (SupportedProtocolVersions[i] == messageProtocolVersion) {
-			isProtocolVersionSupported = 1;
-			break;
-		}
-	}
+	isProtocolVersionSupported = isCodecProtocolVersionSupported(getActiveCodecContext(), messageProtocolVersion);
 
 	// Generate error if protocol version not supported
 	if (!isProtocolVersionSupported) {
-		fprintf(stderr, "Protocol version %u not supported\n", messageProtocolVersion);
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_INVALID, (size_t) (p - MessageBuffer),
+						 "Protocol version %u not supported", messageProtocolVersion);
 		retval = MESSAGE_VERSION_ERROR;
 		memset(HeaderData, 0, sizeof (*HeaderData));
 		return retval;
@@ -0,0 +1,69 @@
+#include "isoerror.h"
+#include "codeccontext.h"
+#include <stdarg.h>
+
+static _Thread_local ISOErrorType lastError = { MESSAGE_OK, MESSAGE_ID_INVALID, 0, NULL, NULL };
+
+/*!
+ * \brief getLastISOError Get the most recent error reported on the calling thread
+ * \return Error description, with code MESSAGE_OK if no error was reported since it was last cleared
+ */
+ISOErrorType getLastISOError(void) {
+	return lastError;
+}
+
+/*!
+ * \brief clearLastISOError Clear the most recent error reported on the calling thread
+ */
+void clearLastISOError(void) {
+	lastError.code = MESSAGE_OK;
+	lastError.messageID = MESSAGE_ID_INVALID;
+	lastError.offset = 0;
+	lastError.function = NULL;
+	lastError.description = NULL;
+}
+
+/*!
+ * \brief setISOErrorCallback Register a function to be called with reported errors. Errors exceeding
+ *			the rate limit within the same second are counted but not passed on. The callback should
+ *			be registered before other threads start encoding or decoding messages.
+ * \param callback Function to call, or NULL to stop calling it
+ * \param userData Pointer passed on to the callback
+ * \param maxReportsPerSecond Maximum number of calls per second, or 0 for no limit
+ */
+void setISOErrorCallback(ISOErrorCallbackType callback, void* userData, const uint32_t maxReportsPerSecond) {
+	setCodecErrorCallback(getDefaultCodecContext(), callback, userData, maxReportsPerSecond);
+}
+
+/*!
+ * \brief getSuppressedISOErrorCount Get the number of errors not passed to the callback due to
+ *			the rate limit since it was registered
+ * \return Number of suppressed errors
+ */
+uint64_t getSuppressedISOErrorCount(void) {
+	return getCodecSuppressedErrorCount(getDefaultCodecContext());
+}
+
+/*!
+ * \brief reportISOError Record an error as the most recent on the calling thread and pass it to the
+ *			error callback of the active codec context. The message is only formatted if a callback
+ *			is registered and the rate limit allows. No output is written by the library itself.
+ * \param code Error code
+ * \param messageID ID of the message being encoded or decoded
+ * \param offset Byte offset into the message buffer where the error was detected
+ * \param function Name of the reporting function
+ * \param format printf style format of the error message, which must be a string literal
+ */
+void reportISOError(const enum ISOMessageReturnValue code, const enum ISOMessageID messageID, const size_t offset,
+					const char* function, const char* format, ...) {
+	lastError.code = code;
+	lastError.messageID = messageID;
+	lastError.offset = offset;
+	lastError.function = function;
+	lastError.description = format;
+
+	va_list args;
+	va_start(args, format);
+	passErrorToCodecSink(getActiveCodecContext(), &lastError, format, args);
+	va_end(args);
+}
@@ -0,0 +1,348 @@
+#include "linkhealth.h"
+#include <errno.h>
+#include <string.h>
+#include <math.h>
+
+#define JITTER_SMOOTHING_FACTOR 16.0
+#define RECEIVED_WINDOW_LENGTH 64
+
+static size_t hashTransmitterID(const uint32_t transmitterID, const size_t capacity);
+static LinkHealthType* findLinkHealthSlot(const LinkHealthTableType* table, const uint32_t transmitterID);
+static void startLinkSequence(LinkHealthType* link, const uint8_t counter, const int64_t arrival_us);
+static void updateLinkTiming(LinkHealthType* link, const int64_t arrival_us, const unsigned int counterSteps);
+
+
+/*!
+ * \brief initLinkHealthTable Initializes a link health table using caller supplied storage. No memory
+ *			is allocated by the table, so that updates can be performed on a receive thread.
+ * \param table Table to initialize
+ * \param storage Array of link health entries to be used by the table
+ * \param capacity Number of entries in storage, must be a power of two. To keep lookups short, the
+ *			capacity should be at least twice the number of expected transmitters.
+ * \return 0 on success, -1 otherwise with errno set to EINVAL
+ */
+int initLinkHealthTable(
+		LinkHealthTableType* table,
+		LinkHealthType* storage,
+		const size_t capacity) {
+
+	if (table == NULL || storage == NULL || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+		errno = EINVAL;
+		return -1;
+	}
+	table->entries = storage;
+	table->capacity = capacity;
+	resetLinkHealthTable(table);
+	return 0;
+}
+
+/*!
+ * \brief resetLinkHealthTable Clears all statistics in a link health table
+ * \param table Table to be cleared
+ */
+void resetLinkHealthTable(LinkHealthTableType* table) {
+	if (table == NULL || table->entries == NULL) {
+		return;
+	}
+	memset(table->entries, 0, table->capacity * sizeof (*table->entries));
+	table->nEntries = 0;
+}
+
+/*!
+ * \brief updateLinkHealth Updates the statistics of the transmitter of a received message. Loss, duplication
+ *			and reordering are determined from the 8 bit message counter, interpreting counter differences of
+ *			up to half the counter range as forward steps.
+ * \param table Table holding statistics for all transmitters
+ * \param header Decoded header of the received message
+ * \param receiveTime Time at which the message was received
+ * \return Pointer to the updated statistics, or NULL with errno set to EINVAL on invalid input,
+ *			or ENOBUFS if the table is full
+ */
+const LinkHealthType* updateLinkHealth(
+		LinkHealthTableType* table,
+		const HeaderType* header,
+		const struct timeval* receiveTime) {
+
+	LinkHealthType* link = NULL;
+
+	if (table == NULL || table->entries == NULL || header == NULL || receiveTime == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	const int64_t arrival_us = (int64_t) receiveTime->tv_sec * 1000000 + (int64_t) receiveTime->tv_usec;
+
+	if ((link = findLinkHealthSlot(table, header->transmitterID)) == NULL) {
+		errno = ENOBUFS;
+		return NULL;
+	}
+
+	if (!link->isActive) {
+		memset(link, 0, sizeof (*link));
+		link->isActive = true;
+		link->transmitterID = header->transmitterID;
+		initQuantileEstimator(&link->jitterMedian, 0.5);
+		initQuantileEstimator(&link->jitterP95, 0.95);
+		initQuantileEstimator(&link->jitterP99, 0.99);
+		table->nEntries++;
+		startLinkSequence(link, header->messageCounter, arrival_us);
+		link->received = 1;
+		return link;
+	}
+
+	const int8_t counterDifference = (int8_t) (uint8_t) (header->messageCounter - link->highestCounter);
+
+	if (counterDifference > 0) {
+		// New message ahead of all previous, any skipped counters are counted as lost until they arrive
+		link->lost += (uint64_t) (counterDifference - 1);
+		link->receivedWindow = counterDifference >= RECEIVED_WINDOW_LENGTH ?
+					0 : link->receivedWindow << counterDifference;
+		link->receivedWindow |= 1;
+		link->highestCounter = header->messageCounter;
+		link->received++;
+		updateLinkTiming(link, arrival_us, (unsigned int) counterDifference);
+	}
+	else if (counterDifference == 0) {
+		link->duplicated++;
+	}
+	else if (-counterDifference < RECEIVED_WINDOW_LENGTH) {
+		const uint64_t bit = (uint64_t) 1 << (-counterDifference);
+
+		if (link->receivedWindow & bit) {
+			link->duplicated++;
+		}
+		else {
+			// Late arrival of a message previously counted as lost
+			link->receivedWindow |= bit;
+			link->reordered++;
+			link->received++;
+			if (link->lost > 0) {
+				link->lost--;
+			}
+		}
+	}
+	else {
+		// Too far behind to be a reordered message, assume the transmitter restarted its counter
+		link->resynchronized++;
+		link->received++;
+		startLinkSequence(link, header->messageCounter, arrival_us);
+	}
+	return link;
+}
+
+/*!
+ * \brief getLinkHealth Finds the statistics for a transmitter
+ * \param table Table holding statistics for all transmitters
+ * \param transmitterID ID of the transmitter
+ * \return Pointer to the statistics, or NULL if the transmitter has not been seen
+ */
+const LinkHealthType* getLinkHealth(
+		const LinkHealthTableType* table,
+		const uint32_t transmitterID) {
+	if (table == NULL || table->entries == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+	const LinkHealthType* link = findLinkHealthSlot(table, transmitterID);
+	return link != NULL && link->isActive ? link : NULL;
+}
+
+/*!
+ * \brief getLinkLossRatio Calculates the ratio of lost messages to the number of messages sent
+ * \param link Statistics for a transmitter
+ * \return Loss ratio between 0 and 1
+ */
+double getLinkLossRatio(const LinkHealthType* link) {
+	if (link == NULL || link->received + link->lost == 0) {
+		return 0.0;
+	}
+	return (double) link->lost / (double) (link->received + link->lost);
+}
+
+/*!
+ * \brief initQuantileEstimator Initializes a streaming quantile estimator according to the P² algorithm
+ *			by Jain and Chlamtac, which uses constant memory and time per sample
+ * \param estimator Estimator to initialize
+ * \param probability Quantile to be estimated, between 0 and 1
+ */
+void initQuantileEstimator(
+		QuantileEstimatorType* estimator,
+		const double probability) {
+	if (estimator == NULL) {
+		return;
+	}
+	memset(estimator, 0, sizeof (*estimator));
+	estimator->probability = probability;
+}
+
+/*!
+ * \brief updateQuantileEstimator Adds a sample to a streaming quantile estimator
+ * \param estimator Estimator to be updated
+ * \param sample New sample value
+ */
+void updateQuantileEstimator(
+		QuantileEstimatorType* estimator,
+		const double sample) {
+
+	double* h = estimator->heights;
+	double* n = estimator->positions;
+	const double p = estimator->probability;
+	int k = 0;
+
+	if (estimator->count < LINK_HEALTH_QUANTILE_MARKERS) {
+		// Insertion sort the initial samples
+		int i = (int) estimator->count;
+		while (i > 0 && h[i - 1] > sample) {
+			h[i] = h[i - 1];
+			i--;
+		}
+		h[i] = sample;
+		estimator->count++;
+
+		if (estimator->count == LINK_HEALTH_QUANTILE_MARKERS) {
+			for (i = 0; i < LINK_HEALTH_QUANTILE_MARKERS; ++i) {
+				n[i] = i + 1;
+			}
+			estimator->desiredPositions[0] = 1.0;
+			estimator->desiredPositions[1] = 1.0 + 2.0 * p;
+			estimator->desiredPositions[2] = 1.0 + 4.0 * p;
+			estimator->desiredPositions[3] = 3.0 + 2.0 * p;
+			estimator->desiredPositions[4] = 5.0;
+			estimator->increments[0] = 0.0;
+			estimator->increments[1] = p / 2.0;
+			estimator->increments[2] = p;
+			estimator->increments[3] = (1.0 + p) / 2.0;
+			estimator->increments[4] = 1.0;
+		}
+		return;
+	}
+
+	// Find the cell containing the sample, extending the extreme markers if needed
+	if (sample < h[0]) {
+		h[0] = sample;
+		k = 0;
+	}
+	else if (sample >= h[4]) {
+		h[4] = sample;
+		k = 3;
+	}
+	else {
+		for (k = 0; k < 3 && sample >= h[k + 1]; ++k);
+	}
+
+	for (int i = k + 1; i < LINK_HEALTH_QUANTILE_MARKERS; ++i) {
+		n[i] += 1.0;
+	}
+	for (int i = 0; i < LINK_HEALTH_QUANTILE_MARKERS; ++i) {
+		estimator->desiredPositions[i] += estimator->increments[i];
+	}
+
+	// Adjust the heights of the middle markers
+	for (int i = 1; i < LINK_HEALTH_QUANTILE_MARKERS - 1; ++i) {
+		const double d = estimator->desiredPositions[i] - n[i];
+
+		if ((d >= 1.0 && n[i + 1] - n[i] > 1.0) || (d <= -1.0 && n[i - 1] - n[i] < -1.0)) {
+			const double s = d >= 0.0 ? 1.0 : -1.0;
+			const double parabolic = h[i] + s / (n[i + 1] - n[i - 1])
+					* ((n[i] - n[i - 1] + s) * (h[i + 1] - h[i]) / (n[i + 1] - n[i])
+					   + (n[i + 1] - n[i] - s) * (h[i] - h[i - 1]) / (n[i] - n[i - 1]));
+
+			if (h[i - 1] < parabolic && parabolic < h[i + 1]) {
+				h[i] = parabolic;
+			}
+			else {
+				const int j = i + (int) s;
+				h[i] = h[i] + s * (h[j] - h[i]) / (n[j] - n[i]);
+			}
+			n[i] += s;
+		}
+	}
+	estimator->count++;
+}
+
+/*!
+ * \brief getQuantileEstimate Retrieves the current quantile estimate
+ * \param estimator Estimator to read
+ * \return Estimated quantile, or NAN if no samples have been added
+ */
+double getQuantileEstimate(const QuantileEstimatorType* estimator) {
+	if (estimator == NULL || estimator->count == 0) {
+		return NAN;
+	}
+	if (estimator->count < LINK_HEALTH_QUANTILE_MARKERS) {
+		// Initial samples are kept sorted
+		const size_t index = (size_t) lround(estimator->probability * (estimator->count - 1));
+		return estimator->heights[index];
+	}
+	return estimator->heights[2];
+}
+
+
+static size_t hashTransmitterID(const uint32_t transmitterID, const size_t capacity) {
+	uint32_t h = transmitterID;
+	h ^= h >> 16;
+	h *= 0x7FEB352DU;
+	h ^= h >> 15;
+	h *= 0x846CA68BU;
+	h ^= h >> 16;
+	return (size_t) h & (capacity - 1);
+}
+
+/*!
+ * \brief findLinkHealthSlot Finds the entry for a transmitter using linear probing
+ * \return The matching entry, an unused entry if the transmitter is new, or NULL if the table is full
+ */
+static LinkHealthType* findLinkHealthSlot(
+		const LinkHealthTableType* table,
+		const uint32_t transmitterID) {
+	size_t index = hashTransmitterID(transmitterID, table->capacity);
+
+	for (size_t probes = 0; probes < table->capacity; ++probes) {
+		LinkHealthType* entry = &table->entries[index];
+		if (!entry->isActive || entry->transmitterID == transmitterID) {
+			return entry;
+		}
+		index = (index + 1) & (table->capacity - 1);
+	}
+	return NULL;
+}
+
+static void startLinkSequence(
+		LinkHealthType* link,
+		const uint8_t counter,
+		const int64_t arrival_us) {
+	link->highestCounter = counter;
+	link->receivedWindow = 1;
+	link->lastArrival_us = arrival_us;
+	link->lastInterArrival_us = -1.0;
+}
+
+/*!
+ * \brief updateLinkTiming Updates inter-arrival statistics for an in-order message. The inter-arrival
+ *			time is normalized by the number of counter steps so that lost messages do not show as jitter.
+ */
+static void updateLinkTiming(
+		LinkHealthType* link,
+		const int64_t arrival_us,
+		const unsigned int counterSteps) {
+
+	const double interArrival_us = (double) (arrival_us - link->lastArrival_us) / counterSteps;
+
+	link->lastArrival_us = arrival_us;
+
+	if (link->minInterArrival_us == 0.0 || interArrival_us < link->minInterArrival_us) {
+		link->minInterArrival_us = interArrival_us;
+	}
+	if (interArrival_us > link->maxInterArrival_us) {
+		link->maxInterArrival_us = interArrival_us;
+	}
+
+	if (link->lastInterArrival_us >= 0.0) {
+		const double deviation_us = fabs(interArrival_us - link->lastInterArrival_us);
+		link->jitter_us += (deviation_us - link->jitter_us) / JITTER_SMOOTHING_FACTOR;
+		updateQuantileEstimator(&link->jitterMedian, deviation_us);
+		updateQuantileEstimator(&link->jitterP95, deviation_us);
+		updateQuantileEstimator(&link->jitterP99, deviation_us);
+	}
+	link->lastInterArrival_us = interArrival_us;
+}
@@ -0,0 +1,1077 @@
+#include "monitorrecording.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define RECORDING_FILE_MAGIC "ISOMREC1"
+#define RECORDING_FILE_MAGIC_LENGTH 8
+#define RECORDING_FILE_VERSION 1
+#define RECORDING_FILE_HEADER_LENGTH 16
+#define RECORDING_BLOCK_MAGIC 0x4B4C4252U			// "RBLK"
+#define RECORDING_BLOCK_HEADER_LENGTH (24 + 8 * 2 + 4 * MONITOR_RECORDING_COLUMN_COUNT)
+#define RECORDING_INDEX_ENTRY_LENGTH 32
+#define RECORDING_TRAILER_MAGIC 0x58444952U			// "RIDX"
+#define RECORDING_TRAILER_LENGTH 16
+#define RECORDING_MAX_VARINT_LENGTH 10
+
+#define DEFAULT_QUEUE_CAPACITY 8192
+#define DEFAULT_SAMPLES_PER_BLOCK 1024
+#define WRITER_IDLE_TIMEOUT_NS 100000000L
+
+// Layout of the status column
+#define STATUS_STATE_SHIFT 8
+#define STATUS_DRIVING_DIRECTION_SHIFT 12
+#define STATUS_ARM_READINESS_SHIFT 14
+#define STATUS_VALIDITY_SHIFT 16
+#define VALID_TIMESTAMP 0x001
+#define VALID_X 0x002
+#define VALID_Y 0x004
+#define VALID_Z 0x008
+#define VALID_POSITION 0x010
+#define VALID_HEADING 0x020
+#define VALID_LONGITUDINAL_SPEED 0x040
+#define VALID_LATERAL_SPEED 0x080
+#define VALID_LONGITUDINAL_ACC 0x100
+#define VALID_LATERAL_ACC 0x200
+
+/*! Samples of one object not yet written to file */
+typedef struct {
+	uint32_t transmitterID;
+	MonitorSampleType* samples;
+	size_t nSamples;
+} PendingObjectType;
+
+struct MonitorRecorder {
+	int fd;
+	uint64_t fileOffset;
+	size_t samplesPerBlock;
+
+	// Single producer, single consumer queue between receive path and writer thread
+	MonitorRecordType* queue;
+	size_t queueMask;
+	atomic_size_t head;
+	atomic_size_t tail;
+
+	sem_t wakeup;
+	pthread_t writerThread;
+	atomic_bool isRunning;
+
+	// Owned by the writer thread until it has been joined
+	PendingObjectType* pending;
+	size_t nPending;
+	size_t pendingCapacity;
+	MonitorRecordingBlockType* index;
+	size_t nIndexEntries;
+	size_t indexCapacity;
+	uint8_t* blockBuffer;
+
+	atomic_uint_fast64_t submitted;
+	atomic_uint_fast64_t dropped;
+	atomic_uint_fast64_t blocksWritten;
+	atomic_uint_fast64_t bytesWritten;
+	atomic_int writeError;
+};
+
+/*! Reading position within one column of a block */
+typedef struct {
+	const uint8_t* p;
+	const uint8_t* end;
+	int64_t previous;
+	int64_t previousDelta;
+	size_t count;
+	bool isDeltaOfDelta;
+} ColumnCursorType;
+
+typedef struct {
+	uint32_t transmitterID;
+	uint32_t nSamples;
+	uint32_t payloadLength;
+	uint64_t firstGPSQms;
+	uint64_t lastGPSQms;
+	uint32_t columnOffsets[MONITOR_RECORDING_COLUMN_COUNT];
+} BlockHeaderType;
+
+static void* writerThreadMain(void* arg);
+static size_t drainQueue(MonitorRecorderType* recorder);
+static void appendRecord(MonitorRecorderType* recorder, const MonitorRecordType* record);
+static void writeBlock(MonitorRecorderType* recorder, PendingObjectType* object);
+static int writeIndex(MonitorRecorderType* recorder);
+static int writeFully(MonitorRecorderType* recorder, const uint8_t* data, const size_t length);
+static void freeRecorder(MonitorRecorderType* recorder);
+
+static int readIndexFromTrailer(MonitorRecordingType* recording);
+static int rebuildIndex(MonitorRecordingType* recording);
+static int parseBlockHeader(const MonitorRecordingType* recording, const uint64_t offset,
+							BlockHeaderType* header);
+static int compareBlocks(const void* a, const void* b);
+static int initColumnCursor(ColumnCursorType* cursor, const MonitorRecordingType* recording,
+							const size_t blockIndex, const MonitorRecordingColumnType column,
+							BlockHeaderType* header);
+static int readColumnValue(ColumnCursorType* cursor, int64_t* value);
+
+static int64_t getSampleColumnValue(const MonitorSampleType* sample, const MonitorRecordingColumnType column);
+static void setSampleColumnValue(MonitorSampleType* sample, const MonitorRecordingColumnType column,
+								 const int64_t value);
+
+static uint8_t* putVarint(uint8_t* p, const int64_t value);
+static const uint8_t* getVarint(const uint8_t* p, const uint8_t* end, int64_t* value);
+static uint8_t* putUint32(uint8_t* p, const uint32_t value);
+static uint8_t* putUint64(uint8_t* p, const uint64_t value);
+static uint32_t getUint32(const uint8_t* p);
+static uint64_t getUint64(const uint8_t* p);
+
+
+/*!
+ * \brief openMonitorRecorder Creates a recording file and starts a background thread writing
+ *			submitted monitor samples to it. Samples are collected per object and written as blocks
+ *			of delta encoded columns, followed by a block index when the recorder is closed.
+ * \param path Path of the file to be created, any existing file is truncated
+ * \param config Queue and block sizes, or NULL for defaults
+ * \return Recorder handle, or NULL with errno set on failure
+ */
+MonitorRecorderType* openMonitorRecorder(
+		const char* path,
+		const MonitorRecorderConfigType* config) {
+
+	const size_t queueCapacity = config != NULL && config->queueCapacity != 0 ?
+				config->queueCapacity : DEFAULT_QUEUE_CAPACITY;
+	const size_t samplesPerBlock = config != NULL && config->samplesPerBlock != 0 ?
+				config->samplesPerBlock : DEFAULT_SAMPLES_PER_BLOCK;
+	uint8_t fileHeader[RECORDING_FILE_HEADER_LENGTH] = { 0 };
+	MonitorRecorderType* recorder;
+	int error;
+
+	if (path == NULL || (queueCapacity & (queueCapacity - 1)) != 0 || samplesPerBlock > UINT32_MAX) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	recorder = calloc(1, sizeof (*recorder));
+	if (recorder == NULL) {
+		return NULL;
+	}
+	recorder->fd = -1;
+	recorder->samplesPerBlock = samplesPerBlock;
+	recorder->queueMask = queueCapacity - 1;
+	recorder->queue = malloc(queueCapacity * sizeof (*recorder->queue));
+	recorder->blockBuffer = malloc(RECORDING_BLOCK_HEADER_LENGTH
+								   + samplesPerBlock * MONITOR_RECORDING_COLUMN_COUNT * RECORDING_MAX_VARINT_LENGTH);
+	if (recorder->queue == NULL || recorder->blockBuffer == NULL) {
+		freeRecorder(recorder);
+		errno = ENOMEM;
+		return NULL;
+	}
+	atomic_init(&recorder->head, 0);
+	atomic_init(&recorder->tail, 0);
+	atomic_init(&recorder->isRunning, true);
+	atomic_init(&recorder->submitted, 0);
+	atomic_init(&recorder->dropped, 0);
+	atomic_init(&recorder->blocksWritten, 0);
+	atomic_init(&recorder->bytesWritten, 0);
+	atomic_init(&recorder->writeError, 0);
+
+	recorder->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (recorder->fd < 0) {
+		error = errno;
+		freeRecorder(recorder);
+		errno = error;
+		return NULL;
+	}
+
+	memcpy(fileHeader, RECORDING_FILE_MAGIC, RECORDING_FILE_MAGIC_LENGTH);
+	putUint32(fileHeader + RECORDING_FILE_MAGIC_LENGTH, RECORDING_FILE_VERSION);
+	if (writeFully(recorder, fileHeader, sizeof (fileHeader)) < 0) {
+		error = errno;
+		freeRecorder(recorder);
+		errno = error;
+		return NULL;
+	}
+
+	if (sem_init(&recorder->wakeup, 0, 0) < 0) {
+		error = errno;
+		freeRecorder(recorder);
+		errno = error;
+		return NULL;
+	}
+	if ((error = pthread_create(&recorder->writerThread, NULL, writerThreadMain, recorder)) != 0) {
+		sem_destroy(&recorder->wakeup);
+		freeRecorder(recorder);
+		errno = error;
+		return NULL;
+	}
+	return recorder;
+}
+
+/*!
+ * \brief submitMonitorRecords Queues records for writing without blocking. Records which do not fit
+ *			in the queue are dropped and counted. Must only be called from one thread at a time.
+ * \param recorder Recorder to which records are submitted
+ * \param records Records to be written
+ * \param nRecords Number of records
+ * \return Number of records queued, or -1 with errno set to EAGAIN if the queue was full, or EINVAL
+ */
+ssize_t submitMonitorRecords(
+		MonitorRecorderType* recorder,
+		const MonitorRecordType* records,
+		const size_t nRecords) {
+
+	size_t head, tail, nFree, nQueued;
+
+	if (recorder == NULL || (records == NULL && nRecords != 0)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	head = atomic_load_explicit(&recorder->head, memory_order_relaxed);
+	tail = atomic_load_explicit(&recorder->tail, memory_order_acquire);
+	nFree = recorder->queueMask + 1 - (head - tail);
+	nQueued = nRecords < nFree ? nRecords : nFree;
+
+	for (size_t i = 0; i < nQueued; ++i) {
+		recorder->queue[(head + i) & recorder->queueMask] = records[i];
+	}
+	atomic_store_explicit(&recorder->head, head + nQueued, memory_order_release);
+
+	atomic_fetch_add_explicit(&recorder->submitted, nQueued, memory_order_relaxed);
+	if (nQueued < nRecords) {
+		atomic_fetch_add_explicit(&recorder->dropped, nRecords - nQueued, memory_order_relaxed);
+	}
+	if (nQueued > 0) {
+		sem_post(&recorder->wakeup);
+	}
+	else if (nRecords > 0) {
+		errno = EAGAIN;
+		return -1;
+	}
+	return (ssize_t) nQueued;
+}
+
+/*!
+ * \brief getMonitorRecorderStatistics Reads the counters of a recorder
+ * \param recorder Recorder to read counters of
+ * \param statistics Struct to be filled
+ */
+void getMonitorRecorderStatistics(
+		MonitorRecorderType* recorder,
+		MonitorRecorderStatisticsType* statistics) {
+
+	if (recorder == NULL || statistics == NULL) {
+		return;
+	}
+	statistics->submitted = atomic_load(&recorder->submitted);
+	statistics->dropped = atomic_load(&recorder->dropped);
+	statistics->blocksWritten = atomic_load(&recorder->blocksWritten);
+	statistics->bytesWritten = atomic_load(&recorder->bytesWritten);
+	statistics->writeError = atomic_load(&recorder->writeError);
+}
+
+/*!
+ * \brief closeMonitorRecorder Stops the writer thread, writes all queued and pending samples followed
+ *			by the block index, and frees the recorder
+ * \param recorder Recorder to be closed
+ * \return 0 on success, -1 with errno set if any write failed
+ */
+int closeMonitorRecorder(MonitorRecorderType* recorder) {
+
+	int error;
+
+	if (recorder == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	atomic_store(&recorder->isRunning, false);
+	sem_post(&recorder->wakeup);
+	pthread_join(recorder->writerThread, NULL);
+	sem_destroy(&recorder->wakeup);
+
+	drainQueue(recorder);
+	for (size_t i = 0; i < recorder->nPending; ++i) {
+		writeBlock(recorder, &recorder->pending[i]);
+	}
+	writeIndex(recorder);
+
+	if (close(recorder->fd) < 0) {
+		int expected = 0;
+		atomic_compare_exchange_strong(&recorder->writeError, &expected, errno);
+	}
+	recorder->fd = -1;
+
+	error = atomic_load(&recorder->writeError);
+	freeRecorder(recorder);
+	if (error != 0) {
+		errno = error;
+		return -1;
+	}
+	return 0;
+}
+
+/*!
+ * \brief openMonitorRecording Maps a recording file into memory. The block index is read from the end
+ *			of the file, or rebuilt by scanning the blocks if the recorder was not closed properly.
+ * \param path Path of the recording
+ * \param recording View to be filled
+ * \return 0 on success, -1 with errno set otherwise
+ */
+int openMonitorRecording(
+		const char* path,
+		MonitorRecordingType* recording) {
+
+	struct stat fileStatus;
+	void* data;
+	int fd, error;
+
+	if (path == NULL || recording == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	memset(recording, 0, sizeof (*recording));
+
+	if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0) {
+		return -1;
+	}
+	if (fstat(fd, &fileStatus) < 0) {
+		error = errno;
+		close(fd);
+		errno = error;
+		return -1;
+	}
+	if ((size_t) fileStatus.st_size < RECORDING_FILE_HEADER_LENGTH) {
+		close(fd);
+		errno = EBADMSG;
+		return -1;
+	}
+
+	data = mmap(NULL, (size_t) fileStatus.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	error = errno;
+	close(fd);
+	if (data == MAP_FAILED) {
+		errno = error;
+		return -1;
+	}
+	recording->data = data;
+	recording->size = (size_t) fileStatus.st_size;
+
+	if (memcmp(recording->data, RECORDING_FILE_MAGIC, RECORDING_FILE_MAGIC_LENGTH) != 0
+			|| getUint32(recording->data + RECORDING_FILE_MAGIC_LENGTH) != RECORDING_FILE_VERSION) {
+		closeMonitorRecording(recording);
+		errno = EBADMSG;
+		return -1;
+	}
+
+	if (readIndexFromTrailer(recording) < 0) {
+		if (rebuildIndex(recording) < 0) {
+			error = errno;
+			closeMonitorRecording(recording);
+			errno = error;
+			return -1;
+		}
+		recording->isIndexRebuilt = 1;
+	}
+	qsort(recording->blocks, recording->nBlocks, sizeof (*recording->blocks), compareBlocks);
+	return 0;
+}
+
+/*!
+ * \brief closeMonitorRecording Unmaps a recording and frees its index
+ * \param recording Recording to be closed
+ */
+void closeMonitorRecording(MonitorRecordingType* recording) {
+	if (recording == NULL) {
+		return;
+	}
+	if (recording->data != NULL) {
+		munmap((void*) recording->data, recording->size);
+	}
+	free(recording->blocks);
+	memset(recording, 0, sizeof (*recording));
+}
+
+/*!
+ * \brief findMonitorRecordingBlock Finds the block of an object containing a point in time
+ * \param recording Recording to search
+ * \param transmitterID Object to search for
+ * \param gpsQms Time since GPS epoch [¼ ms], see ::getMonitorSampleGPSQms
+ * \return Index of the last block starting at or before the given time, or the first block of the
+ *			object if the time precedes it. -1 with errno set to ENOENT if the object was not recorded.
+ */
+ssize_t findMonitorRecordingBlock(
+		const MonitorRecordingType* recording,
+		const uint32_t transmitterID,
+		const uint64_t gpsQms) {
+
+	size_t low = 0, high;
+
+	if (recording == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	// Find first block which is after the sought time, or belongs to a later object
+	high = recording->nBlocks;
+	while (low < high) {
+		const size_t mid = low + (high - low) / 2;
+		const MonitorRecordingBlockType* block = &recording->blocks[mid];
+
+		if (block->transmitterID < transmitterID
+				|| (block->transmitterID == transmitterID && block->firstGPSQms <= gpsQms)) {
+			low = mid + 1;
+		}
+		else {
+			high = mid;
+		}
+	}
+
+	if (low > 0 && recording->blocks[low - 1].transmitterID == transmitterID) {
+		return (ssize_t) (low - 1);
+	}
+	if (low < recording->nBlocks && recording->blocks[low].transmitterID == transmitterID) {
+		return (ssize_t) low;
+	}
+	errno = ENOENT;
+	return -1;
+}
+
+/*!
+ * \brief decodeMonitorRecordingBlock Decodes all samples of a block directly from the mapped file
+ * \param recording Recording containing the block
+ * \param blockIndex Index of the block in the recording
+ * \param samples Array in which to place decoded samples
+ * \param capacity Number of elements in samples
+ * \return Number of samples decoded, or -1 with errno set to EINVAL, ENOBUFS or EBADMSG
+ */
+ssize_t decodeMonitorRecordingBlock(
+		const MonitorRecordingType* recording,
+		const size_t blockIndex,
+		MonitorSampleType* samples,
+		const size_t capacity) {
+
+	ColumnCursorType cursors[MONITOR_RECORDING_COLUMN_COUNT];
+	BlockHeaderType header;
+
+	if (samples == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	for (int c = 0; c < MONITOR_RECORDING_COLUMN_COUNT; ++c) {
+		if (initColumnCursor(&cursors[c], recording, blockIndex, (MonitorRecordingColumnType) c, &header) < 0) {
+			return -1;
+		}
+	}
+	if (capacity < header.nSamples) {
+		errno = ENOBUFS;
+		return -1;
+	}
+
+	for (size_t i = 0; i < header.nSamples; ++i) {
+		int64_t value;
+
+		memset(&samples[i], 0, sizeof (samples[i]));
+		// Status holds the validity flags needed to interpret the timestamp, so it is decoded first
+		for (int c = MONITOR_RECORDING_COLUMN_COUNT - 1; c >= 0; --c) {
+			if (readColumnValue(&cursors[c], &value) < 0) {
+				return -1;
+			}
+			setSampleColumnValue(&samples[i], (MonitorRecordingColumnType) c, value);
+		}
+	}
+	return header.nSamples;
+}
+
+/*!
+ * \brief decodeMonitorRecordingColumn Decodes a single column of a block, e.g. for scanning one field
+ *			across a long recording without decoding the others
+ * \param recording Recording containing the block
+ * \param blockIndex Index of the block in the recording
+ * \param column Column to decode
+ * \param values Array in which to place decoded values, in ISO units. Time is given since GPS epoch.
+ * \param capacity Number of elements in values
+ * \return Number of values decoded, or -1 with errno set to EINVAL, ENOBUFS or EBADMSG
+ */
+ssize_t decodeMonitorRecordingColumn(
+		const MonitorRecordingType* recording,
+		const size_t blockIndex,
+		const MonitorRecordingColumnType column,
+		int64_t* values,
+		const size_t capacity) {
+
+	ColumnCursorType cursor;
+	BlockHeaderType header;
+
+	if (values == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (initColumnCursor(&cursor, recording, blockIndex, column, &header) < 0) {
+		return -1;
+	}
+	if (capacity < header.nSamples) {
+		errno = ENOBUFS;
+		return -1;
+	}
+	for (size_t i = 0; i < header.nSamples; ++i) {
+		if (readColumnValue(&cursor, &values[i]) < 0) {
+			return -1;
+		}
+	}
+	return header.nSamples;
+}
+
+
+static void* writerThreadMain(void* arg) {
+	MonitorRecorderType* recorder = arg;
+	struct timespec deadline;
+
+	while (atomic_load(&recorder->isRunning)) {
+		if (drainQueue(recorder) == 0) {
+			clock_gettime(CLOCK_REALTIME, &deadline);
+			deadline.tv_nsec += WRITER_IDLE_TIMEOUT_NS;
+			if (deadline.tv_nsec >= 1000000000L) {
+				deadline.tv_sec++;
+				deadline.tv_nsec -= 1000000000L;
+			}
+			sem_timedwait(&recorder->wakeup, &deadline);
+		}
+	}
+	return NULL;
+}
+
+static size_t drainQueue(MonitorRecorderType* recorder) {
+	const size_t tail = atomic_load_explicit(&recorder->tail, memory_order_relaxed);
+	const size_t head = atomic_load_explicit(&recorder->head, memory_order_acquire);
+
+	for (size_t i = tail; i != head; ++i) {
+		appendRecord(recorder, &recorder->queue[i & recorder->queueMask]);
+	}
+	atomic_store_explicit(&recorder->tail, head, memory_order_release);
+	return head - tail;
+}
+
+static void appendRecord(
+		MonitorRecorderType* recorder,
+		const MonitorRecordType* record) {
+
+	PendingObjectType* object = NULL;
+
+	for (size_t i = 0; i < recorder->nPending; ++i) {
+		if (recorder->pending[i].transmitterID == record->transmitterID) {
+			object = &recorder->pending[i];
+			break;
+		}
+	}
+
+	if (object == NULL) {
+		if (recorder->nPending == recorder->pendingCapacity) {
+			const size_t newCapacity = recorder->pendingCapacity ? 2 * recorder->pendingCapacity : 16;
+			PendingObjectType* newPending = realloc(recorder->pending, newCapacity * sizeof (*newPending));
+
+			if (newPending == NULL) {
+				atomic_fetch_add(&recorder->dropped, 1);
+				return;
+			}
+			recorder->pending = newPending;
+			recorder->pendingCapacity = newCapacity;
+		}
+		object = &recorder->pending[recorder->nPending];
+		object->samples = malloc(recorder->samplesPerBlock * sizeof (*object->samples));
+		if (object->samples == NULL) {
+			atomic_fetch_add(&recorder->dropped, 1);
+			return;
+		}
+		object->transmitterID = record->transmitterID;
+		object->nSamples = 0;
+		recorder->nPending++;
+	}
+
+	object->samples[object->nSamples++] = record->sample;
+	if (object->nSamples == recorder->samplesPerBlock) {
+		writeBlock(recorder, object);
+	}
+}
+
+static void writeBlock(
+		MonitorRecorderType* recorder,
+		PendingObjectType* object) {
+
+	uint8_t* const payload = recorder->blockBuffer + RECORDING_BLOCK_HEADER_LENGTH;
+	uint8_t* p = payload;
+	uint32_t columnOffsets[MONITOR_RECORDING_COLUMN_COUNT];
+	uint64_t firstGPSQms = 0, lastGPSQms = 0;
+	MonitorRecordingBlockType* entry;
+	uint8_t* h = recorder->blockBuffer;
+
+	if (object->nSamples == 0) {
+		return;
+	}
+
+	for (int c = 0; c < MONITOR_RECORDING_COLUMN_COUNT; ++c) {
+		int64_t previous = 0, previousDelta = 0;
+
+		columnOffsets[c] = (uint32_t) (p - payload);
+		for (size_t i = 0; i < object->nSamples; ++i) {
+			int64_t value = getSampleColumnValue(&object->samples[i], (MonitorRecordingColumnType) c);
+
+			if (c == MONITOR_RECORDING_COLUMN_TIME) {
+				// Invalid timestamps repeat the previous one to keep the delta-of-delta small
+				if (!object->samples[i].isTimestampValid) {
+					value = previous;
+				}
+				if (i == 0) {
+					p = putVarint(p, value);
+					firstGPSQms = (uint64_t) value;
+				}
+				else {
+					p = putVarint(p, (value - previous) - previousDelta);
+					previousDelta = value - previous;
+				}
+				lastGPSQms = (uint64_t) value;
+			}
+			else {
+				p = putVarint(p, value - previous);
+			}
+			previous = value;
+		}
+	}
+
+	h = putUint32(h, RECORDING_BLOCK_MAGIC);
+	h = putUint32(h, object->transmitterID);
+	h = putUint32(h, (uint32_t) object->nSamples);
+	h = putUint32(h, (uint32_t) (p - payload));
+	h = putUint32(h, 0);
+	h = putUint32(h, 0);
+	h = putUint64(h, firstGPSQms);
+	h = putUint64(h, lastGPSQms);
+	for (int c = 0; c < MONITOR_RECORDING_COLUMN_COUNT; ++c) {
+		h = putUint32(h, columnOffsets[c]);
+	}
+
+	if (recorder->nIndexEntries == recorder->indexCapacity) {
+		const size_t newCapacity = recorder->indexCapacity ? 2 * recorder->indexCapacity : 64;
+		MonitorRecordingBlockType* newIndex = realloc(recorder->index, newCapacity * sizeof (*newIndex));
+
+		if (newIndex == NULL) {
+			int expected = 0;
+			atomic_compare_exchange_strong(&recorder->writeError, &expected, ENOMEM);
+			object->nSamples = 0;
+			return;
+		}
+		recorder->index = newIndex;
+		recorder->indexCapacity = newCapacity;
+	}
+	entry = &recorder->index[recorder->nIndexEntries];
+	entry->transmitterID = object->transmitterID;
+	entry->nSamples = (uint32_t) object->nSamples;
+	entry->firstGPSQms = firstGPSQms;
+	entry->lastGPSQms = lastGPSQms;
+	entry->offset = recorder->fileOffset;
+
+	if (writeFully(recorder, recorder->blockBuffer, (size_t) (p - recorder->blockBuffer)) == 0) {
+		recorder->nIndexEntries++;
+		atomic_fetch_add(&recorder->blocksWritten, 1);
+	}
+	object->nSamples = 0;
+}
+
+static int writeIndex(MonitorRecorderType* recorder) {
+	uint8_t entry[RECORDING_INDEX_ENTRY_LENGTH];
+	uint8_t trailer[RECORDING_TRAILER_LENGTH];
+	const uint64_t indexOffset = recorder->fileOffset;
+
+	qsort(recorder->index, recorder->nIndexEntries, sizeof (*recorder->index), compareBlocks);
+	for (size_t i = 0; i < recorder->nIndexEntries; ++i) {
+		uint8_t* p = entry;
+
+		p = putUint32(p, recorder->index[i].transmitterID);
+		p = putUint32(p, recorder->index[i].nSamples);
+		p = putUint64(p, recorder->index[i].firstGPSQms);
+		p = putUint64(p, recorder->index[i].lastGPSQms);
+		putUint64(p, recorder->index[i].offset);
+		if (writeFully(recorder, entry, sizeof (entry)) < 0) {
+			return -1;
+		}
+	}
+	putUint32(putUint32(putUint64(trailer, indexOffset), (uint32_t) recorder->nIndexEntries),
+			  RECORDING_TRAILER_MAGIC);
+	return writeFully(recorder, trailer, sizeof (trailer));
+}
+
+static int writeFully(
+		MonitorRecorderType* recorder,
+		const uint8_t* data,
+		const size_t length) {
+
+	size_t written = 0;
+
+	if (atomic_load(&recorder->writeError) != 0) {
+		errno = atomic_load(&recorder->writeError);
+		return -1;
+	}
+	while (written < length) {
+		const ssize_t result = write(recorder->fd, data + written, length - written);
+
+		if (result < 0) {
+			int expected = 0;
+
+			if (errno == EINTR) {
+				continue;
+			}
+			atomic_compare_exchange_strong(&recorder->writeError, &expected, errno);
+			return -1;
+		}
+		written += (size_t) result;
+	}
+	recorder->fileOffset += length;
+	atomic_fetch_add(&recorder->bytesWritten, length);
+	return 0;
+}
+
+static void freeRecorder(MonitorRecorderType* recorder) {
+	if (recorder->fd >= 0) {
+		close(recorder->fd);
+	}
+	for (size_t i = 0; i < recorder->nPending; ++i) {
+		free(recorder->pending[i].samples);
+	}
+	free(recorder->pending);
+	free(recorder->index);
+	free(recorder->blockBuffer);
+	free(recorder->queue);
+	free(recorder);
+}
+
+
+static int readIndexFromTrailer(MonitorRecordingType* recording) {
+	const uint8_t* trailer;
+	uint64_t indexOffset;
+	uint32_t nEntries;
+
+	if (recording->size < RECORDING_FILE_HEADER_LENGTH + RECORDING_TRAILER_LENGTH) {
+		return -1;
+	}
+	trailer = recording->data + recording->size - RECORDING_TRAILER_LENGTH;
+	indexOffset = getUint64(trailer);
+	nEntries = getUint32(trailer + 8);
+	if (getUint32(trailer + 12) != RECORDING_TRAILER_MAGIC
+			|| indexOffset < RECORDING_FILE_HEADER_LENGTH
+			|| indexOffset + (uint64_t) nEntries * RECORDING_INDEX_ENTRY_LENGTH
+			!= recording->size - RECORDING_TRAILER_LENGTH) {
+		return -1;
+	}
+
+	recording->blocks = malloc((nEntries ? nEntries : 1) * sizeof (*recording->blocks));
+	if (recording->blocks == NULL) {
+		return -1;
+	}
+	for (uint32_t i = 0; i < nEntries; ++i) {
+		const uint8_t* p = recording->data + indexOffset + (uint64_t) i * RECORDING_INDEX_ENTRY_LENGTH;
+		MonitorRecordingBlockType* block = &recording->blocks[i];
+		BlockHeaderType header;
+
+		block->transmitterID = getUint32(p);
+		block->nSamples = getUint32(p + 4);
+		block->firstGPSQms = getUint64(p + 8);
+		block->lastGPSQms = getUint64(p + 16);
+		block->offset = getUint64(p + 24);
+		if (parseBlockHeader(recording, block->offset, &header) < 0
+				|| header.transmitterID != block->transmitterID || header.nSamples != block->nSamples) {
+			free(recording->blocks);
+			recording->blocks = NULL;
+			return -1;
+		}
+	}
+	recording->nBlocks = nEntries;
+	return 0;
+}
+
+static int rebuildIndex(MonitorRecordingType* recording) {
+	uint64_t offset = RECORDING_FILE_HEADER_LENGTH;
+	size_t capacity = 0;
+	BlockHeaderType header;
+
+	recording->nBlocks = 0;
+	while (parseBlockHeader(recording, offset, &header) == 0) {
+		MonitorRecordingBlockType* block;
+
+		if (recording->nBlocks == capacity) {
+			const size_t newCapacity = capacity ? 2 * capacity : 64;
+			MonitorRecordingBlockType* newBlocks = realloc(recording->blocks, newCapacity * sizeof (*newBlocks));
+
+			if (newBlocks == NULL) {
+				errno = ENOMEM;
+				return -1;
+			}
+			recording->blocks = newBlocks;
+			capacity = newCapacity;
+		}
+		block = &recording->blocks[recording->nBlocks++];
+		block->transmitterID = header.transmitterID;
+		block->nSamples = header.nSamples;
+		block->firstGPSQms = header.firstGPSQms;
+		block->lastGPSQms = header.lastGPSQms;
+		block->offset = offset;
+		offset += RECORDING_BLOCK_HEADER_LENGTH + header.payloadLength;
+	}
+	return 0;
+}
+
+static int parseBlockHeader(
+		const MonitorRecordingType* recording,
+		const uint64_t offset,
+		BlockHeaderType* header) {
+
+	const uint8_t* p = recording->data + offset;
+
+	if (offset + RECORDING_BLOCK_HEADER_LENGTH > recording->size
+			|| getUint32(p) != RECORDING_BLOCK_MAGIC) {
+		errno = EBADMSG;
+		return -1;
+	}
+	header->transmitterID = getUint32(p + 4);
+	header->nSamples = getUint32(p + 8);
+	header->payloadLength = getUint32(p + 12);
+	header->firstGPSQms = getUint64(p + 24);
+	header->lastGPSQms = getUint64(p + 32);
+	for (int c = 0; c < MONITOR_RECORDING_COLUMN_COUNT; ++c) {
+		header->columnOffsets[c] = getUint32(p + 40 + 4 * c);
+		if (header->columnOffsets[c] > header->payloadLength
+				|| (c > 0 && header->columnOffsets[c] < header->columnOffsets[c - 1])) {
+			errno = EBADMSG;
+			return -1;
+		}
+	}
+	if (offset + RECORDING_BLOCK_HEADER_LENGTH + header->payloadLength > recording->size) {
+		errno = EBADMSG;
+		return -1;
+	}
+	return 0;
+}
+
+static int compareBlocks(const void* a, const void* b) {
+	const MonitorRecordingBlockType* blockA = a;
+	const MonitorRecordingBlockType* blockB = b;
+
+	if (blockA->transmitterID != blockB->transmitterID) {
+		return blockA->transmitterID < blockB->transmitterID ? -1 : 1;
+	}
+	if (blockA->firstGPSQms != blockB->firstGPSQms) {
+		return blockA->firstGPSQms < blockB->firstGPSQms ? -1 : 1;
+	}
+	return blockA->offset < blockB->offset ? -1 : blockA->offset > blockB->offset;
+}
+
+static int initColumnCursor(
+		ColumnCursorType* cursor,
+		const MonitorRecordingType* recording,
+		const size_t blockIndex,
+		const MonitorRecordingColumnType column,
+		BlockHeaderType* header) {
+
+	const uint8_t* payload;
+
+	if (recording == NULL || blockIndex >= recording->nBlocks
+			|| column < 0 || column >= MONITOR_RECORDING_COLUMN_COUNT) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (parseBlockHeader(recording, recording->blocks[blockIndex].offset, header) < 0) {
+		return -1;
+	}
+	payload = recording->data + recording->blocks[blockIndex].offset + RECORDING_BLOCK_HEADER_LENGTH;
+	cursor->p = payload + header->columnOffsets[column];
+	cursor->end = payload + (column + 1 < MONITOR_RECORDING_COLUMN_COUNT ?
+								 header->columnOffsets[column + 1] : header->payloadLength);
+	cursor->previous = 0;
+	cursor->previousDelta = 0;
+	cursor->count = 0;
+	cursor->isDeltaOfDelta = column == MONITOR_RECORDING_COLUMN_TIME;
+	return 0;
+}
+
+static int readColumnValue(
+		ColumnCursorType* cursor,
+		int64_t* value) {
+
+	int64_t encoded;
+
+	if ((cursor->p = getVarint(cursor->p, cursor->end, &encoded)) == NULL) {
+		errno = EBADMSG;
+		return -1;
+	}
+	if (!cursor->isDeltaOfDelta) {
+		cursor->previous += encoded;
+	}
+	else if (cursor->count == 0) {
+		cursor->previous = encoded;
+	}
+	else {
+		cursor->previousDelta += encoded;
+		cursor->previous += cursor->previousDelta;
+	}
+	cursor->count++;
+	*value = cursor->previous;
+	return 0;
+}
+
+
+static int64_t getSampleColumnValue(
+		const MonitorSampleType* sample,
+		const MonitorRecordingColumnType column) {
+
+	switch (column) {
+	case MONITOR_RECORDING_COLUMN_TIME:
+		return (int64_t) getMonitorSampleGPSQms(sample);
+	case MONITOR_RECORDING_COLUMN_X:
+		return sample->xPosition;
+	case MONITOR_RECORDING_COLUMN_Y:
+		return sample->yPosition;
+	case MONITOR_RECORDING_COLUMN_Z:
+		return sample->zPosition;
+	case MONITOR_RECORDING_COLUMN_YAW:
+		return sample->yaw;
+	case MONITOR_RECORDING_COLUMN_LONGITUDINAL_SPEED:
+		return sample->longitudinalSpeed;
+	case MONITOR_RECORDING_COLUMN_LATERAL_SPEED:
+		return sample->lateralSpeed;
+	case MONITOR_RECORDING_COLUMN_LONGITUDINAL_ACC:
+		return sample->longitudinalAcc;
+	case MONITOR_RECORDING_COLUMN_LATERAL_ACC:
+		return sample->lateralAcc;
+	case MONITOR_RECORDING_COLUMN_STATUS:
+		return (int64_t) sample->errorStatus
+				| (int64_t) sample->state << STATUS_STATE_SHIFT
+				| (int64_t) sample->drivingDirection << STATUS_DRIVING_DIRECTION_SHIFT
+				| (int64_t) sample->armReadiness << STATUS_ARM_READINESS_SHIFT
+				| (int64_t) ((sample->isTimestampValid ? VALID_TIMESTAMP : 0)
+							 | (sample->isXcoordValid ? VALID_X : 0)
+							 | (sample->isYcoordValid ? VALID_Y : 0)
+							 | (sample->isZcoordValid ? VALID_Z : 0)
+							 | (sample->isPositionValid ? VALID_POSITION : 0)
+							 | (sample->isHeadingValid ? VALID_HEADING : 0)
+							 | (sample->isLongitudinalSpeedValid ? VALID_LONGITUDINAL_SPEED : 0)
+							 | (sample->isLateralSpeedValid ? VALID_LATERAL_SPEED : 0)
+							 | (sample->isLongitudinalAccValid ? VALID_LONGITUDINAL_ACC : 0)
+							 | (sample->isLateralAccValid ? VALID_LATERAL_ACC : 0)) << STATUS_VALIDITY_SHIFT;
+	default:
+		return 0;
+	}
+}
+
+static void setSampleColumnValue(
+		MonitorSampleType* sample,
+		const MonitorRecordingColumnType column,
+		const int64_t value) {
+
+	const uint32_t validity = (uint32_t) (value >> STATUS_VALIDITY_SHIFT);
+
+	switch (column) {
+	case MONITOR_RECORDING_COLUMN_TIME:
+		if (sample->isTimestampValid) {
+			sample->gpsWeek = (uint16_t) ((uint64_t) value / WEEK_TIME_QMS);
+			sample->gpsQmsOfWeek = (uint32_t) ((uint64_t) value % WEEK_TIME_QMS);
+		}
+		else {
+			sample->gpsWeek = GPS_WEEK_UNAVAILABLE_VALUE;
+			sample->gpsQmsOfWeek = GPS_SECOND_OF_WEEK_UNAVAILABLE_VALUE;
+		}
+		break;
+	case MONITOR_RECORDING_COLUMN_X:
+		sample->xPosition = (int32_t) value;
+		break;
+	case MONITOR_RECORDING_COLUMN_Y:
+		sample->yPosition = (int32_t) value;
+		break;
+	case MONITOR_RECORDING_COLUMN_Z:
+		sample->zPosition = (int32_t) value;
+		break;
+	case MONITOR_RECORDING_COLUMN_YAW:
+		sample->yaw = (uint16_t) value;
+		break;
+	case MONITOR_RECORDING_COLUMN_LONGITUDINAL_SPEED:
+		sample->longitudinalSpeed = (int16_t) value;
+		break;
+	case MONITOR_RECORDING_COLUMN_LATERAL_SPEED:
+		sample->lateralSpeed = (int16_t) value;
+		break;
+	case MONITOR_RECORDING_COLUMN_LONGITUDINAL_ACC:
+		sample->longitudinalAcc = (int16_t) value;
+		break;
+	case MONITOR_RECORDING_COLUMN_LATERAL_ACC:
+		sample->lateralAcc = (int16_t) value;
+		break;
+	case MONITOR_RECORDING_COLUMN_STATUS:
+		sample->errorStatus = (uint8_t) value;
+		sample->state = (uint8_t) (value >> STATUS_STATE_SHIFT) & 0x0F;
+		sample->drivingDirection = (uint8_t) (value >> STATUS_DRIVING_DIRECTION_SHIFT) & 0x03;
+		sample->armReadiness = (uint8_t) (value >> STATUS_ARM_READINESS_SHIFT) & 0x03;
+		sample->isTimestampValid = (validity & VALID_TIMESTAMP) != 0;
+		sample->isXcoordValid = (validity & VALID_X) != 0;
+		sample->isYcoordValid = (validity & VALID_Y) != 0;
+		sample->isZcoordValid = (validity & VALID_Z) != 0;
+		sample->isPositionValid = (validity & VALID_POSITION) != 0;
+		sample->isHeadingValid = (validity & VALID_HEADING) != 0;
+		sample->isLongitudinalSpeedValid = (validity & VALID_LONGITUDINAL_SPEED) != 0;
+		sample->isLateralSpeedValid = (validity & VALID_LATERAL_SPEED) != 0;
+		sample->isLongitudinalAccValid = (validity & VALID_LONGITUDINAL_ACC) != 0;
+		sample->isLateralAccValid = (validity & VALID_LATERAL_ACC) != 0;
+		break;
+	default:
+		break;
+	}
+}
+
+
+//! Writes a zig-zag encoded LEB128 varint, so that small negative values are also short
+static uint8_t* putVarint(uint8_t* p, const int64_t value) {
+	uint64_t zigzag = ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+
+	while (zigzag >= 0x80) {
+		*p++ = (uint8_t) (zigzag | 0x80);
+		zigzag >>= 7;
+	}
+	*p++ = (uint8_t) zigzag;
+	return p;
+}
+
+static const uint8_t* getVarint(const uint8_t* p, const uint8_t* end, int64_t* value) {
+	uint64_t zigzag = 0;
+
+	for (unsigned int shift = 0; shift < 64; shift += 7) {
+		if (p == NULL || p >= end) {
+			return NULL;
+		}
+		zigzag |= (uint64_t) (*p & 0x7F) << shift;
+		if ((*p++ & 0x80) == 0) {
+			*value = (int64_t) (zigzag >> 1) ^ -(int64_t) (zigzag & 1);
+			return p;
+		}
+	}
+	return NULL;
+}
+
+static uint8_t* putUint32(uint8_t* p, const uint32_t value) {
+	for (int i = 0; i < 4; ++i) {
+		*p++ = (uint8_t) (value >> (8 * i));
+	}
+	return p;
+}
+
+static uint8_t* putUint64(uint8_t* p, const uint64_t value) {
+	return putUint32(putUint32(p, (uint32_t) value), (uint32_t) (value >> 32));
+}
+
+static uint32_t getUint32(const uint8_t* p) {
+	return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+static uint64_t getUint64(const uint8_t* p) {
+	return (uint64_t) getUint32(p) | (uint64_t) getUint32(p + 4) << 32;
+}
@@ -0,0 +1,158 @@
+#include "monitorsample.h"
+#include <string.h>
+
+static int32_t toFixedPoint32(const double value, const double oneUnitValue);
+static int16_t toFixedPoint16(const double value, const double oneUnitValue);
+static uint16_t headingToISOYaw(const double heading_rad);
+
+
+/*!
+ * \brief convertObjectMonitorToSamples Converts an array of monitor data to compact samples. Values
+ *			are rounded to the nearest ISO fixed point unit.
+ * \param monitorData Array of monitor data to be converted
+ * \param samples Array in which to place converted samples
+ * \param nSamples Number of elements in both arrays
+ */
+void convertObjectMonitorToSamples(
+		const ObjectMonitorType* monitorData,
+		MonitorSampleType* samples,
+		const size_t nSamples) {
+
+	for (size_t i = 0; i < nSamples; ++i) {
+		const ObjectMonitorType* in = &monitorData[i];
+		MonitorSampleType* out = &samples[i];
+		int64_t qmsOfWeek = -1;
+		int32_t week = -1;
+
+		memset(out, 0, sizeof (*out));
+
+		if (in->isTimestampValid) {
+			qmsOfWeek = getAsGPSQuarterMillisecondOfWeek(&in->timestamp);
+			week = getAsGPSWeek(&in->timestamp);
+		}
+		out->isTimestampValid = qmsOfWeek >= 0 && week >= 0;
+		out->gpsQmsOfWeek = out->isTimestampValid ? (uint32_t) qmsOfWeek : GPS_SECOND_OF_WEEK_UNAVAILABLE_VALUE;
+		out->gpsWeek = out->isTimestampValid ? (uint16_t) week : GPS_WEEK_UNAVAILABLE_VALUE;
+
+		out->isXcoordValid = in->position.isXcoordValid;
+		out->isYcoordValid = in->position.isYcoordValid;
+		out->isZcoordValid = in->position.isZcoordValid;
+		out->isPositionValid = in->position.isPositionValid;
+		out->isHeadingValid = in->position.isHeadingValid;
+		out->xPosition = in->position.isXcoordValid ?
+					toFixedPoint32(in->position.xCoord_m, POSITION_ONE_METER_VALUE) : POSITION_UNAVAILABLE_VALUE;
+		out->yPosition = in->position.isYcoordValid ?
+					toFixedPoint32(in->position.yCoord_m, POSITION_ONE_METER_VALUE) : POSITION_UNAVAILABLE_VALUE;
+		out->zPosition = in->position.isZcoordValid ?
+					toFixedPoint32(in->position.zCoord_m, POSITION_ONE_METER_VALUE) : POSITION_UNAVAILABLE_VALUE;
+		out->yaw = in->position.isHeadingValid ?
+					headingToISOYaw(in->position.heading_rad) : YAW_UNAVAILABLE_VALUE;
+
+		out->isLongitudinalSpeedValid = in->speed.isLongitudinalValid;
+		out->isLateralSpeedValid = in->speed.isLateralValid;
+		out->longitudinalSpeed = in->speed.isLongitudinalValid ?
+					toFixedPoint16(in->speed.longitudinal_m_s, SPEED_ONE_METER_PER_SECOND_VALUE)
+				  : SPEED_UNAVAILABLE_VALUE;
+		out->lateralSpeed = in->speed.isLateralValid ?
+					toFixedPoint16(in->speed.lateral_m_s, SPEED_ONE_METER_PER_SECOND_VALUE)
+				  : SPEED_UNAVAILABLE_VALUE;
+
+		out->isLongitudinalAccValid = in->acceleration.isLongitudinalValid;
+		out->isLateralAccValid = in->acceleration.isLateralValid;
+		out->longitudinalAcc = in->acceleration.isLongitudinalValid ?
+					toFixedPoint16(in->acceleration.longitudinal_m_s2, ACCELERATION_ONE_METER_PER_SECOND_SQUARED_VALUE)
+				  : ACCELERATION_UNAVAILABLE_VALUE;
+		out->lateralAcc = in->acceleration.isLateralValid ?
+					toFixedPoint16(in->acceleration.lateral_m_s2, ACCELERATION_ONE_METER_PER_SECOND_SQUARED_VALUE)
+				  : ACCELERATION_UNAVAILABLE_VALUE;
+
+		out->drivingDirection = in->drivingDirection;
+		out->state = in->state;
+		out->armReadiness = in->armReadiness;
+
+		out->errorStatus = (uint8_t) ((in->error.abortRequest ? BITMASK_ERROR_ABORT_REQUEST : 0)
+				| (in->error.outsideGeofence ? BITMASK_ERROR_OUTSIDE_GEOFENCE : 0)
+				| (in->error.badPositioningAccuracy ? BITMASK_ERROR_BAD_POSITIONING_ACCURACY : 0)
+				| (in->error.engineFault ? BITMASK_ERROR_ENGINE_FAULT : 0)
+				| (in->error.batteryFault ? BITMASK_ERROR_BATTERY_FAULT : 0)
+				| (in->error.syncPointEnded ? BITMASK_ERROR_SYNC_POINT_ENDED : 0)
+				| (in->error.unknownError ? BITMASK_ERROR_OTHER : 0));
+	}
+}
+
+/*!
+ * \brief convertSamplesToObjectMonitor Converts an array of compact samples to monitor data
+ * \param samples Array of samples to be converted
+ * \param monitorData Array in which to place converted monitor data
+ * \param nSamples Number of elements in both arrays
+ */
+void convertSamplesToObjectMonitor(
+		const MonitorSampleType* samples,
+		ObjectMonitorType* monitorData,
+		const size_t nSamples) {
+
+	for (size_t i = 0; i < nSamples; ++i) {
+		const MonitorSampleType* in = &samples[i];
+		ObjectMonitorType* out = &monitorData[i];
+
+		memset(out, 0, sizeof (*out));
+
+		out->isTimestampValid = getMonitorSampleTimestamp(in, &out->timestamp) >= 0;
+
+		out->position.isXcoordValid = in->isXcoordValid;
+		out->position.isYcoordValid = in->isYcoordValid;
+		out->position.isZcoordValid = in->isZcoordValid;
+		out->position.isPositionValid = in->isPositionValid;
+		out->position.isHeadingValid = in->isHeadingValid;
+		out->position.xCoord_m = getMonitorSampleXCoord_m(in);
+		out->position.yCoord_m = getMonitorSampleYCoord_m(in);
+		out->position.zCoord_m = getMonitorSampleZCoord_m(in);
+		if (in->isHeadingValid) {
+			out->position.heading_rad = getMonitorSampleHeading_rad(in);
+		}
+
+		out->speed.isLongitudinalValid = in->isLongitudinalSpeedValid;
+		out->speed.isLateralValid = in->isLateralSpeedValid;
+		out->speed.longitudinal_m_s = in->isLongitudinalSpeedValid ? getMonitorSampleLongitudinalSpeed_m_s(in) : 0;
+		out->speed.lateral_m_s = in->isLateralSpeedValid ? getMonitorSampleLateralSpeed_m_s(in) : 0;
+
+		out->acceleration.isLongitudinalValid = in->isLongitudinalAccValid;
+		out->acceleration.isLateralValid = in->isLateralAccValid;
+		out->acceleration.longitudinal_m_s2 = in->isLongitudinalAccValid ?
+					getMonitorSampleLongitudinalAcc_m_s2(in) : 0;
+		out->acceleration.lateral_m_s2 = in->isLateralAccValid ? getMonitorSampleLateralAcc_m_s2(in) : 0;
+
+		out->drivingDirection = (DriveDirectionType) in->drivingDirection;
+		out->state = (ObjectStateType) in->state;
+		out->armReadiness = (ObjectArmReadinessType) in->armReadiness;
+
+		out->error.abortRequest = in->errorStatus & BITMASK_ERROR_ABORT_REQUEST;
+		out->error.outsideGeofence = in->errorStatus & BITMASK_ERROR_OUTSIDE_GEOFENCE;
+		out->error.badPositioningAccuracy = in->errorStatus & BITMASK_ERROR_BAD_POSITIONING_ACCURACY;
+		out->error.engineFault = in->errorStatus & BITMASK_ERROR_ENGINE_FAULT;
+		out->error.batteryFault = in->errorStatus & BITMASK_ERROR_BATTERY_FAULT;
+		out->error.syncPointEnded = in->errorStatus & BITMASK_ERROR_SYNC_POINT_ENDED;
+		out->error.unknownError = in->errorStatus & BITMASK_ERROR_OTHER
+				|| in->errorStatus & BITMASK_ERROR_VENDOR_SPECIFIC;
+	}
+}
+
+
+static int32_t toFixedPoint32(const double value, const double oneUnitValue) {
+	return (int32_t) lround(value * oneUnitValue);
+}
+
+static int16_t toFixedPoint16(const double value, const double oneUnitValue) {
+	return (int16_t) lround(value * oneUnitValue);
+}
+
+static uint16_t headingToISOYaw(const double heading_rad) {
+	const double fullTurn = 360.0 * YAW_ONE_DEGREE_VALUE;
+	double yaw = fmod(heading_rad * 180.0 / M_PI * YAW_ONE_DEGREE_VALUE, fullTurn);
+
+	if (yaw < 0.0) {
+		yaw += fullTurn;
+	}
+	yaw = round(yaw);
+	return (uint16_t) (yaw >= fullTurn ? 0.0 : yaw);
+}
@@ -4,6 +4,25 @@
 
 #include "timeconversions.h"
 #include "defines.h"
+#include "isoerror.h"
+
+static ssize_t encodeMONRWireData(MONRType * MONRData, char *monrDataBuffer, const char debug);
+static ssize_t decodeMONRWireData(const char *monrDataBuffer, const size_t bufferLength,
+								  MONRType * MONRData, const char debug);
+static DriveDirectionType mapISODriveDirection(const uint8_t driveDirection);
+static ObjectStateType mapISOObjectState(const uint8_t state);
+static ObjectArmReadinessType mapISOArmReadiness(const uint8_t readyToArm);
+static uint8_t mapHostDriveDirection(const DriveDirectionType driveDirection);
+static uint8_t mapHostObjectState(const ObjectStateType state);
+static uint8_t mapHostArmReadiness(const ObjectArmReadinessType readyToArm);
+
+/*!
+ * \brief getEncodedSizeMONRMessage Get the size of an encoded MONR message
+ * \return Number of bytes written by ::encodeMONRMessage
+ */
+size_t getEncodedSizeMONRMessage(void) {
+	return sizeof (MONRType);
+}
 
 /*!
  * \brief encodeMONRMessage Constructs an ISO MONR message based on object dynamics data from trajectory file or data generated in a simulator
@@ -30,8 +49,6 @@ ssize_t encodeMONRMessage(const MessageHeaderType *inputHeader,
 						  char *monrDataBuffer, const size_t bufferLength, const char debug) {
 	MONRType MONRData;
 
-	memset(monrDataBuffer, 0, bufferLength);
-
 	const uint16_t MONRStructSize = (uint16_t) (sizeof (MONRData) - sizeof (MONRData.header)
 												- sizeof (MONRData.footer.Crc) -
 												sizeof (MONRData.monrStructValueID)
@@ -39,7 +56,8 @@ ssize_t encodeMONRMessage(const MessageHeaderType *inputHeader,
 
 	// If buffer too small to hold MONR data, generate an error
 	if (bufferLength < sizeof (MONRType)) {
-		fprintf(stderr, "Buffer too small to hold necessary MONR data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_MONR, 0,
+						 "Buffer too small to hold necessary MONR data");
 		return -1;
 	}
 
@@ -61,7 +79,8 @@ ssize_t encodeMONRMessage(const MessageHeaderType *inputHeader,
 	}
 	else {
 		errno = EINVAL;
-		fprintf(stderr, "Position is a required field in MONR messages\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_MONR, 0,
+						 "Position is a required field in MONR messages");
 		return -1;
 	}
 
@@ -80,7 +99,8 @@ ssize_t encodeMONRMessage(const MessageHeaderType *inputHeader,
 	}
 	else {
 		errno = EINVAL;
-		fprintf(stderr, "Longitudinal speed is a required field in MONR messages\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_MONR, 0,
+						 "Longitudinal speed is a required field in MONR messages");
 		return -1;
 	}
 	MONRData.lateralSpeed =
@@ -130,35 +150,110 @@ ssize_t encodeMONRMessage(const MessageHeaderType *inputHeader,
 			   MONRData.driveDirection, MONRData.state, MONRData.readyToArm, MONRData.errorStatus);
 	}
 
+	return encodeMONRWireData(&MONRData, monrDataBuffer, debug);
+}
+
+/*!
+ * \brief encodeMONRMessageFromSample Constructs an ISO MONR message from a compact monitor sample,
+ *			copying the fixed point values without conversion
+ * \param inputHeader data to create header with
+ * \param sample Monitor sample to be encoded
+ * \param monrDataBuffer Buffer to hold the message
+ * \param bufferLength Length of the buffer
+ * \param debug Flag for enabling of debugging
+ * \return Number of bytes written to the buffer, or -1 in case of an error
+ */
+ssize_t encodeMONRMessageFromSample(
+		const MessageHeaderType *inputHeader,
+		const MonitorSampleType *sample,
+		char *monrDataBuffer,
+		const size_t bufferLength,
+		const char debug) {
+
+	MONRType MONRData;
+
+	if (inputHeader == NULL || sample == NULL || monrDataBuffer == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_MONR, 0,
+						 "Input pointers to MONR encoding function cannot be null");
+		return -1;
+	}
+
+	// If buffer too small to hold MONR data, generate an error
+	if (bufferLength < sizeof (MONRType)) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_MONR, 0,
+						 "Buffer too small to hold necessary MONR data");
+		return -1;
+	}
+
+	MONRData.header = buildISOHeader(MESSAGE_ID_MONR, inputHeader, sizeof (MONRData), debug);
+	MONRData.monrStructValueID = VALUE_ID_MONR_STRUCT;
+	MONRData.monrStructContentLength = (uint16_t) (sizeof (MONRData) - sizeof (MONRData.header)
+												   - sizeof (MONRData.footer.Crc)
+												   - sizeof (MONRData.monrStructValueID)
+												   - sizeof (MONRData.monrStructContentLength));
+	MONRData.gpsQmsOfWeek = sample->isTimestampValid ? sample->gpsQmsOfWeek : GPS_SECOND_OF_WEEK_UNAVAILABLE_VALUE;
+	MONRData.xPosition = sample->xPosition;
+	MONRData.yPosition = sample->yPosition;
+	MONRData.zPosition = sample->zPosition;
+	MONRData.yaw = sample->yaw;
+	MONRData.pitch = 0;
+	MONRData.roll = 0;
+	MONRData.longitudinalSpeed = sample->longitudinalSpeed;
+	MONRData.lateralSpeed = sample->lateralSpeed;
+	MONRData.longitudinalAcc = sample->longitudinalAcc;
+	MONRData.lateralAcc = sample->lateralAcc;
+	MONRData.driveDirection = mapHostDriveDirection((DriveDirectionType) sample->drivingDirection);
+	MONRData.state = mapHostObjectState((ObjectStateType) sample->state);
+	MONRData.readyToArm = mapHostArmReadiness((ObjectArmReadinessType) sample->armReadiness);
+	MONRData.errorStatus = sample->errorStatus;
+	MONRData.errorCode = 0;
+
+	return encodeMONRWireData(&MONRData, monrDataBuffer, debug);
+}
+
+/*!
+ * \brief encodeMONRWireData Converts a MONR message to little endian, adds the footer and copies it
+ *			to a buffer
+ * \param MONRData MONR message in host endianness, modified by the call
+ * \param monrDataBuffer Buffer to hold the message, at least the size of ::MONRType
+ * \param debug Flag for enabling of debugging
+ * \return Number of bytes written to the buffer
+ */
+static ssize_t encodeMONRWireData(
+		MONRType * MONRData,
+		char *monrDataBuffer,
+		const char debug) {
+
 	// Convert from host endianness to little endian
-	MONRData.monrStructValueID = htole16(MONRData.monrStructValueID);
-	MONRData.monrStructContentLength = htole16(MONRData.monrStructContentLength);
-	MONRData.gpsQmsOfWeek = htole32(MONRData.gpsQmsOfWeek);
-	MONRData.xPosition = (int32_t) htole32(MONRData.xPosition);
-	MONRData.yPosition = (int32_t) htole32(MONRData.yPosition);
-	MONRData.zPosition = (int32_t) htole32(MONRData.zPosition);
-	MONRData.yaw = htole16(MONRData.yaw);
-	MONRData.pitch = (int16_t) htole16(MONRData.pitch);
-	MONRData.roll = (int16_t) htole16(MONRData.roll);
-	MONRData.longitudinalSpeed = (int16_t) htole16(MONRData.longitudinalSpeed);
-	MONRData.lateralSpeed = (int16_t) htole16(MONRData.lateralSpeed);
-	MONRData.longitudinalAcc = (int16_t) htole16(MONRData.longitudinalAcc);
-	MONRData.lateralAcc = (int16_t) htole16(MONRData.lateralAcc);
-	MONRData.errorCode = htole16(MONRData.errorCode);
+	MONRData->monrStructValueID = htole16(MONRData->monrStructValueID);
+	MONRData->monrStructContentLength = htole16(MONRData->monrStructContentLength);
+	MONRData->gpsQmsOfWeek = htole32(MONRData->gpsQmsOfWeek);
+	MONRData->xPosition = (int32_t) htole32(MONRData->xPosition);
+	MONRData->yPosition = (int32_t) htole32(MONRData->yPosition);
+	MONRData->zPosition = (int32_t) htole32(MONRData->zPosition);
+	MONRData->yaw = htole16(MONRData->yaw);
+	MONRData->pitch = (int16_t) htole16(MONRData->pitch);
+	MONRData->roll = (int16_t) htole16(MONRData->roll);
+	MONRData->longitudinalSpeed = (int16_t) htole16(MONRData->longitudinalSpeed);
+	MONRData->lateralSpeed = (int16_t) htole16(MONRData->lateralSpeed);
+	MONRData->longitudinalAcc = (int16_t) htole16(MONRData->longitudinalAcc);
+	MONRData->lateralAcc = (int16_t) htole16(MONRData->lateralAcc);
+	MONRData->errorCode = htole16(MONRData->errorCode);
 
 
 
 	// Construct footer
-	MONRData.footer = buildISOFooter(&MONRData, sizeof (MONRData), debug);
+	MONRData->footer = buildISOFooter(MONRData, sizeof (*MONRData), debug);
 
 	// Copy struct onto the databuffer
-	memcpy(monrDataBuffer, &MONRData, sizeof (MONRData));
+	memcpy(monrDataBuffer, MONRData, sizeof (*MONRData));
 
 	if (debug) {
-		printf("Byte data[%lu]: ", sizeof (MONRData));
+		printf("Byte data[%lu]: ", sizeof (*MONRData));
 		unsigned int i;
 
-		for (i = 0; i < sizeof (MONRData); i++) {
+		for (i = 0; i < sizeof (*MONRData); i++) {
 			if (i > 0)
 				printf(":");
 			printf("%02X", (unsigned char)monrDataBuffer[i]);
@@ -188,24 +283,90 @@ ssize_t decodeMONRMessage(
 	const char debug) {
 
 	MONRType MONRData;
-	const char *p = monrDataBuffer;
-	const uint16_t ExpectedMONRStructSize = (uint16_t) (sizeof (MONRData) - sizeof (MONRData.header)
-														- sizeof (MONRData.footer.Crc) -
-														sizeof (MONRData.monrStructValueID)
-														- sizeof (MONRData.monrStructContentLength));
 	ssize_t retval = MESSAGE_OK;
 
 	if (monitorData == NULL || monrDataBuffer == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointers to MONR parsing function cannot be null\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_MONR, 0,
+						 "Input pointers to MONR parsing function cannot be null");
 		return ISO_FUNCTION_ERROR;
 	}
 
 	memset(monitorData, 0, sizeof (*monitorData));
 
+	if ((retval = decodeMONRWireData(monrDataBuffer, bufferLength, &MONRData, debug)) < 0) {
+		return retval;
+	}
+
+	// Fill output struct with parsed data
+	convertMONRToHostRepresentation(&MONRData, &currentTime, monitorData);
+
+	return retval;
+}
+
+/*!
+ * \brief decodeMONRMessageToSample Fills a compact monitor sample from a buffer of raw data, without
+ *			converting to SI units
+ * \param monrDataBuffer Raw data to be decoded
+ * \param bufferLength Number of bytes in buffer of raw data to be decoded
+ * \param currentTime Current system time, used to guess GPS week of MONR message
+ * \param sample Struct to be filled
+ * \param debug Flag for enabling of debugging
+ * \return Number of bytes decoded, or negative value according to ::ISOMessageReturnValue
+ */
+ssize_t decodeMONRMessageToSample(
+	const char *monrDataBuffer,
+	const size_t bufferLength,
+	const struct timeval currentTime,
+	MonitorSampleType * sample,
+	const char debug) {
+
+	MONRType MONRData;
+	ssize_t retval = MESSAGE_OK;
+
+	if (sample == NULL || monrDataBuffer == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_MONR, 0,
+						 "Input pointers to MONR parsing function cannot be null");
+		return ISO_FUNCTION_ERROR;
+	}
+
+	memset(sample, 0, sizeof (*sample));
+
+	if ((retval = decodeMONRWireData(monrDataBuffer, bufferLength, &MONRData, debug)) < 0) {
+		return retval;
+	}
+
+	convertMONRToMonitorSample(&MONRData, &currentTime, sample);
+
+	return retval;
+}
+
+/*!
+ * \brief decodeMONRWireData Verifies and copies a MONR message from a buffer of raw data, converting
+ *			from little endian to host endianness
+ * \param monrDataBuffer Raw data to be decoded
+ * \param bufferLength Number of bytes in buffer of raw data to be decoded
+ * \param MONRData Struct to be filled
+ * \param debug Flag for enabling of debugging
+ * \return Number of bytes decoded, or negative value according to ::ISOMessageReturnValue
+ */
+static ssize_t decodeMONRWireData(
+	const char *monrDataBuffer,
+	const size_t bufferLength,
+	MONRType * MONRDataPtr,
+	const char debug) {
+
+	MONRType MONRData;
+	const char *p = monrDataBuffer;
+	const uint16_t ExpectedMONRStructSize = (uint16_t) (sizeof (MONRData) - sizeof (MONRData.header)
+														- sizeof (MONRData.footer.Crc) -
+														sizeof (MONRData.monrStructValueID)
+														- sizeof (MONRData.monrStructContentLength));
+	ssize_t retval = MESSAGE_OK;
+
 	// Decode ISO header
 	if ((retval = decodeISOHeader(p, bufferLength, &MONRData.header, debug)) != MESSAGE_OK) {
-		memset(monitorData, 0, sizeof (*monitorData));
 		return retval;
 	}
 	p += sizeof (MONRData.header);
@@ -213,7 +374,8 @@ ssize_t decodeMONRMessage(
 
 	// If message is not a MONR message, generate an error
 	if (MONRData.header.messageID != MESSAGE_ID_MONR) {
-		fprintf(stderr, "Attempted to pass non-MONR message into MONR parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_MONR, (size_t) (p - monrDataBuffer),
+						 "Attempted to pass non-MONR message into MONR parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
@@ -224,7 +386,8 @@ ssize_t decodeMONRMessage(
 
 	// If content is not a MONR struct or an unexpected size, generate an error
 	if (MONRData.monrStructValueID != VALUE_ID_MONR_STRUCT) {
-		fprintf(stderr, "Attempted to pass non-MONR struct into MONR parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_MONR, (size_t) (p - monrDataBuffer),
+						 "Attempted to pass non-MONR struct into MONR parsing function");
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 
@@ -233,8 +396,9 @@ ssize_t decodeMONRMessage(
 	MONRData.monrStructContentLength = le16toh(MONRData.monrStructContentLength);
 
 	if (MONRData.monrStructContentLength != ExpectedMONRStructSize) {
-		fprintf(stderr, "MONR content length %u differs from the expected length %u\n",
-				MONRData.monrStructContentLength, ExpectedMONRStructSize);
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_MONR, (size_t) (p - monrDataBuffer),
+						 "MONR content length %u differs from the expected length %u",
+						 MONRData.monrStructContentLength, ExpectedMONRStructSize);
 		return MESSAGE_LENGTH_ERROR;
 	}
 
@@ -302,14 +466,15 @@ ssize_t decodeMONRMessage(
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - monrDataBuffer), &MONRData.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding MONR footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_MONR, (size_t) (p - monrDataBuffer),
+						 "Error decoding MONR footer");
 		return retval;
 	}
 	p += sizeof (MONRData.footer);
 
 	if ((retval = verifyChecksum(monrDataBuffer, p - monrDataBuffer - sizeof (MONRData.footer),
 								 MONRData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-		fprintf(stderr, "MONR checksum error\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_MONR, (size_t) (p - monrDataBuffer), "MONR checksum error");
 		return retval;
 	}
 
@@ -339,8 +504,7 @@ ssize_t decodeMONRMessage(
 		printf("ErrorCode = %d\n", MONRData.errorCode);
 	}
 
-	// Fill output struct with parsed data
-	convertMONRToHostRepresentation(&MONRData, &currentTime, monitorData);
+	*MONRDataPtr = MONRData;
 
 	return retval < 0 ? retval : p - monrDataBuffer;
 }
@@ -401,77 +565,164 @@ void convertMONRToHostRepresentation(const MONRType * MONRData,
 	monitorData->acceleration.lateral_m_s2 = monitorData->acceleration.isLateralValid ?
 		(double)(MONRData->lateralAcc) / ACCELERATION_ONE_METER_PER_SECOND_SQUARED_VALUE : 0;
 
-	// Drive direction
-	switch (MONRData->driveDirection) {
+	monitorData->drivingDirection = mapISODriveDirection(MONRData->driveDirection);
+	monitorData->state = mapISOObjectState(MONRData->state);
+	monitorData->armReadiness = mapISOArmReadiness(MONRData->readyToArm);
+
+	// Error status
+	monitorData->error.engineFault = MONRData->errorStatus & BITMASK_ERROR_ENGINE_FAULT;
+	monitorData->error.abortRequest = MONRData->errorStatus & BITMASK_ERROR_ABORT_REQUEST;
+	monitorData->error.batteryFault = MONRData->errorStatus & BITMASK_ERROR_BATTERY_FAULT;
+	monitorData->error.unknownError = MONRData->errorStatus & BITMASK_ERROR_OTHER
+		|| MONRData->errorStatus & BITMASK_ERROR_VENDOR_SPECIFIC;
+	monitorData->error.syncPointEnded = MONRData->errorStatus & BITMASK_ERROR_SYNC_POINT_ENDED;
+	monitorData->error.outsideGeofence = MONRData->errorStatus & BITMASK_ERROR_OUTSIDE_GEOFENCE;
+	monitorData->error.badPositioningAccuracy =
+		MONRData->errorStatus & BITMASK_ERROR_BAD_POSITIONING_ACCURACY;
+
+	return;
+}
+
+/*!
+ * \brief convertMONRToMonitorSample Converts a MONR message to a compact monitor sample, keeping
+ * ISO fixed point units
+ * \param MONRData MONR message to be converted
+ * \param currentTime Current system time, used to guess GPS week of MONR message
+ * \param sample Sample in which result is to be placed
+ */
+void convertMONRToMonitorSample(const MONRType * MONRData,
+								const struct timeval *currentTime, MonitorSampleType * sample) {
+
+	const int32_t GPSWeek = getAsGPSWeek(currentTime);
+
+	sample->isTimestampValid = MONRData->gpsQmsOfWeek != GPS_SECOND_OF_WEEK_UNAVAILABLE_VALUE
+			&& GPSWeek >= 0;
+	sample->gpsQmsOfWeek = MONRData->gpsQmsOfWeek;
+	sample->gpsWeek = GPSWeek >= 0 ? (uint16_t) GPSWeek : GPS_WEEK_UNAVAILABLE_VALUE;
+
+	sample->xPosition = MONRData->xPosition;
+	sample->yPosition = MONRData->yPosition;
+	sample->zPosition = MONRData->zPosition;
+	sample->yaw = MONRData->yaw;
+	sample->isXcoordValid = MONRData->xPosition != POSITION_UNAVAILABLE_VALUE;
+	sample->isYcoordValid = MONRData->yPosition != POSITION_UNAVAILABLE_VALUE;
+	sample->isZcoordValid = MONRData->zPosition != POSITION_UNAVAILABLE_VALUE;
+	sample->isPositionValid = sample->isXcoordValid && sample->isYcoordValid;
+	sample->isHeadingValid = MONRData->yaw != YAW_UNAVAILABLE_VALUE;
+
+	sample->longitudinalSpeed = MONRData->longitudinalSpeed;
+	sample->lateralSpeed = MONRData->lateralSpeed;
+	sample->isLongitudinalSpeedValid = MONRData->longitudinalSpeed != SPEED_UNAVAILABLE_VALUE;
+	sample->isLateralSpeedValid = MONRData->lateralSpeed != SPEED_UNAVAILABLE_VALUE;
+
+	sample->longitudinalAcc = MONRData->longitudinalAcc;
+	sample->lateralAcc = MONRData->lateralAcc;
+	sample->isLongitudinalAccValid = MONRData->longitudinalAcc != ACCELERATION_UNAVAILABLE_VALUE;
+	sample->isLateralAccValid = MONRData->lateralAcc != ACCELERATION_UNAVAILABLE_VALUE;
+
+	sample->drivingDirection = mapISODriveDirection(MONRData->driveDirection);
+	sample->state = mapISOObjectState(MONRData->state);
+	sample->armReadiness = mapISOArmReadiness(MONRData->readyToArm);
+	sample->errorStatus = MONRData->errorStatus;
+}
+
+
+static DriveDirectionType mapISODriveDirection(const uint8_t driveDirection) {
+	switch (driveDirection) {
 	case ISO_DRIVE_DIRECTION_FORWARD:
-		monitorData->drivingDirection = OBJECT_DRIVE_DIRECTION_FORWARD;
-		break;
+		return OBJECT_DRIVE_DIRECTION_FORWARD;
 	case ISO_DRIVE_DIRECTION_BACKWARD:
-		monitorData->drivingDirection = OBJECT_DRIVE_DIRECTION_BACKWARD;
-		break;
+		return OBJECT_DRIVE_DIRECTION_BACKWARD;
 	case ISO_DRIVE_DIRECTION_UNAVAILABLE:
 	default:
-		monitorData->drivingDirection = OBJECT_DRIVE_DIRECTION_UNAVAILABLE;
+		return OBJECT_DRIVE_DIRECTION_UNAVAILABLE;
 	}
+}
 
-	// State
-	switch (MONRData->state) {
+static ObjectStateType mapISOObjectState(const uint8_t state) {
+	switch (state) {
 	case ISO_OBJECT_STATE_INIT:
-		monitorData->state = OBJECT_STATE_INIT;
-		break;
+		return OBJECT_STATE_INIT;
 	case ISO_OBJECT_STATE_DISARMED:
-		monitorData->state = OBJECT_STATE_DISARMED;
-		break;
+		return OBJECT_STATE_DISARMED;
 	case ISO_OBJECT_STATE_ARMED:
-		monitorData->state = OBJECT_STATE_ARMED;
-		break;
+		return OBJECT_STATE_ARMED;
 	case ISO_OBJECT_STATE_RUNNING:
-		monitorData->state = OBJECT_STATE_RUNNING;
-		break;
+		return OBJECT_STATE_RUNNING;
 	case ISO_OBJECT_STATE_POSTRUN:
-		monitorData->state = OBJECT_STATE_POSTRUN;
-		break;
+		return OBJECT_STATE_POSTRUN;
 	case ISO_OBJECT_STATE_ABORTING:
-		monitorData->state = OBJECT_STATE_ABORTING;
-		break;
+		return OBJECT_STATE_ABORTING;
 	case ISO_OBJECT_STATE_REMOTE_CONTROLLED:
-		monitorData->state = OBJECT_STATE_REMOTE_CONTROL;
-		break;
+		return OBJECT_STATE_REMOTE_CONTROL;
 	case ISO_OBJECT_STATE_PRE_ARMING:
-		monitorData->state = OBJECT_STATE_PRE_ARMING;
-		break;
+		return OBJECT_STATE_PRE_ARMING;
 	case ISO_OBJECT_STATE_PRE_RUNNING:
-		monitorData->state = OBJECT_STATE_PRE_RUNNING;
-		break;
+		return OBJECT_STATE_PRE_RUNNING;
 	case ISO_OBJECT_STATE_OFF:
 	default:
-		monitorData->state = OBJECT_STATE_UNKNOWN;
-		break;
+		return OBJECT_STATE_UNKNOWN;
 	}
+}
 
-	// Ready to arm
-	switch (MONRData->readyToArm) {
+static ObjectArmReadinessType mapISOArmReadiness(const uint8_t readyToArm) {
+	switch (readyToArm) {
 	case ISO_READY_TO_ARM:
-		monitorData->armReadiness = OBJECT_READY_TO_ARM;
-		break;
+		return OBJECT_READY_TO_ARM;
 	case ISO_NOT_READY_TO_ARM:
-		monitorData->armReadiness = OBJECT_NOT_READY_TO_ARM;
-		break;
+		return OBJECT_NOT_READY_TO_ARM;
 	case ISO_READY_TO_ARM_UNAVAILABLE:
 	default:
-		monitorData->armReadiness = OBJECT_READY_TO_ARM_UNAVAILABLE;
+		return OBJECT_READY_TO_ARM_UNAVAILABLE;
 	}
+}
 
-	// Error status
-	monitorData->error.engineFault = MONRData->errorStatus & BITMASK_ERROR_ENGINE_FAULT;
-	monitorData->error.abortRequest = MONRData->errorStatus & BITMASK_ERROR_ABORT_REQUEST;
-	monitorData->error.batteryFault = MONRData->errorStatus & BITMASK_ERROR_BATTERY_FAULT;
-	monitorData->error.unknownError = MONRData->errorStatus & BITMASK_ERROR_OTHER
-		|| MONRData->errorStatus & BITMASK_ERROR_VENDOR_SPECIFIC;
-	monitorData->error.syncPointEnded = MONRData->errorStatus & BITMASK_ERROR_SYNC_POINT_ENDED;
-	monitorData->error.outsideGeofence = MONRData->errorStatus & BITMASK_ERROR_OUTSIDE_GEOFENCE;
-	monitorData->error.badPositioningAccuracy =
-		MONRData->errorStatus & BITMASK_ERROR_BAD_POSITIONING_ACCURACY;
+static uint8_t mapHostDriveDirection(const DriveDirectionType driveDirection) {
+	switch (driveDirection) {
+	case OBJECT_DRIVE_DIRECTION_FORWARD:
+		return ISO_DRIVE_DIRECTION_FORWARD;
+	case OBJECT_DRIVE_DIRECTION_BACKWARD:
+		return ISO_DRIVE_DIRECTION_BACKWARD;
+	case OBJECT_DRIVE_DIRECTION_UNAVAILABLE:
+	default:
+		return ISO_DRIVE_DIRECTION_UNAVAILABLE;
+	}
+}
 
-	return;
+static uint8_t mapHostObjectState(const ObjectStateType state) {
+	switch (state) {
+	case OBJECT_STATE_INIT:
+		return ISO_OBJECT_STATE_INIT;
+	case OBJECT_STATE_DISARMED:
+		return ISO_OBJECT_STATE_DISARMED;
+	case OBJECT_STATE_ARMED:
+		return ISO_OBJECT_STATE_ARMED;
+	case OBJECT_STATE_RUNNING:
+		return ISO_OBJECT_STATE_RUNNING;
+	case OBJECT_STATE_POSTRUN:
+		return ISO_OBJECT_STATE_POSTRUN;
+	case OBJECT_STATE_ABORTING:
+		return ISO_OBJECT_STATE_ABORTING;
+	case OBJECT_STATE_REMOTE_CONTROL:
+		return ISO_OBJECT_STATE_REMOTE_CONTROLLED;
+	case OBJECT_STATE_PRE_ARMING:
+		return ISO_OBJECT_STATE_PRE_ARMING;
+	case OBJECT_STATE_PRE_RUNNING:
+		return ISO_OBJECT_STATE_PRE_RUNNING;
+	case OBJECT_STATE_UNKNOWN:
+	default:
+		return ISO_OBJECT_STATE_OFF;
+	}
+}
+
+static uint8_t mapHostArmReadiness(const ObjectArmReadinessType readyToArm) {
+	switch (readyToArm) {
+	case OBJECT_READY_TO_ARM:
+		return ISO_READY_TO_ARM;
+	case OBJECT_NOT_READY_TO_ARM:
+		return ISO_NOT_READY_TO_ARM;
+	case OBJECT_READY_TO_ARM_UNAVAILABLE:
+	default:
+		return ISO_READY_TO_ARM_UNAVAILABLE;
+	}
 }
@@ -0,0 +1,343 @@
+#include "monr2.h"
+#include "frame.h"
+#include "timeconversions.h"
+#include "isoerror.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MONR2_STRUCT_CONTENT_LENGTH (sizeof (MONR2Type) - offsetof(MONR2Type, gpsQmsOfWeek) - sizeof (FooterType))
+//! Number of frames whose headers are held at a time by ::decodeMONR2Messages
+#define MONR2_DECODE_BATCH_SIZE 32
+
+static ssize_t checkMONR2Content(const uint8_t* message, const HeaderType* header);
+static void convertMONR2ToHostRepresentation(const uint8_t* message, const int32_t gpsWeek,
+											 ObjectMonitor2Type* monitorData);
+
+
+/*!
+ * \brief getEncodedSizeMONR2Message Get the size of an encoded MONR2 message
+ * \return Number of bytes written by ::encodeMONR2Message
+ */
+size_t getEncodedSizeMONR2Message(void) {
+	return sizeof (MONR2Type);
+}
+
+/*!
+ * \brief encodeMONR2Message Constructs an ISO MONR2 message from secondary monitoring data
+ * \param inputHeader data to create header with
+ * \param monitorData Monitoring data to be encoded, fields marked invalid are sent as unavailable
+ * \param monr2DataBuffer Buffer to hold the message
+ * \param bufferLength Length of the buffer
+ * \param debug Flag for enabling of debugging
+ * \return Number of bytes written to the buffer, or -1 in case of an error
+ */
+ssize_t encodeMONR2Message(
+		const MessageHeaderType* inputHeader,
+		const ObjectMonitor2Type* monitorData,
+		char* monr2DataBuffer,
+		const size_t bufferLength,
+		const char debug) {
+
+	MONR2Type MONR2Data;
+
+	if (inputHeader == NULL || monitorData == NULL || monr2DataBuffer == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_MONR2, 0,
+						 "Input pointers to MONR2 encoding function cannot be null");
+		return -1;
+	}
+
+	// If buffer too small to hold MONR2 data, generate an error
+	if (bufferLength < sizeof (MONR2Type)) {
+		errno = ENOBUFS;
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_MONR2, 0,
+						 "Buffer too small to hold necessary MONR2 data");
+		return -1;
+	}
+
+	MONR2Data.header = buildISOHeader(MESSAGE_ID_MONR2, inputHeader, sizeof (MONR2Data), debug);
+	MONR2Data.monr2StructValueID = VALUE_ID_MONR2_STRUCT;
+	MONR2Data.monr2StructContentLength = MONR2_STRUCT_CONTENT_LENGTH;
+
+	const int64_t GPSQmsOfWeek = monitorData->isTimestampValid ?
+				getAsGPSQuarterMillisecondOfWeek(&monitorData->timestamp) : -1;
+	MONR2Data.gpsQmsOfWeek = GPSQmsOfWeek >= 0 ? (uint32_t) GPSQmsOfWeek : GPS_SECOND_OF_WEEK_UNAVAILABLE_VALUE;
+
+	MONR2Data.pitch = monitorData->isPitchValid ?
+				(int16_t) (monitorData->pitch_rad * 180.0 / M_PI * PITCH_ONE_DEGREE_VALUE) : PITCH_UNAVAILABLE_VALUE;
+	MONR2Data.roll = monitorData->isRollValid ?
+				(int16_t) (monitorData->roll_rad * 180.0 / M_PI * ROLL_ONE_DEGREE_VALUE) : ROLL_UNAVAILABLE_VALUE;
+	MONR2Data.verticalSpeed = monitorData->isVerticalSpeedValid ?
+				(int16_t) (monitorData->verticalSpeed_m_s * SPEED_ONE_METER_PER_SECOND_VALUE)
+			  : SPEED_UNAVAILABLE_VALUE;
+	MONR2Data.verticalAcc = monitorData->isVerticalAccValid ?
+				(int16_t) (monitorData->verticalAcc_m_s2 * ACCELERATION_ONE_METER_PER_SECOND_SQUARED_VALUE)
+			  : ACCELERATION_UNAVAILABLE_VALUE;
+	MONR2Data.yawRate = monitorData->isYawRateValid ?
+				(int16_t) (monitorData->yawRate_rad_s * 180.0 / M_PI * ANGULAR_RATE_ONE_DEGREE_PER_SECOND_VALUE)
+			  : ANGULAR_RATE_UNAVAILABLE_VALUE;
+	MONR2Data.pitchRate = monitorData->isPitchRateValid ?
+				(int16_t) (monitorData->pitchRate_rad_s * 180.0 / M_PI * ANGULAR_RATE_ONE_DEGREE_PER_SECOND_VALUE)
+			  : ANGULAR_RATE_UNAVAILABLE_VALUE;
+	MONR2Data.rollRate = monitorData->isRollRateValid ?
+				(int16_t) (monitorData->rollRate_rad_s * 180.0 / M_PI * ANGULAR_RATE_ONE_DEGREE_PER_SECOND_VALUE)
+			  : ANGULAR_RATE_UNAVAILABLE_VALUE;
+	MONR2Data.positionAccuracy = monitorData->isPositionAccuracyValid ?
+				(uint16_t) (monitorData->positionAccuracy_m * POSITION_ACCURACY_ONE_METER_VALUE)
+			  : POSITION_ACCURACY_UNAVAILABLE_VALUE;
+
+	if (debug) {
+		printf("MONR2 message:\n\tMONR2 struct value ID: 0x%x\n\t"
+			   "MONR2 struct content length: %u\n\t"
+			   "GPS second of week: %u [¼ ms]\n\t"
+			   "Pitch: %d [0,01 deg]\n\t"
+			   "Roll: %d [0,01 deg]\n\t"
+			   "Vertical speed: %d [0,01 m/s]\n\t"
+			   "Vertical acceleration: %d [0,001 m/s²]\n\t"
+			   "Yaw rate: %d [0,01 deg/s]\n\t"
+			   "Pitch rate: %d [0,01 deg/s]\n\t"
+			   "Roll rate: %d [0,01 deg/s]\n\t"
+			   "Position accuracy: %u [0,01 m]\n",
+			   MONR2Data.monr2StructValueID, MONR2Data.monr2StructContentLength, MONR2Data.gpsQmsOfWeek,
+			   MONR2Data.pitch, MONR2Data.roll, MONR2Data.verticalSpeed, MONR2Data.verticalAcc,
+			   MONR2Data.yawRate, MONR2Data.pitchRate, MONR2Data.rollRate, MONR2Data.positionAccuracy);
+	}
+
+	// Convert from host endianness to little endian
+	MONR2Data.monr2StructValueID = htole16(MONR2Data.monr2StructValueID);
+	MONR2Data.monr2StructContentLength = htole16(MONR2Data.monr2StructContentLength);
+	MONR2Data.gpsQmsOfWeek = htole32(MONR2Data.gpsQmsOfWeek);
+	MONR2Data.pitch = (int16_t) htole16(MONR2Data.pitch);
+	MONR2Data.roll = (int16_t) htole16(MONR2Data.roll);
+	MONR2Data.verticalSpeed = (int16_t) htole16(MONR2Data.verticalSpeed);
+	MONR2Data.verticalAcc = (int16_t) htole16(MONR2Data.verticalAcc);
+	MONR2Data.yawRate = (int16_t) htole16(MONR2Data.yawRate);
+	MONR2Data.pitchRate = (int16_t) htole16(MONR2Data.pitchRate);
+	MONR2Data.rollRate = (int16_t) htole16(MONR2Data.rollRate);
+	MONR2Data.positionAccuracy = htole16(MONR2Data.positionAccuracy);
+
+	MONR2Data.footer = buildISOFooter(&MONR2Data, sizeof (MONR2Data), debug);
+	memcpy(monr2DataBuffer, &MONR2Data, sizeof (MONR2Data));
+
+	return sizeof (MONR2Type);
+}
+
+/*!
+ * \brief decodeMONR2Message Fills a secondary monitoring data struct from a buffer of raw data
+ * \param monr2DataBuffer Raw data to be decoded
+ * \param bufferLength Number of bytes in buffer of raw data to be decoded
+ * \param currentTime Current system time, used to guess GPS week of MONR2 message
+ * \param monitorData Struct to be filled
+ * \param debug Flag for enabling of debugging
+ * \return Number of bytes decoded, or negative value according to ::ISOMessageReturnValue
+ */
+ssize_t decodeMONR2Message(
+		const char* monr2DataBuffer,
+		const size_t bufferLength,
+		const struct timeval currentTime,
+		ObjectMonitor2Type* monitorData,
+		const char debug) {
+
+	MONR2ViewType view;
+	ssize_t retval;
+
+	if (monitorData == NULL || monr2DataBuffer == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_MONR2, 0,
+						 "Input pointers to MONR2 parsing function cannot be null");
+		return ISO_FUNCTION_ERROR;
+	}
+
+	memset(monitorData, 0, sizeof (*monitorData));
+
+	if ((retval = viewMONR2Message(monr2DataBuffer, bufferLength, &view)) < 0) {
+		return retval;
+	}
+
+	convertMONR2ToHostRepresentation(view.message, getAsGPSWeek(&currentTime), monitorData);
+
+	if (debug) {
+		printf("MONR2:\n");
+		printf("TransmitterId = %u\n", view.header.transmitterID);
+		printf("MessageCounter = %u\n", view.header.messageCounter);
+		printf("GPSQmsOfWeek = %u\n", getMONR2ViewGPSQmsOfWeek(&view));
+		printf("Pitch = %d\n", getMONR2ViewPitch(&view));
+		printf("Roll = %d\n", getMONR2ViewRoll(&view));
+		printf("VerticalSpeed = %d\n", getMONR2ViewVerticalSpeed(&view));
+		printf("VerticalAcc = %d\n", getMONR2ViewVerticalAcc(&view));
+		printf("YawRate = %d\n", getMONR2ViewYawRate(&view));
+		printf("PitchRate = %d\n", getMONR2ViewPitchRate(&view));
+		printf("RollRate = %d\n", getMONR2ViewRollRate(&view));
+		printf("PositionAccuracy = %u\n", getMONR2ViewPositionAccuracy(&view));
+	}
+
+	return retval;
+}
+
+/*!
+ * \brief decodeMONR2Messages Decodes a batch of MONR2 messages, such as datagrams received in one
+ *			system call. Checksums are verified together as by ::validateISOFrames, and the GPS week
+ *			of all message timestamps is taken from one reading of the current time.
+ * \param frames Buffers each starting with a MONR2 message
+ * \param lengths Number of bytes in each buffer
+ * \param nFrames Number of frames
+ * \param currentTime Current system time, used to guess GPS week of the messages
+ * \param monitorData Array in which to store the data of each frame, zeroed if it could not be decoded
+ * \param results Array in which to store the message size of each frame, or a negative value
+ *			according to ::ISOMessageReturnValue if it could not be decoded
+ * \return Number of frames decoded
+ */
+size_t decodeMONR2Messages(
+		const void* const frames[],
+		const size_t lengths[],
+		const size_t nFrames,
+		const struct timeval currentTime,
+		ObjectMonitor2Type monitorData[],
+		ssize_t results[]) {
+
+	const int32_t gpsWeek = getAsGPSWeek(&currentTime);
+	HeaderType headers[MONR2_DECODE_BATCH_SIZE];
+	size_t nDecoded = 0;
+
+	for (size_t start = 0; start < nFrames; start += MONR2_DECODE_BATCH_SIZE) {
+		const size_t nBatch = nFrames - start < MONR2_DECODE_BATCH_SIZE ? nFrames - start : MONR2_DECODE_BATCH_SIZE;
+
+		validateISOFrames(&frames[start], &lengths[start], nBatch, headers, &results[start]);
+		for (size_t i = start; i < start + nBatch; ++i) {
+			memset(&monitorData[i], 0, sizeof (monitorData[i]));
+			if (results[i] < 0 || (results[i] = checkMONR2Content(frames[i], &headers[i - start])) < 0) {
+				continue;
+			}
+			convertMONR2ToHostRepresentation(frames[i], gpsWeek, &monitorData[i]);
+			nDecoded++;
+		}
+	}
+	return nDecoded;
+}
+
+/*!
+ * \brief viewMONR2Message Validates a MONR2 message and makes a view of it without copying
+ *			or converting its contents
+ * \param monr2DataBuffer Raw data holding the message, which must outlive the view
+ * \param bufferLength Number of bytes in buffer of raw data
+ * \param view View to be filled
+ * \return Number of bytes in the message, or negative value according to ::ISOMessageReturnValue
+ */
+ssize_t viewMONR2Message(
+		const char* monr2DataBuffer,
+		const size_t bufferLength,
+		MONR2ViewType* view) {
+
+	ssize_t retval;
+
+	if (monr2DataBuffer == NULL || view == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_MONR2, 0,
+						 "Input pointers to MONR2 view function cannot be null");
+		return ISO_FUNCTION_ERROR;
+	}
+
+	view->message = NULL;
+	if ((retval = validateISOFrame(monr2DataBuffer, bufferLength, &view->header)) < 0
+			|| (retval = checkMONR2Content((const uint8_t*) monr2DataBuffer, &view->header)) < 0) {
+		return retval;
+	}
+	view->message = (const uint8_t*) monr2DataBuffer;
+	return retval;
+}
+
+/*!
+ * \brief checkMONR2Content Checks message type and content header of a validated frame
+ * \param message Frame starting with the message
+ * \param header Decoded header of the frame
+ * \return Size of the message, or negative value according to ::ISOMessageReturnValue
+ */
+static ssize_t checkMONR2Content(
+		const uint8_t* message,
+		const HeaderType* header) {
+
+	uint16_t valueID, contentLength;
+
+	if (header->messageID != MESSAGE_ID_MONR2) {
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_MONR2, offsetof(HeaderType, messageID),
+						 "Attempted to pass non-MONR2 message into MONR2 parsing function");
+		return MESSAGE_TYPE_ERROR;
+	}
+	if (header->messageLength != sizeof (MONR2Type) - sizeof (HeaderType) - sizeof (FooterType)) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_MONR2, offsetof(HeaderType, messageLength),
+						 "MONR2 message length %u differs from the expected length %zu", header->messageLength,
+						 sizeof (MONR2Type) - sizeof (HeaderType) - sizeof (FooterType));
+		return MESSAGE_LENGTH_ERROR;
+	}
+
+	memcpy(&valueID, message + offsetof(MONR2Type, monr2StructValueID), sizeof (valueID));
+	memcpy(&contentLength, message + offsetof(MONR2Type, monr2StructContentLength), sizeof (contentLength));
+	if (le16toh(valueID) != VALUE_ID_MONR2_STRUCT) {
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_MONR2, offsetof(MONR2Type, monr2StructValueID),
+						 "Attempted to pass non-MONR2 struct into MONR2 parsing function");
+		return MESSAGE_VALUE_ID_ERROR;
+	}
+	if (le16toh(contentLength) != MONR2_STRUCT_CONTENT_LENGTH) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_MONR2, offsetof(MONR2Type, monr2StructContentLength),
+						 "MONR2 content length %u differs from the expected length %zu",
+						 le16toh(contentLength), MONR2_STRUCT_CONTENT_LENGTH);
+		return MESSAGE_LENGTH_ERROR;
+	}
+	return sizeof (MONR2Type);
+}
+
+/*!
+ * \brief convertMONR2ToHostRepresentation Converts a checked MONR2 message to the internal
+ *			representation for secondary monitoring data
+ * \param message Frame starting with the message
+ * \param gpsWeek Current GPS week, or negative if unknown
+ * \param monitorData Monitor data in which result is to be placed
+ */
+static void convertMONR2ToHostRepresentation(
+		const uint8_t* message,
+		const int32_t gpsWeek,
+		ObjectMonitor2Type* monitorData) {
+
+	const MONR2ViewType view = { .message = message };
+	const uint32_t gpsQmsOfWeek = getMONR2ViewGPSQmsOfWeek(&view);
+	const int16_t pitch = getMONR2ViewPitch(&view);
+	const int16_t roll = getMONR2ViewRoll(&view);
+	const int16_t verticalSpeed = getMONR2ViewVerticalSpeed(&view);
+	const int16_t verticalAcc = getMONR2ViewVerticalAcc(&view);
+	const int16_t yawRate = getMONR2ViewYawRate(&view);
+	const int16_t pitchRate = getMONR2ViewPitchRate(&view);
+	const int16_t rollRate = getMONR2ViewRollRate(&view);
+	const uint16_t positionAccuracy = getMONR2ViewPositionAccuracy(&view);
+
+	monitorData->isTimestampValid = gpsQmsOfWeek != GPS_SECOND_OF_WEEK_UNAVAILABLE_VALUE && gpsWeek >= 0
+			&& setToGPStime(&monitorData->timestamp, (uint16_t) gpsWeek, gpsQmsOfWeek) >= 0;
+
+	monitorData->isPitchValid = pitch != PITCH_UNAVAILABLE_VALUE;
+	monitorData->pitch_rad = monitorData->isPitchValid ? pitch / PITCH_ONE_DEGREE_VALUE * M_PI / 180.0 : 0;
+	monitorData->isRollValid = roll != ROLL_UNAVAILABLE_VALUE;
+	monitorData->roll_rad = monitorData->isRollValid ? roll / ROLL_ONE_DEGREE_VALUE * M_PI / 180.0 : 0;
+
+	monitorData->isVerticalSpeedValid = verticalSpeed != SPEED_UNAVAILABLE_VALUE;
+	monitorData->verticalSpeed_m_s = monitorData->isVerticalSpeedValid ?
+				verticalSpeed / SPEED_ONE_METER_PER_SECOND_VALUE : 0;
+	monitorData->isVerticalAccValid = verticalAcc != ACCELERATION_UNAVAILABLE_VALUE;
+	monitorData->verticalAcc_m_s2 = monitorData->isVerticalAccValid ?
+				verticalAcc / ACCELERATION_ONE_METER_PER_SECOND_SQUARED_VALUE : 0;
+
+	monitorData->isYawRateValid = yawRate != ANGULAR_RATE_UNAVAILABLE_VALUE;
+	monitorData->yawRate_rad_s = monitorData->isYawRateValid ?
+				yawRate / ANGULAR_RATE_ONE_DEGREE_PER_SECOND_VALUE * M_PI / 180.0 : 0;
+	monitorData->isPitchRateValid = pitchRate != ANGULAR_RATE_UNAVAILABLE_VALUE;
+	monitorData->pitchRate_rad_s = monitorData->isPitchRateValid ?
+				pitchRate / ANGULAR_RATE_ONE_DEGREE_PER_SECOND_VALUE * M_PI / 180.0 : 0;
+	monitorData->isRollRateValid = rollRate != ANGULAR_RATE_UNAVAILABLE_VALUE;
+	monitorData->rollRate_rad_s = monitorData->isRollRateValid ?
+				rollRate / ANGULAR_RATE_ONE_DEGREE_PER_SECOND_VALUE * M_PI / 180.0 : 0;
+
+	monitorData->isPositionAccuracyValid = positionAccuracy != POSITION_ACCURACY_UNAVAILABLE_VALUE;
+	monitorData->positionAccuracy_m = monitorData->isPositionAccuracyValid ?
+				positionAccuracy / POSITION_ACCURACY_ONE_METER_VALUE : 0;
+}
@@ -2,12 +2,34 @@
 #include "defines.h"
 #include "timeconversions.h"
 #include "iso22133.h"
+#include "isoerror.h"
 
 #include <errno.h>
 #include <stdio.h>
 #include <string.h>
 
 
+/*!
+ * \brief getEncodedSizeOSEMMessage Get the size of an encoded OSEM message, which includes the
+ *		time server only if one is configured
+ * \param objectSettings Settings to be encoded
+ * \return Number of bytes written by ::encodeOSEMMessage
+ */
+size_t getEncodedSizeOSEMMessage(const ObjectSettingsType* objectSettings) {
+	const char SizeDifference64bitTo48bit = 2;
+	const bool timeServerUsed = objectSettings->timeServer.ip && objectSettings->timeServer.port;
+	const bool idAssociationUsed = false;
+
+	// Account for the two values which are 48 bit in the message
+	size_t msgLen = sizeof (HeaderType) + sizeof(OSEMIDType) + sizeof(OSEMOriginType)
+		+ sizeof(OSEMDateTimeType) + sizeof(OSEMAccuracyRequirementsType)
+		+ 4*2*sizeof(uint16_t) + sizeof (FooterType);
+	msgLen -= 2 * SizeDifference64bitTo48bit;
+	msgLen += timeServerUsed ? sizeof (OSEMTimeServerType) + 2*sizeof(uint16_t) : 0;
+	msgLen += idAssociationUsed ? sizeof(OSEMIDAssociationType) + 2*sizeof(uint16_t) : 0; // TODO handle id association
+	return msgLen;
+}
+
 /*!
  * \brief encodeOSEMMessage Creates an OSEM message and writes it into a buffer based on supplied values. All values are passed as pointers and
  *  passing them as NULL causes the OSEM message to contain a default value for that field (a value representing "unavailable" or similar).
@@ -37,32 +59,25 @@ ssize_t encodeOSEMMessage(
 	char *p = osemDataBuffer;
 
 	if (objectSettings == NULL) {
-		fprintf(stderr, "Invalid object settings input pointer\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_OSEM, 0, "Invalid object settings input pointer");
 		return -1;
 	}
 	bool timeServerUsed = objectSettings->timeServer.ip && objectSettings->timeServer.port;
-	bool idAssociationUsed = false;
 
 	// Get local time from real time system clock
 	time_t tval = objectSettings->currentTime.tv_sec;
 	printableTime = localtime(&tval);
 
-	memset(osemDataBuffer, 0, bufferLength);
+	const uint32_t msgLen = (uint32_t) getEncodedSizeOSEMMessage(objectSettings);
 
 	// If buffer too small to hold OSEM data, generate an error
-	if (bufferLength < sizeof (OSEMData) - 2 * SizeDifference64bitTo48bit) {
-		fprintf(stderr, "Buffer too small to hold necessary OSEM data\n");
+	if (bufferLength < msgLen) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_OSEM, (size_t) (p - osemDataBuffer),
+						 "Buffer too small to hold necessary OSEM data");
 		return -1;
 	}
 
-	// Build header, and account for the two values which are 48 bit in the message
-	uint32_t msgLen = sizeof (HeaderType) + sizeof(OSEMIDType) + sizeof(OSEMOriginType)
-		+ sizeof(OSEMDateTimeType) + sizeof(OSEMAccuracyRequirementsType)
-		+ 4*2*sizeof(uint16_t) + sizeof (FooterType);
-	msgLen -= 2 * SizeDifference64bitTo48bit;
-	msgLen += timeServerUsed ? sizeof (OSEMTimeServerType) + 2*sizeof(uint16_t) : 0;
-	msgLen += idAssociationUsed ? sizeof(OSEMIDAssociationType) + 2*sizeof(uint16_t) : 0; // TODO handle id association
-
+	// Build header
 	OSEMData.header = buildISOHeader(MESSAGE_ID_OSEM, inputHeader, msgLen, debug);
 
 	// Fill the OSEM struct with relevant values
@@ -266,7 +281,7 @@ ssize_t decodeOSEMMessage(
 
 	if (objectSettingsData == NULL || osemDataBuffer == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointer error\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_OSEM, 0, "Input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -283,7 +298,8 @@ ssize_t decodeOSEMMessage(
 
 	// If message is not a OSEM message, generate an error
 	if (OSEMData.header.messageID != MESSAGE_ID_OSEM) {
-		fprintf(stderr, "Attempted to pass non-OSEM message into OSEM parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_OSEM, (size_t) (p - osemDataBuffer),
+						 "Attempted to pass non-OSEM message into OSEM parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
@@ -302,7 +318,8 @@ ssize_t decodeOSEMMessage(
 		switch (valueID) {
 		case VALUE_ID_OSEM_ID_STRUCT:
 			if (contentLength != sizeof (OSEMData.ids)) {
-				fprintf(stderr, "Invalid OSEM ID struct length\n");
+				ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_OSEM, (size_t) (p - osemDataBuffer),
+								 "Invalid OSEM ID struct length");
 				return MESSAGE_LENGTH_ERROR;
 			}
 			OSEMData.idStructValueID = valueID;
@@ -314,7 +331,8 @@ ssize_t decodeOSEMMessage(
 			break;
 		case VALUE_ID_OSEM_ORIGIN_STRUCT:
 			if (contentLength != sizeof (OSEMData.origin) - 2*SizeDifference64bitTo48bit) {
-				fprintf(stderr, "Invalid OSEM origin struct length\n");
+				ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_OSEM, (size_t) (p - osemDataBuffer),
+								 "Invalid OSEM origin struct length");
 				return MESSAGE_LENGTH_ERROR;
 			}
 			OSEMData.originStructValueID = valueID;
@@ -339,7 +357,8 @@ ssize_t decodeOSEMMessage(
 			break;
 		case VALUE_ID_OSEM_DATE_TIME_STRUCT:
 			if (contentLength != sizeof (OSEMData.timestamp)) {
-				fprintf(stderr, "Invalid OSEM date time struct length\n");
+				ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_OSEM, (size_t) (p - osemDataBuffer),
+								 "Invalid OSEM date time struct length");
 				return MESSAGE_LENGTH_ERROR;
 			}
 			OSEMData.dateTimeStructValueID = valueID;
@@ -351,7 +370,8 @@ ssize_t decodeOSEMMessage(
 			break;
 		case VALUE_ID_OSEM_ACC_REQ_STRUCT:
 			if (contentLength != sizeof (OSEMData.requirements)) {
-				fprintf(stderr, "Invalid OSEM access requirements struct length\n");
+				ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_OSEM, (size_t) (p - osemDataBuffer),
+								 "Invalid OSEM access requirements struct length");
 				return MESSAGE_LENGTH_ERROR;
 			}
 			OSEMData.accReqStructValueID = valueID;
@@ -365,7 +385,8 @@ ssize_t decodeOSEMMessage(
 			break;
 		case VALUE_ID_OSEM_TIME_SERVER_STRUCT:
 			if (contentLength != sizeof (OSEMData.timeserver)) {
-				fprintf(stderr, "Invalid OSEM time server struct length\n");
+				ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_OSEM, (size_t) (p - osemDataBuffer),
+								 "Invalid OSEM time server struct length");
 				return MESSAGE_LENGTH_ERROR;
 			}
 			OSEMData.timeServerStructValueID = valueID;
@@ -375,7 +396,8 @@ ssize_t decodeOSEMMessage(
 			OSEMData.timeserver.port = le16toh(OSEMData.timeserver.port);
 			break;
 		default:
-			printf("Unable to handle OSEM value ID 0x%x\n", valueID);
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_OSEM, (size_t) (p - osemDataBuffer),
+							 "Unable to handle OSEM value ID 0x%x", valueID);
 			break;
 		}
 		p += contentLength;
@@ -385,14 +407,15 @@ ssize_t decodeOSEMMessage(
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - osemDataBuffer), &OSEMData.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding OSEM footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_OSEM, (size_t) (p - osemDataBuffer),
+						 "Error decoding OSEM footer");
 		return retval;
 	}
 	p += sizeof (OSEMData.footer);
 
 	if ((retval = verifyChecksum(osemDataBuffer, OSEMData.header.messageLength + sizeof (OSEMData.header),
 								 OSEMData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-		fprintf(stderr, "OSEM checksum error\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_OSEM, (size_t) (p - osemDataBuffer), "OSEM checksum error");
 		return retval;
 	}
 
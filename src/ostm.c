@@ -4,6 +4,15 @@
 #include <endian.h>
 #include <errno.h>
 #include "iso22133.h"
+#include "isoerror.h"
+
+/*!
+ * \brief getEncodedSizeOSTMMessage Get the size of an encoded OSTM message
+ * \return Number of bytes written by ::encodeOSTMMessage
+ */
+size_t getEncodedSizeOSTMMessage(void) {
+	return sizeof (OSTMType);
+}
 
 /*!
  * \brief encodeOSTMMessage Constructs an ISO OSTM message based on specified command
@@ -24,11 +33,10 @@ ssize_t encodeOSTMMessage(
 
 	OSTMType OSTMData;
 
-	memset(ostmDataBuffer, 0, bufferLength);
-
 	// Check so buffer can hold message
 	if (bufferLength < sizeof (OSTMData)) {
-		fprintf(stderr, "Buffer too small to hold necessary OSTM data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_OSTM, 0,
+						 "Buffer too small to hold necessary OSTM data");
 		return -1;
 	}
 
@@ -37,7 +45,8 @@ ssize_t encodeOSTMMessage(
 		(command == OBJECT_COMMAND_ARM || command == OBJECT_COMMAND_DISARM
 		 || command == OBJECT_COMMAND_REMOTE_CONTROL
 		 || command == OBJECT_COMMAND_ALL_CLEAR)) {
-		fprintf(stderr, "OSTM does not support command %u\n", (uint8_t) command);
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_OSTM, 0,
+						 "OSTM does not support command %u", (uint8_t) command);
 		return -1;
 	}
 
@@ -91,7 +100,8 @@ ssize_t decodeOSTMMessage(
 
 	if (ostmDataBuffer == NULL || command == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointers to OSTM parsing function cannot be null\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_OSTM, 0,
+						 "Input pointers to OSTM parsing function cannot be null");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -106,12 +116,14 @@ ssize_t decodeOSTMMessage(
 
 	// If message is not a PODI message, generate an error
 	if (OSTMData.header.messageID != MESSAGE_ID_OSTM) {
-		fprintf(stderr, "Attempted to pass non-OSTM message into OSTM parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_OSTM, (size_t) (p - ostmDataBuffer),
+						 "Attempted to pass non-OSTM message into OSTM parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
 	if (OSTMData.header.messageLength > sizeof (OSTMType) - sizeof (HeaderType) - sizeof (FooterType)) {
-		fprintf(stderr, "OSTM message exceeds expected message length\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_OSTM, (size_t) (p - ostmDataBuffer),
+						 "OSTM message exceeds expected message length");
 		return MESSAGE_LENGTH_ERROR;
 	}
 
@@ -131,14 +143,16 @@ ssize_t decodeOSTMMessage(
 			expectedContentLength = sizeof (OSTMData.state);
 			break;
 		default:
-			fprintf(stderr, "Value ID 0x%x does not match any known OSTM value IDs", valueID);
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_OSTM, (size_t) (p - ostmDataBuffer),
+							 "Value ID 0x%x does not match any known OSTM value IDs", valueID);
 			return MESSAGE_VALUE_ID_ERROR;
 		}
 
 		p += contentLength;
 		if (contentLength != expectedContentLength) {
-			fprintf(stderr, "Content length %u for value ID 0x%x does not match the expected %ld",
-					contentLength, valueID, expectedContentLength);
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_OSTM, (size_t) (p - ostmDataBuffer),
+							 "Content length %u for value ID 0x%x does not match the expected %ld",
+							 contentLength, valueID, expectedContentLength);
 			return MESSAGE_LENGTH_ERROR;
 		}
 	}
@@ -147,14 +161,15 @@ ssize_t decodeOSTMMessage(
 	if ((retval =
 		 decodeISOFooter(p, bufferLength - (size_t) (p - ostmDataBuffer), &OSTMData.footer,
 						 debug)) != MESSAGE_OK) {
-		fprintf(stderr, "Error decoding OSTM footer\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_OSTM, (size_t) (p - ostmDataBuffer),
+						 "Error decoding OSTM footer");
 		return retval;
 	}
 	p += sizeof (OSTMData.footer);
 
 	if ((retval = verifyChecksum(ostmDataBuffer, OSTMData.header.messageLength + sizeof (HeaderType),
 								 OSTMData.footer.Crc, debug)) == MESSAGE_CRC_ERROR) {
-		fprintf(stderr, "OSTM checksum error\n");
+		ISO_REPORT_ERROR(retval, MESSAGE_ID_OSTM, (size_t) (p - ostmDataBuffer), "OSTM checksum error");
 		return retval;
 	}
 
@@ -0,0 +1,658 @@
+#include "peertable.h"
+#include "frame.h"
+#include "footer.h"
+#include "defines.h"
+#include "isoerror.h"
+#include "timeconversions.h"
+
+#include <errno.h>
+#include <endian.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PEER_TABLE_DEFAULT_CAPACITY 16
+
+//! Fields of a PODI message making up the peer state
+typedef enum {
+	PEER_FIELD_FOREIGN_TRANSMITTER_ID,
+	PEER_FIELD_GPS_QMS_OF_WEEK,
+	PEER_FIELD_X_POSITION,
+	PEER_FIELD_Y_POSITION,
+	PEER_FIELD_Z_POSITION,
+	PEER_FIELD_HEADING,
+	PEER_FIELD_OBJECT_STATE,
+	PEER_FIELD_PITCH,
+	PEER_FIELD_ROLL,
+	PEER_FIELD_LONGITUDINAL_SPEED,
+	PEER_FIELD_LATERAL_SPEED,
+	PEER_FIELD_COUNT
+} PeerFieldType;
+
+//! Fields preceding the object state; the state defaults to unknown and the others to unavailable
+#define PEER_FIELDS_REQUIRED ((1 << PEER_FIELD_OBJECT_STATE) - 1)
+
+//! Fields in the order ::encodePODIMessage writes them
+static const struct {
+	uint16_t valueID;
+	uint16_t contentLength;
+	PeerFieldType field;
+} CanonicalPODILayout[] = {
+	{ VALUE_ID_PODI_FOREIGN_TRANSMITTER_ID, sizeof (uint32_t), PEER_FIELD_FOREIGN_TRANSMITTER_ID },
+	{ VALUE_ID_PODI_GPS_QMS_OF_WEEK, sizeof (uint32_t), PEER_FIELD_GPS_QMS_OF_WEEK },
+	{ VALUE_ID_PODI_OBJECT_STATE, sizeof (uint8_t), PEER_FIELD_OBJECT_STATE },
+	{ VALUE_ID_PODI_X_POSITION, sizeof (int32_t), PEER_FIELD_X_POSITION },
+	{ VALUE_ID_PODI_Y_POSITION, sizeof (int32_t), PEER_FIELD_Y_POSITION },
+	{ VALUE_ID_PODI_Z_POSITION, sizeof (int32_t), PEER_FIELD_Z_POSITION },
+	{ VALUE_ID_PODI_HEADING, sizeof (uint16_t), PEER_FIELD_HEADING },
+	{ VALUE_ID_PODI_PITCH, sizeof (int16_t), PEER_FIELD_PITCH },
+	{ VALUE_ID_PODI_ROLL, sizeof (int16_t), PEER_FIELD_ROLL },
+	{ VALUE_ID_PODI_LONGITUDINAL_SPEED, sizeof (int16_t), PEER_FIELD_LONGITUDINAL_SPEED },
+	{ VALUE_ID_PODI_LATERAL_SPEED, sizeof (int16_t), PEER_FIELD_LATERAL_SPEED },
+};
+#define CANONICAL_PODI_BODY_SIZE (11 * (2 * sizeof (uint16_t)) + 5 * sizeof (uint32_t) + 5 * sizeof (uint16_t) \
+								  + sizeof (uint8_t))
+
+//! One decoded PODI message, in the representation of the table columns
+typedef struct {
+	uint32_t foreignTransmitterID;
+	uint64_t gpsQms;
+	uint8_t state;
+	double xCoord_m;
+	double yCoord_m;
+	double zCoord_m;
+	double heading_rad;
+	uint8_t isHeadingValid;
+	double pitch_rad;
+	uint8_t isPitchValid;
+	double roll_rad;
+	uint8_t isRollValid;
+	double longitudinalSpeed_m_s;
+	uint8_t isLongitudinalSpeedValid;
+	double lateralSpeed_m_s;
+	uint8_t isLateralSpeedValid;
+} PeerSampleType;
+
+struct PeerTable {
+	size_t nPeers;
+	size_t capacity;
+	uint32_t* foreignTransmitterID;		//!< Sorted, all other columns follow the same order
+	uint64_t* gpsQms;
+	uint8_t* state;
+	double* xCoord_m;
+	double* yCoord_m;
+	double* zCoord_m;
+	double* heading_rad;
+	uint8_t* isHeadingValid;
+	double* pitch_rad;
+	uint8_t* isPitchValid;
+	double* roll_rad;
+	uint8_t* isRollValid;
+	double* longitudinalSpeed_m_s;
+	uint8_t* isLongitudinalSpeedValid;
+	double* lateralSpeed_m_s;
+	uint8_t* isLateralSpeedValid;
+
+	PeerTableStatisticsType statistics;
+};
+
+/*!
+ * \brief growPeerTable Enlarges all columns of a table. Columns already enlarged when an allocation
+ *			fails are kept, as the capacity is only updated once all succeed.
+ * \param table Table to enlarge
+ * \param capacity New number of peers the table can hold
+ * \return 0 on success, -1 otherwise
+ */
+static int growPeerTable(PeerTableType* table, const size_t capacity) {
+	void* column;
+
+#define GROW_COLUMN(name) \
+	if ((column = realloc(table->name, capacity * sizeof (*table->name))) == NULL) { \
+		return -1; \
+	} \
+	table->name = column;
+
+	GROW_COLUMN(foreignTransmitterID)
+	GROW_COLUMN(gpsQms)
+	GROW_COLUMN(state)
+	GROW_COLUMN(xCoord_m)
+	GROW_COLUMN(yCoord_m)
+	GROW_COLUMN(zCoord_m)
+	GROW_COLUMN(heading_rad)
+	GROW_COLUMN(isHeadingValid)
+	GROW_COLUMN(pitch_rad)
+	GROW_COLUMN(isPitchValid)
+	GROW_COLUMN(roll_rad)
+	GROW_COLUMN(isRollValid)
+	GROW_COLUMN(longitudinalSpeed_m_s)
+	GROW_COLUMN(isLongitudinalSpeedValid)
+	GROW_COLUMN(lateralSpeed_m_s)
+	GROW_COLUMN(isLateralSpeedValid)
+#undef GROW_COLUMN
+
+	table->capacity = capacity;
+	return 0;
+}
+
+/*!
+ * \brief createPeerTable Creates an empty table of peer states, to be filled from PODI messages
+ * \param initialCapacity Number of peers to allocate space for, or 0 for a default
+ * \return The table, or NULL if it could not be allocated
+ */
+PeerTableType* createPeerTable(const size_t initialCapacity) {
+	PeerTableType* table = calloc(1, sizeof (*table));
+
+	if (table == NULL) {
+		return NULL;
+	}
+	if (growPeerTable(table, initialCapacity ? initialCapacity : PEER_TABLE_DEFAULT_CAPACITY) < 0) {
+		freePeerTable(table);
+		return NULL;
+	}
+	return table;
+}
+
+/*!
+ * \brief freePeerTable Frees a table created with ::createPeerTable
+ * \param table Table to free
+ */
+void freePeerTable(PeerTableType* table) {
+	if (table == NULL) {
+		return;
+	}
+	free(table->foreignTransmitterID);
+	free(table->gpsQms);
+	free(table->state);
+	free(table->xCoord_m);
+	free(table->yCoord_m);
+	free(table->zCoord_m);
+	free(table->heading_rad);
+	free(table->isHeadingValid);
+	free(table->pitch_rad);
+	free(table->isPitchValid);
+	free(table->roll_rad);
+	free(table->isRollValid);
+	free(table->longitudinalSpeed_m_s);
+	free(table->isLongitudinalSpeedValid);
+	free(table->lateralSpeed_m_s);
+	free(table->isLateralSpeedValid);
+	free(table);
+}
+
+/*!
+ * \brief findPeerIndex Binary search for a peer
+ * \param table Table holding the peers
+ * \param foreignTransmitterID ID of the peer
+ * \param found Set to whether the peer exists
+ * \return Index of the peer, or the index at which it would be inserted
+ */
+static size_t findPeerIndex(const PeerTableType* table, const uint32_t foreignTransmitterID, bool* found) {
+	size_t low = 0, high = table->nPeers;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (table->foreignTransmitterID[middle] < foreignTransmitterID) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	*found = low < table->nPeers && table->foreignTransmitterID[low] == foreignTransmitterID;
+	return low;
+}
+
+/*!
+ * \brief checkPODIValueLayout Checks the value ID and content length of each field in a PODI message body,
+ *			and finds the content of the fields making up the peer state
+ * \param header Header of the message
+ * \param body Message body following the header
+ * \param content Array, indexed by ::PeerFieldType, in which to store the start of the content of each field
+ * \return Set of present ::PeerFieldType fields as a bitmask, or a negative value according to ::ISOMessageReturnValue
+ */
+static int checkPODIValueLayout(
+		const HeaderType* header,
+		const uint8_t* body,
+		const uint8_t* content[]) {
+	const uint8_t* p = body;
+	const uint8_t* const end = body + header->messageLength;
+	int fieldsPresent = 0;
+
+	while (p < end) {
+		uint16_t valueID, contentLength;
+		size_t expectedContentLength;
+		PeerFieldType field;
+
+		if (end - p < (ptrdiff_t) (sizeof (valueID) + sizeof (contentLength))) {
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, header->messageID, sizeof (HeaderType) + (size_t) (p - body),
+							 "Truncated value ID in PODI message");
+			return MESSAGE_LENGTH_ERROR;
+		}
+		memcpy(&valueID, p, sizeof (valueID));
+		p += sizeof (valueID);
+		memcpy(&contentLength, p, sizeof (contentLength));
+		p += sizeof (contentLength);
+		valueID = le16toh(valueID);
+		contentLength = le16toh(contentLength);
+
+		switch (valueID) {
+		case VALUE_ID_PODI_FOREIGN_TRANSMITTER_ID:
+			field = PEER_FIELD_FOREIGN_TRANSMITTER_ID;
+			expectedContentLength = sizeof (uint32_t);
+			break;
+		case VALUE_ID_PODI_GPS_QMS_OF_WEEK:
+			field = PEER_FIELD_GPS_QMS_OF_WEEK;
+			expectedContentLength = sizeof (uint32_t);
+			break;
+		case VALUE_ID_PODI_X_POSITION:
+			field = PEER_FIELD_X_POSITION;
+			expectedContentLength = sizeof (int32_t);
+			break;
+		case VALUE_ID_PODI_Y_POSITION:
+			field = PEER_FIELD_Y_POSITION;
+			expectedContentLength = sizeof (int32_t);
+			break;
+		case VALUE_ID_PODI_Z_POSITION:
+			field = PEER_FIELD_Z_POSITION;
+			expectedContentLength = sizeof (int32_t);
+			break;
+		case VALUE_ID_PODI_HEADING:
+			field = PEER_FIELD_HEADING;
+			expectedContentLength = sizeof (uint16_t);
+			break;
+		case VALUE_ID_PODI_OBJECT_STATE:
+			field = PEER_FIELD_OBJECT_STATE;
+			expectedContentLength = sizeof (uint8_t);
+			break;
+		case VALUE_ID_PODI_PITCH:
+			field = PEER_FIELD_PITCH;
+			expectedContentLength = sizeof (int16_t);
+			break;
+		case VALUE_ID_PODI_ROLL:
+			field = PEER_FIELD_ROLL;
+			expectedContentLength = sizeof (int16_t);
+			break;
+		case VALUE_ID_PODI_LONGITUDINAL_SPEED:
+			field = PEER_FIELD_LONGITUDINAL_SPEED;
+			expectedContentLength = sizeof (int16_t);
+			break;
+		case VALUE_ID_PODI_LATERAL_SPEED:
+			field = PEER_FIELD_LATERAL_SPEED;
+			expectedContentLength = sizeof (int16_t);
+			break;
+		default:
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, header->messageID, sizeof (HeaderType) + (size_t) (p - body),
+							 "Value ID 0x%x does not match any known PODI value IDs", valueID);
+			return MESSAGE_VALUE_ID_ERROR;
+		}
+		if (contentLength != expectedContentLength || end - p < (ptrdiff_t) contentLength) {
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, header->messageID, sizeof (HeaderType) + (size_t) (p - body),
+							 "Content length %u for value ID 0x%x does not match the expected %zu",
+							 contentLength, valueID, expectedContentLength);
+			return MESSAGE_LENGTH_ERROR;
+		}
+		content[field] = p;
+		fieldsPresent |= 1 << field;
+		p += contentLength;
+	}
+	return fieldsPresent;
+}
+
+/*!
+ * \brief findCanonicalPODIContent Finds the field contents of a PODI message laid out exactly as
+ *			::encodePODIMessage writes it, by comparing each value ID and content length against the
+ *			expected ones instead of dispatching on them
+ * \param header Header of the message
+ * \param body Message body following the header
+ * \param content Array, indexed by ::PeerFieldType, in which to store the start of the content of each field
+ * \return true if the message has the canonical layout, false if it has to be parsed field by field
+ */
+static bool findCanonicalPODIContent(
+		const HeaderType* header,
+		const uint8_t* body,
+		const uint8_t* content[]) {
+	size_t offset = 0;
+
+	if (header->messageLength != CANONICAL_PODI_BODY_SIZE) {
+		return false;
+	}
+	// Value ID and content length read as one little endian word
+	for (size_t i = 0; i < sizeof (CanonicalPODILayout) / sizeof (CanonicalPODILayout[0]); ++i) {
+		uint32_t valueHeader;
+		memcpy(&valueHeader, body + offset, sizeof (valueHeader));
+		if (le32toh(valueHeader) != ((uint32_t) CanonicalPODILayout[i].contentLength << 16
+									 | CanonicalPODILayout[i].valueID)) {
+			return false;
+		}
+		offset += sizeof (valueHeader);
+		content[CanonicalPODILayout[i].field] = body + offset;
+		offset += CanonicalPODILayout[i].contentLength;
+	}
+	return true;
+}
+
+/*!
+ * \brief parsePODIFrame Decodes a PODI message directly into the table representation
+ * \param frame Buffer starting with the message
+ * \param length Number of bytes in the buffer
+ * \param gpsWeek GPS week in which the message timestamp lies
+ * \param sample Struct in which to store the decoded message
+ * \return Size of the message including header and footer, or a negative value
+ *			according to ::ISOMessageReturnValue
+ */
+static ssize_t parsePODIFrame(
+		const void* frame,
+		const size_t length,
+		const uint16_t gpsWeek,
+		PeerSampleType* sample) {
+	HeaderType header;
+	const ssize_t messageSize = validateISOFrameHeader(frame, length, &header);
+	const uint8_t* content[PEER_FIELD_COUNT];
+	const uint8_t* body = (const uint8_t*) frame + sizeof (HeaderType);
+	int fieldsPresent = (1 << PEER_FIELD_COUNT) - 1;
+	uint32_t u32;
+	uint16_t u16;
+
+	if (messageSize < 0) {
+		return messageSize;
+	}
+	if (header.messageID != MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI) {
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, header.messageID, offsetof(HeaderType, messageID),
+						 "Attempted to pass non-PODI message into PODI parsing function");
+		return MESSAGE_TYPE_ERROR;
+	}
+	if (!findCanonicalPODIContent(&header, body, content)
+			&& (fieldsPresent = checkPODIValueLayout(&header, body, content)) < 0) {
+		return fieldsPresent;
+	}
+	if ((fieldsPresent & PEER_FIELDS_REQUIRED) != PEER_FIELDS_REQUIRED) {
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, header.messageID, sizeof (HeaderType),
+						 "PODI message lacks required fields (0x%02x present)", fieldsPresent);
+		return MESSAGE_VALUE_ID_ERROR;
+	}
+
+	memcpy(&u32, content[PEER_FIELD_GPS_QMS_OF_WEEK], sizeof (u32));
+	const uint32_t gpsQmsOfWeek = le32toh(u32);
+	if (gpsQmsOfWeek == GPS_SECOND_OF_WEEK_UNAVAILABLE_VALUE) {
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, header.messageID, sizeof (HeaderType),
+						 "Timestamp not supplied in PODI message");
+		return MESSAGE_VALUE_ID_ERROR;
+	}
+	sample->gpsQms = (uint64_t) gpsWeek * WEEK_TIME_QMS + gpsQmsOfWeek;
+
+	memcpy(&u32, content[PEER_FIELD_FOREIGN_TRANSMITTER_ID], sizeof (u32));
+	sample->foreignTransmitterID = le32toh(u32);
+	sample->state = fieldsPresent & (1 << PEER_FIELD_OBJECT_STATE) ?
+				*content[PEER_FIELD_OBJECT_STATE] : OBJECT_STATE_UNKNOWN;
+	memcpy(&u32, content[PEER_FIELD_X_POSITION], sizeof (u32));
+	sample->xCoord_m = (int32_t) le32toh(u32) / POSITION_ONE_METER_VALUE;
+	memcpy(&u32, content[PEER_FIELD_Y_POSITION], sizeof (u32));
+	sample->yCoord_m = (int32_t) le32toh(u32) / POSITION_ONE_METER_VALUE;
+	memcpy(&u32, content[PEER_FIELD_Z_POSITION], sizeof (u32));
+	sample->zCoord_m = (int32_t) le32toh(u32) / POSITION_ONE_METER_VALUE;
+	memcpy(&u16, content[PEER_FIELD_HEADING], sizeof (u16));
+	u16 = le16toh(u16);
+	sample->isHeadingValid = u16 != YAW_UNAVAILABLE_VALUE;
+	sample->heading_rad = mapISOHeadingToHostHeading(u16 / YAW_ONE_DEGREE_VALUE * M_PI / 180.0);
+
+	sample->isPitchValid = sample->isRollValid = false;
+	sample->isLongitudinalSpeedValid = sample->isLateralSpeedValid = false;
+	sample->pitch_rad = sample->roll_rad = 0.0;
+	sample->longitudinalSpeed_m_s = sample->lateralSpeed_m_s = 0.0;
+	if (fieldsPresent & (1 << PEER_FIELD_PITCH)) {
+		memcpy(&u16, content[PEER_FIELD_PITCH], sizeof (u16));
+		const int16_t pitch = (int16_t) le16toh(u16);
+		sample->isPitchValid = pitch != PITCH_UNAVAILABLE_VALUE;
+		sample->pitch_rad = sample->isPitchValid ? pitch / PITCH_ONE_DEGREE_VALUE * M_PI / 180.0 : 0.0;
+	}
+	if (fieldsPresent & (1 << PEER_FIELD_ROLL)) {
+		memcpy(&u16, content[PEER_FIELD_ROLL], sizeof (u16));
+		const int16_t roll = (int16_t) le16toh(u16);
+		sample->isRollValid = roll != ROLL_UNAVAILABLE_VALUE;
+		sample->roll_rad = sample->isRollValid ? roll / ROLL_ONE_DEGREE_VALUE * M_PI / 180.0 : 0.0;
+	}
+	if (fieldsPresent & (1 << PEER_FIELD_LONGITUDINAL_SPEED)) {
+		memcpy(&u16, content[PEER_FIELD_LONGITUDINAL_SPEED], sizeof (u16));
+		const int16_t speed = (int16_t) le16toh(u16);
+		sample->isLongitudinalSpeedValid = speed != SPEED_UNAVAILABLE_VALUE;
+		sample->longitudinalSpeed_m_s = sample->isLongitudinalSpeedValid ?
+					speed / SPEED_ONE_METER_PER_SECOND_VALUE : 0.0;
+	}
+	if (fieldsPresent & (1 << PEER_FIELD_LATERAL_SPEED)) {
+		memcpy(&u16, content[PEER_FIELD_LATERAL_SPEED], sizeof (u16));
+		const int16_t speed = (int16_t) le16toh(u16);
+		sample->isLateralSpeedValid = speed != SPEED_UNAVAILABLE_VALUE;
+		sample->lateralSpeed_m_s = sample->isLateralSpeedValid ? speed / SPEED_ONE_METER_PER_SECOND_VALUE : 0.0;
+	}
+	return messageSize;
+}
+
+/*!
+ * \brief applyPeerSample Stores a sample in the table unless a newer one of the same peer is held
+ * \param table Table to update
+ * \param sample Decoded sample
+ * \return 0 on success, -1 if the table could not be enlarged
+ */
+static int applyPeerSample(PeerTableType* table, const PeerSampleType* sample) {
+	bool found;
+	const size_t i = findPeerIndex(table, sample->foreignTransmitterID, &found);
+
+	if (found && table->gpsQms[i] >= sample->gpsQms) {
+		table->statistics.nSamplesOutdated++;
+		return 0;
+	}
+	if (!found) {
+		if (table->nPeers == table->capacity && growPeerTable(table, 2 * table->capacity) < 0) {
+			return -1;
+		}
+		const size_t nAfter = table->nPeers - i;
+#define SHIFT_COLUMN(name) \
+		memmove(&table->name[i + 1], &table->name[i], nAfter * sizeof (*table->name));
+		SHIFT_COLUMN(foreignTransmitterID)
+		SHIFT_COLUMN(gpsQms)
+		SHIFT_COLUMN(state)
+		SHIFT_COLUMN(xCoord_m)
+		SHIFT_COLUMN(yCoord_m)
+		SHIFT_COLUMN(zCoord_m)
+		SHIFT_COLUMN(heading_rad)
+		SHIFT_COLUMN(isHeadingValid)
+		SHIFT_COLUMN(pitch_rad)
+		SHIFT_COLUMN(isPitchValid)
+		SHIFT_COLUMN(roll_rad)
+		SHIFT_COLUMN(isRollValid)
+		SHIFT_COLUMN(longitudinalSpeed_m_s)
+		SHIFT_COLUMN(isLongitudinalSpeedValid)
+		SHIFT_COLUMN(lateralSpeed_m_s)
+		SHIFT_COLUMN(isLateralSpeedValid)
+#undef SHIFT_COLUMN
+		table->nPeers++;
+		table->foreignTransmitterID[i] = sample->foreignTransmitterID;
+	}
+	table->gpsQms[i] = sample->gpsQms;
+	table->state[i] = sample->state;
+	table->xCoord_m[i] = sample->xCoord_m;
+	table->yCoord_m[i] = sample->yCoord_m;
+	table->zCoord_m[i] = sample->zCoord_m;
+	table->heading_rad[i] = sample->heading_rad;
+	table->isHeadingValid[i] = sample->isHeadingValid;
+	table->pitch_rad[i] = sample->pitch_rad;
+	table->isPitchValid[i] = sample->isPitchValid;
+	table->roll_rad[i] = sample->roll_rad;
+	table->isRollValid[i] = sample->isRollValid;
+	table->longitudinalSpeed_m_s[i] = sample->longitudinalSpeed_m_s;
+	table->isLongitudinalSpeedValid[i] = sample->isLongitudinalSpeedValid;
+	table->lateralSpeed_m_s[i] = sample->lateralSpeed_m_s;
+	table->isLateralSpeedValid[i] = sample->isLateralSpeedValid;
+	table->statistics.nSamplesApplied++;
+	return 0;
+}
+
+/*!
+ * \brief decodePODIMessages Decodes a batch of PODI messages, such as datagrams received in one system call,
+ *			into a peer table. The GPS week of all message timestamps is taken from one reading of the
+ *			current time, and of several messages about the same peer only the newest is kept. As with
+ *			::decodePODIMessage, checksums are not verified.
+ * \param table Table to update
+ * \param frames Buffers each starting with a PODI message
+ * \param lengths Number of bytes in each buffer
+ * \param nFrames Number of frames
+ * \param currentTime Current time, used to find the GPS week of the messages
+ * \param results Array in which to store the message size of each frame, or a negative value
+ *			according to ::ISOMessageReturnValue if it could not be decoded
+ * \return Number of frames decoded
+ */
+size_t decodePODIMessages(
+		PeerTableType* table,
+		const void* const frames[],
+		const size_t lengths[],
+		const size_t nFrames,
+		const struct timeval currentTime,
+		ssize_t results[]) {
+	const int32_t gpsWeek = getAsGPSWeek(&currentTime);
+	size_t nDecoded = 0;
+
+	if (table == NULL || gpsWeek < 0) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, 0,
+						 "Invalid peer table or current time");
+		for (size_t i = 0; i < nFrames; ++i) {
+			results[i] = ISO_FUNCTION_ERROR;
+		}
+		return 0;
+	}
+
+	for (size_t i = 0; i < nFrames; ++i) {
+		PeerSampleType sample;
+		results[i] = parsePODIFrame(frames[i], lengths[i], (uint16_t) gpsWeek, &sample);
+		if (results[i] >= 0 && applyPeerSample(table, &sample) < 0) {
+			results[i] = ISO_FUNCTION_ERROR;
+		}
+		if (results[i] < 0) {
+			table->statistics.nDecodeErrors++;
+			continue;
+		}
+		nDecoded++;
+	}
+	return nDecoded;
+}
+
+/*!
+ * \brief getPeerTableSnapshot Gets the columns of a table
+ * \param table Table to read
+ * \return A view of the table, valid until it is next modified
+ */
+PeerTableSnapshotType getPeerTableSnapshot(const PeerTableType* table) {
+	PeerTableSnapshotType snapshot;
+
+	snapshot.nPeers = table->nPeers;
+	snapshot.foreignTransmitterID = table->foreignTransmitterID;
+	snapshot.gpsQms = table->gpsQms;
+	snapshot.state = table->state;
+	snapshot.xCoord_m = table->xCoord_m;
+	snapshot.yCoord_m = table->yCoord_m;
+	snapshot.zCoord_m = table->zCoord_m;
+	snapshot.heading_rad = table->heading_rad;
+	snapshot.isHeadingValid = table->isHeadingValid;
+	snapshot.pitch_rad = table->pitch_rad;
+	snapshot.isPitchValid = table->isPitchValid;
+	snapshot.roll_rad = table->roll_rad;
+	snapshot.isRollValid = table->isRollValid;
+	snapshot.longitudinalSpeed_m_s = table->longitudinalSpeed_m_s;
+	snapshot.isLongitudinalSpeedValid = table->isLongitudinalSpeedValid;
+	snapshot.lateralSpeed_m_s = table->lateralSpeed_m_s;
+	snapshot.isLateralSpeedValid = table->isLateralSpeedValid;
+	return snapshot;
+}
+
+/*!
+ * \brief findPeerTableIndex Finds the index of a peer in the table columns
+ * \param table Table to search
+ * \param foreignTransmitterID ID of the peer
+ * \return Index of the peer, or -1 if it is not in the table
+ */
+ssize_t findPeerTableIndex(const PeerTableType* table, const uint32_t foreignTransmitterID) {
+	bool found;
+	const size_t i = findPeerIndex(table, foreignTransmitterID, &found);
+	return found ? (ssize_t) i : -1;
+}
+
+/*!
+ * \brief getPeerTableEntry Converts one peer of the table to the representation filled by ::decodePODIMessage.
+ *			Unlike that function, pitch, roll and speed are filled in when the peer supplied them.
+ * \param table Table to read
+ * \param index Index of the peer
+ * \param peerData Struct in which to store the peer state
+ * \return 0 on success, -1 if the index is out of range
+ */
+int getPeerTableEntry(const PeerTableType* table, const size_t index, PeerObjectInjectionType* peerData) {
+	if (peerData == NULL || index >= table->nPeers) {
+		errno = EINVAL;
+		return -1;
+	}
+	memset(peerData, 0, sizeof (*peerData));
+	peerData->foreignTransmitterID = table->foreignTransmitterID[index];
+	setToGPStime(&peerData->dataTimestamp, (uint16_t) (table->gpsQms[index] / WEEK_TIME_QMS),
+				 (uint32_t) (table->gpsQms[index] % WEEK_TIME_QMS));
+	peerData->state = (ObjectStateType) table->state[index];
+	peerData->position.isPositionValid = 1;
+	peerData->position.xCoord_m = table->xCoord_m[index];
+	peerData->position.yCoord_m = table->yCoord_m[index];
+	peerData->position.zCoord_m = table->zCoord_m[index];
+	peerData->position.isHeadingValid = table->isHeadingValid[index];
+	peerData->position.heading_rad = table->heading_rad[index];
+	peerData->isPitchValid = table->isPitchValid[index];
+	peerData->pitch_rad = table->pitch_rad[index];
+	peerData->isRollValid = table->isRollValid[index];
+	peerData->roll_rad = table->roll_rad[index];
+	peerData->speed.isLongitudinalValid = table->isLongitudinalSpeedValid[index];
+	peerData->speed.longitudinal_m_s = table->longitudinalSpeed_m_s[index];
+	peerData->speed.isLateralValid = table->isLateralSpeedValid[index];
+	peerData->speed.lateral_m_s = table->lateralSpeed_m_s[index];
+	return 0;
+}
+
+/*!
+ * \brief removeOutdatedPeers Removes peers whose newest sample is older than a given time
+ * \param table Table to prune
+ * \param oldestTime Time of the oldest sample to keep
+ * \return Number of peers removed
+ */
+size_t removeOutdatedPeers(PeerTableType* table, const struct timeval* oldestTime) {
+	const int32_t gpsWeek = getAsGPSWeek(oldestTime);
+	const int64_t gpsQmsOfWeek = getAsGPSQuarterMillisecondOfWeek(oldestTime);
+	size_t nKept = 0;
+
+	if (gpsWeek < 0 || gpsQmsOfWeek < 0) {
+		return 0;
+	}
+	const uint64_t oldestGPSQms = (uint64_t) gpsWeek * WEEK_TIME_QMS + (uint64_t) gpsQmsOfWeek;
+	for (size_t i = 0; i < table->nPeers; ++i) {
+		if (table->gpsQms[i] < oldestGPSQms) {
+			continue;
+		}
+		table->foreignTransmitterID[nKept] = table->foreignTransmitterID[i];
+		table->gpsQms[nKept] = table->gpsQms[i];
+		table->state[nKept] = table->state[i];
+		table->xCoord_m[nKept] = table->xCoord_m[i];
+		table->yCoord_m[nKept] = table->yCoord_m[i];
+		table->zCoord_m[nKept] = table->zCoord_m[i];
+		table->heading_rad[nKept] = table->heading_rad[i];
+		table->isHeadingValid[nKept] = table->isHeadingValid[i];
+		table->pitch_rad[nKept] = table->pitch_rad[i];
+		table->isPitchValid[nKept] = table->isPitchValid[i];
+		table->roll_rad[nKept] = table->roll_rad[i];
+		table->isRollValid[nKept] = table->isRollValid[i];
+		table->longitudinalSpeed_m_s[nKept] = table->longitudinalSpeed_m_s[i];
+		table->isLongitudinalSpeedValid[nKept] = table->isLongitudinalSpeedValid[i];
+		table->lateralSpeed_m_s[nKept] = table->lateralSpeed_m_s[i];
+		table->isLateralSpeedValid[nKept] = table->isLateralSpeedValid[i];
+		nKept++;
+	}
+	const size_t nRemoved = table->nPeers - nKept;
+	table->nPeers = nKept;
+	return nRemoved;
+}
+
+PeerTableStatisticsType getPeerTableStatistics(const PeerTableType* table) {
+	return table->statistics;
+}
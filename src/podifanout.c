@@ -0,0 +1,374 @@
+#include "podifanout.h"
+#include "header.h"
+#include "footer.h"
+#include "isoerror.h"
+
+#include <errno.h>
+#include <endian.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Header bytes differing between receivers, patched into each copy of an encoded message
+#define PATCH_OFFSET offsetof(HeaderType, receiverID)
+#define PATCH_LENGTH (sizeof (uint32_t) + sizeof (uint8_t))
+
+typedef struct {
+	PeerObjectInjectionType data;
+	char* frame;				//!< Encoded for receiver ID 0 and message counter 0
+	size_t frameLength;			//!< Zero if the peer could not be encoded this tick
+} FanoutPeerType;
+
+typedef struct {
+	uint32_t receiverID;
+	double interestRadius_m;
+	uint8_t messageCounter;
+} FanoutReceiverType;
+
+struct PODIFanout {
+	uint32_t transmitterID;
+	size_t maxDatagramSize;
+	size_t frameSize;
+	char* datagram;
+	//! CRC change caused by each value of each patched byte, as all messages have the same size
+	uint16_t patchCRCDelta[PATCH_LENGTH][256];
+
+	FanoutPeerType* peers;			//!< Sorted on foreign transmitter ID
+	size_t nPeers;
+	FanoutReceiverType* receivers;	//!< Sorted on receiver ID
+	size_t nReceivers;
+
+	PODIFanoutStatisticsType statistics;
+};
+
+/*!
+ * \brief findPeerIndex Binary search for a peer
+ * \param fanout Engine holding the peers
+ * \param peerID Foreign transmitter ID of the peer
+ * \param found Set to whether the peer exists
+ * \return Index of the peer, or the index at which it would be inserted
+ */
+static size_t findPeerIndex(const PODIFanoutType* fanout, const uint32_t peerID, bool* found) {
+	size_t low = 0, high = fanout->nPeers;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (fanout->peers[middle].data.foreignTransmitterID < peerID) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	*found = low < fanout->nPeers && fanout->peers[low].data.foreignTransmitterID == peerID;
+	return low;
+}
+
+/*!
+ * \brief findReceiverIndex Binary search for a receiver
+ * \param fanout Engine holding the receivers
+ * \param receiverID ID of the receiver
+ * \param found Set to whether the receiver exists
+ * \return Index of the receiver, or the index at which it would be inserted
+ */
+static size_t findReceiverIndex(const PODIFanoutType* fanout, const uint32_t receiverID, bool* found) {
+	size_t low = 0, high = fanout->nReceivers;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (fanout->receivers[middle].receiverID < receiverID) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	*found = low < fanout->nReceivers && fanout->receivers[low].receiverID == receiverID;
+	return low;
+}
+
+/*!
+ * \brief createPODIFanout Create an engine sending PODI messages about every peer to every receiver
+ * \param transmitterID Transmitter ID of the sent messages
+ * \param maxDatagramSize Largest datagram passed to the sink, or 0 for ::PODI_FANOUT_DEFAULT_DATAGRAM_SIZE
+ * \return Allocated engine, or NULL with errno set on failure
+ */
+PODIFanoutType* createPODIFanout(const uint32_t transmitterID, const size_t maxDatagramSize) {
+	const size_t datagramSize = maxDatagramSize ? maxDatagramSize : PODI_FANOUT_DEFAULT_DATAGRAM_SIZE;
+
+	if (datagramSize < getEncodedSizePODIMessage()) {
+		errno = EINVAL;
+		return NULL;
+	}
+	PODIFanoutType* fanout = calloc(1, sizeof (*fanout));
+	if (fanout == NULL) {
+		return NULL;
+	}
+	fanout->transmitterID = transmitterID;
+	fanout->maxDatagramSize = datagramSize;
+	fanout->frameSize = getEncodedSizePODIMessage();
+	fanout->datagram = malloc(datagramSize);
+	if (fanout->datagram == NULL) {
+		free(fanout);
+		return NULL;
+	}
+
+	const uint8_t zeros[PATCH_LENGTH] = { 0 };
+	const size_t bytesAfterPatch = fanout->frameSize - sizeof (FooterType) - PATCH_OFFSET - PATCH_LENGTH;
+	for (size_t i = 0; i < PATCH_LENGTH; ++i) {
+		uint8_t patch[PATCH_LENGTH] = { 0 };
+		for (unsigned int value = 0; value < 256; ++value) {
+			patch[i] = (uint8_t) value;
+			fanout->patchCRCDelta[i][value] = crc16Patch(0, zeros, patch, PATCH_LENGTH, bytesAfterPatch);
+		}
+	}
+	return fanout;
+}
+
+/*!
+ * \brief freePODIFanout Free an engine created with ::createPODIFanout
+ * \param fanout Engine to free, may be NULL
+ */
+void freePODIFanout(PODIFanoutType* fanout) {
+	if (fanout == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < fanout->nPeers; ++i) {
+		free(fanout->peers[i].frame);
+	}
+	free(fanout->peers);
+	free(fanout->receivers);
+	free(fanout->datagram);
+	free(fanout);
+}
+
+/*!
+ * \brief addPODIFanoutReceiver Add an object to receive PODI messages about its peers, or change the
+ *			interest radius of one already added. An object never receives messages about itself.
+ * \param fanout Engine to configure
+ * \param receiverID ID of the object
+ * \param interestRadius_m Only peers within this horizontal distance of the object are sent, or 0 for
+ *			all peers. The object position is taken from the peer with the same ID, and all peers are
+ *			sent while it is unknown.
+ * \return 0 on success, -1 with errno set on failure
+ */
+int addPODIFanoutReceiver(PODIFanoutType* fanout, const uint32_t receiverID, const double interestRadius_m) {
+	bool found;
+	const size_t i = findReceiverIndex(fanout, receiverID, &found);
+
+	if (interestRadius_m < 0.0) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (!found) {
+		FanoutReceiverType* receivers = realloc(fanout->receivers, (fanout->nReceivers + 1) * sizeof (*receivers));
+		if (receivers == NULL) {
+			return -1;
+		}
+		fanout->receivers = receivers;
+		memmove(&receivers[i + 1], &receivers[i], (fanout->nReceivers - i) * sizeof (*receivers));
+		fanout->nReceivers++;
+		receivers[i].receiverID = receiverID;
+		receivers[i].messageCounter = 0;
+	}
+	fanout->receivers[i].interestRadius_m = interestRadius_m;
+	return 0;
+}
+
+/*!
+ * \brief removePODIFanoutReceiver Stop sending PODI messages to an object
+ * \param fanout Engine to configure
+ * \param receiverID ID of the object
+ * \return 0 on success, -1 with errno set to ENOENT if the receiver was not added
+ */
+int removePODIFanoutReceiver(PODIFanoutType* fanout, const uint32_t receiverID) {
+	bool found;
+	const size_t i = findReceiverIndex(fanout, receiverID, &found);
+
+	if (!found) {
+		errno = ENOENT;
+		return -1;
+	}
+	memmove(&fanout->receivers[i], &fanout->receivers[i + 1],
+			(fanout->nReceivers - i - 1) * sizeof (fanout->receivers[0]));
+	fanout->nReceivers--;
+	return 0;
+}
+
+/*!
+ * \brief updatePODIFanoutPeer Set the latest state of a peer, to be sent on the next tick
+ * \param fanout Engine to update
+ * \param peer State of the peer, identified by its foreign transmitter ID
+ * \return 0 on success, -1 with errno set on failure
+ */
+int updatePODIFanoutPeer(PODIFanoutType* fanout, const PeerObjectInjectionType* peer) {
+	bool found;
+
+	if (peer == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	const size_t i = findPeerIndex(fanout, peer->foreignTransmitterID, &found);
+	if (!found) {
+		char* frame = malloc(fanout->frameSize);
+		if (frame == NULL) {
+			return -1;
+		}
+		FanoutPeerType* peers = realloc(fanout->peers, (fanout->nPeers + 1) * sizeof (*peers));
+		if (peers == NULL) {
+			free(frame);
+			return -1;
+		}
+		fanout->peers = peers;
+		memmove(&peers[i + 1], &peers[i], (fanout->nPeers - i) * sizeof (*peers));
+		fanout->nPeers++;
+		peers[i].frame = frame;
+		peers[i].frameLength = 0;
+	}
+	fanout->peers[i].data = *peer;
+	return 0;
+}
+
+/*!
+ * \brief removePODIFanoutPeer Stop sending PODI messages about a peer
+ * \param fanout Engine to update
+ * \param peerID Foreign transmitter ID of the peer
+ * \return 0 on success, -1 with errno set to ENOENT if the peer was not added
+ */
+int removePODIFanoutPeer(PODIFanoutType* fanout, const uint32_t peerID) {
+	bool found;
+	const size_t i = findPeerIndex(fanout, peerID, &found);
+
+	if (!found) {
+		errno = ENOENT;
+		return -1;
+	}
+	free(fanout->peers[i].frame);
+	memmove(&fanout->peers[i], &fanout->peers[i + 1], (fanout->nPeers - i - 1) * sizeof (fanout->peers[0]));
+	fanout->nPeers--;
+	return 0;
+}
+
+/*!
+ * \brief appendPatchedFrame Copy an encoded message to the end of a datagram and set its receiver ID
+ *			and message counter, updating the CRC from the changed header bytes only
+ * \param fanout Engine holding the CRC patch tables
+ * \param destination Position in the datagram at which to place the message
+ * \param peer Peer whose encoded message is copied
+ * \param receiverID Receiver ID to set
+ * \param messageCounter Message counter to set
+ */
+static void appendPatchedFrame(
+		const PODIFanoutType* fanout,
+		char* destination,
+		const FanoutPeerType* peer,
+		const uint32_t receiverID,
+		const uint8_t messageCounter) {
+	const uint32_t receiverIDLittleEndian = htole32(receiverID);
+	const size_t crcOffset = peer->frameLength - sizeof (FooterType);
+	const uint8_t* patch = (const uint8_t*) destination + PATCH_OFFSET;
+	uint16_t crc;
+
+	memcpy(destination, peer->frame, peer->frameLength);
+	memcpy(destination + offsetof(HeaderType, receiverID), &receiverIDLittleEndian, sizeof (receiverIDLittleEndian));
+	memcpy(destination + offsetof(HeaderType, messageCounter), &messageCounter, sizeof (messageCounter));
+
+	// The template bytes are all zero, so the CRC changes by the sum of the deltas of each new byte
+	memcpy(&crc, destination + crcOffset, sizeof (crc));
+	crc = le16toh(crc);
+	for (size_t i = 0; i < PATCH_LENGTH; ++i) {
+		crc ^= fanout->patchCRCDelta[i][patch[i]];
+	}
+	crc = htole16(crc);
+	memcpy(destination + crcOffset, &crc, sizeof (crc));
+}
+
+/*!
+ * \brief isWithinInterestRadius Check whether a peer is close enough to a receiver to be sent to it
+ * \param receiver Receiver of the message
+ * \param self Peer entry of the receiver itself, NULL if its position is unknown
+ * \param peer Peer about which the message is
+ * \return true if the message should be sent
+ */
+static bool isWithinInterestRadius(
+		const FanoutReceiverType* receiver,
+		const FanoutPeerType* self,
+		const FanoutPeerType* peer) {
+	if (receiver->interestRadius_m <= 0.0 || self == NULL || self->frameLength == 0) {
+		return true;
+	}
+	const double dx = peer->data.position.xCoord_m - self->data.position.xCoord_m;
+	const double dy = peer->data.position.yCoord_m - self->data.position.yCoord_m;
+	return dx * dx + dy * dy <= receiver->interestRadius_m * receiver->interestRadius_m;
+}
+
+/*!
+ * \brief runPODIFanoutTick Send the latest state of every peer to every receiver. Each peer is encoded
+ *			once, after which the receiver ID, message counter and CRC are patched for each receiver.
+ *			Messages for the same receiver are packed into datagrams of at most the maximum size.
+ * \param fanout Engine to run
+ * \param sink Function called with each datagram
+ * \param userData Pointer passed on to the sink
+ * \return Number of messages sent, or -1 if the sink returned a negative value
+ */
+ssize_t runPODIFanoutTick(PODIFanoutType* fanout, PODIFanoutSinkType sink, void* userData) {
+	const MessageHeaderType templateHeader = { fanout->transmitterID, 0, 0 };
+	ssize_t nFrames = 0;
+
+	fanout->statistics.nTicks++;
+	for (size_t i = 0; i < fanout->nPeers; ++i) {
+		FanoutPeerType* peer = &fanout->peers[i];
+		const ssize_t length = encodePODIMessage(&templateHeader, &peer->data, peer->frame, fanout->frameSize, 0);
+		if (length < 0) {
+			peer->frameLength = 0;
+			fanout->statistics.nEncodeErrors++;
+			continue;
+		}
+		peer->frameLength = (size_t) length;
+		fanout->statistics.nPeersEncoded++;
+	}
+
+	for (size_t r = 0; r < fanout->nReceivers; ++r) {
+		FanoutReceiverType* receiver = &fanout->receivers[r];
+		bool found;
+		const size_t selfIndex = findPeerIndex(fanout, receiver->receiverID, &found);
+		const FanoutPeerType* self = found ? &fanout->peers[selfIndex] : NULL;
+		size_t length = 0;
+
+		for (size_t i = 0; i < fanout->nPeers; ++i) {
+			const FanoutPeerType* peer = &fanout->peers[i];
+			if (peer->frameLength == 0 || peer == self) {
+				continue;
+			}
+			if (!isWithinInterestRadius(receiver, self, peer)) {
+				fanout->statistics.nFramesFiltered++;
+				continue;
+			}
+			if (length + peer->frameLength > fanout->maxDatagramSize) {
+				if (sink(receiver->receiverID, fanout->datagram, length, userData) < 0) {
+					return -1;
+				}
+				fanout->statistics.nDatagramsSent++;
+				length = 0;
+			}
+			appendPatchedFrame(fanout, fanout->datagram + length, peer, receiver->receiverID, receiver->messageCounter++);
+			length += peer->frameLength;
+			fanout->statistics.nFramesSent++;
+			nFrames++;
+		}
+		if (length > 0) {
+			if (sink(receiver->receiverID, fanout->datagram, length, userData) < 0) {
+				return -1;
+			}
+			fanout->statistics.nDatagramsSent++;
+		}
+	}
+	return nFrames;
+}
+
+/*!
+ * \brief getPODIFanoutStatistics Get the counters of an engine
+ * \param fanout Engine
+ * \return Counters since the engine was created
+ */
+PODIFanoutStatisticsType getPODIFanoutStatistics(const PODIFanoutType* fanout) {
+	return fanout->statistics;
+}
@@ -0,0 +1,455 @@
+#define _GNU_SOURCE		// recvmmsg and sendmmsg
+#include "relay.h"
+#include "frame.h"
+#include "footer.h"
+#include "isoerror.h"
+
+#include <errno.h>
+#include <endian.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RELAY_REWRITE_INITIAL_CAPACITY 16
+#define HEADER_ID_OFFSET offsetof(HeaderType, transmitterID)
+#define HEADER_ID_LENGTH (sizeof (uint32_t) + sizeof (uint32_t))
+
+typedef struct {
+	RelayRewriteType rewrite;
+	bool isUsed;
+} RelayRewriteEntryType;
+
+typedef struct {
+	int inputSocket;
+	int outputSocket;
+	struct sockaddr_storage destination;
+	socklen_t destinationLength;	//!< Zero if the output socket is connected
+
+	RelayRewriteEntryType* exactRewrites;	//!< Open addressing table, capacity is a power of two
+	size_t exactCapacity;
+	size_t nExactRewrites;
+	RelayRewriteType* partialRewrites;		//!< Rules matching one or no ID, in order of precedence
+	size_t nPartialRewrites;
+
+	RelayStatisticsType statistics;
+} RelayRouteType;
+
+struct ISORelay {
+	size_t maxDatagramSize;
+	RelayRouteType* routes;
+	size_t nRoutes;
+
+	char* buffers;					//!< One datagram buffer per batch entry
+	struct iovec iov[ISO_RELAY_BATCH_SIZE];
+	struct mmsghdr received[ISO_RELAY_BATCH_SIZE];
+	struct mmsghdr sent[ISO_RELAY_BATCH_SIZE];
+};
+
+/*!
+ * \brief createISORelay Create a relay without routes
+ * \param maxDatagramSize Largest datagram to be relayed, or 0 for ::ISO_RELAY_DEFAULT_DATAGRAM_SIZE
+ * \return Allocated relay, or NULL with errno set on failure
+ */
+ISORelayType* createISORelay(const size_t maxDatagramSize) {
+	ISORelayType* relay = calloc(1, sizeof (*relay));
+	if (relay == NULL) {
+		return NULL;
+	}
+	relay->maxDatagramSize = maxDatagramSize ? maxDatagramSize : ISO_RELAY_DEFAULT_DATAGRAM_SIZE;
+	relay->buffers = malloc(ISO_RELAY_BATCH_SIZE * relay->maxDatagramSize);
+	if (relay->buffers == NULL) {
+		free(relay);
+		return NULL;
+	}
+	for (size_t i = 0; i < ISO_RELAY_BATCH_SIZE; ++i) {
+		relay->iov[i].iov_base = relay->buffers + i * relay->maxDatagramSize;
+		relay->received[i].msg_hdr.msg_iov = &relay->iov[i];
+		relay->received[i].msg_hdr.msg_iovlen = 1;
+	}
+	return relay;
+}
+
+/*!
+ * \brief freeISORelay Free a relay created with ::createISORelay. Sockets are not closed.
+ * \param relay Relay to free, may be NULL
+ */
+void freeISORelay(ISORelayType* relay) {
+	if (relay == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < relay->nRoutes; ++i) {
+		free(relay->routes[i].exactRewrites);
+		free(relay->routes[i].partialRewrites);
+	}
+	free(relay->routes);
+	free(relay->buffers);
+	free(relay);
+}
+
+/*!
+ * \brief addRelayRoute Add a route forwarding datagrams from one socket to another. Each input socket
+ *			should only be used by one route.
+ * \param relay Relay to configure
+ * \param inputSocket Datagram socket from which frames are received
+ * \param outputSocket Datagram socket on which frames are sent
+ * \param destination Address to which frames are sent, or NULL if the output socket is connected
+ * \param destinationLength Length of the destination address
+ * \return Index of the route, or -1 with errno set on failure
+ */
+int addRelayRoute(
+		ISORelayType* relay,
+		const int inputSocket,
+		const int outputSocket,
+		const struct sockaddr* destination,
+		const socklen_t destinationLength) {
+	if (inputSocket < 0 || outputSocket < 0
+			|| (destination != NULL && destinationLength > sizeof (struct sockaddr_storage))) {
+		errno = EINVAL;
+		return -1;
+	}
+	RelayRouteType* routes = realloc(relay->routes, (relay->nRoutes + 1) * sizeof (*routes));
+	if (routes == NULL) {
+		return -1;
+	}
+	relay->routes = routes;
+
+	RelayRouteType* route = &routes[relay->nRoutes];
+	memset(route, 0, sizeof (*route));
+	route->inputSocket = inputSocket;
+	route->outputSocket = outputSocket;
+	if (destination != NULL) {
+		memcpy(&route->destination, destination, destinationLength);
+		route->destinationLength = destinationLength;
+	}
+	return (int) relay->nRoutes++;
+}
+
+/*!
+ * \brief hashRelayIDs Hash a transmitter and receiver ID pair for the exact match table
+ */
+static size_t hashRelayIDs(const uint32_t transmitterID, const uint32_t receiverID) {
+	return (size_t) (transmitterID * 0x9E3779B1u) ^ (size_t) (receiverID * 0x85EBCA77u);
+}
+
+/*!
+ * \brief insertExactRewrite Insert a rewrite matching both IDs, replacing any with the same IDs
+ * \param route Route to which the rewrite is added
+ * \param rewrite Rewrite to insert
+ * \return 0 on success, -1 with errno set on failure
+ */
+static int insertExactRewrite(RelayRouteType* route, const RelayRewriteType* rewrite) {
+	if (2 * (route->nExactRewrites + 1) > route->exactCapacity) {
+		const size_t newCapacity = route->exactCapacity ? 2 * route->exactCapacity : RELAY_REWRITE_INITIAL_CAPACITY;
+		RelayRewriteEntryType* newEntries = calloc(newCapacity, sizeof (*newEntries));
+		if (newEntries == NULL) {
+			return -1;
+		}
+		for (size_t i = 0; i < route->exactCapacity; ++i) {
+			if (route->exactRewrites[i].isUsed) {
+				const RelayRewriteType* moved = &route->exactRewrites[i].rewrite;
+				size_t j = hashRelayIDs(moved->transmitterID, moved->receiverID) & (newCapacity - 1);
+				while (newEntries[j].isUsed) {
+					j = (j + 1) & (newCapacity - 1);
+				}
+				newEntries[j] = route->exactRewrites[i];
+			}
+		}
+		free(route->exactRewrites);
+		route->exactRewrites = newEntries;
+		route->exactCapacity = newCapacity;
+	}
+
+	const size_t mask = route->exactCapacity - 1;
+	size_t i = hashRelayIDs(rewrite->transmitterID, rewrite->receiverID) & mask;
+	while (route->exactRewrites[i].isUsed
+		   && (route->exactRewrites[i].rewrite.transmitterID != rewrite->transmitterID
+			   || route->exactRewrites[i].rewrite.receiverID != rewrite->receiverID)) {
+		i = (i + 1) & mask;
+	}
+	if (!route->exactRewrites[i].isUsed) {
+		route->exactRewrites[i].isUsed = true;
+		route->nExactRewrites++;
+	}
+	route->exactRewrites[i].rewrite = *rewrite;
+	return 0;
+}
+
+/*!
+ * \brief addRelayRewrite Add a rule rewriting IDs of frames forwarded on a route
+ * \param relay Relay to configure
+ * \param route Index of the route, as returned by ::addRelayRoute
+ * \param rewrite Rule to add
+ * \return 0 on success, -1 with errno set on failure
+ */
+int addRelayRewrite(ISORelayType* relay, const int route, const RelayRewriteType* rewrite) {
+	const uint8_t AllFields = RELAY_FIELD_TRANSMITTER_ID | RELAY_FIELD_RECEIVER_ID;
+
+	if (route < 0 || (size_t) route >= relay->nRoutes || rewrite == NULL
+			|| (rewrite->matchedFields & ~AllFields) || (rewrite->rewrittenFields & ~AllFields)) {
+		errno = EINVAL;
+		return -1;
+	}
+	RelayRouteType* r = &relay->routes[route];
+	if (rewrite->matchedFields == AllFields) {
+		return insertExactRewrite(r, rewrite);
+	}
+	RelayRewriteType* rewrites = realloc(r->partialRewrites, (r->nPartialRewrites + 1) * sizeof (*rewrites));
+	if (rewrites == NULL) {
+		return -1;
+	}
+	rewrites[r->nPartialRewrites++] = *rewrite;
+	r->partialRewrites = rewrites;
+	return 0;
+}
+
+/*!
+ * \brief findRewrite Find the rewrite applying to a frame
+ * \param route Route on which the frame is forwarded
+ * \param transmitterID Transmitter ID of the frame
+ * \param receiverID Receiver ID of the frame
+ * \return The rewrite, or NULL if the frame is forwarded unchanged
+ */
+static const RelayRewriteType* findRewrite(
+		const RelayRouteType* route,
+		const uint32_t transmitterID,
+		const uint32_t receiverID) {
+	if (route->nExactRewrites > 0) {
+		const size_t mask = route->exactCapacity - 1;
+		for (size_t i = hashRelayIDs(transmitterID, receiverID) & mask; route->exactRewrites[i].isUsed;
+			 i = (i + 1) & mask) {
+			const RelayRewriteType* rewrite = &route->exactRewrites[i].rewrite;
+			if (rewrite->transmitterID == transmitterID && rewrite->receiverID == receiverID) {
+				return rewrite;
+			}
+		}
+	}
+	for (size_t i = 0; i < route->nPartialRewrites; ++i) {
+		const RelayRewriteType* rewrite = &route->partialRewrites[i];
+		if ((!(rewrite->matchedFields & RELAY_FIELD_TRANSMITTER_ID) || rewrite->transmitterID == transmitterID)
+				&& (!(rewrite->matchedFields & RELAY_FIELD_RECEIVER_ID) || rewrite->receiverID == receiverID)) {
+			return rewrite;
+		}
+	}
+	return NULL;
+}
+
+/*!
+ * \brief rewriteISOFrameIDs Replace the transmitter and/or receiver ID of an encoded message in place.
+ *			The CRC is updated from the changed header bytes only, so the contents are not read and
+ *			a message which was corrupted before the rewrite still fails CRC verification after it.
+ * \param frame Encoded message
+ * \param length Size of the message including header and footer
+ * \param rewrittenFields Bitwise OR of ::RelayFieldType selecting the IDs to replace
+ * \param transmitterID New transmitter ID
+ * \param receiverID New receiver ID
+ * \return The message size, or -1 if the message is too short
+ */
+ssize_t rewriteISOFrameIDs(
+		char* frame,
+		const size_t length,
+		const uint8_t rewrittenFields,
+		const uint32_t transmitterID,
+		const uint32_t receiverID) {
+	uint8_t oldIDs[HEADER_ID_LENGTH];
+	uint32_t newID;
+	uint16_t crc;
+
+	if (frame == NULL || length < sizeof (HeaderType) + sizeof (FooterType)) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_INVALID, 0, "Frame too short to rewrite");
+		return -1;
+	}
+	memcpy(oldIDs, frame + HEADER_ID_OFFSET, sizeof (oldIDs));
+	if (rewrittenFields & RELAY_FIELD_TRANSMITTER_ID) {
+		newID = htole32(transmitterID);
+		memcpy(frame + offsetof(HeaderType, transmitterID), &newID, sizeof (newID));
+	}
+	if (rewrittenFields & RELAY_FIELD_RECEIVER_ID) {
+		newID = htole32(receiverID);
+		memcpy(frame + offsetof(HeaderType, receiverID), &newID, sizeof (newID));
+	}
+
+	// A zero CRC means that the message carries no checksum
+	memcpy(&crc, frame + length - sizeof (FooterType), sizeof (crc));
+	crc = le16toh(crc);
+	if (crc != 0) {
+		crc = crc16Patch(crc, oldIDs, (const uint8_t*) frame + HEADER_ID_OFFSET, HEADER_ID_LENGTH,
+						 length - sizeof (FooterType) - HEADER_ID_OFFSET - HEADER_ID_LENGTH);
+		crc = htole16(crc);
+		memcpy(frame + length - sizeof (FooterType), &crc, sizeof (crc));
+	}
+	return (ssize_t) length;
+}
+
+/*!
+ * \brief relayISOFrames Apply the rewrites of a route to all frames in a datagram, in place.
+ *			Only headers are checked, so CRC errors are passed on to the receiver.
+ * \param relay Relay holding the route
+ * \param route Index of the route
+ * \param datagram Received datagram containing one or more frames
+ * \param length Size of the datagram
+ * \param statistics Statistics to update, may be NULL
+ * \return Number of bytes to forward, which excludes any malformed frame and data following it,
+ *			or -1 with errno set if the route does not exist
+ */
+ssize_t relayISOFrames(
+		const ISORelayType* relay,
+		const int route,
+		char* datagram,
+		const size_t length,
+		RelayStatisticsType* statistics) {
+	RelayStatisticsType discarded;
+	HeaderType header;
+	size_t offset = 0;
+
+	if (route < 0 || (size_t) route >= relay->nRoutes) {
+		errno = EINVAL;
+		return -1;
+	}
+	statistics = statistics != NULL ? statistics : &discarded;
+
+	while (offset < length) {
+		const ssize_t frameLength = validateISOFrameHeader(datagram + offset, length - offset, &header);
+		if (frameLength < 0) {
+			statistics->nMalformedFrames++;
+			break;
+		}
+		const RelayRewriteType* rewrite = findRewrite(&relay->routes[route], header.transmitterID,
+													  header.receiverID);
+		if (rewrite != NULL && rewrite->rewrittenFields) {
+			rewriteISOFrameIDs(datagram + offset, (size_t) frameLength, rewrite->rewrittenFields,
+							   rewrite->newTransmitterID, rewrite->newReceiverID);
+			statistics->nFramesRewritten++;
+		}
+		statistics->nFramesForwarded++;
+		offset += (size_t) frameLength;
+	}
+	return (ssize_t) offset;
+}
+
+/*!
+ * \brief forwardRelayRoute Receive the datagrams waiting on the input socket of a route, up to
+ *			::ISO_RELAY_BATCH_SIZE, rewrite them and send them on the output socket. Datagrams are
+ *			received and sent in one system call each where possible.
+ * \param relay Relay holding the route
+ * \param route Index of the route
+ * \return Number of datagrams forwarded, or -1 with errno set if receiving failed
+ */
+ssize_t forwardRelayRoute(ISORelayType* relay, const int route) {
+	if (route < 0 || (size_t) route >= relay->nRoutes) {
+		errno = EINVAL;
+		return -1;
+	}
+	RelayRouteType* r = &relay->routes[route];
+
+	for (size_t i = 0; i < ISO_RELAY_BATCH_SIZE; ++i) {
+		relay->iov[i].iov_len = relay->maxDatagramSize;
+		relay->received[i].msg_hdr.msg_name = NULL;
+		relay->received[i].msg_hdr.msg_namelen = 0;
+		relay->received[i].msg_hdr.msg_control = NULL;
+		relay->received[i].msg_hdr.msg_controllen = 0;
+		relay->received[i].msg_hdr.msg_flags = 0;
+	}
+	const int nReceived = recvmmsg(r->inputSocket, relay->received, ISO_RELAY_BATCH_SIZE, MSG_DONTWAIT, NULL);
+	if (nReceived < 0) {
+		return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+	}
+	r->statistics.nDatagramsReceived += (uint64_t) nReceived;
+
+	unsigned int nToSend = 0;
+	for (int i = 0; i < nReceived; ++i) {
+		if (relay->received[i].msg_hdr.msg_flags & MSG_TRUNC) {
+			r->statistics.nTruncatedDatagrams++;
+			continue;
+		}
+		const ssize_t length = relayISOFrames(relay, route, relay->iov[i].iov_base, relay->received[i].msg_len,
+											  &r->statistics);
+		if (length <= 0) {
+			continue;
+		}
+		// Received entries are not reused before sending, so the iovec can be shared
+		relay->iov[i].iov_len = (size_t) length;
+		memset(&relay->sent[nToSend], 0, sizeof (relay->sent[nToSend]));
+		relay->sent[nToSend].msg_hdr.msg_iov = &relay->iov[i];
+		relay->sent[nToSend].msg_hdr.msg_iovlen = 1;
+		if (r->destinationLength > 0) {
+			relay->sent[nToSend].msg_hdr.msg_name = &r->destination;
+			relay->sent[nToSend].msg_hdr.msg_namelen = r->destinationLength;
+		}
+		nToSend++;
+	}
+
+	unsigned int nSent = 0;
+	ssize_t nForwarded = 0;
+	while (nSent < nToSend) {
+		const int n = sendmmsg(r->outputSocket, relay->sent + nSent, nToSend - nSent, 0);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			// Skip the datagram which could not be sent and try the rest
+			r->statistics.nSendErrors++;
+			nSent++;
+			continue;
+		}
+		nSent += (unsigned int) n;
+		nForwarded += n;
+	}
+	r->statistics.nDatagramsForwarded += (uint64_t) nForwarded;
+	return nForwarded;
+}
+
+/*!
+ * \brief runISORelay Forward frames on all routes until stopped
+ * \param relay Relay to run
+ * \param stop Flag which stops the relay when set, e.g. from a signal handler
+ * \param pollInterval_ms Longest time between checks of the stop flag
+ * \return 0 when stopped, or -1 with errno set on failure
+ */
+int runISORelay(ISORelayType* relay, const volatile sig_atomic_t* stop, const int pollInterval_ms) {
+	struct pollfd* fds = calloc(relay->nRoutes ? relay->nRoutes : 1, sizeof (*fds));
+	int retval = 0;
+
+	if (fds == NULL) {
+		return -1;
+	}
+	for (size_t i = 0; i < relay->nRoutes; ++i) {
+		fds[i].fd = relay->routes[i].inputSocket;
+		fds[i].events = POLLIN;
+	}
+	while (!*stop) {
+		const int nReady = poll(fds, relay->nRoutes, pollInterval_ms);
+		if (nReady < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			retval = -1;
+			break;
+		}
+		for (size_t i = 0; i < relay->nRoutes && nReady > 0; ++i) {
+			if ((fds[i].revents & POLLIN) && forwardRelayRoute(relay, (int) i) < 0) {
+				retval = -1;
+				break;
+			}
+		}
+		if (retval < 0) {
+			break;
+		}
+	}
+	free(fds);
+	return retval;
+}
+
+/*!
+ * \brief getRelayStatistics Get the forwarding statistics of a route
+ * \param relay Relay holding the route
+ * \param route Index of the route
+ * \return Statistics of the route, all zero if it does not exist
+ */
+RelayStatisticsType getRelayStatistics(const ISORelayType* relay, const int route) {
+	RelayStatisticsType statistics;
+	if (route < 0 || (size_t) route >= relay->nRoutes) {
+		memset(&statistics, 0, sizeof (statistics));
+		return statistics;
+	}
+	return relay->routes[route].statistics;
+}
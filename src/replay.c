@@ -0,0 +1,491 @@
+#include "replay.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "header.h"
+#include "footer.h"
+#include "iso22133.h"
+#include "linkhealth.h"
+#include "monr.h"
+#include "timeconversions.h"
+#include "defines.h"
+
+#define NANOSECONDS_PER_SECOND 1000000000LL
+#define NANOSECONDS_PER_MICROSECOND 1000LL
+#define WEEK_TIME_NS ((int64_t) WEEK_TIME_QMS * 250000LL)
+
+// Position of the timestamp common to MONR and HEAB, directly after the header and the struct value ID
+#define HEADER_MESSAGE_ID_OFFSET 16
+#define STRUCT_VALUE_ID_OFFSET (sizeof (HeaderType))
+#define STRUCT_QMS_OF_WEEK_OFFSET (sizeof (HeaderType) + 4)
+#define HEAB_STRUCT_VALUE_ID 0x0090
+
+typedef struct {
+	double speedFactor;
+	int64_t sourceOrigin_ns;		//!< Original time of the first message
+	int64_t targetOrigin_ns;		//!< Rewritten time of the first message, since the Unix epoch
+	struct timespec monotonicOrigin;
+	bool isStarted;
+	int64_t lastDeadline_ns;		//!< Relative to the monotonic origin
+	int64_t lastSent_ns;
+	double latenessSum_ns;
+	uint64_t nPacedFrames;
+	QuantileEstimatorType medianLateness;
+	QuantileEstimatorType p99Lateness;
+	ReplayStatisticsType* statistics;
+} ReplayScheduleType;
+
+/*! Position in the blocks of one object while merging a recording */
+typedef struct {
+	uint32_t transmitterID;
+	uint8_t messageCounter;
+	size_t nextBlock;
+	size_t endBlock;
+	MonitorSampleType* samples;
+	size_t nSamples;
+	size_t nextSample;
+	int64_t time_ns;				//!< Time of the next sample, or of the last valid one if it has none
+	bool isTimeKnown;				//!< A sample with a valid timestamp has been reached
+} ReplayObjectCursorType;
+
+static int initReplaySchedule(ReplayScheduleType* schedule, const ReplayConfigType* config,
+							  ReplayStatisticsType* statistics);
+static void waitForDeadline(ReplayScheduleType* schedule, const int64_t source_ns);
+static void finishReplaySchedule(ReplayScheduleType* schedule);
+static int64_t mapToTargetTime(const ReplayScheduleType* schedule, const int64_t source_ns);
+static bool rewriteFrameTimestamp(uint8_t* frame, const size_t length, const int64_t captureTime_ns,
+								  const ReplayScheduleType* schedule);
+static int advanceObjectCursor(const MonitorRecordingType* recording, ReplayObjectCursorType* cursor);
+static int64_t getElapsedTime(const struct timespec* origin);
+static int64_t timevalToNanoseconds(const struct timeval* time);
+static struct timeval nanosecondsToTimeval(const int64_t time_ns);
+
+
+/*!
+ * \brief replayCapture Sends the ISO messages of a capture to a sink, paced according to their capture
+ *			times. Deadlines are absolute, so that time spent in the sink or oversleeping does not
+ *			accumulate over the replay.
+ * \param capture Capture to be replayed
+ * \param config Replay configuration
+ * \param sink Function to which each message is passed
+ * \param userData Passed on to the sink
+ * \param statistics Schedule adherence of the replay, may be NULL
+ * \return 0 on success, -1 with errno set otherwise, or as left by the sink if it failed
+ */
+int replayCapture(
+		const CaptureType* capture,
+		const ReplayConfigType* config,
+		ReplaySinkType sink,
+		void* userData,
+		ReplayStatisticsType* statistics) {
+
+	ReplayStatisticsType localStatistics;
+	ReplayScheduleType schedule;
+	CaptureFrameIteratorType* iterator;
+	CaptureFrameType frame;
+	uint8_t* scratch = NULL;
+	size_t scratchCapacity = 0;
+	int result, error = 0;
+
+	if (capture == NULL || config == NULL || sink == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (initReplaySchedule(&schedule, config, statistics ? statistics : &localStatistics) < 0) {
+		return -1;
+	}
+	if ((iterator = createCaptureFrameIterator(capture)) == NULL) {
+		return -1;
+	}
+
+	while ((result = getNextCaptureFrame(iterator, &frame)) > 0) {
+		const uint8_t* data = frame.data;
+
+		if (!schedule.isStarted) {
+			schedule.sourceOrigin_ns = frame.time_ns;
+		}
+		if (config->isTimestampRewritten) {
+			if (frame.length > scratchCapacity) {
+				size_t newCapacity = scratchCapacity ? scratchCapacity : 1024;
+				uint8_t* newScratch;
+
+				while (newCapacity < frame.length) {
+					newCapacity *= 2;
+				}
+				if ((newScratch = realloc(scratch, newCapacity)) == NULL) {
+					error = ENOMEM;
+					break;
+				}
+				scratch = newScratch;
+				scratchCapacity = newCapacity;
+			}
+			memcpy(scratch, frame.data, frame.length);
+			if (rewriteFrameTimestamp(scratch, frame.length, frame.time_ns, &schedule)) {
+				schedule.statistics->nRewritten++;
+				data = scratch;
+			}
+		}
+
+		waitForDeadline(&schedule, frame.time_ns);
+		if (sink((const char*) data, frame.length, userData) < 0) {
+			error = errno != 0 ? errno : EIO;
+			break;
+		}
+		schedule.statistics->nFrames++;
+	}
+	if (result < 0) {
+		error = errno;
+	}
+
+	finishReplaySchedule(&schedule);
+	freeCaptureFrameIterator(iterator);
+	free(scratch);
+	if (error != 0) {
+		errno = error;
+		return -1;
+	}
+	return 0;
+}
+
+/*!
+ * \brief replayMonitorRecording Encodes the samples of a recording as MONR messages and sends them to
+ *			a sink in time order across all objects, paced according to their timestamps. Samples
+ *			without a valid timestamp are sent directly after the preceding sample of their object.
+ * \param recording Recording to be replayed
+ * \param config Replay configuration
+ * \param sink Function to which each message is passed
+ * \param userData Passed on to the sink
+ * \param statistics Schedule adherence of the replay, may be NULL
+ * \return 0 on success, -1 with errno set otherwise, or as left by the sink if it failed
+ */
+int replayMonitorRecording(
+		const MonitorRecordingType* recording,
+		const ReplayConfigType* config,
+		ReplaySinkType sink,
+		void* userData,
+		ReplayStatisticsType* statistics) {
+
+	ReplayStatisticsType localStatistics;
+	ReplayScheduleType schedule;
+	ReplayObjectCursorType* cursors;
+	size_t nCursors = 0, maxBlockSamples = 0;
+	char buffer[sizeof (MONRType)];
+	int error = 0;
+
+	if (recording == NULL || config == NULL || sink == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (initReplaySchedule(&schedule, config, statistics ? statistics : &localStatistics) < 0) {
+		return -1;
+	}
+	if ((cursors = calloc(recording->nBlocks ? recording->nBlocks : 1, sizeof (*cursors))) == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	// Blocks are sorted on transmitter, so each object covers a contiguous range
+	for (size_t b = 0; b < recording->nBlocks; ++b) {
+		if (nCursors == 0 || cursors[nCursors - 1].transmitterID != recording->blocks[b].transmitterID) {
+			cursors[nCursors].transmitterID = recording->blocks[b].transmitterID;
+			cursors[nCursors].nextBlock = b;
+			nCursors++;
+		}
+		cursors[nCursors - 1].endBlock = b + 1;
+		if (recording->blocks[b].nSamples > maxBlockSamples) {
+			maxBlockSamples = recording->blocks[b].nSamples;
+		}
+	}
+	for (size_t c = 0; c < nCursors && error == 0; ++c) {
+		if ((cursors[c].samples = malloc(maxBlockSamples * sizeof (MonitorSampleType))) == NULL) {
+			error = ENOMEM;
+		}
+		else if (advanceObjectCursor(recording, &cursors[c]) < 0) {
+			error = errno;
+		}
+	}
+
+	while (error == 0) {
+		ReplayObjectCursorType* next = NULL;
+		MonitorSampleType sample;
+		MessageHeaderType header;
+		ssize_t length;
+
+		for (size_t c = 0; c < nCursors; ++c) {
+			if (cursors[c].nextSample < cursors[c].nSamples && (next == NULL || cursors[c].time_ns < next->time_ns)) {
+				next = &cursors[c];
+			}
+		}
+		if (next == NULL) {
+			break;
+		}
+
+		sample = next->samples[next->nextSample];
+		if (!schedule.isStarted) {
+			schedule.sourceOrigin_ns = next->time_ns;
+		}
+		if (config->isTimestampRewritten && sample.isTimestampValid) {
+			const struct timeval targetTime = nanosecondsToTimeval(mapToTargetTime(&schedule, next->time_ns));
+
+			sample.gpsWeek = (uint16_t) getAsGPSWeek(&targetTime);
+			sample.gpsQmsOfWeek = (uint32_t) getAsGPSQuarterMillisecondOfWeek(&targetTime);
+			schedule.statistics->nRewritten++;
+		}
+
+		header.transmitterID = next->transmitterID;
+		header.receiverID = config->receiverID;
+		header.messageCounter = next->messageCounter++;
+		if ((length = encodeMONRMessageFromSample(&header, &sample, buffer, sizeof (buffer), 0)) < 0) {
+			error = EINVAL;
+			break;
+		}
+
+		waitForDeadline(&schedule, next->time_ns);
+		if (sink(buffer, (size_t) length, userData) < 0) {
+			error = errno != 0 ? errno : EIO;
+			break;
+		}
+		schedule.statistics->nFrames++;
+
+		next->nextSample++;
+		if (advanceObjectCursor(recording, next) < 0) {
+			error = errno;
+		}
+	}
+
+	finishReplaySchedule(&schedule);
+	for (size_t c = 0; c < nCursors; ++c) {
+		free(cursors[c].samples);
+	}
+	free(cursors);
+	if (error != 0) {
+		errno = error;
+		return -1;
+	}
+	return 0;
+}
+
+
+static int initReplaySchedule(
+		ReplayScheduleType* schedule,
+		const ReplayConfigType* config,
+		ReplayStatisticsType* statistics) {
+
+	struct timeval startTime = config->startTime;
+
+	if (!(config->speedFactor >= 0.0)) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (startTime.tv_sec == 0 && startTime.tv_usec == 0) {
+		gettimeofday(&startTime, NULL);
+	}
+	memset(schedule, 0, sizeof (*schedule));
+	memset(statistics, 0, sizeof (*statistics));
+	schedule->speedFactor = config->speedFactor;
+	schedule->targetOrigin_ns = timevalToNanoseconds(&startTime);
+	schedule->statistics = statistics;
+	initQuantileEstimator(&schedule->medianLateness, 0.5);
+	initQuantileEstimator(&schedule->p99Lateness, 0.99);
+	return 0;
+}
+
+/*!
+ * \brief waitForDeadline Sleeps until the time at which a message is to be sent, and records how late
+ *			it is. The first call starts the schedule.
+ * \param schedule Schedule of the replay
+ * \param source_ns Original time of the message
+ */
+static void waitForDeadline(
+		ReplayScheduleType* schedule,
+		const int64_t source_ns) {
+
+	int64_t deadline_ns, lateness_ns;
+	struct timespec deadline;
+
+	if (!schedule->isStarted) {
+		clock_gettime(CLOCK_MONOTONIC, &schedule->monotonicOrigin);
+		schedule->isStarted = true;
+	}
+	if (schedule->speedFactor <= 0.0) {
+		schedule->lastSent_ns = getElapsedTime(&schedule->monotonicOrigin);
+		return;
+	}
+
+	deadline_ns = (int64_t) ((double) (source_ns - schedule->sourceOrigin_ns) / schedule->speedFactor);
+	deadline.tv_sec = schedule->monotonicOrigin.tv_sec + (time_t) (deadline_ns / NANOSECONDS_PER_SECOND);
+	deadline.tv_nsec = schedule->monotonicOrigin.tv_nsec + (long) (deadline_ns % NANOSECONDS_PER_SECOND);
+	if (deadline.tv_nsec >= NANOSECONDS_PER_SECOND) {
+		deadline.tv_sec++;
+		deadline.tv_nsec -= NANOSECONDS_PER_SECOND;
+	}
+	else if (deadline.tv_nsec < 0) {
+		deadline.tv_sec--;
+		deadline.tv_nsec += NANOSECONDS_PER_SECOND;
+	}
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR);
+
+	schedule->lastSent_ns = getElapsedTime(&schedule->monotonicOrigin);
+	schedule->lastDeadline_ns = deadline_ns;
+	lateness_ns = schedule->lastSent_ns - deadline_ns;
+	if (schedule->nPacedFrames == 0 || lateness_ns > schedule->statistics->maxLateness_ns) {
+		schedule->statistics->maxLateness_ns = lateness_ns;
+	}
+	schedule->latenessSum_ns += (double) lateness_ns;
+	schedule->nPacedFrames++;
+	updateQuantileEstimator(&schedule->medianLateness, (double) lateness_ns);
+	updateQuantileEstimator(&schedule->p99Lateness, (double) lateness_ns);
+	schedule->statistics->drift_ns = lateness_ns;
+}
+
+static void finishReplaySchedule(ReplayScheduleType* schedule) {
+	ReplayStatisticsType* statistics = schedule->statistics;
+
+	statistics->elapsed_ns = schedule->lastSent_ns;
+	statistics->scheduledDuration_ns = schedule->lastDeadline_ns;
+	if (schedule->nPacedFrames > 0) {
+		statistics->meanLateness_ns = schedule->latenessSum_ns / (double) schedule->nPacedFrames;
+		statistics->medianLateness_ns = getQuantileEstimate(&schedule->medianLateness);
+		statistics->p99Lateness_ns = getQuantileEstimate(&schedule->p99Lateness);
+	}
+}
+
+/*!
+ * \brief mapToTargetTime Maps an original message time onto the rewritten timeline, compressed by the
+ *			speed factor. When replaying as fast as possible the original spacing is kept.
+ */
+static int64_t mapToTargetTime(
+		const ReplayScheduleType* schedule,
+		const int64_t source_ns) {
+
+	const double speedFactor = schedule->speedFactor > 0.0 ? schedule->speedFactor : 1.0;
+
+	return schedule->targetOrigin_ns + (int64_t) ((double) (source_ns - schedule->sourceOrigin_ns) / speedFactor);
+}
+
+/*!
+ * \brief rewriteFrameTimestamp Moves the timestamp of a MONR or HEAB message onto the rewritten
+ *			timeline. The GPS week, which is not part of the message, is taken from the capture time.
+ *			The CRC is recomputed unless the sender did not use one.
+ * \param frame Complete message, modified in place
+ * \param length Length of the message
+ * \param captureTime_ns Capture time of the message
+ * \param schedule Schedule of the replay
+ * \return true if the timestamp was rewritten, false if the message has no valid timestamp
+ */
+static bool rewriteFrameTimestamp(
+		uint8_t* frame,
+		const size_t length,
+		const int64_t captureTime_ns,
+		const ReplayScheduleType* schedule) {
+
+	struct timeval captureTime = nanosecondsToTimeval(captureTime_ns), messageTime, targetTime;
+	uint16_t messageID, valueID, crc;
+	uint32_t qmsOfWeek;
+	int64_t message_ns, newQmsOfWeek;
+	int32_t week;
+
+	if (length < STRUCT_QMS_OF_WEEK_OFFSET + sizeof (uint32_t) + sizeof (FooterType)) {
+		return false;
+	}
+	messageID = (uint16_t) (frame[HEADER_MESSAGE_ID_OFFSET] | frame[HEADER_MESSAGE_ID_OFFSET + 1] << 8);
+	valueID = (uint16_t) (frame[STRUCT_VALUE_ID_OFFSET] | frame[STRUCT_VALUE_ID_OFFSET + 1] << 8);
+	if (!(messageID == MESSAGE_ID_MONR && valueID == VALUE_ID_MONR_STRUCT)
+		&& !(messageID == MESSAGE_ID_HEAB && valueID == HEAB_STRUCT_VALUE_ID)) {
+		return false;
+	}
+	qmsOfWeek = (uint32_t) frame[STRUCT_QMS_OF_WEEK_OFFSET] | (uint32_t) frame[STRUCT_QMS_OF_WEEK_OFFSET + 1] << 8
+			| (uint32_t) frame[STRUCT_QMS_OF_WEEK_OFFSET + 2] << 16
+			| (uint32_t) frame[STRUCT_QMS_OF_WEEK_OFFSET + 3] << 24;
+	if (qmsOfWeek == GPS_SECOND_OF_WEEK_UNAVAILABLE_VALUE || qmsOfWeek >= WEEK_TIME_QMS
+		|| (week = getAsGPSWeek(&captureTime)) < 0) {
+		return false;
+	}
+
+	// Sender and capture clocks may straddle a week boundary
+	setToGPStime(&messageTime, (uint16_t) week, qmsOfWeek);
+	message_ns = timevalToNanoseconds(&messageTime);
+	if (message_ns - captureTime_ns > WEEK_TIME_NS / 2) {
+		message_ns -= WEEK_TIME_NS;
+	}
+	else if (captureTime_ns - message_ns > WEEK_TIME_NS / 2) {
+		message_ns += WEEK_TIME_NS;
+	}
+
+	targetTime = nanosecondsToTimeval(mapToTargetTime(schedule, message_ns));
+	if ((newQmsOfWeek = getAsGPSQuarterMillisecondOfWeek(&targetTime)) < 0) {
+		return false;
+	}
+	for (int i = 0; i < 4; ++i) {
+		frame[STRUCT_QMS_OF_WEEK_OFFSET + i] = (uint8_t) (newQmsOfWeek >> (8 * i));
+	}
+
+	crc = (uint16_t) (frame[length - 2] | frame[length - 1] << 8);
+	if (crc != 0) {
+		crc = crc16(frame, length - sizeof (FooterType));
+		frame[length - 2] = (uint8_t) crc;
+		frame[length - 1] = (uint8_t) (crc >> 8);
+	}
+	return true;
+}
+
+/*!
+ * \brief advanceObjectCursor Decodes the next block of an object once its current block has been sent,
+ *			and updates the time of its next sample. Samples without a valid timestamp keep the time of
+ *			the previous one, and are skipped until the object has had a valid timestamp.
+ * \return 0 on success, -1 with errno set otherwise
+ */
+static int advanceObjectCursor(
+		const MonitorRecordingType* recording,
+		ReplayObjectCursorType* cursor) {
+
+	struct timeval time;
+
+	for (;;) {
+		while (cursor->nextSample >= cursor->nSamples) {
+			ssize_t nSamples;
+
+			if (cursor->nextBlock >= cursor->endBlock) {
+				return 0;
+			}
+			nSamples = decodeMonitorRecordingBlock(recording, cursor->nextBlock,
+												   cursor->samples, recording->blocks[cursor->nextBlock].nSamples);
+			if (nSamples < 0) {
+				return -1;
+			}
+			cursor->nextBlock++;
+			cursor->nSamples = (size_t) nSamples;
+			cursor->nextSample = 0;
+		}
+		if (getMonitorSampleTimestamp(&cursor->samples[cursor->nextSample], &time) == 0) {
+			cursor->time_ns = timevalToNanoseconds(&time);
+			cursor->isTimeKnown = true;
+			return 0;
+		}
+		if (cursor->isTimeKnown) {
+			return 0;
+		}
+		cursor->nextSample++;
+	}
+}
+
+static int64_t getElapsedTime(const struct timespec* origin) {
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (int64_t) (now.tv_sec - origin->tv_sec) * NANOSECONDS_PER_SECOND + (now.tv_nsec - origin->tv_nsec);
+}
+
+static int64_t timevalToNanoseconds(const struct timeval* time) {
+	return (int64_t) time->tv_sec * NANOSECONDS_PER_SECOND + (int64_t) time->tv_usec * NANOSECONDS_PER_MICROSECOND;
+}
+
+static struct timeval nanosecondsToTimeval(const int64_t time_ns) {
+	struct timeval time;
+
+	time.tv_sec = (time_t) (time_ns / NANOSECONDS_PER_SECOND);
+	time.tv_usec = (suseconds_t) ((time_ns % NANOSECONDS_PER_SECOND) / NANOSECONDS_PER_MICROSECOND);
+	return time;
+}
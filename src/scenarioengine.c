@@ -0,0 +1,792 @@
+#include "scenarioengine.h"
+#include "isoerror.h"
+#include "dynamicarray.h"
+#include "timeconversions.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCENARIO_DEFAULT_GRID_CELL_SIZE_M 10.0
+//! Regions covering more grid cells than this are tested on every sample instead
+#define SCENARIO_MAX_REGION_CELLS 64
+
+typedef struct {
+	double threshold_m_s;
+	uint16_t triggerID;
+	bool isInclusive;					//!< Or equal to the threshold
+} SpeedTriggerType;
+
+typedef struct {
+	double minX_m;
+	double minY_m;
+	double maxX_m;
+	double maxY_m;
+	uint16_t triggerID;
+	bool firesOnEntry;					//!< Entry or exit of the region
+	bool isInside;
+	uint64_t lastEvaluatedSample;		//!< Avoids testing a region twice in one sample
+} RegionTriggerType;
+
+typedef struct {
+	uint64_t cell;
+	size_t region;
+} GridEntryType;
+
+typedef struct {
+	ObjectStateType state;
+	uint16_t triggerID;
+} StateTriggerType;
+
+//! Triggers on the monitor data of one object, each kind indexed on the value it is tested against
+typedef struct {
+	uint32_t transmitterID;
+	SpeedTriggerType* risingSpeed;		//!< Greater than triggers, sorted on threshold
+	size_t nRisingSpeed, risingSpeedCapacity;
+	SpeedTriggerType* fallingSpeed;		//!< Less than triggers, sorted on threshold
+	size_t nFallingSpeed, fallingSpeedCapacity;
+	RegionTriggerType* regions;
+	size_t nRegions, regionCapacity;
+	GridEntryType* grid;				//!< Grid cells overlapped by each region, sorted on cell
+	size_t nGridEntries, gridCapacity;
+	bool isGridSorted;
+	size_t* largeRegions;				//!< Regions too large for the grid
+	size_t nLargeRegions, largeRegionCapacity;
+	size_t* insideRegions;				//!< Regions the object is in, tested every sample for exit
+	size_t nInsideRegions, insideRegionCapacity;
+	StateTriggerType* states;			//!< Sorted on state
+	size_t nStates, stateCapacity;
+
+	bool hasPreviousSpeed;
+	double previousSpeed_m_s;
+	bool hasPreviousState;
+	ObjectStateType previousState;
+} ScenarioObjectType;
+
+typedef struct {
+	int64_t sendTime_us;
+	uint64_t sequence;					//!< Keeps executions with equal send times in schedule order
+	ScenarioExecutionType execution;
+} PendingExecutionType;
+
+struct ScenarioEngine {
+	double gridCellSize_m;
+	int64_t sendLead_us;
+	ScenarioObjectType* objects;		//!< Sorted on transmitter ID
+	size_t nObjects, objectCapacity;
+	ScenarioActionType* actions;		//!< Sorted on trigger ID
+	size_t nActions, actionCapacity;
+	PendingExecutionType* queue;		//!< Binary min heap on send time
+	size_t nPending, queueCapacity;
+	uint64_t nextSequence;
+	uint64_t nSamples;
+	ScenarioStatisticsType statistics;
+};
+
+static inline uint64_t gridCell(const double x, const double y, const double cellSize) {
+	const int32_t cx = (int32_t) floor(x / cellSize);
+	const int32_t cy = (int32_t) floor(y / cellSize);
+	return ((uint64_t) (uint32_t) cx << 32) | (uint32_t) cy;
+}
+
+/*!
+ * \brief createScenarioEngine Creates an engine without triggers or actions
+ * \param gridCellSize_m Size of the grid cells indexing trigger regions, or 0 for a default. Regions
+ *			should typically cover no more than a few cells.
+ * \param sendLeadTime Time before execution at which an EXAC is due to be sent, or NULL to send it
+ *			at the execution time. Executions closer than this are due immediately.
+ * \return The engine, or NULL if it could not be allocated
+ */
+ScenarioEngineType* createScenarioEngine(
+		const double gridCellSize_m,
+		const struct timeval* sendLeadTime) {
+	ScenarioEngineType* engine = calloc(1, sizeof (*engine));
+
+	if (engine == NULL) {
+		return NULL;
+	}
+	engine->gridCellSize_m = gridCellSize_m > 0.0 ? gridCellSize_m : SCENARIO_DEFAULT_GRID_CELL_SIZE_M;
+	engine->sendLead_us = sendLeadTime != NULL ? timevalToMicroseconds(sendLeadTime) : 0;
+	resetScenarioEngine(engine);
+	return engine;
+}
+
+/*!
+ * \brief freeScenarioEngine Frees an engine and all its triggers, actions and pending executions
+ * \param engine Engine to free, may be NULL
+ */
+void freeScenarioEngine(ScenarioEngineType* engine) {
+	if (engine == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < engine->nObjects; ++i) {
+		ScenarioObjectType* object = &engine->objects[i];
+		free(object->risingSpeed);
+		free(object->fallingSpeed);
+		free(object->regions);
+		free(object->grid);
+		free(object->largeRegions);
+		free(object->insideRegions);
+		free(object->states);
+	}
+	free(engine->objects);
+	free(engine->actions);
+	free(engine->queue);
+	free(engine);
+}
+
+/*!
+ * \brief resetScenarioEngine Prepares an engine for a new test run. Triggers and actions are kept,
+ *			while the previous values they were tested against, pending executions and statistics
+ *			are cleared.
+ * \param engine Engine to reset
+ */
+void resetScenarioEngine(ScenarioEngineType* engine) {
+	for (size_t i = 0; i < engine->nObjects; ++i) {
+		ScenarioObjectType* object = &engine->objects[i];
+		for (size_t j = 0; j < object->nRegions; ++j) {
+			object->regions[j].isInside = false;
+			object->regions[j].lastEvaluatedSample = 0;
+		}
+		object->nInsideRegions = 0;
+		object->hasPreviousSpeed = false;
+		object->hasPreviousState = false;
+	}
+	engine->nPending = 0;
+	engine->nSamples = 0;
+	memset(&engine->statistics, 0, sizeof (engine->statistics));
+	engine->statistics.minLatency_us = INT64_MAX;
+	engine->statistics.maxLatency_us = INT64_MIN;
+}
+
+//! Index of the first speed trigger with a threshold not below a speed
+static size_t lowerBoundSpeed(const SpeedTriggerType* triggers, const size_t nTriggers, const double speed_m_s) {
+	size_t low = 0, high = nTriggers;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (triggers[middle].threshold_m_s < speed_m_s) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+//! Index of the first grid entry not before a cell
+static size_t lowerBoundCell(const GridEntryType* grid, const size_t nEntries, const uint64_t cell) {
+	size_t low = 0, high = nEntries;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (grid[middle].cell < cell) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+static int compareGridEntries(const void* a, const void* b) {
+	const GridEntryType* entryA = a;
+	const GridEntryType* entryB = b;
+	return (entryA->cell > entryB->cell) - (entryA->cell < entryB->cell);
+}
+
+/*!
+ * \brief findScenarioObject Finds the triggers of an object
+ * \param engine Engine to search
+ * \param transmitterID Object to find
+ * \param index Index of the object, or where it would be inserted if not found
+ * \return The object, or NULL if it has no triggers
+ */
+static ScenarioObjectType* findScenarioObject(
+		const ScenarioEngineType* engine,
+		const uint32_t transmitterID,
+		size_t* index) {
+	size_t low = 0, high = engine->nObjects;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (engine->objects[middle].transmitterID < transmitterID) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	*index = low;
+	return low < engine->nObjects && engine->objects[low].transmitterID == transmitterID ?
+				&engine->objects[low] : NULL;
+}
+
+static ScenarioObjectType* addScenarioObject(ScenarioEngineType* engine, const uint32_t transmitterID) {
+	size_t index;
+	ScenarioObjectType* object = findScenarioObject(engine, transmitterID, &index);
+
+	if (object != NULL) {
+		return object;
+	}
+	if (RESERVE(engine->objects, engine->nObjects, engine->objectCapacity) < 0) {
+		return NULL;
+	}
+	memmove(&engine->objects[index + 1], &engine->objects[index],
+			(engine->nObjects - index) * sizeof (engine->objects[0]));
+	engine->nObjects++;
+	object = &engine->objects[index];
+	memset(object, 0, sizeof (*object));
+	object->transmitterID = transmitterID;
+	object->isGridSorted = true;
+	return object;
+}
+
+static int addSpeedTrigger(ScenarioObjectType* object, const ScenarioTriggerType* trigger) {
+	SpeedTriggerType speedTrigger;
+	SpeedTriggerType** triggers;
+	size_t* nTriggers;
+	int retval;
+
+	speedTrigger.threshold_m_s = trigger->speedThreshold_m_s;
+	speedTrigger.triggerID = trigger->triggerID;
+	switch (trigger->comparison) {
+	case TRIGGER_PARAMETER_GREATER_THAN:
+	case TRIGGER_PARAMETER_GREATER_THAN_OR_EQUAL_TO:
+		speedTrigger.isInclusive = trigger->comparison == TRIGGER_PARAMETER_GREATER_THAN_OR_EQUAL_TO;
+		retval = RESERVE(object->risingSpeed, object->nRisingSpeed, object->risingSpeedCapacity);
+		triggers = &object->risingSpeed;
+		nTriggers = &object->nRisingSpeed;
+		break;
+	case TRIGGER_PARAMETER_LESS_THAN:
+	case TRIGGER_PARAMETER_LESS_THAN_OR_EQUAL_TO:
+		speedTrigger.isInclusive = trigger->comparison == TRIGGER_PARAMETER_LESS_THAN_OR_EQUAL_TO;
+		retval = RESERVE(object->fallingSpeed, object->nFallingSpeed, object->fallingSpeedCapacity);
+		triggers = &object->fallingSpeed;
+		nTriggers = &object->nFallingSpeed;
+		break;
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+	if (retval < 0) {
+		return -1;
+	}
+	const size_t index = lowerBoundSpeed(*triggers, *nTriggers, speedTrigger.threshold_m_s);
+	memmove(&(*triggers)[index + 1], &(*triggers)[index], (*nTriggers - index) * sizeof (speedTrigger));
+	(*triggers)[index] = speedTrigger;
+	(*nTriggers)++;
+	return 0;
+}
+
+static int addRegionTrigger(ScenarioObjectType* object, const ScenarioTriggerType* trigger, const double cellSize) {
+	RegionTriggerType region;
+
+	if (!(trigger->minX_m <= trigger->maxX_m && trigger->minY_m <= trigger->maxY_m)) {
+		errno = EINVAL;
+		return -1;
+	}
+	memset(&region, 0, sizeof (region));
+	region.minX_m = trigger->minX_m;
+	region.minY_m = trigger->minY_m;
+	region.maxX_m = trigger->maxX_m;
+	region.maxY_m = trigger->maxY_m;
+	region.triggerID = trigger->triggerID;
+	region.firesOnEntry = trigger->type == TRIGGER_POSITION_REACHED;
+
+	const double nCellsX = floor(region.maxX_m / cellSize) - floor(region.minX_m / cellSize) + 1.0;
+	const double nCellsY = floor(region.maxY_m / cellSize) - floor(region.minY_m / cellSize) + 1.0;
+	const size_t regionIndex = object->nRegions;
+
+	if (RESERVE(object->regions, object->nRegions, object->regionCapacity) < 0) {
+		return -1;
+	}
+	if (nCellsX * nCellsY > SCENARIO_MAX_REGION_CELLS) {
+		if (RESERVE(object->largeRegions, object->nLargeRegions, object->largeRegionCapacity) < 0) {
+			return -1;
+		}
+		object->largeRegions[object->nLargeRegions++] = regionIndex;
+	}
+	else {
+		const int32_t minCellX = (int32_t) floor(region.minX_m / cellSize);
+		const int32_t minCellY = (int32_t) floor(region.minY_m / cellSize);
+		const size_t nGridEntries = object->nGridEntries;
+		for (int32_t i = 0; i < (int32_t) nCellsX; ++i) {
+			for (int32_t j = 0; j < (int32_t) nCellsY; ++j) {
+				if (RESERVE(object->grid, object->nGridEntries, object->gridCapacity) < 0) {
+					// Drop the cells already entered, as they refer to a region which is not added
+					object->nGridEntries = nGridEntries;
+					return -1;
+				}
+				object->grid[object->nGridEntries].cell = ((uint64_t) (uint32_t) (minCellX + i) << 32)
+						| (uint32_t) (minCellY + j);
+				object->grid[object->nGridEntries].region = regionIndex;
+				object->nGridEntries++;
+			}
+		}
+		object->isGridSorted = false;
+	}
+	object->regions[object->nRegions++] = region;
+	return 0;
+}
+
+static int addStateTrigger(ScenarioObjectType* object, const ScenarioTriggerType* trigger) {
+	size_t index = object->nStates;
+
+	if (RESERVE(object->states, object->nStates, object->stateCapacity) < 0) {
+		return -1;
+	}
+	while (index > 0 && object->states[index - 1].state > trigger->state) {
+		object->states[index] = object->states[index - 1];
+		index--;
+	}
+	object->states[index].state = trigger->state;
+	object->states[index].triggerID = trigger->triggerID;
+	object->nStates++;
+	return 0;
+}
+
+/*!
+ * \brief addScenarioTrigger Adds a trigger to be evaluated on the monitor data of an object
+ * \param engine Engine to add the trigger to
+ * \param trigger Trigger to add, copied into the engine
+ * \return 0 on success, -1 otherwise with errno set to
+ *		EINVAL		if the trigger type, comparison or region is not supported
+ *		ENOMEM		if memory could not be allocated
+ */
+int addScenarioTrigger(
+		ScenarioEngineType* engine,
+		const ScenarioTriggerType* trigger) {
+	ScenarioObjectType* object;
+
+	if (engine == NULL || trigger == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	switch (trigger->type) {
+	case TRIGGER_SPEED:
+	case TRIGGER_POSITION_REACHED:
+	case TRIGGER_POSITION_LEFT:
+	case TRIGGER_MODE_CHANGED:
+		break;
+	default:
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRCM, 0,
+						 "Trigger type 0x%x is not supported by the scenario engine", trigger->type);
+		return -1;
+	}
+	if ((object = addScenarioObject(engine, trigger->transmitterID)) == NULL) {
+		return -1;
+	}
+
+	switch (trigger->type) {
+	case TRIGGER_SPEED:
+		return addSpeedTrigger(object, trigger);
+	case TRIGGER_POSITION_REACHED:
+	case TRIGGER_POSITION_LEFT:
+		return addRegionTrigger(object, trigger, engine->gridCellSize_m);
+	default:
+		return addStateTrigger(object, trigger);
+	}
+}
+
+/*!
+ * \brief addScenarioAction Adds an action to be executed when a trigger fires
+ * \param engine Engine to add the action to
+ * \param action Action to add, copied into the engine
+ * \return 0 on success, -1 otherwise
+ */
+int addScenarioAction(
+		ScenarioEngineType* engine,
+		const ScenarioActionType* action) {
+	if (engine == NULL || action == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (RESERVE(engine->actions, engine->nActions, engine->actionCapacity) < 0) {
+		return -1;
+	}
+	size_t index = engine->nActions;
+	while (index > 0 && engine->actions[index - 1].triggerID > action->triggerID) {
+		engine->actions[index] = engine->actions[index - 1];
+		index--;
+	}
+	engine->actions[index] = *action;
+	engine->nActions++;
+	return 0;
+}
+
+static void siftUpExecution(PendingExecutionType* queue, size_t index) {
+	const PendingExecutionType pending = queue[index];
+	while (index > 0) {
+		const size_t parent = (index - 1) / 2;
+		if (queue[parent].sendTime_us < pending.sendTime_us
+				|| (queue[parent].sendTime_us == pending.sendTime_us && queue[parent].sequence < pending.sequence)) {
+			break;
+		}
+		queue[index] = queue[parent];
+		index = parent;
+	}
+	queue[index] = pending;
+}
+
+static void siftDownExecution(PendingExecutionType* queue, const size_t nPending, size_t index) {
+	const PendingExecutionType pending = queue[index];
+	for (;;) {
+		size_t child = 2 * index + 1;
+		if (child >= nPending) {
+			break;
+		}
+		if (child + 1 < nPending && (queue[child + 1].sendTime_us < queue[child].sendTime_us
+				|| (queue[child + 1].sendTime_us == queue[child].sendTime_us
+					&& queue[child + 1].sequence < queue[child].sequence))) {
+			child++;
+		}
+		if (pending.sendTime_us < queue[child].sendTime_us
+				|| (pending.sendTime_us == queue[child].sendTime_us && pending.sequence < queue[child].sequence)) {
+			break;
+		}
+		queue[index] = queue[child];
+		index = child;
+	}
+	queue[index] = pending;
+}
+
+/*!
+ * \brief fireScenarioTrigger Schedules the actions of a trigger which has fired
+ * \param engine Engine holding the actions
+ * \param triggerID Trigger which fired
+ * \param receiveTime_us Receipt of the monitor data which fired it
+ * \return 0 on success, -1 if an execution could not be scheduled
+ */
+static int fireScenarioTrigger(ScenarioEngineType* engine, const uint16_t triggerID, const int64_t receiveTime_us) {
+	size_t low = 0, high = engine->nActions;
+
+	engine->statistics.nTriggersFired++;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (engine->actions[middle].triggerID < triggerID) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	for (size_t i = low; i < engine->nActions && engine->actions[i].triggerID == triggerID; ++i) {
+		const ScenarioActionType* action = &engine->actions[i];
+		const int64_t executionTime_us = receiveTime_us + timevalToMicroseconds(&action->delay);
+		PendingExecutionType pending;
+
+		if (RESERVE(engine->queue, engine->nPending, engine->queueCapacity) < 0) {
+			return -1;
+		}
+		pending.sendTime_us = executionTime_us - engine->sendLead_us > receiveTime_us ?
+					executionTime_us - engine->sendLead_us : receiveTime_us;
+		pending.sequence = engine->nextSequence++;
+		pending.execution.actionID = action->actionID;
+		pending.execution.transmitterID = action->transmitterID;
+		pending.execution.executionTime = microsecondsToTimeval(executionTime_us);
+		pending.execution.triggerTime = microsecondsToTimeval(receiveTime_us);
+		engine->queue[engine->nPending] = pending;
+		siftUpExecution(engine->queue, engine->nPending++);
+		engine->statistics.nExecutionsScheduled++;
+	}
+	return 0;
+}
+
+static ssize_t evaluateSpeedTriggers(ScenarioEngineType* engine, ScenarioObjectType* object,
+									 const double speed_m_s, const int64_t receiveTime_us) {
+	const double previous_m_s = object->previousSpeed_m_s;
+	const bool hasPrevious = object->hasPreviousSpeed;
+	ssize_t nFired = 0;
+
+	// Greater than conditions can only have become true for thresholds between the previous and current speed
+	if (!hasPrevious || speed_m_s > previous_m_s) {
+		size_t i = hasPrevious ? lowerBoundSpeed(object->risingSpeed, object->nRisingSpeed, previous_m_s) : 0;
+		for (; i < object->nRisingSpeed && object->risingSpeed[i].threshold_m_s <= speed_m_s; ++i) {
+			const SpeedTriggerType* trigger = &object->risingSpeed[i];
+			const bool wasTrue = hasPrevious && (trigger->isInclusive ? previous_m_s >= trigger->threshold_m_s
+																	   : previous_m_s > trigger->threshold_m_s);
+			const bool isTrue = trigger->isInclusive ? speed_m_s >= trigger->threshold_m_s
+													 : speed_m_s > trigger->threshold_m_s;
+			engine->statistics.nTriggerEvaluations++;
+			if (isTrue && !wasTrue) {
+				if (fireScenarioTrigger(engine, trigger->triggerID, receiveTime_us) < 0) {
+					return -1;
+				}
+				nFired++;
+			}
+		}
+	}
+	// Less than conditions likewise, for a decreasing speed
+	if (!hasPrevious || speed_m_s < previous_m_s) {
+		size_t i = lowerBoundSpeed(object->fallingSpeed, object->nFallingSpeed, speed_m_s);
+		for (; i < object->nFallingSpeed
+				&& (!hasPrevious || object->fallingSpeed[i].threshold_m_s <= previous_m_s); ++i) {
+			const SpeedTriggerType* trigger = &object->fallingSpeed[i];
+			const bool wasTrue = hasPrevious && (trigger->isInclusive ? previous_m_s <= trigger->threshold_m_s
+																	   : previous_m_s < trigger->threshold_m_s);
+			const bool isTrue = trigger->isInclusive ? speed_m_s <= trigger->threshold_m_s
+													 : speed_m_s < trigger->threshold_m_s;
+			engine->statistics.nTriggerEvaluations++;
+			if (isTrue && !wasTrue) {
+				if (fireScenarioTrigger(engine, trigger->triggerID, receiveTime_us) < 0) {
+					return -1;
+				}
+				nFired++;
+			}
+		}
+	}
+	object->previousSpeed_m_s = speed_m_s;
+	object->hasPreviousSpeed = true;
+	return nFired;
+}
+
+/*!
+ * \brief evaluateRegion Tests whether an object has entered or left a region since the previous sample
+ * \return 1 if the trigger of the region fired, 0 if not and -1 on error
+ */
+static int evaluateRegion(ScenarioEngineType* engine, ScenarioObjectType* object, const size_t regionIndex,
+						  const double x, const double y, const int64_t receiveTime_us) {
+	RegionTriggerType* region = &object->regions[regionIndex];
+
+	if (region->lastEvaluatedSample == engine->nSamples) {
+		return 0;
+	}
+	region->lastEvaluatedSample = engine->nSamples;
+	engine->statistics.nTriggerEvaluations++;
+
+	const bool isInside = x >= region->minX_m && x <= region->maxX_m && y >= region->minY_m && y <= region->maxY_m;
+	if (isInside == region->isInside) {
+		return 0;
+	}
+	region->isInside = isInside;
+	if (isInside) {
+		if (RESERVE(object->insideRegions, object->nInsideRegions, object->insideRegionCapacity) < 0) {
+			return -1;
+		}
+		object->insideRegions[object->nInsideRegions++] = regionIndex;
+	}
+	else {
+		for (size_t i = 0; i < object->nInsideRegions; ++i) {
+			if (object->insideRegions[i] == regionIndex) {
+				object->insideRegions[i] = object->insideRegions[--object->nInsideRegions];
+				break;
+			}
+		}
+	}
+	if (isInside != region->firesOnEntry) {
+		return 0;
+	}
+	return fireScenarioTrigger(engine, region->triggerID, receiveTime_us) < 0 ? -1 : 1;
+}
+
+static ssize_t evaluateRegionTriggers(ScenarioEngineType* engine, ScenarioObjectType* object,
+									  const double x, const double y, const int64_t receiveTime_us) {
+	ssize_t nFired = 0;
+	int retval;
+
+	if (!object->isGridSorted) {
+		qsort(object->grid, object->nGridEntries, sizeof (object->grid[0]), compareGridEntries);
+		object->isGridSorted = true;
+	}
+
+	// Regions the object is in may be left, and only regions overlapping its grid cell may be entered
+	for (size_t i = object->nInsideRegions; i-- > 0;) {
+		if ((retval = evaluateRegion(engine, object, object->insideRegions[i], x, y, receiveTime_us)) < 0) {
+			return -1;
+		}
+		nFired += retval;
+	}
+	const uint64_t cell = gridCell(x, y, engine->gridCellSize_m);
+	for (size_t i = lowerBoundCell(object->grid, object->nGridEntries, cell);
+		 i < object->nGridEntries && object->grid[i].cell == cell; ++i) {
+		if ((retval = evaluateRegion(engine, object, object->grid[i].region, x, y, receiveTime_us)) < 0) {
+			return -1;
+		}
+		nFired += retval;
+	}
+	for (size_t i = 0; i < object->nLargeRegions; ++i) {
+		if ((retval = evaluateRegion(engine, object, object->largeRegions[i], x, y, receiveTime_us)) < 0) {
+			return -1;
+		}
+		nFired += retval;
+	}
+	return nFired;
+}
+
+static ssize_t evaluateStateTriggers(ScenarioEngineType* engine, ScenarioObjectType* object,
+									 const ObjectStateType state, const int64_t receiveTime_us) {
+	ssize_t nFired = 0;
+
+	if (object->hasPreviousState && object->previousState == state) {
+		return 0;
+	}
+	object->previousState = state;
+	object->hasPreviousState = true;
+
+	size_t i = 0;
+	while (i < object->nStates && object->states[i].state < state) {
+		i++;
+	}
+	for (; i < object->nStates && object->states[i].state == state; ++i) {
+		engine->statistics.nTriggerEvaluations++;
+		if (fireScenarioTrigger(engine, object->states[i].triggerID, receiveTime_us) < 0) {
+			return -1;
+		}
+		nFired++;
+	}
+	return nFired;
+}
+
+/*!
+ * \brief processScenarioMonitorData Evaluates the triggers of an object on its latest monitor data,
+ *			scheduling the actions of those which fire. Only triggers whose condition may have changed
+ *			since the previous sample are tested.
+ * \param engine Engine holding the triggers
+ * \param transmitterID Object the monitor data is from
+ * \param monitorData Monitor data, e.g. decoded from MONR. Invalid positions and speeds are not evaluated.
+ * \param receiveTime Time the monitor data was received, from which action delays and latency are measured
+ * \return Number of triggers fired, or -1 if an execution could not be scheduled
+ */
+ssize_t processScenarioMonitorData(
+		ScenarioEngineType* engine,
+		const uint32_t transmitterID,
+		const ObjectMonitorType* monitorData,
+		const struct timeval* receiveTime) {
+	size_t index;
+	ssize_t nFired = 0, retval;
+
+	if (engine == NULL || monitorData == NULL || receiveTime == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	engine->nSamples++;
+	engine->statistics.nMonitorSamples++;
+
+	ScenarioObjectType* object = findScenarioObject(engine, transmitterID, &index);
+	if (object == NULL) {
+		return 0;
+	}
+	const int64_t receiveTime_us = timevalToMicroseconds(receiveTime);
+
+	if (monitorData->speed.isLongitudinalValid) {
+		if ((retval = evaluateSpeedTriggers(engine, object, monitorData->speed.longitudinal_m_s,
+											receiveTime_us)) < 0) {
+			return -1;
+		}
+		nFired += retval;
+	}
+	if (monitorData->position.isPositionValid && object->nRegions > 0) {
+		if ((retval = evaluateRegionTriggers(engine, object, monitorData->position.xCoord_m,
+											 monitorData->position.yCoord_m, receiveTime_us)) < 0) {
+			return -1;
+		}
+		nFired += retval;
+	}
+	if ((retval = evaluateStateTriggers(engine, object, monitorData->state, receiveTime_us)) < 0) {
+		return -1;
+	}
+	return nFired + retval;
+}
+
+/*!
+ * \brief getNextScenarioDeadline Gets the time at which the next EXAC is due to be sent, e.g. for
+ *			arming a timer
+ * \param engine Engine holding the pending executions
+ * \param deadline Time at which ::popDueScenarioExecutions will next return an execution
+ * \return 0 if an execution is pending, -1 otherwise
+ */
+int getNextScenarioDeadline(
+		const ScenarioEngineType* engine,
+		struct timeval* deadline) {
+	if (engine == NULL || deadline == NULL || engine->nPending == 0) {
+		return -1;
+	}
+	*deadline = microsecondsToTimeval(engine->queue[0].sendTime_us);
+	return 0;
+}
+
+/*!
+ * \brief popDueScenarioExecutions Removes the executions due to be sent from the queue, earliest first
+ * \param engine Engine holding the pending executions
+ * \param currentTime Current time
+ * \param executions Array in which to store the due executions
+ * \param maxExecutions Number of executions the array can hold
+ * \return Number of executions stored
+ */
+size_t popDueScenarioExecutions(
+		ScenarioEngineType* engine,
+		const struct timeval* currentTime,
+		ScenarioExecutionType executions[],
+		const size_t maxExecutions) {
+	const int64_t currentTime_us = timevalToMicroseconds(currentTime);
+	size_t nDue = 0;
+
+	while (nDue < maxExecutions && engine->nPending > 0 && engine->queue[0].sendTime_us <= currentTime_us) {
+		executions[nDue++] = engine->queue[0].execution;
+		engine->queue[0] = engine->queue[--engine->nPending];
+		if (engine->nPending > 0) {
+			siftDownExecution(engine->queue, engine->nPending, 0);
+		}
+	}
+	return nDue;
+}
+
+/*!
+ * \brief encodeScenarioEXACMessage Encodes the EXAC message of an execution and records the latency
+ *			from receipt of the monitor data which fired its trigger
+ * \param engine Engine which scheduled the execution
+ * \param inputHeader data to create header with
+ * \param execution Execution to encode
+ * \param sendTime Time the message is sent, normally the current time
+ * \param exacDataBuffer Buffer to hold the message
+ * \param bufferLength Length of the buffer
+ * \param debug Flag for enabling of debugging
+ * \return Number of bytes written to the buffer, or -1 in case of an error
+ */
+ssize_t encodeScenarioEXACMessage(
+		ScenarioEngineType* engine,
+		const MessageHeaderType* inputHeader,
+		const ScenarioExecutionType* execution,
+		const struct timeval* sendTime,
+		char* exacDataBuffer,
+		const size_t bufferLength,
+		const char debug) {
+	if (engine == NULL || execution == NULL || sendTime == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_EXAC, 0,
+						 "Input pointers to scenario EXAC encoding function cannot be null");
+		return -1;
+	}
+
+	const ssize_t retval = encodeEXACMessage(inputHeader, &execution->actionID, &execution->executionTime,
+											 exacDataBuffer, bufferLength, debug);
+	if (retval < 0) {
+		return retval;
+	}
+
+	const int64_t sendTime_us = timevalToMicroseconds(sendTime);
+	const int64_t latency_us = sendTime_us - timevalToMicroseconds(&execution->triggerTime);
+	ScenarioStatisticsType* statistics = &engine->statistics;
+
+	statistics->nExecutionsSent++;
+	if (sendTime_us > timevalToMicroseconds(&execution->executionTime)) {
+		statistics->nExecutionsLate++;
+	}
+	statistics->minLatency_us = latency_us < statistics->minLatency_us ? latency_us : statistics->minLatency_us;
+	statistics->maxLatency_us = latency_us > statistics->maxLatency_us ? latency_us : statistics->maxLatency_us;
+	statistics->totalLatency_us += latency_us;
+	return retval;
+}
+
+/*!
+ * \brief getScenarioStatistics Gets counters of evaluated triggers and sent executions since the
+ *			engine was created or reset
+ * \param engine Engine to read
+ * \return Statistics of the engine. Latencies are only meaningful if an execution has been sent.
+ */
+ScenarioStatisticsType getScenarioStatistics(const ScenarioEngineType* engine) {
+	return engine->statistics;
+}
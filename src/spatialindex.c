@@ -0,0 +1,416 @@
+#include "spatialindex.h"
+#include "isoerror.h"
+#include "timeconversions.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+//! Children of each node, and segments of each leaf
+#define SPATIAL_INDEX_NODE_SIZE 8
+//! Enough levels for any number of segments
+#define SPATIAL_INDEX_MAX_LEVELS 24
+
+typedef struct {
+	double minX_m;
+	double minY_m;
+	double maxX_m;
+	double maxY_m;
+} BoundingBoxType;
+
+/*! Packed R-tree over the segments of a trajectory. Segments are packed into leaves by sort-tile-
+ *  recursive ordering of their centres, so that trajectories passing the same area several times
+ *  still give tight leaves, and consecutive nodes into parents up to a single root. Each level is
+ *  stored contiguously. */
+struct SpatialIndex {
+	size_t nPoints;
+	size_t nSegments;
+	double* x_m;
+	double* y_m;
+	double* arcLength_m;
+	int64_t* time_us;
+	size_t* order;						//!< Segments in the order they are packed into leaves
+	BoundingBoxType* boxes;
+	size_t nLevels;
+	size_t levelOffset[SPATIAL_INDEX_MAX_LEVELS];	//!< Of the first box of each level, leaves first
+	size_t levelSize[SPATIAL_INDEX_MAX_LEVELS];
+};
+
+typedef struct {
+	double x_m;
+	double y_m;
+	size_t segment;
+} SegmentCentreType;
+
+typedef struct {
+	size_t level;
+	size_t node;
+	double distance2;					//!< Lower bound on the squared distance to segments of the node
+} SearchEntryType;
+
+static inline void extendBox(BoundingBoxType* box, const BoundingBoxType* other) {
+	box->minX_m = other->minX_m < box->minX_m ? other->minX_m : box->minX_m;
+	box->minY_m = other->minY_m < box->minY_m ? other->minY_m : box->minY_m;
+	box->maxX_m = other->maxX_m > box->maxX_m ? other->maxX_m : box->maxX_m;
+	box->maxY_m = other->maxY_m > box->maxY_m ? other->maxY_m : box->maxY_m;
+}
+
+static inline size_t nextPoint(const SpatialIndexType* index, const size_t segment) {
+	return index->nPoints > 1 ? segment + 1 : segment;
+}
+
+static int compareCentresByX(const void* a, const void* b) {
+	const SegmentCentreType* centreA = a;
+	const SegmentCentreType* centreB = b;
+	return (centreA->x_m > centreB->x_m) - (centreA->x_m < centreB->x_m);
+}
+
+static int compareCentresByY(const void* a, const void* b) {
+	const SegmentCentreType* centreA = a;
+	const SegmentCentreType* centreB = b;
+	return (centreA->y_m > centreB->y_m) - (centreA->y_m < centreB->y_m);
+}
+
+/*!
+ * \brief orderSpatialIndexSegments Orders segments for packing into leaves: sorted by centre x into
+ *			vertical slices of about the square root of the number of leaves, and within each slice
+ *			by centre y
+ * \param index Index with points and segments
+ * \return 0 on success, -1 if memory could not be allocated
+ */
+static int orderSpatialIndexSegments(SpatialIndexType* index) {
+	const size_t nSegments = index->nSegments;
+	SegmentCentreType* centres = malloc(nSegments * sizeof (*centres));
+
+	if (centres == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+	for (size_t i = 0; i < nSegments; ++i) {
+		const size_t next = nextPoint(index, i);
+		centres[i].x_m = 0.5 * (index->x_m[i] + index->x_m[next]);
+		centres[i].y_m = 0.5 * (index->y_m[i] + index->y_m[next]);
+		centres[i].segment = i;
+	}
+	const size_t nLeaves = (nSegments + SPATIAL_INDEX_NODE_SIZE - 1) / SPATIAL_INDEX_NODE_SIZE;
+	const size_t nSlices = (size_t) ceil(sqrt((double) nLeaves));
+	const size_t sliceSize = nSlices * SPATIAL_INDEX_NODE_SIZE;
+
+	qsort(centres, nSegments, sizeof (*centres), compareCentresByX);
+	for (size_t first = 0; first < nSegments; first += sliceSize) {
+		const size_t n = first + sliceSize < nSegments ? sliceSize : nSegments - first;
+		qsort(&centres[first], n, sizeof (*centres), compareCentresByY);
+	}
+	for (size_t i = 0; i < nSegments; ++i) {
+		index->order[i] = centres[i].segment;
+	}
+	free(centres);
+	return 0;
+}
+
+/*!
+ * \brief buildSpatialIndexLevels Computes the bounding boxes of all nodes, leaves first
+ * \param index Index with points, ordered segments and allocated boxes
+ */
+static void buildSpatialIndexLevels(SpatialIndexType* index) {
+	size_t level = 0, offset = 0;
+	size_t nNodes = (index->nSegments + SPATIAL_INDEX_NODE_SIZE - 1) / SPATIAL_INDEX_NODE_SIZE;
+
+	for (size_t node = 0; node < nNodes; ++node) {
+		BoundingBoxType* box = &index->boxes[node];
+		const size_t first = node * SPATIAL_INDEX_NODE_SIZE;
+		const size_t end = first + SPATIAL_INDEX_NODE_SIZE < index->nSegments ?
+					first + SPATIAL_INDEX_NODE_SIZE : index->nSegments;
+		box->minX_m = box->maxX_m = index->x_m[index->order[first]];
+		box->minY_m = box->maxY_m = index->y_m[index->order[first]];
+		for (size_t i = first; i < end; ++i) {
+			const size_t start = index->order[i];
+			const size_t next = nextPoint(index, start);
+			const BoundingBoxType segmentBox = {
+				fmin(index->x_m[start], index->x_m[next]), fmin(index->y_m[start], index->y_m[next]),
+				fmax(index->x_m[start], index->x_m[next]), fmax(index->y_m[start], index->y_m[next])
+			};
+			extendBox(box, &segmentBox);
+		}
+	}
+	index->levelOffset[0] = 0;
+	index->levelSize[0] = nNodes;
+
+	while (nNodes > 1) {
+		const size_t nChildren = nNodes;
+		const size_t childOffset = offset;
+		offset += nChildren;
+		nNodes = (nChildren + SPATIAL_INDEX_NODE_SIZE - 1) / SPATIAL_INDEX_NODE_SIZE;
+		level++;
+		for (size_t node = 0; node < nNodes; ++node) {
+			BoundingBoxType* box = &index->boxes[offset + node];
+			const size_t first = node * SPATIAL_INDEX_NODE_SIZE;
+			const size_t end = first + SPATIAL_INDEX_NODE_SIZE < nChildren ? first + SPATIAL_INDEX_NODE_SIZE : nChildren;
+			*box = index->boxes[childOffset + first];
+			for (size_t child = first + 1; child < end; ++child) {
+				extendBox(box, &index->boxes[childOffset + child]);
+			}
+		}
+		index->levelOffset[level] = offset;
+		index->levelSize[level] = nNodes;
+	}
+	index->nLevels = level + 1;
+}
+
+/*!
+ * \brief createSpatialIndex Creates an index for finding the segment of a trajectory nearest to a
+ *			position. The waypoints are copied, and need not be kept.
+ * \param waypoints Trajectory, e.g. decoded from TRAJ, with valid positions
+ * \param nWaypoints Number of waypoints, at least one
+ * \return The index, or NULL otherwise with errno set to
+ *		EINVAL		if a position is invalid
+ *		ENOMEM		if memory could not be allocated
+ */
+SpatialIndexType* createSpatialIndex(
+		const TrajectoryWaypointType waypoints[],
+		const size_t nWaypoints) {
+	SpatialIndexType* index;
+
+	if (waypoints == NULL || nWaypoints == 0) {
+		errno = EINVAL;
+		return NULL;
+	}
+	for (size_t i = 0; i < nWaypoints; ++i) {
+		if (!waypoints[i].pos.isPositionValid) {
+			errno = EINVAL;
+			ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0,
+							 "Trajectory point %zu has no valid position to index", i);
+			return NULL;
+		}
+	}
+
+	const size_t nSegments = nWaypoints > 1 ? nWaypoints - 1 : 1;
+	const size_t nLeaves = (nSegments + SPATIAL_INDEX_NODE_SIZE - 1) / SPATIAL_INDEX_NODE_SIZE;
+	// Each level above the leaves has at most an eighth of the nodes, rounded up
+	const size_t nBoxes = nLeaves + nLeaves / (SPATIAL_INDEX_NODE_SIZE - 1) + SPATIAL_INDEX_MAX_LEVELS;
+	const size_t size = nWaypoints * (3 * sizeof (double) + sizeof (int64_t)) + nSegments * sizeof (size_t)
+			+ nBoxes * sizeof (BoundingBoxType);
+
+	if ((index = malloc(sizeof (*index))) == NULL
+			|| (index->x_m = malloc(size)) == NULL) {
+		free(index);
+		errno = ENOMEM;
+		return NULL;
+	}
+	index->nPoints = nWaypoints;
+	index->nSegments = nSegments;
+	index->y_m = index->x_m + nWaypoints;
+	index->arcLength_m = index->y_m + nWaypoints;
+	index->time_us = (int64_t*) (index->arcLength_m + nWaypoints);
+	index->order = (size_t*) (index->time_us + nWaypoints);
+	index->boxes = (BoundingBoxType*) (index->order + nSegments);
+
+	for (size_t i = 0; i < nWaypoints; ++i) {
+		index->x_m[i] = waypoints[i].pos.xCoord_m;
+		index->y_m[i] = waypoints[i].pos.yCoord_m;
+		index->time_us[i] = timevalToMicroseconds(&waypoints[i].relativeTime);
+		index->arcLength_m[i] = i == 0 ? 0.0 : index->arcLength_m[i - 1]
+					+ hypot(index->x_m[i] - index->x_m[i - 1], index->y_m[i] - index->y_m[i - 1]);
+	}
+	if (orderSpatialIndexSegments(index) < 0) {
+		freeSpatialIndex(index);
+		return NULL;
+	}
+	buildSpatialIndexLevels(index);
+	return index;
+}
+
+/*!
+ * \brief freeSpatialIndex Frees an index
+ * \param index Index to free, may be NULL
+ */
+void freeSpatialIndex(SpatialIndexType* index) {
+	if (index == NULL) {
+		return;
+	}
+	free(index->x_m);
+	free(index);
+}
+
+//! Squared distance from a position to a segment, and the fraction of the segment at which it is closest
+static inline double projectOntoSegment(const SpatialIndexType* index, const size_t segment,
+										const double x, const double y, double* fraction) {
+	const size_t next = nextPoint(index, segment);
+	const double dx = index->x_m[next] - index->x_m[segment];
+	const double dy = index->y_m[next] - index->y_m[segment];
+	const double length2 = dx * dx + dy * dy;
+	double f = length2 > 0.0 ? ((x - index->x_m[segment]) * dx + (y - index->y_m[segment]) * dy) / length2 : 0.0;
+
+	f = f < 0.0 ? 0.0 : f > 1.0 ? 1.0 : f;
+	*fraction = f;
+	const double ex = index->x_m[segment] + f * dx - x;
+	const double ey = index->y_m[segment] + f * dy - y;
+	return ex * ex + ey * ey;
+}
+
+static inline double boxDistance2(const BoundingBoxType* box, const double x, const double y) {
+	const double dx = x < box->minX_m ? box->minX_m - x : x > box->maxX_m ? x - box->maxX_m : 0.0;
+	const double dy = y < box->minY_m ? box->minY_m - y : y > box->maxY_m ? y - box->maxY_m : 0.0;
+	return dx * dx + dy * dy;
+}
+
+/*!
+ * \brief findNearestSegment Searches the tree depth first, visiting nearer nodes first and skipping
+ *			nodes which cannot hold a segment nearer than the best found so far
+ * \param index Index to search
+ * \param x Position
+ * \param y Position
+ * \param segment Nearest segment. On input, a segment to start from, or SIZE_MAX.
+ * \param fraction Of the nearest segment before the nearest point
+ * \return Squared distance to the nearest segment
+ */
+static double findNearestSegment(const SpatialIndexType* index, const double x, const double y,
+								 size_t* segment, double* fraction) {
+	SearchEntryType stack[SPATIAL_INDEX_MAX_LEVELS * SPATIAL_INDEX_NODE_SIZE];
+	size_t nStacked = 0;
+	double best2 = INFINITY;
+
+	if (*segment < index->nSegments) {
+		best2 = projectOntoSegment(index, *segment, x, y, fraction);
+	}
+	const size_t root = index->nLevels - 1;
+	stack[nStacked].level = root;
+	stack[nStacked].node = 0;
+	stack[nStacked++].distance2 = boxDistance2(&index->boxes[index->levelOffset[root]], x, y);
+
+	while (nStacked > 0) {
+		const SearchEntryType entry = stack[--nStacked];
+		if (entry.distance2 >= best2) {
+			continue;
+		}
+		const size_t first = entry.node * SPATIAL_INDEX_NODE_SIZE;
+
+		if (entry.level == 0) {
+			const size_t end = first + SPATIAL_INDEX_NODE_SIZE < index->nSegments ?
+						first + SPATIAL_INDEX_NODE_SIZE : index->nSegments;
+			for (size_t i = first; i < end; ++i) {
+				double f;
+				const double distance2 = projectOntoSegment(index, index->order[i], x, y, &f);
+				if (distance2 < best2) {
+					best2 = distance2;
+					*segment = index->order[i];
+					*fraction = f;
+				}
+			}
+			continue;
+		}
+
+		// Children are pushed farthest first, so that the nearest is searched first
+		const size_t childLevel = entry.level - 1;
+		const size_t end = first + SPATIAL_INDEX_NODE_SIZE < index->levelSize[childLevel] ?
+					first + SPATIAL_INDEX_NODE_SIZE : index->levelSize[childLevel];
+		const size_t nChildren = end - first;
+		SearchEntryType* children = &stack[nStacked];
+		size_t nPushed = 0;
+		for (size_t i = 0; i < nChildren; ++i) {
+			const double distance2 = boxDistance2(&index->boxes[index->levelOffset[childLevel] + first + i], x, y);
+			if (distance2 >= best2) {
+				continue;
+			}
+			size_t j = nPushed++;
+			while (j > 0 && children[j - 1].distance2 < distance2) {
+				children[j] = children[j - 1];
+				j--;
+			}
+			children[j].level = childLevel;
+			children[j].node = first + i;
+			children[j].distance2 = distance2;
+		}
+		nStacked += nPushed;
+	}
+	return best2;
+}
+
+static void fillProjection(const SpatialIndexType* index, const size_t segment, const double fraction,
+						   const double distance2, const double x, const double y,
+						   TrajectoryProjectionType* projection) {
+	const size_t next = nextPoint(index, segment);
+	const double dx = index->x_m[next] - index->x_m[segment];
+	const double dy = index->y_m[next] - index->y_m[segment];
+	const double cross = dx * (y - index->y_m[segment]) - dy * (x - index->x_m[segment]);
+	const int64_t time_us = index->time_us[segment]
+			+ (int64_t) llround(fraction * (double) (index->time_us[next] - index->time_us[segment]));
+
+	projection->segment = segment;
+	projection->fraction = fraction;
+	projection->x_m = index->x_m[segment] + fraction * dx;
+	projection->y_m = index->y_m[segment] + fraction * dy;
+	projection->distance_m = sqrt(distance2);
+	projection->lateralOffset_m = cross < 0.0 ? -projection->distance_m : projection->distance_m;
+	projection->arcLength_m = index->arcLength_m[segment]
+			+ fraction * (index->arcLength_m[next] - index->arcLength_m[segment]);
+	projection->relativeTime.tv_sec = (time_t) (time_us / MICROSECONDS_PER_SECOND);
+	projection->relativeTime.tv_usec = (suseconds_t) (time_us % MICROSECONDS_PER_SECOND);
+	if (projection->relativeTime.tv_usec < 0) {
+		projection->relativeTime.tv_sec--;
+		projection->relativeTime.tv_usec += MICROSECONDS_PER_SECOND;
+	}
+}
+
+/*!
+ * \brief projectOntoSpatialIndex Finds the point of a trajectory nearest to a position, in
+ *			logarithmic time for positions near the trajectory
+ * \param index Index of the trajectory
+ * \param x_m Position
+ * \param y_m Position
+ * \param projection Nearest point, with the lateral offset, arc length and time at it
+ * \return 0 on success, -1 otherwise
+ */
+int projectOntoSpatialIndex(
+		const SpatialIndexType* index,
+		const double x_m,
+		const double y_m,
+		TrajectoryProjectionType* projection) {
+	size_t segment = SIZE_MAX;
+	double fraction = 0.0;
+
+	if (index == NULL || projection == NULL || !isfinite(x_m) || !isfinite(y_m)) {
+		errno = EINVAL;
+		return -1;
+	}
+	const double distance2 = findNearestSegment(index, x_m, y_m, &segment, &fraction);
+	fillProjection(index, segment, fraction, distance2, x_m, y_m, projection);
+	return 0;
+}
+
+/*!
+ * \brief projectManyOntoSpatialIndex Finds the points of a trajectory nearest to several positions.
+ *			The segment nearest to each position bounds the search for the next, which makes a
+ *			series of nearby positions, such as a recorded track, cheaper to project.
+ * \param index Index of the trajectory
+ * \param x_m Positions
+ * \param y_m Positions
+ * \param nPositions Number of positions
+ * \param projections Array of at least nPositions projections. Projections of positions which are
+ *			not finite are left unchanged.
+ * \return Number of positions projected
+ */
+size_t projectManyOntoSpatialIndex(
+		const SpatialIndexType* index,
+		const double x_m[],
+		const double y_m[],
+		const size_t nPositions,
+		TrajectoryProjectionType projections[]) {
+	size_t segment = SIZE_MAX, nProjected = 0;
+	double fraction = 0.0;
+
+	if (index == NULL || x_m == NULL || y_m == NULL || projections == NULL) {
+		errno = EINVAL;
+		return 0;
+	}
+	for (size_t i = 0; i < nPositions; ++i) {
+		if (!isfinite(x_m[i]) || !isfinite(y_m[i])) {
+			continue;
+		}
+		const double distance2 = findNearestSegment(index, x_m[i], y_m[i], &segment, &fraction);
+		fillProjection(index, segment, fraction, distance2, x_m[i], y_m[i], &projections[i]);
+		nProjected++;
+	}
+	return nProjected;
+}
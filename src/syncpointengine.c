@@ -0,0 +1,524 @@
+#include "syncpointengine.h"
+#include "spatialindex.h"
+#include "isoerror.h"
+#include "dynamicarray.h"
+#include "timeconversions.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SYNC_POINT_DEFAULT_UPDATE_PERIOD_US 100000
+//! Segments on either side of the predicted segment a position is projected onto
+#define SYNC_POINT_SEARCH_WINDOW 4
+//! Positions further than this from the predicted segments are reacquired through the spatial index
+#define SYNC_POINT_MAX_DEVIATION_M 5.0
+
+//! Trajectory of a master object, stored as columns indexed on both time and arc length
+typedef struct {
+	uint32_t transmitterID;
+	size_t nPoints;
+	int64_t* time_us;					//!< Time from start of trajectory, nondecreasing
+	double* x_m;
+	double* y_m;
+	double* arcLength_m;				//!< Distance along the trajectory, nondecreasing
+	SpatialIndexType* spatialIndex;		//!< For positions far from the predicted segments
+
+	bool isLocked;						//!< Whether the previous projection can be used as prediction
+	double projectedArcLength_m;
+	int64_t sampleTime_us;
+} SyncPointMasterType;
+
+typedef struct {
+	SyncPointType syncPoint;
+	int64_t masterTime_us;
+	double arcLength_m;
+	bool hasEstimate;
+	bool isPassed;
+	int64_t estimate_us;
+	double remainingDistance_m;
+	int64_t nextUpdate_us;
+} SyncPointStateType;
+
+struct SyncPointEngine {
+	int64_t updatePeriod_us;
+	SyncPointMasterType* masters;		//!< Sorted on transmitter ID
+	size_t nMasters, masterCapacity;
+	SyncPointStateType* syncPoints;		//!< Sorted on master transmitter ID
+	size_t nSyncPoints, syncPointCapacity;
+	SyncPointStatisticsType statistics;
+};
+
+/*!
+ * \brief createSyncPointEngine Creates an engine without master trajectories or sync points
+ * \param updatePeriod Time between MTSP updates to each slave, or NULL for 100 ms
+ * \return The engine, or NULL if it could not be allocated
+ */
+SyncPointEngineType* createSyncPointEngine(const struct timeval* updatePeriod) {
+	SyncPointEngineType* engine = calloc(1, sizeof (*engine));
+
+	if (engine == NULL) {
+		return NULL;
+	}
+	engine->updatePeriod_us = updatePeriod != NULL ? timevalToMicroseconds(updatePeriod)
+												   : SYNC_POINT_DEFAULT_UPDATE_PERIOD_US;
+	resetSyncPointEngine(engine);
+	return engine;
+}
+
+/*!
+ * \brief freeSyncPointEngine Frees an engine and all its trajectories and sync points
+ * \param engine Engine to free, may be NULL
+ */
+void freeSyncPointEngine(SyncPointEngineType* engine) {
+	if (engine == NULL) {
+		return;
+	}
+	for (size_t i = 0; i < engine->nMasters; ++i) {
+		free(engine->masters[i].time_us);
+		freeSpatialIndex(engine->masters[i].spatialIndex);
+	}
+	free(engine->masters);
+	free(engine->syncPoints);
+	free(engine);
+}
+
+/*!
+ * \brief resetSyncPointEngine Prepares an engine for a new test run. Trajectories and sync points
+ *			are kept, while master positions, estimates and statistics are cleared.
+ * \param engine Engine to reset
+ */
+void resetSyncPointEngine(SyncPointEngineType* engine) {
+	for (size_t i = 0; i < engine->nMasters; ++i) {
+		engine->masters[i].isLocked = false;
+	}
+	for (size_t i = 0; i < engine->nSyncPoints; ++i) {
+		engine->syncPoints[i].hasEstimate = false;
+		engine->syncPoints[i].isPassed = false;
+		engine->syncPoints[i].nextUpdate_us = INT64_MIN;
+	}
+	memset(&engine->statistics, 0, sizeof (engine->statistics));
+}
+
+/*!
+ * \brief findSyncPointMaster Finds the trajectory of a master object
+ * \param engine Engine to search
+ * \param transmitterID Master object to find
+ * \param index Index of the master, or where it would be inserted if not found
+ * \return The master, or NULL if it has no trajectory
+ */
+static SyncPointMasterType* findSyncPointMaster(
+		const SyncPointEngineType* engine,
+		const uint32_t transmitterID,
+		size_t* index) {
+	size_t low = 0, high = engine->nMasters;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (engine->masters[middle].transmitterID < transmitterID) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	*index = low;
+	return low < engine->nMasters && engine->masters[low].transmitterID == transmitterID ?
+				&engine->masters[low] : NULL;
+}
+
+//! Index of the first sync point of a master
+static size_t lowerBoundSyncPoint(const SyncPointEngineType* engine, const uint32_t masterTransmitterID) {
+	size_t low = 0, high = engine->nSyncPoints;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (engine->syncPoints[middle].syncPoint.masterTransmitterID < masterTransmitterID) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+//! Last segment starting at or before a time along a trajectory
+static size_t findSegmentByTime(const SyncPointMasterType* master, const int64_t time_us) {
+	size_t low = 1, high = master->nPoints - 1;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (master->time_us[middle] <= time_us) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low - 1;
+}
+
+//! Last segment starting at or before a distance along a trajectory
+static size_t findSegmentByArcLength(const SyncPointMasterType* master, const double arcLength_m) {
+	size_t low = 1, high = master->nPoints - 1;
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (master->arcLength_m[middle] <= arcLength_m) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low - 1;
+}
+
+/*!
+ * \brief locateSyncPoint Finds the distance along the master trajectory at which a sync point lies
+ * \param master Trajectory of the master, or NULL if it is not known
+ * \param state Sync point to locate
+ */
+static void locateSyncPoint(const SyncPointMasterType* master, SyncPointStateType* state) {
+	state->hasEstimate = false;
+	state->isPassed = false;
+	if (master == NULL) {
+		return;
+	}
+	const size_t i = findSegmentByTime(master, state->masterTime_us);
+	const int64_t duration_us = master->time_us[i + 1] - master->time_us[i];
+	double fraction = duration_us > 0 ? (double) (state->masterTime_us - master->time_us[i]) / (double) duration_us
+									  : 0.0;
+	fraction = fraction < 0.0 ? 0.0 : fraction > 1.0 ? 1.0 : fraction;
+	state->arcLength_m = master->arcLength_m[i] + fraction * (master->arcLength_m[i + 1] - master->arcLength_m[i]);
+}
+
+/*!
+ * \brief setSyncPointMasterTrajectory Sets the trajectory of a master object, replacing any previous one
+ * \param engine Engine to add the trajectory to
+ * \param masterTransmitterID Master object following the trajectory
+ * \param waypoints Trajectory, e.g. decoded from TRAJ, with nondecreasing times and valid positions
+ * \param nWaypoints Number of waypoints, at least two
+ * \return 0 on success, -1 otherwise with errno set to
+ *		EINVAL		if the trajectory cannot be indexed
+ *		ENOMEM		if memory could not be allocated
+ */
+int setSyncPointMasterTrajectory(
+		SyncPointEngineType* engine,
+		const uint32_t masterTransmitterID,
+		const TrajectoryWaypointType waypoints[],
+		const size_t nWaypoints) {
+	size_t index;
+
+	if (engine == NULL || waypoints == NULL || nWaypoints < 2) {
+		errno = EINVAL;
+		return -1;
+	}
+	for (size_t i = 0; i < nWaypoints; ++i) {
+		if (!waypoints[i].pos.isPositionValid
+				|| (i > 0 && timevalToMicroseconds(&waypoints[i].relativeTime) < timevalToMicroseconds(&waypoints[i - 1].relativeTime))) {
+			errno = EINVAL;
+			ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0,
+							 "Trajectory point %zu cannot be indexed by the sync point engine", i);
+			return -1;
+		}
+	}
+
+	// All columns share one allocation, the time column first
+	int64_t* columns = malloc(nWaypoints * (sizeof (int64_t) + 3 * sizeof (double)));
+	if (columns == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+	SyncPointMasterType trajectory;
+	memset(&trajectory, 0, sizeof (trajectory));
+	trajectory.transmitterID = masterTransmitterID;
+	trajectory.nPoints = nWaypoints;
+	trajectory.time_us = columns;
+	trajectory.x_m = (double*) (columns + nWaypoints);
+	trajectory.y_m = trajectory.x_m + nWaypoints;
+	trajectory.arcLength_m = trajectory.y_m + nWaypoints;
+	if ((trajectory.spatialIndex = createSpatialIndex(waypoints, nWaypoints)) == NULL) {
+		free(columns);
+		return -1;
+	}
+	for (size_t i = 0; i < nWaypoints; ++i) {
+		trajectory.time_us[i] = timevalToMicroseconds(&waypoints[i].relativeTime);
+		trajectory.x_m[i] = waypoints[i].pos.xCoord_m;
+		trajectory.y_m[i] = waypoints[i].pos.yCoord_m;
+		trajectory.arcLength_m[i] = i == 0 ? 0.0 : trajectory.arcLength_m[i - 1]
+					+ hypot(trajectory.x_m[i] - trajectory.x_m[i - 1], trajectory.y_m[i] - trajectory.y_m[i - 1]);
+	}
+
+	SyncPointMasterType* master = findSyncPointMaster(engine, masterTransmitterID, &index);
+	if (master != NULL) {
+		free(master->time_us);
+		freeSpatialIndex(master->spatialIndex);
+	}
+	else {
+		if (RESERVE(engine->masters, engine->nMasters, engine->masterCapacity) < 0) {
+			freeSpatialIndex(trajectory.spatialIndex);
+			free(columns);
+			return -1;
+		}
+		memmove(&engine->masters[index + 1], &engine->masters[index],
+				(engine->nMasters - index) * sizeof (engine->masters[0]));
+		engine->nMasters++;
+		master = &engine->masters[index];
+	}
+	*master = trajectory;
+
+	for (size_t i = lowerBoundSyncPoint(engine, masterTransmitterID);
+		 i < engine->nSyncPoints && engine->syncPoints[i].syncPoint.masterTransmitterID == masterTransmitterID; ++i) {
+		locateSyncPoint(master, &engine->syncPoints[i]);
+	}
+	return 0;
+}
+
+/*!
+ * \brief addSyncPoint Adds a sync point for which estimates are sent to a slave. The trajectory
+ *			of the master may be set before or after.
+ * \param engine Engine to add the sync point to
+ * \param syncPoint Sync point to add, copied into the engine
+ * \return 0 on success, -1 otherwise
+ */
+int addSyncPoint(
+		SyncPointEngineType* engine,
+		const SyncPointType* syncPoint) {
+	size_t index;
+
+	if (engine == NULL || syncPoint == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (RESERVE(engine->syncPoints, engine->nSyncPoints, engine->syncPointCapacity) < 0) {
+		return -1;
+	}
+	size_t insertAt = engine->nSyncPoints;
+	while (insertAt > 0 && engine->syncPoints[insertAt - 1].syncPoint.masterTransmitterID > syncPoint->masterTransmitterID) {
+		engine->syncPoints[insertAt] = engine->syncPoints[insertAt - 1];
+		insertAt--;
+	}
+	engine->nSyncPoints++;
+
+	SyncPointStateType* state = &engine->syncPoints[insertAt];
+	memset(state, 0, sizeof (*state));
+	state->syncPoint = *syncPoint;
+	state->masterTime_us = timevalToMicroseconds(&syncPoint->masterTime);
+	state->nextUpdate_us = INT64_MIN;
+	locateSyncPoint(findSyncPointMaster(engine, syncPoint->masterTransmitterID, &index), state);
+	return 0;
+}
+
+//! Squared distance from a position to a trajectory segment, and the fraction of the segment at which it is closest
+static inline double projectOntoSegment(const SyncPointMasterType* master, const size_t i,
+										const double x, const double y, double* fraction) {
+	const double dx = master->x_m[i + 1] - master->x_m[i];
+	const double dy = master->y_m[i + 1] - master->y_m[i];
+	const double length2 = dx * dx + dy * dy;
+	double f = length2 > 0.0 ? ((x - master->x_m[i]) * dx + (y - master->y_m[i]) * dy) / length2 : 0.0;
+
+	f = f < 0.0 ? 0.0 : f > 1.0 ? 1.0 : f;
+	*fraction = f;
+	const double ex = master->x_m[i] + f * dx - x;
+	const double ey = master->y_m[i] + f * dy - y;
+	return ex * ex + ey * ey;
+}
+
+//! Segment among a range closest to a position, of equally close segments the one nearest a preferred segment
+static double projectOntoSegments(const SyncPointMasterType* master, const size_t first, const size_t last,
+								  const size_t preferred, const double x, const double y,
+								  size_t* segment, double* fraction) {
+	double bestDistance2 = INFINITY;
+	size_t bestOffset = SIZE_MAX;
+
+	for (size_t i = first; i <= last; ++i) {
+		double f;
+		const double distance2 = projectOntoSegment(master, i, x, y, &f);
+		const size_t offset = i > preferred ? i - preferred : preferred - i;
+		if (distance2 < bestDistance2 || (distance2 == bestDistance2 && offset < bestOffset)) {
+			bestOffset = offset;
+			bestDistance2 = distance2;
+			*segment = i;
+			*fraction = f;
+		}
+	}
+	return bestDistance2;
+}
+
+/*!
+ * \brief projectMasterPosition Finds the point on the trajectory of a master closest to its position.
+ *			The distance travelled since the previous sample predicts the segment, found by binary search
+ *			on arc length, and only segments around it are tested. A position far from all of them, or
+ *			the first position, is reacquired through the spatial index of the trajectory in logarithmic
+ *			time. Where the trajectory overlaps itself, the segment nearest the prediction is chosen.
+ * \param engine Engine counting tested segments
+ * \param master Master trajectory
+ * \param x Position of the master
+ * \param y Position of the master
+ * \param speed_m_s Longitudinal speed of the master, or NAN if not known
+ * \param sampleTime_us Time of the position
+ * \return Time along the trajectory of the projected point
+ */
+static int64_t projectMasterPosition(SyncPointEngineType* engine, SyncPointMasterType* master,
+									 const double x, const double y, const double speed_m_s,
+									 const int64_t sampleTime_us) {
+	const size_t lastSegment = master->nPoints - 2;
+	size_t segment = 0;
+	double fraction = 0.0;
+	double distance2 = INFINITY;
+
+	if (master->isLocked) {
+		double predicted_m = master->projectedArcLength_m;
+		if (!isnan(speed_m_s) && sampleTime_us > master->sampleTime_us) {
+			predicted_m += speed_m_s * (double) (sampleTime_us - master->sampleTime_us) / MICROSECONDS_PER_SECOND;
+		}
+		const size_t predicted = findSegmentByArcLength(master, predicted_m);
+		const size_t first = predicted > SYNC_POINT_SEARCH_WINDOW ? predicted - SYNC_POINT_SEARCH_WINDOW : 0;
+		const size_t last = predicted + SYNC_POINT_SEARCH_WINDOW < lastSegment ?
+					predicted + SYNC_POINT_SEARCH_WINDOW : lastSegment;
+		distance2 = projectOntoSegments(master, first, last, predicted, x, y, &segment, &fraction);
+		engine->statistics.nSegmentsTested += last - first + 1;
+	}
+	if (distance2 > SYNC_POINT_MAX_DEVIATION_M * SYNC_POINT_MAX_DEVIATION_M) {
+		TrajectoryProjectionType projection;
+		projectOntoSpatialIndex(master->spatialIndex, x, y, &projection);
+		segment = projection.segment < lastSegment ? projection.segment : lastSegment;
+		projectOntoSegment(master, segment, x, y, &fraction);
+		engine->statistics.nSegmentsTested++;
+		engine->statistics.nReacquisitions++;
+	}
+
+	master->isLocked = true;
+	master->projectedArcLength_m = master->arcLength_m[segment]
+			+ fraction * (master->arcLength_m[segment + 1] - master->arcLength_m[segment]);
+	master->sampleTime_us = sampleTime_us;
+	return master->time_us[segment]
+			+ (int64_t) llround(fraction * (double) (master->time_us[segment + 1] - master->time_us[segment]));
+}
+
+/*!
+ * \brief processSyncPointMonitorData Projects the latest position of a master object onto its
+ *			trajectory, and estimates when it will pass each of its sync points. Monitor data of
+ *			objects without a trajectory is ignored.
+ * \param engine Engine holding the trajectories
+ * \param transmitterID Object the monitor data is from
+ * \param monitorData Monitor data, e.g. decoded from MONR. Invalid positions are not projected.
+ * \param receiveTime Time the monitor data was received, used if it has no valid timestamp
+ * \return Number of sync point estimates updated, or -1 on error
+ */
+int processSyncPointMonitorData(
+		SyncPointEngineType* engine,
+		const uint32_t transmitterID,
+		const ObjectMonitorType* monitorData,
+		const struct timeval* receiveTime) {
+	size_t index;
+	int nUpdated = 0;
+
+	if (engine == NULL || monitorData == NULL || receiveTime == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	engine->statistics.nMonitorSamples++;
+
+	SyncPointMasterType* master = findSyncPointMaster(engine, transmitterID, &index);
+	if (master == NULL || !monitorData->position.isPositionValid) {
+		return 0;
+	}
+	const int64_t sampleTime_us = monitorData->isTimestampValid ? timevalToMicroseconds(&monitorData->timestamp)
+																: timevalToMicroseconds(receiveTime);
+	const int64_t trajectoryTime_us = projectMasterPosition(
+				engine, master, monitorData->position.xCoord_m, monitorData->position.yCoord_m,
+				monitorData->speed.isLongitudinalValid ? monitorData->speed.longitudinal_m_s : NAN, sampleTime_us);
+
+	for (size_t i = lowerBoundSyncPoint(engine, transmitterID);
+		 i < engine->nSyncPoints && engine->syncPoints[i].syncPoint.masterTransmitterID == transmitterID; ++i) {
+		SyncPointStateType* state = &engine->syncPoints[i];
+		state->estimate_us = sampleTime_us + state->masterTime_us - trajectoryTime_us;
+		state->remainingDistance_m = state->arcLength_m - master->projectedArcLength_m;
+		state->isPassed = trajectoryTime_us >= state->masterTime_us;
+		state->hasEstimate = true;
+		nUpdated++;
+	}
+	return nUpdated;
+}
+
+static inline bool isSyncPointUpdatePending(const SyncPointStateType* state) {
+	return state->hasEstimate && !state->isPassed;
+}
+
+/*!
+ * \brief getNextSyncPointDeadline Gets the time at which the next MTSP is due to be sent, e.g. for
+ *			arming a timer
+ * \param engine Engine holding the sync points
+ * \param deadline Time at which ::popDueSyncPointUpdates will next return an update
+ * \return 0 if an update is pending, -1 otherwise
+ */
+int getNextSyncPointDeadline(
+		const SyncPointEngineType* engine,
+		struct timeval* deadline) {
+	int64_t earliest_us = INT64_MAX;
+
+	if (engine == NULL || deadline == NULL) {
+		return -1;
+	}
+	for (size_t i = 0; i < engine->nSyncPoints; ++i) {
+		const SyncPointStateType* state = &engine->syncPoints[i];
+		if (isSyncPointUpdatePending(state) && state->nextUpdate_us < earliest_us) {
+			earliest_us = state->nextUpdate_us;
+		}
+	}
+	if (earliest_us == INT64_MAX) {
+		return -1;
+	}
+	*deadline = earliest_us == INT64_MIN ? (struct timeval) { 0, 0 } : microsecondsToTimeval(earliest_us);
+	return 0;
+}
+
+/*!
+ * \brief popDueSyncPointUpdates Gets the latest estimates of sync points whose MTSP update is due,
+ *			and schedules their next update one period later. Sync points the master has passed are
+ *			no longer updated. Each update can be encoded with ::encodeMTSPMessage.
+ * \param engine Engine holding the sync points
+ * \param currentTime Current time
+ * \param updates Array in which to store the due updates
+ * \param maxUpdates Number of updates the array can hold
+ * \return Number of updates stored
+ */
+size_t popDueSyncPointUpdates(
+		SyncPointEngineType* engine,
+		const struct timeval* currentTime,
+		SyncPointUpdateType updates[],
+		const size_t maxUpdates) {
+	const int64_t currentTime_us = timevalToMicroseconds(currentTime);
+	size_t nDue = 0;
+
+	for (size_t i = 0; i < engine->nSyncPoints && nDue < maxUpdates; ++i) {
+		SyncPointStateType* state = &engine->syncPoints[i];
+		if (!isSyncPointUpdatePending(state) || state->nextUpdate_us > currentTime_us) {
+			continue;
+		}
+		SyncPointUpdateType* update = &updates[nDue++];
+		update->syncPointID = state->syncPoint.syncPointID;
+		update->masterTransmitterID = state->syncPoint.masterTransmitterID;
+		update->slaveTransmitterID = state->syncPoint.slaveTransmitterID;
+		update->estSyncPointTime = microsecondsToTimeval(state->estimate_us);
+		update->remainingDistance_m = state->remainingDistance_m;
+
+		// Keep to the update rate, unless updates have been delayed by more than a period
+		state->nextUpdate_us = state->nextUpdate_us != INT64_MIN
+				&& state->nextUpdate_us + engine->updatePeriod_us > currentTime_us ?
+					state->nextUpdate_us + engine->updatePeriod_us : currentTime_us + engine->updatePeriod_us;
+	}
+	engine->statistics.nUpdates += nDue;
+	return nDue;
+}
+
+/*!
+ * \brief getSyncPointStatistics Gets counters of projected samples and updates since the engine
+ *			was created or reset
+ * \param engine Engine to read
+ * \return Statistics of the engine
+ */
+SyncPointStatisticsType getSyncPointStatistics(const SyncPointEngineType* engine) {
+	return engine->statistics;
+}
@@ -74,3 +74,29 @@ int64_t getAsGPSQuarterMillisecondOfWeek(const struct timeval * time) {
 
 	return (int64_t) (GPSqms % WEEK_TIME_QMS);
 }
+
+/*!
+ * \brief timevalToMicroseconds Converts a timestamp or duration into microseconds
+ * \param time Timestamp or duration
+ * \return Time represented as microseconds
+ */
+int64_t timevalToMicroseconds(const struct timeval * time) {
+	return (int64_t) time->tv_sec * MICROSECONDS_PER_SECOND + (int64_t) time->tv_usec;
+}
+
+/*!
+ * \brief microsecondsToTimeval Converts microseconds into a timestamp or duration, with
+ *			microseconds in [0, 1 s) also for negative times
+ * \param time_us Time represented as microseconds
+ * \return Timestamp or duration
+ */
+struct timeval microsecondsToTimeval(const int64_t time_us) {
+	struct timeval time;
+	time.tv_sec = (time_t) (time_us / MICROSECONDS_PER_SECOND);
+	time.tv_usec = (suseconds_t) (time_us % MICROSECONDS_PER_SECOND);
+	if (time.tv_usec < 0) {
+		time.tv_sec--;
+		time.tv_usec += MICROSECONDS_PER_SECOND;
+	}
+	return time;
+}
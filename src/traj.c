@@ -1,16 +1,32 @@
 #include "traj.h"
 #include "iohelpers.h"
 #include "iso22133.h"
+#include "isoerror.h"
+#include "timeconversions.h"
+#include "codeccontext.h"
+#include "vendorregistry.h"
 #include <errno.h>
 #include <string.h>
 
-static uint16_t trajectoryMessageCrc = 0;
+
+static enum ISOMessageReturnValue convertTRAJHeaderToHostRepresentation(TRAJHeaderType* TRAJHeaderData,
+				uint32_t trajectoryLength,	TrajectoryHeaderType* trajectoryHeaderData);
 
 //! TRAJ header field descriptions
 static DebugStrings_t TRAJIdentifierDescription = 	{"Trajectory ID",	"",	&printU32};
 static DebugStrings_t TRAJNameDescription = 		{"Trajectory name",	"",	&printString};
 static DebugStrings_t TRAJInfoDescription = 		{"Trajectory info",	"",	&printU8};
 
+/*!
+ * \brief getEncodedSizeTRAJMessage Get the size of an encoded TRAJ message
+ * \param numberOfPointsInTraj Number of trajectory points in the message
+ * \return Total number of bytes written by ::encodeTRAJMessageHeader, ::encodeTRAJMessagePoint
+ *		and ::encodeTRAJMessageFooter
+ */
+size_t getEncodedSizeTRAJMessage(const uint32_t numberOfPointsInTraj) {
+	return sizeof (TRAJHeaderType) + numberOfPointsInTraj * sizeof (TRAJPointType) + sizeof (TRAJFooterType);
+}
+
 /*!
  * \brief encodeTRAJMessageHeader Creates a TRAJ message header based on supplied values and resets
  *	an internal CRC to be used in the corresponding footer. The header is printed to a buffer.
@@ -41,31 +57,33 @@ ssize_t encodeTRAJMessageHeader(
 {
 
 	TRAJHeaderType TRAJData;
+	uint16_t* trajectoryMessageCrc = getCodecTrajectoryCRC(getActiveCodecContext());
 	char* p = trajDataBuffer;
 	size_t remainingBytes = bufferLength;
 	int retval = 0;
 
-	memset(trajDataBuffer, 0, bufferLength);
-
 	// Error guarding
 	if (trajectoryName == NULL && nameLength > 0) {
 		errno = EINVAL;
-		printf("Trajectory name length and pointer mismatch\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0,
+						 "Trajectory name length and pointer mismatch");
 		return -1;
 	}
 	else if (trajDataBuffer == NULL) {
 		errno = EINVAL;
-		printf("Trajectory data buffer invalid\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Trajectory data buffer invalid");
 		return -1;
 	}
 	else if (bufferLength < sizeof (TRAJHeaderType)) {
 		errno = ENOBUFS;
-		printf("Buffer too small to hold necessary TRAJ header data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRAJ, 0,
+						 "Buffer too small to hold necessary TRAJ header data");
 		return -1;
 	}
 	else if (nameLength >= sizeof (TRAJData.trajectoryName)) {
 		errno = EMSGSIZE;
-		printf("Trajectory name <%s> too long for TRAJ message\n", trajectoryName);
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRAJ, 0,
+						 "Trajectory name <%s> too long for TRAJ message", trajectoryName);
 		return -1;
 	}
 	
@@ -73,9 +91,7 @@ ssize_t encodeTRAJMessageHeader(
 	TRAJData.header = buildISOHeader(
 		MESSAGE_ID_TRAJ,
 		inputHeader,
-		sizeof (TRAJHeaderType)
-			+ numberOfPointsInTraj * sizeof (TRAJPointType)
-			+ sizeof (TRAJFooterType),
+		getEncodedSizeTRAJMessage(numberOfPointsInTraj),
 		debug);
 	memcpy(p, &TRAJData.header, sizeof(TRAJData.header));
 	p += sizeof (HeaderType);
@@ -118,15 +134,14 @@ ssize_t encodeTRAJMessageHeader(
 	TRAJData.trajectoryNameContentLength = htole16(TRAJData.trajectoryNameContentLength);
 
 	// Reset CRC
-	trajectoryMessageCrc = DEFAULT_CRC_INIT_VALUE;
+	*trajectoryMessageCrc = DEFAULT_CRC_INIT_VALUE;
 
 	// Update CRC
 	size_t dataLen = p - trajDataBuffer;
 	char* crcPtr = trajDataBuffer;
 	while (dataLen-- > 0) {
-		trajectoryMessageCrc = crcByte(trajectoryMessageCrc, (uint8_t) (*crcPtr++));
+		*trajectoryMessageCrc = crcByte(*trajectoryMessageCrc, (uint8_t) (*crcPtr++));
 	}
-	printf("CRC hdr %x\n",trajectoryMessageCrc);
 	return retval ? retval : p - trajDataBuffer;
 }
 
@@ -156,7 +171,8 @@ ssize_t decodeTRAJMessageHeader(
 
 	if (trajDataBuffer == NULL || trajHeader == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointers to TRAJ header parsing function cannot be null\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0,
+						 "Input pointers to TRAJ header parsing function cannot be null");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -171,7 +187,8 @@ ssize_t decodeTRAJMessageHeader(
 
 	// If message is not a  message, generate an error
 	if (TRAJHeaderData.header.messageID != MESSAGE_ID_TRAJ) {
-		fprintf(stderr, "Attempted to pass non-TRAJ message into TRAJ header parsing function\n");
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_TRAJ, (size_t) (p - trajDataBuffer),
+						 "Attempted to pass non-TRAJ message into TRAJ header parsing function");
 		return MESSAGE_TYPE_ERROR;
 	}
 
@@ -205,14 +222,16 @@ ssize_t decodeTRAJMessageHeader(
 			break;
 
 		default:
-			fprintf(stderr, "Value ID 0x%x does not match any known TRAJ header value IDs", valueID);
+			ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_TRAJ, (size_t) (p - trajDataBuffer),
+							 "Value ID 0x%x does not match any known TRAJ header value IDs", valueID);
 			return MESSAGE_VALUE_ID_ERROR;
 		}
 
 		p += contentLength;
 		if (contentLength != expectedContentLength) {
-			fprintf(stderr, "Content length %u for value ID 0x%x does not match the expected %ld",
-					contentLength, valueID, expectedContentLength);
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRAJ, (size_t) (p - trajDataBuffer),
+							 "Content length %u for value ID 0x%x does not match the expected %ld",
+							 contentLength, valueID, expectedContentLength);
 			return MESSAGE_LENGTH_ERROR;
 		}
 	}
@@ -241,7 +260,7 @@ enum ISOMessageReturnValue convertTRAJHeaderToHostRepresentation(TRAJHeaderType*
 				uint32_t trajectoryLength,	TrajectoryHeaderType* trajectoryHeaderData) {
 	if (TRAJHeaderData == NULL || trajectoryHeaderData == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "TRAJ header input pointer error");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "TRAJ header input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
@@ -255,85 +274,139 @@ enum ISOMessageReturnValue convertTRAJHeaderToHostRepresentation(TRAJHeaderType*
 }
 
 /*!
- * \brief encodeTRAJMessagePoint Creates a TRAJ message point based on supplied values and updates an internal
- * CRC to be used in the footer. Also prints the TRAJ point to a buffer.
- * \param pointTimeFromStart Time from start of the trajectory point
+ * \brief convertTRAJPointToISORepresentation Scales a trajectory point to the fixed point fields of a TRAJ
+ *			point, in host byte order
+ * \param pointTimeFromStart Time of the point relative to the start of the trajectory
  * \param position Position of the point
  * \param speed Speed at the point
  * \param acceleration Acceleration at the point
  * \param curvature Curvature of the trajectory at the point
- * \param trajDataBufferPointer Buffer to which the message is to be printed
- * \param remainingBufferLength Remaining bytes in the buffer to which the message is to be printed
- * \param debug Flag for enabling debugging
- * \return Number of bytes printed, or -1 in case of error with the following errnos:
- *		EINVAL		if one of the input parameters are invalid
- *		ENOBUFS		if supplied buffer is too small to hold point
+ * \param TRAJPointData Output data struct, including value ID and content length
+ * \return Value according to ::ISOMessageReturnValue, with errno set to EINVAL if a required field is missing
  */
-ssize_t encodeTRAJMessagePoint(const struct timeval *pointTimeFromStart, const CartesianPosition position,
-							   const SpeedType speed, const AccelerationType acceleration,
-							   const float curvature, char *trajDataBufferPointer,
-							   const size_t remainingBufferLength, const char debug) {
-	TRAJPointType TRAJData;
-	size_t dataLen;
-
-	if (remainingBufferLength < sizeof (TRAJPointType)) {
-		errno = ENOBUFS;
-		printf("Buffer too small to hold necessary TRAJ point data\n");
-		return -1;
-	}
-	else if (trajDataBufferPointer == NULL) {
-		errno = EINVAL;
-		printf("Trajectory data buffer invalid\n");
-		return -1;
-	}
-
-	TRAJData.trajectoryPointValueID = VALUE_ID_TRAJ_POINT;
-	TRAJData.trajectoryPointContentLength = sizeof (TRAJData) - sizeof (TRAJData.trajectoryPointValueID)
-											- sizeof (TRAJData.trajectoryPointContentLength);
+enum ISOMessageReturnValue convertTRAJPointToISORepresentation(
+		const struct timeval* pointTimeFromStart,
+		const CartesianPosition position,
+		const SpeedType speed,
+		const AccelerationType acceleration,
+		const float curvature,
+		TRAJPointType* TRAJPointData) {
+	TRAJPointData->trajectoryPointValueID = VALUE_ID_TRAJ_POINT;
+	TRAJPointData->trajectoryPointContentLength = sizeof (*TRAJPointData)
+		- sizeof (TRAJPointData->trajectoryPointValueID) - sizeof (TRAJPointData->trajectoryPointContentLength);
 	// Fill contents
-	TRAJData.relativeTime =
+	TRAJPointData->relativeTime =
 		(uint32_t) (((double)(pointTimeFromStart->tv_sec) + pointTimeFromStart->tv_usec / 1000000.0)
 					* RELATIVE_TIME_ONE_SECOND_VALUE);
 
 	if (position.isPositionValid) {
-		TRAJData.xPosition = (int32_t) (position.xCoord_m * POSITION_ONE_METER_VALUE);
-		TRAJData.yPosition = (int32_t) (position.yCoord_m * POSITION_ONE_METER_VALUE);
-		TRAJData.zPosition = (int32_t) (position.zCoord_m * POSITION_ONE_METER_VALUE);
+		TRAJPointData->xPosition = (int32_t) (position.xCoord_m * POSITION_ONE_METER_VALUE);
+		TRAJPointData->yPosition = (int32_t) (position.yCoord_m * POSITION_ONE_METER_VALUE);
+		TRAJPointData->zPosition = (int32_t) (position.zCoord_m * POSITION_ONE_METER_VALUE);
 	}
 	else {
 		errno = EINVAL;
-		printf("Position is a required field in TRAJ messages\n");
-		return -1;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0,
+						 "Position is a required field in TRAJ messages");
+		return ISO_FUNCTION_ERROR;
 	}
 
 	if (position.isHeadingValid) {
-		TRAJData.yaw = (uint16_t) (position.heading_rad * 180.0 / M_PI * YAW_ONE_DEGREE_VALUE);
+		TRAJPointData->yaw = (uint16_t) (position.heading_rad * 180.0 / M_PI * YAW_ONE_DEGREE_VALUE);
 	}
 	else {
-		TRAJData.yaw = YAW_UNAVAILABLE_VALUE;
+		TRAJPointData->yaw = YAW_UNAVAILABLE_VALUE;
 	}
 
 	if (speed.isLongitudinalValid) {
-		TRAJData.longitudinalSpeed = (int16_t) (speed.longitudinal_m_s * SPEED_ONE_METER_PER_SECOND_VALUE);
+		TRAJPointData->longitudinalSpeed = (int16_t) (speed.longitudinal_m_s * SPEED_ONE_METER_PER_SECOND_VALUE);
 	}
 	else {
 		errno = EINVAL;
-		printf("Longitudinal speed is a required field in TRAJ messages\n");
-		return -1;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0,
+						 "Longitudinal speed is a required field in TRAJ messages");
+		return ISO_FUNCTION_ERROR;
 	}
-	TRAJData.lateralSpeed =
+	TRAJPointData->lateralSpeed =
 		speed.isLateralValid ? (int16_t) (speed.lateral_m_s *
 										  SPEED_ONE_METER_PER_SECOND_VALUE) : SPEED_UNAVAILABLE_VALUE;
 
-	TRAJData.longitudinalAcceleration = acceleration.isLongitudinalValid ?
+	TRAJPointData->longitudinalAcceleration = acceleration.isLongitudinalValid ?
 		(int16_t) (acceleration.longitudinal_m_s2 *
 				   ACCELERATION_ONE_METER_PER_SECOND_SQUARED_VALUE) : ACCELERATION_UNAVAILABLE_VALUE;
-	TRAJData.lateralAcceleration =
+	TRAJPointData->lateralAcceleration =
 		acceleration.isLateralValid ? (int16_t) (acceleration.lateral_m_s2 *
 												 ACCELERATION_ONE_METER_PER_SECOND_SQUARED_VALUE) :
 		ACCELERATION_UNAVAILABLE_VALUE;
 
-	TRAJData.curvature = curvature;
+	TRAJPointData->curvature = curvature;
+	return MESSAGE_OK;
+}
+
+/*!
+ * \brief writeTRAJPoint Prints a TRAJ point in host byte order to a buffer in little endian
+ * \param TRAJPointData Point to print, as filled by ::convertTRAJPointToISORepresentation
+ * \param trajDataBufferPointer Buffer with room for a TRAJ point
+ */
+void writeTRAJPoint(const TRAJPointType* TRAJPointData, char* trajDataBufferPointer) {
+	TRAJPointType TRAJData = *TRAJPointData;
+
+	// Convert from host endianness to little endian
+	TRAJData.trajectoryPointValueID = htole16(TRAJData.trajectoryPointValueID);
+	TRAJData.trajectoryPointContentLength = htole16(TRAJData.trajectoryPointContentLength);
+	TRAJData.relativeTime = htole32(TRAJData.relativeTime);
+	TRAJData.xPosition = (int32_t) htole32(TRAJData.xPosition);
+	TRAJData.yPosition = (int32_t) htole32(TRAJData.yPosition);
+	TRAJData.zPosition = (int32_t) htole32(TRAJData.zPosition);
+	TRAJData.yaw = htole16(TRAJData.yaw);
+	TRAJData.longitudinalSpeed = (int16_t) htole16(TRAJData.longitudinalSpeed);
+	TRAJData.lateralSpeed = (int16_t) htole16(TRAJData.lateralSpeed);
+	TRAJData.longitudinalAcceleration = (int16_t) htole16(TRAJData.longitudinalAcceleration);
+	TRAJData.lateralAcceleration = (int16_t) htole16(TRAJData.lateralAcceleration);
+	TRAJData.curvature = htolef(TRAJData.curvature);
+
+	memcpy(trajDataBufferPointer, &TRAJData, sizeof (TRAJData));
+}
+
+/*!
+ * \brief encodeTRAJMessagePoint Creates a TRAJ message point based on supplied values and updates an internal
+ * CRC to be used in the footer. Also prints the TRAJ point to a buffer.
+ * \param pointTimeFromStart Time from start of the trajectory point
+ * \param position Position of the point
+ * \param speed Speed at the point
+ * \param acceleration Acceleration at the point
+ * \param curvature Curvature of the trajectory at the point
+ * \param trajDataBufferPointer Buffer to which the message is to be printed
+ * \param remainingBufferLength Remaining bytes in the buffer to which the message is to be printed
+ * \param debug Flag for enabling debugging
+ * \return Number of bytes printed, or -1 in case of error with the following errnos:
+ *		EINVAL		if one of the input parameters are invalid
+ *		ENOBUFS		if supplied buffer is too small to hold point
+ */
+ssize_t encodeTRAJMessagePoint(const struct timeval *pointTimeFromStart, const CartesianPosition position,
+							   const SpeedType speed, const AccelerationType acceleration,
+							   const float curvature, char *trajDataBufferPointer,
+							   const size_t remainingBufferLength, const char debug) {
+	TRAJPointType TRAJData;
+	uint16_t* trajectoryMessageCrc = getCodecTrajectoryCRC(getActiveCodecContext());
+	size_t dataLen;
+
+	if (remainingBufferLength < sizeof (TRAJPointType)) {
+		errno = ENOBUFS;
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRAJ, 0,
+						 "Buffer too small to hold necessary TRAJ point data");
+		return -1;
+	}
+	else if (trajDataBufferPointer == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Trajectory data buffer invalid");
+		return -1;
+	}
+
+	if (convertTRAJPointToISORepresentation(pointTimeFromStart, position, speed, acceleration, curvature,
+											&TRAJData) != MESSAGE_OK) {
+		return -1;
+	}
 
 	if (debug) {
 		printf("TRAJ message point:\n\t"
@@ -362,28 +435,13 @@ ssize_t encodeTRAJMessagePoint(const struct timeval *pointTimeFromStart, const C
 			   (double_t) TRAJData.curvature);
 	}
 
-	// Convert from host endianness to little endian
-	TRAJData.trajectoryPointValueID = htole16(TRAJData.trajectoryPointValueID);
-	TRAJData.trajectoryPointContentLength = htole16(TRAJData.trajectoryPointContentLength);
-	TRAJData.relativeTime = htole32(TRAJData.relativeTime);
-	TRAJData.xPosition = (int32_t) htole32(TRAJData.xPosition);
-	TRAJData.yPosition = (int32_t) htole32(TRAJData.yPosition);
-	TRAJData.zPosition = (int32_t) htole32(TRAJData.zPosition);
-	TRAJData.yaw = htole16(TRAJData.yaw);
-	TRAJData.longitudinalSpeed = (int16_t) htole16(TRAJData.longitudinalSpeed);
-	TRAJData.lateralSpeed = (int16_t) htole16(TRAJData.lateralSpeed);
-	TRAJData.longitudinalAcceleration = (int16_t) htole16(TRAJData.longitudinalAcceleration);
-	TRAJData.lateralAcceleration = (int16_t) htole16(TRAJData.lateralAcceleration);
-	TRAJData.curvature = htolef(TRAJData.curvature);
-
-	memcpy(trajDataBufferPointer, &TRAJData, sizeof (TRAJData));
+	writeTRAJPoint(&TRAJData, trajDataBufferPointer);
 
 	// Update CRC
 	dataLen = sizeof (TRAJData);
 	while (dataLen-- > 0) {
-		trajectoryMessageCrc = crcByte(trajectoryMessageCrc, (uint8_t) (*trajDataBufferPointer++));
+		*trajectoryMessageCrc = crcByte(*trajectoryMessageCrc, (uint8_t) (*trajDataBufferPointer++));
 	}
-	printf("CRC: %x\n", trajectoryMessageCrc);
 	return sizeof (TRAJData);
 }
 
@@ -404,17 +462,19 @@ ssize_t encodeTRAJMessageFooter(
 	const char debug) {
 
 	TRAJFooterType TRAJData;
+	uint16_t* trajectoryMessageCrc = getCodecTrajectoryCRC(getActiveCodecContext());
 	ssize_t dataLen = 0;
 	char* p = trajDataBuffer;
 
 	if (remainingBufferLength < sizeof (TRAJFooterType)) {
 		errno = ENOBUFS;
-		printf("Buffer too small to hold TRAJ footer data\n");
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRAJ, 0,
+						 "Buffer too small to hold TRAJ footer data");
 		return -1;
 	}
 	else if (trajDataBuffer == NULL) {
 		errno = EINVAL;
-		printf("Invalid trajectory data buffer supplied\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Invalid trajectory data buffer supplied");
 		return -1;
 	}
 	TRAJData.lineInfoValueID = VALUE_ID_TRAJ_LINE_INFO;
@@ -430,10 +490,10 @@ ssize_t encodeTRAJMessageFooter(
 	dataLen = p - trajDataBuffer;
 	char* crcPtr = trajDataBuffer;
 	while (dataLen-- > 0) {
-		trajectoryMessageCrc = crcByte(trajectoryMessageCrc, (uint8_t) (*crcPtr++));
+		*trajectoryMessageCrc = crcByte(*trajectoryMessageCrc, (uint8_t) (*crcPtr++));
 	}
 
-	TRAJData.footer.Crc = trajectoryMessageCrc;
+	TRAJData.footer.Crc = *trajectoryMessageCrc;
 	TRAJData.footer.Crc = le16toh(TRAJData.footer.Crc);
 	memcpy(p, &TRAJData.footer, sizeof(TRAJData.footer));
 	p += sizeof(TRAJData.footer);
@@ -446,24 +506,214 @@ ssize_t encodeTRAJMessageFooter(
 }
 
 
+//! Reads point \a index of a trajectory, returning 0 or -1 with errno set
+typedef int (*TRAJPointReaderType)(const void* trajectory, const uint32_t index, TrajectoryWaypointType* point);
+
 /*!
- * \brief decodeTRAJMessagePoint
- * \param trajHeader Output data struct, to be used by host
- * \param trajDataBuffer Received trajectory data buffer
- * \param bufferLength Length of trajDataBuffer
+ * \brief encodeTRAJMessagePoints Prints a complete TRAJ message to a buffer, reading its points
+ *			one at a time so that any trajectory representation can share the encoding
+ * \param trajectory Trajectory passed to readPoint
+ * \param readPoint Function filling in each point of the trajectory
+ * \param nPoints Number of points in the trajectory
+ * \return Number of bytes printed, or -1 in case of error with errno set
+ */
+static ssize_t encodeTRAJMessagePoints(
+		const MessageHeaderType* inputHeader,
+		const uint16_t trajectoryID,
+		const TrajectoryInfoType trajectoryInfo,
+		const char* trajectoryName,
+		const size_t nameLength,
+		const void* trajectory,
+		const TRAJPointReaderType readPoint,
+		const uint32_t nPoints,
+		char* trajDataBuffer,
+		const size_t bufferLength,
+		const char debug) {
+	char* p = trajDataBuffer;
+	size_t remainingBytes = bufferLength;
+	TrajectoryWaypointType point;
+	ssize_t retval;
+
+	if (bufferLength < getEncodedSizeTRAJMessage(nPoints)) {
+		errno = ENOBUFS;
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRAJ, 0, "Buffer too small to hold TRAJ message");
+		return -1;
+	}
+	if ((retval = encodeTRAJMessageHeader(inputHeader, trajectoryID, trajectoryInfo, trajectoryName, nameLength,
+										  nPoints, p, remainingBytes, debug)) < 0) {
+		return -1;
+	}
+	p += retval;
+	remainingBytes -= (size_t) retval;
+	for (uint32_t i = 0; i < nPoints; ++i) {
+		if (readPoint(trajectory, i, &point) < 0
+				|| (retval = encodeTRAJMessagePoint(&point.relativeTime, point.pos, point.spd, point.acc,
+													point.curvature, p, remainingBytes, debug)) < 0) {
+			return -1;
+		}
+		p += retval;
+		remainingBytes -= (size_t) retval;
+	}
+	if ((retval = encodeTRAJMessageFooter(p, remainingBytes, debug)) < 0) {
+		return -1;
+	}
+	return p + retval - trajDataBuffer;
+}
+
+static int readWaypoint(const void* trajectory, const uint32_t index, TrajectoryWaypointType* point) {
+	*point = ((const TrajectoryWaypointType*) trajectory)[index];
+	return 0;
+}
+
+/*!
+ * \brief encodeTRAJMessageWaypoints Prints a complete TRAJ message to a buffer
+ * \param inputHeader Data to create the ISO header with
+ * \param trajectoryID ID of the trajectory
+ * \param trajectoryInfo Info of the trajectory
+ * \param trajectoryName A string of maximum length 63 excluding the null terminator
+ * \param nameLength Length of the name string excluding the null terminator
+ * \param waypoints Points of the trajectory
+ * \param nWaypoints Number of points
+ * \param trajDataBuffer Buffer to which the message is to be printed
+ * \param bufferLength Length of the buffer, at least ::getEncodedSizeTRAJMessage of the points
+ * \param debug Flag for enabling debugging
+ * \return Number of bytes printed, or -1 in case of error with errno set as by ::encodeTRAJMessageColumns
+ */
+ssize_t encodeTRAJMessageWaypoints(
+		const MessageHeaderType* inputHeader,
+		const uint16_t trajectoryID,
+		const TrajectoryInfoType trajectoryInfo,
+		const char* trajectoryName,
+		const size_t nameLength,
+		const TrajectoryWaypointType waypoints[],
+		const uint32_t nWaypoints,
+		char* trajDataBuffer,
+		const size_t bufferLength,
+		const char debug) {
+	if (waypoints == NULL && nWaypoints > 0) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Trajectory waypoints invalid");
+		return -1;
+	}
+	return encodeTRAJMessagePoints(inputHeader, trajectoryID, trajectoryInfo, trajectoryName, nameLength,
+								   waypoints, readWaypoint, nWaypoints, trajDataBuffer, bufferLength, debug);
+}
+
+static int readColumnsPoint(const void* trajectory, const uint32_t index, TrajectoryWaypointType* point) {
+	const TrajectoryColumnsType* columns = trajectory;
+	const int64_t time_us = columns->time_us[index];
+
+	if (time_us < 0) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Trajectory point %u has negative time", index);
+		return -1;
+	}
+	point->relativeTime.tv_sec = (time_t) (time_us / MICROSECONDS_PER_SECOND);
+	point->relativeTime.tv_usec = (suseconds_t) (time_us % MICROSECONDS_PER_SECOND);
+	point->pos.xCoord_m = columns->x_m[index];
+	point->pos.yCoord_m = columns->y_m[index];
+	point->pos.zCoord_m = columns->z_m != NULL ? columns->z_m[index] : 0.0;
+	point->pos.heading_rad = columns->heading_rad != NULL ? columns->heading_rad[index] : 0.0;
+	point->pos.isPositionValid = point->pos.isXcoordValid = point->pos.isYcoordValid = true;
+	point->pos.isZcoordValid = columns->z_m != NULL;
+	point->pos.isHeadingValid = columns->heading_rad != NULL;
+	point->spd.longitudinal_m_s = columns->longitudinalSpeed_m_s[index];
+	point->spd.lateral_m_s = columns->lateralSpeed_m_s != NULL ? columns->lateralSpeed_m_s[index] : 0.0;
+	point->spd.isLongitudinalValid = true;
+	point->spd.isLateralValid = columns->lateralSpeed_m_s != NULL;
+	point->acc.longitudinal_m_s2 = columns->longitudinalAcceleration_m_s2 != NULL
+			? columns->longitudinalAcceleration_m_s2[index] : 0.0;
+	point->acc.lateral_m_s2 = columns->lateralAcceleration_m_s2 != NULL
+			? columns->lateralAcceleration_m_s2[index] : 0.0;
+	point->acc.isLongitudinalValid = columns->longitudinalAcceleration_m_s2 != NULL;
+	point->acc.isLateralValid = columns->lateralAcceleration_m_s2 != NULL;
+	point->curvature = columns->curvature != NULL ? columns->curvature[index] : 0.0f;
+	return 0;
+}
+
+/*!
+ * \brief encodeTRAJMessageColumns Prints a complete TRAJ message from a trajectory held in columns,
+ *			e.g. as given by ::resampleTrajectory or ::getTrajectoryColumns
+ * \param inputHeader Data to create the ISO header with
+ * \param trajectoryID ID of the trajectory
+ * \param trajectoryInfo Info of the trajectory
+ * \param trajectoryName A string of maximum length 63 excluding the null terminator
+ * \param nameLength Length of the name string excluding the null terminator
+ * \param columns Trajectory with times measured from its start, positions and longitudinal speeds.
+ *			Other columns may be NULL, in which case their fields are unavailable.
+ * \param trajDataBuffer Buffer to which the message is to be printed
+ * \param bufferLength Length of the buffer, at least ::getEncodedSizeTRAJMessage of the points
  * \param debug Flag for enabling debugging
  * \return Number of bytes printed, or -1 in case of error with the following errnos:
- *		EINVAL		if one of the input parameters are invalid
- *		ENOBUFS		if supplied buffer is too small to hold header
- *		EMSGSIZE	if trajectory name is too long
+ *		EINVAL		if a required column is missing or a time is negative
+ *		ENOBUFS		if supplied buffer is too small to hold the message
+ *		EMSGSIZE	if there are too many points or the name is too long
+ */
+ssize_t encodeTRAJMessageColumns(
+		const MessageHeaderType* inputHeader,
+		const uint16_t trajectoryID,
+		const TrajectoryInfoType trajectoryInfo,
+		const char* trajectoryName,
+		const size_t nameLength,
+		const TrajectoryColumnsType* columns,
+		char* trajDataBuffer,
+		const size_t bufferLength,
+		const char debug) {
+	if (columns == NULL || (columns->nPoints > 0
+			&& (columns->time_us == NULL || columns->x_m == NULL || columns->y_m == NULL
+				|| columns->longitudinalSpeed_m_s == NULL))) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0,
+						 "Trajectory columns must include time, x, y and longitudinal speed");
+		return -1;
+	}
+	if (columns->nPoints > (UINT32_MAX - getEncodedSizeTRAJMessage(0))
+			/ (getEncodedSizeTRAJMessage(1) - getEncodedSizeTRAJMessage(0))) {
+		errno = EMSGSIZE;
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRAJ, 0, "Too many points for a TRAJ message");
+		return -1;
+	}
+	return encodeTRAJMessagePoints(inputHeader, trajectoryID, trajectoryInfo, trajectoryName, nameLength,
+								   columns, readColumnsPoint, (uint32_t) columns->nPoints, trajDataBuffer,
+								   bufferLength, debug);
+}
+
+/*!
+ * \brief decodeTRAJMessagePoint Decodes one trajectory point, trusting the content lengths stated in
+ *			the buffer. Use ::decodeTRAJMessagePointBounded when the length of the buffer is known.
+ * \param wayPoint Output data struct, to be used by host
+ * \param trajDataBuffer Received trajectory data buffer, starting at the point
+ * \param debug Flag for enabling debugging
+ * \return Number of bytes decoded, or a negative value according to ::ISOMessageReturnValue
  */
 ssize_t decodeTRAJMessagePoint(
 		TrajectoryWaypointType* wayPoint,
 		const char* trajDataBuffer,
 		const char debug) {
+	return decodeTRAJMessagePointBounded(wayPoint, trajDataBuffer, SIZE_MAX, debug);
+}
+
+/*!
+ * \brief decodeTRAJMessagePointBounded Decodes one trajectory point. Vendor specific values preceding
+ *			the point are passed to handlers registered with ::registerVendorValueHandler, and included
+ *			in the returned number of bytes.
+ * \param wayPoint Output data struct, to be used by host
+ * \param trajDataBuffer Received trajectory data buffer, starting at the point
+ * \param bufferLength Number of bytes remaining in trajDataBuffer
+ * \param debug Flag for enabling debugging
+ * \return Number of bytes decoded, or a negative value according to ::ISOMessageReturnValue.
+ *			::MESSAGE_LENGTH_ERROR is returned if a value does not fit in the buffer.
+ */
+ssize_t decodeTRAJMessagePointBounded(
+		TrajectoryWaypointType* wayPoint,
+		const char* trajDataBuffer,
+		const size_t bufferLength,
+		const char debug) {
 
 	TRAJPointType TRAJPointData;
 	const char *p = trajDataBuffer;
+	const size_t valueHeaderLength = sizeof (TRAJPointData.trajectoryPointValueID)
+		+ sizeof (TRAJPointData.trajectoryPointContentLength);
 	ssize_t retval = MESSAGE_OK;
 	const ssize_t expectedContentLength = sizeof (TRAJPointData)
 		- sizeof (TRAJPointData.trajectoryPointValueID)
@@ -471,28 +721,59 @@ ssize_t decodeTRAJMessagePoint(
 
 	if (trajDataBuffer == NULL || wayPoint == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "Input pointers to TRAJ points parsing function cannot be null\n");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0,
+						 "Input pointers to TRAJ points parsing function cannot be null");
 		return ISO_FUNCTION_ERROR;
 	}
 
 	memset(&TRAJPointData, 0, sizeof (TRAJPointData));
 	memset(wayPoint, 0, sizeof (*wayPoint));
 
-	memcpy(&TRAJPointData.trajectoryPointValueID, p, sizeof (TRAJPointData.trajectoryPointValueID));
-	p += sizeof (TRAJPointData.trajectoryPointValueID);
-	memcpy(&TRAJPointData.trajectoryPointContentLength, p, sizeof (TRAJPointData.trajectoryPointContentLength));
-	p += sizeof (TRAJPointData.trajectoryPointContentLength);
-	TRAJPointData.trajectoryPointValueID = le16toh(TRAJPointData.trajectoryPointValueID);
-	TRAJPointData.trajectoryPointContentLength = le16toh(TRAJPointData.trajectoryPointContentLength);
+	for (;;) {
+		if (bufferLength - (size_t) (p - trajDataBuffer) < valueHeaderLength) {
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRAJ, (size_t) (p - trajDataBuffer),
+							 "Buffer too small to hold TRAJ value header");
+			return MESSAGE_LENGTH_ERROR;
+		}
+		memcpy(&TRAJPointData.trajectoryPointValueID, p, sizeof (TRAJPointData.trajectoryPointValueID));
+		p += sizeof (TRAJPointData.trajectoryPointValueID);
+		memcpy(&TRAJPointData.trajectoryPointContentLength, p, sizeof (TRAJPointData.trajectoryPointContentLength));
+		p += sizeof (TRAJPointData.trajectoryPointContentLength);
+		TRAJPointData.trajectoryPointValueID = le16toh(TRAJPointData.trajectoryPointValueID);
+		TRAJPointData.trajectoryPointContentLength = le16toh(TRAJPointData.trajectoryPointContentLength);
+		if (TRAJPointData.trajectoryPointContentLength > bufferLength - (size_t) (p - trajDataBuffer)) {
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRAJ, (size_t) (p - trajDataBuffer),
+							 "Content length %u for value ID 0x%x exceeds the remaining %zu bytes",
+							 TRAJPointData.trajectoryPointContentLength, TRAJPointData.trajectoryPointValueID,
+							 bufferLength - (size_t) (p - trajDataBuffer));
+			return MESSAGE_LENGTH_ERROR;
+		}
+
+		// Vendor specific values preceding the point are passed to their registered handlers
+		if (TRAJPointData.trajectoryPointValueID < VALUE_ID_TRAJ_VENDOR_SPECIFIC_RANGE_LOWER
+				|| TRAJPointData.trajectoryPointValueID > VALUE_ID_TRAJ_VENDOR_SPECIFIC_RANGE_UPPER) {
+			break;
+		}
+		if ((retval = handleVendorValue(MESSAGE_ID_TRAJ, TRAJPointData.trajectoryPointValueID, p,
+										TRAJPointData.trajectoryPointContentLength)) < 0) {
+			ISO_REPORT_ERROR(retval, MESSAGE_ID_TRAJ, (size_t) (p - trajDataBuffer),
+							 "Vendor specific value ID 0x%x could not be handled",
+							 TRAJPointData.trajectoryPointValueID);
+			return retval;
+		}
+		p += TRAJPointData.trajectoryPointContentLength;
+	}
 
 	if (TRAJPointData.trajectoryPointValueID != VALUE_ID_TRAJ_POINT) {
-		fprintf(stderr, "Value ID 0x%x does not match TRAJ point value ID\n", TRAJPointData.trajectoryPointValueID);
+		ISO_REPORT_ERROR(MESSAGE_VALUE_ID_ERROR, MESSAGE_ID_TRAJ, (size_t) (p - trajDataBuffer),
+						 "Value ID 0x%x does not match TRAJ point value ID", TRAJPointData.trajectoryPointValueID);
 		return MESSAGE_VALUE_ID_ERROR;
 	}
 	if (TRAJPointData.trajectoryPointContentLength != expectedContentLength) {
-		fprintf(stderr, "Content length %u for value ID 0x%x does not match the expected %ld\n",
-				TRAJPointData.trajectoryPointContentLength, TRAJPointData.trajectoryPointValueID,
-				expectedContentLength);
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRAJ, (size_t) (p - trajDataBuffer),
+						 "Content length %u for value ID 0x%x does not match the expected %ld",
+						 TRAJPointData.trajectoryPointContentLength, TRAJPointData.trajectoryPointValueID,
+						 expectedContentLength);
 		return MESSAGE_LENGTH_ERROR;
 	}
 	memcpy(&TRAJPointData.relativeTime, p, sizeof (TRAJPointData) - sizeof (TRAJPointData.trajectoryPointValueID)
@@ -537,7 +818,6 @@ ssize_t decodeTRAJMessagePoint(
 }
 
 
-
 /*!
  * \brief convertTRAJPointToHostRepresentation Converts a TRAJ header message to be used by host
  * \param TRAJPointData Data struct containing ISO formatted data
@@ -549,7 +829,7 @@ enum ISOMessageReturnValue convertTRAJPointToHostRepresentation(
 		TrajectoryWaypointType* wayPoint) {
 	if (TRAJPointData == NULL || wayPoint == NULL) {
 		errno = EINVAL;
-		fprintf(stderr, "TRAJ point input pointer error");
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "TRAJ point input pointer error");
 		return ISO_FUNCTION_ERROR;
 	}
 
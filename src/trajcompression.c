@@ -0,0 +1,803 @@
+#include "trajcompression.h"
+#include "traj.h"
+#include "frame.h"
+#include "footer.h"
+#include "isoerror.h"
+
+#include <endian.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CTRJ_FIELD_COUNT 10
+//! Largest number of bytes of one packed block, i.e. the bit widths followed by full width residuals
+#define CTRJ_MAX_BLOCK_SIZE (CTRJ_FIELD_COUNT + CTRJ_POINTS_PER_BLOCK * CTRJ_FIELD_COUNT * sizeof (uint32_t))
+#define CTRJ_PAYLOAD_INITIAL_CAPACITY 4096
+
+#pragma pack(push, 1)
+/*! CTRJ message preceding the packed blocks. The blocks are followed by the ISO footer. */
+typedef struct {
+	HeaderType header;
+	uint8_t codecVersion;
+	uint16_t trajectoryID;
+	uint8_t trajectoryInfo;
+	char trajectoryName[TRAJ_NAME_STRING_MAX_LENGTH];
+	uint32_t nPoints;
+} CTRJHeaderType;
+
+/*! CTRA message, announcing the highest compressed trajectory codec version the sender decodes */
+typedef struct {
+	HeaderType header;
+	uint8_t codecVersion;
+	FooterType footer;
+} CTRAType;
+#pragma pack(pop)
+
+/*! Fixed point field of a TRAJ point. Each value is predicted from the preceding points of the
+ *  trajectory, linearly for fields following the motion and by the previous value for the others,
+ *  and the difference to the prediction stored as a zigzag coded residual. */
+typedef struct {
+	uint8_t nBits;
+	uint8_t predictionOrder;
+} CompressedFieldType;
+
+enum {
+	FIELD_RELATIVE_TIME,
+	FIELD_X_POSITION,
+	FIELD_Y_POSITION,
+	FIELD_Z_POSITION,
+	FIELD_YAW,
+	FIELD_LONGITUDINAL_SPEED,
+	FIELD_LATERAL_SPEED,
+	FIELD_LONGITUDINAL_ACCELERATION,
+	FIELD_LATERAL_ACCELERATION,
+	FIELD_CURVATURE
+};
+
+static const CompressedFieldType compressedFields[CTRJ_FIELD_COUNT] = {
+	[FIELD_RELATIVE_TIME] = { 32, 2 },
+	[FIELD_X_POSITION] = { 32, 2 },
+	[FIELD_Y_POSITION] = { 32, 2 },
+	[FIELD_Z_POSITION] = { 32, 2 },
+	[FIELD_YAW] = { 16, 2 },
+	[FIELD_LONGITUDINAL_SPEED] = { 16, 1 },
+	[FIELD_LATERAL_SPEED] = { 16, 1 },
+	[FIELD_LONGITUDINAL_ACCELERATION] = { 16, 1 },
+	[FIELD_LATERAL_ACCELERATION] = { 16, 1 },
+	[FIELD_CURVATURE] = { 32, 1 }
+};
+
+struct TrajectoryCompressor {
+	uint16_t trajectoryID;
+	TrajectoryInfoType trajectoryInfo;
+	char trajectoryName[TRAJ_NAME_STRING_MAX_LENGTH];
+	uint32_t nPoints;
+	uint32_t previous[2][CTRJ_FIELD_COUNT];		//!< Values of the last and second to last point
+	uint32_t residuals[CTRJ_FIELD_COUNT][CTRJ_POINTS_PER_BLOCK];
+	size_t nPending;							//!< Points of the block not yet packed
+	uint8_t* payload;							//!< Packed blocks
+	size_t payloadLength;
+	size_t payloadCapacity;
+};
+
+struct TrajectoryDecompressor {
+	const uint8_t* payload;						//!< Packed blocks within the buffer passed to the header decoder
+	const uint8_t* payloadEnd;
+	uint32_t nPoints;
+	uint32_t nDecoded;
+	uint32_t previous[2][CTRJ_FIELD_COUNT];
+	TrajectoryWaypointType block[CTRJ_POINTS_PER_BLOCK];
+	size_t blockLength;
+	size_t blockPosition;
+};
+
+static inline uint32_t fieldMask(const CompressedFieldType* field) {
+	return field->nBits == 32 ? UINT32_MAX : (UINT32_C(1) << field->nBits) - 1;
+}
+
+/*!
+ * \brief predictField Predicts the value of a field from the preceding points
+ * \param field Field to predict
+ * \param previous Field values of the last and second to last point
+ * \param nPreceding Number of points preceding the predicted one
+ * \return Predicted value, wrapped to the width of the field
+ */
+static inline uint32_t predictField(const CompressedFieldType* field, const uint32_t previous[2],
+									const uint32_t nPreceding) {
+	if (nPreceding == 0) {
+		return 0;
+	}
+	if (nPreceding == 1 || field->predictionOrder == 1) {
+		return previous[0];
+	}
+	return (2 * previous[0] - previous[1]) & fieldMask(field);
+}
+
+/*!
+ * \brief encodeResidual Zigzag codes the difference between a value and its prediction, so that
+ *			small differences of either sign have few significant bits
+ * \param field Field of the value
+ * \param value Value to code
+ * \param predicted Predicted value
+ * \return Coded residual, using at most the width of the field
+ */
+static inline uint32_t encodeResidual(const CompressedFieldType* field, const uint32_t value,
+									  const uint32_t predicted) {
+	const uint32_t difference = (value - predicted) & fieldMask(field);
+	const int32_t residual = field->nBits == 16 ? (int16_t) difference : (int32_t) difference;
+	return ((uint32_t) residual << 1) ^ (uint32_t) (residual >> 31);
+}
+
+static inline uint32_t decodeResidual(const CompressedFieldType* field, const uint32_t coded,
+									  const uint32_t predicted) {
+	const uint32_t residual = (coded >> 1) ^ (0u - (coded & 1u));
+	return (predicted + residual) & fieldMask(field);
+}
+
+/*!
+ * \brief getPointFields Gathers the fixed point fields of a TRAJ point in host byte order
+ * \param point Point to read
+ * \param values Array in which to store the field values
+ */
+static void getPointFields(const TRAJPointType* point, uint32_t values[CTRJ_FIELD_COUNT]) {
+	values[FIELD_RELATIVE_TIME] = point->relativeTime;
+	values[FIELD_X_POSITION] = (uint32_t) point->xPosition;
+	values[FIELD_Y_POSITION] = (uint32_t) point->yPosition;
+	values[FIELD_Z_POSITION] = (uint32_t) point->zPosition;
+	values[FIELD_YAW] = point->yaw;
+	values[FIELD_LONGITUDINAL_SPEED] = (uint16_t) point->longitudinalSpeed;
+	values[FIELD_LATERAL_SPEED] = (uint16_t) point->lateralSpeed;
+	values[FIELD_LONGITUDINAL_ACCELERATION] = (uint16_t) point->longitudinalAcceleration;
+	values[FIELD_LATERAL_ACCELERATION] = (uint16_t) point->lateralAcceleration;
+	memcpy(&values[FIELD_CURVATURE], &point->curvature, sizeof (values[FIELD_CURVATURE]));
+}
+
+static void setPointFields(TRAJPointType* point, const uint32_t values[CTRJ_FIELD_COUNT]) {
+	point->relativeTime = values[FIELD_RELATIVE_TIME];
+	point->xPosition = (int32_t) values[FIELD_X_POSITION];
+	point->yPosition = (int32_t) values[FIELD_Y_POSITION];
+	point->zPosition = (int32_t) values[FIELD_Z_POSITION];
+	point->yaw = (uint16_t) values[FIELD_YAW];
+	point->longitudinalSpeed = (int16_t) values[FIELD_LONGITUDINAL_SPEED];
+	point->lateralSpeed = (int16_t) values[FIELD_LATERAL_SPEED];
+	point->longitudinalAcceleration = (int16_t) values[FIELD_LONGITUDINAL_ACCELERATION];
+	point->lateralAcceleration = (int16_t) values[FIELD_LATERAL_ACCELERATION];
+	memcpy(&point->curvature, &values[FIELD_CURVATURE], sizeof (point->curvature));
+}
+
+/*!
+ * \brief getBitWidth Get the number of significant bits of a set of values
+ * \param values Values to examine
+ * \param nValues Number of values
+ * \return Number of bits needed to store the largest value
+ */
+static unsigned int getBitWidth(const uint32_t values[], const size_t nValues) {
+	uint32_t combined = 0;
+	for (size_t i = 0; i < nValues; ++i) {
+		combined |= values[i];
+	}
+	return combined == 0 ? 0 : 32 - (unsigned int) __builtin_clz(combined);
+}
+
+/*!
+ * \brief packBits Stores values with a fixed number of bits each, least significant bit first
+ * \param out Output bytes, with room for (nValues * width + 7) / 8 bytes
+ * \param values Values of at most width bits
+ * \param nValues Number of values
+ * \param width Number of bits per value
+ * \return Position after the written bytes
+ */
+static uint8_t* packBits(uint8_t* out, const uint32_t values[], const size_t nValues, const unsigned int width) {
+	uint64_t bits = 0;
+	unsigned int nBits = 0;
+
+	for (size_t i = 0; i < nValues; ++i) {
+		bits |= (uint64_t) values[i] << nBits;
+		nBits += width;
+		while (nBits >= 8) {
+			*out++ = (uint8_t) bits;
+			bits >>= 8;
+			nBits -= 8;
+		}
+	}
+	if (nBits > 0) {
+		*out++ = (uint8_t) bits;
+	}
+	return out;
+}
+
+static const uint8_t* unpackBits(const uint8_t* in, uint32_t values[], const size_t nValues,
+								 const unsigned int width) {
+	const uint64_t mask = (UINT64_C(1) << width) - 1;
+	uint64_t bits = 0;
+	unsigned int nBits = 0;
+
+	for (size_t i = 0; i < nValues; ++i) {
+		while (nBits < width) {
+			bits |= (uint64_t) *in++ << nBits;
+			nBits += 8;
+		}
+		values[i] = (uint32_t) (bits & mask);
+		bits >>= width;
+		nBits -= width;
+	}
+	return in;
+}
+
+/*!
+ * \brief createTrajectoryCompressor Creates a compressor, to be started with ::beginCTRJMessage
+ * \return The compressor, or NULL if it could not be allocated
+ */
+TrajectoryCompressorType* createTrajectoryCompressor(void) {
+	return calloc(1, sizeof (TrajectoryCompressorType));
+}
+
+/*!
+ * \brief freeTrajectoryCompressor Frees a compressor and its packed points
+ * \param compressor Compressor to free, may be NULL
+ */
+void freeTrajectoryCompressor(TrajectoryCompressorType* compressor) {
+	if (compressor == NULL) {
+		return;
+	}
+	free(compressor->payload);
+	free(compressor);
+}
+
+/*!
+ * \brief beginCTRJMessage Starts compressing a new trajectory, discarding any points added before
+ * \param compressor Compressor to use
+ * \param trajectoryID ID of the trajectory
+ * \param trajectoryInfo Info of the trajectory
+ * \param trajectoryName A string of maximum length 63 excluding the null terminator
+ * \param nameLength Length of the name string excluding the null terminator
+ * \return 0 on success, -1 otherwise with errno set to
+ *		EINVAL		if one of the input parameters are invalid
+ *		EMSGSIZE	if trajectory name is too long
+ */
+int beginCTRJMessage(
+		TrajectoryCompressorType* compressor,
+		const uint16_t trajectoryID,
+		const TrajectoryInfoType trajectoryInfo,
+		const char* trajectoryName,
+		const size_t nameLength) {
+	if (compressor == NULL || (trajectoryName == NULL && nameLength > 0)) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, 0,
+						 "Trajectory name length and pointer mismatch");
+		return -1;
+	}
+	if (nameLength >= sizeof (compressor->trajectoryName)) {
+		errno = EMSGSIZE;
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, 0,
+						 "Trajectory name too long for CTRJ message");
+		return -1;
+	}
+	compressor->trajectoryID = trajectoryID;
+	compressor->trajectoryInfo = trajectoryInfo;
+	memset(compressor->trajectoryName, 0, sizeof (compressor->trajectoryName));
+	if (nameLength > 0) {
+		memcpy(compressor->trajectoryName, trajectoryName, nameLength);
+	}
+	compressor->nPoints = 0;
+	compressor->nPending = 0;
+	compressor->payloadLength = 0;
+	return 0;
+}
+
+/*!
+ * \brief writeBlock Packs the residuals of a block of points
+ * \param residuals Coded residuals of each field
+ * \param nPoints Number of points in the block
+ * \param out Output bytes, with room for ::CTRJ_MAX_BLOCK_SIZE bytes
+ * \return Position after the written bytes
+ */
+static uint8_t* writeBlock(const uint32_t residuals[CTRJ_FIELD_COUNT][CTRJ_POINTS_PER_BLOCK], const size_t nPoints,
+						   uint8_t* out) {
+	uint8_t* widths = out;
+
+	out += CTRJ_FIELD_COUNT;
+	for (size_t f = 0; f < CTRJ_FIELD_COUNT; ++f) {
+		widths[f] = (uint8_t) getBitWidth(residuals[f], nPoints);
+		out = packBits(out, residuals[f], nPoints, widths[f]);
+	}
+	return out;
+}
+
+/*!
+ * \brief packPendingBlock Packs the residuals of a full block of added points
+ * \param compressor Compressor with a full block of pending points
+ * \return 0 on success, -1 with errno set to ENOMEM if the packed points could not be grown
+ */
+static int packPendingBlock(TrajectoryCompressorType* compressor) {
+	const size_t required = compressor->payloadLength + CTRJ_MAX_BLOCK_SIZE;
+
+	if (required > compressor->payloadCapacity) {
+		size_t newCapacity = compressor->payloadCapacity == 0 ? CTRJ_PAYLOAD_INITIAL_CAPACITY
+															  : compressor->payloadCapacity;
+		while (newCapacity < required) {
+			newCapacity *= 2;
+		}
+		uint8_t* grown = realloc(compressor->payload, newCapacity);
+		if (grown == NULL) {
+			errno = ENOMEM;
+			return -1;
+		}
+		compressor->payload = grown;
+		compressor->payloadCapacity = newCapacity;
+	}
+	const uint8_t* end = writeBlock(compressor->residuals, compressor->nPending,
+									compressor->payload + compressor->payloadLength);
+	compressor->payloadLength = (size_t) (end - compressor->payload);
+	compressor->nPending = 0;
+	return 0;
+}
+
+/*!
+ * \brief addCTRJMessagePoint Adds a point to the trajectory being compressed. The fields are quantised
+ *			and required as by ::encodeTRAJMessagePoint.
+ * \param compressor Compressor started with ::beginCTRJMessage
+ * \param pointTimeFromStart Time of the point relative to the start of the trajectory
+ * \param position Position of the point
+ * \param speed Speed at the point
+ * \param acceleration Acceleration at the point
+ * \param curvature Curvature of the trajectory at the point
+ * \return 0 on success, -1 otherwise with errno set to
+ *		EINVAL		if one of the input parameters are invalid
+ *		ENOMEM		if the packed points could not be grown
+ */
+int addCTRJMessagePoint(
+		TrajectoryCompressorType* compressor,
+		const struct timeval* pointTimeFromStart,
+		const CartesianPosition position,
+		const SpeedType speed,
+		const AccelerationType acceleration,
+		const float curvature) {
+	TRAJPointType point;
+	uint32_t values[CTRJ_FIELD_COUNT];
+
+	if (compressor == NULL || pointTimeFromStart == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, 0,
+						 "Input pointers to CTRJ point encoding function cannot be null");
+		return -1;
+	}
+	if (convertTRAJPointToISORepresentation(pointTimeFromStart, position, speed, acceleration, curvature,
+											&point) != MESSAGE_OK) {
+		return -1;
+	}
+
+	getPointFields(&point, values);
+	for (size_t f = 0; f < CTRJ_FIELD_COUNT; ++f) {
+		const uint32_t previous[2] = { compressor->previous[0][f], compressor->previous[1][f] };
+		compressor->residuals[f][compressor->nPending] =
+			encodeResidual(&compressedFields[f], values[f],
+						   predictField(&compressedFields[f], previous, compressor->nPoints));
+	}
+	memcpy(compressor->previous[1], compressor->previous[0], sizeof (compressor->previous[0]));
+	memcpy(compressor->previous[0], values, sizeof (values));
+	compressor->nPoints++;
+	return ++compressor->nPending == CTRJ_POINTS_PER_BLOCK ? packPendingBlock(compressor) : 0;
+}
+
+/*!
+ * \brief getPendingBlockSize Get the number of bytes the points not yet packed will occupy
+ * \param compressor Compressor to query
+ * \return Number of bytes of the pending block
+ */
+static size_t getPendingBlockSize(const TrajectoryCompressorType* compressor) {
+	size_t size = 0;
+
+	if (compressor->nPending == 0) {
+		return 0;
+	}
+	for (size_t f = 0; f < CTRJ_FIELD_COUNT; ++f) {
+		size += (compressor->nPending * getBitWidth(compressor->residuals[f], compressor->nPending) + 7) / 8;
+	}
+	return CTRJ_FIELD_COUNT + size;
+}
+
+/*!
+ * \brief getEncodedSizeCTRJMessage Get the size of the CTRJ message holding the points added so far
+ * \param compressor Compressor to query
+ * \return Number of bytes written by ::encodeCTRJMessage
+ */
+size_t getEncodedSizeCTRJMessage(const TrajectoryCompressorType* compressor) {
+	return sizeof (CTRJHeaderType) + compressor->payloadLength + getPendingBlockSize(compressor)
+		+ sizeof (FooterType);
+}
+
+/*!
+ * \brief encodeCTRJMessage Prints a CTRJ message holding the points added since ::beginCTRJMessage
+ *			to a buffer. Further points may be added and the message encoded again.
+ * \param compressor Compressor holding the points
+ * \param inputHeader data to create header with
+ * \param ctrjDataBuffer Buffer to which the message is to be printed
+ * \param bufferLength Length of the buffer
+ * \param debug Flag for enabling debugging
+ * \return Number of bytes printed, or -1 in case of error with the following errnos:
+ *		EINVAL		if one of the input parameters are invalid
+ *		ENOBUFS		if supplied buffer is too small to hold the message
+ */
+ssize_t encodeCTRJMessage(
+		TrajectoryCompressorType* compressor,
+		const MessageHeaderType* inputHeader,
+		char* ctrjDataBuffer,
+		const size_t bufferLength,
+		const char debug) {
+	CTRJHeaderType CTRJData;
+
+	if (compressor == NULL || ctrjDataBuffer == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, 0,
+						 "Input pointers to CTRJ encoding function cannot be null");
+		return -1;
+	}
+	const size_t messageSize = getEncodedSizeCTRJMessage(compressor);
+	if (bufferLength < messageSize) {
+		errno = ENOBUFS;
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, 0,
+						 "Buffer too small to hold CTRJ message of %zu bytes", messageSize);
+		return -1;
+	}
+	CTRJData.header = buildISOHeader(MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, inputHeader, (uint32_t) messageSize, debug);
+	CTRJData.codecVersion = CTRJ_CODEC_VERSION;
+	CTRJData.trajectoryID = htole16(compressor->trajectoryID);
+	CTRJData.trajectoryInfo = (uint8_t) compressor->trajectoryInfo;
+	memcpy(CTRJData.trajectoryName, compressor->trajectoryName, sizeof (CTRJData.trajectoryName));
+	CTRJData.nPoints = htole32(compressor->nPoints);
+
+	if (debug) {
+		printf("CTRJ message:\n\tCodec version: %u\n\tTrajectory ID: %u\n\tTrajectory name: %s\n\t"
+			   "Trajectory info: %u\n\tNumber of points: %u\n\tPacked size: %zu bytes, %zu as TRAJ\n",
+			   CTRJData.codecVersion, compressor->trajectoryID, compressor->trajectoryName,
+			   CTRJData.trajectoryInfo, compressor->nPoints, compressor->payloadLength,
+			   (size_t) compressor->nPoints * sizeof (TRAJPointType));
+	}
+
+	char* p = ctrjDataBuffer;
+	memcpy(p, &CTRJData, sizeof (CTRJData));
+	p += sizeof (CTRJData);
+	if (compressor->payloadLength > 0) {
+		memcpy(p, compressor->payload, compressor->payloadLength);
+		p += compressor->payloadLength;
+	}
+	if (compressor->nPending > 0) {
+		p = (char*) writeBlock(compressor->residuals, compressor->nPending, (uint8_t*) p);
+	}
+	const FooterType footer = buildISOFooter(ctrjDataBuffer, messageSize, debug);
+	memcpy(p, &footer, sizeof (footer));
+	return (ssize_t) messageSize;
+}
+
+/*!
+ * \brief createTrajectoryDecompressor Creates a decompressor, to be started with ::decodeCTRJMessageHeader
+ * \return The decompressor, or NULL if it could not be allocated
+ */
+TrajectoryDecompressorType* createTrajectoryDecompressor(void) {
+	return calloc(1, sizeof (TrajectoryDecompressorType));
+}
+
+/*!
+ * \brief freeTrajectoryDecompressor Frees a decompressor
+ * \param decompressor Decompressor to free, may be NULL
+ */
+void freeTrajectoryDecompressor(TrajectoryDecompressorType* decompressor) {
+	free(decompressor);
+}
+
+/*!
+ * \brief decodeCTRJMessageHeader Verifies the framing of a CTRJ message, decodes its trajectory header
+ *			and prepares the decompressor for ::decodeCTRJMessagePoints. The buffer must remain valid
+ *			until all points have been decoded.
+ * \param decompressor Decompressor to prepare
+ * \param trajHeader Output data struct, with the length and number of points of the equivalent TRAJ message
+ * \param ctrjDataBuffer Received message
+ * \param bufferLength Length of ctrjDataBuffer
+ * \param debug Flag for enabling debugging
+ * \return Size of the message including header and footer, or a negative value according to
+ *			::ISOMessageReturnValue
+ */
+ssize_t decodeCTRJMessageHeader(
+		TrajectoryDecompressorType* decompressor,
+		TrajectoryHeaderType* trajHeader,
+		const char* ctrjDataBuffer,
+		const size_t bufferLength,
+		const char debug) {
+	CTRJHeaderType CTRJData;
+	HeaderType header;
+
+	if (decompressor == NULL || trajHeader == NULL || ctrjDataBuffer == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, 0,
+						 "Input pointers to CTRJ header parsing function cannot be null");
+		return ISO_FUNCTION_ERROR;
+	}
+	memset(decompressor, 0, sizeof (*decompressor));
+
+	const ssize_t messageSize = validateISOFrame(ctrjDataBuffer, bufferLength, &header);
+	if (messageSize < 0) {
+		return messageSize;
+	}
+	if (header.messageID != MESSAGE_ID_VENDOR_SPECIFIC_CTRJ) {
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, offsetof(HeaderType, messageID),
+						 "Attempted to pass non-CTRJ message into CTRJ header parsing function");
+		return MESSAGE_TYPE_ERROR;
+	}
+	if ((size_t) messageSize < sizeof (CTRJHeaderType) + sizeof (FooterType)) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, sizeof (HeaderType),
+						 "CTRJ message of %zd bytes too short to hold its header", messageSize);
+		return MESSAGE_LENGTH_ERROR;
+	}
+	memcpy(&CTRJData, ctrjDataBuffer, sizeof (CTRJData));
+	if (CTRJData.codecVersion != CTRJ_CODEC_VERSION) {
+		ISO_REPORT_ERROR(MESSAGE_VERSION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ,
+						 offsetof(CTRJHeaderType, codecVersion),
+						 "Unsupported CTRJ codec version %u", CTRJData.codecVersion);
+		return MESSAGE_VERSION_ERROR;
+	}
+
+	memset(trajHeader, 0, sizeof (*trajHeader));
+	trajHeader->trajectoryID = le16toh(CTRJData.trajectoryID);
+	memcpy(trajHeader->trajectoryName, CTRJData.trajectoryName, sizeof (CTRJData.trajectoryName));
+	trajHeader->trajectoryName[sizeof (trajHeader->trajectoryName) - 1] = '\0';
+	trajHeader->trajectoryInfo = (TrajectoryInfoType) CTRJData.trajectoryInfo;
+	trajHeader->nWaypoints = le32toh(CTRJData.nPoints);
+	trajHeader->trajectoryLength = trajHeader->nWaypoints * (uint32_t) sizeof (TRAJPointType);
+
+	decompressor->payload = (const uint8_t*) ctrjDataBuffer + sizeof (CTRJHeaderType);
+	decompressor->payloadEnd = (const uint8_t*) ctrjDataBuffer + messageSize - sizeof (FooterType);
+	decompressor->nPoints = trajHeader->nWaypoints;
+
+	if (debug) {
+		printf("CTRJ header data:\n\tTrajectory ID: 0x%x\n\tTrajectory name: %s\n\tTrajectory info: %u\n\t"
+			   "Number of points: %u\n\tPacked size: %zu bytes\n", trajHeader->trajectoryID,
+			   trajHeader->trajectoryName, trajHeader->trajectoryInfo, trajHeader->nWaypoints,
+			   (size_t) (decompressor->payloadEnd - decompressor->payload));
+	}
+	return messageSize;
+}
+
+/*!
+ * \brief unpackNextBlock Decodes the next block of points into the decompressor
+ * \param decompressor Decompressor with points remaining
+ * \return Value according to ::ISOMessageReturnValue
+ */
+static enum ISOMessageReturnValue unpackNextBlock(TrajectoryDecompressorType* decompressor) {
+	uint32_t residuals[CTRJ_FIELD_COUNT][CTRJ_POINTS_PER_BLOCK];
+	const uint32_t nRemaining = decompressor->nPoints - decompressor->nDecoded;
+	const size_t nPoints = nRemaining < CTRJ_POINTS_PER_BLOCK ? nRemaining : CTRJ_POINTS_PER_BLOCK;
+	const uint8_t* p = decompressor->payload;
+
+	if (decompressor->payloadEnd - p < CTRJ_FIELD_COUNT) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, 0,
+						 "CTRJ message ends before point %u of %u", decompressor->nDecoded, decompressor->nPoints);
+		return MESSAGE_LENGTH_ERROR;
+	}
+	const uint8_t* widths = p;
+	p += CTRJ_FIELD_COUNT;
+	for (size_t f = 0; f < CTRJ_FIELD_COUNT; ++f) {
+		if (widths[f] > compressedFields[f].nBits) {
+			ISO_REPORT_ERROR(MESSAGE_CONTENT_OUT_OF_RANGE, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, 0,
+							 "CTRJ residual width %u exceeds the %u bits of field %zu",
+							 widths[f], compressedFields[f].nBits, f);
+			return MESSAGE_CONTENT_OUT_OF_RANGE;
+		}
+		const size_t nBytes = (nPoints * widths[f] + 7) / 8;
+		if ((size_t) (decompressor->payloadEnd - p) < nBytes) {
+			ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, 0,
+							 "CTRJ message ends before point %u of %u", decompressor->nDecoded,
+							 decompressor->nPoints);
+			return MESSAGE_LENGTH_ERROR;
+		}
+		p = unpackBits(p, residuals[f], nPoints, widths[f]);
+	}
+
+	for (size_t i = 0; i < nPoints; ++i) {
+		uint32_t values[CTRJ_FIELD_COUNT];
+		TRAJPointType point;
+		for (size_t f = 0; f < CTRJ_FIELD_COUNT; ++f) {
+			const uint32_t previous[2] = { decompressor->previous[0][f], decompressor->previous[1][f] };
+			values[f] = decodeResidual(&compressedFields[f], residuals[f][i],
+									   predictField(&compressedFields[f], previous,
+													decompressor->nDecoded + (uint32_t) i));
+		}
+		memcpy(decompressor->previous[1], decompressor->previous[0], sizeof (decompressor->previous[0]));
+		memcpy(decompressor->previous[0], values, sizeof (values));
+		setPointFields(&point, values);
+		convertTRAJPointToHostRepresentation(&point, &decompressor->block[i]);
+	}
+	decompressor->payload = p;
+	decompressor->blockLength = nPoints;
+	decompressor->blockPosition = 0;
+
+	if (decompressor->nDecoded + nPoints == decompressor->nPoints && p != decompressor->payloadEnd) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, 0,
+						 "CTRJ message has %zu bytes after its last point", (size_t) (decompressor->payloadEnd - p));
+		return MESSAGE_LENGTH_ERROR;
+	}
+	return MESSAGE_OK;
+}
+
+/*!
+ * \brief decodeCTRJMessagePoints Decodes the next points of the message passed to ::decodeCTRJMessageHeader
+ * \param decompressor Decompressor prepared by ::decodeCTRJMessageHeader
+ * \param wayPoints Array in which to store the points, as ::decodeTRAJMessagePoint would
+ * \param maxPoints Capacity of the array
+ * \return Number of points decoded, zero once all points have been decoded, or a negative value
+ *			according to ::ISOMessageReturnValue
+ */
+ssize_t decodeCTRJMessagePoints(
+		TrajectoryDecompressorType* decompressor,
+		TrajectoryWaypointType wayPoints[],
+		const size_t maxPoints) {
+	size_t nOutput = 0;
+
+	if (decompressor == NULL || (wayPoints == NULL && maxPoints > 0)) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, 0,
+						 "Input pointers to CTRJ point parsing function cannot be null");
+		return ISO_FUNCTION_ERROR;
+	}
+	while (nOutput < maxPoints && decompressor->nDecoded < decompressor->nPoints) {
+		if (decompressor->blockPosition == decompressor->blockLength) {
+			const enum ISOMessageReturnValue retval = unpackNextBlock(decompressor);
+			if (retval != MESSAGE_OK) {
+				return retval;
+			}
+		}
+		size_t nCopied = decompressor->blockLength - decompressor->blockPosition;
+		if (nCopied > maxPoints - nOutput) {
+			nCopied = maxPoints - nOutput;
+		}
+		memcpy(&wayPoints[nOutput], &decompressor->block[decompressor->blockPosition],
+			   nCopied * sizeof (wayPoints[0]));
+		decompressor->blockPosition += nCopied;
+		decompressor->nDecoded += (uint32_t) nCopied;
+		nOutput += nCopied;
+	}
+	return (ssize_t) nOutput;
+}
+
+/*!
+ * \brief getEncodedSizeCTRAMessage Get the size of an encoded CTRA message
+ * \return Number of bytes written by ::encodeCTRAMessage
+ */
+size_t getEncodedSizeCTRAMessage(void) {
+	return sizeof (CTRAType);
+}
+
+/*!
+ * \brief encodeCTRAMessage Constructs a CTRA message, with which an object announces that it decodes
+ *			CTRJ messages up to the codec version implemented here
+ * \param inputHeader data to create header with
+ * \param ctraDataBuffer Data buffer in which to place encoded CTRA message
+ * \param bufferLength Size of data buffer in which to place encoded CTRA message
+ * \param debug Flag for enabling debugging
+ * \return number of bytes written to the data buffer, or -1 if an error occurred
+ */
+ssize_t encodeCTRAMessage(
+		const MessageHeaderType* inputHeader,
+		char* ctraDataBuffer,
+		const size_t bufferLength,
+		const char debug) {
+	CTRAType CTRAData;
+
+	if (ctraDataBuffer == NULL || bufferLength < sizeof (CTRAType)) {
+		errno = ENOBUFS;
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRA, 0,
+						 "Buffer too small to hold necessary CTRA data");
+		return -1;
+	}
+	CTRAData.header = buildISOHeader(MESSAGE_ID_VENDOR_SPECIFIC_CTRA, inputHeader, sizeof (CTRAType), debug);
+	CTRAData.codecVersion = CTRJ_CODEC_VERSION;
+	if (debug) {
+		printf("CTRA message:\n\tCodec version: %u\n", CTRAData.codecVersion);
+	}
+	CTRAData.footer = buildISOFooter(&CTRAData, sizeof (CTRAType), debug);
+	memcpy(ctraDataBuffer, &CTRAData, sizeof (CTRAType));
+	return sizeof (CTRAType);
+}
+
+/*!
+ * \brief decodeCTRAMessage Decodes the codec version announced in a CTRA message
+ * \param ctraDataBuffer Received message
+ * \param bufferLength Length of ctraDataBuffer
+ * \param codecVersion Highest CTRJ codec version decoded by the sender
+ * \param debug Flag for enabling debugging
+ * \return Size of the message including header and footer, or a negative value according to
+ *			::ISOMessageReturnValue
+ */
+ssize_t decodeCTRAMessage(
+		const char* ctraDataBuffer,
+		const size_t bufferLength,
+		uint8_t* codecVersion,
+		const char debug) {
+	CTRAType CTRAData;
+	HeaderType header;
+
+	if (ctraDataBuffer == NULL || codecVersion == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRA, 0,
+						 "Input pointers to CTRA parsing function cannot be null");
+		return ISO_FUNCTION_ERROR;
+	}
+	const ssize_t messageSize = validateISOFrame(ctraDataBuffer, bufferLength, &header);
+	if (messageSize < 0) {
+		return messageSize;
+	}
+	if (header.messageID != MESSAGE_ID_VENDOR_SPECIFIC_CTRA) {
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRA, offsetof(HeaderType, messageID),
+						 "Attempted to pass non-CTRA message into CTRA parsing function");
+		return MESSAGE_TYPE_ERROR;
+	}
+	if ((size_t) messageSize != sizeof (CTRAType)) {
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_VENDOR_SPECIFIC_CTRA, sizeof (HeaderType),
+						 "CTRA message of %zd bytes does not match the expected %zu", messageSize,
+						 sizeof (CTRAType));
+		return MESSAGE_LENGTH_ERROR;
+	}
+	memcpy(&CTRAData, ctraDataBuffer, sizeof (CTRAData));
+	*codecVersion = CTRAData.codecVersion;
+	if (debug) {
+		printf("CTRA data:\n\tCodec version: %u\n", *codecVersion);
+	}
+	return messageSize;
+}
+
+/*!
+ * \brief encodeTrajectoryMessage Prints a trajectory to a buffer in the form accepted by the receiver:
+ *			as a CTRJ message if the receiver has announced a compatible codec version and compression
+ *			makes the message smaller, and as a TRAJ message otherwise
+ * \param compressor Compressor to use, or NULL to always send TRAJ
+ * \param acceptedCodecVersion CTRJ codec version announced by the receiver, or zero if it has not
+ *			announced any
+ * \param inputHeader data to create header with
+ * \param trajectoryID ID of the trajectory
+ * \param trajectoryInfo Info of the trajectory
+ * \param trajectoryName A string of maximum length 63 excluding the null terminator
+ * \param nameLength Length of the name string excluding the null terminator
+ * \param waypoints Points of the trajectory
+ * \param nWaypoints Number of points
+ * \param dataBuffer Buffer to which the message is to be printed, of at least
+ *			::getEncodedSizeTRAJMessage bytes
+ * \param bufferLength Length of the buffer
+ * \param debug Flag for enabling debugging
+ * \return Number of bytes printed, or -1 in case of error with errno set as by the TRAJ encoders
+ */
+ssize_t encodeTrajectoryMessage(
+		TrajectoryCompressorType* compressor,
+		const uint8_t acceptedCodecVersion,
+		const MessageHeaderType* inputHeader,
+		const uint16_t trajectoryID,
+		const TrajectoryInfoType trajectoryInfo,
+		const char* trajectoryName,
+		const size_t nameLength,
+		const TrajectoryWaypointType waypoints[],
+		const uint32_t nWaypoints,
+		char* dataBuffer,
+		const size_t bufferLength,
+		const char debug) {
+	if (waypoints == NULL && nWaypoints > 0) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Trajectory waypoints invalid");
+		return -1;
+	}
+	if (compressor != NULL && acceptedCodecVersion >= CTRJ_CODEC_VERSION) {
+		if (beginCTRJMessage(compressor, trajectoryID, trajectoryInfo, trajectoryName, nameLength) < 0) {
+			return -1;
+		}
+		for (uint32_t i = 0; i < nWaypoints; ++i) {
+			if (addCTRJMessagePoint(compressor, &waypoints[i].relativeTime, waypoints[i].pos, waypoints[i].spd,
+									waypoints[i].acc, waypoints[i].curvature) < 0) {
+				return -1;
+			}
+		}
+		if (getEncodedSizeCTRJMessage(compressor) < getEncodedSizeTRAJMessage(nWaypoints)) {
+			return encodeCTRJMessage(compressor, inputHeader, dataBuffer, bufferLength, debug);
+		}
+	}
+	return encodeTRAJMessageWaypoints(inputHeader, trajectoryID, trajectoryInfo, trajectoryName, nameLength,
+									  waypoints, nWaypoints, dataBuffer, bufferLength, debug);
+}
@@ -0,0 +1,727 @@
+#include "trajectoryimport.h"
+#include "traj.h"
+#include "footer.h"
+#include "codeccontext.h"
+#include "isoerror.h"
+#include "timeconversions.h"
+#include "workerpool.h"
+#include "defines.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*! Bytes of text per independently parsed chunk, before extending to the end of a line. Each
+ *  thread gets a few chunks, so that lines of uneven length do not leave threads idle. */
+#define IMPORT_MIN_BYTES_PER_CHUNK (64U * 1024U)
+#define IMPORT_CHUNKS_PER_THREAD 4
+#define CRC_PARTS_PER_CHUNK 4
+//! Significant digits and decimal exponents for which a double is exactly mantissa times a power of ten
+#define FAST_FLOAT_MAX_DIGITS 15
+#define FAST_FLOAT_MAX_EXPONENT 22
+#define MANTISSA_MAX_DIGITS 19
+#define FLOAT_TOKEN_MAX_LENGTH 64
+
+//! Number of distinct column meanings, i.e. fields of a parsed line
+#define N_COLUMN_TYPES (TRAJECTORY_COLUMN_CURVATURE + 1)
+
+typedef struct {
+	const char* begin;
+	const char* end;
+	size_t nLines;
+	size_t nPoints;
+	size_t firstLine;				//!< Line number of the first line of the chunk, starting at 1
+	size_t firstPoint;
+	size_t errorLine;				//!< Line number of the first line which could not be imported, 0 if none
+	uint16_t crc;					//!< Checksum of the encoded points of the chunk
+} ImportChunkType;
+
+typedef struct Import {
+	const TrajectoryImportOptionsType* options;
+	const TrajectoryColumnType* columns;
+	size_t nColumns;
+	char delimiter;
+	ImportChunkType* chunks;
+	size_t nChunks;
+	char* points;					//!< First point of the encoded TRAJ message
+	void (*pass)(const struct Import*, ImportChunkType*);
+} ImportType;
+
+typedef struct {
+	double values[N_COLUMN_TYPES];
+	bool isValid[N_COLUMN_TYPES];
+} ParsedLineType;
+
+typedef struct {
+	const char* name;
+	TrajectoryColumnType column;
+} ColumnNameType;
+
+static const ColumnNameType columnNames[] = {
+	{ "t", TRAJECTORY_COLUMN_TIME_S },
+	{ "time", TRAJECTORY_COLUMN_TIME_S },
+	{ "time_s", TRAJECTORY_COLUMN_TIME_S },
+	{ "x", TRAJECTORY_COLUMN_X_M },
+	{ "x_m", TRAJECTORY_COLUMN_X_M },
+	{ "y", TRAJECTORY_COLUMN_Y_M },
+	{ "y_m", TRAJECTORY_COLUMN_Y_M },
+	{ "z", TRAJECTORY_COLUMN_Z_M },
+	{ "z_m", TRAJECTORY_COLUMN_Z_M },
+	{ "heading", TRAJECTORY_COLUMN_HEADING_RAD },
+	{ "heading_rad", TRAJECTORY_COLUMN_HEADING_RAD },
+	{ "yaw", TRAJECTORY_COLUMN_HEADING_RAD },
+	{ "heading_deg", TRAJECTORY_COLUMN_HEADING_DEG },
+	{ "speed", TRAJECTORY_COLUMN_LONGITUDINAL_SPEED_M_S },
+	{ "v", TRAJECTORY_COLUMN_LONGITUDINAL_SPEED_M_S },
+	{ "vx", TRAJECTORY_COLUMN_LONGITUDINAL_SPEED_M_S },
+	{ "longitudinal_speed", TRAJECTORY_COLUMN_LONGITUDINAL_SPEED_M_S },
+	{ "vy", TRAJECTORY_COLUMN_LATERAL_SPEED_M_S },
+	{ "lateral_speed", TRAJECTORY_COLUMN_LATERAL_SPEED_M_S },
+	{ "acceleration", TRAJECTORY_COLUMN_LONGITUDINAL_ACCELERATION_M_S2 },
+	{ "ax", TRAJECTORY_COLUMN_LONGITUDINAL_ACCELERATION_M_S2 },
+	{ "longitudinal_acceleration", TRAJECTORY_COLUMN_LONGITUDINAL_ACCELERATION_M_S2 },
+	{ "ay", TRAJECTORY_COLUMN_LATERAL_ACCELERATION_M_S2 },
+	{ "lateral_acceleration", TRAJECTORY_COLUMN_LATERAL_ACCELERATION_M_S2 },
+	{ "curvature", TRAJECTORY_COLUMN_CURVATURE },
+	{ "kappa", TRAJECTORY_COLUMN_CURVATURE }
+};
+
+static const double powersOfTen[FAST_FLOAT_MAX_EXPONENT + 1] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool isBlank(const char c) {
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool isDigit(const char c) {
+	return c >= '0' && c <= '9';
+}
+
+//! End of the line starting at p, excluding the newline
+static inline const char* findLineEnd(const char* p, const char* end) {
+	const char* newline = memchr(p, '\n', (size_t) (end - p));
+	return newline != NULL ? newline : end;
+}
+
+//! Lines containing only whitespace, and comments starting with '#', carry no point
+static bool isDataLine(const char* p, const char* lineEnd) {
+	while (p < lineEnd && isBlank(*p)) {
+		p++;
+	}
+	return p < lineEnd && *p != '#';
+}
+
+static bool isHeaderLine(const char* p, const char* lineEnd) {
+	while (p < lineEnd && isBlank(*p)) {
+		p++;
+	}
+	return p < lineEnd && !isDigit(*p) && *p != '-' && *p != '+' && *p != '.';
+}
+
+/*!
+ * \brief parseNumber Parses a decimal floating point number. Numbers which are a mantissa of at most
+ *			15 digits times an exactly representable power of ten are computed directly, which is
+ *			correctly rounded, and other numbers are passed to strtod.
+ * \param p Start of the field
+ * \param end End of the field
+ * \param value Parsed value
+ * \return 1 if a number was parsed, 0 if the field is empty and -1 if it is not a number
+ */
+static int parseNumber(const char* p, const char* end, double* value) {
+	const char* token;
+	uint64_t mantissa = 0;
+	int nDigits = 0, exponent = 0, explicitExponent = 0;
+	bool isNegative = false, isTruncated = false, hasDigits = false;
+
+	while (p < end && isBlank(*p)) {
+		p++;
+	}
+	while (end > p && isBlank(end[-1])) {
+		end--;
+	}
+	if (p == end) {
+		return 0;
+	}
+	token = p;
+
+	if (*p == '-' || *p == '+') {
+		isNegative = *p++ == '-';
+	}
+	for (; p < end && isDigit(*p); ++p) {
+		hasDigits = true;
+		if (nDigits < MANTISSA_MAX_DIGITS) {
+			mantissa = mantissa * 10 + (uint64_t) (*p - '0');
+			nDigits += mantissa != 0;
+		}
+		else {
+			exponent++;
+			isTruncated = true;
+		}
+	}
+	if (p < end && *p == '.') {
+		for (++p; p < end && isDigit(*p); ++p) {
+			hasDigits = true;
+			if (nDigits < MANTISSA_MAX_DIGITS) {
+				mantissa = mantissa * 10 + (uint64_t) (*p - '0');
+				nDigits += mantissa != 0;
+				exponent--;
+			}
+			else {
+				isTruncated = true;
+			}
+		}
+	}
+	if (!hasDigits) {
+		return -1;
+	}
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		bool isExponentNegative = false;
+
+		if (++p < end && (*p == '-' || *p == '+')) {
+			isExponentNegative = *p++ == '-';
+		}
+		if (p == end || !isDigit(*p)) {
+			return -1;
+		}
+		for (; p < end && isDigit(*p); ++p) {
+			if (explicitExponent < 10000) {
+				explicitExponent = explicitExponent * 10 + (*p - '0');
+			}
+		}
+		exponent += isExponentNegative ? -explicitExponent : explicitExponent;
+	}
+	if (p != end) {
+		return -1;
+	}
+
+	if (!isTruncated && nDigits <= FAST_FLOAT_MAX_DIGITS
+			&& exponent >= -FAST_FLOAT_MAX_EXPONENT && exponent <= FAST_FLOAT_MAX_EXPONENT) {
+		const double magnitude = exponent < 0 ? (double) mantissa / powersOfTen[-exponent]
+											  : (double) mantissa * powersOfTen[exponent];
+		*value = isNegative ? -magnitude : magnitude;
+		return 1;
+	}
+	else {
+		char buffer[FLOAT_TOKEN_MAX_LENGTH];
+		char* parsedEnd;
+		const size_t length = (size_t) (end - token);
+
+		if (length >= sizeof (buffer)) {
+			return -1;
+		}
+		memcpy(buffer, token, length);
+		buffer[length] = '\0';
+		*value = strtod(buffer, &parsedEnd);
+		return parsedEnd == buffer + length ? 1 : -1;
+	}
+}
+
+/*!
+ * \brief parseLine Parses the fields of a data line into values by column meaning. Missing
+ *			trailing fields are treated as empty, and fields beyond the known columns are ignored.
+ * \param import Import options
+ * \param p Start of the line
+ * \param lineEnd End of the line
+ * \param line Parsed values
+ * \return 0 on success, -1 if a field is not a number
+ */
+static int parseLine(const ImportType* import, const char* p, const char* lineEnd, ParsedLineType* line) {
+	memset(line->isValid, 0, sizeof (line->isValid));
+	for (size_t c = 0; c < import->nColumns && p <= lineEnd; ++c) {
+		const char* fieldEnd = memchr(p, import->delimiter, (size_t) (lineEnd - p));
+		const TrajectoryColumnType column = import->columns[c];
+		double value = 0.0;
+		int result;
+
+		fieldEnd = fieldEnd != NULL ? fieldEnd : lineEnd;
+		if (column != TRAJECTORY_COLUMN_IGNORED) {
+			if ((result = parseNumber(p, fieldEnd, &value)) < 0) {
+				return -1;
+			}
+			line->values[column] = value;
+			line->isValid[column] = result > 0;
+		}
+		p = fieldEnd + 1;
+	}
+	return 0;
+}
+
+/*!
+ * \brief encodeLine Scales the parsed values of a line to a TRAJ point, in host byte order
+ * \param line Parsed values
+ * \param point Point to be filled
+ * \return 0 on success, -1 if a required field is missing or out of range
+ */
+static int encodeLine(const ParsedLineType* line, TRAJPointType* point) {
+	const double* v = line->values;
+	const bool* isValid = line->isValid;
+	struct timeval time;
+	CartesianPosition position;
+	SpeedType speed;
+	AccelerationType acceleration;
+	double seconds, heading;
+
+	if (!isValid[TRAJECTORY_COLUMN_TIME_S] || !isValid[TRAJECTORY_COLUMN_X_M] || !isValid[TRAJECTORY_COLUMN_Y_M]
+			|| !isValid[TRAJECTORY_COLUMN_LONGITUDINAL_SPEED_M_S]) {
+		return -1;
+	}
+	if (!(v[TRAJECTORY_COLUMN_TIME_S] >= 0.0 && v[TRAJECTORY_COLUMN_TIME_S] < UINT32_MAX / RELATIVE_TIME_ONE_SECOND_VALUE)) {
+		return -1;
+	}
+	seconds = floor(v[TRAJECTORY_COLUMN_TIME_S]);
+	time.tv_sec = (time_t) seconds;
+	time.tv_usec = (suseconds_t) lround((v[TRAJECTORY_COLUMN_TIME_S] - seconds) * MICROSECONDS_PER_SECOND);
+	if (time.tv_usec >= MICROSECONDS_PER_SECOND) {
+		time.tv_sec++;
+		time.tv_usec -= MICROSECONDS_PER_SECOND;
+	}
+
+	position.xCoord_m = v[TRAJECTORY_COLUMN_X_M];
+	position.yCoord_m = v[TRAJECTORY_COLUMN_Y_M];
+	position.zCoord_m = isValid[TRAJECTORY_COLUMN_Z_M] ? v[TRAJECTORY_COLUMN_Z_M] : 0.0;
+	position.isPositionValid = true;
+	position.isXcoordValid = true;
+	position.isYcoordValid = true;
+	position.isZcoordValid = isValid[TRAJECTORY_COLUMN_Z_M];
+	position.isHeadingValid = isValid[TRAJECTORY_COLUMN_HEADING_RAD] || isValid[TRAJECTORY_COLUMN_HEADING_DEG];
+	heading = isValid[TRAJECTORY_COLUMN_HEADING_RAD] ? v[TRAJECTORY_COLUMN_HEADING_RAD]
+													 : v[TRAJECTORY_COLUMN_HEADING_DEG] * M_PI / 180.0;
+	if (position.isHeadingValid) {
+		heading = fmod(heading, 2.0 * M_PI);
+		heading = heading < 0.0 ? heading + 2.0 * M_PI : heading;
+		position.heading_rad = heading < 2.0 * M_PI ? heading : 0.0;
+	}
+	else {
+		position.heading_rad = 0.0;
+	}
+
+	speed.longitudinal_m_s = v[TRAJECTORY_COLUMN_LONGITUDINAL_SPEED_M_S];
+	speed.isLongitudinalValid = true;
+	speed.lateral_m_s = v[TRAJECTORY_COLUMN_LATERAL_SPEED_M_S];
+	speed.isLateralValid = isValid[TRAJECTORY_COLUMN_LATERAL_SPEED_M_S];
+	acceleration.longitudinal_m_s2 = v[TRAJECTORY_COLUMN_LONGITUDINAL_ACCELERATION_M_S2];
+	acceleration.isLongitudinalValid = isValid[TRAJECTORY_COLUMN_LONGITUDINAL_ACCELERATION_M_S2];
+	acceleration.lateral_m_s2 = v[TRAJECTORY_COLUMN_LATERAL_ACCELERATION_M_S2];
+	acceleration.isLateralValid = isValid[TRAJECTORY_COLUMN_LATERAL_ACCELERATION_M_S2];
+
+	if (!isfinite(position.xCoord_m) || !isfinite(position.yCoord_m) || !isfinite(position.zCoord_m)
+			|| !isfinite(position.heading_rad) || !isfinite(speed.longitudinal_m_s)) {
+		return -1;
+	}
+	return convertTRAJPointToISORepresentation(&time, position, speed, acceleration,
+											   isValid[TRAJECTORY_COLUMN_CURVATURE]
+											   ? (float) v[TRAJECTORY_COLUMN_CURVATURE] : 0.0f,
+											   point) == MESSAGE_OK ? 0 : -1;
+}
+
+//! First pass, counting the lines and points of a chunk
+static void countChunk(const ImportType* import, ImportChunkType* chunk) {
+	const char* p = chunk->begin;
+
+	(void) import;
+	while (p < chunk->end) {
+		const char* lineEnd = findLineEnd(p, chunk->end);
+
+		chunk->nLines++;
+		chunk->nPoints += isDataLine(p, lineEnd);
+		p = lineEnd + 1;
+	}
+}
+
+//! Second pass, encoding the points of a chunk at their place in the message
+static void encodeChunk(const ImportType* import, ImportChunkType* chunk) {
+	char* const first = import->points + chunk->firstPoint * sizeof (TRAJPointType);
+	char* out = first;
+	const char* p = chunk->begin;
+	ParsedLineType line;
+	TRAJPointType point;
+
+	for (size_t lineNumber = chunk->firstLine; p < chunk->end; ++lineNumber) {
+		const char* lineEnd = findLineEnd(p, chunk->end);
+
+		if (isDataLine(p, lineEnd)) {
+			if (parseLine(import, p, lineEnd, &line) < 0 || encodeLine(&line, &point) < 0) {
+				chunk->errorLine = lineNumber;
+				return;
+			}
+			writeTRAJPoint(&point, out);
+			out += sizeof (TRAJPointType);
+		}
+		p = lineEnd + 1;
+	}
+
+	// Checksum quarters of the chunk together, as the table lookups of a single checksum are serial
+	const size_t length = (size_t) (out - first);
+	const uint8_t* parts[CRC_PARTS_PER_CHUNK];
+	size_t partLengths[CRC_PARTS_PER_CHUNK];
+	uint16_t partCRCs[CRC_PARTS_PER_CHUNK];
+
+	for (size_t i = 0; i < CRC_PARTS_PER_CHUNK; ++i) {
+		parts[i] = (const uint8_t*) first + i * (length / CRC_PARTS_PER_CHUNK);
+		partLengths[i] = i + 1 < CRC_PARTS_PER_CHUNK ? length / CRC_PARTS_PER_CHUNK
+													 : length - i * (length / CRC_PARTS_PER_CHUNK);
+	}
+	crc16Interleaved(parts, partLengths, CRC_PARTS_PER_CHUNK, partCRCs);
+	chunk->crc = partCRCs[0];
+	for (size_t i = 1; i < CRC_PARTS_PER_CHUNK; ++i) {
+		chunk->crc = crc16Combine(chunk->crc, partCRCs[i], partLengths[i]);
+	}
+}
+
+static void importChunkTask(void* arg, const unsigned int thread, const size_t chunk) {
+	ImportType* import = arg;
+
+	(void) thread;
+	import->pass(import, &import->chunks[chunk]);
+}
+
+/*!
+ * \brief runImportPass Runs a pass over all chunks, on the calling thread and up to nThreads - 1 more
+ * \param import Import in progress
+ * \param nThreads Number of threads to import on
+ * \param pass Function to run for each chunk
+ */
+static void runImportPass(ImportType* import, unsigned int nThreads,
+						  void (*pass)(const ImportType*, ImportChunkType*)) {
+	import->pass = pass;
+	runWorkers(importChunkTask, import, nThreads, import->nChunks);
+}
+
+/*!
+ * \brief parseHeader Finds the meaning of each column from its name. Names are matched without
+ *			regard to case, and unknown names are ignored.
+ * \param p Start of the header line
+ * \param lineEnd End of the header line
+ * \param delimiter Field separator
+ * \param columns Column meanings
+ * \return Number of columns, or -1 if there are too many
+ */
+static ssize_t parseHeader(const char* p, const char* lineEnd, const char delimiter, TrajectoryColumnType columns[]) {
+	size_t nColumns = 0;
+
+	while (p <= lineEnd) {
+		const char* fieldEnd = memchr(p, delimiter, (size_t) (lineEnd - p));
+		const char* nameEnd;
+
+		fieldEnd = fieldEnd != NULL ? fieldEnd : lineEnd;
+		nameEnd = fieldEnd;
+		while (p < nameEnd && (isBlank(*p) || *p == '"')) {
+			p++;
+		}
+		while (nameEnd > p && (isBlank(nameEnd[-1]) || nameEnd[-1] == '"')) {
+			nameEnd--;
+		}
+		if (nColumns == TRAJECTORY_IMPORT_MAX_COLUMNS) {
+			return -1;
+		}
+		columns[nColumns] = TRAJECTORY_COLUMN_IGNORED;
+		for (size_t i = 0; i < sizeof (columnNames) / sizeof (columnNames[0]); ++i) {
+			if (strlen(columnNames[i].name) == (size_t) (nameEnd - p)
+					&& strncasecmp(columnNames[i].name, p, (size_t) (nameEnd - p)) == 0) {
+				columns[nColumns] = columnNames[i].column;
+				break;
+			}
+		}
+		nColumns++;
+		p = fieldEnd + 1;
+	}
+	return (ssize_t) nColumns;
+}
+
+static bool hasRequiredColumns(const TrajectoryColumnType columns[], const size_t nColumns) {
+	bool hasColumn[N_COLUMN_TYPES] = { false };
+
+	for (size_t c = 0; c < nColumns; ++c) {
+		if ((size_t) columns[c] < N_COLUMN_TYPES) {
+			hasColumn[columns[c]] = true;
+		}
+	}
+	return hasColumn[TRAJECTORY_COLUMN_TIME_S] && hasColumn[TRAJECTORY_COLUMN_X_M] && hasColumn[TRAJECTORY_COLUMN_Y_M]
+		&& hasColumn[TRAJECTORY_COLUMN_LONGITUDINAL_SPEED_M_S];
+}
+
+/*!
+ * \brief splitChunks Splits text into chunks of whole lines
+ * \param import Import to which chunks are to be added
+ * \param text Start of the text
+ * \param end End of the text
+ * \param nThreads Number of threads the chunks are to be shared by
+ * \return 0 on success, -1 if memory could not be allocated
+ */
+static int splitChunks(ImportType* import, const char* text, const char* end, const unsigned int nThreads) {
+	const size_t length = (size_t) (end - text);
+	size_t chunkSize = length / ((size_t) nThreads * IMPORT_CHUNKS_PER_THREAD);
+	size_t maxChunks;
+
+	chunkSize = chunkSize > IMPORT_MIN_BYTES_PER_CHUNK ? chunkSize : IMPORT_MIN_BYTES_PER_CHUNK;
+	maxChunks = length / chunkSize + 1;
+	if ((import->chunks = calloc(maxChunks, sizeof (*import->chunks))) == NULL) {
+		return -1;
+	}
+	import->nChunks = 0;
+	for (const char* p = text; p < end; ) {
+		ImportChunkType* chunk = &import->chunks[import->nChunks++];
+		const char* chunkEnd = (size_t) (end - p) > chunkSize ? findLineEnd(p + chunkSize, end) : end;
+
+		chunk->begin = p;
+		chunk->end = chunkEnd < end ? chunkEnd + 1 : end;
+		p = chunk->end;
+	}
+	return 0;
+}
+
+/*!
+ * \brief importTrajectoryText Converts a trajectory in delimited text, one point per line, to an
+ *			encoded TRAJ message without storing the points in between. Blank lines and lines
+ *			starting with '#' are skipped. Unless columns are given in the options, the first other
+ *			line names the columns, e.g. "time,x,y,heading,speed". Times are in seconds and
+ *			positions in meters. Large texts are split at line boundaries and parsed in parallel,
+ *			each thread encoding its points straight into their place in the message.
+ * \param text Trajectory text, which need not be null terminated
+ * \param length Length of the text
+ * \param options Delimiter, columns and number of threads, or NULL for comma separated text with a
+ *			header line
+ * \param inputHeader Data to create the ISO header with
+ * \param trajectoryID ID of the trajectory
+ * \param trajectoryInfo Info of the trajectory
+ * \param trajectoryName A string of maximum length 63 excluding the null terminator
+ * \param nameLength Length of the name string excluding the null terminator
+ * \param trajDataBuffer Set to the encoded message, to be freed by the caller, or NULL on error
+ * \param statistics Number of lines and points, and the first line in error, may be NULL
+ * \return Length of the encoded message, or -1 in case of error with the following errnos:
+ *		EINVAL		if the columns are unknown or lack time, x, y or speed
+ *		EBADMSG		if a line could not be imported, as reported in the statistics
+ *		EMSGSIZE	if there are too many points for a TRAJ message or the name is too long
+ *		ENOMEM		if memory could not be allocated
+ */
+ssize_t importTrajectoryText(
+		const char* text,
+		const size_t length,
+		const TrajectoryImportOptionsType* options,
+		const MessageHeaderType* inputHeader,
+		const uint16_t trajectoryID,
+		const TrajectoryInfoType trajectoryInfo,
+		const char* trajectoryName,
+		const size_t nameLength,
+		char** trajDataBuffer,
+		TrajectoryImportStatisticsType* statistics) {
+
+	static const TrajectoryImportOptionsType defaultOptions = { 0 };
+	const char* const end = text + length;
+	const char* p = text;
+	TrajectoryColumnType headerColumns[TRAJECTORY_IMPORT_MAX_COLUMNS];
+	ImportType import;
+	TrajectoryImportStatisticsType result = { 0, 0, 0 };
+	size_t nLeadingLines = 0, errorLine = 0, messageLength;
+	unsigned int nThreads;
+	long nProcessors;
+	ssize_t retval;
+	uint16_t* trajectoryMessageCrc;
+
+	if ((text == NULL && length > 0) || trajDataBuffer == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Invalid trajectory text or output buffer");
+		return -1;
+	}
+	*trajDataBuffer = NULL;
+	if (statistics != NULL) {
+		memset(statistics, 0, sizeof (*statistics));
+	}
+	if (options == NULL) {
+		options = &defaultOptions;
+	}
+	memset(&import, 0, sizeof (import));
+	import.options = options;
+	import.delimiter = options->delimiter != 0 ? options->delimiter : ',';
+	import.columns = options->columns;
+	import.nColumns = options->nColumns;
+	if (import.nColumns > TRAJECTORY_IMPORT_MAX_COLUMNS) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Too many trajectory columns");
+		return -1;
+	}
+
+	// Skip comments up to the first line with content, which names the columns if it is not a number
+	while (p < end) {
+		const char* lineEnd = findLineEnd(p, end);
+
+		if (isDataLine(p, lineEnd)) {
+			if (isHeaderLine(p, lineEnd)) {
+				if (import.nColumns == 0) {
+					const ssize_t nColumns = parseHeader(p, lineEnd, import.delimiter, headerColumns);
+
+					if (nColumns < 0) {
+						errno = EINVAL;
+						ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Too many trajectory columns");
+						return -1;
+					}
+					import.columns = headerColumns;
+					import.nColumns = (size_t) nColumns;
+				}
+				nLeadingLines++;
+				p = lineEnd + 1;
+			}
+			break;
+		}
+		nLeadingLines++;
+		p = lineEnd + 1;
+	}
+	p = p < end ? p : end;
+	if (!hasRequiredColumns(import.columns, import.nColumns)) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0,
+						 "Trajectory columns must include time, x, y and longitudinal speed");
+		return -1;
+	}
+
+	nProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+	nThreads = options->nThreads != 0 ? options->nThreads : (nProcessors > 0 ? (unsigned int) nProcessors : 1);
+	if (splitChunks(&import, p, end, nThreads) < 0) {
+		errno = ENOMEM;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Unable to allocate trajectory import chunks");
+		return -1;
+	}
+
+	// Count points, so that every chunk knows where in the message its points go
+	runImportPass(&import, nThreads, countChunk);
+	result.nLines = nLeadingLines;
+	for (size_t c = 0; c < import.nChunks; ++c) {
+		import.chunks[c].firstLine = result.nLines + 1;
+		import.chunks[c].firstPoint = result.nPoints;
+		result.nLines += import.chunks[c].nLines;
+		result.nPoints += import.chunks[c].nPoints;
+	}
+	if (statistics != NULL) {
+		*statistics = result;
+	}
+	if (result.nPoints > (UINT32_MAX - getEncodedSizeTRAJMessage(0)) / sizeof (TRAJPointType)) {
+		free(import.chunks);
+		errno = EMSGSIZE;
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRAJ, 0, "Too many points for a TRAJ message");
+		return -1;
+	}
+	messageLength = getEncodedSizeTRAJMessage((uint32_t) result.nPoints);
+	if ((*trajDataBuffer = malloc(messageLength)) == NULL) {
+		free(import.chunks);
+		errno = ENOMEM;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Unable to allocate TRAJ message");
+		return -1;
+	}
+
+	retval = encodeTRAJMessageHeader(inputHeader, trajectoryID, trajectoryInfo, trajectoryName, nameLength,
+									 (uint32_t) result.nPoints, *trajDataBuffer, messageLength, false);
+	if (retval < 0) {
+		free(import.chunks);
+		free(*trajDataBuffer);
+		*trajDataBuffer = NULL;
+		return -1;
+	}
+	import.points = *trajDataBuffer + retval;
+
+	// Encode points, and combine the checksums of the chunks in order with that of the header
+	runImportPass(&import, nThreads, encodeChunk);
+	trajectoryMessageCrc = getCodecTrajectoryCRC(getActiveCodecContext());
+	for (size_t c = 0; c < import.nChunks && errorLine == 0; ++c) {
+		errorLine = import.chunks[c].errorLine;
+		*trajectoryMessageCrc = crc16Combine(*trajectoryMessageCrc, import.chunks[c].crc,
+											 import.chunks[c].nPoints * sizeof (TRAJPointType));
+	}
+	free(import.chunks);
+	if (errorLine != 0) {
+		if (statistics != NULL) {
+			statistics->errorLine = errorLine;
+		}
+		free(*trajDataBuffer);
+		*trajDataBuffer = NULL;
+		errno = EBADMSG;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Unable to import trajectory line %zu", errorLine);
+		return -1;
+	}
+
+	retval = encodeTRAJMessageFooter(import.points + result.nPoints * sizeof (TRAJPointType),
+									 sizeof (TRAJFooterType), false);
+	if (retval < 0) {
+		free(*trajDataBuffer);
+		*trajDataBuffer = NULL;
+		return -1;
+	}
+	return (ssize_t) messageLength;
+}
+
+/*!
+ * \brief importTrajectoryFile Converts a trajectory text file to an encoded TRAJ message as
+ *			::importTrajectoryText, parsing the file directly from a memory mapping
+ * \param path Path of the trajectory file
+ * \param options Delimiter, columns and number of threads, or NULL for defaults
+ * \param inputHeader Data to create the ISO header with
+ * \param trajectoryID ID of the trajectory
+ * \param trajectoryInfo Info of the trajectory
+ * \param trajectoryName A string of maximum length 63 excluding the null terminator
+ * \param nameLength Length of the name string excluding the null terminator
+ * \param trajDataBuffer Set to the encoded message, to be freed by the caller, or NULL on error
+ * \param statistics Number of lines and points, and the first line in error, may be NULL
+ * \return Length of the encoded message, or -1 with errno set as by ::importTrajectoryText or by
+ *			opening and mapping the file
+ */
+ssize_t importTrajectoryFile(
+		const char* path,
+		const TrajectoryImportOptionsType* options,
+		const MessageHeaderType* inputHeader,
+		const uint16_t trajectoryID,
+		const TrajectoryInfoType trajectoryInfo,
+		const char* trajectoryName,
+		const size_t nameLength,
+		char** trajDataBuffer,
+		TrajectoryImportStatisticsType* statistics) {
+
+	struct stat fileStatus;
+	void* data = NULL;
+	size_t size;
+	ssize_t retval;
+	int fd, error;
+
+	if (path == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0) {
+		return -1;
+	}
+	if (fstat(fd, &fileStatus) < 0) {
+		error = errno;
+		close(fd);
+		errno = error;
+		return -1;
+	}
+	size = (size_t) fileStatus.st_size;
+	if (size > 0) {
+		data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	error = errno;
+	close(fd);
+	if (data == MAP_FAILED) {
+		errno = error;
+		return -1;
+	}
+	if (data != NULL) {
+		madvise(data, size, MADV_SEQUENTIAL);
+	}
+
+	retval = importTrajectoryText(data, size, options, inputHeader, trajectoryID, trajectoryInfo,
+								  trajectoryName, nameLength, trajDataBuffer, statistics);
+	error = errno;
+	if (data != NULL) {
+		munmap(data, size);
+	}
+	errno = error;
+	return retval;
+}
@@ -0,0 +1,370 @@
+#include "trajectoryindex.h"
+#include "isoerror.h"
+#include "timeconversions.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+//! Validity of the fields of a trajectory point
+enum {
+	POINT_X_VALID = 1 << 0,
+	POINT_Y_VALID = 1 << 1,
+	POINT_Z_VALID = 1 << 2,
+	POINT_POSITION_VALID = 1 << 3,
+	POINT_HEADING_VALID = 1 << 4,
+	POINT_LONGITUDINAL_SPEED_VALID = 1 << 5,
+	POINT_LATERAL_SPEED_VALID = 1 << 6,
+	POINT_LONGITUDINAL_ACCELERATION_VALID = 1 << 7,
+	POINT_LATERAL_ACCELERATION_VALID = 1 << 8
+};
+
+//! Trajectory points stored as columns, in one allocation starting with the time column
+struct TrajectoryIndex {
+	size_t nPoints;
+	int64_t* time_us;					//!< Time from start of trajectory, nondecreasing
+	double* x_m;
+	double* y_m;
+	double* z_m;
+	double* heading_rad;
+	double* longitudinalSpeed_m_s;
+	double* lateralSpeed_m_s;
+	double* longitudinalAcceleration_m_s2;
+	double* lateralAcceleration_m_s2;
+	float* curvature;
+	uint16_t* validity;
+};
+
+static uint16_t getPointValidity(const TrajectoryWaypointType* waypoint) {
+	return (uint16_t) ((waypoint->pos.isXcoordValid ? POINT_X_VALID : 0)
+					   | (waypoint->pos.isYcoordValid ? POINT_Y_VALID : 0)
+					   | (waypoint->pos.isZcoordValid ? POINT_Z_VALID : 0)
+					   | (waypoint->pos.isPositionValid ? POINT_POSITION_VALID : 0)
+					   | (waypoint->pos.isHeadingValid ? POINT_HEADING_VALID : 0)
+					   | (waypoint->spd.isLongitudinalValid ? POINT_LONGITUDINAL_SPEED_VALID : 0)
+					   | (waypoint->spd.isLateralValid ? POINT_LATERAL_SPEED_VALID : 0)
+					   | (waypoint->acc.isLongitudinalValid ? POINT_LONGITUDINAL_ACCELERATION_VALID : 0)
+					   | (waypoint->acc.isLateralValid ? POINT_LATERAL_ACCELERATION_VALID : 0));
+}
+
+/*!
+ * \brief createTrajectoryIndex Creates an index for looking up interpolated points of a trajectory
+ *			by time. The waypoints are copied, and need not be kept.
+ * \param waypoints Trajectory, e.g. decoded from TRAJ, with nondecreasing times
+ * \param nWaypoints Number of waypoints, at least one
+ * \return The index, or NULL otherwise with errno set to
+ *		EINVAL		if the waypoint times decrease
+ *		ENOMEM		if memory could not be allocated
+ */
+TrajectoryIndexType* createTrajectoryIndex(
+		const TrajectoryWaypointType waypoints[],
+		const size_t nWaypoints) {
+	TrajectoryIndexType* index;
+
+	if (waypoints == NULL || nWaypoints == 0) {
+		errno = EINVAL;
+		return NULL;
+	}
+	for (size_t i = 1; i < nWaypoints; ++i) {
+		if (timevalToMicroseconds(&waypoints[i].relativeTime) < timevalToMicroseconds(&waypoints[i - 1].relativeTime)) {
+			errno = EINVAL;
+			ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0,
+							 "Trajectory point %zu is earlier than the point before it", i);
+			return NULL;
+		}
+	}
+
+	const size_t columnsSize = nWaypoints * (sizeof (int64_t) + 8 * sizeof (double)
+											 + sizeof (float) + sizeof (uint16_t));
+	if ((index = malloc(sizeof (*index))) == NULL
+			|| (index->time_us = malloc(columnsSize)) == NULL) {
+		free(index);
+		errno = ENOMEM;
+		return NULL;
+	}
+	index->nPoints = nWaypoints;
+	index->x_m = (double*) (index->time_us + nWaypoints);
+	index->y_m = index->x_m + nWaypoints;
+	index->z_m = index->y_m + nWaypoints;
+	index->heading_rad = index->z_m + nWaypoints;
+	index->longitudinalSpeed_m_s = index->heading_rad + nWaypoints;
+	index->lateralSpeed_m_s = index->longitudinalSpeed_m_s + nWaypoints;
+	index->longitudinalAcceleration_m_s2 = index->lateralSpeed_m_s + nWaypoints;
+	index->lateralAcceleration_m_s2 = index->longitudinalAcceleration_m_s2 + nWaypoints;
+	index->curvature = (float*) (index->lateralAcceleration_m_s2 + nWaypoints);
+	index->validity = (uint16_t*) (index->curvature + nWaypoints);
+
+	for (size_t i = 0; i < nWaypoints; ++i) {
+		const TrajectoryWaypointType* waypoint = &waypoints[i];
+		index->time_us[i] = timevalToMicroseconds(&waypoint->relativeTime);
+		index->x_m[i] = waypoint->pos.xCoord_m;
+		index->y_m[i] = waypoint->pos.yCoord_m;
+		index->z_m[i] = waypoint->pos.zCoord_m;
+		index->heading_rad[i] = waypoint->pos.heading_rad;
+		index->longitudinalSpeed_m_s[i] = waypoint->spd.longitudinal_m_s;
+		index->lateralSpeed_m_s[i] = waypoint->spd.lateral_m_s;
+		index->longitudinalAcceleration_m_s2[i] = waypoint->acc.longitudinal_m_s2;
+		index->lateralAcceleration_m_s2[i] = waypoint->acc.lateral_m_s2;
+		index->curvature[i] = waypoint->curvature;
+		index->validity[i] = getPointValidity(waypoint);
+	}
+	return index;
+}
+
+/*!
+ * \brief freeTrajectoryIndex Frees an index. Cursors into it may no longer be used.
+ * \param index Index to free, may be NULL
+ */
+void freeTrajectoryIndex(TrajectoryIndexType* index) {
+	if (index == NULL) {
+		return;
+	}
+	free(index->time_us);
+	free(index);
+}
+
+/*!
+ * \brief initTrajectoryCursor Places a cursor at the start of a trajectory
+ * \param cursor Cursor to initialise
+ * \param index Index the cursor looks up points in
+ */
+void initTrajectoryCursor(
+		TrajectoryCursorType* cursor,
+		const TrajectoryIndexType* index) {
+	cursor->index = index;
+	cursor->segment = 0;
+}
+
+//! Index of the first point in a range later than a time, or the end of the range if there is none
+static size_t upperBoundTime(const TrajectoryIndexType* index, size_t low, size_t high, const int64_t time_us) {
+	while (low < high) {
+		const size_t middle = low + (high - low) / 2;
+		if (index->time_us[middle] <= time_us) {
+			low = middle + 1;
+		}
+		else {
+			high = middle;
+		}
+	}
+	return low;
+}
+
+/*!
+ * \brief findSegment Finds the segment, starting at a trajectory point, in which a time lies.
+ *			Segments from the hint onwards are searched with exponentially growing steps, so that
+ *			a time in or just after the hinted segment is found in constant time.
+ * \param index Index to search, with at least two points
+ * \param hint Segment to start searching from
+ * \param time_us Time to find
+ * \return The last segment starting at or before the time, or the first segment
+ */
+static size_t findSegment(const TrajectoryIndexType* index, const size_t hint, const int64_t time_us) {
+	const size_t lastPoint = index->nPoints - 1;
+
+	if (time_us < index->time_us[hint]) {
+		const size_t end = upperBoundTime(index, 1, hint + 1, time_us);
+		return end - 1;
+	}
+	size_t low = hint + 1, high = low, step = 1;
+	while (high < lastPoint && index->time_us[high] <= time_us) {
+		low = high + 1;
+		high += step;
+		step *= 2;
+	}
+	return upperBoundTime(index, low, high < lastPoint ? high : lastPoint, time_us) - 1;
+}
+
+static inline double interpolate(const double* column, const size_t i, const size_t next, const double fraction) {
+	return column[i] + fraction * (column[next] - column[i]);
+}
+
+//! Interpolates heading along the shorter turn, into the range [0, 2π)
+static inline double interpolateHeading(const double* column, const size_t i, const size_t next,
+										const double fraction) {
+	double difference = column[next] - column[i];
+
+	if (difference > M_PI) {
+		difference -= 2.0 * M_PI;
+	}
+	else if (difference < -M_PI) {
+		difference += 2.0 * M_PI;
+	}
+	double heading = column[i] + fraction * difference;
+	if (heading < 0.0) {
+		heading += 2.0 * M_PI;
+	}
+	else if (heading >= 2.0 * M_PI) {
+		heading -= 2.0 * M_PI;
+	}
+	return heading;
+}
+
+/*!
+ * \brief evaluateSegment Interpolates a trajectory point in a segment. Times outside the trajectory
+ *			are clamped to its ends.
+ * \param index Index holding the trajectory
+ * \param i Segment to interpolate in, or 0 for a trajectory of one point
+ * \param time_us Time of the point
+ * \param point Interpolated point. Fields are valid if valid at both ends of the segment.
+ * \return 0 if the time is within the trajectory, -1 with errno set to ERANGE otherwise
+ */
+static int evaluateSegment(const TrajectoryIndexType* index, const size_t i, int64_t time_us,
+						   TrajectoryWaypointType* point) {
+	const size_t next = index->nPoints > 1 ? i + 1 : i;
+	const int64_t duration_us = index->time_us[next] - index->time_us[i];
+	int retval = 0;
+
+	if (time_us < index->time_us[0] || time_us > index->time_us[index->nPoints - 1]) {
+		time_us = time_us < index->time_us[0] ? index->time_us[0] : index->time_us[index->nPoints - 1];
+		errno = ERANGE;
+		retval = -1;
+	}
+	double fraction = duration_us > 0 ? (double) (time_us - index->time_us[i]) / (double) duration_us : 0.0;
+	fraction = fraction < 0.0 ? 0.0 : fraction > 1.0 ? 1.0 : fraction;
+
+	const uint16_t validity = index->validity[i] & index->validity[next];
+	point->relativeTime.tv_sec = (time_t) (time_us / MICROSECONDS_PER_SECOND);
+	point->relativeTime.tv_usec = (suseconds_t) (time_us % MICROSECONDS_PER_SECOND);
+	if (point->relativeTime.tv_usec < 0) {
+		point->relativeTime.tv_sec--;
+		point->relativeTime.tv_usec += MICROSECONDS_PER_SECOND;
+	}
+	point->pos.xCoord_m = interpolate(index->x_m, i, next, fraction);
+	point->pos.yCoord_m = interpolate(index->y_m, i, next, fraction);
+	point->pos.zCoord_m = interpolate(index->z_m, i, next, fraction);
+	point->pos.heading_rad = interpolateHeading(index->heading_rad, i, next, fraction);
+	point->pos.isXcoordValid = (validity & POINT_X_VALID) != 0;
+	point->pos.isYcoordValid = (validity & POINT_Y_VALID) != 0;
+	point->pos.isZcoordValid = (validity & POINT_Z_VALID) != 0;
+	point->pos.isPositionValid = (validity & POINT_POSITION_VALID) != 0;
+	point->pos.isHeadingValid = (validity & POINT_HEADING_VALID) != 0;
+	point->spd.longitudinal_m_s = interpolate(index->longitudinalSpeed_m_s, i, next, fraction);
+	point->spd.lateral_m_s = interpolate(index->lateralSpeed_m_s, i, next, fraction);
+	point->spd.isLongitudinalValid = (validity & POINT_LONGITUDINAL_SPEED_VALID) != 0;
+	point->spd.isLateralValid = (validity & POINT_LATERAL_SPEED_VALID) != 0;
+	point->acc.longitudinal_m_s2 = interpolate(index->longitudinalAcceleration_m_s2, i, next, fraction);
+	point->acc.lateral_m_s2 = interpolate(index->lateralAcceleration_m_s2, i, next, fraction);
+	point->acc.isLongitudinalValid = (validity & POINT_LONGITUDINAL_ACCELERATION_VALID) != 0;
+	point->acc.isLateralValid = (validity & POINT_LATERAL_ACCELERATION_VALID) != 0;
+	point->curvature = index->curvature[i] + (float) fraction * (index->curvature[next] - index->curvature[i]);
+	return retval;
+}
+
+/*!
+ * \brief getTrajectoryPointAt Interpolates the point of a trajectory at a time, found by binary search
+ * \param index Index holding the trajectory
+ * \param relativeTime Time from the start of the trajectory
+ * \param point Interpolated point. Fields are valid if valid at both of the surrounding waypoints.
+ * \return 0 on success, or -1 with errno set to
+ *		ERANGE		if the time is outside the trajectory, in which case the nearest end is returned
+ *		EINVAL		if an argument is NULL
+ */
+int getTrajectoryPointAt(
+		const TrajectoryIndexType* index,
+		const struct timeval* relativeTime,
+		TrajectoryWaypointType* point) {
+	if (index == NULL || relativeTime == NULL || point == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	const int64_t time_us = timevalToMicroseconds(relativeTime);
+	const size_t segment = index->nPoints > 1 ? upperBoundTime(index, 1, index->nPoints - 1, time_us) - 1 : 0;
+	return evaluateSegment(index, segment, time_us, point);
+}
+
+/*!
+ * \brief getTrajectoryPointAtCursor Interpolates the point of a trajectory at a time, searching from
+ *			the segment of the previous lookup with the cursor. Increasing times take amortised constant
+ *			time, and earlier times are found by binary search.
+ * \param cursor Cursor into the index, moved to the segment of the time
+ * \param relativeTime Time from the start of the trajectory
+ * \param point Interpolated point, as for ::getTrajectoryPointAt
+ * \return 0 on success, or -1 with errno set as for ::getTrajectoryPointAt
+ */
+int getTrajectoryPointAtCursor(
+		TrajectoryCursorType* cursor,
+		const struct timeval* relativeTime,
+		TrajectoryWaypointType* point) {
+	if (cursor == NULL || cursor->index == NULL || relativeTime == NULL || point == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	const TrajectoryIndexType* index = cursor->index;
+	const int64_t time_us = timevalToMicroseconds(relativeTime);
+	if (index->nPoints > 1) {
+		cursor->segment = findSegment(index, cursor->segment, time_us);
+	}
+	return evaluateSegment(index, cursor->segment, time_us, point);
+}
+
+/*!
+ * \brief seekTrajectoryCursor Moves a cursor to the segment in which a time lies, as for
+ *			::getTrajectoryPointAtCursor, without interpolating
+ * \param cursor Cursor into the index
+ * \param relativeTime_us Time from the start of the trajectory
+ * \return The segment, i.e. the index of the last point at or before the time. Times before the
+ *			trajectory give the first segment and times after it the last.
+ */
+size_t seekTrajectoryCursor(
+		TrajectoryCursorType* cursor,
+		const int64_t relativeTime_us) {
+	if (cursor->index->nPoints > 1) {
+		cursor->segment = findSegment(cursor->index, cursor->segment, relativeTime_us);
+	}
+	return cursor->segment;
+}
+
+/*!
+ * \brief getTrajectoryColumns Gets the points of an index as columns, for evaluating many
+ *			trajectories together
+ * \param index Index to read
+ * \return Read only columns of the index, valid as long as the index
+ */
+TrajectoryColumnsType getTrajectoryColumns(const TrajectoryIndexType* index) {
+	TrajectoryColumnsType columns;
+
+	columns.nPoints = index->nPoints;
+	columns.time_us = index->time_us;
+	columns.x_m = index->x_m;
+	columns.y_m = index->y_m;
+	columns.z_m = index->z_m;
+	columns.heading_rad = index->heading_rad;
+	columns.longitudinalSpeed_m_s = index->longitudinalSpeed_m_s;
+	columns.lateralSpeed_m_s = index->lateralSpeed_m_s;
+	columns.longitudinalAcceleration_m_s2 = index->longitudinalAcceleration_m_s2;
+	columns.lateralAcceleration_m_s2 = index->lateralAcceleration_m_s2;
+	columns.curvature = index->curvature;
+	return columns;
+}
+
+/*!
+ * \brief getTrajectoryPointsAt Interpolates the points of a trajectory at several times. Sorted
+ *			times take amortised constant time each.
+ * \param index Index holding the trajectory
+ * \param relativeTimes Times from the start of the trajectory
+ * \param nTimes Number of times
+ * \param points Array of at least nTimes points, in which to store the interpolated points. Points
+ *			for times outside the trajectory hold the nearest end.
+ * \return Number of times within the trajectory
+ */
+size_t getTrajectoryPointsAt(
+		const TrajectoryIndexType* index,
+		const struct timeval relativeTimes[],
+		const size_t nTimes,
+		TrajectoryWaypointType points[]) {
+	size_t segment = 0, nWithin = 0;
+
+	if (index == NULL || relativeTimes == NULL || points == NULL) {
+		errno = EINVAL;
+		return 0;
+	}
+	for (size_t i = 0; i < nTimes; ++i) {
+		const int64_t time_us = timevalToMicroseconds(&relativeTimes[i]);
+		if (index->nPoints > 1) {
+			segment = findSegment(index, segment, time_us);
+		}
+		nWithin += evaluateSegment(index, segment, time_us, &points[i]) == 0;
+	}
+	return nWithin;
+}
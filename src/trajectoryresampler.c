@@ -0,0 +1,420 @@
+#include "trajectoryresampler.h"
+#include "isoerror.h"
+#include "timeconversions.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+//! Below this speed heading is held and curvature is zero, as both are dominated by noise
+#define RESAMPLER_MIN_MOVING_SPEED_M_S 0.01
+//! Fraction of a step below which the end of the trajectory replaces the last step, rather than
+//! following it as a tiny step with noisy derivatives
+#define RESAMPLER_MIN_END_STEP 0.1
+//! Double columns of a resampled trajectory: output fields, then working columns
+#define RESAMPLER_N_DOUBLE_COLUMNS 14
+
+struct TrajectoryResampler {
+	size_t capacity;
+	void* frame;						//!< Columns for the capacity, in one allocation
+	int64_t* time_us;
+	double* x_m;
+	double* y_m;
+	double* z_m;
+	double* heading_rad;
+	double* longitudinalSpeed_m_s;
+	double* lateralSpeed_m_s;
+	double* longitudinalAcceleration_m_s2;
+	double* lateralAcceleration_m_s2;
+	double* time_s;						//!< From the first input point
+	double* xRate;						//!< First and second derivatives with respect to time
+	double* yRate;
+	double* xSecondRate;
+	double* ySecondRate;
+	double* fraction;					//!< Of the input segment at each output point
+	size_t* segment;
+	float* curvature;
+
+	size_t inputCapacity;
+	double* parameter;					//!< Time or arc length at each input point
+};
+
+/*!
+ * \brief createTrajectoryResampler Creates a resampler, whose columns grow with the trajectories
+ * \return The resampler, or NULL if it could not be allocated
+ */
+TrajectoryResamplerType* createTrajectoryResampler(void) {
+	return calloc(1, sizeof (TrajectoryResamplerType));
+}
+
+/*!
+ * \brief freeTrajectoryResampler Frees a resampler and its output columns
+ * \param resampler Resampler to free, may be NULL
+ */
+void freeTrajectoryResampler(TrajectoryResamplerType* resampler) {
+	if (resampler == NULL) {
+		return;
+	}
+	free(resampler->frame);
+	free(resampler->parameter);
+	free(resampler);
+}
+
+/*!
+ * \brief reserveResampledPoints Makes room for a number of output and input points. Columns hold
+ *			nothing between resamplings, so are reallocated without copying.
+ * \param resampler Resampler to enlarge
+ * \param nPoints Number of output points
+ * \param nInputPoints Number of input points
+ * \return 0 on success, -1 otherwise
+ */
+static int reserveResampledPoints(TrajectoryResamplerType* resampler, const size_t nPoints,
+								  const size_t nInputPoints) {
+	if (nPoints > resampler->capacity) {
+		const size_t capacity = nPoints > 2 * resampler->capacity ? nPoints : 2 * resampler->capacity;
+		void* frame = malloc(capacity * (sizeof (int64_t) + RESAMPLER_N_DOUBLE_COLUMNS * sizeof (double)
+										 + sizeof (size_t) + sizeof (float)));
+		double* column;
+
+		if (frame == NULL) {
+			errno = ENOMEM;
+			return -1;
+		}
+		free(resampler->frame);
+		resampler->frame = frame;
+		resampler->capacity = capacity;
+		resampler->time_us = frame;
+		column = (double*) (resampler->time_us + capacity);
+		double** doubleColumns[RESAMPLER_N_DOUBLE_COLUMNS] = {
+			&resampler->x_m, &resampler->y_m, &resampler->z_m, &resampler->heading_rad,
+			&resampler->longitudinalSpeed_m_s, &resampler->lateralSpeed_m_s,
+			&resampler->longitudinalAcceleration_m_s2, &resampler->lateralAcceleration_m_s2,
+			&resampler->time_s, &resampler->xRate, &resampler->yRate, &resampler->xSecondRate,
+			&resampler->ySecondRate, &resampler->fraction
+		};
+		for (size_t i = 0; i < RESAMPLER_N_DOUBLE_COLUMNS; ++i) {
+			*doubleColumns[i] = column;
+			column += capacity;
+		}
+		resampler->segment = (size_t*) column;
+		resampler->curvature = (float*) (resampler->segment + capacity);
+	}
+	if (nInputPoints > resampler->inputCapacity) {
+		double* parameter = malloc(nInputPoints * sizeof (double));
+
+		if (parameter == NULL) {
+			errno = ENOMEM;
+			return -1;
+		}
+		free(resampler->parameter);
+		resampler->parameter = parameter;
+		resampler->inputCapacity = nInputPoints;
+	}
+	return 0;
+}
+
+/*!
+ * \brief computeInputParameter Computes the time since the first point, or the planar arc length
+ *			from it, at each input point
+ * \param input Input trajectory
+ * \param mode Resampling mode
+ * \param parameter Column to be filled
+ */
+static void computeInputParameter(const TrajectoryColumnsType* input, const TrajectoryResampleModeType mode,
+								  double* restrict parameter) {
+	const size_t n = input->nPoints;
+	const int64_t* restrict time_us = input->time_us;
+	const double* restrict x = input->x_m;
+	const double* restrict y = input->y_m;
+
+	if (mode != TRAJECTORY_RESAMPLE_DISTANCE) {
+		for (size_t i = 0; i < n; ++i) {
+			parameter[i] = (double) (time_us[i] - time_us[0]) / MICROSECONDS_PER_SECOND;
+		}
+		return;
+	}
+	// Segment lengths in one loop and their running sum in another, as only the first vectorises
+	parameter[0] = 0.0;
+	for (size_t i = 1; i < n; ++i) {
+		const double dx = x[i] - x[i - 1];
+		const double dy = y[i] - y[i - 1];
+		parameter[i] = sqrt(dx * dx + dy * dy);
+	}
+	for (size_t i = 1; i < n; ++i) {
+		parameter[i] += parameter[i - 1];
+	}
+}
+
+/*!
+ * \brief countResampledPoints Counts the points at every step from the start, plus the end of the
+ *			trajectory. An end within ::RESAMPLER_MIN_END_STEP of a step past the last one replaces it,
+ *			and a trajectory of zero length is the start alone.
+ * \param length Time or arc length of the trajectory
+ * \param step Time or arc length step
+ * \return Number of points, or 0 if there would be more than a TRAJ message can hold
+ */
+static size_t countResampledPoints(const double length, const double step) {
+	const double nSteps = floor(length / step);
+
+	if (!(length > 0.0)) {
+		return 1;
+	}
+	if (nSteps >= (double) UINT32_MAX) {
+		return 0;
+	}
+	if (nSteps >= 1.0 && length - nSteps * step < RESAMPLER_MIN_END_STEP * step) {
+		return (size_t) nSteps + 1;
+	}
+	return (size_t) nSteps + 2;
+}
+
+/*!
+ * \brief locateResampledPoints Finds the input segment and the fraction of it at which each output
+ *			point lies, walking the input once
+ * \param resampler Resampler with room for the output points
+ * \param nInputPoints Number of input points, at least two
+ * \param nPoints Number of output points
+ * \param step Time or arc length step, or 0 to keep the input points
+ */
+static void locateResampledPoints(TrajectoryResamplerType* resampler, const size_t nInputPoints,
+								  const size_t nPoints, const double step) {
+	const double* parameter = resampler->parameter;
+	const double length = parameter[nInputPoints - 1];
+	size_t segment = 0;
+
+	for (size_t k = 0; k < nPoints; ++k) {
+		const double target = step > 0.0 ? (k + 1 < nPoints ? (double) k * step : length) : parameter[k];
+
+		while (segment + 2 < nInputPoints && parameter[segment + 1] < target) {
+			segment++;
+		}
+		const double segmentLength = parameter[segment + 1] - parameter[segment];
+		const double fraction = segmentLength > 0.0 ? (target - parameter[segment]) / segmentLength : 0.0;
+		resampler->segment[k] = segment;
+		resampler->fraction[k] = fraction < 0.0 ? 0.0 : fraction > 1.0 ? 1.0 : fraction;
+	}
+}
+
+//! Linear interpolation of an input column at the located output points
+static void interpolateColumn(const double* restrict input, const size_t* restrict segment,
+							  const double* restrict fraction, const size_t nPoints, double* restrict output) {
+	for (size_t k = 0; k < nPoints; ++k) {
+		const double first = input[segment[k]];
+		output[k] = first + fraction[k] * (input[segment[k] + 1] - first);
+	}
+}
+
+/*!
+ * \brief differentiate Computes first and second time derivatives of a column. Each point uses the
+ *			quadratic through it and its neighbours, the end points that of the nearest three points,
+ *			so that spacing may vary and both derivatives come from the same fit.
+ * \param time_s Strictly increasing times
+ * \param f Column to differentiate
+ * \param n Number of points, at least three
+ * \param rate First derivative
+ * \param secondRate Second derivative
+ */
+static void differentiate(const double* restrict time_s, const double* restrict f, const size_t n,
+						  double* restrict rate, double* restrict secondRate) {
+	for (size_t i = 1; i + 1 < n; ++i) {
+		const double h1 = time_s[i] - time_s[i - 1];
+		const double h2 = time_s[i + 1] - time_s[i];
+		const double d1 = (f[i] - f[i - 1]) / h1;
+		const double d2 = (f[i + 1] - f[i]) / h2;
+
+		rate[i] = (h2 * d1 + h1 * d2) / (h1 + h2);
+		secondRate[i] = 2.0 * (d2 - d1) / (h1 + h2);
+	}
+	const double h1 = time_s[1] - time_s[0];
+	const double h2 = time_s[n - 1] - time_s[n - 2];
+
+	rate[0] = rate[1] - h1 * secondRate[1];
+	secondRate[0] = secondRate[1];
+	rate[n - 1] = rate[n - 2] + h2 * secondRate[n - 2];
+	secondRate[n - 1] = secondRate[n - 2];
+}
+
+/*!
+ * \brief computeKinematics Derives speed, acceleration and curvature along the path from the
+ *			velocity and acceleration vectors. Lateral speed is zero, as heading follows the path.
+ * \param vx Velocity along x
+ * \param vy Velocity along y
+ * \param ax Acceleration along x
+ * \param ay Acceleration along y
+ * \param n Number of points
+ * \param speed Speed along the path
+ * \param lateralSpeed Speed across the path
+ * \param longitudinalAcceleration Acceleration along the path
+ * \param lateralAcceleration Acceleration across the path, positive to the left
+ * \param curvature Curvature of the path, positive to the left
+ */
+static void computeKinematics(const double* restrict vx, const double* restrict vy, const double* restrict ax,
+							  const double* restrict ay, const size_t n, double* restrict speed,
+							  double* restrict lateralSpeed, double* restrict longitudinalAcceleration,
+							  double* restrict lateralAcceleration, float* restrict curvature) {
+	for (size_t i = 0; i < n; ++i) {
+		const double v = sqrt(vx[i] * vx[i] + vy[i] * vy[i]);
+		const bool isMoving = v >= RESAMPLER_MIN_MOVING_SPEED_M_S;
+		// Computed for all points and masked, so that the loop has no branches
+		const double inverseSpeed = (isMoving ? 1.0 : 0.0) / (isMoving ? v : RESAMPLER_MIN_MOVING_SPEED_M_S);
+		const double cross = vx[i] * ay[i] - vy[i] * ax[i];
+		const double magnitude = sqrt(ax[i] * ax[i] + ay[i] * ay[i]);
+
+		speed[i] = v;
+		lateralSpeed[i] = 0.0;
+		// From standstill all acceleration is along the coming motion
+		longitudinalAcceleration[i] = isMoving ? (vx[i] * ax[i] + vy[i] * ay[i]) * inverseSpeed : magnitude;
+		lateralAcceleration[i] = cross * inverseSpeed;
+		curvature[i] = (float) (cross * inverseSpeed * inverseSpeed * inverseSpeed);
+	}
+}
+
+/*!
+ * \brief computeHeading Computes heading in [0, 2π) along the velocity. While standing still the
+ *			heading of the nearest motion before, or else after, is held.
+ * \param resampler Resampler holding the velocities of n points
+ * \param n Number of points
+ */
+static void computeHeading(TrajectoryResamplerType* resampler, const size_t n) {
+	double* heading = resampler->heading_rad;
+	size_t firstMoving = n;
+	double held = 0.0;
+
+	for (size_t i = 0; i < n; ++i) {
+		if (resampler->longitudinalSpeed_m_s[i] >= RESAMPLER_MIN_MOVING_SPEED_M_S) {
+			const double angle = atan2(resampler->yRate[i], resampler->xRate[i]);
+			held = angle < 0.0 ? angle + 2.0 * M_PI : angle;
+			firstMoving = firstMoving < i ? firstMoving : i;
+		}
+		heading[i] = held;
+	}
+	for (size_t i = 0; i < firstMoving && firstMoving < n; ++i) {
+		heading[i] = heading[firstMoving];
+	}
+}
+
+/*!
+ * \brief resampleTrajectory Resamples a trajectory at a fixed time or arc length step, and derives
+ *			heading, speed, acceleration and curvature from the positions by finite differences.
+ *			Positions and times are interpolated linearly between input points, so the input should
+ *			be sampled more densely than the output. The end of the trajectory is always included,
+ *			in place of the last step if it lies less than a tenth of a step beyond it. A single
+ *			point, or in distance mode a trajectory which does not move, gives its first point alone.
+ *			Each step runs as a loop over contiguous columns, which the compiler vectorises. The
+ *			output columns suit ::encodeTRAJMessageColumns.
+ * \param resampler Resampler holding the output columns
+ * \param input Trajectory with strictly increasing times and x and y positions. Other columns are
+ *			not used, except z which may be NULL.
+ * \param options Mode and step of the resampling
+ * \param output Columns of the resampled trajectory, valid until the next resampling
+ * \return Number of output points, or -1 with errno set to
+ *		EINVAL		if the trajectory or step is invalid
+ *		EMSGSIZE	if the step gives more points than a TRAJ message can hold
+ *		ENOMEM		if memory could not be allocated
+ */
+ssize_t resampleTrajectory(
+		TrajectoryResamplerType* resampler,
+		const TrajectoryColumnsType* input,
+		const TrajectoryResampleOptionsType* options,
+		TrajectoryColumnsType* output) {
+	if (resampler == NULL || input == NULL || options == NULL || output == NULL || input->nPoints == 0
+			|| input->time_us == NULL || input->x_m == NULL || input->y_m == NULL
+			|| (options->mode != TRAJECTORY_RESAMPLE_NONE && !(options->step > 0.0))) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0, "Invalid trajectory resampling input");
+		return -1;
+	}
+	const size_t nInputPoints = input->nPoints;
+	for (size_t i = 1; i < nInputPoints; ++i) {
+		if (input->time_us[i] <= input->time_us[i - 1]) {
+			errno = EINVAL;
+			ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0,
+							 "Trajectory point %zu is not later than the point before it", i);
+			return -1;
+		}
+	}
+	if (reserveResampledPoints(resampler, 0, nInputPoints) < 0) {
+		return -1;
+	}
+	computeInputParameter(input, options->mode, resampler->parameter);
+
+	const double step = options->mode != TRAJECTORY_RESAMPLE_NONE ? options->step : 0.0;
+	const size_t nPoints = step > 0.0 ? countResampledPoints(resampler->parameter[nInputPoints - 1], step)
+									  : nInputPoints;
+	if (nPoints == 0) {
+		errno = EMSGSIZE;
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, MESSAGE_ID_TRAJ, 0,
+						 "Resampling step %f gives too many points for a TRAJ message", step);
+		return -1;
+	}
+	if (reserveResampledPoints(resampler, nPoints, nInputPoints) < 0) {
+		return -1;
+	}
+
+	if (nInputPoints == 1) {
+		resampler->time_s[0] = 0.0;
+		resampler->x_m[0] = input->x_m[0];
+		resampler->y_m[0] = input->y_m[0];
+		resampler->z_m[0] = input->z_m != NULL ? input->z_m[0] : 0.0;
+	}
+	else {
+		const double* parameter = resampler->parameter;
+
+		locateResampledPoints(resampler, nInputPoints, nPoints, step);
+		if (options->mode == TRAJECTORY_RESAMPLE_DISTANCE) {
+			// Times are needed as the parameter is arc length
+			for (size_t i = 0; i < nInputPoints; ++i) {
+				resampler->parameter[i] = (double) (input->time_us[i] - input->time_us[0])
+						/ MICROSECONDS_PER_SECOND;
+			}
+		}
+		interpolateColumn(parameter, resampler->segment, resampler->fraction, nPoints, resampler->time_s);
+		interpolateColumn(input->x_m, resampler->segment, resampler->fraction, nPoints, resampler->x_m);
+		interpolateColumn(input->y_m, resampler->segment, resampler->fraction, nPoints, resampler->y_m);
+		if (input->z_m != NULL) {
+			interpolateColumn(input->z_m, resampler->segment, resampler->fraction, nPoints, resampler->z_m);
+		}
+		else {
+			memset(resampler->z_m, 0, nPoints * sizeof (*resampler->z_m));
+		}
+	}
+	for (size_t k = 0; k < nPoints; ++k) {
+		resampler->time_us[k] = input->time_us[0]
+				+ (int64_t) (resampler->time_s[k] * MICROSECONDS_PER_SECOND + 0.5);
+	}
+
+	if (nPoints >= 3) {
+		differentiate(resampler->time_s, resampler->x_m, nPoints, resampler->xRate, resampler->xSecondRate);
+		differentiate(resampler->time_s, resampler->y_m, nPoints, resampler->yRate, resampler->ySecondRate);
+	}
+	else {
+		const double duration = nPoints == 2 ? resampler->time_s[1] - resampler->time_s[0] : 0.0;
+
+		for (size_t k = 0; k < nPoints; ++k) {
+			resampler->xRate[k] = duration > 0.0 ? (resampler->x_m[nPoints - 1] - resampler->x_m[0]) / duration : 0.0;
+			resampler->yRate[k] = duration > 0.0 ? (resampler->y_m[nPoints - 1] - resampler->y_m[0]) / duration : 0.0;
+			resampler->xSecondRate[k] = 0.0;
+			resampler->ySecondRate[k] = 0.0;
+		}
+	}
+	computeKinematics(resampler->xRate, resampler->yRate, resampler->xSecondRate, resampler->ySecondRate, nPoints,
+					  resampler->longitudinalSpeed_m_s, resampler->lateralSpeed_m_s,
+					  resampler->longitudinalAcceleration_m_s2, resampler->lateralAcceleration_m_s2,
+					  resampler->curvature);
+	computeHeading(resampler, nPoints);
+
+	output->nPoints = nPoints;
+	output->time_us = resampler->time_us;
+	output->x_m = resampler->x_m;
+	output->y_m = resampler->y_m;
+	output->z_m = resampler->z_m;
+	output->heading_rad = resampler->heading_rad;
+	output->longitudinalSpeed_m_s = resampler->longitudinalSpeed_m_s;
+	output->lateralSpeed_m_s = resampler->lateralSpeed_m_s;
+	output->longitudinalAcceleration_m_s2 = resampler->longitudinalAcceleration_m_s2;
+	output->lateralAcceleration_m_s2 = resampler->lateralAcceleration_m_s2;
+	output->curvature = resampler->curvature;
+	return (ssize_t) nPoints;
+}
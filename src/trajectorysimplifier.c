@@ -0,0 +1,253 @@
+#include "trajectorysimplifier.h"
+#include "isoerror.h"
+#include "timeconversions.h"
+#include "workerpool.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/*! Points per independently simplified chunk. Chunk ends are always kept, and since the chunking
+ *  does not depend on the number of threads, neither does the result. */
+#define SIMPLIFIER_POINTS_PER_CHUNK 8192
+
+//! Largest errors found, per error type
+typedef struct {
+	double position_m;
+	double speed_m_s;
+	double curvature;
+} SimplificationErrorType;
+
+typedef struct {
+	size_t first;
+	size_t last;
+} PointRangeType;
+
+typedef struct {
+	const TrajectoryWaypointType* waypoints;
+	const int64_t* time_us;
+	size_t nPoints;
+	size_t nChunks;
+	const TrajectorySimplificationOptionsType* options;
+	bool* isKept;
+	SimplificationErrorType* chunkErrors;
+	atomic_int error;
+} SimplificationType;
+
+//! Error relative to its tolerance, above one if the tolerance is exceeded
+static inline double relativeError(const double error, const double tolerance) {
+	if (tolerance > 0.0) {
+		return error / tolerance;
+	}
+	return error > 0.0 ? INFINITY : 0.0;
+}
+
+static inline double interpolate(const double first, const double last, const double fraction) {
+	return first + fraction * (last - first);
+}
+
+/*!
+ * \brief measurePointError Compares a point with the straight line between two kept points,
+ *			interpolated at the time of the point
+ * \param simplification Trajectory being simplified
+ * \param first Kept point before
+ * \param last Kept point after
+ * \param k Point between them
+ * \param error Errors of the point
+ * \return Largest error relative to its tolerance
+ */
+static double measurePointError(const SimplificationType* simplification, const size_t first, const size_t last,
+								const size_t k, SimplificationErrorType* error) {
+	const TrajectoryWaypointType* a = &simplification->waypoints[first];
+	const TrajectoryWaypointType* b = &simplification->waypoints[last];
+	const TrajectoryWaypointType* p = &simplification->waypoints[k];
+	const TrajectorySimplificationOptionsType* options = simplification->options;
+	const int64_t duration_us = simplification->time_us[last] - simplification->time_us[first];
+	const double fraction = duration_us > 0 ?
+				(double) (simplification->time_us[k] - simplification->time_us[first]) / (double) duration_us : 0.0;
+
+	const double dx = interpolate(a->pos.xCoord_m, b->pos.xCoord_m, fraction) - p->pos.xCoord_m;
+	const double dy = interpolate(a->pos.yCoord_m, b->pos.yCoord_m, fraction) - p->pos.yCoord_m;
+	const double dz = a->pos.isZcoordValid && b->pos.isZcoordValid && p->pos.isZcoordValid ?
+				interpolate(a->pos.zCoord_m, b->pos.zCoord_m, fraction) - p->pos.zCoord_m : 0.0;
+	error->position_m = sqrt(dx * dx + dy * dy + dz * dz);
+
+	error->speed_m_s = 0.0;
+	if (a->spd.isLongitudinalValid && b->spd.isLongitudinalValid && p->spd.isLongitudinalValid) {
+		error->speed_m_s = fabs(interpolate(a->spd.longitudinal_m_s, b->spd.longitudinal_m_s, fraction)
+								- p->spd.longitudinal_m_s);
+	}
+	if (a->spd.isLateralValid && b->spd.isLateralValid && p->spd.isLateralValid) {
+		const double lateralError = fabs(interpolate(a->spd.lateral_m_s, b->spd.lateral_m_s, fraction)
+										 - p->spd.lateral_m_s);
+		error->speed_m_s = fmax(error->speed_m_s, lateralError);
+	}
+	error->curvature = fabs(interpolate(a->curvature, b->curvature, fraction) - p->curvature);
+
+	return fmax(relativeError(error->position_m, options->position_m),
+				fmax(relativeError(error->speed_m_s, options->speed_m_s),
+					 relativeError(error->curvature, options->curvature)));
+}
+
+/*!
+ * \brief simplifyChunk Marks the points of one chunk to keep, by Douglas-Peucker splitting of each
+ *			range at its worst point until all removed points are within tolerance
+ * \param simplification Trajectory being simplified
+ * \param chunk Chunk to simplify
+ * \return 0 on success, -1 if memory could not be allocated
+ */
+static int simplifyChunk(SimplificationType* simplification, const size_t chunk) {
+	const size_t first = chunk * SIMPLIFIER_POINTS_PER_CHUNK;
+	const size_t last = first + SIMPLIFIER_POINTS_PER_CHUNK < simplification->nPoints - 1 ?
+				first + SIMPLIFIER_POINTS_PER_CHUNK : simplification->nPoints - 1;
+	SimplificationErrorType* chunkError = &simplification->chunkErrors[chunk];
+	// Each split replaces a range with two of which at least one has an interior point
+	PointRangeType* stack = malloc((last - first + 1) * sizeof (*stack));
+	size_t nStacked = 0;
+
+	if (stack == NULL) {
+		return -1;
+	}
+	// The last point belongs to the next chunk, or is marked by the caller
+	simplification->isKept[first] = true;
+	stack[nStacked++] = (PointRangeType) { first, last };
+	while (nStacked > 0) {
+		const PointRangeType range = stack[--nStacked];
+		SimplificationErrorType rangeError = { 0.0, 0.0, 0.0 }, error;
+		double worst = 0.0;
+		size_t split = range.first;
+
+		for (size_t k = range.first + 1; k < range.last; ++k) {
+			const double relative = measurePointError(simplification, range.first, range.last, k, &error);
+			if (relative > worst) {
+				worst = relative;
+				split = k;
+			}
+			rangeError.position_m = fmax(rangeError.position_m, error.position_m);
+			rangeError.speed_m_s = fmax(rangeError.speed_m_s, error.speed_m_s);
+			rangeError.curvature = fmax(rangeError.curvature, error.curvature);
+		}
+		if (worst <= 1.0) {
+			chunkError->position_m = fmax(chunkError->position_m, rangeError.position_m);
+			chunkError->speed_m_s = fmax(chunkError->speed_m_s, rangeError.speed_m_s);
+			chunkError->curvature = fmax(chunkError->curvature, rangeError.curvature);
+			continue;
+		}
+		simplification->isKept[split] = true;
+		stack[nStacked++] = (PointRangeType) { split, range.last };
+		stack[nStacked++] = (PointRangeType) { range.first, split };
+	}
+	free(stack);
+	return 0;
+}
+
+static void simplifyChunkTask(void* arg, const unsigned int thread, const size_t chunk) {
+	SimplificationType* simplification = arg;
+
+	(void) thread;
+	if (simplifyChunk(simplification, chunk) < 0) {
+		atomic_store(&simplification->error, ENOMEM);
+	}
+}
+
+/*!
+ * \brief simplifyTrajectory Removes points from a trajectory while keeping the trajectory
+ *			interpolated between the remaining points within tolerance of every removed point, e.g.
+ *			to shorten TRAJ messages before ::encodeTRAJMessageHeader and ::encodeTRAJMessagePoint.
+ *			Errors are measured at the time of each removed point, so that timing is kept as well as
+ *			the path. The trajectory is split into chunks simplified in parallel by Douglas-Peucker.
+ * \param waypoints Trajectory with nondecreasing times and valid positions
+ * \param nWaypoints Number of waypoints
+ * \param options Error tolerances and number of threads
+ * \param simplified Array of at least nWaypoints points, in which the kept points are stored in
+ *			order. May be the same array as waypoints.
+ * \param statistics Achieved compression and largest errors, may be NULL
+ * \return Number of points kept, always including the first and last, or -1 on error with errno set to
+ *		EINVAL		if the trajectory cannot be simplified
+ *		ENOMEM		if memory could not be allocated
+ */
+ssize_t simplifyTrajectory(
+		const TrajectoryWaypointType waypoints[],
+		const size_t nWaypoints,
+		const TrajectorySimplificationOptionsType* options,
+		TrajectoryWaypointType simplified[],
+		TrajectorySimplificationStatisticsType* statistics) {
+	SimplificationType simplification;
+	SimplificationErrorType maxError = { 0.0, 0.0, 0.0 };
+	size_t nKept = 0;
+
+	if (waypoints == NULL || options == NULL || simplified == NULL
+			|| isnan(options->position_m) || isnan(options->speed_m_s) || isnan(options->curvature)) {
+		errno = EINVAL;
+		return -1;
+	}
+	memset(&simplification, 0, sizeof (simplification));
+	simplification.waypoints = waypoints;
+	simplification.nPoints = nWaypoints;
+	simplification.options = options;
+	simplification.nChunks = nWaypoints > 2 ? (nWaypoints - 2) / SIMPLIFIER_POINTS_PER_CHUNK + 1 : 0;
+
+	int64_t* time_us = malloc(nWaypoints * sizeof (*time_us) + nWaypoints * sizeof (bool)
+							  + simplification.nChunks * sizeof (SimplificationErrorType) + 1);
+	if (time_us == NULL) {
+		errno = ENOMEM;
+		return -1;
+	}
+	for (size_t i = 0; i < nWaypoints; ++i) {
+		time_us[i] = timevalToMicroseconds(&waypoints[i].relativeTime);
+		if (!waypoints[i].pos.isPositionValid || (i > 0 && time_us[i] < time_us[i - 1])) {
+			free(time_us);
+			errno = EINVAL;
+			ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, MESSAGE_ID_TRAJ, 0,
+							 "Trajectory point %zu cannot be simplified", i);
+			return -1;
+		}
+	}
+	simplification.time_us = time_us;
+	simplification.chunkErrors = (SimplificationErrorType*) (time_us + nWaypoints);
+	simplification.isKept = (bool*) (simplification.chunkErrors + simplification.nChunks);
+	memset(simplification.isKept, 0, nWaypoints * sizeof (bool));
+	memset(simplification.chunkErrors, 0, simplification.nChunks * sizeof (SimplificationErrorType));
+	if (nWaypoints > 0) {
+		simplification.isKept[0] = true;
+		simplification.isKept[nWaypoints - 1] = true;
+	}
+
+	if (simplification.nChunks > 0) {
+		const long nProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+		runWorkers(simplifyChunkTask, &simplification, options->nThreads != 0 ? options->nThreads
+					: (nProcessors > 0 ? (unsigned int) nProcessors : 1), simplification.nChunks);
+	}
+	if (atomic_load(&simplification.error) != 0) {
+		free(time_us);
+		errno = ENOMEM;
+		return -1;
+	}
+
+	for (size_t i = 0; i < nWaypoints; ++i) {
+		if (simplification.isKept[i]) {
+			simplified[nKept++] = waypoints[i];
+		}
+	}
+	for (size_t c = 0; c < simplification.nChunks; ++c) {
+		maxError.position_m = fmax(maxError.position_m, simplification.chunkErrors[c].position_m);
+		maxError.speed_m_s = fmax(maxError.speed_m_s, simplification.chunkErrors[c].speed_m_s);
+		maxError.curvature = fmax(maxError.curvature, simplification.chunkErrors[c].curvature);
+	}
+	free(time_us);
+
+	if (statistics != NULL) {
+		statistics->nInputPoints = nWaypoints;
+		statistics->nOutputPoints = nKept;
+		statistics->compressionRatio = nKept > 0 ? (double) nWaypoints / (double) nKept : 1.0;
+		statistics->maxPositionError_m = maxError.position_m;
+		statistics->maxSpeedError_m_s = maxError.speed_m_s;
+		statistics->maxCurvatureError = maxError.curvature;
+	}
+	return (ssize_t) nKept;
+}
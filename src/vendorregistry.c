@@ -0,0 +1,271 @@
+#include "vendorregistry.h"
+#include "frame.h"
+#include "footer.h"
+#include "traj.h"
+#include "isoerror.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define VENDOR_MESSAGE_COUNT (MESSAGE_ID_VENDOR_SPECIFIC_UPPER_LIMIT - MESSAGE_ID_VENDOR_SPECIFIC_LOWER_LIMIT + 1)
+#define TRAJ_VENDOR_VALUE_COUNT (VALUE_ID_TRAJ_VENDOR_SPECIFIC_RANGE_UPPER - VALUE_ID_TRAJ_VENDOR_SPECIFIC_RANGE_LOWER + 1)
+
+typedef struct {
+	VendorValueHandlerType handle;
+	void* userData;
+} VendorValueEntryType;
+
+/*! Handlers indexed directly by message or value ID, so that dispatch is a single lookup. Registration
+ *  is not synchronised with dispatch and should be done before messages are encoded or decoded. */
+static VendorMessageHandlerType vendorMessages[VENDOR_MESSAGE_COUNT];
+static VendorValueEntryType trajVendorValues[TRAJ_VENDOR_VALUE_COUNT];
+
+/*!
+ * \brief isBuiltInVendorMessage Check if a vendor specific message is implemented by this library
+ * \param messageID ID of the message
+ * \return true if the message has its own encoder and decoder, false otherwise
+ */
+static bool isBuiltInVendorMessage(const uint16_t messageID) {
+	switch (messageID) {
+	case MESSAGE_ID_VENDOR_SPECIFIC_RISE_INSUP:
+	case MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_OPRO:
+	case MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_FOPR:
+	case MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI:
+	case MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCTI:
+	case MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_GDRM:
+	case MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_RDCA:
+	case MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_DCMM:
+	case MESSAGE_ID_VENDOR_SPECIFIC_CTRJ:
+	case MESSAGE_ID_VENDOR_SPECIFIC_CTRA:
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*!
+ * \brief findVendorValueEntry Finds the handler slot of a vendor specific value ID within a message
+ * \param messageID Message in which the value ID occurs
+ * \param valueID Value ID
+ * \return The slot, or NULL if the value ID is not in the vendor specific range of the message
+ */
+static VendorValueEntryType* findVendorValueEntry(const enum ISOMessageID messageID, const uint16_t valueID) {
+	switch (messageID) {
+	case MESSAGE_ID_TRAJ:
+		if (valueID >= VALUE_ID_TRAJ_VENDOR_SPECIFIC_RANGE_LOWER && valueID <= VALUE_ID_TRAJ_VENDOR_SPECIFIC_RANGE_UPPER) {
+			return &trajVendorValues[valueID - VALUE_ID_TRAJ_VENDOR_SPECIFIC_RANGE_LOWER];
+		}
+		return NULL;
+	default:
+		return NULL;
+	}
+}
+
+/*!
+ * \brief registerVendorMessage Registers an encoder and decoder for a vendor specific message ID
+ * \param messageID ID in the vendor specific range, not used by a message implemented in this library
+ * \param handler Callbacks for the message, copied into the registry. Either callback may be NULL.
+ * \return 0 on success, -1 otherwise with errno set to
+ *		EINVAL		if the ID is outside the vendor specific range or the handler is NULL
+ *		EEXIST		if the ID is already registered or implemented by this library
+ */
+int registerVendorMessage(const uint16_t messageID, const VendorMessageHandlerType* handler) {
+	if (handler == NULL || messageID < MESSAGE_ID_VENDOR_SPECIFIC_LOWER_LIMIT
+			|| messageID > MESSAGE_ID_VENDOR_SPECIFIC_UPPER_LIMIT) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (isBuiltInVendorMessage(messageID) || getVendorMessageHandler(messageID) != NULL) {
+		errno = EEXIST;
+		return -1;
+	}
+	vendorMessages[messageID - MESSAGE_ID_VENDOR_SPECIFIC_LOWER_LIMIT] = *handler;
+	return 0;
+}
+
+/*!
+ * \brief unregisterVendorMessage Removes the callbacks of a vendor specific message ID
+ * \param messageID ID of the message
+ * \return 0 on success, -1 if the ID was not registered
+ */
+int unregisterVendorMessage(const uint16_t messageID) {
+	if (getVendorMessageHandler(messageID) == NULL) {
+		errno = ENOENT;
+		return -1;
+	}
+	memset(&vendorMessages[messageID - MESSAGE_ID_VENDOR_SPECIFIC_LOWER_LIMIT], 0, sizeof (VendorMessageHandlerType));
+	return 0;
+}
+
+/*!
+ * \brief getVendorMessageHandler Looks up the callbacks of a vendor specific message ID
+ * \param messageID ID of the message
+ * \return The registered callbacks, or NULL if none are registered for the ID
+ */
+const VendorMessageHandlerType* getVendorMessageHandler(const uint16_t messageID) {
+	if (messageID < MESSAGE_ID_VENDOR_SPECIFIC_LOWER_LIMIT || messageID > MESSAGE_ID_VENDOR_SPECIFIC_UPPER_LIMIT) {
+		return NULL;
+	}
+	const VendorMessageHandlerType* handler = &vendorMessages[messageID - MESSAGE_ID_VENDOR_SPECIFIC_LOWER_LIMIT];
+	return handler->encode != NULL || handler->decode != NULL ? handler : NULL;
+}
+
+/*!
+ * \brief encodeVendorMessage Constructs a vendor specific message, with its contents written by the
+ *			registered encoder and header and footer added around them
+ * \param inputHeader Data to create header with
+ * \param messageID ID of a registered vendor specific message
+ * \param messageData Data passed on to the registered encoder
+ * \param buffer Data buffer in which to place the encoded message
+ * \param bufferLength Size of the data buffer
+ * \param debug Flag for enabling debugging
+ * \return Number of bytes written to the data buffer, or -1 if an error occurred
+ */
+ssize_t encodeVendorMessage(
+		const MessageHeaderType* inputHeader,
+		const uint16_t messageID,
+		const void* messageData,
+		char* buffer,
+		const size_t bufferLength,
+		const char debug) {
+	const VendorMessageHandlerType* handler = getVendorMessageHandler(messageID);
+
+	if (inputHeader == NULL || buffer == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, messageID, 0, "Input pointer error");
+		return -1;
+	}
+	if (handler == NULL || handler->encode == NULL) {
+		errno = EINVAL;
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, messageID, 0, "No encoder registered for message ID 0x%x", messageID);
+		return -1;
+	}
+	if (bufferLength < sizeof (HeaderType) + sizeof (FooterType)) {
+		errno = ENOBUFS;
+		ISO_REPORT_ERROR(MESSAGE_LENGTH_ERROR, messageID, 0, "Buffer too small to hold message header and footer");
+		return -1;
+	}
+
+	const size_t contentCapacity = bufferLength - sizeof (HeaderType) - sizeof (FooterType);
+	const ssize_t contentLength = handler->encode(messageData, buffer + sizeof (HeaderType), contentCapacity,
+												  handler->userData);
+	if (contentLength < 0 || (size_t) contentLength > contentCapacity) {
+		ISO_REPORT_ERROR(ISO_FUNCTION_ERROR, messageID, sizeof (HeaderType),
+						 "Encoder for message ID 0x%x failed", messageID);
+		return -1;
+	}
+
+	const size_t messageSize = sizeof (HeaderType) + (size_t) contentLength + sizeof (FooterType);
+	const HeaderType header = buildISOHeader((enum ISOMessageID) messageID, inputHeader, (uint32_t) messageSize, debug);
+	memcpy(buffer, &header, sizeof (header));
+	const FooterType footer = buildISOFooter(buffer, messageSize, debug);
+	memcpy(buffer + messageSize - sizeof (footer), &footer, sizeof (footer));
+	return (ssize_t) messageSize;
+}
+
+/*!
+ * \brief decodeVendorMessage Verifies the framing of a vendor specific message and passes its contents
+ *			to the decoder registered for its message ID
+ * \param buffer Buffer starting with the message
+ * \param bufferLength Number of bytes in the buffer
+ * \param messageData Data passed on to the registered decoder
+ * \param debug Flag for enabling debugging
+ * \return Size of the message including header and footer, or a negative value
+ *			according to ::ISOMessageReturnValue
+ */
+ssize_t decodeVendorMessage(
+		const char* buffer,
+		const size_t bufferLength,
+		void* messageData,
+		const char debug) {
+	HeaderType header;
+	const ssize_t messageSize = validateISOFrame(buffer, bufferLength, &header);
+
+	if (messageSize < 0) {
+		return messageSize;
+	}
+	const VendorMessageHandlerType* handler = getVendorMessageHandler(header.messageID);
+	if (handler == NULL || handler->decode == NULL) {
+		ISO_REPORT_ERROR(MESSAGE_TYPE_ERROR, header.messageID, offsetof(HeaderType, messageID),
+						 "No decoder registered for message ID 0x%x", header.messageID);
+		return MESSAGE_TYPE_ERROR;
+	}
+	if (debug) {
+		printf("Vendor message 0x%x with %u bytes of content\n", header.messageID, header.messageLength);
+	}
+	const int retval = handler->decode(&header, buffer + sizeof (HeaderType), header.messageLength, messageData,
+									   handler->userData);
+	return retval < 0 ? retval : messageSize;
+}
+
+/*!
+ * \brief registerVendorValueHandler Registers a handler for a vendor specific value ID within a standard
+ *			message, called by its decoder instead of rejecting the value ID
+ * \param messageID Message in which the value ID occurs, currently only ::MESSAGE_ID_TRAJ has such a range
+ * \param valueID Value ID within the vendor specific range of the message
+ * \param handler Callback receiving the content of the value
+ * \param userData Pointer passed on to the callback
+ * \return 0 on success, -1 otherwise with errno set to
+ *		EINVAL		if the value ID is outside the vendor specific range of the message
+ *		EEXIST		if the value ID is already registered
+ */
+int registerVendorValueHandler(
+		const enum ISOMessageID messageID,
+		const uint16_t valueID,
+		VendorValueHandlerType handler,
+		void* userData) {
+	VendorValueEntryType* entry = findVendorValueEntry(messageID, valueID);
+
+	if (entry == NULL || handler == NULL) {
+		errno = EINVAL;
+		return -1;
+	}
+	if (entry->handle != NULL) {
+		errno = EEXIST;
+		return -1;
+	}
+	entry->handle = handler;
+	entry->userData = userData;
+	return 0;
+}
+
+/*!
+ * \brief unregisterVendorValueHandler Removes the handler of a vendor specific value ID
+ * \param messageID Message in which the value ID occurs
+ * \param valueID Value ID
+ * \return 0 on success, -1 if no handler was registered
+ */
+int unregisterVendorValueHandler(const enum ISOMessageID messageID, const uint16_t valueID) {
+	VendorValueEntryType* entry = findVendorValueEntry(messageID, valueID);
+
+	if (entry == NULL || entry->handle == NULL) {
+		errno = ENOENT;
+		return -1;
+	}
+	entry->handle = NULL;
+	entry->userData = NULL;
+	return 0;
+}
+
+/*!
+ * \brief handleVendorValue Passes the content of a vendor specific value ID to its registered handler
+ * \param messageID Message in which the value ID occurs
+ * \param valueID Value ID
+ * \param content Content of the value
+ * \param contentLength Length of the content
+ * \return Value according to ::ISOMessageReturnValue, ::MESSAGE_VALUE_ID_ERROR if no handler is registered
+ */
+int handleVendorValue(
+		const enum ISOMessageID messageID,
+		const uint16_t valueID,
+		const char* content,
+		const uint16_t contentLength) {
+	const VendorValueEntryType* entry = findVendorValueEntry(messageID, valueID);
+
+	if (entry == NULL || entry->handle == NULL) {
+		return MESSAGE_VALUE_ID_ERROR;
+	}
+	return entry->handle(messageID, valueID, content, contentLength, entry->userData);
+}
@@ -0,0 +1,64 @@
+#include "workerpool.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+typedef struct {
+	WorkerFunctionType fn;
+	void* arg;
+	size_t nTasks;
+	atomic_size_t nextTask;
+} WorkerPoolType;
+
+typedef struct {
+	WorkerPoolType* pool;
+	unsigned int thread;
+	pthread_t handle;
+	bool isStarted;
+} WorkerType;
+
+static void* workerMain(void* arg) {
+	WorkerType* worker = arg;
+	size_t task;
+
+	while ((task = atomic_fetch_add(&worker->pool->nextTask, 1)) < worker->pool->nTasks) {
+		worker->pool->fn(worker->pool->arg, worker->thread, task);
+	}
+	return NULL;
+}
+
+/*!
+ * \brief runWorkers Runs tasks 0 to nTasks - 1, on the calling thread and up to nThreads - 1 more,
+ *			each thread taking the next task when done with its previous one. Returns when all
+ *			tasks are done.
+ * \param fn Function running one task
+ * \param arg Argument passed to fn
+ * \param nThreads Number of threads to run on
+ * \param nTasks Number of tasks
+ */
+void runWorkers(WorkerFunctionType fn, void* arg, const unsigned int nThreads, const size_t nTasks) {
+	WorkerPoolType pool = { .fn = fn, .arg = arg, .nTasks = nTasks };
+	const unsigned int nWorkers = nThreads < nTasks ? nThreads : (unsigned int) nTasks;
+	WorkerType* workers = nWorkers > 1 ? calloc(nWorkers, sizeof (*workers)) : NULL;
+	WorkerType caller = { .pool = &pool, .thread = 0 };
+
+	atomic_init(&pool.nextTask, 0);
+	// The calling thread takes part, and also covers for threads which could not be started
+	if (workers != NULL) {
+		for (unsigned int t = 1; t < nWorkers; ++t) {
+			workers[t].pool = &pool;
+			workers[t].thread = t;
+			workers[t].isStarted = pthread_create(&workers[t].handle, NULL, workerMain, &workers[t]) == 0;
+		}
+	}
+	workerMain(&caller);
+	if (workers != NULL) {
+		for (unsigned int t = 1; t < nWorkers; ++t) {
+			if (workers[t].isStarted) {
+				pthread_join(workers[t].handle, NULL);
+			}
+		}
+	}
+	free(workers);
+}
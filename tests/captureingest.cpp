@@ -0,0 +1,268 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+extern "C" {
+#include "captureingest.h"
+#include "iso22133.h"
+#include "defines.h"
+}
+#include "testdefines.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+class CaptureIngest : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		snprintf(path, sizeof(path), "/tmp/captureingest_%d.pcap", getpid());
+	}
+	void TearDown() override {
+		unlink(path);
+	}
+
+	//! Object state is given as the ISO value
+	static Bytes encodeMONR(uint32_t transmitterID, uint8_t state, long usec) {
+		MessageHeaderType header;
+		memset(&header, 0, sizeof(header));
+		header.transmitterID = transmitterID;
+		struct timeval time = { 1651198942, usec };
+		CartesianPosition position;
+		memset(&position, 0, sizeof(position));
+		position.isPositionValid = position.isXcoordValid = position.isYcoordValid = true;
+		SpeedType speed;
+		memset(&speed, 0, sizeof(speed));
+		speed.isLongitudinalValid = true;
+		AccelerationType acceleration;
+		memset(&acceleration, 0, sizeof(acceleration));
+		char buffer[256];
+		ssize_t length = encodeMONRMessage(&header, &time, position, speed, acceleration,
+										   OBJECT_DRIVE_DIRECTION_FORWARD, state, OBJECT_READY_TO_ARM,
+										   0, 0, buffer, sizeof(buffer), false);
+		EXPECT_GT(length, 0);
+		return Bytes(buffer, buffer + length);
+	}
+
+	static void put16(Bytes& b, size_t offset, uint16_t value) {
+		b[offset] = static_cast<uint8_t>(value >> 8);
+		b[offset + 1] = static_cast<uint8_t>(value);
+	}
+	static void put32(Bytes& b, size_t offset, uint32_t value) {
+		put16(b, offset, static_cast<uint16_t>(value >> 16));
+		put16(b, offset + 2, static_cast<uint16_t>(value));
+	}
+
+	//! Ethernet, IPv4 and UDP or TCP headers around a payload
+	static Bytes makePacket(const Bytes& payload, bool isTCP, uint32_t sequence = 0, uint8_t flags = 0x18) {
+		const size_t transportLength = isTCP ? 20 : 8;
+		Bytes packet(14 + 20 + transportLength, 0);
+		put16(packet, 12, 0x0800);
+		packet[14] = 0x45;
+		put16(packet, 16, static_cast<uint16_t>(20 + transportLength + payload.size()));
+		packet[23] = isTCP ? 6 : 17;
+		put32(packet, 26, 0x0A000001);
+		put32(packet, 30, 0x0A000002);
+		put16(packet, 34, 53240);
+		put16(packet, 36, isTCP ? 53241 : 53240);
+		if (isTCP) {
+			put32(packet, 38, sequence);
+			packet[46] = 0x50;
+			packet[47] = flags;
+		}
+		else {
+			put16(packet, 38, static_cast<uint16_t>(8 + payload.size()));
+		}
+		packet.insert(packet.end(), payload.begin(), payload.end());
+		return packet;
+	}
+
+	//! Ethernet, IPv6 with a hop-by-hop extension header, and UDP headers around a payload
+	static Bytes makeIPv6Packet(const Bytes& payload) {
+		Bytes packet(14 + 40 + 8 + 8, 0);
+		put16(packet, 12, 0x86DD);
+		packet[14] = 0x60;
+		put16(packet, 18, static_cast<uint16_t>(8 + 8 + payload.size()));
+		packet[20] = 0;
+		packet[21] = 64;
+		packet[37] = 1;
+		packet[53] = 2;
+		packet[54] = 17;
+		packet[56] = 1;
+		packet[57] = 4;
+		put16(packet, 62, 53240);
+		put16(packet, 64, 53240);
+		put16(packet, 66, static_cast<uint16_t>(8 + payload.size()));
+		packet.insert(packet.end(), payload.begin(), payload.end());
+		return packet;
+	}
+
+	static void appendLE32(Bytes& b, uint32_t value) {
+		for (int i = 0; i < 4; ++i) {
+			b.push_back(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	}
+
+	void writePcap(const std::vector<Bytes>& packets) {
+		Bytes file;
+		appendLE32(file, 0xA1B2C3D4);
+		appendLE32(file, 0x00040002);
+		appendLE32(file, 0);
+		appendLE32(file, 0);
+		appendLE32(file, 65535);
+		appendLE32(file, 1);
+		for (size_t i = 0; i < packets.size(); ++i) {
+			appendLE32(file, 1651198942);
+			appendLE32(file, static_cast<uint32_t>(i * 10000));
+			appendLE32(file, static_cast<uint32_t>(packets[i].size()));
+			appendLE32(file, static_cast<uint32_t>(packets[i].size()));
+			file.insert(file.end(), packets[i].begin(), packets[i].end());
+		}
+		std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+	}
+
+	void writePcapng(const std::vector<Bytes>& packets) {
+		Bytes file;
+		appendLE32(file, 0x0A0D0D0A);
+		appendLE32(file, 28);
+		appendLE32(file, 0x1A2B3C4D);
+		appendLE32(file, 0x00000001);
+		appendLE32(file, 0xFFFFFFFF);
+		appendLE32(file, 0xFFFFFFFF);
+		appendLE32(file, 28);
+		appendLE32(file, 1);
+		appendLE32(file, 20);
+		appendLE32(file, 1);
+		appendLE32(file, 65535);
+		appendLE32(file, 20);
+		for (size_t i = 0; i < packets.size(); ++i) {
+			const uint64_t timestamp = 1651198942000000ULL + i * 10000;
+			const size_t padded = (packets[i].size() + 3) & ~size_t(3);
+			appendLE32(file, 6);
+			appendLE32(file, static_cast<uint32_t>(32 + padded));
+			appendLE32(file, 0);
+			appendLE32(file, static_cast<uint32_t>(timestamp >> 32));
+			appendLE32(file, static_cast<uint32_t>(timestamp));
+			appendLE32(file, static_cast<uint32_t>(packets[i].size()));
+			appendLE32(file, static_cast<uint32_t>(packets[i].size()));
+			file.insert(file.end(), packets[i].begin(), packets[i].end());
+			file.resize(file.size() + padded - packets[i].size(), 0);
+			appendLE32(file, static_cast<uint32_t>(32 + padded));
+		}
+		std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+	}
+
+	std::vector<Bytes> makeTraffic() {
+		std::vector<Bytes> packets;
+		const uint8_t states[] = { ISO_OBJECT_STATE_ARMED, ISO_OBJECT_STATE_RUNNING, ISO_OBJECT_STATE_ABORTING };
+		for (int i = 0; i < 3000; ++i) {
+			packets.push_back(makePacket(encodeMONR(TEST_TRANSMITTER_ID_1, states[i / 1000], (i * 10) % 1000000),
+										 false));
+		}
+		// Two messages in one datagram, one of them corrupted
+		Bytes pair = encodeMONR(TEST_TRANSMITTER_ID_2, ISO_OBJECT_STATE_ARMED, 0);
+		Bytes corrupt = encodeMONR(TEST_TRANSMITTER_ID_2, ISO_OBJECT_STATE_ARMED, 10);
+		corrupt[30] ^= 0xFF;
+		pair.insert(pair.end(), corrupt.begin(), corrupt.end());
+		packets.push_back(makePacket(pair, false));
+
+		// TCP stream with a message split over two segments, and a retransmission
+		Bytes streamed = encodeMONR(TEST_HEADER_TRANSMITTER_ID, ISO_OBJECT_STATE_DISARMED, 0);
+		Bytes first(streamed.begin(), streamed.begin() + 10);
+		Bytes second(streamed.begin() + 10, streamed.end());
+		packets.push_back(makePacket(Bytes(), true, 999, 0x02));
+		packets.push_back(makePacket(first, true, 1000));
+		packets.push_back(makePacket(first, true, 1000));
+		packets.push_back(makePacket(second, true, 1010));
+		packets.push_back(makePacket(streamed, true, static_cast<uint32_t>(1000 + streamed.size())));
+		return packets;
+	}
+
+	void checkStatistics(const CaptureStatisticsType& statistics) {
+		EXPECT_EQ(3006u, statistics.nPackets);
+		EXPECT_EQ(3001u, statistics.nUDPPackets);
+		EXPECT_EQ(5u, statistics.nTCPPackets);
+		EXPECT_EQ(3004u, statistics.nFrames);
+		EXPECT_EQ(1u, statistics.nCRCErrors);
+		EXPECT_EQ(0u, statistics.nSkippedBytes);
+		EXPECT_EQ(3004u, statistics.messageCounts[MESSAGE_ID_MONR]);
+		ASSERT_EQ(3u, statistics.nObjects);
+
+		const CaptureObjectStatisticsType* object = &statistics.objects[0];
+		EXPECT_EQ(TEST_TRANSMITTER_ID_2, object->transmitterID);
+		EXPECT_EQ(2u, object->nMessages);
+		EXPECT_EQ(1u, object->nCRCErrors);
+
+		object = &statistics.objects[1];
+		EXPECT_EQ(TEST_TRANSMITTER_ID_1, object->transmitterID);
+		EXPECT_EQ(3000u, object->nMONRMessages);
+		EXPECT_EQ(static_cast<int64_t>(2999) * 10000000, object->lastMONRTime_ns - object->firstMONRTime_ns);
+		ASSERT_EQ(3u, object->nTimelineEntries);
+		EXPECT_EQ(OBJECT_STATE_ARMED, object->timeline[0].state);
+		EXPECT_EQ(OBJECT_STATE_RUNNING, object->timeline[1].state);
+		EXPECT_EQ(OBJECT_STATE_ABORTING, object->timeline[2].state);
+		EXPECT_EQ(statistics.firstTime_ns + static_cast<int64_t>(1000) * 10000000, object->timeline[1].time_ns);
+
+		object = &statistics.objects[2];
+		EXPECT_EQ(TEST_HEADER_TRANSMITTER_ID, object->transmitterID);
+		EXPECT_EQ(2u, object->nMONRMessages);
+	}
+	char path[64];
+};
+
+TEST_F(CaptureIngest, Pcap) {
+	writePcap(makeTraffic());
+	CaptureType capture;
+	ASSERT_EQ(0, openCapture(path, &capture));
+	CaptureAnalysisOptionsType options = { 4, false, 0, true };
+	CaptureStatisticsType statistics;
+	ASSERT_EQ(0, analyzeCapture(&capture, &options, &statistics));
+	checkStatistics(statistics);
+	freeCaptureStatistics(&statistics);
+	closeCapture(&capture);
+}
+
+TEST_F(CaptureIngest, Pcapng) {
+	writePcapng(makeTraffic());
+	CaptureType capture;
+	ASSERT_EQ(0, openCapture(path, &capture));
+	EXPECT_EQ(1651198942000000000LL, capture.packets[0].time_ns);
+	CaptureAnalysisOptionsType options = { 3, false, 0, true };
+	CaptureStatisticsType statistics;
+	ASSERT_EQ(0, analyzeCapture(&capture, &options, &statistics));
+	checkStatistics(statistics);
+	freeCaptureStatistics(&statistics);
+	closeCapture(&capture);
+}
+
+TEST_F(CaptureIngest, TransmitterFilter) {
+	writePcap(makeTraffic());
+	CaptureType capture;
+	ASSERT_EQ(0, openCapture(path, &capture));
+	CaptureAnalysisOptionsType options = { 2, true, TEST_TRANSMITTER_ID_2, false };
+	CaptureStatisticsType statistics;
+	ASSERT_EQ(0, analyzeCapture(&capture, &options, &statistics));
+	ASSERT_EQ(1u, statistics.nObjects);
+	EXPECT_EQ(TEST_TRANSMITTER_ID_2, statistics.objects[0].transmitterID);
+	EXPECT_EQ(0u, statistics.objects[0].nTimelineEntries);
+	freeCaptureStatistics(&statistics);
+	closeCapture(&capture);
+}
+
+TEST_F(CaptureIngest, TruncatedIPv6ExtensionHeader) {
+	const Bytes packet = makeIPv6Packet(encodeMONR(TEST_TRANSMITTER_ID_1, ISO_OBJECT_STATE_ARMED, 0));
+	// Ending inside the extension header, before and after its length field
+	writePcap({ packet, Bytes(packet.begin(), packet.begin() + 14 + 40 + 1),
+				Bytes(packet.begin(), packet.begin() + 14 + 40 + 6) });
+	CaptureType capture;
+	ASSERT_EQ(0, openCapture(path, &capture));
+	CaptureAnalysisOptionsType options = { 1, false, 0, false };
+	CaptureStatisticsType statistics;
+	ASSERT_EQ(0, analyzeCapture(&capture, &options, &statistics));
+	EXPECT_EQ(3u, statistics.nPackets);
+	EXPECT_EQ(1u, statistics.nUDPPackets);
+	EXPECT_EQ(2u, statistics.nOtherPackets);
+	EXPECT_EQ(1u, statistics.messageCounts[MESSAGE_ID_MONR]);
+	freeCaptureStatistics(&statistics);
+	closeCapture(&capture);
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+extern "C" {
+#include "codeccontext.h"
+#include "iso22133.h"
+#include "defines.h"
+}
+#include "testdefines.h"
+
+typedef std::vector<char> Bytes;
+
+static void countError(const ISOErrorType*, const char*, void* userData) {
+	++*static_cast<int*>(userData);
+}
+
+class CodecContext : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		context = createISOCodecContext();
+		ASSERT_NE(nullptr, context);
+		MessageHeaderType header = { TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, TEST_DEFAULT_MESSAGE_COUNTER };
+		length = encodeOSTMMessage(&header, OBJECT_COMMAND_ARM, message, sizeof(message), false);
+		ASSERT_GT(length, 0);
+	}
+	void TearDown() override {
+		freeISOCodecContext(context);
+		setISOErrorCallback(nullptr, nullptr, 0);
+	}
+
+	void corruptCRC() {
+		message[length - 1] ^= 0x5A;
+	}
+
+	static Bytes encodeTrajectory(ISOCodecContextType* context, int nPoints) {
+		Bytes buffer(1024 + 64 * nPoints);
+		MessageHeaderType header = { TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, 0 };
+		char name[] = "trajectory";
+		char* p = buffer.data();
+		size_t remaining = buffer.size();
+		ssize_t n = encodeTRAJMessageHeaderCtx(context, &header, 1, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, name,
+											   sizeof(name), static_cast<uint32_t>(nPoints), p, remaining);
+		EXPECT_GT(n, 0);
+		p += n;
+		remaining -= static_cast<size_t>(n);
+		for (int i = 0; i < nPoints; ++i) {
+			struct timeval time = { i / 100, (i % 100) * 10000 };
+			CartesianPosition position = {};
+			position.isPositionValid = true;
+			position.xCoord_m = i * 0.1;
+			SpeedType speed = {};
+			speed.isLongitudinalValid = true;
+			speed.longitudinal_m_s = 1.0;
+			AccelerationType acceleration = {};
+			n = encodeTRAJMessagePointCtx(context, &time, position, speed, acceleration, 0.0f, p, remaining);
+			EXPECT_GT(n, 0);
+			p += n;
+			remaining -= static_cast<size_t>(n);
+		}
+		n = encodeTRAJMessageFooterCtx(context, p, remaining);
+		EXPECT_GT(n, 0);
+		p += n;
+		buffer.resize(static_cast<size_t>(p - buffer.data()));
+		return buffer;
+	}
+
+	ISOCodecContextType* context;
+	char message[64];
+	ssize_t length;
+};
+
+TEST_F(CodecContext, CRCVerificationIsPerContext) {
+	corruptCRC();
+	enum ObjectCommandType command;
+	EXPECT_LT(decodeOSTMMessageCtx(context, message, static_cast<size_t>(length), &command), 0);
+	EXPECT_EQ(MESSAGE_CRC_ERROR, getCodecLastError(context).code);
+
+	ISOCodecContextType* trusted = createISOCodecContext();
+	ASSERT_NE(nullptr, trusted);
+	setCodecCRCVerification(trusted, false);
+	EXPECT_GT(decodeOSTMMessageCtx(trusted, message, static_cast<size_t>(length), &command), 0);
+	EXPECT_EQ(OBJECT_COMMAND_ARM, command);
+	EXPECT_EQ(MESSAGE_OK, getCodecLastError(trusted).code);
+	freeISOCodecContext(trusted);
+
+	// Default context is unaffected
+	EXPECT_LT(decodeOSTMMessage(message, static_cast<size_t>(length), &command, false), 0);
+}
+
+TEST_F(CodecContext, ProtocolVersions) {
+	message[6] = (message[6] & 0x80) | 3;
+	HeaderType header;
+	EXPECT_EQ(MESSAGE_VERSION_ERROR, decodeISOHeaderCtx(context, message, static_cast<size_t>(length), &header));
+	const uint8_t versions[] = { 2, 3 };
+	ASSERT_EQ(0, setCodecProtocolVersions(context, versions, 2));
+	EXPECT_EQ(MESSAGE_OK, decodeISOHeaderCtx(context, message, static_cast<size_t>(length), &header));
+	EXPECT_EQ(MESSAGE_VERSION_ERROR, decodeISOHeader(message, static_cast<size_t>(length), &header, false));
+	EXPECT_EQ(-1, setCodecProtocolVersions(context, versions, 0));
+}
+
+TEST_F(CodecContext, MessageCountersPerReceiver) {
+	MessageHeaderType header;
+	for (int i = 0; i < 300; ++i) {
+		ASSERT_EQ(0, fillCodecMessageHeader(context, TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, &header));
+		EXPECT_EQ(static_cast<uint8_t>(i), header.messageCounter);
+	}
+	// Many receivers, forcing the counter table to grow
+	for (uint32_t id = 1; id <= 100; ++id) {
+		for (uint32_t i = 0; i < id % 5; ++i) {
+			ASSERT_EQ(0, fillCodecMessageHeader(context, TEST_TRANSMITTER_ID_1, id, &header));
+		}
+	}
+	for (uint32_t id = 1; id <= 100; ++id) {
+		ASSERT_EQ(0, fillCodecMessageHeader(context, TEST_TRANSMITTER_ID_2, id, &header));
+		EXPECT_EQ(id % 5, header.messageCounter);
+		EXPECT_EQ(TEST_TRANSMITTER_ID_2, header.transmitterID);
+		EXPECT_EQ(id, header.receiverID);
+	}
+	ASSERT_EQ(0, fillCodecMessageHeader(context, TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, &header));
+	EXPECT_EQ(static_cast<uint8_t>(300), header.messageCounter);
+}
+
+TEST_F(CodecContext, ErrorCallback) {
+	int globalErrors = 0;
+	int contextErrors = 0;
+	setISOErrorCallback(countError, &globalErrors, 0);
+	corruptCRC();
+	enum ObjectCommandType command;
+	EXPECT_LT(decodeOSTMMessageCtx(context, message, static_cast<size_t>(length), &command), 0);
+	EXPECT_EQ(1, globalErrors);
+
+	setCodecErrorCallback(context, countError, &contextErrors, 2);
+	for (int i = 0; i < 5; ++i) {
+		EXPECT_LT(decodeOSTMMessageCtx(context, message, static_cast<size_t>(length), &command), 0);
+	}
+	EXPECT_EQ(1, globalErrors);
+	EXPECT_GE(contextErrors, 2);
+	EXPECT_EQ(5u, contextErrors + getCodecSuppressedErrorCount(context));
+}
+
+TEST_F(CodecContext, ConcurrentTrajectories) {
+	const Bytes expected = encodeTrajectory(context, 200);
+	std::vector<Bytes> results(4);
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < results.size(); ++t) {
+		threads.emplace_back([&results, t]() {
+			ISOCodecContextType* threadContext = createISOCodecContext();
+			for (int i = 0; i < 20; ++i) {
+				results[t] = encodeTrajectory(threadContext, 200);
+			}
+			freeISOCodecContext(threadContext);
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	for (const auto& result : results) {
+		EXPECT_EQ(expected, result);
+	}
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "deviationmonitor.h"
+}
+#include "testdefines.h"
+#include "testtrajectories.h"
+
+class DeviationMonitor : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		monitor = createDeviationMonitor();
+		ASSERT_NE(nullptr, monitor);
+		start.startTime = { 1651198942, 0 };
+		start.isTimestampValid = true;
+		settings = {};
+		settings.maxDeviation.position_m = 2.0;
+		settings.maxDeviation.lateral_m = 1.0;
+		settings.maxDeviation.yaw_rad = 0.2;
+		settings.minRequiredPositioningAccuracy_m = 0.1;
+	}
+	void TearDown() override {
+		freeDeviationMonitor(monitor);
+	}
+
+	//! Monitor data some time after the start
+	ObjectMonitorType sample(const int64_t elapsed_us, const double x, const double y, const double heading) const {
+		ObjectMonitorType monitorData = {};
+		const int64_t time_us = start.startTime.tv_sec * 1000000LL + start.startTime.tv_usec + elapsed_us;
+		monitorData.timestamp = { static_cast<time_t>(time_us / 1000000), static_cast<suseconds_t>(time_us % 1000000) };
+		monitorData.isTimestampValid = true;
+		monitorData.position.xCoord_m = x;
+		monitorData.position.yCoord_m = y;
+		monitorData.position.heading_rad = heading;
+		monitorData.position.isPositionValid = true;
+		monitorData.position.isHeadingValid = !std::isnan(heading);
+		return monitorData;
+	}
+
+	int process(const ObjectMonitorType& monitorData, TrajectoryDeviationType* deviation = nullptr,
+				const uint32_t transmitterID = TEST_TRANSMITTER_ID_1) {
+		return processDeviationMonitorData(monitor, transmitterID, &monitorData, &monitorData.timestamp, deviation);
+	}
+
+	DeviationMonitorType* monitor;
+	StartMessageType start;
+	ObjectSettingsType settings;
+};
+
+TEST_F(DeviationMonitor, ComputesDeviations) {
+	const auto waypoints = lineTrajectory(20);
+	ASSERT_EQ(0, setDeviationTrajectory(monitor, TEST_TRANSMITTER_ID_1, waypoints.data(), waypoints.size(), &settings));
+	ASSERT_EQ(0, setDeviationStartTime(monitor, &start));
+
+	TrajectoryDeviationType deviation;
+	ASSERT_EQ(1, process(sample(10500000, 9.2, 1.5, 0.1), &deviation));
+	EXPECT_EQ(TEST_TRANSMITTER_ID_1, deviation.transmitterID);
+	EXPECT_EQ(10, deviation.trajectoryTime.tv_sec);
+	EXPECT_EQ(500000, deviation.trajectoryTime.tv_usec);
+	EXPECT_DOUBLE_EQ(std::hypot(1.3, 1.5), deviation.wayDeviation_m);
+	EXPECT_DOUBLE_EQ(1.5, deviation.lateralDeviation_m);	// Left of travel along x
+	EXPECT_NEAR(0.1, deviation.yawDeviation_rad, 1e-12);
+	EXPECT_EQ(9u, deviation.segment);
+
+	// Headings wrap, and are not compared when not reported
+	ASSERT_EQ(1, process(sample(11000000, 11.0, -0.5, 2.0 * M_PI - 0.1), &deviation));
+	EXPECT_DOUBLE_EQ(0.5, deviation.wayDeviation_m);
+	EXPECT_DOUBLE_EQ(-0.5, deviation.lateralDeviation_m);
+	EXPECT_NEAR(-0.1, deviation.yawDeviation_rad, 1e-12);
+	ASSERT_EQ(1, process(sample(12000000, 12.0, 0.0, NAN), &deviation));
+	EXPECT_TRUE(std::isnan(deviation.yawDeviation_rad));
+
+	// After the end, the object is compared to the end of the trajectory
+	ASSERT_EQ(1, process(sample(30000000, 20.0, 0.0, 0.0), &deviation));
+	EXPECT_EQ(20, deviation.trajectoryTime.tv_sec);
+	EXPECT_DOUBLE_EQ(0.0, deviation.wayDeviation_m);
+}
+
+TEST_F(DeviationMonitor, RaisesEventsWhenLimitsBecomeExceeded) {
+	const auto waypoints = lineTrajectory(20);
+	ASSERT_EQ(0, setDeviationTrajectory(monitor, TEST_TRANSMITTER_ID_1, waypoints.data(), waypoints.size(), &settings));
+	ASSERT_EQ(0, setDeviationStartTime(monitor, &start));
+	DeviationEventType events[8];
+
+	ASSERT_EQ(1, process(sample(1000000, 1.0, 0.5, 0.0)));
+	EXPECT_EQ(0u, popDeviationEvents(monitor, events, 8));
+
+	ASSERT_EQ(1, process(sample(2000000, 2.0, 1.5, 0.0)));
+	ASSERT_EQ(1, process(sample(3000000, 3.0, 1.6, 0.0)));	// Still exceeded, not raised again
+	ASSERT_EQ(1u, popDeviationEvents(monitor, events, 8));
+	EXPECT_EQ(DEVIATION_EVENT_LATERAL, events[0].kind);
+	EXPECT_EQ(TEST_TRANSMITTER_ID_1, events[0].transmitterID);
+	EXPECT_DOUBLE_EQ(1.5, events[0].deviation);
+	EXPECT_DOUBLE_EQ(1.0, events[0].limit);
+	EXPECT_EQ(start.startTime.tv_sec + 2, events[0].sampleTime.tv_sec);
+
+	// Within, then exceeded on the other side, behind schedule, turned and with poor positioning
+	ASSERT_EQ(1, process(sample(4000000, 4.0, 0.0, 0.0)));
+	ObjectMonitorType monitorData = sample(5000000, 2.5, -1.2, -0.3);
+	monitorData.error.badPositioningAccuracy = true;
+	ASSERT_EQ(1, process(monitorData));
+	ASSERT_EQ(4u, popDeviationEvents(monitor, events, 8));
+	EXPECT_EQ(DEVIATION_EVENT_WAY, events[0].kind);
+	EXPECT_DOUBLE_EQ(std::hypot(2.5, 1.2), events[0].deviation);
+	EXPECT_DOUBLE_EQ(2.0, events[0].limit);
+	EXPECT_EQ(DEVIATION_EVENT_LATERAL, events[1].kind);
+	EXPECT_DOUBLE_EQ(1.2, events[1].deviation);
+	EXPECT_EQ(DEVIATION_EVENT_YAW, events[2].kind);
+	EXPECT_NEAR(0.3, events[2].deviation, 1e-12);
+	EXPECT_EQ(DEVIATION_EVENT_POSITIONING_ACCURACY, events[3].kind);
+	EXPECT_TRUE(std::isnan(events[3].deviation));
+	EXPECT_DOUBLE_EQ(0.1, events[3].limit);
+
+	// Events are popped oldest first, a few at a time
+	ASSERT_EQ(1, process(sample(6000000, 6.0, 0.0, 0.0)));
+	ASSERT_EQ(1, process(sample(7000000, 7.0, 3.0, 0.0)));
+	ASSERT_EQ(1, process(sample(8000000, 8.0, 0.0, 0.0)));
+	ASSERT_EQ(1, process(sample(9000000, 9.0, -3.0, 0.0)));
+	ASSERT_EQ(1u, popDeviationEvents(monitor, events, 1));
+	EXPECT_EQ(7, events[0].sampleTime.tv_sec - start.startTime.tv_sec);
+	EXPECT_EQ(DEVIATION_EVENT_WAY, events[0].kind);
+	ASSERT_EQ(3u, popDeviationEvents(monitor, events, 8));
+	EXPECT_EQ(7, events[0].sampleTime.tv_sec - start.startTime.tv_sec);
+	EXPECT_EQ(9, events[1].sampleTime.tv_sec - start.startTime.tv_sec);
+	EXPECT_EQ(9, events[2].sampleTime.tv_sec - start.startTime.tv_sec);
+
+	const DeviationStatisticsType statistics = getDeviationStatistics(monitor);
+	EXPECT_EQ(9u, statistics.nEvaluations);
+	EXPECT_EQ(9u, statistics.nEvents);
+}
+
+TEST_F(DeviationMonitor, FollowsProgressAlongOverlappingPath) {
+	const auto waypoints = lineTrajectory(10, true);
+	ASSERT_EQ(0, setDeviationTrajectory(monitor, TEST_TRANSMITTER_ID_1, waypoints.data(), waypoints.size(), &settings));
+	ASSERT_EQ(0, setDeviationStartTime(monitor, &start));
+
+	// Out and back along the same line, slightly to the left of travel both ways
+	TrajectoryDeviationType deviation;
+	for (int i = 0; i <= 40; ++i) {
+		const double elapsed_s = i * 0.5;
+		const bool isReturning = elapsed_s > 10.0;
+		const double x = isReturning ? 20.0 - elapsed_s : elapsed_s;
+		ASSERT_EQ(1, process(sample(static_cast<int64_t>(elapsed_s * 1e6), x, isReturning ? -0.2 : 0.2,
+									isReturning ? M_PI : 0.0), &deviation));
+		EXPECT_NEAR(0.0, deviation.wayDeviation_m, 0.2 + 1e-12) << elapsed_s;
+		if (std::fabs(elapsed_s - 10.0) >= 1.0) {	// The heading of the path turns around the turning point
+			EXPECT_NEAR(0.2, deviation.lateralDeviation_m, 1e-12) << elapsed_s;
+			EXPECT_NEAR(0.0, deviation.yawDeviation_rad, 1e-12) << elapsed_s;
+		}
+		if (isReturning) {
+			EXPECT_LE(10u, deviation.segment) << elapsed_s;
+		}
+	}
+	EXPECT_EQ(0u, popDeviationEvents(monitor, nullptr, 0));
+
+	const DeviationStatisticsType statistics = getDeviationStatistics(monitor);
+	EXPECT_EQ(1u, statistics.nReacquisitions);
+	EXPECT_GT(4u * 41u, statistics.nSegmentsTested);
+
+	// A jump away from the path is projected onto the whole path
+	ASSERT_EQ(1, process(sample(21000000, 4.0, 8.0, 0.0), &deviation));
+	EXPECT_EQ(2u, getDeviationStatistics(monitor).nReacquisitions);
+	EXPECT_DOUBLE_EQ(8.0, std::fabs(deviation.lateralDeviation_m));
+}
+
+TEST_F(DeviationMonitor, IgnoresUnevaluableData) {
+	const auto waypoints = lineTrajectory(20);
+	TrajectoryDeviationType deviation = {};
+	ASSERT_EQ(0, setDeviationTrajectory(monitor, TEST_TRANSMITTER_ID_1, waypoints.data(), waypoints.size(), nullptr));
+
+	// Before a start time is set, and before the start
+	EXPECT_EQ(0, process(sample(1000000, 1.0, 5.0, 0.0), &deviation));
+	ASSERT_EQ(0, setDeviationStartTime(monitor, &start));
+	EXPECT_EQ(0, process(sample(-1000000, 0.0, 0.0, 0.0), &deviation));
+
+	// Unknown objects and invalid positions
+	EXPECT_EQ(0, process(sample(1000000, 1.0, 0.0, 0.0), &deviation, TEST_TRANSMITTER_ID_2));
+	ObjectMonitorType monitorData = sample(1000000, 1.0, 0.0, 0.0);
+	monitorData.position.isPositionValid = false;
+	EXPECT_EQ(0, process(monitorData, &deviation));
+	EXPECT_EQ(0u, deviation.transmitterID);
+
+	// Without limits, no events are raised
+	monitorData = sample(2000000, 2.0, 30.0, 3.0);
+	monitorData.error.badPositioningAccuracy = true;
+	EXPECT_EQ(1, process(monitorData, &deviation));
+	EXPECT_DOUBLE_EQ(30.0, deviation.lateralDeviation_m);
+	DeviationEventType event;
+	EXPECT_EQ(0u, popDeviationEvents(monitor, &event, 1));
+
+	EXPECT_EQ(-1, removeDeviationTrajectory(monitor, TEST_TRANSMITTER_ID_2));
+	EXPECT_EQ(ENOENT, errno);
+	EXPECT_EQ(0, removeDeviationTrajectory(monitor, TEST_TRANSMITTER_ID_1));
+	EXPECT_EQ(0, process(sample(3000000, 3.0, 0.0, 0.0), &deviation));
+	EXPECT_EQ(-1, processDeviationMonitorData(monitor, TEST_TRANSMITTER_ID_1, nullptr, &start.startTime, nullptr));
+	EXPECT_EQ(EINVAL, errno);
+	errno = 0;
+	EXPECT_EQ(0u, popDeviationEvents(nullptr, &event, 1));
+	EXPECT_EQ(EINVAL, errno);
+	errno = 0;
+	EXPECT_EQ(0u, getDeviationStatistics(nullptr).nMonitorSamples);
+	EXPECT_EQ(EINVAL, errno);
+
+	resetDeviationMonitor(monitor);
+	EXPECT_EQ(0u, getDeviationStatistics(monitor).nMonitorSamples);
+}
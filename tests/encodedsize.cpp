@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include <functional>
+#include <vector>
+extern "C" {
+#include "iso22133.h"
+#include "isoerror.h"
+#include "defines.h"
+#include "frame.h"
+}
+#include "testdefines.h"
+
+typedef std::function<ssize_t(char*, size_t)> Encoder;
+
+class EncodedSize : public ::testing::Test
+{
+protected:
+	static constexpr size_t GuardLength = 16;
+	static constexpr char GuardByte = static_cast<char>(0xAA);
+
+	//! Encode into a buffer of exactly the queried size followed by guard bytes
+	static void expectExactSize(const size_t expectedSize, const Encoder& encode) {
+		std::vector<char> buffer(expectedSize + GuardLength, GuardByte);
+		ASSERT_EQ(static_cast<ssize_t>(expectedSize), encode(buffer.data(), expectedSize))
+			<< getLastISOError().description;
+		for (size_t i = expectedSize; i < buffer.size(); ++i) {
+			EXPECT_EQ(GuardByte, buffer[i]) << "byte " << i << " overwritten";
+		}
+		HeaderType frameHeader;
+		EXPECT_EQ(static_cast<ssize_t>(expectedSize), validateISOFrame(buffer.data(), expectedSize, &frameHeader))
+			<< "header length or checksum does not match the encoded message";
+		EXPECT_LT(encode(buffer.data(), expectedSize - 1), 0);
+	}
+
+	MessageHeaderType header = { TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, TEST_DEFAULT_MESSAGE_COUNTER };
+	struct timeval time = { 1651198942, 500000 };
+};
+
+TEST_F(EncodedSize, FixedSizeMessages) {
+	expectExactSize(getEncodedSizeOSTMMessage(), [&](char* buffer, size_t length) {
+		return encodeOSTMMessage(&header, OBJECT_COMMAND_ARM, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizeHEABMessage(), [&](char* buffer, size_t length) {
+		return encodeHEABMessage(&header, &time, CONTROL_CENTER_STATUS_RUNNING, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizeSTRTMessage(), [&](char* buffer, size_t length) {
+		StartMessageType start;
+		start.startTime = time;
+		start.isTimestampValid = true;
+		return encodeSTRTMessage(&header, &start, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizeDREQMessage(), [&](char* buffer, size_t length) {
+		return encodeDREQMessage(&header, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizeMONRMessage(), [&](char* buffer, size_t length) {
+		CartesianPosition position = {};
+		position.isPositionValid = position.isXcoordValid = position.isYcoordValid = true;
+		SpeedType speed = {};
+		speed.isLongitudinalValid = true;
+		AccelerationType acceleration = {};
+		return encodeMONRMessage(&header, &time, position, speed, acceleration, ISO_DRIVE_DIRECTION_FORWARD,
+								 ISO_OBJECT_STATE_RUNNING, ISO_READY_TO_ARM, 0, 0, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizePODIMessage(), [&](char* buffer, size_t length) {
+		PeerObjectInjectionType peer = {};
+		peer.foreignTransmitterID = TEST_TRANSMITTER_ID_2;
+		peer.dataTimestamp = time;
+		peer.state = OBJECT_STATE_RUNNING;
+		peer.position.isPositionValid = peer.position.isXcoordValid = peer.position.isYcoordValid = true;
+		peer.position.isHeadingValid = true;
+		peer.speed.isLongitudinalValid = peer.speed.isLateralValid = true;
+		return encodePODIMessage(&header, &peer, buffer, length, false);
+	});
+}
+
+TEST_F(EncodedSize, FixedSizeControlMessages) {
+	expectExactSize(getEncodedSizeSYPMMessage(), [&](char* buffer, size_t length) {
+		return encodeSYPMMessage(&header, time, time, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizeMTSPMessage(), [&](char* buffer, size_t length) {
+		return encodeMTSPMessage(&header, &time, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizeTRCMMessage(), [&](char* buffer, size_t length) {
+		const uint16_t triggerID = 1;
+		const enum TriggerType_t triggerType = TRIGGER_TYPE_1;
+		const enum TriggerTypeParameter_t parameter = TRIGGER_PARAMETER_TRUE;
+		return encodeTRCMMessage(&header, &triggerID, &triggerType, &parameter, &parameter, &parameter, buffer,
+								 length, false);
+	});
+	expectExactSize(getEncodedSizeACCMMessage(), [&](char* buffer, size_t length) {
+		const uint16_t actionID = 2;
+		const enum ActionType_t actionType = ACTION_TYPE_1;
+		const enum ActionTypeParameter_t parameter = ACTION_PARAMETER_SET_TRUE;
+		return encodeACCMMessage(&header, &actionID, &actionType, &parameter, &parameter, &parameter, buffer,
+								 length, false);
+	});
+	expectExactSize(getEncodedSizeEXACMessage(), [&](char* buffer, size_t length) {
+		const uint16_t actionID = 2;
+		return encodeEXACMessage(&header, &actionID, &time, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizeINSUPMessage(), [&](char* buffer, size_t length) {
+		return encodeINSUPMessage(&header, SUPERVISOR_COMMAND_NORMAL, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizeGREMMessage(), [&](char* buffer, size_t length) {
+		GeneralResponseMessageType response = {};
+		response.receivedHeaderTransmitterID = TEST_TRANSMITTER_ID_2;
+		response.receivedHeaderMessageID = MESSAGE_ID_OSEM;
+		response.responseCode = GREM_OK;
+		return encodeGREMMessage(&header, &response, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizeDRESMessage(), [&](char* buffer, size_t length) {
+		TestObjectDiscoveryType discovery = {};
+		strcpy(discovery.vendor, "vendor");
+		strcpy(discovery.productName, "product");
+		strcpy(discovery.firmwareVersion, "1.0");
+		strcpy(discovery.testObjectName, "object");
+		discovery.testObjectTypeCode = OBJECT_TYPE_MOVEABLE;
+		return encodeDRESMessage(&header, &discovery, buffer, length, false);
+	});
+}
+
+TEST_F(EncodedSize, FixedSizeVendorMessages) {
+	expectExactSize(getEncodedSizeOPROMessage(), [&](char* buffer, size_t length) {
+		ObjectPropertiesType properties = {};
+		properties.isMassValid = true;
+		properties.mass_kg = 1500.0;
+		return encodeOPROMessage(&header, &properties, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizeFOPRMessage(), [&](char* buffer, size_t length) {
+		ForeignObjectPropertiesType properties = {};
+		properties.foreignTransmitterID = TEST_TRANSMITTER_ID_2;
+		properties.isObjectXDimensionValid = true;
+		properties.objectXDimension_m = 4.5;
+		return encodeFOPRMessage(&header, &properties, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizeGDRMMessage(), [&](char* buffer, size_t length) {
+		GdrmMessageDataType request = { DIRECT_CONTROL_TRANSMITTER_ID_REQUEST };
+		return encodeGDRMMessage(&header, &request, buffer, length, false);
+	});
+	expectExactSize(getEncodedSizeDCTIMessage(), [&](char* buffer, size_t length) {
+		DctiMessageDataType transmitter = { 2, 1, TEST_TRANSMITTER_ID_2 };
+		return encodeDCTIMessage(&header, &transmitter, buffer, length, false);
+	});
+}
+
+TEST_F(EncodedSize, RCMMDependsOnValidManoeuvres) {
+	RemoteControlManoeuvreMessageType manoeuvre = {};
+	manoeuvre.steeringManoeuvre.pct = 20.0;
+	manoeuvre.steeringUnit = ISO_UNIT_TYPE_STEERING_PERCENTAGE;
+	manoeuvre.speedManoeuvre.m_s = 2.5;
+	manoeuvre.speedUnit = ISO_UNIT_TYPE_SPEED_METER_SECOND;
+	manoeuvre.isThrottleManoeuvreValid = manoeuvre.isBrakeManoeuvreValid = true;
+	manoeuvre.throttleUnit = ISO_UNIT_TYPE_THROTTLE_PERCENTAGE;
+	manoeuvre.brakeUnit = ISO_UNIT_TYPE_BRAKE_PERCENTAGE;
+
+	size_t previousSize = 0;
+	for (int validFields = 0; validFields <= 3; ++validFields) {
+		manoeuvre.isSteeringManoeuvreValid = validFields >= 1;
+		manoeuvre.isSpeedManoeuvreValid = validFields >= 2;
+		manoeuvre.command = validFields >= 3 ? MANOEUVRE_BACK_TO_START : MANOEUVRE_NONE;
+		const size_t size = getEncodedSizeRCMMMessage(&manoeuvre);
+		EXPECT_GT(size, previousSize);
+		expectExactSize(size, [&](char* buffer, size_t length) {
+			return encodeRCMMMessage(&header, &manoeuvre, buffer, length, false);
+		});
+		EXPECT_EQ(size, getEncodedSizeDCMMMessage(&manoeuvre));
+		expectExactSize(size, [&](char* buffer, size_t length) {
+			return encodeDCMMMessage(&header, &manoeuvre, buffer, length, false);
+		});
+		previousSize = size;
+	}
+}
+
+TEST_F(EncodedSize, OSEMDependsOnTimeServer) {
+	ObjectSettingsType settings = {};
+	settings.currentTime = time;
+	settings.coordinateSystemType = COORDINATE_SYSTEM_WGS84;
+	const size_t withoutTimeServer = getEncodedSizeOSEMMessage(&settings);
+	expectExactSize(withoutTimeServer, [&](char* buffer, size_t length) {
+		return encodeOSEMMessage(&header, &settings, buffer, length, false);
+	});
+
+	settings.timeServer.ip = 0x0A000001;
+	settings.timeServer.port = 123;
+	const size_t withTimeServer = getEncodedSizeOSEMMessage(&settings);
+	EXPECT_GT(withTimeServer, withoutTimeServer);
+	expectExactSize(withTimeServer, [&](char* buffer, size_t length) {
+		return encodeOSEMMessage(&header, &settings, buffer, length, false);
+	});
+}
+
+TEST_F(EncodedSize, RDCADependsOnValidActions) {
+	RequestControlActionType action = {};
+	action.executingID = TEST_TRANSMITTER_ID_2;
+	action.dataTimestamp = time;
+	action.steeringAction.rad = 0.05;
+	action.steeringUnit = ISO_UNIT_TYPE_STEERING_DEGREES;
+	action.speedAction.m_s = 8.3;
+	action.speedUnit = ISO_UNIT_TYPE_SPEED_METER_SECOND;
+
+	size_t previousSize = 0;
+	for (int validActions = 0; validActions <= 2; ++validActions) {
+		action.isSteeringActionValid = validActions >= 1;
+		action.isSpeedActionValid = validActions >= 2;
+		const size_t size = getEncodedSizeRDCAMessage(&action);
+		EXPECT_GT(size, previousSize);
+		expectExactSize(size, [&](char* buffer, size_t length) {
+			return encodeRDCAMessage(&header, &action, buffer, length, false);
+		});
+		previousSize = size;
+	}
+}
+
+TEST_F(EncodedSize, TRAJMatchesEncodedParts) {
+	const uint32_t nPoints = 10;
+	std::vector<char> buffer(getEncodedSizeTRAJMessage(nPoints) + GuardLength, GuardByte);
+	char name[] = "trajectory";
+	char* p = buffer.data();
+	size_t remaining = getEncodedSizeTRAJMessage(nPoints);
+	ssize_t n = encodeTRAJMessageHeader(&header, 1, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, name, sizeof(name) - 1,
+										nPoints, p, remaining, false);
+	ASSERT_GT(n, 0);
+	p += n;
+	remaining -= static_cast<size_t>(n);
+	for (uint32_t i = 0; i < nPoints; ++i) {
+		struct timeval pointTime = { 0, static_cast<suseconds_t>(i * 10000) };
+		CartesianPosition position = {};
+		position.isPositionValid = true;
+		SpeedType speed = {};
+		speed.isLongitudinalValid = true;
+		AccelerationType acceleration = {};
+		n = encodeTRAJMessagePoint(&pointTime, position, speed, acceleration, 0.0f, p, remaining, false);
+		ASSERT_GT(n, 0);
+		p += n;
+		remaining -= static_cast<size_t>(n);
+	}
+	n = encodeTRAJMessageFooter(p, remaining, false);
+	ASSERT_GT(n, 0);
+	EXPECT_EQ(static_cast<size_t>(n), remaining);
+	for (size_t i = getEncodedSizeTRAJMessage(nPoints); i < buffer.size(); ++i) {
+		EXPECT_EQ(GuardByte, buffer[i]);
+	}
+}
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "fleetevaluator.h"
+#include "trajectoryindex.h"
+}
+
+class FleetEvaluator : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		evaluator = createFleetEvaluator();
+		ASSERT_NE(nullptr, evaluator);
+		start.startTime = { 1651198942, 500000 };
+		start.isTimestampValid = true;
+	}
+	void TearDown() override {
+		freeFleetEvaluator(evaluator);
+	}
+
+	//! Trajectory with points every 100 ms and its own speed and heading rate, starting after a delay
+	static std::vector<TrajectoryWaypointType> trajectory(const double speed, const int nPoints,
+														  const int delayPoints = 0) {
+		std::vector<TrajectoryWaypointType> waypoints;
+		for (int i = delayPoints; i < delayPoints + nPoints; ++i) {
+			TrajectoryWaypointType waypoint = {};
+			waypoint.relativeTime = { i / 10, (i % 10) * 100000 };
+			waypoint.pos.xCoord_m = speed * i * 0.1;
+			waypoint.pos.yCoord_m = -speed * i * 0.05;
+			waypoint.pos.heading_rad = std::fmod(6.0 + speed * i * 0.01, 2.0 * M_PI);
+			waypoint.pos.isPositionValid = true;
+			waypoint.spd.longitudinal_m_s = speed + i * 0.01;
+			waypoint.acc.lateral_m_s2 = -0.1 * i;
+			waypoint.curvature = 0.002f * i;
+			waypoints.push_back(waypoint);
+		}
+		return waypoints;
+	}
+
+	struct timeval at(const int64_t elapsed_us) const {
+		const int64_t time_us = start.startTime.tv_sec * 1000000LL + start.startTime.tv_usec + elapsed_us;
+		return { static_cast<time_t>(time_us / 1000000), static_cast<suseconds_t>(time_us % 1000000) };
+	}
+
+	FleetEvaluatorType* evaluator;
+	StartMessageType start;
+};
+
+TEST_F(FleetEvaluator, MatchesSingleTrajectoryLookup) {
+	std::vector<std::vector<TrajectoryWaypointType>> trajectories;
+	for (int i = 0; i < 4; ++i) {
+		trajectories.push_back(trajectory(5.0 + i, 200 + 50 * i, 3 * i));
+	}
+	for (int i = 3; i >= 0; --i) {
+		ASSERT_EQ(0, setFleetTrajectory(evaluator, 10 * (i + 1), trajectories[i].data(), trajectories[i].size()));
+	}
+	ASSERT_EQ(0, setFleetStartTime(evaluator, &start));
+
+	std::vector<TrajectoryIndexType*> indices;
+	for (const auto& waypoints : trajectories) {
+		indices.push_back(createTrajectoryIndex(waypoints.data(), waypoints.size()));
+	}
+	FleetPlannedStatesType states;
+	for (int64_t elapsed_us = 0; elapsed_us < 40000000; elapsed_us += 16667) {
+		const struct timeval time = at(elapsed_us);
+		const ssize_t nWithin = evaluateFleetPlannedStates(evaluator, &time, &states);
+		ASSERT_EQ(4u, states.nObjects);
+		ssize_t nExpectedWithin = 0;
+		for (size_t k = 0; k < states.nObjects; ++k) {
+			ASSERT_EQ(10 * (k + 1), states.transmitterID[k]);
+			const struct timeval relativeTime = { static_cast<time_t>(elapsed_us / 1000000),
+												  static_cast<suseconds_t>(elapsed_us % 1000000) };
+			TrajectoryWaypointType expected;
+			const bool isWithin = getTrajectoryPointAt(indices[k], &relativeTime, &expected) == 0;
+			nExpectedWithin += isWithin;
+			EXPECT_EQ(isWithin, states.isWithinTrajectory[k]);
+			EXPECT_DOUBLE_EQ(expected.pos.xCoord_m, states.x_m[k]) << elapsed_us;
+			EXPECT_DOUBLE_EQ(expected.pos.yCoord_m, states.y_m[k]);
+			EXPECT_NEAR(expected.pos.heading_rad, states.heading_rad[k], 1e-12);
+			EXPECT_DOUBLE_EQ(expected.spd.longitudinal_m_s, states.longitudinalSpeed_m_s[k]);
+			EXPECT_DOUBLE_EQ(expected.acc.lateral_m_s2, states.lateralAcceleration_m_s2[k]);
+			EXPECT_FLOAT_EQ(expected.curvature, states.curvature[k]);
+		}
+		EXPECT_EQ(nExpectedWithin, nWithin);
+	}
+	for (TrajectoryIndexType* index : indices) {
+		freeTrajectoryIndex(index);
+	}
+}
+
+TEST_F(FleetEvaluator, OrdersObjectsByTransmitterID) {
+	const auto waypoints = trajectory(1.0, 10);
+	ASSERT_EQ(0, setFleetTrajectory(evaluator, 7, waypoints.data(), waypoints.size()));
+	ASSERT_EQ(0, setFleetTrajectory(evaluator, 3, waypoints.data(), waypoints.size()));
+	ASSERT_EQ(0, setFleetTrajectory(evaluator, 5, waypoints.data(), waypoints.size()));
+	// Replacing keeps one row per object
+	const auto faster = trajectory(2.0, 10);
+	ASSERT_EQ(0, setFleetTrajectory(evaluator, 5, faster.data(), faster.size()));
+	ASSERT_EQ(0, setFleetStartTime(evaluator, &start));
+
+	FleetPlannedStatesType states;
+	const struct timeval time = at(500000);
+	ASSERT_EQ(3, evaluateFleetPlannedStates(evaluator, &time, &states));
+	ASSERT_EQ(3u, states.nObjects);
+	EXPECT_EQ(3u, states.transmitterID[0]);
+	EXPECT_EQ(5u, states.transmitterID[1]);
+	EXPECT_EQ(7u, states.transmitterID[2]);
+	EXPECT_DOUBLE_EQ(0.5, states.x_m[0]);
+	EXPECT_DOUBLE_EQ(1.0, states.x_m[1]);
+
+	ASSERT_EQ(0, removeFleetTrajectory(evaluator, 5));
+	errno = 0;
+	EXPECT_EQ(-1, removeFleetTrajectory(evaluator, 5));
+	EXPECT_EQ(ENOENT, errno);
+	ASSERT_EQ(2, evaluateFleetPlannedStates(evaluator, &time, &states));
+	EXPECT_EQ(7u, states.transmitterID[1]);
+}
+
+TEST_F(FleetEvaluator, GrowsToManyObjects) {
+	const auto waypoints = trajectory(1.0, 100);
+	for (uint32_t id = 0; id < 300; ++id) {
+		ASSERT_EQ(0, setFleetTrajectory(evaluator, 1000 - id, waypoints.data(), waypoints.size()));
+	}
+	ASSERT_EQ(0, setFleetStartTime(evaluator, &start));
+	FleetPlannedStatesType states;
+	const struct timeval time = at(2250000);
+	ASSERT_EQ(300, evaluateFleetPlannedStates(evaluator, &time, &states));
+	for (size_t k = 0; k < states.nObjects; ++k) {
+		EXPECT_EQ(701 + k, states.transmitterID[k]);
+		EXPECT_DOUBLE_EQ(2.25, states.x_m[k]);
+	}
+}
+
+TEST_F(FleetEvaluator, RequiresStartTime) {
+	const auto waypoints = trajectory(1.0, 10);
+	ASSERT_EQ(0, setFleetTrajectory(evaluator, 1, waypoints.data(), waypoints.size()));
+	FleetPlannedStatesType states;
+	const struct timeval time = at(0);
+	errno = 0;
+	EXPECT_EQ(-1, evaluateFleetPlannedStates(evaluator, &time, &states));
+	EXPECT_EQ(EINVAL, errno);
+	start.isTimestampValid = false;
+	EXPECT_EQ(-1, setFleetStartTime(evaluator, &start));
+	EXPECT_EQ(-1, setFleetTrajectory(evaluator, 2, waypoints.data(), 0));
+
+	// Before the start, the first point is planned
+	start.isTimestampValid = true;
+	ASSERT_EQ(0, setFleetStartTime(evaluator, &start));
+	const struct timeval before = at(-1000000);
+	ASSERT_EQ(0, evaluateFleetPlannedStates(evaluator, &before, &states));
+	EXPECT_FALSE(states.isWithinTrajectory[0]);
+	EXPECT_DOUBLE_EQ(0.0, states.x_m[0]);
+}
@@ -96,3 +96,15 @@ TEST(FooterEncode, TrajPointCRC) {
 	auto res = crc16(reinterpret_cast<uint8_t*>(data), sizeof(data));
 	EXPECT_EQ(res, 0x7484);
 }
+
+TEST(FooterEncode, CombinedCrcMatchesWholeBlock) {
+	uint8_t data[300];
+	for (size_t i = 0; i < sizeof(data); ++i) {
+		data[i] = static_cast<uint8_t>(i * 37 + 11);
+	}
+	for (size_t split : { size_t(0), size_t(1), size_t(150), sizeof(data) }) {
+		EXPECT_EQ(crc16(data, sizeof(data)),
+				  crc16Combine(crc16(data, split), crc16(data + split, sizeof(data) - split), sizeof(data) - split))
+			<< "Split at " << split;
+	}
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <vector>
+extern "C" {
+#include "frame.h"
+#include "footer.h"
+#include "codeccontext.h"
+#include "iso22133.h"
+#include "defines.h"
+}
+#include "testdefines.h"
+
+typedef std::vector<char> Bytes;
+
+class Frame : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		for (uint8_t i = 0; i < 10; ++i) {
+			MessageHeaderType header = { static_cast<uint32_t>(TEST_TRANSMITTER_ID_1 + i), TEST_DEFAULT_RECEIVER_ID, i };
+			Bytes message(128);
+			ssize_t length;
+			if (i % 2 == 0) {
+				length = encodeOSTMMessage(&header, OBJECT_COMMAND_ARM, message.data(), message.size(), false);
+			}
+			else {
+				struct timeval time = { 1651198942, 0 };
+				length = encodeHEABMessage(&header, &time, CONTROL_CENTER_STATUS_RUNNING, message.data(),
+										   message.size(), false);
+			}
+			ASSERT_GT(length, 0);
+			message.resize(static_cast<size_t>(length));
+			messages.push_back(message);
+		}
+	}
+
+	std::vector<ssize_t> validateAll(std::vector<HeaderType>& headers, size_t& nValid) {
+		std::vector<const void*> frames;
+		std::vector<size_t> lengths;
+		for (const auto& message : messages) {
+			frames.push_back(message.data());
+			lengths.push_back(message.size());
+		}
+		headers.resize(messages.size());
+		std::vector<ssize_t> results(messages.size());
+		nValid = validateISOFrames(frames.data(), lengths.data(), frames.size(), headers.data(), results.data());
+		return results;
+	}
+
+	std::vector<Bytes> messages;
+};
+
+TEST_F(Frame, ValidatesAndDecodesHeader) {
+	HeaderType header;
+	const Bytes& message = messages[1];
+	ASSERT_EQ(static_cast<ssize_t>(message.size()), validateISOFrame(message.data(), message.size(), &header));
+	HeaderType expected;
+	ASSERT_EQ(MESSAGE_OK, decodeISOHeader(message.data(), message.size(), &expected, false));
+	EXPECT_EQ(0, memcmp(&expected, &header, sizeof(header)));
+	EXPECT_EQ(TEST_TRANSMITTER_ID_1 + 1, header.transmitterID);
+	EXPECT_EQ(MESSAGE_ID_HEAB, header.messageID);
+
+	// Trailing data after the message is allowed
+	Bytes longer(message);
+	longer.resize(message.size() + 10, 0x55);
+	EXPECT_EQ(static_cast<ssize_t>(message.size()), validateISOFrame(longer.data(), longer.size(), &header));
+}
+
+TEST_F(Frame, DetectsMalformedFrames) {
+	HeaderType header;
+	Bytes message = messages[0];
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR, validateISOFrame(message.data(), message.size() - 1, &header));
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR, validateISOFrame(message.data(), 5, &header));
+
+	message[0] ^= 0x01;
+	EXPECT_EQ(MESSAGE_SYNC_WORD_ERROR, validateISOFrame(message.data(), message.size(), &header));
+	message[0] ^= 0x01;
+
+	message[6] = static_cast<char>((message[6] & 0x80) | 3);
+	EXPECT_EQ(MESSAGE_VERSION_ERROR, validateISOFrame(message.data(), message.size(), &header));
+
+	message = messages[0];
+	message[sizeof(HeaderType)] ^= 0x10;
+	EXPECT_EQ(MESSAGE_CRC_ERROR, validateISOFrame(message.data(), message.size(), &header));
+	EXPECT_EQ(0u, header.transmitterID);
+
+	// A zero CRC means that the message carries no checksum
+	message[message.size() - 1] = message[message.size() - 2] = 0;
+	EXPECT_EQ(static_cast<ssize_t>(message.size()), validateISOFrame(message.data(), message.size(), &header));
+}
+
+TEST_F(Frame, CRCVerificationFollowsContext) {
+	Bytes message = messages[0];
+	message[sizeof(HeaderType)] ^= 0x10;
+	HeaderType header;
+	ISOCodecContextType* context = createISOCodecContext();
+	ASSERT_NE(nullptr, context);
+	EXPECT_EQ(MESSAGE_CRC_ERROR, validateISOFrameCtx(context, message.data(), message.size(), &header));
+	setCodecCRCVerification(context, false);
+	EXPECT_EQ(static_cast<ssize_t>(message.size()),
+			  validateISOFrameCtx(context, message.data(), message.size(), &header));
+	freeISOCodecContext(context);
+}
+
+TEST_F(Frame, BatchMatchesSingleValidation) {
+	// Enough frames for several batches, with differing lengths and a few corrupted
+	const std::vector<Bytes> originals = messages;
+	for (int repeat = 0; repeat < 20; ++repeat) {
+		messages.insert(messages.end(), originals.begin(), originals.end());
+	}
+	messages[3][sizeof(HeaderType) + 2] ^= 0x01;
+	messages[70][0] = 0;
+	messages[71].resize(messages[71].size() - 1);
+	messages[130][sizeof(HeaderType)] ^= 0x40;
+
+	std::vector<HeaderType> headers;
+	size_t nValid;
+	std::vector<ssize_t> results = validateAll(headers, nValid);
+	size_t nExpectedValid = 0;
+	for (size_t i = 0; i < messages.size(); ++i) {
+		HeaderType header;
+		const ssize_t expected = validateISOFrame(messages[i].data(), messages[i].size(), &header);
+		EXPECT_EQ(expected, results[i]) << "frame " << i;
+		EXPECT_EQ(0, memcmp(&header, &headers[i], sizeof(header))) << "frame " << i;
+		nExpectedValid += expected > 0;
+	}
+	EXPECT_EQ(nExpectedValid, nValid);
+	EXPECT_EQ(messages.size() - 4, nValid);
+	EXPECT_EQ(MESSAGE_CRC_ERROR, results[3]);
+	EXPECT_EQ(MESSAGE_SYNC_WORD_ERROR, results[70]);
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR, results[71]);
+}
+
+TEST_F(Frame, InterleavedCRCMatchesSequential) {
+	std::vector<uint8_t> data(300);
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = static_cast<uint8_t>(i * 37 + 11);
+	}
+	std::vector<const uint8_t*> blocks;
+	std::vector<size_t> lengths;
+	for (size_t i = 0; i < 11; ++i) {
+		blocks.push_back(data.data() + i * 7);
+		lengths.push_back((i * 53) % 200);
+	}
+	std::vector<uint16_t> crcs(blocks.size());
+	crc16Interleaved(blocks.data(), lengths.data(), blocks.size(), crcs.data());
+	for (size_t i = 0; i < blocks.size(); ++i) {
+		EXPECT_EQ(crc16(blocks[i], lengths[i]), crcs[i]) << "block " << i;
+	}
+}
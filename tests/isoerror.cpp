@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+extern "C" {
+#include "isoerror.h"
+#include "iso22133.h"
+#include "defines.h"
+#include "header.h"
+}
+#include "testdefines.h"
+
+struct ReportedErrors {
+	std::vector<ISOErrorType> errors;
+	std::vector<std::string> messages;
+};
+
+static void collectError(const ISOErrorType* error, const char* message, void* userData) {
+	auto reported = static_cast<ReportedErrors*>(userData);
+	reported->errors.push_back(*error);
+	reported->messages.push_back(message);
+}
+
+class ISOError : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		clearLastISOError();
+		MessageHeaderType header = { TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, TEST_DEFAULT_MESSAGE_COUNTER };
+		struct timeval time = { 1651198942, 0 };
+		CartesianPosition position;
+		memset(&position, 0, sizeof(position));
+		position.isPositionValid = position.isXcoordValid = position.isYcoordValid = true;
+		SpeedType speed;
+		memset(&speed, 0, sizeof(speed));
+		speed.isLongitudinalValid = true;
+		AccelerationType acceleration;
+		memset(&acceleration, 0, sizeof(acceleration));
+		length = encodeMONRMessage(&header, &time, position, speed, acceleration, ISO_DRIVE_DIRECTION_FORWARD,
+								   ISO_OBJECT_STATE_RUNNING, ISO_READY_TO_ARM, 0, 0, message, sizeof(message), false);
+		ASSERT_GT(length, 0);
+		ASSERT_EQ(MESSAGE_OK, getLastISOError().code);
+	}
+	void TearDown() override {
+		setISOErrorCallback(nullptr, nullptr, 0);
+	}
+
+	//! Overwrite the MONR value ID, which invalidates the message
+	void corruptValueID() {
+		message[sizeof(HeaderType)] = 0x7F;
+		message[sizeof(HeaderType) + 1] = 0x7F;
+	}
+
+	ssize_t decode() {
+		struct timeval now = { 1651198942, 0 };
+		ObjectMonitorType monitor;
+		return decodeMONRMessage(message, static_cast<size_t>(length), now, &monitor, false);
+	}
+
+	char message[256];
+	ssize_t length;
+};
+
+TEST_F(ISOError, RecordsLastError) {
+	corruptValueID();
+	EXPECT_LT(decode(), 0);
+	ISOErrorType error = getLastISOError();
+	EXPECT_EQ(MESSAGE_VALUE_ID_ERROR, error.code);
+	EXPECT_EQ(MESSAGE_ID_MONR, error.messageID);
+	EXPECT_GE(error.offset, sizeof(HeaderType));
+	EXPECT_LE(error.offset, static_cast<size_t>(length));
+	ASSERT_NE(nullptr, error.function);
+	EXPECT_NE(nullptr, error.description);
+
+	clearLastISOError();
+	EXPECT_EQ(MESSAGE_OK, getLastISOError().code);
+	EXPECT_EQ(nullptr, getLastISOError().function);
+}
+
+TEST_F(ISOError, ReportsUnknownMessageID) {
+	message[16] = 0x34;
+	message[17] = 0x12;
+	EXPECT_EQ(MESSAGE_ID_INVALID, getISOMessageType(message, static_cast<size_t>(length), false));
+	ISOErrorType error = getLastISOError();
+	EXPECT_EQ(MESSAGE_TYPE_ERROR, error.code);
+	EXPECT_EQ(0x1234, error.messageID);
+	EXPECT_EQ(16u, error.offset);
+}
+
+TEST_F(ISOError, LastErrorIsPerThread) {
+	corruptValueID();
+	std::thread([this]() {
+		EXPECT_LT(decode(), 0);
+		EXPECT_EQ(MESSAGE_VALUE_ID_ERROR, getLastISOError().code);
+	}).join();
+	EXPECT_EQ(MESSAGE_OK, getLastISOError().code);
+}
+
+TEST_F(ISOError, CallsCallbackWithFormattedMessage) {
+	ReportedErrors reported;
+	setISOErrorCallback(collectError, &reported, 0);
+	EXPECT_GT(decode(), 0);
+	EXPECT_TRUE(reported.errors.empty());
+
+	corruptValueID();
+	EXPECT_LT(decode(), 0);
+	ASSERT_EQ(1u, reported.errors.size());
+	EXPECT_EQ(MESSAGE_VALUE_ID_ERROR, reported.errors[0].code);
+	EXPECT_FALSE(reported.messages[0].empty());
+	EXPECT_EQ(std::string::npos, reported.messages[0].find('\n'));
+}
+
+TEST_F(ISOError, RateLimitsCallback) {
+	ReportedErrors reported;
+	setISOErrorCallback(collectError, &reported, 10);
+	corruptValueID();
+	for (int i = 0; i < 1000; ++i) {
+		EXPECT_LT(decode(), 0);
+	}
+	// At most one window change during the loop
+	EXPECT_GE(reported.errors.size(), 10u);
+	EXPECT_LE(reported.errors.size(), 20u);
+	EXPECT_EQ(1000u, reported.errors.size() + getSuppressedISOErrorCount());
+	EXPECT_EQ(MESSAGE_VALUE_ID_ERROR, getLastISOError().code);
+
+	setISOErrorCallback(nullptr, nullptr, 0);
+	EXPECT_LT(decode(), 0);
+	EXPECT_EQ(0u, getSuppressedISOErrorCount());
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+extern "C" {
+#include "linkhealth.h"
+}
+#include "testdefines.h"
+
+class LinkHealth : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		ASSERT_EQ(0, initLinkHealthTable(&table, storage, 16));
+		memset(&header, 0, sizeof(header));
+		header.transmitterID = TEST_TRANSMITTER_ID_1;
+		rxTime.tv_sec = 1651198942;
+		rxTime.tv_usec = 0;
+	}
+	const LinkHealthType* receive(uint8_t counter, long intervalUs = 10000) {
+		header.messageCounter = counter;
+		rxTime.tv_usec += intervalUs;
+		rxTime.tv_sec += rxTime.tv_usec / 1000000;
+		rxTime.tv_usec %= 1000000;
+		return updateLinkHealth(&table, &header, &rxTime);
+	}
+	LinkHealthType storage[16];
+	LinkHealthTableType table;
+	HeaderType header;
+	struct timeval rxTime;
+};
+
+TEST_F(LinkHealth, RejectsNonPowerOfTwoCapacity) {
+	LinkHealthTableType other;
+	EXPECT_EQ(-1, initLinkHealthTable(&other, storage, 12));
+}
+
+TEST_F(LinkHealth, InOrderWithWrap) {
+	const LinkHealthType* link = nullptr;
+	for (int i = 0; i < 600; ++i) {
+		link = receive(static_cast<uint8_t>(i));
+	}
+	ASSERT_NE(nullptr, link);
+	EXPECT_EQ(600u, link->received);
+	EXPECT_EQ(0u, link->lost);
+	EXPECT_EQ(0u, link->duplicated);
+	EXPECT_EQ(0u, link->reordered);
+	EXPECT_NEAR(0.0, link->jitter_us, 1e-9);
+}
+
+TEST_F(LinkHealth, LossAcrossWrap) {
+	receive(253);
+	receive(254);
+	const LinkHealthType* link = receive(2);	// 255, 0 and 1 lost
+	EXPECT_EQ(3u, link->lost);
+	EXPECT_EQ(3u, link->received);
+	EXPECT_NEAR(0.5, getLinkLossRatio(link), 1e-9);
+}
+
+TEST_F(LinkHealth, Duplicate) {
+	receive(10);
+	receive(11);
+	receive(12);
+	const LinkHealthType* link = receive(12);
+	EXPECT_EQ(1u, link->duplicated);
+	link = receive(11);
+	EXPECT_EQ(2u, link->duplicated);
+	EXPECT_EQ(3u, link->received);
+}
+
+TEST_F(LinkHealth, Reordered) {
+	receive(10);
+	receive(12);
+	const LinkHealthType* link = receive(11);
+	EXPECT_EQ(1u, link->reordered);
+	EXPECT_EQ(0u, link->lost);
+	EXPECT_EQ(3u, link->received);
+	link = receive(11);
+	EXPECT_EQ(1u, link->duplicated);
+}
+
+TEST_F(LinkHealth, SeparateTransmitters) {
+	receive(0);
+	receive(1);
+	header.transmitterID = TEST_TRANSMITTER_ID_2;
+	receive(100);
+	EXPECT_EQ(2u, table.nEntries);
+	const LinkHealthType* link = getLinkHealth(&table, TEST_TRANSMITTER_ID_1);
+	ASSERT_NE(nullptr, link);
+	EXPECT_EQ(2u, link->received);
+	EXPECT_EQ(nullptr, getLinkHealth(&table, TEST_HEADER_TRANSMITTER_ID));
+}
+
+TEST_F(LinkHealth, JitterQuantiles) {
+	// Alternate between 9 ms and 11 ms inter-arrival times, giving a constant 2 ms deviation
+	for (int i = 0; i < 1000; ++i) {
+		receive(static_cast<uint8_t>(i), i % 2 ? 9000 : 11000);
+	}
+	const LinkHealthType* link = getLinkHealth(&table, TEST_TRANSMITTER_ID_1);
+	ASSERT_NE(nullptr, link);
+	EXPECT_NEAR(2000.0, getQuantileEstimate(&link->jitterMedian), 1.0);
+	EXPECT_NEAR(2000.0, getQuantileEstimate(&link->jitterP99), 1.0);
+	EXPECT_NEAR(2000.0, link->jitter_us, 1.0);
+	EXPECT_NEAR(9000.0, link->minInterArrival_us, 1.0);
+	EXPECT_NEAR(11000.0, link->maxInterArrival_us, 1.0);
+}
+
+TEST(QuantileEstimator, Uniform) {
+	QuantileEstimatorType median, p95;
+	initQuantileEstimator(&median, 0.5);
+	initQuantileEstimator(&p95, 0.95);
+	for (int i = 0; i < 10000; ++i) {
+		double sample = static_cast<double>((i * 7919) % 10000);
+		updateQuantileEstimator(&median, sample);
+		updateQuantileEstimator(&p95, sample);
+	}
+	EXPECT_NEAR(5000.0, getQuantileEstimate(&median), 200.0);
+	EXPECT_NEAR(9500.0, getQuantileEstimate(&p95), 200.0);
+}
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <vector>
+#include <unistd.h>
+extern "C" {
+#include "monitorrecording.h"
+}
+#include "testdefines.h"
+
+class MonitorRecording : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		snprintf(path, sizeof(path), "/tmp/monitorrecording_%d.rec", getpid());
+	}
+	void TearDown() override {
+		unlink(path);
+	}
+	static MonitorSampleType makeSample(int i) {
+		MonitorSampleType sample;
+		memset(&sample, 0, sizeof(sample));
+		sample.gpsWeek = 2207;
+		sample.gpsQmsOfWeek = 1000000 + 40 * static_cast<uint32_t>(i);
+		sample.isTimestampValid = i % 97 != 5;
+		if (!sample.isTimestampValid) {
+			sample.gpsWeek = GPS_WEEK_UNAVAILABLE_VALUE;
+			sample.gpsQmsOfWeek = GPS_SECOND_OF_WEEK_UNAVAILABLE_VALUE;
+		}
+		sample.xPosition = 1000 * i;
+		sample.yPosition = -37 * i;
+		sample.zPosition = 12;
+		sample.yaw = static_cast<uint16_t>((i * 7) % 36000);
+		sample.longitudinalSpeed = static_cast<int16_t>(i % 500);
+		sample.lateralAcc = -3;
+		sample.state = OBJECT_STATE_RUNNING;
+		sample.drivingDirection = OBJECT_DRIVE_DIRECTION_FORWARD;
+		sample.errorStatus = i == 10 ? 0x80 : 0;
+		sample.isXcoordValid = sample.isYcoordValid = sample.isPositionValid = true;
+		sample.isLateralAccValid = true;
+		return sample;
+	}
+	void record(int nSamples) {
+		MonitorRecorderConfigType config = { 1024, 100 };
+		MonitorRecorderType* recorder = openMonitorRecorder(path, &config);
+		ASSERT_NE(nullptr, recorder);
+		std::vector<MonitorRecordType> batch;
+		for (int i = 0; i < nSamples; ++i) {
+			batch.push_back({ TEST_TRANSMITTER_ID_1, makeSample(i) });
+			batch.push_back({ TEST_TRANSMITTER_ID_2, makeSample(2 * i) });
+			if (batch.size() == 64) {
+				submitAll(recorder, batch);
+			}
+		}
+		submitAll(recorder, batch);
+		MonitorRecorderStatisticsType statistics;
+		getMonitorRecorderStatistics(recorder, &statistics);
+		EXPECT_EQ(2u * static_cast<uint64_t>(nSamples), statistics.submitted);
+		EXPECT_EQ(0, statistics.writeError);
+		EXPECT_EQ(0, closeMonitorRecorder(recorder));
+	}
+	static void submitAll(MonitorRecorderType* recorder, std::vector<MonitorRecordType>& batch) {
+		size_t submitted = 0;
+		while (submitted < batch.size()) {
+			ssize_t n = submitMonitorRecords(recorder, batch.data() + submitted, batch.size() - submitted);
+			if (n < 0) {
+				ASSERT_EQ(EAGAIN, errno);
+				usleep(1000);
+				continue;
+			}
+			submitted += static_cast<size_t>(n);
+		}
+		batch.clear();
+	}
+	char path[64];
+};
+
+TEST_F(MonitorRecording, RoundTrip) {
+	record(1050);
+	MonitorRecordingType recording;
+	ASSERT_EQ(0, openMonitorRecording(path, &recording));
+	EXPECT_FALSE(recording.isIndexRebuilt);
+	EXPECT_EQ(22u, recording.nBlocks);
+
+	std::vector<MonitorSampleType> samples(100);
+	int i = 0;
+	for (size_t b = 0; b < recording.nBlocks; ++b) {
+		if (recording.blocks[b].transmitterID != TEST_TRANSMITTER_ID_1) {
+			continue;
+		}
+		ssize_t n = decodeMonitorRecordingBlock(&recording, b, samples.data(), samples.size());
+		ASSERT_GT(n, 0);
+		for (ssize_t s = 0; s < n; ++s, ++i) {
+			MonitorSampleType expected = makeSample(i);
+			ASSERT_EQ(0, memcmp(&expected, &samples[s], sizeof(expected))) << "sample " << i;
+		}
+	}
+	EXPECT_EQ(1050, i);
+	closeMonitorRecording(&recording);
+}
+
+TEST_F(MonitorRecording, IsSmallerThanRawSamples) {
+	record(1000);
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	EXPECT_LT(static_cast<size_t>(file.tellg()), 2000 * sizeof(MonitorSampleType) / 2);
+}
+
+TEST_F(MonitorRecording, SeekAndColumn) {
+	record(1000);
+	MonitorRecordingType recording;
+	ASSERT_EQ(0, openMonitorRecording(path, &recording));
+
+	MonitorSampleType sample = makeSample(450);
+	ssize_t b = findMonitorRecordingBlock(&recording, TEST_TRANSMITTER_ID_1, getMonitorSampleGPSQms(&sample));
+	ASSERT_GE(b, 0);
+	EXPECT_LE(recording.blocks[b].firstGPSQms, getMonitorSampleGPSQms(&sample));
+	EXPECT_GE(recording.blocks[b].lastGPSQms, getMonitorSampleGPSQms(&sample));
+
+	int64_t x[100];
+	ASSERT_EQ(100, decodeMonitorRecordingColumn(&recording, static_cast<size_t>(b),
+												MONITOR_RECORDING_COLUMN_X, x, 100));
+	EXPECT_EQ(400000, x[0]);
+	EXPECT_EQ(450000, x[50]);
+
+	EXPECT_EQ(-1, findMonitorRecordingBlock(&recording, TEST_HEADER_TRANSMITTER_ID, 0));
+	closeMonitorRecording(&recording);
+}
+
+TEST_F(MonitorRecording, RebuildsIndexOfTruncatedFile) {
+	record(1000);
+	// Cut off the index and part of the last block, as if the writer was interrupted
+	std::ifstream file(path, std::ios::binary | std::ios::ate);
+	auto size = file.tellg();
+	file.close();
+	ASSERT_EQ(0, truncate(path, static_cast<off_t>(size) - 20 * 32 - 16 - 10));
+
+	MonitorRecordingType recording;
+	ASSERT_EQ(0, openMonitorRecording(path, &recording));
+	EXPECT_TRUE(recording.isIndexRebuilt);
+	EXPECT_EQ(19u, recording.nBlocks);
+	closeMonitorRecording(&recording);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+extern "C" {
+#include "monr.h"
+#include "monitorsample.h"
+}
+
+class MonitorSample : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		memset(&monitor, 0, sizeof(monitor));
+		// Friday, April 29, 2022 2:22:22 AM
+		monitor.timestamp.tv_sec = 1651198942;
+		monitor.timestamp.tv_usec = 250000;
+		monitor.isTimestampValid = true;
+		monitor.position.xCoord_m = 1.234;
+		monitor.position.yCoord_m = -2.0;
+		monitor.position.zCoord_m = 3.0;
+		monitor.position.heading_rad = 0.4;
+		monitor.position.isXcoordValid = true;
+		monitor.position.isYcoordValid = true;
+		monitor.position.isZcoordValid = true;
+		monitor.position.isPositionValid = true;
+		monitor.position.isHeadingValid = true;
+		monitor.speed.longitudinal_m_s = 1.0;
+		monitor.speed.lateral_m_s = 2.0;
+		monitor.speed.isLongitudinalValid = true;
+		monitor.speed.isLateralValid = true;
+		monitor.acceleration.longitudinal_m_s2 = -1.5;
+		monitor.acceleration.isLongitudinalValid = true;
+		monitor.drivingDirection = OBJECT_DRIVE_DIRECTION_FORWARD;
+		monitor.state = OBJECT_STATE_RUNNING;
+		monitor.armReadiness = OBJECT_READY_TO_ARM;
+		monitor.error.engineFault = true;
+	}
+	ObjectMonitorType monitor;
+};
+
+TEST_F(MonitorSample, Size) {
+	EXPECT_LE(sizeof(MonitorSampleType), 40u);
+}
+
+TEST_F(MonitorSample, RoundTrip) {
+	MonitorSampleType sample;
+	ObjectMonitorType result;
+	convertObjectMonitorToSamples(&monitor, &sample, 1);
+	convertSamplesToObjectMonitor(&sample, &result, 1);
+
+	EXPECT_TRUE(result.isTimestampValid);
+	EXPECT_EQ(monitor.timestamp.tv_sec, result.timestamp.tv_sec);
+	EXPECT_EQ(monitor.timestamp.tv_usec, result.timestamp.tv_usec);
+	EXPECT_EQ(1234, sample.xPosition);
+	EXPECT_NEAR(monitor.position.xCoord_m, result.position.xCoord_m, 1e-9);
+	EXPECT_NEAR(monitor.position.yCoord_m, result.position.yCoord_m, 1e-9);
+	EXPECT_NEAR(monitor.position.heading_rad, result.position.heading_rad, 1e-3);
+	EXPECT_NEAR(monitor.speed.lateral_m_s, result.speed.lateral_m_s, 1e-9);
+	EXPECT_NEAR(monitor.acceleration.longitudinal_m_s2, result.acceleration.longitudinal_m_s2, 1e-9);
+	EXPECT_FALSE(result.acceleration.isLateralValid);
+	EXPECT_EQ(OBJECT_STATE_RUNNING, result.state);
+	EXPECT_EQ(OBJECT_DRIVE_DIRECTION_FORWARD, result.drivingDirection);
+	EXPECT_EQ(OBJECT_READY_TO_ARM, result.armReadiness);
+	EXPECT_TRUE(result.error.engineFault);
+	EXPECT_FALSE(result.error.abortRequest);
+}
+
+TEST_F(MonitorSample, NegativeHeadingIsWrapped) {
+	MonitorSampleType sample;
+	monitor.position.heading_rad = -M_PI / 2.0;
+	convertObjectMonitorToSamples(&monitor, &sample, 1);
+	EXPECT_EQ(27000, sample.yaw);
+}
+
+TEST_F(MonitorSample, DecodeFromMONR) {
+	char buffer[1024];
+	MessageHeaderType inputHeader;
+	MonitorSampleType sample;
+	ObjectMonitorType expected;
+	memset(&inputHeader, 0, sizeof(inputHeader));
+
+	auto encoded = encodeMONRMessage(&inputHeader, &monitor.timestamp, monitor.position, monitor.speed,
+									 monitor.acceleration, monitor.drivingDirection, monitor.state,
+									 monitor.armReadiness, 0, 0, buffer, sizeof(buffer), false);
+	ASSERT_GT(encoded, 0);
+
+	auto decoded = decodeMONRMessageToSample(buffer, static_cast<size_t>(encoded), monitor.timestamp,
+											 &sample, false);
+	ASSERT_EQ(encoded, decoded);
+	EXPECT_TRUE(sample.isTimestampValid);
+	EXPECT_EQ(1234, sample.xPosition);
+	EXPECT_EQ(-2000, sample.yPosition);
+	EXPECT_EQ(100, sample.longitudinalSpeed);
+	EXPECT_EQ(OBJECT_STATE_RUNNING, getMonitorSampleState(&sample));
+
+	ASSERT_GT(decodeMONRMessage(buffer, static_cast<size_t>(encoded), monitor.timestamp, &expected, false), 0);
+	struct timeval sampleTime;
+	ASSERT_GE(getMonitorSampleTimestamp(&sample, &sampleTime), 0);
+	EXPECT_EQ(expected.timestamp.tv_sec, sampleTime.tv_sec);
+	EXPECT_EQ(expected.timestamp.tv_usec, sampleTime.tv_usec);
+}
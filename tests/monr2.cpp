@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "monr2.h"
+#include "codeccontext.h"
+}
+#include "testdefines.h"
+
+class MONR2 : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		data.isTimestampValid = true;
+		data.timestamp = { 1651198942, 500000 };
+		data.pitch_rad = 0.05;
+		data.isPitchValid = true;
+		data.roll_rad = -0.02;
+		data.isRollValid = true;
+		data.verticalSpeed_m_s = -0.25;
+		data.isVerticalSpeedValid = true;
+		data.yawRate_rad_s = 0.3;
+		data.isYawRateValid = true;
+		data.positionAccuracy_m = 0.03;
+		data.isPositionAccuracyValid = true;
+	}
+
+	std::vector<char> encode(const ObjectMonitor2Type& monitorData) {
+		MessageHeaderType header = { TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, TEST_DEFAULT_MESSAGE_COUNTER };
+		std::vector<char> buffer(getEncodedSizeMONR2Message());
+		EXPECT_EQ(static_cast<ssize_t>(buffer.size()),
+				  encodeMONR2Message(&header, &monitorData, buffer.data(), buffer.size(), false));
+		return buffer;
+	}
+
+	static constexpr struct timeval CurrentTime = { 1651198943, 0 };
+	ObjectMonitor2Type data = {};
+};
+
+TEST_F(MONR2, EncodesStructInISOUnits) {
+	const std::vector<char> buffer = encode(data);
+	ASSERT_EQ(sizeof (MONR2Type), buffer.size());
+
+	MONR2ViewType view;
+	ASSERT_EQ(static_cast<ssize_t>(buffer.size()), viewMONR2Message(buffer.data(), buffer.size(), &view));
+	EXPECT_EQ(MESSAGE_ID_MONR2, view.header.messageID);
+	EXPECT_EQ(TEST_TRANSMITTER_ID_1, view.header.transmitterID);
+	EXPECT_EQ(286, getMONR2ViewPitch(&view));
+	EXPECT_EQ(-114, getMONR2ViewRoll(&view));
+	EXPECT_EQ(-25, getMONR2ViewVerticalSpeed(&view));
+	EXPECT_EQ(ACCELERATION_UNAVAILABLE_VALUE, getMONR2ViewVerticalAcc(&view));
+	EXPECT_EQ(1718, getMONR2ViewYawRate(&view));
+	EXPECT_EQ(ANGULAR_RATE_UNAVAILABLE_VALUE, getMONR2ViewRollRate(&view));
+	EXPECT_EQ(3, getMONR2ViewPositionAccuracy(&view));
+	EXPECT_EQ(reinterpret_cast<const uint8_t*>(buffer.data()), view.message);
+}
+
+TEST_F(MONR2, RoundTrip) {
+	const std::vector<char> buffer = encode(data);
+	ObjectMonitor2Type decoded;
+	ASSERT_EQ(static_cast<ssize_t>(buffer.size()),
+			  decodeMONR2Message(buffer.data(), buffer.size(), CurrentTime, &decoded, false));
+
+	EXPECT_TRUE(decoded.isTimestampValid);
+	EXPECT_EQ(data.timestamp.tv_sec, decoded.timestamp.tv_sec);
+	EXPECT_EQ(data.timestamp.tv_usec, decoded.timestamp.tv_usec);
+	EXPECT_NEAR(data.pitch_rad, decoded.pitch_rad, 0.01 * M_PI / 180.0);
+	EXPECT_NEAR(data.roll_rad, decoded.roll_rad, 0.01 * M_PI / 180.0);
+	EXPECT_DOUBLE_EQ(-0.25, decoded.verticalSpeed_m_s);
+	EXPECT_NEAR(data.yawRate_rad_s, decoded.yawRate_rad_s, 0.01 * M_PI / 180.0);
+	EXPECT_NEAR(0.03, decoded.positionAccuracy_m, 0.01);
+	EXPECT_TRUE(decoded.isPitchValid && decoded.isRollValid && decoded.isVerticalSpeedValid);
+	EXPECT_TRUE(decoded.isYawRateValid && decoded.isPositionAccuracyValid);
+	EXPECT_FALSE(decoded.isVerticalAccValid || decoded.isPitchRateValid || decoded.isRollRateValid);
+}
+
+TEST_F(MONR2, RejectsInvalidMessages) {
+	std::vector<char> buffer = encode(data);
+	ObjectMonitor2Type decoded;
+	MONR2ViewType view;
+
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR, decodeMONR2Message(buffer.data(), buffer.size() - 1, CurrentTime, &decoded, false));
+	buffer[offsetof(MONR2Type, pitch)] ^= 1;
+	EXPECT_EQ(MESSAGE_CRC_ERROR, decodeMONR2Message(buffer.data(), buffer.size(), CurrentTime, &decoded, false));
+	EXPECT_EQ(MESSAGE_CRC_ERROR, viewMONR2Message(buffer.data(), buffer.size(), &view));
+	EXPECT_EQ(nullptr, view.message);
+
+	// Without CRC verification, the content header is still checked
+	ISOCodecContextType* context = createISOCodecContext();
+	ASSERT_NE(nullptr, context);
+	setCodecCRCVerification(context, false);
+	buffer[offsetof(MONR2Type, monr2StructValueID)] = 0x0F;
+	EXPECT_EQ(MESSAGE_VALUE_ID_ERROR, decodeMONR2MessageCtx(context, buffer.data(), buffer.size(), CurrentTime,
+															&decoded));
+	freeISOCodecContext(context);
+
+	MessageHeaderType header = { TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, TEST_DEFAULT_MESSAGE_COUNTER };
+	EXPECT_EQ(-1, encodeMONR2Message(&header, &data, buffer.data(), buffer.size() - 1, false));
+}
+
+TEST_F(MONR2, BatchMatchesSingleMessageDecoder) {
+	std::vector<std::vector<char>> messages;
+	for (int i = 0; i < 40; ++i) {
+		data.timestamp.tv_usec = i * 10000;
+		data.verticalSpeed_m_s = i * 0.5;
+		messages.push_back(encode(data));
+	}
+	messages[3][0] = 0;
+	messages[37].resize(20);
+	std::vector<const void*> frames;
+	std::vector<size_t> lengths;
+	for (const auto& message : messages) {
+		frames.push_back(message.data());
+		lengths.push_back(message.size());
+	}
+
+	std::vector<ObjectMonitor2Type> decoded(messages.size());
+	std::vector<ssize_t> results(messages.size());
+	ASSERT_EQ(messages.size() - 2, decodeMONR2Messages(frames.data(), lengths.data(), frames.size(), CurrentTime,
+													   decoded.data(), results.data()));
+	for (size_t i = 0; i < messages.size(); ++i) {
+		ObjectMonitor2Type expected;
+		EXPECT_EQ(decodeMONR2Message(messages[i].data(), messages[i].size(), CurrentTime, &expected, false),
+				  results[i]) << "frame " << i;
+		EXPECT_EQ(expected.isTimestampValid, decoded[i].isTimestampValid);
+		EXPECT_EQ(expected.timestamp.tv_usec, decoded[i].timestamp.tv_usec);
+		EXPECT_EQ(expected.verticalSpeed_m_s, decoded[i].verticalSpeed_m_s);
+	}
+	EXPECT_EQ(MESSAGE_SYNC_WORD_ERROR, results[3]);
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR, results[37]);
+}
@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+extern "C" {
+#include "peertable.h"
+#include "iso22133.h"
+#include "header.h"
+}
+#include "testdefines.h"
+
+typedef std::vector<char> Bytes;
+
+class PeerTable : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		table = createPeerTable(2);
+		ASSERT_NE(nullptr, table);
+	}
+	void TearDown() override {
+		freePeerTable(table);
+	}
+
+	static PeerObjectInjectionType makePeer(const uint32_t id, const double x, const suseconds_t usec) {
+		PeerObjectInjectionType peer = {};
+		peer.foreignTransmitterID = id;
+		peer.dataTimestamp = { 1651198942, usec };
+		peer.state = OBJECT_STATE_RUNNING;
+		peer.position.xCoord_m = x;
+		peer.position.yCoord_m = -2.5;
+		peer.position.zCoord_m = 0.25;
+		peer.position.isPositionValid = peer.position.isXcoordValid = peer.position.isYcoordValid = true;
+		peer.position.isZcoordValid = true;
+		peer.position.heading_rad = 1.25;
+		peer.position.isHeadingValid = true;
+		peer.speed.isLongitudinalValid = peer.speed.isLateralValid = true;
+		return peer;
+	}
+
+	static Bytes encode(const PeerObjectInjectionType& peer) {
+		MessageHeaderType header = { TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, TEST_DEFAULT_MESSAGE_COUNTER };
+		Bytes message(256);
+		const ssize_t length = encodePODIMessage(&header, &peer, message.data(), message.size(), false);
+		message.resize(length > 0 ? static_cast<size_t>(length) : 0);
+		return message;
+	}
+
+	size_t decode(const std::vector<Bytes>& messages, std::vector<ssize_t>& results) {
+		std::vector<const void*> frames;
+		std::vector<size_t> lengths;
+		for (const auto& message : messages) {
+			frames.push_back(message.data());
+			lengths.push_back(message.size());
+		}
+		results.resize(messages.size());
+		return decodePODIMessages(table, frames.data(), lengths.data(), messages.size(), CurrentTime,
+								  results.data());
+	}
+
+	static constexpr struct timeval CurrentTime = { 1651198943, 0 };
+	PeerTableType* table;
+};
+
+TEST_F(PeerTable, MatchesSingleMessageDecoder) {
+	std::vector<Bytes> messages;
+	for (uint32_t id : { 7u, 3u, 5u }) {
+		messages.push_back(encode(makePeer(id, id * 1.5, 250000)));
+		ASSERT_FALSE(messages.back().empty());
+	}
+	std::vector<ssize_t> results;
+	ASSERT_EQ(3u, decode(messages, results));
+
+	const PeerTableSnapshotType snapshot = getPeerTableSnapshot(table);
+	ASSERT_EQ(3u, snapshot.nPeers);
+	EXPECT_EQ(3u, snapshot.foreignTransmitterID[0]);
+	EXPECT_EQ(5u, snapshot.foreignTransmitterID[1]);
+	EXPECT_EQ(7u, snapshot.foreignTransmitterID[2]);
+
+	for (size_t i = 0; i < messages.size(); ++i) {
+		EXPECT_EQ(static_cast<ssize_t>(messages[i].size()), results[i]);
+		PeerObjectInjectionType expected, actual;
+		ASSERT_EQ(results[i], decodePODIMessage(messages[i].data(), messages[i].size(), CurrentTime, &expected, false));
+		const ssize_t index = findPeerTableIndex(table, expected.foreignTransmitterID);
+		ASSERT_GE(index, 0);
+		ASSERT_EQ(0, getPeerTableEntry(table, static_cast<size_t>(index), &actual));
+		EXPECT_EQ(expected.foreignTransmitterID, actual.foreignTransmitterID);
+		EXPECT_EQ(expected.dataTimestamp.tv_sec, actual.dataTimestamp.tv_sec);
+		EXPECT_EQ(expected.dataTimestamp.tv_usec, actual.dataTimestamp.tv_usec);
+		EXPECT_EQ(expected.state, actual.state);
+		EXPECT_EQ(expected.position.isPositionValid, actual.position.isPositionValid);
+		EXPECT_DOUBLE_EQ(expected.position.xCoord_m, actual.position.xCoord_m);
+		EXPECT_DOUBLE_EQ(expected.position.yCoord_m, actual.position.yCoord_m);
+		EXPECT_DOUBLE_EQ(expected.position.zCoord_m, actual.position.zCoord_m);
+		EXPECT_EQ(expected.position.isHeadingValid, actual.position.isHeadingValid);
+		EXPECT_DOUBLE_EQ(expected.position.heading_rad, actual.position.heading_rad);
+	}
+	EXPECT_EQ(-1, findPeerTableIndex(table, 4));
+	PeerObjectInjectionType peer;
+	EXPECT_EQ(-1, getPeerTableEntry(table, 3, &peer));
+}
+
+TEST_F(PeerTable, KeepsPitchRollAndSpeed) {
+	PeerObjectInjectionType moving = makePeer(4, 1.0, 0);
+	moving.pitch_rad = 0.05;
+	moving.roll_rad = 0.125;
+	moving.isPitchValid = moving.isRollValid = true;
+	moving.speed.longitudinal_m_s = 8.25;
+	moving.speed.lateral_m_s = -0.5;
+	PeerObjectInjectionType still = makePeer(2, 1.0, 0);
+	still.speed.isLateralValid = false;
+	std::vector<Bytes> messages = { encode(moving), encode(still) };
+	// Swap the pitch and roll fields, so that the message is parsed field by field
+	const size_t pitchOffset = sizeof (HeaderType) + 51, fieldSize = 6;
+	std::swap_ranges(messages[0].begin() + pitchOffset, messages[0].begin() + pitchOffset + fieldSize,
+					 messages[0].begin() + pitchOffset + fieldSize);
+	std::vector<ssize_t> results;
+	ASSERT_EQ(2u, decode(messages, results));
+
+	const PeerTableSnapshotType snapshot = getPeerTableSnapshot(table);
+	ASSERT_EQ(2u, snapshot.nPeers);
+	EXPECT_FALSE(snapshot.isPitchValid[0]);
+	EXPECT_FALSE(snapshot.isRollValid[0]);
+	EXPECT_TRUE(snapshot.isLongitudinalSpeedValid[0]);
+	EXPECT_DOUBLE_EQ(0.0, snapshot.longitudinalSpeed_m_s[0]);
+	EXPECT_FALSE(snapshot.isLateralSpeedValid[0]);
+	EXPECT_TRUE(snapshot.isPitchValid[1]);
+	EXPECT_NEAR(0.05, snapshot.pitch_rad[1], 1e-3);
+	EXPECT_TRUE(snapshot.isRollValid[1]);
+	EXPECT_NEAR(0.125, snapshot.roll_rad[1], 1e-3);
+	EXPECT_NEAR(8.25, snapshot.longitudinalSpeed_m_s[1], 1e-9);
+	EXPECT_NEAR(-0.5, snapshot.lateralSpeed_m_s[1], 1e-9);
+
+	PeerObjectInjectionType peer;
+	ASSERT_EQ(0, getPeerTableEntry(table, 1, &peer));
+	EXPECT_TRUE(peer.isPitchValid);
+	EXPECT_DOUBLE_EQ(snapshot.pitch_rad[1], peer.pitch_rad);
+	EXPECT_TRUE(peer.isRollValid);
+	EXPECT_DOUBLE_EQ(snapshot.roll_rad[1], peer.roll_rad);
+	EXPECT_TRUE(peer.speed.isLongitudinalValid);
+	EXPECT_DOUBLE_EQ(8.25, peer.speed.longitudinal_m_s);
+	EXPECT_TRUE(peer.speed.isLateralValid);
+	EXPECT_DOUBLE_EQ(-0.5, peer.speed.lateral_m_s);
+}
+
+TEST_F(PeerTable, DecodesFieldsInAnyOrder) {
+	PeerObjectInjectionType peer = makePeer(9, 12.5, 0);
+	std::vector<Bytes> messages = { encode(peer) };
+	// Swap the x and y position fields, which have the same size
+	const size_t xOffset = sizeof (HeaderType) + 21, fieldSize = 8;
+	std::swap_ranges(messages[0].begin() + xOffset, messages[0].begin() + xOffset + fieldSize,
+					 messages[0].begin() + xOffset + fieldSize);
+	std::vector<ssize_t> results;
+	ASSERT_EQ(1u, decode(messages, results));
+	const PeerTableSnapshotType snapshot = getPeerTableSnapshot(table);
+	ASSERT_EQ(1u, snapshot.nPeers);
+	EXPECT_DOUBLE_EQ(12.5, snapshot.xCoord_m[0]);
+	EXPECT_DOUBLE_EQ(-2.5, snapshot.yCoord_m[0]);
+	EXPECT_EQ(OBJECT_STATE_RUNNING, snapshot.state[0]);
+}
+
+TEST_F(PeerTable, KeepsNewestSamplePerPeer) {
+	const std::vector<Bytes> messages = {
+		encode(makePeer(1, 2.0, 500000)),
+		encode(makePeer(1, 1.0, 250000)),
+		encode(makePeer(2, 5.0, 0)),
+		encode(makePeer(2, 6.0, 750000)),
+	};
+	std::vector<ssize_t> results;
+	ASSERT_EQ(4u, decode(messages, results));
+
+	const PeerTableSnapshotType snapshot = getPeerTableSnapshot(table);
+	ASSERT_EQ(2u, snapshot.nPeers);
+	EXPECT_DOUBLE_EQ(2.0, snapshot.xCoord_m[0]);
+	EXPECT_DOUBLE_EQ(6.0, snapshot.xCoord_m[1]);
+	EXPECT_EQ(1000u, snapshot.gpsQms[1] - snapshot.gpsQms[0]);
+
+	const PeerTableStatisticsType statistics = getPeerTableStatistics(table);
+	EXPECT_EQ(3u, statistics.nSamplesApplied);
+	EXPECT_EQ(1u, statistics.nSamplesOutdated);
+	EXPECT_EQ(0u, statistics.nDecodeErrors);
+}
+
+TEST_F(PeerTable, ReportsErrorsPerFrame) {
+	std::vector<Bytes> messages = {
+		encode(makePeer(1, 0.0, 0)),
+		encode(makePeer(2, 0.0, 0)),
+		encode(makePeer(3, 0.0, 0)),
+		encode(makePeer(4, 0.0, 0)),
+	};
+	messages[0].resize(messages[0].size() - 3);
+	messages[1][0] = 0;
+	messages[2][sizeof (HeaderType)] = 0x55;
+	std::vector<ssize_t> results;
+	ASSERT_EQ(1u, decode(messages, results));
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR, results[0]);
+	EXPECT_EQ(MESSAGE_SYNC_WORD_ERROR, results[1]);
+	EXPECT_EQ(MESSAGE_VALUE_ID_ERROR, results[2]);
+	EXPECT_EQ(static_cast<ssize_t>(messages[3].size()), results[3]);
+	EXPECT_EQ(3u, getPeerTableStatistics(table).nDecodeErrors);
+	ASSERT_EQ(1u, getPeerTableSnapshot(table).nPeers);
+	EXPECT_EQ(4u, getPeerTableSnapshot(table).foreignTransmitterID[0]);
+}
+
+TEST_F(PeerTable, RemovesOutdatedPeers) {
+	const std::vector<Bytes> messages = {
+		encode(makePeer(1, 0.0, 0)),
+		encode(makePeer(2, 0.0, 500000)),
+		encode(makePeer(3, 0.0, 250000)),
+	};
+	std::vector<ssize_t> results;
+	ASSERT_EQ(3u, decode(messages, results));
+	const struct timeval oldest = { 1651198942, 250000 };
+	EXPECT_EQ(1u, removeOutdatedPeers(table, &oldest));
+	const PeerTableSnapshotType snapshot = getPeerTableSnapshot(table);
+	ASSERT_EQ(2u, snapshot.nPeers);
+	EXPECT_EQ(2u, snapshot.foreignTransmitterID[0]);
+	EXPECT_EQ(3u, snapshot.foreignTransmitterID[1]);
+}
@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <vector>
+extern "C" {
+#include "podifanout.h"
+#include "frame.h"
+#include "iso22133.h"
+#include "defines.h"
+}
+#include "testdefines.h"
+
+typedef std::vector<char> Bytes;
+
+struct SentDatagrams {
+	std::map<uint32_t, std::vector<Bytes>> datagrams;
+};
+
+static ssize_t collectDatagram(const uint32_t receiverID, const char* datagram, const size_t length, void* userData) {
+	static_cast<SentDatagrams*>(userData)->datagrams[receiverID].emplace_back(datagram, datagram + length);
+	return static_cast<ssize_t>(length);
+}
+
+static ssize_t failingSink(const uint32_t, const char*, const size_t, void*) {
+	return -1;
+}
+
+class PODIFanout : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		fanout = createPODIFanout(TEST_TRANSMITTER_ID_1, 0);
+		ASSERT_NE(nullptr, fanout);
+	}
+	void TearDown() override {
+		freePODIFanout(fanout);
+	}
+
+	static PeerObjectInjectionType makePeer(const uint32_t id, const double x, const double y) {
+		PeerObjectInjectionType peer = {};
+		peer.foreignTransmitterID = id;
+		peer.dataTimestamp = { 1651198942, 250000 };
+		peer.state = OBJECT_STATE_RUNNING;
+		peer.position.xCoord_m = x;
+		peer.position.yCoord_m = y;
+		peer.position.isPositionValid = peer.position.isXcoordValid = peer.position.isYcoordValid = true;
+		peer.position.heading_rad = 0.5;
+		peer.position.isHeadingValid = true;
+		peer.speed.longitudinal_m_s = 5.0;
+		peer.speed.isLongitudinalValid = peer.speed.isLateralValid = true;
+		return peer;
+	}
+
+	static Bytes encodeExpected(const PeerObjectInjectionType& peer, const uint32_t receiverID, const uint8_t counter) {
+		MessageHeaderType header = { TEST_TRANSMITTER_ID_1, receiverID, counter };
+		Bytes message(256);
+		const ssize_t length = encodePODIMessage(&header, &peer, message.data(), message.size(), false);
+		message.resize(length > 0 ? static_cast<size_t>(length) : 0);
+		return message;
+	}
+
+	//! Split a datagram into its messages, checking that each is valid
+	static std::vector<Bytes> splitFrames(const Bytes& datagram) {
+		std::vector<Bytes> frames;
+		size_t offset = 0;
+		while (offset < datagram.size()) {
+			HeaderType header;
+			const ssize_t length = validateISOFrame(datagram.data() + offset, datagram.size() - offset, &header);
+			EXPECT_GT(length, 0);
+			if (length <= 0) {
+				break;
+			}
+			frames.emplace_back(datagram.begin() + static_cast<long>(offset),
+								datagram.begin() + static_cast<long>(offset) + length);
+			offset += static_cast<size_t>(length);
+		}
+		return frames;
+	}
+
+	PODIFanoutType* fanout;
+};
+
+TEST_F(PODIFanout, FramesMatchIndividualEncoding) {
+	std::vector<PeerObjectInjectionType> peers;
+	for (uint32_t id = 1; id <= 4; ++id) {
+		peers.push_back(makePeer(id, id * 10.0, -5.0));
+		ASSERT_EQ(0, updatePODIFanoutPeer(fanout, &peers.back()));
+		ASSERT_EQ(0, addPODIFanoutReceiver(fanout, id, 0.0));
+	}
+
+	for (uint8_t tick = 0; tick < 2; ++tick) {
+		SentDatagrams sent;
+		ASSERT_EQ(12, runPODIFanoutTick(fanout, collectDatagram, &sent));
+		for (uint32_t receiver = 1; receiver <= 4; ++receiver) {
+			ASSERT_EQ(1u, sent.datagrams[receiver].size());
+			const std::vector<Bytes> frames = splitFrames(sent.datagrams[receiver][0]);
+			ASSERT_EQ(3u, frames.size());
+			uint8_t counter = static_cast<uint8_t>(3 * tick);
+			size_t f = 0;
+			for (const auto& peer : peers) {
+				if (peer.foreignTransmitterID == receiver) {
+					continue;
+				}
+				EXPECT_EQ(encodeExpected(peer, receiver, counter++), frames[f++]);
+			}
+		}
+	}
+	const PODIFanoutStatisticsType statistics = getPODIFanoutStatistics(fanout);
+	EXPECT_EQ(2u, statistics.nTicks);
+	EXPECT_EQ(8u, statistics.nPeersEncoded);
+	EXPECT_EQ(24u, statistics.nFramesSent);
+	EXPECT_EQ(8u, statistics.nDatagramsSent);
+}
+
+TEST_F(PODIFanout, CoalescesUpToDatagramSize) {
+	const size_t frameSize = getEncodedSizePODIMessage();
+	freePODIFanout(fanout);
+	fanout = createPODIFanout(TEST_TRANSMITTER_ID_1, 2 * frameSize + 10);
+	ASSERT_NE(nullptr, fanout);
+	EXPECT_EQ(nullptr, createPODIFanout(TEST_TRANSMITTER_ID_1, frameSize - 1));
+
+	for (uint32_t id = 1; id <= 6; ++id) {
+		const PeerObjectInjectionType peer = makePeer(id, 0.0, 0.0);
+		ASSERT_EQ(0, updatePODIFanoutPeer(fanout, &peer));
+	}
+	ASSERT_EQ(0, addPODIFanoutReceiver(fanout, 100, 0.0));
+	SentDatagrams sent;
+	ASSERT_EQ(6, runPODIFanoutTick(fanout, collectDatagram, &sent));
+	ASSERT_EQ(3u, sent.datagrams[100].size());
+	for (const auto& datagram : sent.datagrams[100]) {
+		EXPECT_EQ(2 * frameSize, datagram.size());
+		EXPECT_EQ(2u, splitFrames(datagram).size());
+	}
+	EXPECT_EQ(-1, runPODIFanoutTick(fanout, failingSink, nullptr));
+}
+
+TEST_F(PODIFanout, FiltersOnInterestRadius) {
+	const PeerObjectInjectionType self = makePeer(1, 0.0, 0.0);
+	const PeerObjectInjectionType near = makePeer(2, 30.0, 40.0);
+	const PeerObjectInjectionType far = makePeer(3, 60.0, 80.0);
+	ASSERT_EQ(0, updatePODIFanoutPeer(fanout, &far));
+	ASSERT_EQ(0, updatePODIFanoutPeer(fanout, &self));
+	ASSERT_EQ(0, updatePODIFanoutPeer(fanout, &near));
+	ASSERT_EQ(0, addPODIFanoutReceiver(fanout, 1, 50.0));
+	// Position unknown, so all peers are sent
+	ASSERT_EQ(0, addPODIFanoutReceiver(fanout, 9, 50.0));
+
+	SentDatagrams sent;
+	ASSERT_EQ(4, runPODIFanoutTick(fanout, collectDatagram, &sent));
+	const std::vector<Bytes> frames = splitFrames(sent.datagrams[1].at(0));
+	ASSERT_EQ(1u, frames.size());
+	EXPECT_EQ(encodeExpected(near, 1, 0), frames[0]);
+	EXPECT_EQ(3u, splitFrames(sent.datagrams[9].at(0)).size());
+	EXPECT_EQ(1u, getPODIFanoutStatistics(fanout).nFramesFiltered);
+
+	ASSERT_EQ(0, removePODIFanoutPeer(fanout, 2));
+	ASSERT_EQ(0, removePODIFanoutReceiver(fanout, 9));
+	EXPECT_EQ(-1, removePODIFanoutReceiver(fanout, 9));
+	sent.datagrams.clear();
+	EXPECT_EQ(0, runPODIFanoutTick(fanout, collectDatagram, &sent));
+	EXPECT_TRUE(sent.datagrams.empty());
+}
+
+TEST_F(PODIFanout, SkipsPeersWhichCannotBeEncoded) {
+	PeerObjectInjectionType invalid = makePeer(1, 0.0, 0.0);
+	invalid.position.isPositionValid = false;
+	const PeerObjectInjectionType valid = makePeer(2, 0.0, 0.0);
+	ASSERT_EQ(0, updatePODIFanoutPeer(fanout, &invalid));
+	ASSERT_EQ(0, updatePODIFanoutPeer(fanout, &valid));
+	ASSERT_EQ(0, addPODIFanoutReceiver(fanout, 3, 0.0));
+	SentDatagrams sent;
+	EXPECT_EQ(1, runPODIFanoutTick(fanout, collectDatagram, &sent));
+	EXPECT_EQ(1u, getPODIFanoutStatistics(fanout).nEncodeErrors);
+}
@@ -0,0 +1,185 @@
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+extern "C" {
+#include "relay.h"
+#include "frame.h"
+#include "footer.h"
+#include "iso22133.h"
+#include "defines.h"
+}
+#include "testdefines.h"
+
+typedef std::vector<char> Bytes;
+
+static Bytes encodeMONR(const uint32_t transmitterID, const uint32_t receiverID, const uint8_t counter) {
+	MessageHeaderType header = { transmitterID, receiverID, counter };
+	struct timeval time = { 1651198942, 0 };
+	CartesianPosition position = {};
+	position.isPositionValid = position.isXcoordValid = position.isYcoordValid = true;
+	position.xCoord_m = counter * 0.5;
+	SpeedType speed = {};
+	speed.isLongitudinalValid = true;
+	AccelerationType acceleration = {};
+	Bytes message(256);
+	const ssize_t length = encodeMONRMessage(&header, &time, position, speed, acceleration,
+											 ISO_DRIVE_DIRECTION_FORWARD, ISO_OBJECT_STATE_RUNNING,
+											 ISO_READY_TO_ARM, 0, 0, message.data(), message.size(), false);
+	message.resize(length > 0 ? static_cast<size_t>(length) : 0);
+	return message;
+}
+
+TEST(RelayCRC, PatchMatchesRecalculation) {
+	std::vector<uint8_t> data(500);
+	for (size_t i = 0; i < data.size(); ++i) {
+		data[i] = static_cast<uint8_t>(i * 13 + 5);
+	}
+	const uint16_t crc = crc16(data.data(), data.size());
+	for (size_t offset : { static_cast<size_t>(0), static_cast<size_t>(7), static_cast<size_t>(490) }) {
+		std::vector<uint8_t> patched(data);
+		std::vector<uint8_t> old(data.begin() + static_cast<long>(offset), data.begin() + static_cast<long>(offset) + 10);
+		for (size_t i = 0; i < 10; ++i) {
+			patched[offset + i] ^= static_cast<uint8_t>(0xA5 + i);
+		}
+		EXPECT_EQ(crc16(patched.data(), patched.size()),
+				  crc16Patch(crc, old.data(), patched.data() + offset, 10, data.size() - offset - 10))
+			<< "offset " << offset;
+	}
+}
+
+TEST(RelayRewrite, RewritesIDsAndKeepsCRCValid) {
+	Bytes message = encodeMONR(TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, 3);
+	ASSERT_FALSE(message.empty());
+	const Bytes original(message);
+	ASSERT_EQ(static_cast<ssize_t>(message.size()),
+			  rewriteISOFrameIDs(message.data(), message.size(), RELAY_FIELD_RECEIVER_ID, 0, TEST_RECEIVER_ID_2));
+
+	HeaderType header;
+	ASSERT_EQ(static_cast<ssize_t>(message.size()), validateISOFrame(message.data(), message.size(), &header));
+	EXPECT_EQ(TEST_TRANSMITTER_ID_1, header.transmitterID);
+	EXPECT_EQ(TEST_RECEIVER_ID_2, header.receiverID);
+	EXPECT_EQ(encodeMONR(TEST_TRANSMITTER_ID_1, TEST_RECEIVER_ID_2, 3), message);
+	// Contents are untouched
+	EXPECT_TRUE(std::equal(original.begin() + sizeof(HeaderType), original.end() - sizeof(FooterType),
+						   message.begin() + sizeof(HeaderType)));
+
+	// Corruption survives the rewrite
+	message[sizeof(HeaderType) + 4] ^= 0x01;
+	rewriteISOFrameIDs(message.data(), message.size(), RELAY_FIELD_TRANSMITTER_ID, TEST_TRANSMITTER_ID_2, 0);
+	EXPECT_EQ(MESSAGE_CRC_ERROR, validateISOFrame(message.data(), message.size(), &header));
+}
+
+class Relay : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_DGRAM, 0, input));
+		ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_DGRAM, 0, output));
+		relay = createISORelay(0);
+		ASSERT_NE(nullptr, relay);
+		route = addRelayRoute(relay, input[1], output[0], nullptr, 0);
+		ASSERT_EQ(0, route);
+	}
+	void TearDown() override {
+		freeISORelay(relay);
+		for (int fd : { input[0], input[1], output[0], output[1] }) {
+			close(fd);
+		}
+	}
+
+	void send(const Bytes& datagram) {
+		ASSERT_EQ(static_cast<ssize_t>(datagram.size()), ::send(input[0], datagram.data(), datagram.size(), 0));
+	}
+
+	Bytes receive() {
+		Bytes datagram(4096);
+		const ssize_t length = recv(output[1], datagram.data(), datagram.size(), MSG_DONTWAIT);
+		datagram.resize(length > 0 ? static_cast<size_t>(length) : 0);
+		return datagram;
+	}
+
+	int input[2];
+	int output[2];
+	ISORelayType* relay;
+	int route;
+};
+
+TEST_F(Relay, ForwardsBatchWithRewriteTable) {
+	RelayRewriteType subDevice = {};
+	subDevice.matchedFields = RELAY_FIELD_TRANSMITTER_ID | RELAY_FIELD_RECEIVER_ID;
+	subDevice.transmitterID = TEST_TRANSMITTER_ID_1;
+	subDevice.receiverID = TEST_DEFAULT_RECEIVER_ID;
+	subDevice.rewrittenFields = RELAY_FIELD_TRANSMITTER_ID;
+	subDevice.newTransmitterID = 0x0100;
+	ASSERT_EQ(0, addRelayRewrite(relay, route, &subDevice));
+	RelayRewriteType anyToReceiver = {};
+	anyToReceiver.matchedFields = RELAY_FIELD_RECEIVER_ID;
+	anyToReceiver.receiverID = TEST_DEFAULT_RECEIVER_ID;
+	anyToReceiver.rewrittenFields = RELAY_FIELD_RECEIVER_ID;
+	anyToReceiver.newReceiverID = TEST_RECEIVER_ID_2;
+	ASSERT_EQ(0, addRelayRewrite(relay, route, &anyToReceiver));
+	// Many exact rules, forcing the table to grow
+	for (uint32_t id = 1000; id < 1100; ++id) {
+		subDevice.transmitterID = id;
+		subDevice.newTransmitterID = id + 1;
+		ASSERT_EQ(0, addRelayRewrite(relay, route, &subDevice));
+	}
+
+	send(encodeMONR(TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, 0));
+	send(encodeMONR(TEST_TRANSMITTER_ID_2, TEST_DEFAULT_RECEIVER_ID, 1));
+	send(encodeMONR(1050, TEST_DEFAULT_RECEIVER_ID, 2));
+	send(encodeMONR(TEST_TRANSMITTER_ID_2, TEST_RECEIVER_ID_2, 3));
+	// Two frames in one datagram
+	Bytes combined = encodeMONR(1000, TEST_DEFAULT_RECEIVER_ID, 4);
+	const Bytes second = encodeMONR(TEST_TRANSMITTER_ID_2, TEST_DEFAULT_RECEIVER_ID, 5);
+	combined.insert(combined.end(), second.begin(), second.end());
+	send(combined);
+
+	ASSERT_EQ(5, forwardRelayRoute(relay, route));
+	EXPECT_EQ(encodeMONR(0x0100, TEST_DEFAULT_RECEIVER_ID, 0), receive());
+	EXPECT_EQ(encodeMONR(TEST_TRANSMITTER_ID_2, TEST_RECEIVER_ID_2, 1), receive());
+	EXPECT_EQ(encodeMONR(1051, TEST_DEFAULT_RECEIVER_ID, 2), receive());
+	EXPECT_EQ(encodeMONR(TEST_TRANSMITTER_ID_2, TEST_RECEIVER_ID_2, 3), receive());
+	Bytes expected = encodeMONR(1001, TEST_DEFAULT_RECEIVER_ID, 4);
+	const Bytes expectedSecond = encodeMONR(TEST_TRANSMITTER_ID_2, TEST_RECEIVER_ID_2, 5);
+	expected.insert(expected.end(), expectedSecond.begin(), expectedSecond.end());
+	EXPECT_EQ(expected, receive());
+	EXPECT_TRUE(receive().empty());
+
+	const RelayStatisticsType statistics = getRelayStatistics(relay, route);
+	EXPECT_EQ(5u, statistics.nDatagramsReceived);
+	EXPECT_EQ(5u, statistics.nDatagramsForwarded);
+	EXPECT_EQ(6u, statistics.nFramesForwarded);
+	EXPECT_EQ(5u, statistics.nFramesRewritten);
+	EXPECT_EQ(0, forwardRelayRoute(relay, route));
+}
+
+TEST_F(Relay, DropsMalformedFrames) {
+	Bytes garbage(40, 0x11);
+	send(garbage);
+	Bytes truncated = encodeMONR(TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, 0);
+	truncated.resize(truncated.size() - 3);
+	send(truncated);
+	// Valid frame followed by trailing garbage is forwarded without the garbage
+	Bytes trailing = encodeMONR(TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, 1);
+	const size_t validLength = trailing.size();
+	trailing.insert(trailing.end(), garbage.begin(), garbage.end());
+	send(trailing);
+
+	ASSERT_EQ(1, forwardRelayRoute(relay, route));
+	EXPECT_EQ(validLength, receive().size());
+	const RelayStatisticsType statistics = getRelayStatistics(relay, route);
+	EXPECT_EQ(3u, statistics.nDatagramsReceived);
+	EXPECT_EQ(3u, statistics.nMalformedFrames);
+	EXPECT_EQ(1u, statistics.nFramesForwarded);
+}
+
+TEST_F(Relay, RejectsInvalidConfiguration) {
+	RelayRewriteType rewrite = {};
+	EXPECT_EQ(-1, addRelayRewrite(relay, route + 1, &rewrite));
+	rewrite.matchedFields = 0x80;
+	EXPECT_EQ(-1, addRelayRewrite(relay, route, &rewrite));
+	EXPECT_EQ(-1, addRelayRoute(relay, -1, output[0], nullptr, 0));
+	EXPECT_EQ(-1, forwardRelayRoute(relay, 5));
+}
@@ -0,0 +1,267 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <vector>
+#include <unistd.h>
+extern "C" {
+#include "replay.h"
+#include "iso22133.h"
+#include "defines.h"
+#include "timeconversions.h"
+#include "header.h"
+}
+#include "testdefines.h"
+
+typedef std::vector<uint8_t> Bytes;
+
+struct ReplayedFrame {
+	HeaderType header;
+	ObjectMonitorType monitor;
+};
+
+static ssize_t collectFrame(const char* data, const size_t length, void* userData) {
+	auto frames = static_cast<std::vector<ReplayedFrame>*>(userData);
+	ReplayedFrame frame;
+	struct timeval now = { 1651198942, 0 };
+	if (decodeMONRMessage(data, length, now, &frame.monitor, false) < 0) {
+		ADD_FAILURE() << "replayed message could not be decoded";
+		return -1;
+	}
+	memcpy(&frame.header, data, sizeof(frame.header));
+	frames->push_back(frame);
+	return static_cast<ssize_t>(length);
+}
+
+static ssize_t failingSink(const char*, const size_t, void*) {
+	errno = EPIPE;
+	return -1;
+}
+
+class Replay : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		snprintf(path, sizeof(path), "/tmp/replay_%d", getpid());
+	}
+	void TearDown() override {
+		unlink(path);
+	}
+
+	static void appendLE32(Bytes& b, uint32_t value) {
+		for (int i = 0; i < 4; ++i) {
+			b.push_back(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	}
+
+	//! MONR messages 10 ms apart in a raw IPv4 capture, captured 1 ms after being sent
+	void writeCapture(int nMessages) {
+		Bytes file;
+		appendLE32(file, 0xA1B2C3D4);
+		appendLE32(file, 0x00040002);
+		appendLE32(file, 0);
+		appendLE32(file, 0);
+		appendLE32(file, 65535);
+		appendLE32(file, 228);
+		for (int i = 0; i < nMessages; ++i) {
+			MessageHeaderType header = { TEST_TRANSMITTER_ID_1, 0, static_cast<uint8_t>(i) };
+			struct timeval time = { 1651198942, i * 10000 };
+			CartesianPosition position;
+			memset(&position, 0, sizeof(position));
+			position.isPositionValid = position.isXcoordValid = position.isYcoordValid = true;
+			position.xCoord_m = i;
+			SpeedType speed;
+			memset(&speed, 0, sizeof(speed));
+			speed.isLongitudinalValid = true;
+			AccelerationType acceleration;
+			memset(&acceleration, 0, sizeof(acceleration));
+			char buffer[256];
+			ssize_t length = encodeMONRMessage(&header, &time, position, speed, acceleration,
+											   ISO_DRIVE_DIRECTION_FORWARD, ISO_OBJECT_STATE_RUNNING,
+											   ISO_READY_TO_ARM, 0, 0, buffer, sizeof(buffer), false);
+			ASSERT_GT(length, 0);
+
+			Bytes packet(28, 0);
+			packet[0] = 0x45;
+			packet[2] = static_cast<uint8_t>((28 + length) >> 8);
+			packet[3] = static_cast<uint8_t>(28 + length);
+			packet[9] = 17;
+			packet[24] = static_cast<uint8_t>((8 + length) >> 8);
+			packet[25] = static_cast<uint8_t>(8 + length);
+			packet.insert(packet.end(), buffer, buffer + length);
+
+			appendLE32(file, 1651198942);
+			appendLE32(file, static_cast<uint32_t>(i * 10000 + 1000));
+			appendLE32(file, static_cast<uint32_t>(packet.size()));
+			appendLE32(file, static_cast<uint32_t>(packet.size()));
+			file.insert(file.end(), packet.begin(), packet.end());
+		}
+		std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(file.data()), file.size());
+	}
+
+	static uint32_t getQmsOfWeek(const ReplayedFrame& frame) {
+		return static_cast<uint32_t>(getAsGPSQuarterMillisecondOfWeek(&frame.monitor.timestamp));
+	}
+	char path[64];
+};
+
+TEST_F(Replay, RewritesCaptureTimestamps) {
+	writeCapture(20);
+	CaptureType capture;
+	ASSERT_EQ(0, openCapture(path, &capture));
+
+	ReplayConfigType config;
+	memset(&config, 0, sizeof(config));
+	config.speedFactor = 0;
+	config.isTimestampRewritten = true;
+	config.startTime = { 1700000000, 0 };
+	std::vector<ReplayedFrame> frames;
+	ReplayStatisticsType statistics;
+	ASSERT_EQ(0, replayCapture(&capture, &config, collectFrame, &frames, &statistics));
+	EXPECT_EQ(20u, statistics.nFrames);
+	EXPECT_EQ(20u, statistics.nRewritten);
+	ASSERT_EQ(20u, frames.size());
+
+	// Sent 1 ms before the first capture time, which is mapped onto the start time
+	struct timeval expected = { 1699999999, 999000 };
+	EXPECT_EQ(getAsGPSQuarterMillisecondOfWeek(&expected), getQmsOfWeek(frames[0]));
+	for (size_t i = 1; i < frames.size(); ++i) {
+		EXPECT_EQ(40u, getQmsOfWeek(frames[i]) - getQmsOfWeek(frames[i - 1]));
+		EXPECT_EQ(i, frames[i].header.messageCounter);
+		EXPECT_DOUBLE_EQ(static_cast<double>(i), frames[i].monitor.position.xCoord_m);
+	}
+	closeCapture(&capture);
+}
+
+TEST_F(Replay, CompressesTimestampsWithSpeed) {
+	writeCapture(11);
+	CaptureType capture;
+	ASSERT_EQ(0, openCapture(path, &capture));
+
+	ReplayConfigType config;
+	memset(&config, 0, sizeof(config));
+	config.speedFactor = 4;
+	config.isTimestampRewritten = true;
+	config.startTime = { 1700000000, 0 };
+	std::vector<ReplayedFrame> frames;
+	ReplayStatisticsType statistics;
+	ASSERT_EQ(0, replayCapture(&capture, &config, collectFrame, &frames, &statistics));
+	ASSERT_EQ(11u, frames.size());
+	EXPECT_EQ(100u, getQmsOfWeek(frames[10]) - getQmsOfWeek(frames[0]));
+
+	// 100 ms of traffic in 25 ms
+	EXPECT_EQ(25000000, statistics.scheduledDuration_ns);
+	EXPECT_GE(statistics.elapsed_ns, 25000000);
+	EXPECT_GE(statistics.maxLateness_ns, 0);
+	EXPECT_EQ(statistics.drift_ns, statistics.elapsed_ns - statistics.scheduledDuration_ns);
+	closeCapture(&capture);
+}
+
+TEST_F(Replay, LeavesCaptureUnmodifiedWithoutRewrite) {
+	writeCapture(5);
+	CaptureType capture;
+	ASSERT_EQ(0, openCapture(path, &capture));
+
+	ReplayConfigType config;
+	memset(&config, 0, sizeof(config));
+	std::vector<ReplayedFrame> frames;
+	ReplayStatisticsType statistics;
+	ASSERT_EQ(0, replayCapture(&capture, &config, collectFrame, &frames, &statistics));
+	ASSERT_EQ(5u, frames.size());
+	EXPECT_EQ(0u, statistics.nRewritten);
+	struct timeval expected = { 1651198942, 40000 };
+	EXPECT_EQ(getAsGPSQuarterMillisecondOfWeek(&expected), getQmsOfWeek(frames[4]));
+
+	EXPECT_EQ(-1, replayCapture(&capture, &config, failingSink, nullptr, &statistics));
+	EXPECT_EQ(EPIPE, errno);
+	EXPECT_EQ(0u, statistics.nFrames);
+	closeCapture(&capture);
+}
+
+TEST_F(Replay, MergesRecordedObjectsInTimeOrder) {
+	MonitorRecorderConfigType recorderConfig = { 1024, 16 };
+	MonitorRecorderType* recorder = openMonitorRecorder(path, &recorderConfig);
+	ASSERT_NE(nullptr, recorder);
+	std::vector<MonitorRecordType> records;
+	for (int i = 0; i < 50; ++i) {
+		// The second object runs at half the rate, offset by 5 ms
+		for (uint32_t id : { TEST_TRANSMITTER_ID_1, TEST_TRANSMITTER_ID_2 }) {
+			if (id == TEST_TRANSMITTER_ID_2 && i % 2 == 1) {
+				continue;
+			}
+			MonitorRecordType record;
+			memset(&record, 0, sizeof(record));
+			record.transmitterID = id;
+			record.sample.gpsWeek = 2207;
+			record.sample.gpsQmsOfWeek = 1000000 + 40 * static_cast<uint32_t>(i) + (id == TEST_TRANSMITTER_ID_2 ? 20 : 0);
+			record.sample.isTimestampValid = true;
+			record.sample.xPosition = i;
+			record.sample.state = OBJECT_STATE_RUNNING;
+			record.sample.isPositionValid = record.sample.isXcoordValid = true;
+			records.push_back(record);
+		}
+	}
+	ASSERT_EQ(static_cast<ssize_t>(records.size()), submitMonitorRecords(recorder, records.data(), records.size()));
+	ASSERT_EQ(0, closeMonitorRecorder(recorder));
+
+	MonitorRecordingType recording;
+	ASSERT_EQ(0, openMonitorRecording(path, &recording));
+	ReplayConfigType config;
+	memset(&config, 0, sizeof(config));
+	config.isTimestampRewritten = true;
+	config.startTime = { 1700000000, 0 };
+	config.receiverID = TEST_DEFAULT_RECEIVER_ID;
+	std::vector<ReplayedFrame> frames;
+	ReplayStatisticsType statistics;
+	ASSERT_EQ(0, replayMonitorRecording(&recording, &config, collectFrame, &frames, &statistics));
+	ASSERT_EQ(75u, frames.size());
+	EXPECT_EQ(75u, statistics.nRewritten);
+
+	uint8_t counters[2] = { 0, 0 };
+	for (size_t i = 0; i < frames.size(); ++i) {
+		const bool isFirst = frames[i].header.transmitterID == TEST_TRANSMITTER_ID_1;
+		EXPECT_EQ(TEST_DEFAULT_RECEIVER_ID, frames[i].header.receiverID);
+		EXPECT_EQ(counters[isFirst ? 0 : 1]++, frames[i].header.messageCounter);
+		EXPECT_EQ(OBJECT_STATE_RUNNING, frames[i].monitor.state);
+		if (i > 0) {
+			EXPECT_GE(getQmsOfWeek(frames[i]), getQmsOfWeek(frames[i - 1]));
+		}
+	}
+	EXPECT_EQ(TEST_TRANSMITTER_ID_2, frames[1].header.transmitterID);
+	EXPECT_EQ(1960u, getQmsOfWeek(frames.back()) - getQmsOfWeek(frames.front()));
+	closeMonitorRecording(&recording);
+}
+
+TEST_F(Replay, PacesRecordingFromFirstValidTimestamp) {
+	MonitorRecorderConfigType recorderConfig = { 1024, 16 };
+	MonitorRecorderType* recorder = openMonitorRecorder(path, &recorderConfig);
+	ASSERT_NE(nullptr, recorder);
+	std::vector<MonitorRecordType> records;
+	for (int i = 0; i < 50; ++i) {
+		MonitorRecordType record;
+		memset(&record, 0, sizeof(record));
+		record.transmitterID = TEST_TRANSMITTER_ID_1;
+		record.sample.gpsWeek = 2207;
+		record.sample.gpsQmsOfWeek = 1000000 + 40 * static_cast<uint32_t>(i);
+		// Leading samples cannot be placed in time, later ones take the time of the previous sample
+		record.sample.isTimestampValid = i >= 2 && i != 10;
+		record.sample.xPosition = i;
+		record.sample.state = OBJECT_STATE_RUNNING;
+		record.sample.isPositionValid = record.sample.isXcoordValid = true;
+		records.push_back(record);
+	}
+	ASSERT_EQ(static_cast<ssize_t>(records.size()), submitMonitorRecords(recorder, records.data(), records.size()));
+	ASSERT_EQ(0, closeMonitorRecorder(recorder));
+
+	MonitorRecordingType recording;
+	ASSERT_EQ(0, openMonitorRecording(path, &recording));
+	ReplayConfigType config;
+	memset(&config, 0, sizeof(config));
+	config.speedFactor = 100.0;
+	std::vector<ReplayedFrame> frames;
+	ReplayStatisticsType statistics;
+	ASSERT_EQ(0, replayMonitorRecording(&recording, &config, collectFrame, &frames, &statistics));
+	ASSERT_EQ(48u, frames.size());
+	EXPECT_DOUBLE_EQ(0.002, frames.front().monitor.position.xCoord_m);
+	// 47 steps of 10 ms, at a hundred times real time
+	EXPECT_EQ(4700000, statistics.scheduledDuration_ns);
+	closeMonitorRecording(&recording);
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <vector>
+extern "C" {
+#include "scenarioengine.h"
+#include "iso22133.h"
+#include "header.h"
+}
+#include "testdefines.h"
+
+#define TEST_OBJECT_ID 5
+
+class ScenarioEngine : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		const struct timeval lead = { 0, 100000 };
+		engine = createScenarioEngine(5.0, &lead);
+		ASSERT_NE(nullptr, engine);
+	}
+	void TearDown() override {
+		freeScenarioEngine(engine);
+	}
+
+	static ScenarioTriggerType speedTrigger(const uint16_t id, const TriggerTypeParameter_t comparison,
+											const double threshold) {
+		ScenarioTriggerType trigger = {};
+		trigger.triggerID = id;
+		trigger.transmitterID = TEST_OBJECT_ID;
+		trigger.type = TRIGGER_SPEED;
+		trigger.comparison = comparison;
+		trigger.speedThreshold_m_s = threshold;
+		return trigger;
+	}
+
+	static ScenarioTriggerType regionTrigger(const uint16_t id, const TriggerType_t type, const double minX,
+											 const double minY, const double maxX, const double maxY) {
+		ScenarioTriggerType trigger = {};
+		trigger.triggerID = id;
+		trigger.transmitterID = TEST_OBJECT_ID;
+		trigger.type = type;
+		trigger.minX_m = minX;
+		trigger.minY_m = minY;
+		trigger.maxX_m = maxX;
+		trigger.maxY_m = maxY;
+		return trigger;
+	}
+
+	int add(const ScenarioTriggerType& trigger) {
+		return addScenarioTrigger(engine, &trigger);
+	}
+
+	ssize_t process(const double x, const double y, const double speed,
+					const ObjectStateType state = OBJECT_STATE_RUNNING) {
+		ObjectMonitorType monitor = {};
+		monitor.position.xCoord_m = x;
+		monitor.position.yCoord_m = y;
+		monitor.position.isPositionValid = true;
+		monitor.speed.longitudinal_m_s = speed;
+		monitor.speed.isLongitudinalValid = true;
+		monitor.state = state;
+		now.tv_usec += 10000;
+		return processScenarioMonitorData(engine, TEST_OBJECT_ID, &monitor, &now);
+	}
+
+	ScenarioEngineType* engine;
+	struct timeval now = { 1651198942, 0 };
+};
+
+TEST_F(ScenarioEngine, SpeedTriggersFireOnCrossing) {
+	ASSERT_EQ(0, add(speedTrigger(1, TRIGGER_PARAMETER_GREATER_THAN, 5.0)));
+	ASSERT_EQ(0, add(speedTrigger(2, TRIGGER_PARAMETER_GREATER_THAN_OR_EQUAL_TO, 10.0)));
+	ASSERT_EQ(0, add(speedTrigger(3, TRIGGER_PARAMETER_LESS_THAN, 2.0)));
+
+	EXPECT_EQ(0, process(0, 0, 3.0));
+	EXPECT_EQ(0, process(0, 0, 5.0));
+	EXPECT_EQ(2, process(0, 0, 10.0));	// Crosses 5 and reaches 10
+	EXPECT_EQ(0, process(0, 0, 10.0));
+	EXPECT_EQ(0, process(0, 0, 6.0));
+	EXPECT_EQ(1, process(0, 0, 1.0));
+	EXPECT_EQ(2, process(0, 0, 12.0));
+	EXPECT_EQ(5u, getScenarioStatistics(engine).nTriggersFired);
+}
+
+TEST_F(ScenarioEngine, FirstSampleFiresTrueConditions) {
+	ASSERT_EQ(0, add(speedTrigger(1, TRIGGER_PARAMETER_GREATER_THAN, 5.0)));
+	ASSERT_EQ(0, add(speedTrigger(2, TRIGGER_PARAMETER_LESS_THAN, 8.0)));
+	ScenarioTriggerType stateTrigger = {};
+	stateTrigger.triggerID = 3;
+	stateTrigger.transmitterID = TEST_OBJECT_ID;
+	stateTrigger.type = TRIGGER_MODE_CHANGED;
+	stateTrigger.state = OBJECT_STATE_RUNNING;
+	ASSERT_EQ(0, addScenarioTrigger(engine, &stateTrigger));
+
+	EXPECT_EQ(3, process(0, 0, 6.0));
+	EXPECT_EQ(0, process(0, 0, 6.0));
+	EXPECT_EQ(0, process(0, 0, 6.0, OBJECT_STATE_POSTRUN));
+	EXPECT_EQ(1, process(0, 0, 6.0, OBJECT_STATE_RUNNING));
+}
+
+TEST_F(ScenarioEngine, RegionsFireOnEntryAndExit) {
+	ASSERT_EQ(0, add(regionTrigger(1, TRIGGER_POSITION_REACHED, 10, 10, 12, 12)));
+	ASSERT_EQ(0, add(regionTrigger(2, TRIGGER_POSITION_LEFT, 10, 10, 12, 12)));
+	// Large enough to bypass the grid
+	ASSERT_EQ(0, add(regionTrigger(3, TRIGGER_POSITION_REACHED, -500, -500, 500, 500)));
+	ASSERT_EQ(0, add(regionTrigger(4, TRIGGER_POSITION_REACHED, 100, 0, 101, 1)));
+
+	EXPECT_EQ(1, process(0, 0, 1.0));
+	EXPECT_EQ(0, process(9.9, 11, 1.0));
+	EXPECT_EQ(1, process(11, 11, 1.0));
+	EXPECT_EQ(0, process(11.5, 11, 1.0));
+	EXPECT_EQ(1, process(30, 30, 1.0));	// Left, although the grid cell no longer overlaps the region
+	EXPECT_EQ(1, process(10, 12, 1.0));
+
+	const ScenarioStatisticsType statistics = getScenarioStatistics(engine);
+	EXPECT_EQ(6u, statistics.nMonitorSamples);
+	EXPECT_EQ(4u, statistics.nTriggersFired);
+	// The region at x = 100 is never tested
+	EXPECT_LT(statistics.nTriggerEvaluations, 6u * 4u);
+}
+
+TEST_F(ScenarioEngine, RejectsInvalidTriggers) {
+	errno = 0;
+	EXPECT_EQ(-1, add(speedTrigger(1, TRIGGER_PARAMETER_EQUAL_TO, 5.0)));
+	EXPECT_EQ(EINVAL, errno);
+	EXPECT_EQ(-1, add(regionTrigger(1, TRIGGER_POSITION_REACHED, 1, 0, 0, 1)));
+	ScenarioTriggerType trigger = speedTrigger(1, TRIGGER_PARAMETER_GREATER_THAN, 5.0);
+	trigger.type = TRIGGER_BRAKE;
+	EXPECT_EQ(-1, addScenarioTrigger(engine, &trigger));
+	EXPECT_EQ(0, process(0, 0, 10.0));
+}
+
+TEST_F(ScenarioEngine, SchedulesActionsInExecutionOrder) {
+	ASSERT_EQ(0, add(speedTrigger(1, TRIGGER_PARAMETER_GREATER_THAN, 5.0)));
+	const ScenarioActionType late = { 20, 1, TEST_TRANSMITTER_ID_2, { 1, 0 } };
+	const ScenarioActionType early = { 21, 1, TEST_TRANSMITTER_ID_2, { 0, 500000 } };
+	const ScenarioActionType immediate = { 22, 1, TEST_TRANSMITTER_ID_1, { 0, 0 } };
+	ASSERT_EQ(0, addScenarioAction(engine, &late));
+	ASSERT_EQ(0, addScenarioAction(engine, &early));
+	ASSERT_EQ(0, addScenarioAction(engine, &immediate));
+
+	struct timeval deadline;
+	EXPECT_EQ(-1, getNextScenarioDeadline(engine, &deadline));
+	ASSERT_EQ(1, process(0, 0, 6.0));
+	const struct timeval triggerTime = now;
+	EXPECT_EQ(3u, getScenarioStatistics(engine).nExecutionsScheduled);
+
+	// Immediate execution is due at once, the others 100 ms before execution
+	ASSERT_EQ(0, getNextScenarioDeadline(engine, &deadline));
+	EXPECT_EQ(triggerTime.tv_sec, deadline.tv_sec);
+	EXPECT_EQ(triggerTime.tv_usec, deadline.tv_usec);
+
+	ScenarioExecutionType executions[4];
+	ASSERT_EQ(1u, popDueScenarioExecutions(engine, &triggerTime, executions, 4));
+	EXPECT_EQ(22, executions[0].actionID);
+	ASSERT_EQ(0, getNextScenarioDeadline(engine, &deadline));
+	EXPECT_EQ(triggerTime.tv_sec, deadline.tv_sec);
+	EXPECT_EQ(triggerTime.tv_usec + 400000, deadline.tv_usec);
+
+	struct timeval later = { triggerTime.tv_sec + 2, 0 };
+	ASSERT_EQ(2u, popDueScenarioExecutions(engine, &later, executions, 4));
+	EXPECT_EQ(21, executions[0].actionID);
+	EXPECT_EQ(20, executions[1].actionID);
+	EXPECT_EQ(TEST_TRANSMITTER_ID_2, executions[1].transmitterID);
+	EXPECT_EQ(triggerTime.tv_sec + 1, executions[1].executionTime.tv_sec);
+	EXPECT_EQ(triggerTime.tv_usec, executions[1].executionTime.tv_usec);
+	EXPECT_EQ(-1, getNextScenarioDeadline(engine, &deadline));
+}
+
+TEST_F(ScenarioEngine, ReportsLatencyOfSentEXAC) {
+	ASSERT_EQ(0, add(speedTrigger(1, TRIGGER_PARAMETER_GREATER_THAN, 5.0)));
+	const ScenarioActionType action = { 7, 1, TEST_TRANSMITTER_ID_2, { 0, 50000 } };
+	ASSERT_EQ(0, addScenarioAction(engine, &action));
+	ASSERT_EQ(1, process(0, 0, 6.0));
+
+	ScenarioExecutionType execution;
+	ASSERT_EQ(1u, popDueScenarioExecutions(engine, &now, &execution, 1));
+	MessageHeaderType header = { TEST_TRANSMITTER_ID_1, TEST_TRANSMITTER_ID_2, TEST_DEFAULT_MESSAGE_COUNTER };
+	std::vector<char> buffer(getEncodedSizeEXACMessage());
+	struct timeval sendTime = now;
+	sendTime.tv_usec += 250;
+	ASSERT_EQ(static_cast<ssize_t>(buffer.size()),
+			  encodeScenarioEXACMessage(engine, &header, &execution, &sendTime, buffer.data(), buffer.size(), false));
+	HeaderType exacHeader;
+	ASSERT_EQ(MESSAGE_OK, decodeISOHeader(buffer.data(), buffer.size(), &exacHeader, false));
+	EXPECT_EQ(MESSAGE_ID_EXAC, exacHeader.messageID);
+
+	ScenarioStatisticsType statistics = getScenarioStatistics(engine);
+	EXPECT_EQ(1u, statistics.nExecutionsSent);
+	EXPECT_EQ(0u, statistics.nExecutionsLate);
+	EXPECT_EQ(250, statistics.minLatency_us);
+	EXPECT_EQ(250, statistics.maxLatency_us);
+
+	resetScenarioEngine(engine);
+	statistics = getScenarioStatistics(engine);
+	EXPECT_EQ(0u, statistics.nExecutionsSent);
+	EXPECT_EQ(1, process(0, 0, 6.0));
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cmath>
+#include <limits>
+#include <vector>
+extern "C" {
+#include "spatialindex.h"
+}
+
+class SpatialIndex : public ::testing::Test
+{
+protected:
+	static TrajectoryWaypointType waypoint(const double x, const double y, const int64_t time_ms) {
+		TrajectoryWaypointType point = {};
+		point.relativeTime = { static_cast<time_t>(time_ms / 1000), static_cast<suseconds_t>(time_ms % 1000 * 1000) };
+		point.pos.xCoord_m = x;
+		point.pos.yCoord_m = y;
+		point.pos.isPositionValid = true;
+		return point;
+	}
+
+	//! Spiral passing over itself, so that nearby segments are far apart along the trajectory
+	static std::vector<TrajectoryWaypointType> spiral(const int nPoints) {
+		std::vector<TrajectoryWaypointType> waypoints;
+		for (int i = 0; i < nPoints; ++i) {
+			const double angle = i * 0.05;
+			const double radius = 20.0 + 10.0 * std::sin(i * 0.013);
+			waypoints.push_back(waypoint(radius * std::cos(angle), radius * std::sin(angle), i * 10));
+		}
+		return waypoints;
+	}
+
+	static double bruteForceDistance(const std::vector<TrajectoryWaypointType>& waypoints,
+									 const double x, const double y) {
+		double best = std::numeric_limits<double>::infinity();
+		for (size_t i = 0; i + 1 < waypoints.size(); ++i) {
+			const double ax = waypoints[i].pos.xCoord_m, ay = waypoints[i].pos.yCoord_m;
+			const double dx = waypoints[i + 1].pos.xCoord_m - ax, dy = waypoints[i + 1].pos.yCoord_m - ay;
+			const double length2 = dx * dx + dy * dy;
+			double f = length2 > 0.0 ? ((x - ax) * dx + (y - ay) * dy) / length2 : 0.0;
+			f = std::fmin(1.0, std::fmax(0.0, f));
+			best = std::fmin(best, std::hypot(ax + f * dx - x, ay + f * dy - y));
+		}
+		return best;
+	}
+};
+
+TEST_F(SpatialIndex, FindsNearestSegment) {
+	const std::vector<TrajectoryWaypointType> waypoints = spiral(2000);
+	SpatialIndexType* index = createSpatialIndex(waypoints.data(), waypoints.size());
+	ASSERT_NE(nullptr, index);
+
+	for (double x = -45.0; x <= 45.0; x += 3.7) {
+		for (double y = -45.0; y <= 45.0; y += 4.1) {
+			TrajectoryProjectionType projection;
+			ASSERT_EQ(0, projectOntoSpatialIndex(index, x, y, &projection));
+			EXPECT_NEAR(bruteForceDistance(waypoints, x, y), projection.distance_m, 1e-9) << x << ", " << y;
+			EXPECT_NEAR(projection.distance_m, std::hypot(projection.x_m - x, projection.y_m - y), 1e-9);
+		}
+	}
+	freeSpatialIndex(index);
+}
+
+TEST_F(SpatialIndex, ReportsOffsetArcLengthAndTime) {
+	const std::vector<TrajectoryWaypointType> waypoints = {
+		waypoint(0, 0, 0), waypoint(10, 0, 1000), waypoint(10, 10, 3000), waypoint(0, 10, 4000)
+	};
+	SpatialIndexType* index = createSpatialIndex(waypoints.data(), waypoints.size());
+	ASSERT_NE(nullptr, index);
+
+	TrajectoryProjectionType projection;
+	ASSERT_EQ(0, projectOntoSpatialIndex(index, 4.0, 1.5, &projection));
+	EXPECT_EQ(0u, projection.segment);
+	EXPECT_DOUBLE_EQ(0.4, projection.fraction);
+	EXPECT_DOUBLE_EQ(1.5, projection.lateralOffset_m);	// Left of travel along x
+	EXPECT_DOUBLE_EQ(4.0, projection.arcLength_m);
+	EXPECT_EQ(0, projection.relativeTime.tv_sec);
+	EXPECT_EQ(400000, projection.relativeTime.tv_usec);
+
+	ASSERT_EQ(0, projectOntoSpatialIndex(index, 12.0, 5.0, &projection));
+	EXPECT_EQ(1u, projection.segment);
+	EXPECT_DOUBLE_EQ(-2.0, projection.lateralOffset_m);	// Right of travel along y
+	EXPECT_DOUBLE_EQ(15.0, projection.arcLength_m);
+	EXPECT_EQ(2, projection.relativeTime.tv_sec);
+	EXPECT_EQ(0, projection.relativeTime.tv_usec);
+
+	// Beyond the end, the offset keeps the side of the last segment
+	ASSERT_EQ(0, projectOntoSpatialIndex(index, -3.0, 14.0, &projection));
+	EXPECT_EQ(2u, projection.segment);
+	EXPECT_DOUBLE_EQ(1.0, projection.fraction);
+	EXPECT_DOUBLE_EQ(-5.0, projection.lateralOffset_m);
+	EXPECT_DOUBLE_EQ(30.0, projection.arcLength_m);
+	freeSpatialIndex(index);
+}
+
+TEST_F(SpatialIndex, BatchMatchesSingleQueries) {
+	const std::vector<TrajectoryWaypointType> waypoints = spiral(5000);
+	SpatialIndexType* index = createSpatialIndex(waypoints.data(), waypoints.size());
+	ASSERT_NE(nullptr, index);
+
+	std::vector<double> x, y;
+	for (int i = 0; i < 500; ++i) {
+		x.push_back(waypoints[static_cast<size_t>(i * 7)].pos.xCoord_m + std::sin(i) * 2.0);
+		y.push_back(waypoints[static_cast<size_t>(i * 7)].pos.yCoord_m + std::cos(i * 0.7) * 2.0);
+	}
+	x[10] = std::numeric_limits<double>::quiet_NaN();
+	y[20] = std::numeric_limits<double>::infinity();
+	std::vector<TrajectoryProjectionType> projections(x.size());
+	EXPECT_EQ(x.size() - 2, projectManyOntoSpatialIndex(index, x.data(), y.data(), x.size(), projections.data()));
+	for (size_t i = 0; i < x.size(); ++i) {
+		TrajectoryProjectionType expected;
+		if (i == 10 || i == 20) {
+			EXPECT_EQ(-1, projectOntoSpatialIndex(index, x[i], y[i], &expected));
+			continue;
+		}
+		ASSERT_EQ(0, projectOntoSpatialIndex(index, x[i], y[i], &expected));
+		EXPECT_DOUBLE_EQ(expected.distance_m, projections[i].distance_m) << i;
+		EXPECT_DOUBLE_EQ(expected.lateralOffset_m, projections[i].lateralOffset_m) << i;
+	}
+	freeSpatialIndex(index);
+}
+
+TEST_F(SpatialIndex, HandlesDegenerateTrajectories) {
+	std::vector<TrajectoryWaypointType> waypoints = { waypoint(3, 4, 0) };
+	errno = 0;
+	EXPECT_EQ(nullptr, createSpatialIndex(waypoints.data(), 0));
+	EXPECT_EQ(EINVAL, errno);
+
+	SpatialIndexType* index = createSpatialIndex(waypoints.data(), 1);
+	ASSERT_NE(nullptr, index);
+	TrajectoryProjectionType projection;
+	ASSERT_EQ(0, projectOntoSpatialIndex(index, 0.0, 0.0, &projection));
+	EXPECT_DOUBLE_EQ(5.0, projection.distance_m);
+	EXPECT_DOUBLE_EQ(0.0, projection.arcLength_m);
+	freeSpatialIndex(index);
+
+	waypoints.push_back(waypoint(5, 5, 100));
+	waypoints[1].pos.isPositionValid = false;
+	EXPECT_EQ(nullptr, createSpatialIndex(waypoints.data(), waypoints.size()));
+}
@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <vector>
+extern "C" {
+#include "syncpointengine.h"
+}
+#include "testdefines.h"
+#include "testtrajectories.h"
+
+#define TEST_MASTER_ID TEST_TRANSMITTER_ID_1
+#define TEST_SLAVE_ID TEST_TRANSMITTER_ID_2
+
+class SyncPointEngine : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		const struct timeval period = { 0, 100000 };
+		engine = createSyncPointEngine(&period);
+		ASSERT_NE(nullptr, engine);
+	}
+	void TearDown() override {
+		freeSyncPointEngine(engine);
+	}
+
+	int setTrajectory(const std::vector<TrajectoryWaypointType>& waypoints, const uint32_t masterID = TEST_MASTER_ID) {
+		return setSyncPointMasterTrajectory(engine, masterID, waypoints.data(), waypoints.size());
+	}
+
+	int addPoint(const uint16_t id, const time_t masterTime_s, const uint32_t masterID = TEST_MASTER_ID) {
+		SyncPointType syncPoint = {};
+		syncPoint.syncPointID = id;
+		syncPoint.masterTransmitterID = masterID;
+		syncPoint.slaveTransmitterID = TEST_SLAVE_ID;
+		syncPoint.masterTime = { masterTime_s, 0 };
+		return addSyncPoint(engine, &syncPoint);
+	}
+
+	int process(const double x, const double y, const double speed = 1.0, const uint32_t masterID = TEST_MASTER_ID) {
+		ObjectMonitorType monitor = {};
+		monitor.isTimestampValid = true;
+		monitor.timestamp = now;
+		monitor.position.xCoord_m = x;
+		monitor.position.yCoord_m = y;
+		monitor.position.isPositionValid = true;
+		monitor.speed.longitudinal_m_s = speed;
+		monitor.speed.isLongitudinalValid = true;
+		return processSyncPointMonitorData(engine, masterID, &monitor, &now);
+	}
+
+	SyncPointEngineType* engine;
+	struct timeval now = { 1651198942, 0 };
+};
+
+TEST_F(SyncPointEngine, EstimatesFromProjectedPosition) {
+	ASSERT_EQ(0, setTrajectory(lineTrajectory(100)));
+	ASSERT_EQ(0, addPoint(1, 50));
+	ASSERT_EQ(1, process(10.25, 0.5));
+
+	SyncPointUpdateType update;
+	ASSERT_EQ(1u, popDueSyncPointUpdates(engine, &now, &update, 1));
+	EXPECT_EQ(1, update.syncPointID);
+	EXPECT_EQ(TEST_MASTER_ID, update.masterTransmitterID);
+	EXPECT_EQ(TEST_SLAVE_ID, update.slaveTransmitterID);
+	EXPECT_EQ(now.tv_sec + 39, update.estSyncPointTime.tv_sec);
+	EXPECT_EQ(750000, update.estSyncPointTime.tv_usec);
+	EXPECT_DOUBLE_EQ(39.75, update.remainingDistance_m);
+}
+
+TEST_F(SyncPointEngine, UpdatesAtConfiguredRate) {
+	ASSERT_EQ(0, setTrajectory(lineTrajectory(100)));
+	ASSERT_EQ(0, addPoint(1, 20));
+	ASSERT_EQ(0, addPoint(2, 40));
+
+	SyncPointUpdateType updates[4];
+	struct timeval deadline;
+	EXPECT_EQ(-1, getNextSyncPointDeadline(engine, &deadline));
+	ASSERT_EQ(2, process(10.0, 0.0));
+	EXPECT_EQ(2u, popDueSyncPointUpdates(engine, &now, updates, 4));
+
+	struct timeval later = { now.tv_sec, 50000 };
+	EXPECT_EQ(0u, popDueSyncPointUpdates(engine, &later, updates, 4));
+	ASSERT_EQ(0, getNextSyncPointDeadline(engine, &deadline));
+	EXPECT_EQ(now.tv_sec, deadline.tv_sec);
+	EXPECT_EQ(100000, deadline.tv_usec);
+	later.tv_usec = 100000;
+	EXPECT_EQ(2u, popDueSyncPointUpdates(engine, &later, updates, 4));
+
+	// Once passed, a sync point is no longer updated
+	now.tv_sec += 20;
+	ASSERT_EQ(2, process(30.0, 0.0));
+	later = { now.tv_sec, 0 };
+	ASSERT_EQ(1u, popDueSyncPointUpdates(engine, &later, updates, 4));
+	EXPECT_EQ(2, updates[0].syncPointID);
+	EXPECT_EQ(5u, getSyncPointStatistics(engine).nUpdates);
+}
+
+TEST_F(SyncPointEngine, TracksAlongTrajectoryWithoutFullSearch) {
+	ASSERT_EQ(0, setTrajectory(lineTrajectory(5000)));
+	ASSERT_EQ(0, addPoint(1, 4000));
+
+	const int nSamples = 3000;
+	for (int i = 0; i < nSamples; ++i) {
+		now.tv_usec = (i % 10) * 100000;
+		now.tv_sec += i % 10 == 0 ? 1 : 0;
+		ASSERT_EQ(1, process(i * 0.1, 0.2));
+	}
+	SyncPointStatisticsType statistics = getSyncPointStatistics(engine);
+	EXPECT_EQ(1u, statistics.nReacquisitions);
+	EXPECT_LT(statistics.nSegmentsTested, 16u * nSamples);
+
+	// A position far from the prediction is reacquired anywhere on the trajectory
+	ASSERT_EQ(1, process(3000.0, 0.0));
+	statistics = getSyncPointStatistics(engine);
+	EXPECT_EQ(2u, statistics.nReacquisitions);
+	SyncPointUpdateType update;
+	now.tv_sec += 1;
+	ASSERT_EQ(1u, popDueSyncPointUpdates(engine, &now, &update, 1));
+	EXPECT_DOUBLE_EQ(1000.0, update.remainingDistance_m);
+}
+
+TEST_F(SyncPointEngine, FollowsReturnLegOfOverlappingTrajectory) {
+	ASSERT_EQ(0, setTrajectory(lineTrajectory(100, true)));
+	ASSERT_EQ(0, addPoint(1, 190));
+
+	// Driving out and back, each position is passed twice and only the progress tells them apart
+	for (int x = 0; x <= 100; x += 2) {
+		now.tv_sec += 2;
+		ASSERT_EQ(1, process(x, 0.0));
+	}
+	for (int x = 98; x >= 12; x -= 2) {
+		now.tv_sec += 2;
+		ASSERT_EQ(1, process(x, 0.0));
+	}
+	SyncPointUpdateType update;
+	ASSERT_EQ(1u, popDueSyncPointUpdates(engine, &now, &update, 1));
+	EXPECT_EQ(now.tv_sec + 2, update.estSyncPointTime.tv_sec);
+	EXPECT_DOUBLE_EQ(2.0, update.remainingDistance_m);
+	EXPECT_EQ(1u, getSyncPointStatistics(engine).nReacquisitions);
+}
+
+TEST_F(SyncPointEngine, HandlesSeveralMasters) {
+	ASSERT_EQ(0, addPoint(1, 10));
+	ASSERT_EQ(0, addPoint(2, 10, TEST_DEFAULT_RECEIVER_ID));
+	ASSERT_EQ(0, addPoint(3, 20));
+
+	// Sync points added before their trajectory are estimated once it is set
+	EXPECT_EQ(0, process(0.0, 0.0));
+	ASSERT_EQ(0, setTrajectory(lineTrajectory(100)));
+	ASSERT_EQ(0, setTrajectory(lineTrajectory(50), TEST_DEFAULT_RECEIVER_ID));
+	EXPECT_EQ(2, process(5.0, 0.0));
+	EXPECT_EQ(1, process(1.0, 0.0, 1.0, TEST_DEFAULT_RECEIVER_ID));
+
+	SyncPointUpdateType updates[4] = {};
+	ASSERT_EQ(3u, popDueSyncPointUpdates(engine, &now, updates, 4));
+	for (const auto& update : updates) {
+		if (update.syncPointID == 2) {
+			EXPECT_EQ(TEST_DEFAULT_RECEIVER_ID, update.masterTransmitterID);
+			EXPECT_EQ(now.tv_sec + 9, update.estSyncPointTime.tv_sec);
+		}
+	}
+
+	resetSyncPointEngine(engine);
+	EXPECT_EQ(0u, popDueSyncPointUpdates(engine, &now, updates, 4));
+	EXPECT_EQ(0u, getSyncPointStatistics(engine).nMonitorSamples);
+}
+
+TEST_F(SyncPointEngine, RejectsInvalidTrajectories) {
+	std::vector<TrajectoryWaypointType> waypoints = lineTrajectory(10);
+	errno = 0;
+	EXPECT_EQ(-1, setSyncPointMasterTrajectory(engine, TEST_MASTER_ID, waypoints.data(), 1));
+	EXPECT_EQ(EINVAL, errno);
+	waypoints[5].relativeTime = { 3, 0 };
+	EXPECT_EQ(-1, setTrajectory(waypoints));
+	waypoints = lineTrajectory(10);
+	waypoints[2].pos.isPositionValid = false;
+	EXPECT_EQ(-1, setTrajectory(waypoints));
+	ASSERT_EQ(0, addPoint(1, 5));
+	EXPECT_EQ(0, process(1.0, 0.0));
+}
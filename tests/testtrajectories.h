@@ -0,0 +1,51 @@
+#pragma once
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "iso22133.h"
+}
+
+//! Trajectory along the x axis at 1 m/s, optionally out to a turning point and back along the same line
+static inline std::vector<TrajectoryWaypointType> lineTrajectory(const int length_m, const bool isReturning = false) {
+	std::vector<TrajectoryWaypointType> waypoints;
+	const int nPoints = isReturning ? 2 * length_m + 1 : length_m + 1;
+	for (int i = 0; i < nPoints; ++i) {
+		TrajectoryWaypointType waypoint = {};
+		waypoint.relativeTime = { i, 0 };
+		waypoint.pos.xCoord_m = i <= length_m ? i : 2 * length_m - i;
+		waypoint.pos.heading_rad = i < length_m ? 0.0 : M_PI;
+		waypoint.pos.isPositionValid = true;
+		waypoint.pos.isHeadingValid = true;
+		waypoints.push_back(waypoint);
+	}
+	return waypoints;
+}
+
+//! Straights and curves at 100 Hz with heading, speed and acceleration, lateral speed unavailable
+static inline std::vector<TrajectoryWaypointType> drivingTrajectory(const int nPoints) {
+	std::vector<TrajectoryWaypointType> waypoints;
+	double x = 100.0, y = -50.0, heading = 0.5, speed = 5.0;
+	for (int i = 0; i < nPoints; ++i) {
+		TrajectoryWaypointType point = {};
+		const double acceleration = 1.5 * std::sin(i * 0.001);
+		const float curvature = (i / 1500) % 3 == 1 ? static_cast<float>(0.02 * std::sin(i * 0.002)) : 0.0f;
+		point.relativeTime = { i / 100, (i % 100) * 10000 };
+		point.pos.xCoord_m = x;
+		point.pos.yCoord_m = y;
+		point.pos.zCoord_m = 0.001 * i;
+		point.pos.heading_rad = heading;
+		point.pos.isPositionValid = point.pos.isHeadingValid = true;
+		point.spd.longitudinal_m_s = speed;
+		point.spd.isLongitudinalValid = true;
+		point.acc.longitudinal_m_s2 = acceleration;
+		point.acc.lateral_m_s2 = curvature * speed * speed;
+		point.acc.isLongitudinalValid = point.acc.isLateralValid = true;
+		point.curvature = curvature;
+		waypoints.push_back(point);
+		speed += acceleration * 0.01;
+		heading = std::fmod(heading + curvature * speed * 0.01 + 2.0 * M_PI, 2.0 * M_PI);
+		x += speed * 0.01 * std::cos(heading);
+		y += speed * 0.01 * std::sin(heading);
+	}
+	return waypoints;
+}
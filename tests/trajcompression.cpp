@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <vector>
+extern "C" {
+#include "trajcompression.h"
+#include "codeccontext.h"
+#include "iso22133.h"
+#include "vendorregistry.h"
+}
+#include "testtrajectories.h"
+
+#define CTRJ_N_POINTS_OFFSET 86
+#define CTRJ_FIRST_BLOCK_OFFSET 90
+
+class TrajectoryCompression : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		compressor = createTrajectoryCompressor();
+		decompressor = createTrajectoryDecompressor();
+		ASSERT_NE(nullptr, compressor);
+		ASSERT_NE(nullptr, decompressor);
+		inputHeader.transmitterID = 1;
+		inputHeader.receiverID = 2;
+		inputHeader.messageCounter = 0;
+	}
+
+	void TearDown() override {
+		freeTrajectoryCompressor(compressor);
+		freeTrajectoryDecompressor(decompressor);
+	}
+
+	//! Decodes a plain TRAJ message
+	static std::vector<TrajectoryWaypointType> decodeTRAJ(const std::vector<char>& buffer, const size_t size) {
+		TrajectoryHeaderType header;
+		const ssize_t headerSize = decodeTRAJMessageHeader(&header, buffer.data(), size, false);
+		EXPECT_GT(headerSize, 0);
+		std::vector<TrajectoryWaypointType> waypoints(header.nWaypoints);
+		const char* p = buffer.data() + headerSize;
+		for (auto& waypoint : waypoints) {
+			const ssize_t pointSize = decodeTRAJMessagePointBounded(&waypoint, p, buffer.data() + size - p, false);
+			EXPECT_GT(pointSize, 0);
+			p += pointSize;
+		}
+		return waypoints;
+	}
+
+	//! Decodes a CTRJ message a few points at a time
+	std::vector<TrajectoryWaypointType> decodeCTRJ(const std::vector<char>& buffer, const size_t size,
+												   TrajectoryHeaderType* header) {
+		std::vector<TrajectoryWaypointType> waypoints;
+		EXPECT_EQ(static_cast<ssize_t>(size), decodeCTRJMessageHeader(decompressor, header, buffer.data(), size, false));
+		TrajectoryWaypointType chunk[37];
+		ssize_t nDecoded;
+		while ((nDecoded = decodeCTRJMessagePoints(decompressor, chunk, 37)) > 0) {
+			waypoints.insert(waypoints.end(), chunk, chunk + nDecoded);
+		}
+		EXPECT_EQ(0, nDecoded);
+		return waypoints;
+	}
+
+	static void expectSameWaypoints(const std::vector<TrajectoryWaypointType>& expected,
+									const std::vector<TrajectoryWaypointType>& actual) {
+		ASSERT_EQ(expected.size(), actual.size());
+		for (size_t i = 0; i < expected.size(); ++i) {
+			ASSERT_EQ(0, std::memcmp(&expected[i], &actual[i], sizeof (TrajectoryWaypointType))) << "point " << i;
+		}
+	}
+
+	TrajectoryCompressorType* compressor;
+	TrajectoryDecompressorType* decompressor;
+	MessageHeaderType inputHeader;
+};
+
+TEST_F(TrajectoryCompression, DecodesAsPlainTRAJ) {
+	const auto waypoints = drivingTrajectory(20000);
+	const uint32_t nPoints = static_cast<uint32_t>(waypoints.size());
+	std::vector<char> plain(getEncodedSizeTRAJMessage(nPoints)), compressed(plain.size());
+
+	const ssize_t plainSize = encodeTrajectoryMessage(compressor, 0, &inputHeader, 7, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN,
+													  "drive", 5, waypoints.data(), nPoints, plain.data(),
+													  plain.size(), false);
+	ASSERT_EQ(static_cast<ssize_t>(plain.size()), plainSize);
+	EXPECT_EQ(MESSAGE_ID_TRAJ, getISOMessageType(plain.data(), plain.size(), false));
+
+	const ssize_t compressedSize = encodeTrajectoryMessage(compressor, CTRJ_CODEC_VERSION, &inputHeader, 7,
+														   TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, "drive", 5,
+														   waypoints.data(), nPoints, compressed.data(),
+														   compressed.size(), false);
+	ASSERT_GT(compressedSize, 0);
+	EXPECT_EQ(MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, getISOMessageType(compressed.data(), compressed.size(), false));
+	EXPECT_GT(static_cast<double>(plainSize) / compressedSize, 5.0);
+
+	TrajectoryHeaderType header;
+	const auto decoded = decodeCTRJ(compressed, static_cast<size_t>(compressedSize), &header);
+	EXPECT_EQ(7, header.trajectoryID);
+	EXPECT_STREQ("drive", header.trajectoryName);
+	EXPECT_EQ(TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, header.trajectoryInfo);
+	EXPECT_EQ(nPoints, header.nWaypoints);
+	expectSameWaypoints(decodeTRAJ(plain, plain.size()), decoded);
+}
+
+TEST_F(TrajectoryCompression, EncodesWhilePointsAreAdded) {
+	const auto waypoints = drivingTrajectory(1000);
+	std::vector<char> buffer(getEncodedSizeTRAJMessage(1000));
+	TrajectoryHeaderType header;
+
+	ASSERT_EQ(0, beginCTRJMessage(compressor, 1, TRAJECTORY_INFO_RELATIVE_TO_OBJECT, nullptr, 0));
+	for (size_t n = 0; n < waypoints.size(); ++n) {
+		const auto& point = waypoints[n];
+		if (n == 0 || n == 64 || n == 100) {
+			const ssize_t size = encodeCTRJMessage(compressor, &inputHeader, buffer.data(), buffer.size(), false);
+			ASSERT_EQ(static_cast<ssize_t>(getEncodedSizeCTRJMessage(compressor)), size);
+			const auto decoded = decodeCTRJ(buffer, static_cast<size_t>(size), &header);
+			EXPECT_EQ(n, header.nWaypoints);
+			ASSERT_EQ(n, decoded.size());
+			if (n > 0) {
+				EXPECT_NEAR(waypoints[n - 1].pos.xCoord_m, decoded.back().pos.xCoord_m, 1e-3);
+			}
+		}
+		ASSERT_EQ(0, addCTRJMessagePoint(compressor, &point.relativeTime, point.pos, point.spd, point.acc,
+										 point.curvature));
+	}
+	const ssize_t size = encodeCTRJMessage(compressor, &inputHeader, buffer.data(), buffer.size(), false);
+	const auto decoded = decodeCTRJ(buffer, static_cast<size_t>(size), &header);
+	ASSERT_EQ(waypoints.size(), decoded.size());
+	EXPECT_NEAR(waypoints.back().pos.yCoord_m, decoded.back().pos.yCoord_m, 1e-3);
+	EXPECT_FALSE(decoded.back().spd.isLateralValid);
+
+	// Points are required as in TRAJ
+	CartesianPosition position = waypoints[0].pos;
+	position.isPositionValid = false;
+	EXPECT_EQ(-1, addCTRJMessagePoint(compressor, &waypoints[0].relativeTime, position, waypoints[0].spd,
+									  waypoints[0].acc, 0.0f));
+	EXPECT_EQ(EINVAL, errno);
+	EXPECT_EQ(-1, beginCTRJMessage(compressor, 1, TRAJECTORY_INFO_RELATIVE_TO_OBJECT, buffer.data(), 64));
+	EXPECT_EQ(EMSGSIZE, errno);
+}
+
+TEST_F(TrajectoryCompression, SendsPlainTRAJUntilSupportIsAnnounced) {
+	const auto waypoints = drivingTrajectory(500);
+	std::vector<char> buffer(getEncodedSizeTRAJMessage(500));
+	char ctra[64];
+	ISOCodecContextType* controlCentre = createISOCodecContext();
+	ISOCodecContextType* object = createISOCodecContext();
+
+	ssize_t size = encodeTrajectoryMessageCtx(controlCentre, compressor, &inputHeader, 1,
+											  TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, nullptr, 0, waypoints.data(),
+											  500, buffer.data(), buffer.size());
+	EXPECT_EQ(static_cast<ssize_t>(buffer.size()), size);
+	EXPECT_EQ(MESSAGE_ID_TRAJ, getISOMessageType(buffer.data(), buffer.size(), false));
+
+	size = encodeCTRAMessageCtx(object, &inputHeader, ctra, sizeof (ctra));
+	ASSERT_EQ(static_cast<ssize_t>(getEncodedSizeCTRAMessage()), size);
+	EXPECT_EQ(MESSAGE_ID_VENDOR_SPECIFIC_CTRA, getISOMessageType(ctra, static_cast<size_t>(size), false));
+	ASSERT_EQ(size, decodeCTRAMessageCtx(controlCentre, ctra, static_cast<size_t>(size)));
+	EXPECT_EQ(CTRJ_CODEC_VERSION, getCodecCompressedTrajectoryVersion(controlCentre));
+
+	size = encodeTrajectoryMessageCtx(controlCentre, compressor, &inputHeader, 1, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN,
+									  nullptr, 0, waypoints.data(), 500, buffer.data(), buffer.size());
+	ASSERT_GT(size, 0);
+	EXPECT_LT(static_cast<size_t>(size), buffer.size() / 5);
+	EXPECT_EQ(MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, getISOMessageType(buffer.data(), buffer.size(), false));
+
+	// Without a compressor the plain message is sent regardless
+	size = encodeTrajectoryMessageCtx(controlCentre, nullptr, &inputHeader, 1, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN,
+									  nullptr, 0, waypoints.data(), 500, buffer.data(), buffer.size());
+	EXPECT_EQ(static_cast<ssize_t>(buffer.size()), size);
+
+	// Built in vendor messages cannot be registered by users
+	VendorMessageHandlerType handler = {};
+	EXPECT_EQ(-1, registerVendorMessage(MESSAGE_ID_VENDOR_SPECIFIC_CTRJ, &handler));
+	EXPECT_EQ(EEXIST, errno);
+
+	freeISOCodecContext(controlCentre);
+	freeISOCodecContext(object);
+}
+
+TEST_F(TrajectoryCompression, RejectsCorruptMessages) {
+	const auto waypoints = drivingTrajectory(200);
+	std::vector<char> buffer(getEncodedSizeTRAJMessage(200));
+	TrajectoryHeaderType header;
+	TrajectoryWaypointType decoded[200];
+
+	const ssize_t size = encodeTrajectoryMessage(compressor, CTRJ_CODEC_VERSION, &inputHeader, 1,
+												 TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, nullptr, 0, waypoints.data(), 200,
+												 buffer.data(), buffer.size(), false);
+	ASSERT_GT(size, 0);
+	const std::vector<char> original(buffer);
+	const auto clearCRC = [&]() { std::memset(&buffer[static_cast<size_t>(size) - 2], 0, 2); };
+
+	// Checksum mismatch
+	buffer[CTRJ_FIRST_BLOCK_OFFSET + 20] ^= 1;
+	EXPECT_EQ(MESSAGE_CRC_ERROR, decodeCTRJMessageHeader(decompressor, &header, buffer.data(), buffer.size(), false));
+
+	// More points than packed
+	buffer = original;
+	buffer[CTRJ_N_POINTS_OFFSET] = static_cast<char>(201);
+	clearCRC();
+	ASSERT_EQ(size, decodeCTRJMessageHeader(decompressor, &header, buffer.data(), buffer.size(), false));
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR, decodeCTRJMessagePoints(decompressor, decoded, 200));
+
+	// Fewer points than packed
+	buffer[CTRJ_N_POINTS_OFFSET] = static_cast<char>(150);
+	ASSERT_EQ(size, decodeCTRJMessageHeader(decompressor, &header, buffer.data(), buffer.size(), false));
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR, decodeCTRJMessagePoints(decompressor, decoded, 200));
+
+	// Residuals wider than their field
+	buffer = original;
+	buffer[CTRJ_FIRST_BLOCK_OFFSET + 4] = 17;
+	clearCRC();
+	ASSERT_EQ(size, decodeCTRJMessageHeader(decompressor, &header, buffer.data(), buffer.size(), false));
+	EXPECT_EQ(MESSAGE_CONTENT_OUT_OF_RANGE, decodeCTRJMessagePoints(decompressor, decoded, 200));
+
+	// Unknown codec version
+	buffer = original;
+	buffer[sizeof (HeaderType)] = CTRJ_CODEC_VERSION + 1;
+	clearCRC();
+	EXPECT_EQ(MESSAGE_VERSION_ERROR, decodeCTRJMessageHeader(decompressor, &header, buffer.data(), buffer.size(), false));
+
+	buffer = original;
+	ASSERT_EQ(size, decodeCTRJMessageHeader(decompressor, &header, buffer.data(), buffer.size(), false));
+	EXPECT_EQ(200, decodeCTRJMessagePoints(decompressor, decoded, 200));
+}
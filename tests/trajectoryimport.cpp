@@ -0,0 +1,231 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unistd.h>
+extern "C" {
+#include "trajectoryimport.h"
+#include "iso22133.h"
+#include "frame.h"
+}
+
+class TrajectoryImport : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		inputHeader.transmitterID = 1;
+		inputHeader.receiverID = 2;
+		inputHeader.messageCounter = 0;
+	}
+
+	void TearDown() override {
+		free(message);
+	}
+
+	struct Row {
+		std::string time, x, y, heading, speed, acceleration, curvature;
+	};
+
+	//! Rows of a driving trajectory at 100 Hz, formatted with varying precision
+	static std::vector<Row> drivingRows(const int nRows) {
+		std::vector<Row> rows;
+		char field[64];
+		for (int i = 0; i < nRows; ++i) {
+			Row row;
+			snprintf(field, sizeof(field), "%.2f", i * 0.01);
+			row.time = field;
+			snprintf(field, sizeof(field), i % 3 == 0 ? "%.3f" : "%.17g", 100.0 + 30.0 * std::sin(i * 0.001));
+			row.x = field;
+			snprintf(field, sizeof(field), "%g", -50.0 + 0.07 * i);
+			row.y = field;
+			snprintf(field, sizeof(field), "%.6f", std::fmod(0.5 + i * 0.0003, 2.0 * M_PI));
+			row.heading = field;
+			snprintf(field, sizeof(field), "%.4f", 5.0 + std::cos(i * 0.002));
+			row.speed = field;
+			if (i % 7 != 0) {
+				snprintf(field, sizeof(field), "%.3e", 1.5 * std::sin(i * 0.001));
+				row.acceleration = field;
+			}
+			snprintf(field, sizeof(field), "%.9g", 0.02 * std::sin(i * 0.002));
+			row.curvature = field;
+			rows.push_back(row);
+		}
+		return rows;
+	}
+
+	static std::string toText(const std::vector<Row>& rows) {
+		std::string text = "# Exported trajectory\ntime,x,y,heading,speed,acceleration,curvature\n";
+		for (const Row& row : rows) {
+			text += row.time + "," + row.x + "," + row.y + "," + row.heading + "," + row.speed + ","
+					+ row.acceleration + "," + row.curvature + "\n";
+		}
+		return text;
+	}
+
+	//! The same trajectory encoded point by point, from the values strtod gives for the fields
+	std::vector<char> encodeRows(const std::vector<Row>& rows) {
+		std::vector<char> buffer(getEncodedSizeTRAJMessage(static_cast<uint32_t>(rows.size())));
+		char* p = buffer.data();
+		ssize_t length = encodeTRAJMessageHeader(&inputHeader, 7, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, "imported",
+												 8, static_cast<uint32_t>(rows.size()), p, buffer.size(), false);
+		EXPECT_GT(length, 0);
+		p += length;
+		for (const Row& row : rows) {
+			const double time = std::strtod(row.time.c_str(), nullptr);
+			struct timeval pointTime = { static_cast<time_t>(time),
+										 static_cast<suseconds_t>(std::lround((time - std::floor(time)) * 1e6)) };
+			CartesianPosition position = {};
+			SpeedType speed = {};
+			AccelerationType acceleration = {};
+			position.xCoord_m = std::strtod(row.x.c_str(), nullptr);
+			position.yCoord_m = std::strtod(row.y.c_str(), nullptr);
+			position.heading_rad = std::strtod(row.heading.c_str(), nullptr);
+			position.isPositionValid = position.isHeadingValid = true;
+			speed.longitudinal_m_s = std::strtod(row.speed.c_str(), nullptr);
+			speed.isLongitudinalValid = true;
+			acceleration.longitudinal_m_s2 = std::strtod(row.acceleration.c_str(), nullptr);
+			acceleration.isLongitudinalValid = !row.acceleration.empty();
+			length = encodeTRAJMessagePoint(&pointTime, position, speed, acceleration,
+											static_cast<float>(std::strtod(row.curvature.c_str(), nullptr)), p,
+											buffer.data() + buffer.size() - p, false);
+			EXPECT_GT(length, 0);
+			p += length;
+		}
+		length = encodeTRAJMessageFooter(p, buffer.data() + buffer.size() - p, false);
+		EXPECT_GT(length, 0);
+		return buffer;
+	}
+
+	ssize_t import(const std::string& text, const TrajectoryImportOptionsType* options) {
+		free(message);
+		message = nullptr;
+		return importTrajectoryText(text.data(), text.size(), options, &inputHeader, 7,
+									TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, "imported", 8, &message, &statistics);
+	}
+
+	MessageHeaderType inputHeader;
+	char* message = nullptr;
+	TrajectoryImportStatisticsType statistics;
+};
+
+TEST_F(TrajectoryImport, MatchesPointByPointEncoding) {
+	const auto rows = drivingRows(20000);
+	const std::string text = toText(rows);
+	const auto expected = encodeRows(rows);
+	TrajectoryImportOptionsType options = {};
+
+	for (unsigned int nThreads : { 1U, 4U }) {
+		options.nThreads = nThreads;
+		ASSERT_EQ(static_cast<ssize_t>(expected.size()), import(text, &options));
+		EXPECT_EQ(expected, std::vector<char>(message, message + expected.size())) << nThreads << " threads";
+		EXPECT_EQ(20002U, statistics.nLines);
+		EXPECT_EQ(20000U, statistics.nPoints);
+		EXPECT_EQ(0U, statistics.errorLine);
+	}
+
+	HeaderType header;
+	EXPECT_EQ(static_cast<ssize_t>(expected.size()), validateISOFrame(message, expected.size(), &header));
+}
+
+TEST_F(TrajectoryImport, GivenColumnsAndDelimiter) {
+	const std::string text = "t;x;y;v;heading\n"
+							 "0.0; 1.5 ;2.25;3.0;90\n"
+							 "\n"
+							 "0.5;-1.5;2.5;3.5;\r\n"
+							 "# pause\n"
+							 "1.0;-2.0;3.0;4.0;-90\n";
+	TrajectoryImportOptionsType options = {};
+	options.delimiter = ';';
+	options.nColumns = 5;
+	options.columns[0] = TRAJECTORY_COLUMN_TIME_S;
+	options.columns[1] = TRAJECTORY_COLUMN_X_M;
+	options.columns[2] = TRAJECTORY_COLUMN_Y_M;
+	options.columns[3] = TRAJECTORY_COLUMN_LONGITUDINAL_SPEED_M_S;
+	options.columns[4] = TRAJECTORY_COLUMN_HEADING_DEG;
+
+	const ssize_t length = import(text, &options);
+	ASSERT_EQ(static_cast<ssize_t>(getEncodedSizeTRAJMessage(3)), length);
+	EXPECT_EQ(6U, statistics.nLines);
+	EXPECT_EQ(3U, statistics.nPoints);
+
+	TrajectoryHeaderType trajectoryHeader;
+	TrajectoryWaypointType points[3];
+	ssize_t offset = decodeTRAJMessageHeader(&trajectoryHeader, message, static_cast<size_t>(length), false);
+	ASSERT_GT(offset, 0);
+	EXPECT_EQ(3U, trajectoryHeader.nWaypoints);
+	for (auto& point : points) {
+		const ssize_t pointLength = decodeTRAJMessagePointBounded(&point, message + offset, length - offset, false);
+		ASSERT_GT(pointLength, 0);
+		offset += pointLength;
+	}
+	EXPECT_EQ(500000, points[1].relativeTime.tv_usec);
+	EXPECT_NEAR(1.5, points[0].pos.xCoord_m, 1e-9);
+	EXPECT_NEAR(2.25, points[0].pos.yCoord_m, 1e-9);
+	EXPECT_NEAR(M_PI / 2.0, points[0].pos.heading_rad, 1e-3);
+	EXPECT_FALSE(points[1].pos.isHeadingValid);
+	EXPECT_NEAR(3.0 * M_PI / 2.0, points[2].pos.heading_rad, 1e-3);
+	EXPECT_NEAR(3.5, points[1].spd.longitudinal_m_s, 1e-9);
+	EXPECT_FALSE(points[2].spd.isLateralValid);
+	EXPECT_FALSE(points[2].acc.isLongitudinalValid);
+}
+
+TEST_F(TrajectoryImport, ReportsFirstBadLine) {
+	auto rows = drivingRows(20000);
+	rows[15000].y = "12.5m";
+	rows[17000].speed = "";
+	TrajectoryImportOptionsType options = {};
+	options.nThreads = 4;
+
+	errno = 0;
+	EXPECT_EQ(-1, import(toText(rows), &options));
+	EXPECT_EQ(EBADMSG, errno);
+	EXPECT_EQ(nullptr, message);
+	EXPECT_EQ(15003U, statistics.errorLine);
+
+	rows[15000].y = "12.5";
+	EXPECT_EQ(-1, import(toText(rows), &options));
+	EXPECT_EQ(17003U, statistics.errorLine);
+}
+
+TEST_F(TrajectoryImport, RejectsMissingRequiredColumn) {
+	errno = 0;
+	EXPECT_EQ(-1, import("time,x,y,heading\n0,1,2,0\n", nullptr));
+	EXPECT_EQ(EINVAL, errno);
+
+	errno = 0;
+	EXPECT_EQ(-1, import("0,1,2,3\n", nullptr));
+	EXPECT_EQ(EINVAL, errno);
+
+	errno = 0;
+	EXPECT_EQ(-1, import("time,x,y,speed\n-1,1,2,3\n", nullptr));
+	EXPECT_EQ(EBADMSG, errno);
+	EXPECT_EQ(2U, statistics.errorLine);
+}
+
+TEST_F(TrajectoryImport, ImportsFile) {
+	const auto rows = drivingRows(1000);
+	const std::string text = toText(rows);
+	char path[64];
+	snprintf(path, sizeof(path), "/tmp/trajectoryimport_%d.csv", getpid());
+	FILE* file = fopen(path, "w");
+	ASSERT_NE(nullptr, file);
+	fwrite(text.data(), 1, text.size(), file);
+	fclose(file);
+
+	const auto expected = encodeRows(rows);
+	ASSERT_EQ(static_cast<ssize_t>(expected.size()),
+			  importTrajectoryFile(path, nullptr, &inputHeader, 7, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, "imported", 8,
+								   &message, &statistics));
+	EXPECT_EQ(expected, std::vector<char>(message, message + expected.size()));
+	unlink(path);
+
+	errno = 0;
+	free(message);
+	message = nullptr;
+	EXPECT_EQ(-1, importTrajectoryFile(path, nullptr, &inputHeader, 7, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, nullptr,
+									   0, &message, &statistics));
+	EXPECT_EQ(ENOENT, errno);
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "trajectoryindex.h"
+}
+
+class TrajectoryIndex : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		// Every 100 ms, accelerating along x while the heading turns through north
+		for (int i = 0; i < 50; ++i) {
+			TrajectoryWaypointType waypoint = {};
+			waypoint.relativeTime = { i / 10, (i % 10) * 100000 };
+			waypoint.pos.xCoord_m = i * 1.0;
+			waypoint.pos.yCoord_m = -i * 0.5;
+			waypoint.pos.zCoord_m = 0.25;
+			waypoint.pos.heading_rad = std::fmod(2.0 * M_PI - 0.5 + i * 0.04, 2.0 * M_PI);
+			waypoint.pos.isXcoordValid = waypoint.pos.isYcoordValid = waypoint.pos.isZcoordValid = true;
+			waypoint.pos.isPositionValid = waypoint.pos.isHeadingValid = true;
+			waypoint.spd.longitudinal_m_s = 10.0 + i * 0.2;
+			waypoint.spd.isLongitudinalValid = true;
+			waypoint.spd.isLateralValid = i != 20;
+			waypoint.acc.longitudinal_m_s2 = 2.0;
+			waypoint.acc.isLongitudinalValid = true;
+			waypoint.curvature = 0.001f * i;
+			waypoints.push_back(waypoint);
+		}
+		index = createTrajectoryIndex(waypoints.data(), waypoints.size());
+		ASSERT_NE(nullptr, index);
+	}
+	void TearDown() override {
+		freeTrajectoryIndex(index);
+	}
+
+	std::vector<TrajectoryWaypointType> waypoints;
+	TrajectoryIndexType* index;
+};
+
+TEST_F(TrajectoryIndex, InterpolatesBetweenWaypoints) {
+	const struct timeval time = { 1, 225000 };
+	TrajectoryWaypointType point;
+	ASSERT_EQ(0, getTrajectoryPointAt(index, &time, &point));
+	EXPECT_EQ(1, point.relativeTime.tv_sec);
+	EXPECT_EQ(225000, point.relativeTime.tv_usec);
+	EXPECT_DOUBLE_EQ(12.25, point.pos.xCoord_m);
+	EXPECT_DOUBLE_EQ(-6.125, point.pos.yCoord_m);
+	EXPECT_DOUBLE_EQ(0.25, point.pos.zCoord_m);
+	EXPECT_NEAR(2.0 * M_PI - 0.5 + 12.25 * 0.04, point.pos.heading_rad, 1e-9);
+	EXPECT_NEAR(12.45, point.spd.longitudinal_m_s, 1e-9);
+	EXPECT_DOUBLE_EQ(2.0, point.acc.longitudinal_m_s2);
+	EXPECT_NEAR(0.01225, point.curvature, 1e-6);
+	EXPECT_TRUE(point.pos.isPositionValid && point.pos.isHeadingValid && point.spd.isLongitudinalValid);
+	EXPECT_TRUE(point.spd.isLateralValid);
+	EXPECT_FALSE(point.acc.isLateralValid);
+
+	// Invalid at either end of the segment makes the interpolated field invalid
+	const struct timeval nearInvalid = { 1, 950000 };
+	ASSERT_EQ(0, getTrajectoryPointAt(index, &nearInvalid, &point));
+	EXPECT_FALSE(point.spd.isLateralValid);
+}
+
+TEST_F(TrajectoryIndex, InterpolatesHeadingAcrossNorth) {
+	// Waypoint 12 is just below 2π and waypoint 13 just above 0
+	const struct timeval time = { 1, 250000 };
+	TrajectoryWaypointType point;
+	ASSERT_EQ(0, getTrajectoryPointAt(index, &time, &point));
+	EXPECT_NEAR(0.0, point.pos.heading_rad, 1e-9);
+	const struct timeval later = { 1, 260000 };
+	ASSERT_EQ(0, getTrajectoryPointAt(index, &later, &point));
+	EXPECT_NEAR(0.004, point.pos.heading_rad, 1e-9);
+	EXPECT_GE(point.pos.heading_rad, 0.0);
+}
+
+TEST_F(TrajectoryIndex, ClampsTimesOutsideTrajectory) {
+	TrajectoryWaypointType point;
+	const struct timeval before = { -1, 0 };
+	errno = 0;
+	EXPECT_EQ(-1, getTrajectoryPointAt(index, &before, &point));
+	EXPECT_EQ(ERANGE, errno);
+	EXPECT_DOUBLE_EQ(0.0, point.pos.xCoord_m);
+	EXPECT_EQ(0, point.relativeTime.tv_sec);
+
+	const struct timeval end = { 4, 900000 };
+	EXPECT_EQ(0, getTrajectoryPointAt(index, &end, &point));
+	EXPECT_DOUBLE_EQ(49.0, point.pos.xCoord_m);
+	const struct timeval after = { 10, 0 };
+	EXPECT_EQ(-1, getTrajectoryPointAt(index, &after, &point));
+	EXPECT_DOUBLE_EQ(49.0, point.pos.xCoord_m);
+}
+
+TEST_F(TrajectoryIndex, CursorMatchesBinarySearch) {
+	TrajectoryCursorType cursor;
+	initTrajectoryCursor(&cursor, index);
+	// Mostly increasing with jumps in both directions
+	const int64_t times_us[] = { 0, 1000, 99999, 100000, 150000, 1650000, 1660000, 4900000, 2000000, 300000,
+								 310000, 4899999, 5000000, -5 };
+	for (const int64_t time_us : times_us) {
+		const struct timeval time = { static_cast<time_t>(time_us / 1000000),
+									  static_cast<suseconds_t>(time_us % 1000000) };
+		TrajectoryWaypointType expected, actual;
+		const int expectedResult = getTrajectoryPointAt(index, &time, &expected);
+		EXPECT_EQ(expectedResult, getTrajectoryPointAtCursor(&cursor, &time, &actual)) << time_us;
+		EXPECT_DOUBLE_EQ(expected.pos.xCoord_m, actual.pos.xCoord_m) << time_us;
+		EXPECT_DOUBLE_EQ(expected.spd.longitudinal_m_s, actual.spd.longitudinal_m_s) << time_us;
+	}
+}
+
+TEST_F(TrajectoryIndex, BatchEvaluatesManyTimes) {
+	std::vector<struct timeval> times;
+	for (int i = -2; i < 600; ++i) {
+		times.push_back({ i / 100, (i % 100) * 10000 });
+	}
+	std::vector<TrajectoryWaypointType> points(times.size());
+	// Times from -20 ms, and after 4.9 s, are outside
+	EXPECT_EQ(491u, getTrajectoryPointsAt(index, times.data(), times.size(), points.data()));
+	for (size_t i = 0; i < times.size(); ++i) {
+		TrajectoryWaypointType expected;
+		getTrajectoryPointAt(index, &times[i], &expected);
+		EXPECT_DOUBLE_EQ(expected.pos.yCoord_m, points[i].pos.yCoord_m) << i;
+		EXPECT_DOUBLE_EQ(expected.pos.heading_rad, points[i].pos.heading_rad) << i;
+	}
+}
+
+TEST_F(TrajectoryIndex, HandlesDegenerateTrajectories) {
+	errno = 0;
+	EXPECT_EQ(nullptr, createTrajectoryIndex(waypoints.data(), 0));
+	EXPECT_EQ(EINVAL, errno);
+	std::vector<TrajectoryWaypointType> decreasing = waypoints;
+	decreasing[10].relativeTime = { 0, 0 };
+	EXPECT_EQ(nullptr, createTrajectoryIndex(decreasing.data(), decreasing.size()));
+
+	TrajectoryIndexType* single = createTrajectoryIndex(&waypoints[3], 1);
+	ASSERT_NE(nullptr, single);
+	TrajectoryWaypointType point;
+	EXPECT_EQ(0, getTrajectoryPointAt(single, &waypoints[3].relativeTime, &point));
+	EXPECT_DOUBLE_EQ(3.0, point.pos.xCoord_m);
+	TrajectoryCursorType cursor;
+	initTrajectoryCursor(&cursor, single);
+	const struct timeval later = { 1, 0 };
+	EXPECT_EQ(-1, getTrajectoryPointAtCursor(&cursor, &later, &point));
+	EXPECT_DOUBLE_EQ(3.0, point.pos.xCoord_m);
+	freeTrajectoryIndex(single);
+}
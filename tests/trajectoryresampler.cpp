@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cmath>
+#include <vector>
+extern "C" {
+#include "trajectoryresampler.h"
+#include "frame.h"
+#include "iso22133.h"
+}
+
+class TrajectoryResampler : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		resampler = createTrajectoryResampler();
+		ASSERT_NE(nullptr, resampler);
+	}
+
+	void TearDown() override {
+		freeTrajectoryResampler(resampler);
+	}
+
+	//! Raw trajectory with the given positions at unevenly spaced times of about 1 ms
+	template<typename Position>
+	void makeInput(const double duration_s, Position position) {
+		time_us.clear();
+		x.clear();
+		y.clear();
+		for (int64_t t = 0; t < static_cast<int64_t>(duration_s * 1e6); t += 800 + (t / 1000 % 7) * 100) {
+			time_us.push_back(t);
+		}
+		time_us.push_back(static_cast<int64_t>(duration_s * 1e6));
+		for (int64_t t : time_us) {
+			double px, py;
+			position(static_cast<double>(t) / 1e6, px, py);
+			x.push_back(px);
+			y.push_back(py);
+		}
+		input = {};
+		input.nPoints = time_us.size();
+		input.time_us = time_us.data();
+		input.x_m = x.data();
+		input.y_m = y.data();
+	}
+
+	TrajectoryResamplerType* resampler;
+	std::vector<int64_t> time_us;
+	std::vector<double> x, y;
+	TrajectoryColumnsType input, output;
+};
+
+TEST_F(TrajectoryResampler, CircleAtFixedTimeStep) {
+	const double radius = 20.0, speed = 5.0;
+	makeInput(10.0, [&](double t, double& px, double& py) {
+		px = radius * std::cos(speed * t / radius);
+		py = radius * std::sin(speed * t / radius);
+	});
+	const TrajectoryResampleOptionsType options = { TRAJECTORY_RESAMPLE_TIME, 0.1 };
+
+	ASSERT_EQ(101, resampleTrajectory(resampler, &input, &options, &output));
+	ASSERT_EQ(101U, output.nPoints);
+	for (size_t i = 0; i < output.nPoints; ++i) {
+		const double t = static_cast<double>(i) * 0.1;
+		EXPECT_EQ(static_cast<int64_t>(i) * 100000, output.time_us[i]);
+		EXPECT_NEAR(radius * std::cos(speed * t / radius), output.x_m[i], 1e-6);
+		// End points are one sided and less accurate
+		const double tolerance = i == 0 || i + 1 == output.nPoints ? 50.0 : 1.0;
+		EXPECT_NEAR(speed, output.longitudinalSpeed_m_s[i], 1e-3 * tolerance) << i;
+		EXPECT_NEAR(0.0, output.lateralSpeed_m_s[i], 1e-12);
+		EXPECT_NEAR(std::fmod(speed * t / radius + M_PI / 2.0, 2.0 * M_PI), output.heading_rad[i],
+					1e-4 * tolerance) << i;
+		EXPECT_NEAR(1.0 / radius, output.curvature[i], 1e-4 * tolerance) << i;
+		EXPECT_NEAR(speed * speed / radius, output.lateralAcceleration_m_s2[i], 1e-3 * tolerance) << i;
+		EXPECT_NEAR(0.0, output.longitudinalAcceleration_m_s2[i], 1e-3 * tolerance) << i;
+	}
+}
+
+TEST_F(TrajectoryResampler, AcceleratingAtFixedDistanceStep) {
+	const double acceleration = 2.0;
+	makeInput(10.0, [&](double t, double& px, double& py) {
+		px = 0.5 * acceleration * t * t;
+		py = -px;
+	});
+	const TrajectoryResampleOptionsType options = { TRAJECTORY_RESAMPLE_DISTANCE, 1.0 };
+	const double length = 100.0 * std::sqrt(2.0);
+
+	const ssize_t nPoints = resampleTrajectory(resampler, &input, &options, &output);
+	ASSERT_EQ(static_cast<ssize_t>(std::floor(length)) + 2, nPoints);
+	for (ssize_t i = 1; i < nPoints; ++i) {
+		const double step = std::hypot(output.x_m[i] - output.x_m[i - 1], output.y_m[i] - output.y_m[i - 1]);
+		EXPECT_NEAR(i + 1 < nPoints ? 1.0 : length - std::floor(length), step, 1e-9) << i;
+	}
+	for (ssize_t i = 2; i + 2 < nPoints; ++i) {
+		const double t = static_cast<double>(output.time_us[i]) / 1e6;
+		EXPECT_NEAR(std::sqrt(2.0) * acceleration * t, output.longitudinalSpeed_m_s[i], 1e-3) << i;
+		EXPECT_NEAR(std::sqrt(2.0) * acceleration, output.longitudinalAcceleration_m_s2[i], 1e-2) << i;
+		EXPECT_NEAR(7.0 * M_PI / 4.0, output.heading_rad[i], 1e-9) << i;
+		EXPECT_NEAR(0.0, output.curvature[i], 1e-6) << i;
+	}
+	EXPECT_EQ(10000000, output.time_us[nPoints - 1]);
+}
+
+TEST_F(TrajectoryResampler, HoldsHeadingAtStandstill) {
+	makeInput(3.0, [](double t, double& px, double& py) {
+		px = 1.0;
+		py = t < 1.0 ? 0.0 : -(t - 1.0) * (t - 1.0);
+	});
+	const TrajectoryResampleOptionsType options = { TRAJECTORY_RESAMPLE_TIME, 0.25 };
+
+	ASSERT_EQ(13, resampleTrajectory(resampler, &input, &options, &output));
+	for (size_t i = 0; i < output.nPoints; ++i) {
+		EXPECT_NEAR(3.0 * M_PI / 2.0, output.heading_rad[i], 1e-9) << i;
+		EXPECT_TRUE(std::isfinite(output.curvature[i]));
+	}
+	EXPECT_DOUBLE_EQ(0.0, output.longitudinalSpeed_m_s[1]);
+	EXPECT_NEAR(2.0, output.longitudinalAcceleration_m_s2[10], 1e-2);
+}
+
+TEST_F(TrajectoryResampler, IncludesEndOffStep) {
+	makeInput(1.05, [](double t, double& px, double& py) {
+		px = t;
+		py = 0.0;
+	});
+	TrajectoryResampleOptionsType options = { TRAJECTORY_RESAMPLE_TIME, 0.1 };
+
+	ASSERT_EQ(12, resampleTrajectory(resampler, &input, &options, &output));
+	EXPECT_EQ(1000000, output.time_us[10]);
+	EXPECT_EQ(1050000, output.time_us[11]);
+	EXPECT_NEAR(1.0, output.longitudinalSpeed_m_s[11], 1e-9);
+
+	options.mode = TRAJECTORY_RESAMPLE_NONE;
+	ASSERT_EQ(static_cast<ssize_t>(time_us.size()), resampleTrajectory(resampler, &input, &options, &output));
+	EXPECT_EQ(time_us, std::vector<int64_t>(output.time_us, output.time_us + output.nPoints));
+}
+
+TEST_F(TrajectoryResampler, MergesTinyEndRemainder) {
+	makeInput(1.005, [](double t, double& px, double& py) {
+		px = t;
+		py = 0.0;
+	});
+	const TrajectoryResampleOptionsType options = { TRAJECTORY_RESAMPLE_TIME, 0.1 };
+
+	ASSERT_EQ(11, resampleTrajectory(resampler, &input, &options, &output));
+	EXPECT_EQ(900000, output.time_us[9]);
+	EXPECT_EQ(time_us.back(), output.time_us[10]);
+	EXPECT_NEAR(1.0, output.longitudinalSpeed_m_s[10], 1e-9);
+	EXPECT_NEAR(0.0, output.longitudinalAcceleration_m_s2[10], 1e-6);
+}
+
+TEST_F(TrajectoryResampler, ZeroLengthGivesSinglePoint) {
+	for (const auto mode : { TRAJECTORY_RESAMPLE_TIME, TRAJECTORY_RESAMPLE_DISTANCE }) {
+		const TrajectoryResampleOptionsType options = { mode, 0.5 };
+
+		makeInput(0.0, [](double, double& px, double& py) {
+			px = 3.0;
+			py = -4.0;
+		});
+		ASSERT_EQ(1U, input.nPoints);
+		ASSERT_EQ(1, resampleTrajectory(resampler, &input, &options, &output)) << mode;
+		ASSERT_EQ(1U, output.nPoints);
+		EXPECT_EQ(0, output.time_us[0]);
+		EXPECT_DOUBLE_EQ(3.0, output.x_m[0]);
+		EXPECT_DOUBLE_EQ(-4.0, output.y_m[0]);
+		EXPECT_DOUBLE_EQ(0.0, output.z_m[0]);
+		EXPECT_DOUBLE_EQ(0.0, output.longitudinalSpeed_m_s[0]);
+		EXPECT_DOUBLE_EQ(0.0, output.longitudinalAcceleration_m_s2[0]);
+		EXPECT_DOUBLE_EQ(0.0, output.lateralAcceleration_m_s2[0]);
+		EXPECT_DOUBLE_EQ(0.0, output.heading_rad[0]);
+		EXPECT_FLOAT_EQ(0.0f, output.curvature[0]);
+
+		makeInput(2.0, [](double, double& px, double& py) {
+			px = 3.0;
+			py = -4.0;
+		});
+		const ssize_t nPoints = resampleTrajectory(resampler, &input, &options, &output);
+		if (mode == TRAJECTORY_RESAMPLE_TIME) {
+			EXPECT_EQ(5, nPoints);
+			continue;
+		}
+		// A trajectory which does not move has no arc length
+		ASSERT_EQ(1, nPoints);
+		EXPECT_EQ(0, output.time_us[0]);
+		EXPECT_DOUBLE_EQ(3.0, output.x_m[0]);
+		EXPECT_DOUBLE_EQ(-4.0, output.y_m[0]);
+		EXPECT_DOUBLE_EQ(0.0, output.z_m[0]);
+		EXPECT_DOUBLE_EQ(0.0, output.longitudinalSpeed_m_s[0]);
+		EXPECT_FLOAT_EQ(0.0f, output.curvature[0]);
+	}
+}
+
+TEST_F(TrajectoryResampler, RejectsInvalidInput) {
+	makeInput(1.0, [](double t, double& px, double& py) {
+		px = t;
+		py = 0.0;
+	});
+	TrajectoryResampleOptionsType options = { TRAJECTORY_RESAMPLE_DISTANCE, 0.0 };
+
+	errno = 0;
+	EXPECT_EQ(-1, resampleTrajectory(resampler, &input, &options, &output));
+	EXPECT_EQ(EINVAL, errno);
+
+	options.step = 0.1;
+	time_us[5] = time_us[4];
+	errno = 0;
+	EXPECT_EQ(-1, resampleTrajectory(resampler, &input, &options, &output));
+	EXPECT_EQ(EINVAL, errno);
+}
+
+TEST_F(TrajectoryResampler, EncodesColumnsAsTRAJ) {
+	makeInput(5.0, [](double t, double& px, double& py) {
+		px = 3.0 * t;
+		py = 10.0 * std::sin(t);
+	});
+	const TrajectoryResampleOptionsType options = { TRAJECTORY_RESAMPLE_TIME, 0.05 };
+	ASSERT_EQ(101, resampleTrajectory(resampler, &input, &options, &output));
+
+	MessageHeaderType inputHeader = {};
+	std::vector<char> buffer(getEncodedSizeTRAJMessage(101));
+	errno = 0;
+	EXPECT_EQ(-1, encodeTRAJMessageColumns(&inputHeader, 3, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, "resampled", 9,
+										   &output, buffer.data(), buffer.size() - 1, false));
+	EXPECT_EQ(ENOBUFS, errno);
+	ASSERT_EQ(static_cast<ssize_t>(buffer.size()),
+			  encodeTRAJMessageColumns(&inputHeader, 3, TRAJECTORY_INFO_RELATIVE_TO_ORIGIN, "resampled", 9, &output,
+									   buffer.data(), buffer.size(), false));
+	HeaderType header;
+	EXPECT_EQ(static_cast<ssize_t>(buffer.size()), validateISOFrame(buffer.data(), buffer.size(), &header));
+
+	TrajectoryHeaderType trajectoryHeader;
+	ssize_t offset = decodeTRAJMessageHeader(&trajectoryHeader, buffer.data(), buffer.size(), false);
+	ASSERT_GT(offset, 0);
+	ASSERT_EQ(101U, trajectoryHeader.nWaypoints);
+	for (size_t i = 0; i < 101; ++i) {
+		TrajectoryWaypointType point;
+		const ssize_t length = decodeTRAJMessagePointBounded(&point, buffer.data() + offset,
+															 buffer.size() - offset, false);
+		ASSERT_GT(length, 0);
+		offset += length;
+		EXPECT_EQ(output.time_us[i], point.relativeTime.tv_sec * 1000000 + point.relativeTime.tv_usec);
+		EXPECT_NEAR(output.x_m[i], point.pos.xCoord_m, 1e-3);
+		EXPECT_NEAR(output.y_m[i], point.pos.yCoord_m, 1e-3);
+		EXPECT_NEAR(output.heading_rad[i], point.pos.heading_rad, 1e-3);
+		EXPECT_NEAR(output.longitudinalSpeed_m_s[i], point.spd.longitudinal_m_s, 1e-2);
+		EXPECT_NEAR(output.lateralAcceleration_m_s2[i], point.acc.lateral_m_s2, 1e-2);
+		EXPECT_FLOAT_EQ(output.curvature[i], point.curvature);
+	}
+}
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <vector>
+extern "C" {
+#include "trajectorysimplifier.h"
+}
+#include "testtrajectories.h"
+
+class TrajectorySimplifier : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		options.position_m = 0.02;
+		options.speed_m_s = 0.05;
+		options.curvature = 0.001;
+		options.nThreads = 4;
+	}
+
+	static TrajectoryWaypointType waypoint(const int i, const double x, const double y, const double speed,
+										   const float curvature) {
+		TrajectoryWaypointType point = {};
+		point.relativeTime = { i / 100, (i % 100) * 10000 };
+		point.pos.xCoord_m = x;
+		point.pos.yCoord_m = y;
+		point.pos.isPositionValid = true;
+		point.spd.longitudinal_m_s = speed;
+		point.spd.isLongitudinalValid = true;
+		point.curvature = curvature;
+		return point;
+	}
+
+	//! Largest errors of a simplified trajectory, interpolated at the time of each original point
+	static TrajectorySimplificationStatisticsType measureErrors(const std::vector<TrajectoryWaypointType>& original,
+																const TrajectoryWaypointType* simplified,
+																const size_t nSimplified) {
+		TrajectorySimplificationStatisticsType errors = {};
+		size_t j = 0;
+		for (const auto& point : original) {
+			const double t = point.relativeTime.tv_sec + point.relativeTime.tv_usec * 1e-6;
+			while (j + 2 < nSimplified && simplified[j + 1].relativeTime.tv_sec
+				   + simplified[j + 1].relativeTime.tv_usec * 1e-6 <= t) {
+				j++;
+			}
+			const TrajectoryWaypointType& a = simplified[j];
+			const TrajectoryWaypointType& b = simplified[j + 1];
+			const double ta = a.relativeTime.tv_sec + a.relativeTime.tv_usec * 1e-6;
+			const double tb = b.relativeTime.tv_sec + b.relativeTime.tv_usec * 1e-6;
+			const double f = tb > ta ? (t - ta) / (tb - ta) : 0.0;
+			errors.maxPositionError_m = std::max(errors.maxPositionError_m,
+												 std::hypot(a.pos.xCoord_m + f * (b.pos.xCoord_m - a.pos.xCoord_m) - point.pos.xCoord_m,
+															a.pos.yCoord_m + f * (b.pos.yCoord_m - a.pos.yCoord_m) - point.pos.yCoord_m));
+			errors.maxSpeedError_m_s = std::max(errors.maxSpeedError_m_s, std::fabs(
+													a.spd.longitudinal_m_s + f * (b.spd.longitudinal_m_s - a.spd.longitudinal_m_s)
+													- point.spd.longitudinal_m_s));
+			errors.maxCurvatureError = std::max(errors.maxCurvatureError, std::fabs(
+													a.curvature + f * (b.curvature - a.curvature) - point.curvature));
+		}
+		return errors;
+	}
+
+	TrajectorySimplificationOptionsType options;
+};
+
+TEST_F(TrajectorySimplifier, ReducesStraightLineToEnds) {
+	std::vector<TrajectoryWaypointType> waypoints;
+	for (int i = 0; i < 10000; ++i) {
+		waypoints.push_back(waypoint(i, 0.1 * i, -0.05 * i, 10.0, 0.0f));
+	}
+	std::vector<TrajectoryWaypointType> simplified(waypoints.size());
+	TrajectorySimplificationStatisticsType statistics;
+
+	// Chunk ends are kept
+	const ssize_t nKept = simplifyTrajectory(waypoints.data(), waypoints.size(), &options, simplified.data(), &statistics);
+	ASSERT_LE(2, nKept);
+	EXPECT_GE(4, nKept);
+	EXPECT_EQ(0, simplified[0].relativeTime.tv_sec);
+	EXPECT_EQ(99, simplified[static_cast<size_t>(nKept) - 1].relativeTime.tv_sec);
+	EXPECT_EQ(10000u, statistics.nInputPoints);
+	EXPECT_EQ(static_cast<size_t>(nKept), statistics.nOutputPoints);
+	EXPECT_DOUBLE_EQ(10000.0 / nKept, statistics.compressionRatio);
+	EXPECT_NEAR(0.0, statistics.maxPositionError_m, 1e-9);
+}
+
+TEST_F(TrajectorySimplifier, KeepsErrorsWithinTolerance) {
+	const auto waypoints = drivingTrajectory(30000);
+	std::vector<TrajectoryWaypointType> simplified(waypoints.size());
+	TrajectorySimplificationStatisticsType statistics;
+
+	const ssize_t nKept = simplifyTrajectory(waypoints.data(), waypoints.size(), &options, simplified.data(), &statistics);
+	ASSERT_GT(nKept, 2);
+	EXPECT_GT(statistics.compressionRatio, 10.0);
+
+	const auto errors = measureErrors(waypoints, simplified.data(), static_cast<size_t>(nKept));
+	EXPECT_LE(errors.maxPositionError_m, options.position_m);
+	EXPECT_LE(errors.maxSpeedError_m_s, options.speed_m_s);
+	EXPECT_LE(errors.maxCurvatureError, options.curvature);
+	EXPECT_NEAR(errors.maxPositionError_m, statistics.maxPositionError_m, 1e-9);
+	EXPECT_NEAR(errors.maxSpeedError_m_s, statistics.maxSpeedError_m_s, 1e-9);
+	EXPECT_NEAR(errors.maxCurvatureError, statistics.maxCurvatureError, 1e-6);
+
+	// Ignoring speed and curvature allows fewer points
+	options.speed_m_s = INFINITY;
+	options.curvature = INFINITY;
+	TrajectorySimplificationStatisticsType pathStatistics;
+	ASSERT_LT(simplifyTrajectory(waypoints.data(), waypoints.size(), &options, simplified.data(), &pathStatistics), nKept);
+	EXPECT_LE(pathStatistics.maxPositionError_m, options.position_m);
+}
+
+TEST_F(TrajectorySimplifier, KeepsTiming) {
+	// Stops halfway along a straight line, which does not change the path
+	std::vector<TrajectoryWaypointType> waypoints;
+	for (int i = 0; i < 3000; ++i) {
+		const double x = i < 1000 ? 0.1 * i : i < 2000 ? 100.0 : 0.1 * (i - 1000);
+		waypoints.push_back(waypoint(i, x, 0.0, 0.0, 0.0f));
+		waypoints.back().spd.isLongitudinalValid = false;
+	}
+	std::vector<TrajectoryWaypointType> simplified(waypoints.size());
+
+	const ssize_t nKept = simplifyTrajectory(waypoints.data(), waypoints.size(), &options, simplified.data(), nullptr);
+	ASSERT_EQ(4, nKept);
+	EXPECT_EQ(10, simplified[1].relativeTime.tv_sec);
+	EXPECT_EQ(20, simplified[2].relativeTime.tv_sec);
+	EXPECT_EQ(0, simplified[2].relativeTime.tv_usec);
+}
+
+TEST_F(TrajectorySimplifier, ResultDoesNotDependOnThreads) {
+	auto waypoints = drivingTrajectory(50000);
+	std::vector<TrajectoryWaypointType> parallel(waypoints.size()), serial(waypoints.size());
+
+	const ssize_t nParallel = simplifyTrajectory(waypoints.data(), waypoints.size(), &options, parallel.data(), nullptr);
+	options.nThreads = 1;
+	const ssize_t nSerial = simplifyTrajectory(waypoints.data(), waypoints.size(), &options, serial.data(), nullptr);
+	ASSERT_EQ(nSerial, nParallel);
+	for (ssize_t i = 0; i < nSerial; ++i) {
+		ASSERT_EQ(0, std::memcmp(&serial[static_cast<size_t>(i)], &parallel[static_cast<size_t>(i)],
+								 sizeof (TrajectoryWaypointType)));
+	}
+
+	// In place
+	ASSERT_EQ(nSerial, simplifyTrajectory(waypoints.data(), waypoints.size(), &options, waypoints.data(), nullptr));
+	EXPECT_EQ(0, std::memcmp(serial.data(), waypoints.data(), static_cast<size_t>(nSerial) * sizeof (TrajectoryWaypointType)));
+}
+
+TEST_F(TrajectorySimplifier, RejectsInvalidTrajectories) {
+	std::vector<TrajectoryWaypointType> waypoints = { waypoint(0, 0, 0, 1, 0), waypoint(2, 1, 0, 1, 0), waypoint(1, 2, 0, 1, 0) };
+	std::vector<TrajectoryWaypointType> simplified(waypoints.size());
+
+	EXPECT_EQ(-1, simplifyTrajectory(waypoints.data(), waypoints.size(), &options, simplified.data(), nullptr));
+	EXPECT_EQ(EINVAL, errno);
+	waypoints[2] = waypoint(3, 2, 0, 1, 0);
+	waypoints[1].pos.isPositionValid = false;
+	EXPECT_EQ(-1, simplifyTrajectory(waypoints.data(), waypoints.size(), &options, simplified.data(), nullptr));
+	EXPECT_EQ(-1, simplifyTrajectory(waypoints.data(), waypoints.size(), nullptr, simplified.data(), nullptr));
+
+	// Too short to simplify
+	EXPECT_EQ(0, simplifyTrajectory(waypoints.data(), 0, &options, simplified.data(), nullptr));
+	EXPECT_EQ(1, simplifyTrajectory(waypoints.data(), 1, &options, simplified.data(), nullptr));
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cstring>
+#include <endian.h>
+#include <string>
+#include <vector>
+extern "C" {
+#include "vendorregistry.h"
+#include "frame.h"
+#include "traj.h"
+}
+#include "testdefines.h"
+
+#define TEST_VENDOR_MESSAGE_ID 0xB123
+#define TEST_VENDOR_VALUE_ID 0xA010
+#define TEST_VENDOR_VALUE_ID_SPEED_LIMIT 0x0100
+
+struct SpeedLimitType {
+	uint16_t speedLimit_cm_s;
+};
+
+//! Encodes a single value with value ID, content length and content
+static ssize_t encodeSpeedLimit(const void* messageData, char* content, const size_t contentCapacity, void* userData) {
+	const uint16_t header[] = { htole16(TEST_VENDOR_VALUE_ID_SPEED_LIMIT), htole16(sizeof (uint16_t)) };
+	const uint16_t value = htole16(static_cast<const SpeedLimitType*>(messageData)->speedLimit_cm_s);
+	if (contentCapacity < sizeof (header) + sizeof (value)) {
+		return -1;
+	}
+	memcpy(content, header, sizeof (header));
+	memcpy(content + sizeof (header), &value, sizeof (value));
+	++*static_cast<int*>(userData);
+	return sizeof (header) + sizeof (value);
+}
+
+static int decodeSpeedLimit(const HeaderType* header, const char* content, const size_t contentLength,
+							void* messageData, void* userData) {
+	uint16_t valueID, value;
+	if (header->messageID != TEST_VENDOR_MESSAGE_ID || contentLength != 3 * sizeof (uint16_t)) {
+		return MESSAGE_LENGTH_ERROR;
+	}
+	memcpy(&valueID, content, sizeof (valueID));
+	if (le16toh(valueID) != TEST_VENDOR_VALUE_ID_SPEED_LIMIT) {
+		return MESSAGE_VALUE_ID_ERROR;
+	}
+	memcpy(&value, content + 2 * sizeof (uint16_t), sizeof (value));
+	static_cast<SpeedLimitType*>(messageData)->speedLimit_cm_s = le16toh(value);
+	++*static_cast<int*>(userData);
+	return MESSAGE_OK;
+}
+
+class VendorMessage : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		VendorMessageHandlerType handler = { encodeSpeedLimit, decodeSpeedLimit, &nCalls };
+		ASSERT_EQ(0, registerVendorMessage(TEST_VENDOR_MESSAGE_ID, &handler));
+	}
+	void TearDown() override {
+		unregisterVendorMessage(TEST_VENDOR_MESSAGE_ID);
+	}
+
+	ssize_t encode(const SpeedLimitType& data) {
+		MessageHeaderType header = { TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, TEST_DEFAULT_MESSAGE_COUNTER };
+		return encodeVendorMessage(&header, TEST_VENDOR_MESSAGE_ID, &data, buffer, sizeof (buffer), false);
+	}
+
+	int nCalls = 0;
+	char buffer[64];
+};
+
+TEST_F(VendorMessage, RoundTrip) {
+	const ssize_t length = encode({ 1389 });
+	ASSERT_EQ(static_cast<ssize_t>(sizeof (HeaderType) + 6 + sizeof (FooterType)), length);
+
+	HeaderType header;
+	ASSERT_EQ(length, validateISOFrame(buffer, static_cast<size_t>(length), &header));
+	EXPECT_EQ(TEST_VENDOR_MESSAGE_ID, header.messageID);
+	EXPECT_EQ(TEST_TRANSMITTER_ID_1, header.transmitterID);
+
+	SpeedLimitType decoded = {};
+	EXPECT_EQ(length, decodeVendorMessage(buffer, static_cast<size_t>(length), &decoded, false));
+	EXPECT_EQ(1389, decoded.speedLimit_cm_s);
+	EXPECT_EQ(2, nCalls);
+}
+
+TEST_F(VendorMessage, RejectsInvalidRegistrations) {
+	VendorMessageHandlerType handler = { encodeSpeedLimit, nullptr, nullptr };
+	errno = 0;
+	EXPECT_EQ(-1, registerVendorMessage(MESSAGE_ID_MONR, &handler));
+	EXPECT_EQ(EINVAL, errno);
+	EXPECT_EQ(-1, registerVendorMessage(MESSAGE_ID_VENDOR_SPECIFIC_UPPER_LIMIT + 1, &handler));
+	EXPECT_EQ(EINVAL, errno);
+	EXPECT_EQ(-1, registerVendorMessage(MESSAGE_ID_VENDOR_SPECIFIC_ASTAZERO_PODI, &handler));
+	EXPECT_EQ(EEXIST, errno);
+	EXPECT_EQ(-1, registerVendorMessage(TEST_VENDOR_MESSAGE_ID, &handler));
+	EXPECT_EQ(EEXIST, errno);
+	EXPECT_EQ(nullptr, getVendorMessageHandler(TEST_VENDOR_MESSAGE_ID + 1));
+	ASSERT_NE(nullptr, getVendorMessageHandler(TEST_VENDOR_MESSAGE_ID));
+	EXPECT_EQ(&nCalls, getVendorMessageHandler(TEST_VENDOR_MESSAGE_ID)->userData);
+}
+
+TEST_F(VendorMessage, ReportsErrors) {
+	const ssize_t length = encode({ 100 });
+	ASSERT_GT(length, 0);
+	SpeedLimitType decoded;
+
+	buffer[sizeof (HeaderType)] = 0x7F;
+	EXPECT_EQ(MESSAGE_CRC_ERROR, decodeVendorMessage(buffer, static_cast<size_t>(length), &decoded, false));
+
+	ASSERT_EQ(0, unregisterVendorMessage(TEST_VENDOR_MESSAGE_ID));
+	EXPECT_EQ(-1, unregisterVendorMessage(TEST_VENDOR_MESSAGE_ID));
+	EXPECT_EQ(-1, encode({ 100 }));
+	MessageHeaderType header = { TEST_TRANSMITTER_ID_1, TEST_DEFAULT_RECEIVER_ID, TEST_DEFAULT_MESSAGE_COUNTER };
+	VendorMessageHandlerType handler = { encodeSpeedLimit, decodeSpeedLimit, &nCalls };
+	ASSERT_EQ(0, registerVendorMessage(TEST_VENDOR_MESSAGE_ID + 1, &handler));
+	const SpeedLimitType data = { 100 };
+	ASSERT_EQ(length, encodeVendorMessage(&header, TEST_VENDOR_MESSAGE_ID + 1, &data, buffer, sizeof (buffer), false));
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR, decodeVendorMessage(buffer, static_cast<size_t>(length), &decoded, false));
+	EXPECT_EQ(-1, encodeVendorMessage(&header, TEST_VENDOR_MESSAGE_ID + 1, &data, buffer, 24, false));
+	unregisterVendorMessage(TEST_VENDOR_MESSAGE_ID + 1);
+	EXPECT_EQ(MESSAGE_TYPE_ERROR, decodeVendorMessage(buffer, static_cast<size_t>(length), &decoded, false));
+}
+
+static int collectValue(const enum ISOMessageID messageID, const uint16_t valueID, const char* content,
+						const uint16_t contentLength, void* userData) {
+	if (messageID != MESSAGE_ID_TRAJ || valueID != TEST_VENDOR_VALUE_ID) {
+		return MESSAGE_VALUE_ID_ERROR;
+	}
+	static_cast<std::string*>(userData)->assign(content, contentLength);
+	return MESSAGE_OK;
+}
+
+class TRAJVendorValue : public ::testing::Test
+{
+protected:
+	void SetUp() override {
+		const uint16_t valueHeader[] = { htole16(TEST_VENDOR_VALUE_ID), htole16(3) };
+		memcpy(buffer, valueHeader, sizeof (valueHeader));
+		memcpy(buffer + sizeof (valueHeader), "abc", 3);
+		vendorValueSize = sizeof (valueHeader) + 3;
+
+		struct timeval time = { 1, 500000 };
+		CartesianPosition position = {};
+		position.xCoord_m = 12.0;
+		position.isPositionValid = true;
+		SpeedType speed = {};
+		speed.longitudinal_m_s = 2.0;
+		speed.isLongitudinalValid = true;
+		AccelerationType acceleration = {};
+		pointSize = encodeTRAJMessagePoint(&time, position, speed, acceleration, 0.0f, buffer + vendorValueSize,
+										   sizeof (buffer) - vendorValueSize, false);
+		ASSERT_GT(pointSize, 0);
+	}
+	void TearDown() override {
+		unregisterVendorValueHandler(MESSAGE_ID_TRAJ, TEST_VENDOR_VALUE_ID);
+	}
+
+	char buffer[128];
+	ssize_t vendorValueSize;
+	ssize_t pointSize;
+	std::string received;
+};
+
+TEST_F(TRAJVendorValue, PassedToHandlerBeforePoint) {
+	ASSERT_EQ(0, registerVendorValueHandler(MESSAGE_ID_TRAJ, TEST_VENDOR_VALUE_ID, collectValue, &received));
+	TrajectoryWaypointType point;
+	EXPECT_EQ(vendorValueSize + pointSize, decodeTRAJMessagePoint(&point, buffer, false));
+	EXPECT_EQ("abc", received);
+	EXPECT_DOUBLE_EQ(12.0, point.pos.xCoord_m);
+}
+
+TEST_F(TRAJVendorValue, RejectedWithoutHandler) {
+	TrajectoryWaypointType point;
+	EXPECT_EQ(MESSAGE_VALUE_ID_ERROR, decodeTRAJMessagePoint(&point, buffer, false));
+	EXPECT_EQ(pointSize, decodeTRAJMessagePoint(&point, buffer + vendorValueSize, false));
+}
+
+TEST_F(TRAJVendorValue, BoundedByBuffer) {
+	ASSERT_EQ(0, registerVendorValueHandler(MESSAGE_ID_TRAJ, TEST_VENDOR_VALUE_ID, collectValue, &received));
+	TrajectoryWaypointType point;
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR, decodeTRAJMessagePointBounded(&point, buffer, 2, false));
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR,
+			  decodeTRAJMessagePointBounded(&point, buffer, static_cast<size_t>(vendorValueSize) - 1, false));
+	EXPECT_TRUE(received.empty());
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR,
+			  decodeTRAJMessagePointBounded(&point, buffer, static_cast<size_t>(vendorValueSize + pointSize) - 1, false));
+
+	// Content length claiming more than the buffer holds
+	const uint16_t oversized = htole16(0xFFFF);
+	memcpy(buffer + sizeof (uint16_t), &oversized, sizeof (oversized));
+	received.clear();
+	EXPECT_EQ(MESSAGE_LENGTH_ERROR, decodeTRAJMessagePointBounded(&point, buffer, sizeof (buffer), false));
+	EXPECT_TRUE(received.empty());
+}
+
+TEST_F(TRAJVendorValue, RangeChecked) {
+	errno = 0;
+	EXPECT_EQ(-1, registerVendorValueHandler(MESSAGE_ID_TRAJ, VALUE_ID_TRAJ_POINT, collectValue, nullptr));
+	EXPECT_EQ(EINVAL, errno);
+	EXPECT_EQ(-1, registerVendorValueHandler(MESSAGE_ID_MONR, TEST_VENDOR_VALUE_ID, collectValue, nullptr));
+	EXPECT_EQ(0, registerVendorValueHandler(MESSAGE_ID_TRAJ, TEST_VENDOR_VALUE_ID, collectValue, nullptr));
+	EXPECT_EQ(-1, registerVendorValueHandler(MESSAGE_ID_TRAJ, TEST_VENDOR_VALUE_ID, collectValue, nullptr));
+	EXPECT_EQ(EEXIST, errno);
+	EXPECT_EQ(MESSAGE_VALUE_ID_ERROR, handleVendorValue(MESSAGE_ID_TRAJ, TEST_VENDOR_VALUE_ID + 1, "", 0));
+}
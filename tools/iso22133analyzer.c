@@ -0,0 +1,152 @@
+/*!
+ * Summarizes ISO 22133 traffic in a pcap or pcapng capture: message counts, per object rates and
+ * CRC errors, and optionally the state timeline of each object.
+ */
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "captureingest.h"
+#include "positioning.h"
+
+static const char* getStateName(const uint8_t state);
+static double secondsBetween(const struct timespec* start, const struct timespec* end);
+static void printUsage(const char* program);
+
+
+int main(int argc, char** argv) {
+	CaptureAnalysisOptionsType options = { 0 };
+	CaptureStatisticsType statistics;
+	CaptureType capture;
+	struct timespec startTime, indexedTime, analyzedTime;
+	double duration_s, analysisTime_s;
+	int option;
+
+	while ((option = getopt(argc, argv, "j:t:sh")) != -1) {
+		switch (option) {
+		case 'j':
+			options.nThreads = (unsigned int) strtoul(optarg, NULL, 0);
+			break;
+		case 't':
+			options.isTransmitterFiltered = true;
+			options.transmitterID = (uint32_t) strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			options.isTimelineEnabled = true;
+			break;
+		case 'h':
+			printUsage(argv[0]);
+			return EXIT_SUCCESS;
+		default:
+			printUsage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	if (optind != argc - 1) {
+		printUsage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, &startTime);
+	if (openCapture(argv[optind], &capture) < 0) {
+		fprintf(stderr, "Unable to open capture %s: %s\n", argv[optind], strerror(errno));
+		return EXIT_FAILURE;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &indexedTime);
+	if (analyzeCapture(&capture, &options, &statistics) < 0) {
+		fprintf(stderr, "Unable to analyse capture: %s\n", strerror(errno));
+		closeCapture(&capture);
+		return EXIT_FAILURE;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &analyzedTime);
+
+	analysisTime_s = secondsBetween(&indexedTime, &analyzedTime);
+	duration_s = (double) (statistics.lastTime_ns - statistics.firstTime_ns) / 1e9;
+	printf("Capture: %" PRIu64 " packets (%" PRIu64 " UDP, %" PRIu64 " TCP, %" PRIu64 " other), %"
+		   PRIu64 " bytes, %.3f s\n", statistics.nPackets, statistics.nUDPPackets, statistics.nTCPPackets,
+		   statistics.nOtherPackets, statistics.nBytes, duration_s);
+	printf("Messages: %" PRIu64 ", CRC errors: %" PRIu64 ", decode errors: %" PRIu64 ", truncated: %" PRIu64
+		   ", skipped bytes: %" PRIu64 ", TCP gaps: %" PRIu64 "\n", statistics.nFrames, statistics.nCRCErrors,
+		   statistics.nDecodeErrors, statistics.nTruncatedFrames, statistics.nSkippedBytes, statistics.nTCPGaps);
+	printf("Indexed in %.3f s, analysed in %.3f s (%.0f messages/s)\n",
+		   secondsBetween(&startTime, &indexedTime), analysisTime_s,
+		   analysisTime_s > 0.0 ? (double) statistics.nFrames / analysisTime_s : 0.0);
+
+	printf("\nMessage ID  Count\n");
+	for (size_t id = 0; id < sizeof (statistics.messageCounts) / sizeof (statistics.messageCounts[0]); ++id) {
+		if (statistics.messageCounts[id] > 0) {
+			printf("0x%04zx      %" PRIu64 "\n", id, statistics.messageCounts[id]);
+		}
+	}
+	if (statistics.nVendorMessages > 0) {
+		printf("vendor      %" PRIu64 "\n", statistics.nVendorMessages);
+	}
+
+	printf("\nTransmitter  Messages  MONR      MONR rate [Hz]  CRC errors  Decode errors\n");
+	for (size_t i = 0; i < statistics.nObjects; ++i) {
+		const CaptureObjectStatisticsType* object = &statistics.objects[i];
+		const double monrSpan_s = (double) (object->lastMONRTime_ns - object->firstMONRTime_ns) / 1e9;
+
+		printf("%-11" PRIu32 "  %-8" PRIu64 "  %-8" PRIu64 "  %-14.2f  %-10" PRIu64 "  %" PRIu64 "\n",
+			   object->transmitterID, object->nMessages, object->nMONRMessages,
+			   monrSpan_s > 0.0 ? (double) (object->nMONRMessages - 1) / monrSpan_s : 0.0,
+			   object->nCRCErrors, object->nDecodeErrors);
+	}
+
+	if (options.isTimelineEnabled) {
+		for (size_t i = 0; i < statistics.nObjects; ++i) {
+			const CaptureObjectStatisticsType* object = &statistics.objects[i];
+
+			printf("\nState timeline of transmitter %" PRIu32 "\n", object->transmitterID);
+			for (size_t j = 0; j < object->nTimelineEntries; ++j) {
+				printf("%12.3f s  %s\n", (double) (object->timeline[j].time_ns - statistics.firstTime_ns) / 1e9,
+					   getStateName(object->timeline[j].state));
+			}
+		}
+	}
+
+	freeCaptureStatistics(&statistics);
+	closeCapture(&capture);
+	return EXIT_SUCCESS;
+}
+
+static const char* getStateName(const uint8_t state) {
+	switch ((ObjectStateType) state) {
+	case OBJECT_STATE_INIT:
+		return "INIT";
+	case OBJECT_STATE_DISARMED:
+		return "DISARMED";
+	case OBJECT_STATE_ARMED:
+		return "ARMED";
+	case OBJECT_STATE_RUNNING:
+		return "RUNNING";
+	case OBJECT_STATE_POSTRUN:
+		return "POSTRUN";
+	case OBJECT_STATE_ABORTING:
+		return "ABORTING";
+	case OBJECT_STATE_REMOTE_CONTROL:
+		return "REMOTE CONTROL";
+	case OBJECT_STATE_PRE_ARMING:
+		return "PRE ARMING";
+	case OBJECT_STATE_PRE_RUNNING:
+		return "PRE RUNNING";
+	case OBJECT_STATE_UNKNOWN:
+	default:
+		return "UNKNOWN";
+	}
+}
+
+static double secondsBetween(const struct timespec* start, const struct timespec* end) {
+	return (double) (end->tv_sec - start->tv_sec) + (double) (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void printUsage(const char* program) {
+	printf("Usage: %s [-j threads] [-t transmitterID] [-s] capture\n"
+		   "  -j  Number of decoding threads, default one per processor\n"
+		   "  -t  Only analyse messages from this transmitter\n"
+		   "  -s  Print the MONR state timeline of each object\n", program);
+}